@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+    AllocationCounter.h
+    GOODMETER - Heap allocation counters fed by the benchmark operator new
+
+    StandaloneApp.cpp replaces the global operator new when built with
+    GOODMETER_BENCHMARKS=1 (the Xcode "Benchmark" configuration) and calls
+    AllocationCounter::noteAllocation() from it. Two views come out of that:
+
+      - per thread: only while a ScopedAllocationCount is alive on the
+        thread, which is what --benchmark-process-block uses to catch
+        allocations inside processBlock;
+      - process wide: every allocation on every thread, which the Audio
+        Doctor JobProfiler diffs across a stage (its task graph work runs on
+        pool threads, so a per-thread count would miss most of it).
+
+    In every other build nothing calls noteAllocation(), `available` is
+    false and all counts read zero.
+
+    Thread safety model:
+      - Per-thread counters are thread_local.
+      - Process-wide counters are relaxed atomics: totals only, no ordering
+        with anything else.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstddef>
+
+#ifndef GOODMETER_BENCHMARKS
+ #define GOODMETER_BENCHMARKS 0
+#endif
+
+namespace goodmeter
+{
+namespace benchmark
+{
+
+//==============================================================================
+/** Allocation counters bumped by the replacement operator new. */
+struct AllocationCounter
+{
+    static constexpr bool available = GOODMETER_BENCHMARKS != 0 && JucePlugin_Build_Standalone != 0;
+
+    static inline thread_local bool armed = false;
+    static inline thread_local juce::uint64 count = 0;
+
+    static inline std::atomic<juce::uint64> processCount { 0 };
+    static inline std::atomic<juce::uint64> processBytes { 0 };
+
+    static void noteAllocation(std::size_t bytes) noexcept
+    {
+        processCount.fetch_add(1, std::memory_order_relaxed);
+        processBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        if (armed)
+            ++count;
+    }
+};
+
+/** Counts heap allocations on this thread for as long as it lives. */
+class ScopedAllocationCount
+{
+public:
+    ScopedAllocationCount() noexcept
+        : startCount(AllocationCounter::count)
+    {
+        AllocationCounter::armed = true;
+    }
+
+    ~ScopedAllocationCount()
+    {
+        AllocationCounter::armed = false;
+    }
+
+    juce::uint64 get() const noexcept   { return AllocationCounter::count - startCount; }
+
+private:
+    const juce::uint64 startCount;
+    JUCE_DECLARE_NON_COPYABLE(ScopedAllocationCount)
+};
+
+} // namespace benchmark
+} // namespace goodmeter
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+    AnalysisDemand.h
+    GOODMETER - Which analyses the on-screen components actually need
+
+    processBlock used to run every analysis for every block whether or not
+    anything displayed it. Components now declare what they read by holding
+    a Subscription:
+
+      - stereoSamples: decimated L/R pairs for the goniometer FIFO
+      - bands:         the crossover bank and its per-band RMS
+      - spectrum:      samples for the FFT worker, at an update rate
+
+    An analysis with no active subscription is skipped by the audio thread
+    (its snapshot values read as silence). Loudness, peak, true peak, RMS,
+    correlation and M/S are not optional: loudness is compliance-critical
+    and the rest come out of the same fused pass for free.
+
+    Rates: each spectrum subscription asks for frames per second (kFullRate
+    = every hop). The worker's hop is stretched to the fastest request, then
+    by the PowerPolicy throttle while the device is hot or in low power mode.
+
+    Thread safety model:
+      - Subscriptions and setPowerThrottle(): message thread
+      - isWanted() / getSpectrumHopMultiple(): audio thread (relaxed atomics)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PowerPolicy.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+class AnalysisDemand : private PowerPolicy::Listener
+{
+public:
+    enum class Analysis
+    {
+        stereoSamples = 0,
+        bands,
+        spectrum
+    };
+
+    static constexpr int kNumAnalyses = 3;
+    static constexpr float kFullRate = std::numeric_limits<float>::max();
+
+    //==========================================================================
+    /** Held by a component for as long as it reads an analysis. */
+    class Subscription
+    {
+    public:
+        Subscription(AnalysisDemand& demandToJoin, Analysis analysisToUse,
+                     float rateHz = kFullRate, bool startActive = true)
+            : demand(demandToJoin), analysis(analysisToUse), rate(rateHz), active(startActive)
+        {
+            demand.add(*this);
+        }
+
+        ~Subscription()     { demand.remove(*this); }
+
+        /** Inactive subscriptions (e.g. a hidden view) don't count. */
+        void setActive(bool shouldBeActive)
+        {
+            if (active == shouldBeActive)
+                return;
+
+            active = shouldBeActive;
+            demand.refresh();
+        }
+
+        void setRateHz(float rateHz)
+        {
+            if (rate == rateHz)
+                return;
+
+            rate = rateHz;
+            demand.refresh();
+        }
+
+        bool isActive() const noexcept      { return active; }
+
+    private:
+        friend class AnalysisDemand;
+        AnalysisDemand& demand;
+        const Analysis analysis;
+        float rate;
+        bool active;
+
+        JUCE_DECLARE_NON_COPYABLE(Subscription)
+    };
+
+    //==========================================================================
+    AnalysisDemand()
+    {
+        PowerPolicy::getInstance().addListener(this);
+        setPowerThrottle(PowerPolicy::getInstance().getLevel());
+    }
+
+    ~AnalysisDemand() override
+    {
+        PowerPolicy::getInstance().removeListener(this);
+        jassert(subscriptions.empty());   // subscribers must not outlive the processor
+    }
+
+    //==========================================================================
+    /** Audio thread: does any active subscription need this analysis? */
+    bool isWanted(Analysis analysis) const noexcept
+    {
+        return wanted[index(analysis)].load(std::memory_order_relaxed);
+    }
+
+    /** Audio thread: how many base hops between spectrum frames, given the
+        worker's frame rate at its base hop. */
+    int getSpectrumHopMultiple(double fullRateHz) const noexcept
+    {
+        const float requested = fastestRate[index(Analysis::spectrum)].load(std::memory_order_relaxed);
+        const int forRate = (requested > 0.0f && requested < fullRateHz)
+                          ? static_cast<int>(fullRateHz / requested)
+                          : 1;
+        return juce::jmax(1, forRate) * powerThrottle.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t index(Analysis analysis) noexcept   { return static_cast<size_t>(analysis); }
+
+    void add(Subscription& subscription)
+    {
+        subscriptions.push_back(&subscription);
+        refresh();
+    }
+
+    void remove(Subscription& subscription)
+    {
+        subscriptions.erase(std::remove(subscriptions.begin(), subscriptions.end(), &subscription),
+                            subscriptions.end());
+        refresh();
+    }
+
+    void refresh()
+    {
+        std::array<bool, kNumAnalyses> anyActive {};
+        std::array<float, kNumAnalyses> fastest {};
+
+        for (const auto* subscription : subscriptions)
+        {
+            if (! subscription->active)
+                continue;
+
+            const auto a = index(subscription->analysis);
+            anyActive[a] = true;
+            fastest[a] = juce::jmax(fastest[a], subscription->rate);
+        }
+
+        for (size_t a = 0; a < (size_t) kNumAnalyses; ++a)
+        {
+            fastestRate[a].store(fastest[a], std::memory_order_relaxed);
+            wanted[a].store(anyActive[a], std::memory_order_relaxed);
+        }
+    }
+
+    void powerLevelChanged(PowerPolicy::Level level) override   { setPowerThrottle(level); }
+
+    void setPowerThrottle(PowerPolicy::Level level)
+    {
+        powerThrottle.store(PowerPolicy::getSpectrumHopFactor(level), std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    std::vector<Subscription*> subscriptions;         // message thread
+    std::array<std::atomic<bool>, kNumAnalyses> wanted {};
+    std::array<std::atomic<float>, kNumAnalyses> fastestRate {};
+    std::atomic<int> powerThrottle { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisDemand)
+};
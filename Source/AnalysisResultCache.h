@@ -0,0 +1,367 @@
+/*
+  ==============================================================================
+    AnalysisResultCache.h
+    GOODMETER - Persistent, content-addressed cache of offline analysis results
+
+    Reopening a file in Audio Doctor, Nono or the history views used to
+    re-run the whole analysis. Results are now stored on disk under the app
+    data directory, keyed by the file's content hash (the same
+    "fnv1a64:<hex>" identity Audio Doctor writes into its manifests), a
+    result kind and the analyser's version number:
+
+        <app data>/GOODMETER/AnalysisCache/<kind>/<hash>.v<version>.gmac
+
+    Each entry carries a small header (magic, kind, version, hash, payload
+    length and checksum) in front of the analyser's own binary payload.
+    Entries that fail validation are deleted on read; bumping an analyser's
+    version simply stops old entries from matching, and they age out.
+
+    Hashing a multi-GB file on every open would defeat the point, so an
+    identity index maps (path, size, modification time) to the content hash.
+    An unchanged file costs one stat; a touched or replaced file is hashed
+    again and gets a fresh key, so stale results can never be served.
+
+    The directory is kept under a byte budget (least recently used first;
+    a cache hit refreshes the entry's modification time).
+
+    Thread safety model:
+      - Any non-audio thread. The index is guarded by a mutex; entries are
+        written to a temporary file and renamed into place, so readers
+        never see a partial entry.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+class AnalysisResultCache
+{
+public:
+    static constexpr juce::int64 kDefaultBudgetBytes = juce::int64 (512) * 1024 * 1024;
+
+    /** Shared by every window and thread in the process. */
+    static AnalysisResultCache& getInstance()
+    {
+        static AnalysisResultCache cache;
+        return cache;
+    }
+
+    //==========================================================================
+    /** FNV-1a 64 over the file's bytes, as "fnv1a64:<hex>"; empty if unreadable. */
+    static juce::String hashFileFnv1a64(const juce::File& file)
+    {
+        juce::FileInputStream stream(file);
+        if (! stream.openedOk())
+            return {};
+
+        juce::uint64 hash = 1469598103934665603ULL;
+        std::array<juce::uint8, 65536> buffer {};
+        for (;;)
+        {
+            const auto bytesRead = stream.read(buffer.data(), static_cast<int>(buffer.size()));
+            if (bytesRead <= 0)
+                break;
+
+            for (int i = 0; i < bytesRead; ++i)
+            {
+                hash ^= buffer[(size_t) i];
+                hash *= 1099511628211ULL;
+            }
+        }
+
+        return "fnv1a64:" + juce::String::toHexString(static_cast<juce::int64>(hash));
+    }
+
+    /** Content hash through the identity index: only hashes the file when
+     *  its size or modification time changed since the last call. */
+    juce::String getContentHash(const juce::File& file)
+    {
+        if (! file.existsAsFile())
+            return {};
+
+        const auto path = file.getFullPathName();
+        const auto size = file.getSize();
+        const auto modified = file.getLastModificationTime().toMilliseconds();
+
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            loadIndexIfNeeded();
+
+            const auto it = identities.find(path);
+            if (it != identities.end() && it->second.size == size && it->second.modifiedMs == modified)
+                return it->second.hash;
+        }
+
+        // Hash outside the lock: other files can be looked up meanwhile
+        const auto hash = hashFileFnv1a64(file);
+        if (hash.isEmpty())
+            return {};
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (identities.size() >= kMaxIdentities)
+            identities.clear();
+
+        identities[path] = { size, modified, hash };
+        saveIndex();
+        return hash;
+    }
+
+    /** The indexed content hash if the file is unchanged since it was last
+     *  hashed, else empty. Never reads the file: one stat at most. */
+    juce::String getKnownContentHash(const juce::File& file)
+    {
+        if (! file.existsAsFile())
+            return {};
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        loadIndexIfNeeded();
+
+        const auto it = identities.find(file.getFullPathName());
+        if (it != identities.end() && it->second.size == file.getSize()
+            && it->second.modifiedMs == file.getLastModificationTime().toMilliseconds())
+            return it->second.hash;
+
+        return {};
+    }
+
+    //==========================================================================
+    /** Fetch a stored payload. False on miss, version mismatch or a damaged entry. */
+    bool load(const juce::String& contentHash, const juce::String& kind, int version, juce::MemoryBlock& payload)
+    {
+        if (contentHash.isEmpty())
+            return false;
+
+        const auto file = entryFile(contentHash, kind, version);
+        juce::FileInputStream stream(file);
+        if (! stream.openedOk())
+            return false;
+
+        const bool valid = stream.readInt() == kEntryMagic
+                        && stream.readInt() == kEntryFormat
+                        && stream.readString() == kind
+                        && stream.readInt() == version
+                        && stream.readString() == contentHash;
+
+        const auto length = valid ? stream.readInt64() : juce::int64 (-1);
+        const auto checksum = static_cast<juce::uint64>(stream.readInt64());
+
+        if (! valid || length < 0 || length != stream.getNumBytesRemaining())
+        {
+            file.deleteFile();
+            return false;
+        }
+
+        payload.setSize(static_cast<size_t>(length));
+        if (stream.read(payload.getData(), static_cast<int>(length)) != static_cast<int>(length)
+            || checksumOf(payload) != checksum)
+        {
+            file.deleteFile();
+            return false;
+        }
+
+        file.setLastModificationTime(juce::Time::getCurrentTime());   // LRU
+        return true;
+    }
+
+    /** Store a payload, replacing any previous entry for the same key. */
+    void store(const juce::String& contentHash, const juce::String& kind, int version, const juce::MemoryBlock& payload)
+    {
+        if (contentHash.isEmpty())
+            return;
+
+        const auto file = entryFile(contentHash, kind, version);
+        if (! file.getParentDirectory().createDirectory())
+            return;
+
+        juce::TemporaryFile temp(file);
+        {
+            auto out = temp.getFile().createOutputStream();
+            if (out == nullptr)
+                return;
+
+            out->writeInt(kEntryMagic);
+            out->writeInt(kEntryFormat);
+            out->writeString(kind);
+            out->writeInt(version);
+            out->writeString(contentHash);
+            out->writeInt64(static_cast<juce::int64>(payload.getSize()));
+            out->writeInt64(static_cast<juce::int64>(checksumOf(payload)));
+            out->write(payload.getData(), payload.getSize());
+            out->flush();
+
+            if (out->getStatus().failed())
+                return;
+        }
+
+        if (temp.overwriteTargetFileWithTemporary())
+            trimIfNeeded(static_cast<juce::int64>(payload.getSize()));
+    }
+
+    //==========================================================================
+    void setBudgetBytes(juce::int64 newBudget)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        budgetBytes = juce::jmax(juce::int64 (0), newBudget);
+    }
+
+    juce::File getDirectory() const
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("GOODMETER")
+            .getChildFile("AnalysisCache");
+    }
+
+    /** Delete every entry and the identity index. */
+    void clear()
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        identities.clear();
+        getDirectory().deleteRecursively();
+        indexLoaded = true;
+    }
+
+private:
+    AnalysisResultCache() = default;
+
+    static constexpr int kEntryMagic = 0x43414d47;   // "GMAC"
+    static constexpr int kEntryFormat = 1;
+    static constexpr int kIndexMagic = 0x58444947;   // "GIDX"
+    static constexpr size_t kMaxIdentities = 20000;
+
+    struct Identity
+    {
+        juce::int64 size = 0;
+        juce::int64 modifiedMs = 0;
+        juce::String hash;
+    };
+
+    //==========================================================================
+    static juce::uint64 checksumOf(const juce::MemoryBlock& block) noexcept
+    {
+        juce::uint64 hash = 1469598103934665603ULL;
+        const auto* bytes = static_cast<const juce::uint8*>(block.getData());
+        for (size_t i = 0; i < block.getSize(); ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    juce::File entryFile(const juce::String& contentHash, const juce::String& kind, int version) const
+    {
+        // "fnv1a64:abcd" → "fnv1a64-abcd": safe on every file system
+        const auto name = contentHash.replaceCharacter(':', '-').retainCharacters("0123456789abcdefghijklmnopqrstuvwxyz-");
+        return getDirectory().getChildFile(kind).getChildFile(name + ".v" + juce::String(version) + ".gmac");
+    }
+
+    juce::File indexFile() const    { return getDirectory().getChildFile("identity.idx"); }
+
+    //==========================================================================
+    // Identity index (mutex held)
+    //==========================================================================
+    void loadIndexIfNeeded()
+    {
+        if (indexLoaded)
+            return;
+
+        indexLoaded = true;
+        juce::FileInputStream stream(indexFile());
+        if (! stream.openedOk() || stream.readInt() != kIndexMagic)
+            return;
+
+        const int count = stream.readInt();
+        for (int i = 0; i < count && ! stream.isExhausted(); ++i)
+        {
+            const auto path = stream.readString();
+            Identity identity;
+            identity.size = stream.readInt64();
+            identity.modifiedMs = stream.readInt64();
+            identity.hash = stream.readString();
+
+            if (path.isNotEmpty() && identity.hash.isNotEmpty())
+                identities[path] = identity;
+        }
+    }
+
+    void saveIndex()
+    {
+        if (! getDirectory().createDirectory())
+            return;
+
+        juce::TemporaryFile temp(indexFile());
+        {
+            auto out = temp.getFile().createOutputStream();
+            if (out == nullptr)
+                return;
+
+            out->writeInt(kIndexMagic);
+            out->writeInt(static_cast<int>(identities.size()));
+            for (const auto& [path, identity] : identities)
+            {
+                out->writeString(path);
+                out->writeInt64(identity.size);
+                out->writeInt64(identity.modifiedMs);
+                out->writeString(identity.hash);
+            }
+            out->flush();
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
+    //==========================================================================
+    /** Scan and evict oldest entries once roughly a tenth of the budget has
+     *  been written since the last scan, so stores stay cheap. */
+    void trimIfNeeded(juce::int64 bytesWritten)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        bytesSinceTrim += bytesWritten;
+        if (bytesSinceTrim < budgetBytes / 10)
+            return;
+
+        bytesSinceTrim = 0;
+
+        struct Entry { juce::File file; juce::int64 size; juce::Time used; };
+        std::vector<Entry> entries;
+        juce::int64 total = 0;
+
+        for (const auto& item : juce::RangedDirectoryIterator(getDirectory(), true, "*.gmac", juce::File::findFiles))
+        {
+            entries.push_back({ item.getFile(), item.getFileSize(), item.getModificationTime() });
+            total += item.getFileSize();
+        }
+
+        if (total <= budgetBytes)
+            return;
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+
+        // Down to 80 % so the next few stores don't rescan straight away
+        const auto target = budgetBytes - budgetBytes / 5;
+        for (const auto& entry : entries)
+        {
+            if (total <= target)
+                break;
+
+            if (entry.file.deleteFile())
+                total -= entry.size;
+        }
+    }
+
+    //==========================================================================
+    std::mutex mutex;
+    std::map<juce::String, Identity> identities;
+    bool indexLoaded = false;
+    juce::int64 budgetBytes = kDefaultBudgetBytes;
+    juce::int64 bytesSinceTrim = kDefaultBudgetBytes / 10;   // first store of a session scans
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisResultCache)
+};
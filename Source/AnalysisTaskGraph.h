@@ -0,0 +1,340 @@
+/*
+  ==============================================================================
+    AnalysisTaskGraph.h
+    GOODMETER - Dependency-aware task graph on a shared work-stealing pool
+
+    Offline analysis (Audio Doctor stages, job runner assets) is a handful of
+    coarse, mostly independent steps. A graph is built with addTask(name,
+    work, dependencies) and run(): every task whose dependencies are done is
+    handed to the pool, and the thread that finishes a task pushes the tasks
+    it unblocked onto its own queue, so dependent stages stay on a warm core.
+
+    One pool is shared by the whole process (AnalysisThreadPool). Each worker
+    owns a deque: it pops its own work LIFO and, when empty, steals FIFO from
+    the other workers or takes work submitted from outside the pool. The
+    thread calling run() helps execute tasks until its graph is done, so
+    graphs nested inside another graph's task (an asset analysed inside a
+    job-level graph) share the same workers instead of oversubscribing.
+
+    Every task records its start time, duration and executing thread; see
+    getTimings().
+
+    Thread safety model:
+      - A graph is built and run by one thread; run() blocks until every
+        task has finished. Tasks must not call addTask() on their own graph.
+      - Tasks run concurrently with each other and must only touch state no
+        other task of the same graph writes.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+class AnalysisThreadPool
+{
+public:
+    using Job = std::function<void()>;
+
+    /** Sized to the machine on first use (one thread fewer than cores: the
+     *  caller of AnalysisTaskGraph::run() always helps). */
+    static AnalysisThreadPool& getInstance()
+    {
+        static AnalysisThreadPool pool(juce::jmax(0, juce::SystemStats::getNumCpus() - 1));
+        return pool;
+    }
+
+    ~AnalysisThreadPool()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(wakeMutex);
+            shuttingDown = true;
+        }
+        wake.notify_all();
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    int getNumWorkers() const noexcept   { return static_cast<int>(threads.size()); }
+
+    /** Queue a job: onto the calling worker's own deque, or the shared
+     *  injection queue when called from outside the pool. */
+    void submit(Job job)
+    {
+        auto& queue = currentWorker >= 0 && currentPool == this ? *queues[(size_t) currentWorker] : injected;
+        {
+            const std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+
+        {
+            // Under the wake lock so a worker about to sleep can't miss it
+            const std::lock_guard<std::mutex> lock(wakeMutex);
+            pending.fetch_add(1, std::memory_order_release);
+        }
+        wake.notify_one();
+    }
+
+    /** Run one queued job on the calling thread, if there is any. */
+    bool runOne()
+    {
+        Job job;
+        if (! take(job))
+            return false;
+
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        job();
+        return true;
+    }
+
+    /** Number of the calling worker thread (1-based), 0 for any other thread. */
+    static int getCurrentThreadTag() noexcept   { return currentWorker + 1; }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    explicit AnalysisThreadPool(int numWorkers)
+    {
+        for (int i = 0; i < numWorkers; ++i)
+            queues.push_back(std::make_unique<Queue>());
+
+        for (int i = 0; i < numWorkers; ++i)
+            threads.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    void workerLoop(int index)
+    {
+        currentWorker = index;
+        currentPool = this;
+
+        for (;;)
+        {
+            if (runOne())
+                continue;
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return shuttingDown || pending.load(std::memory_order_acquire) > 0; });
+            if (shuttingDown)
+                return;
+        }
+    }
+
+    static bool popBack(Queue& queue, Job& job)
+    {
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            return false;
+
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    static bool popFront(Queue& queue, Job& job)
+    {
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            return false;
+
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    bool take(Job& job)
+    {
+        const int self = currentPool == this ? currentWorker : -1;
+
+        // Own work newest first (its inputs are still in cache)...
+        if (self >= 0 && popBack(*queues[(size_t) self], job))
+            return true;
+
+        // ...then outside submissions, then the oldest work of the others
+        if (popFront(injected, job))
+            return true;
+
+        const int n = static_cast<int>(queues.size());
+        for (int k = 1; k <= n; ++k)
+        {
+            const int victim = (juce::jmax(0, self) + k) % n;
+            if (victim != self && popFront(*queues[(size_t) victim], job))
+                return true;
+        }
+
+        return false;
+    }
+
+    static inline thread_local int currentWorker = -1;
+    static inline thread_local AnalysisThreadPool* currentPool = nullptr;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    Queue injected;
+    std::vector<std::thread> threads;
+
+    std::atomic<int> pending { 0 };
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool shuttingDown = false;
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisThreadPool)
+};
+
+//==============================================================================
+class AnalysisTaskGraph
+{
+public:
+    using TaskId = int;
+
+    struct TaskTiming
+    {
+        juce::String name;
+        double startMs = 0.0;       // relative to the start of run()
+        double durationMs = 0.0;
+        int thread = 0;             // 0 = a thread outside the pool, else worker number
+    };
+
+    /** Add a task that may start once every task in `dependencies` is done. */
+    TaskId addTask(const juce::String& name, std::function<void()> work, std::vector<TaskId> dependencies = {})
+    {
+        const auto id = static_cast<TaskId>(nodes.size());
+        auto node = std::make_unique<Node>();
+        node->name = name;
+        node->work = std::move(work);
+
+        for (const auto dependency : dependencies)
+        {
+            jassert(dependency >= 0 && dependency < id);
+            if (dependency >= 0 && dependency < id)
+            {
+                nodes[(size_t) dependency]->dependents.push_back(id);
+                ++node->unmetDependencies;
+            }
+        }
+
+        nodes.push_back(std::move(node));
+        return id;
+    }
+
+    int getNumTasks() const noexcept   { return static_cast<int>(nodes.size()); }
+
+    /** Execute every task, in parallel where the dependencies allow.
+     *  Blocks until done; the calling thread executes tasks too. */
+    void run()
+    {
+        if (nodes.empty())
+            return;
+
+        auto& pool = AnalysisThreadPool::getInstance();
+        runStartTicks = juce::Time::getHighResolutionTicks();
+        remaining.store(static_cast<int>(nodes.size()), std::memory_order_release);
+
+        for (auto& node : nodes)
+            node->waitingOn.store(node->unmetDependencies, std::memory_order_relaxed);
+
+        for (TaskId id = 0; id < static_cast<TaskId>(nodes.size()); ++id)
+            if (nodes[(size_t) id]->unmetDependencies == 0)
+                schedule(pool, id);
+
+        while (remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (pool.runOne())
+                continue;
+
+            // Nothing to help with: the rest is running elsewhere
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneCondition.wait_for(lock, std::chrono::milliseconds(2),
+                                   [this] { return remaining.load(std::memory_order_acquire) == 0; });
+        }
+
+        const std::lock_guard<std::mutex> lock(doneMutex);
+    }
+
+    /** Per-task timing of the last run(), in task order. */
+    std::vector<TaskTiming> getTimings() const
+    {
+        std::vector<TaskTiming> timings;
+        timings.reserve(nodes.size());
+
+        const double msPerTick = 1000.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+        for (const auto& node : nodes)
+            timings.push_back({ node->name,
+                                static_cast<double>(node->startTicks - runStartTicks) * msPerTick,
+                                static_cast<double>(node->endTicks - node->startTicks) * msPerTick,
+                                node->thread });
+        return timings;
+    }
+
+    /** Wall-clock span of the last run() in ms (first start to last end). */
+    double getElapsedMs() const
+    {
+        juce::int64 last = runStartTicks;
+        for (const auto& node : nodes)
+            last = juce::jmax(last, node->endTicks);
+
+        return static_cast<double>(last - runStartTicks) * 1000.0
+             / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    }
+
+private:
+    struct Node
+    {
+        juce::String name;
+        std::function<void()> work;
+        std::vector<TaskId> dependents;
+        int unmetDependencies = 0;
+        std::atomic<int> waitingOn { 0 };
+
+        juce::int64 startTicks = 0;
+        juce::int64 endTicks = 0;
+        int thread = 0;
+    };
+
+    void schedule(AnalysisThreadPool& pool, TaskId id)
+    {
+        pool.submit([this, &pool, id] { execute(pool, id); });
+    }
+
+    void execute(AnalysisThreadPool& pool, TaskId id)
+    {
+        auto& node = *nodes[(size_t) id];
+        node.thread = AnalysisThreadPool::getCurrentThreadTag();
+        node.startTicks = juce::Time::getHighResolutionTicks();
+
+        if (node.work)
+            node.work();
+
+        node.endTicks = juce::Time::getHighResolutionTicks();
+
+        for (const auto dependent : node.dependents)
+            if (nodes[(size_t) dependent]->waitingOn.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                schedule(pool, dependent);
+
+        // The last decrement happens under doneMutex, and run() takes the
+        // lock once more before returning, so the graph can't be destroyed
+        // while this thread is still inside it
+        const std::lock_guard<std::mutex> lock(doneMutex);
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            doneCondition.notify_all();
+    }
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::atomic<int> remaining { 0 };
+    juce::int64 runStartTicks = 0;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+};
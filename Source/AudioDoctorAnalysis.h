@@ -14,6 +14,13 @@
 #include <complex>
 #include <cstdint>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "AnalysisResultCache.h"
+#include "AnalysisTaskGraph.h"
+#include "AudioFileIngest.h"
+#include "TruePeakDetector.h"
 
 namespace goodmeter::audio_doctor
 {
@@ -25,6 +32,7 @@ struct Metrics
     juce::int64 samples = 0;
     double durationSeconds = 0.0;
     float peakDb = -120.0f;
+    float truePeakDb = -120.0f;
     float rmsDb = -120.0f;
     float crestDb = 0.0f;
 };
@@ -155,6 +163,7 @@ struct Asset
     juce::String name;
     juce::String sourcePath;
     juce::AudioBuffer<float> buffer;
+    bool analysisOnly = false;      // streamed from a file too long to load: buffer is empty
     double sampleRate = 48000.0;
     Metrics metrics;
     ReverbSpaceMetrics spaceMetrics;
@@ -170,9 +179,14 @@ struct Asset
     std::vector<PlotPoint> energyDecay;
     std::vector<PlotPoint> dynamicsRms;
     std::vector<PlotPoint> groupDelay;
+    std::vector<PlotPoint> transferMagnitudeDb;     // H1, dry -> wet
+    std::vector<PlotPoint> transferMagnitudeH2Db;
+    std::vector<PlotPoint> transferPhaseDegrees;
+    std::vector<PlotPoint> transferCoherence;
     juce::Image spectrogramBlue;
     juce::Image spectrogramYellow;
     juce::Image spectrogramPink;
+    std::vector<AnalysisTaskGraph::TaskTiming> analysisTimings;   // last refreshAnalysis(); empty on a cache hit
 };
 
 inline float safeGainToDb(float gain)
@@ -394,6 +408,7 @@ inline juce::var writeAnalysisSummaryJson(const Metrics& metrics)
     obj->setProperty("channels", metrics.channels);
     obj->setProperty("durationSeconds", metrics.durationSeconds);
     obj->setProperty("peakDb", metrics.peakDb);
+    obj->setProperty("truePeakDb", metrics.truePeakDb);
     obj->setProperty("rmsDb", metrics.rmsDb);
     obj->setProperty("crestDb", metrics.crestDb);
     return juce::var(obj.release());
@@ -449,6 +464,7 @@ inline Metrics computeMetrics(const juce::AudioBuffer<float>& buffer, double sam
     double sumSquares = 0.0;
     juce::int64 count = 0;
     float peak = 0.0f;
+    float truePeak = 0.0f;
 
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
     {
@@ -460,10 +476,13 @@ inline Metrics computeMetrics(const juce::AudioBuffer<float>& buffer, double sam
             sumSquares += static_cast<double>(v) * static_cast<double>(v);
             ++count;
         }
+
+        truePeak = juce::jmax(truePeak, measureTruePeak(data, buffer.getNumSamples()));
     }
 
     const float rms = count > 0 ? static_cast<float>(std::sqrt(sumSquares / static_cast<double>(count))) : 0.0f;
     m.peakDb = safeGainToDb(peak);
+    m.truePeakDb = safeGainToDb(juce::jmax(peak, truePeak));
     m.rmsDb = safeGainToDb(rms);
     m.crestDb = m.peakDb - m.rmsDb;
     return m;
@@ -485,8 +504,8 @@ inline std::vector<PlotPoint> computeEnvelope(const juce::AudioBuffer<float>& bu
 
     for (int p = 0; p < pointCount; ++p)
     {
-        const int start = p * samples / pointCount;
-        const int end = (p + 1) * samples / pointCount;
+        const int start = static_cast<int>(static_cast<juce::int64>(p) * samples / pointCount);
+        const int end = static_cast<int>(static_cast<juce::int64>(p + 1) * samples / pointCount);
         float peak = 0.0f;
 
         for (int i = start; i < end; ++i)
@@ -550,7 +569,7 @@ inline std::vector<PlotPoint> computeEnergyDecayCurve(const juce::AudioBuffer<fl
 
     for (int p = 0; p < pointCount; ++p)
     {
-        const int index = p * (samples - onset - 1) / juce::jmax(1, pointCount - 1);
+        const int index = static_cast<int>(static_cast<juce::int64>(p) * (samples - onset - 1) / juce::jmax(1, pointCount - 1));
         const double norm = juce::jmax(1.0e-18, cumulative[static_cast<size_t>(index)] / reference);
         points.push_back({ static_cast<float>(index / sampleRate),
                            juce::jlimit(-100.0f, 0.0f, static_cast<float>(10.0 * std::log10(norm))) });
@@ -577,7 +596,7 @@ inline std::vector<PlotPoint> computeRmsEnvelope(const juce::AudioBuffer<float>&
 
     for (int p = 0; p < pointCount; ++p)
     {
-        const int centre = p * samples / pointCount;
+        const int centre = static_cast<int>(static_cast<juce::int64>(p) * samples / pointCount);
         const int start = juce::jlimit(0, samples, centre - window / 2);
         const int end = juce::jlimit(start + 1, samples, centre + window / 2);
         double sumSquares = 0.0;
@@ -869,105 +888,270 @@ inline juce::var writeApparentAttenuationStatsJson(const ApparentAttenuationStat
     return juce::var(obj.release());
 }
 
-inline std::vector<PlotPoint> computeAverageSpectrum(const juce::AudioBuffer<float>& buffer,
-                                                     double sampleRate,
-                                                     int fftOrder = 14,
-                                                     int maxFrames = 512)
-{
-    std::vector<PlotPoint> points;
-    const int samples = buffer.getNumSamples();
-
-    while (fftOrder > 11 && samples < (1 << fftOrder))
-        --fftOrder;
-
-    const int fftSize = 1 << fftOrder;
-    const int halfSize = fftSize / 2;
+//==============================================================================
+/** Welch / averaged-periodogram magnitude accumulator: Hann frames at 50 %
+ *  overlap, every frame of the signal, fed in arbitrary block sizes.
+ *  Magnitudes are summed with FloatVectorOperations into a float block
+ *  accumulator that is folded into doubles every kFramesPerFlush frames, so
+ *  long files keep full precision without a scalar inner loop. */
+class WelchSpectrumAccumulator
+{
+public:
+    explicit WelchSpectrumAccumulator(int fftOrderToUse)
+        : fftOrder(fftOrderToUse),
+          fftSize(1 << fftOrderToUse),
+          hop(fftSize / 2),
+          fft(fftOrderToUse),
+          window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann),
+          frame(static_cast<size_t>(fftSize), 0.0f),
+          fftData(static_cast<size_t>(fftSize * 2), 0.0f),
+          blockSum(static_cast<size_t>(fftSize / 2), 0.0f),
+          totalSum(static_cast<size_t>(fftSize / 2), 0.0)
+    {
+    }
 
-    if (sampleRate <= 0.0 || samples < fftSize)
-        return points;
+    int getFftOrder() const noexcept    { return fftOrder; }
+    int getFftSize() const noexcept     { return fftSize; }
+    int getNumFrames() const noexcept   { return framesTotal; }
 
-    auto mono = mixToMono(buffer);
-    const auto* data = mono.getReadPointer(0);
+    void push(const float* data, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            const int toCopy = juce::jmin(numSamples, fftSize - filled);
+            std::copy(data, data + toCopy, frame.begin() + filled);
+            filled += toCopy;
+            data += toCopy;
+            numSamples -= toCopy;
 
-    juce::dsp::FFT fft(fftOrder);
-    juce::dsp::WindowingFunction<float> window(fftSize, juce::dsp::WindowingFunction<float>::hann);
+            if (filled == fftSize)
+            {
+                processFrame();
 
-    const int hop = fftSize / 2;
-    const int availableFrames = juce::jmax(1, (samples - fftSize) / hop + 1);
-    const int frames = juce::jmin(maxFrames, availableFrames);
-    std::vector<double> magnitudes(static_cast<size_t>(halfSize), 0.0);
-    std::vector<float> fftData(static_cast<size_t>(fftSize * 2), 0.0f);
+                // Keep the second half: it is the first half of the next frame
+                std::copy(frame.begin() + hop, frame.end(), frame.begin());
+                filled = fftSize - hop;
+            }
+        }
+    }
 
-    for (int frame = 0; frame < frames; ++frame)
+    /** Mean magnitude per bin over every frame pushed so far (bins 0..fftSize/2-1). */
+    std::vector<double> getAverageMagnitudes()
     {
-        const int sourceFrame = frame * availableFrames / frames;
-        const int pos = sourceFrame * hop;
-        std::fill(fftData.begin(), fftData.end(), 0.0f);
+        flush();
+        std::vector<double> average(totalSum.size(), 0.0);
+        if (framesTotal > 0)
+            for (size_t bin = 0; bin < average.size(); ++bin)
+                average[bin] = totalSum[bin] / static_cast<double>(framesTotal);
+        return average;
+    }
 
-        for (int i = 0; i < fftSize; ++i)
-            fftData[static_cast<size_t>(i)] = data[pos + i];
+private:
+    static constexpr int kFramesPerFlush = 64;
 
-        window.multiplyWithWindowingTable(fftData.data(), fftSize);
+    void processFrame()
+    {
+        std::copy(frame.begin(), frame.end(), fftData.begin());
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+        window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
         fft.performFrequencyOnlyForwardTransform(fftData.data());
 
-        for (int bin = 1; bin < halfSize; ++bin)
-            magnitudes[static_cast<size_t>(bin)] += static_cast<double>(fftData[static_cast<size_t>(bin)]);
+        juce::FloatVectorOperations::add(blockSum.data(), fftData.data(), fftSize / 2);
+        ++framesTotal;
+
+        if (++framesInBlock == kFramesPerFlush)
+            flush();
     }
 
-    std::vector<float> binDb(static_cast<size_t>(halfSize), -120.0f);
-    for (int bin = 1; bin < halfSize; ++bin)
+    void flush()
     {
-        const float avgMag = static_cast<float>(magnitudes[static_cast<size_t>(bin)] / static_cast<double>(frames));
-        binDb[static_cast<size_t>(bin)] = safeGainToDb(avgMag / static_cast<float>(fftSize)) + 54.0f;
+        if (framesInBlock == 0)
+            return;
+
+        for (size_t bin = 0; bin < totalSum.size(); ++bin)
+            totalSum[bin] += static_cast<double>(blockSum[bin]);
+
+        std::fill(blockSum.begin(), blockSum.end(), 0.0f);
+        framesInBlock = 0;
     }
 
-    auto interpolateBinDb = [&](double exactBin)
+    const int fftOrder;
+    const int fftSize;
+    const int hop;
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::vector<float> frame;
+    std::vector<float> fftData;
+    std::vector<float> blockSum;
+    std::vector<double> totalSum;
+    int filled = 0;
+    int framesInBlock = 0;
+    int framesTotal = 0;
+};
+
+//==============================================================================
+/** Sparse bin-to-plot-point weights for the 2200-point, 20 Hz - 20 kHz log
+ *  spectrum: the interpolated, frequency-dependent smoothing of the plot
+ *  folded into one weighted sum of bins per point. Depends only on
+ *  (fftSize, sampleRate), so it is built once and shared. */
+struct LogSpectrumMap
+{
+    static constexpr int kPointCount = 2200;
+
+    struct Tap
     {
-        exactBin = juce::jlimit(1.0, static_cast<double>(halfSize - 1), exactBin);
-        const int bin0 = juce::jlimit(1, halfSize - 1, static_cast<int>(std::floor(exactBin)));
-        const int bin1 = juce::jlimit(1, halfSize - 1, bin0 + 1);
-        const float frac = static_cast<float>(exactBin - static_cast<double>(bin0));
-        return juce::jmap(frac, binDb[static_cast<size_t>(bin0)], binDb[static_cast<size_t>(bin1)]);
+        int bin = 0;
+        float weight = 0.0f;
     };
 
-    constexpr float minFreq = 20.0f;
-    constexpr float maxFreq = 20000.0f;
-    constexpr int pointCount = 2200;
-    const double logMin = std::log10(minFreq);
-    const double logMax = std::log10(maxFreq);
-    const double logStep = (logMax - logMin) / static_cast<double>(pointCount - 1);
-    points.reserve(static_cast<size_t>(pointCount));
+    std::vector<float> frequencies;   // one per point
+    std::vector<int> firstTap;        // kPointCount + 1 offsets into taps
+    std::vector<Tap> taps;
+
+    static std::shared_ptr<const LogSpectrumMap> get(int fftSize, double sampleRate)
+    {
+        static std::mutex mutex;
+        static std::map<std::pair<int, double>, std::shared_ptr<const LogSpectrumMap>> maps;
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto& map = maps[{ fftSize, sampleRate }];
+        if (map == nullptr)
+            map = build(fftSize, sampleRate);
+        return map;
+    }
 
-    for (int i = 0; i < pointCount; ++i)
+private:
+    static std::shared_ptr<const LogSpectrumMap> build(int fftSize, double sampleRate)
     {
-        const double centreLog = logMin + static_cast<double>(i) * logStep;
-        const float freq = static_cast<float>(std::pow(10.0, centreLog));
-        const double exactBin = static_cast<double>(freq) * static_cast<double>(fftSize) / sampleRate;
+        auto map = std::make_shared<LogSpectrumMap>();
+        const int halfSize = fftSize / 2;
+        map->frequencies.reserve(static_cast<size_t>(kPointCount));
+        map->firstTap.reserve(static_cast<size_t>(kPointCount + 1));
 
-        const double smoothingBins = juce::jlimit(0.0, 18.0, exactBin * 0.006);
-        if (smoothingBins < 1.0)
+        std::vector<double> weights(static_cast<size_t>(halfSize), 0.0);
+        std::vector<int> touched;
+
+        // Linear interpolation between the two bins around exactBin
+        auto addInterpolated = [&](double exactBin, double weight)
         {
-            points.push_back({ freq, interpolateBinDb(exactBin) });
-            continue;
-        }
+            exactBin = juce::jlimit(1.0, static_cast<double>(halfSize - 1), exactBin);
+            const int bin0 = juce::jlimit(1, halfSize - 1, static_cast<int>(std::floor(exactBin)));
+            const int bin1 = juce::jlimit(1, halfSize - 1, bin0 + 1);
+            const double frac = exactBin - static_cast<double>(bin0);
+
+            for (const auto& [bin, w] : { std::make_pair(bin0, (1.0 - frac) * weight), std::make_pair(bin1, frac * weight) })
+            {
+                if (weights[(size_t) bin] == 0.0)
+                    touched.push_back(bin);
+                weights[(size_t) bin] += w;
+            }
+        };
+
+        constexpr float minFreq = 20.0f;
+        constexpr float maxFreq = 20000.0f;
+        const double logMin = std::log10(minFreq);
+        const double logMax = std::log10(maxFreq);
+        const double logStep = (logMax - logMin) / static_cast<double>(kPointCount - 1);
 
-        const int taps = juce::jlimit(1, 9, static_cast<int>(std::ceil(smoothingBins)));
-        double weightedSum = 0.0;
-        double weightTotal = 0.0;
-        for (int offset = -taps; offset <= taps; ++offset)
+        for (int i = 0; i < kPointCount; ++i)
         {
-            const double distance = std::abs(static_cast<double>(offset)) / (smoothingBins + 0.0001);
-            const double weight = juce::jmax(0.0, 1.0 - distance);
-            weightedSum += static_cast<double>(interpolateBinDb(exactBin + static_cast<double>(offset))) * weight;
-            weightTotal += weight;
+            const double centreLog = logMin + static_cast<double>(i) * logStep;
+            const float freq = static_cast<float>(std::pow(10.0, centreLog));
+            const double exactBin = static_cast<double>(freq) * static_cast<double>(fftSize) / sampleRate;
+            map->frequencies.push_back(freq);
+            map->firstTap.push_back(static_cast<int>(map->taps.size()));
+
+            const double smoothingBins = juce::jlimit(0.0, 18.0, exactBin * 0.006);
+            if (smoothingBins < 1.0)
+            {
+                addInterpolated(exactBin, 1.0);
+            }
+            else
+            {
+                const int taps = juce::jlimit(1, 9, static_cast<int>(std::ceil(smoothingBins)));
+                double weightTotal = 0.0;
+                for (int offset = -taps; offset <= taps; ++offset)
+                    weightTotal += juce::jmax(0.0, 1.0 - std::abs(static_cast<double>(offset)) / (smoothingBins + 0.0001));
+
+                for (int offset = -taps; offset <= taps; ++offset)
+                {
+                    const double distance = std::abs(static_cast<double>(offset)) / (smoothingBins + 0.0001);
+                    const double weight = juce::jmax(0.0, 1.0 - distance);
+                    if (weight > 0.0)
+                        addInterpolated(exactBin + static_cast<double>(offset), weight / juce::jmax(0.0001, weightTotal));
+                }
+            }
+
+            std::sort(touched.begin(), touched.end());
+            for (const int bin : touched)
+            {
+                map->taps.push_back({ bin, static_cast<float>(weights[(size_t) bin]) });
+                weights[(size_t) bin] = 0.0;
+            }
+            touched.clear();
         }
 
-        points.push_back({ freq, static_cast<float>(weightedSum / juce::jmax(0.0001, weightTotal)) });
+        map->firstTap.push_back(static_cast<int>(map->taps.size()));
+        return map;
+    }
+};
+
+/** The 2200-point log-frequency plot of everything pushed into `welch`. */
+inline std::vector<PlotPoint> logSpectrumPoints(WelchSpectrumAccumulator& welch, double sampleRate)
+{
+    std::vector<PlotPoint> points;
+    const int fftSize = welch.getFftSize();
+    const int halfSize = fftSize / 2;
+    if (welch.getNumFrames() <= 0 || sampleRate <= 0.0)
+        return points;
+
+    const auto magnitudes = welch.getAverageMagnitudes();
+    std::vector<float> binDb(static_cast<size_t>(halfSize), -120.0f);
+    for (int bin = 1; bin < halfSize; ++bin)
+        binDb[static_cast<size_t>(bin)] = safeGainToDb(static_cast<float>(magnitudes[static_cast<size_t>(bin)]) / static_cast<float>(fftSize)) + 54.0f;
+
+    const auto map = LogSpectrumMap::get(fftSize, sampleRate);
+    points.reserve(static_cast<size_t>(LogSpectrumMap::kPointCount));
+
+    for (int i = 0; i < LogSpectrumMap::kPointCount; ++i)
+    {
+        float value = 0.0f;
+        for (int t = map->firstTap[(size_t) i]; t < map->firstTap[(size_t) i + 1]; ++t)
+            value += map->taps[(size_t) t].weight * binDb[(size_t) map->taps[(size_t) t].bin];
+
+        points.push_back({ map->frequencies[(size_t) i], value });
     }
 
     return points;
 }
 
+/** Average spectrum of an already mixed-down mono signal, over every frame. */
+inline std::vector<PlotPoint> computeAverageSpectrumMono(const float* data,
+                                                         int samples,
+                                                         double sampleRate,
+                                                         int fftOrder = 14)
+{
+    std::vector<PlotPoint> points;
+
+    while (fftOrder > 11 && samples < (1 << fftOrder))
+        --fftOrder;
+
+    if (data == nullptr || sampleRate <= 0.0 || samples < (1 << fftOrder))
+        return points;
+
+    WelchSpectrumAccumulator welch(fftOrder);
+    welch.push(data, samples);
+    return logSpectrumPoints(welch, sampleRate);
+}
+
+inline std::vector<PlotPoint> computeAverageSpectrum(const juce::AudioBuffer<float>& buffer,
+                                                     double sampleRate,
+                                                     int fftOrder = 14)
+{
+    const auto mono = mixToMono(buffer);
+    return computeAverageSpectrumMono(mono.getReadPointer(0), mono.getNumSamples(), sampleRate, fftOrder);
+}
+
 inline float centsBetween(float frequencyHz, float expectedHz)
 {
     if (frequencyHz <= 0.0f || expectedHz <= 0.0f)
@@ -1151,60 +1335,72 @@ inline std::vector<SpectrumPeak> selectHarmonicPeaks(const std::vector<SpectrumP
     return harmonics;
 }
 
-inline std::vector<PlotPoint> computeTransferGroupDelay(const juce::AudioBuffer<float>& dryBuffer,
-                                                        const juce::AudioBuffer<float>& wetBuffer,
-                                                        double sampleRate,
-                                                        int fftOrder = 14,
-                                                        int maxFrames = 96)
+//==============================================================================
+/** Dry -> wet transfer function estimated over every 50%-overlap Hann frame:
+ *  H1 = Sxy / Sxx and H2 = Syy / Syx magnitude, unwrapped phase and group
+ *  delay of Sxy, and magnitude-squared coherence |Sxy|^2 / (Sxx Syy).
+ *  All curves share the same frequency points (20 Hz - 20 kHz, about 900). */
+struct TransferFunction
 {
-    std::vector<PlotPoint> points;
+    bool valid = false;
+    int fftSize = 0;
+    int frames = 0;
+    std::vector<PlotPoint> magnitudeH1Db;
+    std::vector<PlotPoint> magnitudeH2Db;
+    std::vector<PlotPoint> phaseDegrees;
+    std::vector<PlotPoint> groupDelayMs;
+    std::vector<PlotPoint> coherence;
+};
+
+inline TransferFunction computeTransferFunction(const juce::AudioBuffer<float>& dryBuffer,
+                                                const juce::AudioBuffer<float>& wetBuffer,
+                                                double sampleRate,
+                                                int fftOrder = 14)
+{
+    TransferFunction result;
 
     const int fftSize = 1 << fftOrder;
     const int halfSize = fftSize / 2;
     const int samples = juce::jmin(dryBuffer.getNumSamples(), wetBuffer.getNumSamples());
     if (sampleRate <= 0.0 || samples < fftSize)
-        return points;
+        return result;
 
-    auto dryMono = mixToMono(dryBuffer);
-    auto wetMono = mixToMono(wetBuffer);
+    const auto dryMono = mixToMono(dryBuffer);
+    const auto wetMono = mixToMono(wetBuffer);
     const auto* dry = dryMono.getReadPointer(0);
     const auto* wet = wetMono.getReadPointer(0);
 
+    // Real-input transforms: only bins 0..N/2 are produced, as interleaved re/im
     juce::dsp::FFT fft(fftOrder);
-    std::vector<juce::dsp::Complex<float>> dryIn(static_cast<size_t>(fftSize));
-    std::vector<juce::dsp::Complex<float>> wetIn(static_cast<size_t>(fftSize));
-    std::vector<juce::dsp::Complex<float>> dryOut(static_cast<size_t>(fftSize));
-    std::vector<juce::dsp::Complex<float>> wetOut(static_cast<size_t>(fftSize));
-    std::vector<std::complex<double>> cross(static_cast<size_t>(halfSize));
+    juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+    std::vector<float> dryData(static_cast<size_t>(fftSize * 2), 0.0f);
+    std::vector<float> wetData(static_cast<size_t>(fftSize * 2), 0.0f);
+
+    std::vector<double> sxx(static_cast<size_t>(halfSize), 0.0);
+    std::vector<double> syy(static_cast<size_t>(halfSize), 0.0);
+    std::vector<std::complex<double>> sxy(static_cast<size_t>(halfSize));
 
     const int hop = fftSize / 2;
-    const int availableFrames = juce::jmax(1, (samples - fftSize) / hop + 1);
-    const int frames = juce::jmin(maxFrames, availableFrames);
+    const int frames = (samples - fftSize) / hop + 1;
 
     for (int frame = 0; frame < frames; ++frame)
     {
-        const int sourceFrame = frame * availableFrames / frames;
-        const int pos = sourceFrame * hop;
+        const int pos = frame * hop;
+        std::copy(dry + pos, dry + pos + fftSize, dryData.begin());
+        std::copy(wet + pos, wet + pos + fftSize, wetData.begin());
+        window.multiplyWithWindowingTable(dryData.data(), static_cast<size_t>(fftSize));
+        window.multiplyWithWindowingTable(wetData.data(), static_cast<size_t>(fftSize));
 
-        for (int i = 0; i < fftSize; ++i)
-        {
-            const double phase = juce::MathConstants<double>::twoPi * static_cast<double>(i)
-                               / static_cast<double>(fftSize - 1);
-            const float win = static_cast<float>(0.5 - 0.5 * std::cos(phase));
-            dryIn[static_cast<size_t>(i)] = { dry[pos + i] * win, 0.0f };
-            wetIn[static_cast<size_t>(i)] = { wet[pos + i] * win, 0.0f };
-        }
-
-        fft.perform(dryIn.data(), dryOut.data(), false);
-        fft.perform(wetIn.data(), wetOut.data(), false);
+        fft.performRealOnlyForwardTransform(dryData.data(), true);
+        fft.performRealOnlyForwardTransform(wetData.data(), true);
 
         for (int bin = 1; bin < halfSize; ++bin)
         {
-            const auto x = std::complex<double>(dryOut[static_cast<size_t>(bin)].real(),
-                                                dryOut[static_cast<size_t>(bin)].imag());
-            const auto y = std::complex<double>(wetOut[static_cast<size_t>(bin)].real(),
-                                                wetOut[static_cast<size_t>(bin)].imag());
-            cross[static_cast<size_t>(bin)] += y * std::conj(x);
+            const std::complex<double> x(dryData[(size_t) (2 * bin)], dryData[(size_t) (2 * bin + 1)]);
+            const std::complex<double> y(wetData[(size_t) (2 * bin)], wetData[(size_t) (2 * bin + 1)]);
+            sxx[(size_t) bin] += std::norm(x);
+            syy[(size_t) bin] += std::norm(y);
+            sxy[(size_t) bin] += y * std::conj(x);
         }
     }
 
@@ -1215,7 +1411,7 @@ inline std::vector<PlotPoint> computeTransferGroupDelay(const juce::AudioBuffer<
 
     for (int bin = 1; bin < halfSize; ++bin)
     {
-        const auto c = cross[static_cast<size_t>(bin)];
+        const auto c = sxy[static_cast<size_t>(bin)];
         const double raw = std::atan2(c.imag(), c.real());
 
         if (hasPrevious)
@@ -1232,6 +1428,10 @@ inline std::vector<PlotPoint> computeTransferGroupDelay(const juce::AudioBuffer<
         hasPrevious = true;
     }
 
+    result.valid = true;
+    result.fftSize = fftSize;
+    result.frames = frames;
+
     const int stride = juce::jmax(1, halfSize / 900);
     for (int bin = 2; bin < halfSize; bin += stride)
     {
@@ -1241,19 +1441,50 @@ inline std::vector<PlotPoint> computeTransferGroupDelay(const juce::AudioBuffer<
         if (freq < 20.0 || freq > 20000.0)
             continue;
 
-        const auto c = cross[static_cast<size_t>(bin)];
-        if (std::abs(c) < 1.0e-9)
+        const auto c = sxy[static_cast<size_t>(bin)];
+        const double crossMagnitude = std::abs(c);
+        if (crossMagnitude < 1.0e-9)
             continue;
 
+        const auto x = static_cast<float>(freq);
+        const double powerX = sxx[(size_t) bin];
+        const double powerY = syy[(size_t) bin];
+
+        if (powerX > 0.0)
+            result.magnitudeH1Db.push_back({ x, static_cast<float>(20.0 * std::log10(crossMagnitude / powerX)) });
+
+        result.magnitudeH2Db.push_back({ x, static_cast<float>(20.0 * std::log10(juce::jmax(1.0e-18, powerY) / crossMagnitude)) });
+        result.phaseDegrees.push_back({ x, static_cast<float>(juce::radiansToDegrees(phases[(size_t) bin])) });
+
+        if (powerX > 0.0 && powerY > 0.0)
+            result.coherence.push_back({ x, static_cast<float>(juce::jlimit(0.0, 1.0, crossMagnitude * crossMagnitude / (powerX * powerY))) });
+
         const double dPhase = phases[static_cast<size_t>(bin)] - phases[static_cast<size_t>(bin - 1)];
         const double groupDelayMs = -dPhase / (juce::MathConstants<double>::twoPi * (f1 - f0)) * 1000.0;
 
         if (std::isfinite(groupDelayMs))
-            points.push_back({ static_cast<float>(freq),
-                               juce::jlimit(-20.0f, 80.0f, static_cast<float>(groupDelayMs)) });
+            result.groupDelayMs.push_back({ x, juce::jlimit(-20.0f, 80.0f, static_cast<float>(groupDelayMs)) });
     }
 
-    return points;
+    return result;
+}
+
+/** Store every curve of a transfer function on the wet asset it describes. */
+inline void applyTransferFunction(Asset& wet, TransferFunction transfer)
+{
+    wet.groupDelay = std::move(transfer.groupDelayMs);
+    wet.transferMagnitudeDb = std::move(transfer.magnitudeH1Db);
+    wet.transferMagnitudeH2Db = std::move(transfer.magnitudeH2Db);
+    wet.transferPhaseDegrees = std::move(transfer.phaseDegrees);
+    wet.transferCoherence = std::move(transfer.coherence);
+}
+
+inline std::vector<PlotPoint> computeTransferGroupDelay(const juce::AudioBuffer<float>& dryBuffer,
+                                                        const juce::AudioBuffer<float>& wetBuffer,
+                                                        double sampleRate,
+                                                        int fftOrder = 14)
+{
+    return computeTransferFunction(dryBuffer, wetBuffer, sampleRate, fftOrder).groupDelayMs;
 }
 
 enum class SpectrogramPalette
@@ -1263,100 +1494,208 @@ enum class SpectrogramPalette
     Pink
 };
 
-inline juce::Image computeSpectrogramImage(const juce::AudioBuffer<float>& buffer,
-                                           double sampleRate,
-                                           SpectrogramPalette palette,
-                                           int imageWidth = 2048,
-                                           int fftOrder = 10)
+/** One STFT of the mono mix, shared by every spectrogram palette.
+ *  logMagnitudes is column-major (columns x bins, log10 of |X|). */
+struct SpectrogramMagnitudes
 {
+    int columns = 0;
+    int bins = 0;
+    float logMax = -10.0f;
+    std::vector<float> logMagnitudes;
+
+    bool isEmpty() const noexcept   { return columns <= 0 || bins <= 0; }
+};
+
+/** Windowed FFT of one spectrogram column: log10 magnitudes of `frame`
+ *  (fftSize samples) into `column` (fftSize / 2 bins). */
+class SpectrogramColumnTransform
+{
+public:
+    explicit SpectrogramColumnTransform(int fftOrderToUse)
+        : fftSize(1 << fftOrderToUse),
+          fft(fftOrderToUse),
+          window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann),
+          fftData(static_cast<size_t>(fftSize * 2), 0.0f)
+    {
+    }
+
+    /** Returns the column's largest linear magnitude. */
+    float process(const float* frame, float* column)
+    {
+        std::fill(fftData.begin(), fftData.end(), 0.0f);
+        std::copy(frame, frame + fftSize, fftData.begin());
+
+        window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        float columnMax = 0.0f;
+        for (int bin = 0; bin < fftSize / 2; ++bin)
+        {
+            const float mag = fftData[static_cast<size_t>(bin)];
+            column[bin] = std::log10(mag + 1.0e-10f);
+            columnMax = juce::jmax(columnMax, mag);
+        }
+
+        return columnMax;
+    }
+
+private:
+    const int fftSize;
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::vector<float> fftData;
+};
+
+inline SpectrogramMagnitudes computeSpectrogramMagnitudes(const float* data,
+                                                          int samples,
+                                                          double sampleRate,
+                                                          int imageWidth = 2048,
+                                                          int fftOrder = 10)
+{
+    SpectrogramMagnitudes result;
     const int fftSize = 1 << fftOrder;
     const int halfFFT = fftSize / 2;
-    const int samples = buffer.getNumSamples();
-
-    if (sampleRate <= 0.0 || samples < fftSize || imageWidth <= 0)
-        return {};
 
-    auto mono = mixToMono(buffer);
-    const auto* data = mono.getReadPointer(0);
+    if (data == nullptr || sampleRate <= 0.0 || samples < fftSize || imageWidth <= 0)
+        return result;
 
-    juce::dsp::FFT fft(fftOrder);
-    juce::dsp::WindowingFunction<float> window(fftSize, juce::dsp::WindowingFunction<float>::hann);
-    std::vector<float> fftData(static_cast<size_t>(fftSize * 2), 0.0f);
+    SpectrogramColumnTransform transform(fftOrder);
     const int hopSize = fftSize / 4;
     const int numFrames = (samples - fftSize) / hopSize + 1;
     const int renderWidth = juce::jmin(imageWidth, numFrames);
-    std::vector<std::vector<float>> magnitudes(static_cast<size_t>(renderWidth),
-                                               std::vector<float>(static_cast<size_t>(halfFFT), 0.0f));
+
+    result.columns = renderWidth;
+    result.bins = halfFFT;
+    result.logMagnitudes.resize(static_cast<size_t>(renderWidth) * static_cast<size_t>(halfFFT));
 
     float globalMax = 1.0e-10f;
     for (int col = 0; col < renderWidth; ++col)
     {
-        const int frameIndex = col * numFrames / renderWidth;
-        const int pos = frameIndex * hopSize;
-        std::fill(fftData.begin(), fftData.end(), 0.0f);
-
-        for (int i = 0; i < fftSize; ++i)
-            fftData[static_cast<size_t>(i)] = data[pos + i];
+        const int frameIndex = static_cast<int>(static_cast<juce::int64>(col) * numFrames / renderWidth);
+        auto* column = result.logMagnitudes.data() + static_cast<size_t>(col) * static_cast<size_t>(halfFFT);
+        globalMax = juce::jmax(globalMax, transform.process(data + static_cast<size_t>(frameIndex) * static_cast<size_t>(hopSize), column));
+    }
 
-        window.multiplyWithWindowingTable(fftData.data(), fftSize);
-        fft.performFrequencyOnlyForwardTransform(fftData.data());
+    result.logMax = std::log10(globalMax + 1.0e-10f);
+    return result;
+}
 
-        for (int bin = 0; bin < halfFFT; ++bin)
-        {
-            const float mag = fftData[static_cast<size_t>(bin)];
-            magnitudes[static_cast<size_t>(col)][static_cast<size_t>(bin)] = mag;
-            globalMax = juce::jmax(globalMax, mag);
-        }
+/** Palette colour for a normalised level (0 = 80 dB below the peak, 1 = peak). */
+inline juce::Colour spectrogramPaletteColour(SpectrogramPalette palette, float norm)
+{
+    juce::Colour c;
+    if (palette == SpectrogramPalette::Yellow)
+    {
+        if (norm < 0.3f)
+            c = juce::Colour(0xFF0A0A04).interpolatedWith(juce::Colour(0xFF8B6600), norm / 0.3f);
+        else if (norm < 0.6f)
+            c = juce::Colour(0xFF8B6600).interpolatedWith(juce::Colour(0xFFFFD700), (norm - 0.3f) / 0.3f);
+        else
+            c = juce::Colour(0xFFFFD700).interpolatedWith(juce::Colour(0xFFFFF8E8), (norm - 0.6f) / 0.4f);
+    }
+    else if (palette == SpectrogramPalette::Pink)
+    {
+        if (norm < 0.3f)
+            c = juce::Colour(0xFF140812).interpolatedWith(juce::Colour(0xFF9A1E65), norm / 0.3f);
+        else if (norm < 0.6f)
+            c = juce::Colour(0xFF9A1E65).interpolatedWith(juce::Colour(0xFFFF3E91), (norm - 0.3f) / 0.3f);
+        else
+            c = juce::Colour(0xFFFF3E91).interpolatedWith(juce::Colour(0xFFFFE8F4), (norm - 0.6f) / 0.4f);
     }
+    else
+    {
+        if (norm < 0.3f)
+            c = juce::Colour(0xFF0A0A18).interpolatedWith(juce::Colour(0xFF2244AA), norm / 0.3f);
+        else if (norm < 0.6f)
+            c = juce::Colour(0xFF2244AA).interpolatedWith(juce::Colour(0xFF40C8E0), (norm - 0.3f) / 0.3f);
+        else
+            c = juce::Colour(0xFF40C8E0).interpolatedWith(juce::Colour(0xFFE8E4F0), (norm - 0.6f) / 0.4f);
+    }
+
+    return c;
+}
+
+/** The palette sampled at kSpectrogramLutSize levels, as premultiplied pixels. */
+constexpr int kSpectrogramLutSize = 1024;
+
+inline const std::array<juce::PixelARGB, kSpectrogramLutSize>& spectrogramPaletteLut(SpectrogramPalette palette)
+{
+    using Lut = std::array<juce::PixelARGB, kSpectrogramLutSize>;
+    static const std::array<Lut, 3> luts = []
+    {
+        std::array<Lut, 3> result;
+        const SpectrogramPalette palettes[] = { SpectrogramPalette::Blue, SpectrogramPalette::Yellow, SpectrogramPalette::Pink };
+
+        for (size_t p = 0; p < result.size(); ++p)
+            for (int i = 0; i < kSpectrogramLutSize; ++i)
+                result[p][(size_t) i] = spectrogramPaletteColour(palettes[p], static_cast<float>(i) / static_cast<float>(kSpectrogramLutSize - 1))
+                                            .getPixelARGB();
+        return result;
+    }();
 
-    const float logMax = std::log10(globalMax + 1.0e-10f);
+    return luts[palette == SpectrogramPalette::Yellow ? 1 : palette == SpectrogramPalette::Pink ? 2 : 0];
+}
+
+inline juce::Image renderSpectrogramImage(const SpectrogramMagnitudes& magnitudes, SpectrogramPalette palette)
+{
+    if (magnitudes.isEmpty())
+        return {};
+
+    const int renderWidth = magnitudes.columns;
+    const int halfFFT = magnitudes.bins;
+    const auto& lut = spectrogramPaletteLut(palette);
     juce::Image image(juce::Image::ARGB, renderWidth, halfFFT, true);
 
-    for (int col = 0; col < renderWidth; ++col)
+    // level = (logMag - (logMax - 4)) / 4 (four decades of magnitude: 80 dB),
+    // scaled straight to a LUT index
+    const float scale = 0.25f * static_cast<float>(kSpectrogramLutSize - 1);
+    const float offset = 0.5f - (magnitudes.logMax - 4.0f) * scale;   // +0.5: round on truncation
+
+    // Columns are converted in tiles of 16 so the pixel writes go out as
+    // contiguous 64-byte row runs instead of one cache line per pixel
+    constexpr int tileWidth = 16;
+    std::vector<float> levels(static_cast<size_t>(tileWidth * halfFFT));
+
+    juce::Image::BitmapData bitmap(image, juce::Image::BitmapData::writeOnly);
+    jassert(bitmap.pixelFormat == juce::Image::ARGB && bitmap.pixelStride == 4);
+
+    for (int tileStart = 0; tileStart < renderWidth; tileStart += tileWidth)
     {
-        for (int bin = 0; bin < halfFFT; ++bin)
-        {
-            const float mag = magnitudes[static_cast<size_t>(col)][static_cast<size_t>(bin)];
-            const float logMag = std::log10(mag + 1.0e-10f);
-            const float norm = juce::jlimit(0.0f, 1.0f, (logMag - (logMax - 4.0f)) / 4.0f);
+        const int tileColumns = juce::jmin(tileWidth, renderWidth - tileStart);
 
-            juce::Colour c;
-            if (palette == SpectrogramPalette::Yellow)
-            {
-                if (norm < 0.3f)
-                    c = juce::Colour(0xFF0A0A04).interpolatedWith(juce::Colour(0xFF8B6600), norm / 0.3f);
-                else if (norm < 0.6f)
-                    c = juce::Colour(0xFF8B6600).interpolatedWith(juce::Colour(0xFFFFD700), (norm - 0.3f) / 0.3f);
-                else
-                    c = juce::Colour(0xFFFFD700).interpolatedWith(juce::Colour(0xFFFFF8E8), (norm - 0.6f) / 0.4f);
-            }
-            else if (palette == SpectrogramPalette::Pink)
-            {
-                if (norm < 0.3f)
-                    c = juce::Colour(0xFF140812).interpolatedWith(juce::Colour(0xFF9A1E65), norm / 0.3f);
-                else if (norm < 0.6f)
-                    c = juce::Colour(0xFF9A1E65).interpolatedWith(juce::Colour(0xFFFF3E91), (norm - 0.3f) / 0.3f);
-                else
-                    c = juce::Colour(0xFFFF3E91).interpolatedWith(juce::Colour(0xFFFFE8F4), (norm - 0.6f) / 0.4f);
-            }
-            else
-            {
-                if (norm < 0.3f)
-                    c = juce::Colour(0xFF0A0A18).interpolatedWith(juce::Colour(0xFF2244AA), norm / 0.3f);
-                else if (norm < 0.6f)
-                    c = juce::Colour(0xFF2244AA).interpolatedWith(juce::Colour(0xFF40C8E0), (norm - 0.3f) / 0.3f);
-                else
-                    c = juce::Colour(0xFF40C8E0).interpolatedWith(juce::Colour(0xFFE8E4F0), (norm - 0.6f) / 0.4f);
-            }
+        for (int t = 0; t < tileColumns; ++t)
+        {
+            const auto* column = magnitudes.logMagnitudes.data() + static_cast<size_t>(tileStart + t) * static_cast<size_t>(halfFFT);
+            auto* dest = levels.data() + static_cast<size_t>(t * halfFFT);
+            juce::FloatVectorOperations::multiply(dest, column, scale, halfFFT);
+            juce::FloatVectorOperations::add(dest, offset, halfFFT);
+            juce::FloatVectorOperations::clip(dest, dest, 0.0f, static_cast<float>(kSpectrogramLutSize - 1), halfFFT);
+        }
 
-            const int y = halfFFT - 1 - bin;
-            image.setPixelAt(col, y, c);
+        // Bin 0 is the bottom row
+        for (int bin = 0; bin < halfFFT; ++bin)
+        {
+            auto* row = reinterpret_cast<juce::PixelARGB*>(bitmap.getPixelPointer(tileStart, halfFFT - 1 - bin));
+            for (int t = 0; t < tileColumns; ++t)
+                row[t] = lut[static_cast<size_t>(levels[static_cast<size_t>(t * halfFFT + bin)])];
         }
     }
 
     return image;
 }
 
+inline juce::Image computeSpectrogramImage(const juce::AudioBuffer<float>& buffer,
+                                           double sampleRate,
+                                           SpectrogramPalette palette,
+                                           int imageWidth = 2048,
+                                           int fftOrder = 10)
+{
+    const auto mono = mixToMono(buffer);
+    return renderSpectrogramImage(computeSpectrogramMagnitudes(mono.getReadPointer(0), mono.getNumSamples(),
+                                                               sampleRate, imageWidth, fftOrder),
+                                  palette);
+}
+
 inline juce::Image computeSpectrogramImage(const juce::AudioBuffer<float>& buffer,
                                            double sampleRate,
                                            bool useYellow,
@@ -1370,49 +1709,730 @@ inline juce::Image computeSpectrogramImage(const juce::AudioBuffer<float>& buffe
                                    fftOrder);
 }
 
+//==============================================================================
+/** The buffer-free counterpart of refreshAnalysis() for files too long to
+ *  hold in memory. The source is pushed through in blocks of any size, in
+ *  order; memory is bounded by the block plus the fixed-size accumulators
+ *  (one spectrogram's worth of magnitudes), independent of file length.
+ *
+ *  Metrics (peak, true peak, RMS, crest), the peak envelope, RMS envelope,
+ *  Welch spectrum with its peaks and the spectrograms match the in-memory
+ *  stages sample for sample (the RMS sum differs only in summation order).
+ *  The onset-relative stages (energy decay, reverb space, dynamics) need
+ *  the whole signal and are left empty. */
+class StreamingAssetAnalyzer
+{
+public:
+    StreamingAssetAnalyzer(juce::int64 totalSamplesToExpect,
+                           double sampleRateToUse,
+                           int maxPoints = 1200,
+                           double rmsWindowMs = 50.0,
+                           int spectrumFftOrder = 14,
+                           int imageWidth = 2048,
+                           int spectrogramFftOrder = 10)
+        : totalSamples(juce::jmax(juce::int64 (0), totalSamplesToExpect)),
+          sampleRate(sampleRateToUse),
+          pointCount(static_cast<int>(juce::jmin(static_cast<juce::int64>(maxPoints), totalSamples))),
+          rmsWindow(juce::jmax(16, static_cast<int>(sampleRateToUse * rmsWindowMs / 1000.0))),
+          welch(clampSpectrumOrder(spectrumFftOrder, totalSamples)),
+          stftSize(1 << spectrogramFftOrder),
+          stftHop(stftSize / 4),
+          transform(spectrogramFftOrder)
+    {
+        rmsSums.assign(static_cast<size_t>(juce::jmax(0, pointCount)), 0.0);
+        envelope.reserve(static_cast<size_t>(juce::jmax(0, pointCount)));
+        rmsEnvelope.reserve(static_cast<size_t>(juce::jmax(0, pointCount)));
+
+        if (totalSamples >= stftSize && imageWidth > 0)
+        {
+            stftFrames = (totalSamples - stftSize) / stftHop + 1;
+            stft.columns = static_cast<int>(juce::jmin(static_cast<juce::int64>(imageWidth), stftFrames));
+            stft.bins = stftSize / 2;
+            stft.logMagnitudes.resize(static_cast<size_t>(stft.columns) * static_cast<size_t>(stft.bins));
+        }
+    }
+
+    /** Feed the next block of the stereo signal (pass the same pointer twice for mono). */
+    void push(const float* left, const float* right, int numSamples)
+    {
+        numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples), totalSamples - position));
+        if (numSamples <= 0)
+            return;
+
+        const float* channels[] = { left, right };
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const auto* data = channels[ch];
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float v = data[i];
+                peak = juce::jmax(peak, std::abs(v));
+                sumSquares[ch] += static_cast<double>(v) * static_cast<double>(v);
+            }
+
+            truePeak = juce::jmax(truePeak, truePeakFilters[(size_t) ch].process(data, numSamples));
+        }
+
+        // Same mix as mixToMono(): 0.5 * L + 0.5 * R
+        mono.resize(static_cast<size_t>(numSamples));
+        juce::FloatVectorOperations::copyWithMultiply(mono.data(), left, 0.5f, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(mono.data(), right, 0.5f, numSamples);
+
+        pushEnvelope(mono.data(), numSamples);
+        pushRmsEnvelope(mono.data(), numSamples);
+        welch.push(mono.data(), numSamples);
+        pushSpectrogram(mono.data(), numSamples);
+
+        position += numSamples;
+    }
+
+    juce::int64 getSamplesPushed() const noexcept   { return position; }
+
+    /** Store the results on `asset` once every sample has been pushed. */
+    void finishInto(Asset& asset)
+    {
+        jassert(position == totalSamples);
+
+        auto& m = asset.metrics;
+        m = {};
+        m.sampleRate = sampleRate;
+        m.channels = 2;
+        m.samples = totalSamples;
+        m.durationSeconds = sampleRate > 0.0 ? static_cast<double>(totalSamples) / sampleRate : 0.0;
+
+        // Flush the interpolators, as measureTruePeak() does
+        const std::array<float, TruePeakFilter::kHistory> tail {};
+        for (auto& filter : truePeakFilters)
+            truePeak = juce::jmax(truePeak, filter.process(tail.data(), static_cast<int>(tail.size())));
+
+        const auto count = 2.0 * static_cast<double>(totalSamples);
+        const float rms = totalSamples > 0 ? static_cast<float>(std::sqrt((sumSquares[0] + sumSquares[1]) / count)) : 0.0f;
+        m.peakDb = safeGainToDb(peak);
+        m.truePeakDb = safeGainToDb(juce::jmax(peak, truePeak));
+        m.rmsDb = safeGainToDb(rms);
+        m.crestDb = m.peakDb - m.rmsDb;
+
+        asset.envelope = envelope;
+        asset.dynamicsRms = rmsEnvelope;
+        asset.energyDecay.clear();
+        asset.spaceMetrics = {};
+        asset.dynamicsMetrics = {};
+
+        asset.spectrum = totalSamples >= welch.getFftSize() ? logSpectrumPoints(welch, sampleRate) : std::vector<PlotPoint> {};
+        asset.spectrumPeaks = computeSpectrumPeaks(asset.spectrum);
+        asset.harmonicPeaks = selectHarmonicPeaks(asset.spectrumPeaks);
+
+        stft.logMax = std::log10(stftMax + 1.0e-10f);
+        asset.spectrogramBlue = renderSpectrogramImage(stft, SpectrogramPalette::Blue);
+        asset.spectrogramYellow = renderSpectrogramImage(stft, SpectrogramPalette::Yellow);
+        asset.spectrogramPink = renderSpectrogramImage(stft, SpectrogramPalette::Pink);
+        asset.analysisTimings.clear();
+    }
+
+private:
+    static int clampSpectrumOrder(int fftOrder, juce::int64 samples)
+    {
+        // As computeAverageSpectrumMono(): shrink the FFT for short signals
+        while (fftOrder > 11 && samples < (juce::int64 (1) << fftOrder))
+            --fftOrder;
+        return fftOrder;
+    }
+
+    juce::int64 pointStart(int p) const noexcept   { return static_cast<juce::int64>(p) * totalSamples / pointCount; }
+
+    void pushEnvelope(const float* data, int numSamples)
+    {
+        // Point p covers [pointStart(p), pointStart(p + 1)), back to back
+        for (int i = 0; i < numSamples && envelopePoint < pointCount;)
+        {
+            const auto end = pointStart(envelopePoint + 1);
+            const int run = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples - i), end - (position + i)));
+
+            for (int k = 0; k < run; ++k)
+                envelopePeak = juce::jmax(envelopePeak, std::abs(data[i + k]));
+            i += run;
+
+            if (position + i >= end)
+            {
+                envelope.push_back({ static_cast<float>(static_cast<double>(pointStart(envelopePoint)) / sampleRate), safeGainToDb(envelopePeak) });
+                envelopePeak = 0.0f;
+                ++envelopePoint;
+            }
+        }
+    }
+
+    void pushRmsEnvelope(const float* data, int numSamples)
+    {
+        // Windows overlap but their starts and ends are both increasing, so the
+        // open windows are a contiguous run of points beginning at rmsFirstOpen
+        const auto blockEnd = position + numSamples;
+        for (int p = rmsFirstOpen; p < pointCount; ++p)
+        {
+            const auto centre = pointStart(p);
+            const auto start = juce::jlimit(juce::int64 (0), totalSamples, centre - rmsWindow / 2);
+            const auto end = juce::jlimit(start + 1, totalSamples, centre + rmsWindow / 2);
+            if (start >= blockEnd)
+                break;
+
+            auto& sum = rmsSums[(size_t) p];
+            for (auto i = juce::jmax(start, position); i < juce::jmin(end, blockEnd); ++i)
+            {
+                const auto v = static_cast<double>(data[i - position]);
+                sum += v * v;
+            }
+
+            if (end <= blockEnd && p == rmsFirstOpen)
+            {
+                const float rms = static_cast<float>(std::sqrt(sum / static_cast<double>(end - start)));
+                rmsEnvelope.push_back({ static_cast<float>(static_cast<double>(centre) / sampleRate), safeGainToDb(rms) });
+                ++rmsFirstOpen;
+            }
+        }
+    }
+
+    juce::int64 columnStart(int column) const noexcept
+    {
+        return static_cast<juce::int64>(column) * stftFrames / stft.columns * stftHop;
+    }
+
+    void pushSpectrogram(const float* data, int numSamples)
+    {
+        if (stftColumn >= stft.columns)
+            return;
+
+        // Hold samples from the next column's start onwards; columns can be
+        // closer together than one FFT or far apart
+        const auto keepFrom = columnStart(stftColumn);
+        const auto blockStart = position;
+        const auto skip = static_cast<int>(juce::jlimit(juce::int64 (0), static_cast<juce::int64>(numSamples), keepFrom - blockStart));
+        if (pending.empty())
+            pendingStart = blockStart + skip;
+        pending.insert(pending.end(), data + skip, data + numSamples);
+
+        const auto available = pendingStart + static_cast<juce::int64>(pending.size());
+        while (stftColumn < stft.columns && columnStart(stftColumn) + stftSize <= available)
+        {
+            auto* column = stft.logMagnitudes.data() + static_cast<size_t>(stftColumn) * static_cast<size_t>(stft.bins);
+            stftMax = juce::jmax(stftMax, transform.process(pending.data() + (columnStart(stftColumn) - pendingStart), column));
+            ++stftColumn;
+        }
+
+        const auto dropTo = stftColumn < stft.columns ? juce::jmin(columnStart(stftColumn), available) : available;
+        pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(dropTo - pendingStart));
+        pendingStart = dropTo;
+    }
+
+    const juce::int64 totalSamples;
+    const double sampleRate;
+    const int pointCount;
+    const int rmsWindow;
+    juce::int64 position = 0;
+
+    float peak = 0.0f;
+    float truePeak = 0.0f;
+    std::array<double, 2> sumSquares {};
+    std::array<TruePeakFilter, 2> truePeakFilters;
+    std::vector<float> mono;
+
+    std::vector<PlotPoint> envelope;
+    int envelopePoint = 0;
+    float envelopePeak = 0.0f;
+
+    std::vector<PlotPoint> rmsEnvelope;
+    std::vector<double> rmsSums;
+    int rmsFirstOpen = 0;
+
+    WelchSpectrumAccumulator welch;
+
+    const int stftSize;
+    const int stftHop;
+    juce::int64 stftFrames = 0;
+    SpectrogramColumnTransform transform;
+    SpectrogramMagnitudes stft;
+    int stftColumn = 0;
+    float stftMax = 1.0e-10f;
+    std::vector<float> pending;
+    juce::int64 pendingStart = 0;
+};
+
+/** Adds every refreshAnalysis() stage of `asset` to `graph`. The stages only
+ *  read asset.buffer and each writes its own Asset fields, so independent
+ *  stages (and stages of different assets) run concurrently. */
+inline void addAnalysisTasks(AnalysisTaskGraph& graph, Asset& asset)
+{
+    // One mono mix and one STFT feed the spectrum and all three palettes
+    struct Shared
+    {
+        juce::AudioBuffer<float> mono;
+        SpectrogramMagnitudes stft;
+    };
+
+    auto shared = std::make_shared<Shared>();
+    Asset* a = &asset;
+
+    graph.addTask("metrics", [a] { a->metrics = computeMetrics(a->buffer, a->sampleRate); });
+    graph.addTask("envelope", [a] { a->envelope = computeEnvelope(a->buffer, a->sampleRate); });
+
+    const auto decay = graph.addTask("energyDecay", [a] { a->energyDecay = computeEnergyDecayCurve(a->buffer, a->sampleRate); });
+    graph.addTask("reverbSpace", [a] { a->spaceMetrics = computeReverbSpaceMetrics(a->buffer, a->sampleRate, a->energyDecay); }, { decay });
+
+    const auto rms = graph.addTask("rmsEnvelope", [a] { a->dynamicsRms = computeRmsEnvelope(a->buffer, a->sampleRate); });
+    graph.addTask("dynamics", [a] { a->dynamicsMetrics = computeDynamicsMetrics(a->buffer, a->sampleRate, a->dynamicsRms); }, { rms });
+
+    const auto mono = graph.addTask("monoMix", [a, shared] { shared->mono = mixToMono(a->buffer); });
+
+    const auto spectrum = graph.addTask("spectrum", [a, shared]
+    {
+        a->spectrum = computeAverageSpectrumMono(shared->mono.getReadPointer(0), shared->mono.getNumSamples(), a->sampleRate);
+    }, { mono });
+
+    graph.addTask("spectrumPeaks", [a]
+    {
+        a->spectrumPeaks = computeSpectrumPeaks(a->spectrum);
+        a->harmonicPeaks = selectHarmonicPeaks(a->spectrumPeaks);
+    }, { spectrum });
+
+    const auto stft = graph.addTask("stft", [a, shared]
+    {
+        shared->stft = computeSpectrogramMagnitudes(shared->mono.getReadPointer(0), shared->mono.getNumSamples(), a->sampleRate);
+    }, { mono });
+
+    graph.addTask("spectrogramBlue", [a, shared] { a->spectrogramBlue = renderSpectrogramImage(shared->stft, SpectrogramPalette::Blue); }, { stft });
+    graph.addTask("spectrogramYellow", [a, shared] { a->spectrogramYellow = renderSpectrogramImage(shared->stft, SpectrogramPalette::Yellow); }, { stft });
+    graph.addTask("spectrogramPink", [a, shared] { a->spectrogramPink = renderSpectrogramImage(shared->stft, SpectrogramPalette::Pink); }, { stft });
+}
+
+/** Analyse several assets in one graph; each asset keeps the timings of its own stages. */
+inline void refreshAnalysis(const std::vector<Asset*>& assets)
+{
+    AnalysisTaskGraph graph;
+    std::vector<int> firstTask;
+
+    for (auto* asset : assets)
+    {
+        firstTask.push_back(graph.getNumTasks());
+        if (asset != nullptr)
+            addAnalysisTasks(graph, *asset);
+    }
+
+    graph.run();
+
+    const auto timings = graph.getTimings();
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        if (assets[i] == nullptr)
+            continue;
+
+        const auto begin = timings.begin() + firstTask[i];
+        const auto end = i + 1 < assets.size() ? timings.begin() + firstTask[i + 1] : timings.end();
+        assets[i]->analysisTimings.assign(begin, end);
+    }
+}
+
 inline void refreshAnalysis(Asset& asset)
 {
-    asset.metrics = computeMetrics(asset.buffer, asset.sampleRate);
-    asset.envelope = computeEnvelope(asset.buffer, asset.sampleRate);
-    asset.energyDecay = computeEnergyDecayCurve(asset.buffer, asset.sampleRate);
-    asset.dynamicsRms = computeRmsEnvelope(asset.buffer, asset.sampleRate);
-    asset.spaceMetrics = computeReverbSpaceMetrics(asset.buffer, asset.sampleRate, asset.energyDecay);
-    asset.dynamicsMetrics = computeDynamicsMetrics(asset.buffer, asset.sampleRate, asset.dynamicsRms);
-    asset.spectrum = computeAverageSpectrum(asset.buffer, asset.sampleRate);
-    asset.spectrumPeaks = computeSpectrumPeaks(asset.spectrum);
-    asset.harmonicPeaks = selectHarmonicPeaks(asset.spectrumPeaks);
-    asset.spectrogramBlue = computeSpectrogramImage(asset.buffer, asset.sampleRate, SpectrogramPalette::Blue);
-    asset.spectrogramYellow = computeSpectrogramImage(asset.buffer, asset.sampleRate, SpectrogramPalette::Yellow);
-    asset.spectrogramPink = computeSpectrogramImage(asset.buffer, asset.sampleRate, SpectrogramPalette::Pink);
+    refreshAnalysis(std::vector<Asset*> { &asset });
 }
 
-inline bool readAudioFile(const juce::File& file, Asset& out, juce::String& error)
+inline juce::var analysisTimingsToVar(const Asset& asset)
+{
+    juce::Array<juce::var> stages;
+    for (const auto& timing : asset.analysisTimings)
+    {
+        auto stage = std::make_unique<juce::DynamicObject>();
+        stage->setProperty("stage", timing.name);
+        stage->setProperty("startMs", timing.startMs);
+        stage->setProperty("durationMs", timing.durationMs);
+        stage->setProperty("thread", timing.thread);
+        stages.add(juce::var(stage.release()));
+    }
+    return stages;
+}
+
+//==============================================================================
+// Cached analysis (AnalysisResultCache). Bump kAnalysisCacheVersion whenever
+// refreshAnalysis() or one of the compute* functions changes its output.
+//==============================================================================
+constexpr int kAnalysisCacheVersion = 3;
+
+inline void writePlotPoints(juce::OutputStream& out, const std::vector<PlotPoint>& points)
+{
+    out.writeInt(static_cast<int>(points.size()));
+    for (const auto& p : points)
+    {
+        out.writeFloat(p.x);
+        out.writeFloat(p.y);
+    }
+}
+
+inline bool readPlotPoints(juce::InputStream& in, std::vector<PlotPoint>& points)
 {
-    juce::AudioFormatManager formats;
-    formats.registerBasicFormats();
+    const int count = in.readInt();
+    if (count < 0 || static_cast<juce::int64>(count) * 8 > in.getNumBytesRemaining())
+        return false;
+
+    points.resize(static_cast<size_t>(count));
+    for (auto& p : points)
+    {
+        p.x = in.readFloat();
+        p.y = in.readFloat();
+    }
+    return true;
+}
+
+inline void writeSpectrumPeaks(juce::OutputStream& out, const std::vector<SpectrumPeak>& peaks)
+{
+    out.writeInt(static_cast<int>(peaks.size()));
+    for (const auto& p : peaks)
+    {
+        out.writeFloat(p.frequencyHz);
+        out.writeFloat(p.magnitudeDb);
+        out.writeInt(p.harmonicNumber);
+        out.writeFloat(p.expectedHz);
+        out.writeFloat(p.deltaCents);
+        out.writeBool(p.nearHarmonic);
+    }
+}
+
+inline bool readSpectrumPeaks(juce::InputStream& in, std::vector<SpectrumPeak>& peaks)
+{
+    const int count = in.readInt();
+    if (count < 0 || static_cast<juce::int64>(count) * 21 > in.getNumBytesRemaining())
+        return false;
+
+    peaks.resize(static_cast<size_t>(count));
+    for (auto& p : peaks)
+    {
+        p.frequencyHz = in.readFloat();
+        p.magnitudeDb = in.readFloat();
+        p.harmonicNumber = in.readInt();
+        p.expectedHz = in.readFloat();
+        p.deltaCents = in.readFloat();
+        p.nearHarmonic = in.readBool();
+    }
+    return true;
+}
+
+inline void writeImagePng(juce::OutputStream& out, const juce::Image& image)
+{
+    juce::MemoryOutputStream png;
+    if (image.isValid())
+        juce::PNGImageFormat().writeImageToStream(image, png);
+
+    out.writeInt(static_cast<int>(png.getDataSize()));
+    out.write(png.getData(), png.getDataSize());
+}
+
+inline bool readImagePng(juce::InputStream& in, juce::Image& image)
+{
+    const int size = in.readInt();
+    if (size < 0 || size > in.getNumBytesRemaining())
+        return false;
+
+    image = {};
+    if (size == 0)
+        return true;
+
+    juce::MemoryBlock png;
+    in.readIntoMemoryBlock(png, size);
+    image = juce::ImageFileFormat::loadFrom(png.getData(), png.getSize());
+    return image.isValid();
+}
+
+/** Everything refreshAnalysis() derives from the buffer, as one cache payload. */
+inline juce::MemoryBlock serialiseAnalysis(const Asset& asset)
+{
+    juce::MemoryOutputStream out;
+
+    const auto& m = asset.metrics;
+    out.writeDouble(m.sampleRate);
+    out.writeInt(m.channels);
+    out.writeInt64(m.samples);
+    out.writeDouble(m.durationSeconds);
+    for (auto v : { m.peakDb, m.truePeakDb, m.rmsDb, m.crestDb })
+        out.writeFloat(v);
+
+    const auto& r = asset.spaceMetrics;
+    out.writeBool(r.valid);
+    for (auto v : { r.onsetSeconds, r.tailEndSeconds, r.directEnergyDb, r.earlyEnergyDb, r.lateEnergyDb,
+                    r.drrDb, r.earlyLateDb, r.rt20Seconds, r.rt30Seconds, r.rt60Seconds,
+                    r.stereoCorrelation, r.sideToMidDb })
+        out.writeFloat(v);
+
+    const auto& d = asset.dynamicsMetrics;
+    out.writeBool(d.valid);
+    for (auto v : { d.rmsRangeDb, d.rmsP10Db, d.rmsP50Db, d.rmsP90Db, d.transientToSustainDb, d.onsetSeconds })
+        out.writeFloat(v);
+
+    writePlotPoints(out, asset.envelope);
+    writePlotPoints(out, asset.energyDecay);
+    writePlotPoints(out, asset.dynamicsRms);
+    writePlotPoints(out, asset.spectrum);
+    writeSpectrumPeaks(out, asset.spectrumPeaks);
+    writeSpectrumPeaks(out, asset.harmonicPeaks);
+    writeImagePng(out, asset.spectrogramBlue);
+    writeImagePng(out, asset.spectrogramYellow);
+    writeImagePng(out, asset.spectrogramPink);
+
+    return out.getMemoryBlock();
+}
+
+inline bool deserialiseAnalysis(const juce::MemoryBlock& payload, Asset& asset)
+{
+    juce::MemoryInputStream in(payload, false);
+    Asset decoded;
+
+    auto& m = decoded.metrics;
+    m.sampleRate = in.readDouble();
+    m.channels = in.readInt();
+    m.samples = in.readInt64();
+    m.durationSeconds = in.readDouble();
+    for (auto* v : { &m.peakDb, &m.truePeakDb, &m.rmsDb, &m.crestDb })
+        *v = in.readFloat();
+
+    auto& r = decoded.spaceMetrics;
+    r.valid = in.readBool();
+    for (auto* v : { &r.onsetSeconds, &r.tailEndSeconds, &r.directEnergyDb, &r.earlyEnergyDb, &r.lateEnergyDb,
+                     &r.drrDb, &r.earlyLateDb, &r.rt20Seconds, &r.rt30Seconds, &r.rt60Seconds,
+                     &r.stereoCorrelation, &r.sideToMidDb })
+        *v = in.readFloat();
+
+    auto& d = decoded.dynamicsMetrics;
+    d.valid = in.readBool();
+    for (auto* v : { &d.rmsRangeDb, &d.rmsP10Db, &d.rmsP50Db, &d.rmsP90Db, &d.transientToSustainDb, &d.onsetSeconds })
+        *v = in.readFloat();
+
+    if (! (readPlotPoints(in, decoded.envelope)
+           && readPlotPoints(in, decoded.energyDecay)
+           && readPlotPoints(in, decoded.dynamicsRms)
+           && readPlotPoints(in, decoded.spectrum)
+           && readSpectrumPeaks(in, decoded.spectrumPeaks)
+           && readSpectrumPeaks(in, decoded.harmonicPeaks)
+           && readImagePng(in, decoded.spectrogramBlue)
+           && readImagePng(in, decoded.spectrogramYellow)
+           && readImagePng(in, decoded.spectrogramPink)))
+        return false;
+
+    asset.metrics = decoded.metrics;
+    asset.spaceMetrics = decoded.spaceMetrics;
+    asset.dynamicsMetrics = decoded.dynamicsMetrics;
+    asset.envelope = std::move(decoded.envelope);
+    asset.energyDecay = std::move(decoded.energyDecay);
+    asset.dynamicsRms = std::move(decoded.dynamicsRms);
+    asset.spectrum = std::move(decoded.spectrum);
+    asset.spectrumPeaks = std::move(decoded.spectrumPeaks);
+    asset.harmonicPeaks = std::move(decoded.harmonicPeaks);
+    asset.spectrogramBlue = decoded.spectrogramBlue;
+    asset.spectrogramYellow = decoded.spectrogramYellow;
+    asset.spectrogramPink = decoded.spectrogramPink;
+    asset.analysisTimings.clear();
+    return true;
+}
+
+/** refreshAnalysis() through the on-disk cache. contentHash identifies the
+ *  unedited source; pass an empty hash for anything derived or edited. */
+inline void refreshAnalysisCached(Asset& asset, const juce::String& contentHash)
+{
+    auto& cache = AnalysisResultCache::getInstance();
+    juce::MemoryBlock payload;
+
+    if (cache.load(contentHash, "audio-doctor", kAnalysisCacheVersion, payload)
+        && deserialiseAnalysis(payload, asset))
+        return;
+
+    refreshAnalysis(asset);
+    cache.store(contentHash, "audio-doctor", kAnalysisCacheVersion, serialiseAnalysis(asset));
+}
+
+//==============================================================================
+// Job artifacts: a whole asset (audio, analysis, stage markers) so JobRunner
+// can reuse generated signals and plugin renders whose inputs are unchanged
+//==============================================================================
+constexpr int kJobArtifactVersion = 2;
 
-    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+/** "artifact-fnv1a64:<hex>" over the given key parts; the analysis version is
+ *  always part of the key, so a new analyser never reuses old artifacts. */
+inline juce::String makeArtifactKey(const juce::StringArray& parts)
+{
+    const auto text = parts.joinIntoString("\n") + "\nanalysis.v" + juce::String(kAnalysisCacheVersion);
+    const auto hash = fnv1a64Bytes(text.toRawUTF8(), static_cast<size_t>(text.getNumBytesAsUTF8()));
+    return "artifact-fnv1a64:" + juce::String::toHexString(static_cast<juce::int64>(hash));
+}
+
+/** Content identity of in-memory audio: sample rate, shape and every sample. */
+inline juce::String hashAudioBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    const int shape[] = { buffer.getNumChannels(), buffer.getNumSamples() };
+    auto hash = fnv1a64Bytes(&sampleRate, sizeof(sampleRate));
+    hash = fnv1a64Bytes(shape, sizeof(shape), hash);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        hash = fnv1a64Bytes(buffer.getReadPointer(ch), sizeof(float) * static_cast<size_t>(buffer.getNumSamples()), hash);
+
+    return "audio-fnv1a64:" + juce::String::toHexString(static_cast<juce::int64>(hash));
+}
+
+inline void writeAssetArtifact(juce::OutputStream& out, const Asset& asset)
+{
+    out.writeString(asset.name);
+    out.writeString(asset.sourcePath);
+    out.writeDouble(asset.sampleRate);
+    out.writeBool(asset.generatedSignal);
+
+    out.writeInt(static_cast<int>(asset.stageMarkers.size()));
+    for (const auto& marker : asset.stageMarkers)
+    {
+        out.writeString(marker.label);
+        out.writeDouble(marker.startSec);
+        out.writeDouble(marker.endSec);
+    }
+
+    out.writeInt(asset.buffer.getNumChannels());
+    out.writeInt(asset.buffer.getNumSamples());
+    for (int ch = 0; ch < asset.buffer.getNumChannels(); ++ch)
+        out.write(asset.buffer.getReadPointer(ch), sizeof(float) * static_cast<size_t>(asset.buffer.getNumSamples()));
+
+    const auto analysis = serialiseAnalysis(asset);
+    out.writeInt64(static_cast<juce::int64>(analysis.getSize()));
+    out.write(analysis.getData(), analysis.getSize());
+}
+
+inline bool readAssetArtifact(juce::InputStream& in, Asset& asset)
+{
+    Asset decoded;
+    decoded.name = in.readString();
+    decoded.sourcePath = in.readString();
+    decoded.sampleRate = in.readDouble();
+    decoded.generatedSignal = in.readBool();
+
+    const int markers = in.readInt();
+    if (markers < 0 || markers > 4096)
+        return false;
+
+    for (int i = 0; i < markers; ++i)
+    {
+        StageMarker marker;
+        marker.label = in.readString();
+        marker.startSec = in.readDouble();
+        marker.endSec = in.readDouble();
+        decoded.stageMarkers.push_back(marker);
+    }
+
+    const int channels = in.readInt();
+    const int samples = in.readInt();
+    if (channels < 0 || channels > 64 || samples < 0
+        || static_cast<juce::int64>(channels) * samples * static_cast<juce::int64>(sizeof(float)) > in.getNumBytesRemaining())
+        return false;
+
+    decoded.buffer.setSize(channels, samples);
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const auto bytes = static_cast<int>(sizeof(float) * static_cast<size_t>(samples));
+        if (in.read(decoded.buffer.getWritePointer(ch), bytes) != bytes)
+            return false;
+    }
+
+    const auto analysisSize = in.readInt64();
+    if (analysisSize < 0 || analysisSize > in.getNumBytesRemaining())
+        return false;
+
+    juce::MemoryBlock analysis(static_cast<size_t>(analysisSize));
+    if (in.read(analysis.getData(), static_cast<int>(analysisSize)) != static_cast<int>(analysisSize)
+        || ! deserialiseAnalysis(analysis, decoded))
+        return false;
+
+    asset = std::move(decoded);
+    return true;
+}
+
+/** Files whose stereo float copy would exceed this are analysed by
+ *  streaming instead of being loaded (about 93 minutes at 48 kHz). */
+constexpr juce::int64 kMaxInMemoryAnalysisBytes = juce::int64 (2) * 1024 * 1024 * 1024;
+
+/** Analyse a file block by block with StreamingAssetAnalyzer. The asset
+ *  gets its metrics and curves but no samples (analysisOnly). */
+inline bool analyseAudioFileStreaming(const juce::File& file, Asset& out, juce::String& error,
+                                      int blockSize = 1 << 16)
+{
+    auto reader = AudioFileIngest::openReader(file);
+    if (reader == nullptr || reader->numChannels == 0)
+    {
+        error = "Unsupported or unreadable audio file.";
+        return false;
+    }
+
+    if (reader->lengthInSamples <= 0)
+    {
+        error = "Audio file is empty.";
+        return false;
+    }
+
+    out.name = file.getFileName();
+    out.sourcePath = file.getFullPathName();
+    out.sampleRate = reader->sampleRate;
+    out.buffer.setSize(2, 0);
+    out.analysisOnly = true;
+
+    auto& cache = AnalysisResultCache::getInstance();
+    const auto contentHash = cache.getContentHash(file);
+    juce::MemoryBlock payload;
+    if (cache.load(contentHash, "audio-doctor-stream", kAnalysisCacheVersion, payload)
+        && deserialiseAnalysis(payload, out))
+        return true;
+
+    StreamingAssetAnalyzer analyzer(reader->lengthInSamples, reader->sampleRate);
+    const bool ok = AudioFileIngest::forEachBlock(*reader, blockSize,
+        [&analyzer](const float* const* channels, int numChannels, juce::int64, int numSamples)
+        {
+            analyzer.push(channels[0], channels[numChannels > 1 ? 1 : 0], numSamples);
+            return true;
+        });
+
+    if (! ok || analyzer.getSamplesPushed() != reader->lengthInSamples)
+    {
+        error = "Audio file could not be read.";
+        return false;
+    }
+
+    analyzer.finishInto(out);
+    cache.store(contentHash, "audio-doctor-stream", kAnalysisCacheVersion, serialiseAnalysis(out));
+    return true;
+}
+
+inline bool readAudioFile(const juce::File& file, Asset& out, juce::String& error)
+{
+    // Memory-mapped for WAV/AIFF; only the two channels we keep are converted
+    auto reader = AudioFileIngest::openReader(file);
     if (reader == nullptr)
     {
         error = "Unsupported or unreadable audio file.";
         return false;
     }
 
-    if (reader->lengthInSamples <= 0 || reader->lengthInSamples > std::numeric_limits<int>::max())
+    if (reader->lengthInSamples <= 0)
     {
-        error = "Audio file is too long for this first Audio Doctor pass.";
+        error = "Audio file is empty.";
         return false;
     }
 
-    juce::AudioBuffer<float> loaded(static_cast<int>(reader->numChannels),
-                                    static_cast<int>(reader->lengthInSamples));
-    reader->read(&loaded, 0, loaded.getNumSamples(), 0, true, true);
+    if (reader->lengthInSamples > std::numeric_limits<int>::max()
+        || reader->lengthInSamples * 2 * static_cast<juce::int64>(sizeof(float)) > kMaxInMemoryAnalysisBytes)
+    {
+        reader.reset();
+        return analyseAudioFileStreaming(file, out, error);
+    }
+
+    juce::AudioBuffer<float> stereo;
+    if (! AudioFileIngest::readIntoBuffer(*reader, stereo, 2))
+    {
+        error = "Audio file could not be read.";
+        return false;
+    }
 
     out.name = file.getFileName();
     out.sourcePath = file.getFullPathName();
     out.sampleRate = reader->sampleRate;
-    out.buffer = toStereoBuffer(loaded);
-    refreshAnalysis(out);
+    out.buffer = std::move(stereo);
+    refreshAnalysisCached(out, AnalysisResultCache::getInstance().getContentHash(file));
     return true;
 }
 
@@ -2156,21 +3176,8 @@ inline juce::String hashSourceFnv1a64(const juce::String& sourcePath)
                                                    : juce::String();
     }
 
-    juce::FileInputStream stream(file);
-    if (!stream.openedOk())
-        return {};
-
-    uint64_t hash = offsetBasis;
-    std::array<uint8_t, 8192> buffer {};
-    while (!stream.isExhausted())
-    {
-        const auto bytesRead = stream.read(buffer.data(), static_cast<int>(buffer.size()));
-        if (bytesRead <= 0)
-            break;
-        hash = fnv1a64Bytes(buffer.data(), static_cast<size_t>(bytesRead), hash);
-    }
-
-    return "fnv1a64:" + juce::String::toHexString(static_cast<juce::int64>(hash));
+    // Same identity the analysis cache keys on; unchanged files aren't re-read
+    return AnalysisResultCache::getInstance().getContentHash(file);
 }
 
 inline juce::int64 sourceBytesOnDisk(const juce::String& sourcePath)
@@ -2179,6 +3186,69 @@ inline juce::int64 sourceBytesOnDisk(const juce::String& sourcePath)
     return file.existsAsFile() ? file.getSize() : 0;
 }
 
+/** Which data files writeAssetCurves() and friends produce. NumPy files
+ *  sit next to the CSVs under the same name and hold the same columns. */
+struct DataFileFormats
+{
+    bool csv = true;
+    bool npy = false;
+};
+
+/** A NumPy .npy file (format 1.0) of packed records, one per row. The
+ *  header names the columns ("f4", "i4", "u1", ...), the rows are the
+ *  caller's bytes written as they are. Loads with numpy.load(); columns by
+ *  name, e.g. data["hz"]. */
+inline bool writeNpyRecords(const juce::File& file,
+                            const juce::StringArray& columnNames,
+                            const juce::StringArray& columnTypes,
+                            const void* rows, size_t rowCount, size_t rowBytes)
+{
+    jassert(columnNames.size() == columnTypes.size());
+    const juce::String order = juce::ByteOrder::isBigEndian() ? ">" : "<";
+
+    juce::String descr = "[";
+    for (int i = 0; i < columnNames.size(); ++i)
+        descr << "('" << columnNames[i] << "', '" << (columnTypes[i] == "u1" ? "|" : order) << columnTypes[i] << "'), ";
+    descr << "]";
+
+    auto header = "{'descr': " + descr + ", 'fortran_order': False, 'shape': ("
+                + juce::String(static_cast<juce::int64>(rowCount)) + ",), }";
+
+    // Magic, version and length take 10 bytes; the data starts 64-byte aligned
+    const int unpadded = 10 + header.getNumBytesAsUTF8() + 1;
+    header << juce::String::repeatedString(" ", (64 - unpadded % 64) % 64) << "\n";
+
+    file.deleteFile();
+    auto out = file.createOutputStream();
+    if (out == nullptr)
+        return false;
+
+    out->write("\x93NUMPY", 6);
+    out->writeByte(1);
+    out->writeByte(0);
+    out->writeShort(static_cast<short>(header.getNumBytesAsUTF8()));
+    out->write(header.toRawUTF8(), static_cast<size_t>(header.getNumBytesAsUTF8()));
+    out->write(rows, rowCount * rowBytes);
+    out->flush();
+    return out->getStatus().wasOk();
+}
+
+/** A curve as two float32 columns named after the CSV header ("hz,dB"). */
+inline void writeCurveNpy(const juce::File& dataDir, const juce::String& role, const juce::String& name,
+                          const juce::String& header, const std::vector<PlotPoint>& points,
+                          juce::Array<juce::var>& dataFiles)
+{
+    static_assert(sizeof(PlotPoint) == 2 * sizeof(float), "PlotPoint rows are written as they are");
+    if (points.empty())
+        return;
+
+    const auto file = dataDir.getChildFile(role + "_" + name).withFileExtension(".npy");
+    juce::StringArray columns;
+    columns.addTokens(header, ",", {});
+    if (writeNpyRecords(file, columns, { "f4", "f4" }, points.data(), points.size(), sizeof(PlotPoint)))
+        dataFiles.add(file.getFullPathName());
+}
+
 inline void writeCurveCsv(const juce::File& dataDir, const juce::String& role, const juce::String& name,
                           const juce::String& header, const std::vector<PlotPoint>& points,
                           juce::Array<juce::var>& dataFiles)
@@ -2195,16 +3265,27 @@ inline void writeCurveCsv(const juce::File& dataDir, const juce::String& role, c
     dataFiles.add(file.getFullPathName());
 }
 
+inline void writeCurveFiles(const juce::File& dataDir, const juce::String& role, const juce::String& name,
+                            const juce::String& header, const std::vector<PlotPoint>& points,
+                            juce::Array<juce::var>& dataFiles, DataFileFormats formats)
+{
+    if (formats.csv)
+        writeCurveCsv(dataDir, role, name, header, points, dataFiles);
+    if (formats.npy)
+        writeCurveNpy(dataDir, role, name, header, points, dataFiles);
+}
+
 inline void writeApparentAttenuationCsv(const juce::File& dataDir, const juce::String& role,
                                         const Asset* reference, const Asset* target,
-                                        juce::Array<juce::var>& dataFiles)
+                                        juce::Array<juce::var>& dataFiles,
+                                        DataFileFormats formats = {})
 {
     if (reference == nullptr || target == nullptr)
         return;
 
-    writeCurveCsv(dataDir, role, "apparent_attenuation_seconds_delta_db", "seconds,delta_dB",
-                  computeApparentAttenuationCurve(reference->dynamicsRms, target->dynamicsRms),
-                  dataFiles);
+    writeCurveFiles(dataDir, role, "apparent_attenuation_seconds_delta_db", "seconds,delta_dB",
+                    computeApparentAttenuationCurve(reference->dynamicsRms, target->dynamicsRms),
+                    dataFiles, formats);
 }
 
 inline void writeSpectrumPeakCsv(const juce::File& dataDir, const juce::String& role,
@@ -2230,6 +3311,36 @@ inline void writeSpectrumPeakCsv(const juce::File& dataDir, const juce::String&
     dataFiles.add(file.getFullPathName());
 }
 
+inline void writeSpectrumPeakNpy(const juce::File& dataDir, const juce::String& role,
+                                 const std::vector<SpectrumPeak>& peaks,
+                                 juce::Array<juce::var>& dataFiles)
+{
+    if (peaks.empty())
+        return;
+
+    // Packed rows: four float32, one int32, one uint8
+    constexpr size_t rowBytes = 4 * 4 + 4 + 1;
+    std::vector<juce::uint8> rows(peaks.size() * rowBytes);
+    auto* row = rows.data();
+    for (const auto& peak : peaks)
+    {
+        const float floats[] = { peak.frequencyHz, peak.magnitudeDb, peak.expectedHz, peak.deltaCents };
+        const juce::int32 harmonic = peak.harmonicNumber;
+        std::memcpy(row, floats, 8);
+        std::memcpy(row + 8, &harmonic, 4);
+        std::memcpy(row + 12, floats + 2, 8);
+        row[20] = peak.nearHarmonic ? 1 : 0;
+        row += rowBytes;
+    }
+
+    const auto file = dataDir.getChildFile(role + "_spectrum_peaks").withFileExtension(".npy");
+    if (writeNpyRecords(file,
+                        { "frequencyHz", "dB", "harmonicNumber", "expectedHz", "deltaCents", "nearHarmonic" },
+                        { "f4", "f4", "i4", "f4", "f4", "u1" },
+                        rows.data(), peaks.size(), rowBytes))
+        dataFiles.add(file.getFullPathName());
+}
+
 inline juce::var writeSpectrumPeaksJson(const std::vector<SpectrumPeak>& peaks)
 {
     juce::Array<juce::var> array;
@@ -2330,17 +3441,31 @@ inline void writeStageMarkersCsv(const juce::File& dataDir, const juce::String&
 }
 
 inline void writeAssetCurves(const juce::File& dataDir, const juce::String& role, const Asset* asset,
-                             juce::Array<juce::var>& dataFiles)
+                             juce::Array<juce::var>& dataFiles, DataFileFormats formats = {})
 {
     if (asset == nullptr)
         return;
 
-    writeCurveCsv(dataDir, role, "spectrum_hz_db",            "hz,dB",        asset->spectrum,     dataFiles);
-    writeSpectrumPeakCsv(dataDir, role, asset->spectrumPeaks, dataFiles);
-    writeCurveCsv(dataDir, role, "envelope_seconds_dbfs",     "seconds,dBFS", asset->envelope,     dataFiles);
-    writeCurveCsv(dataDir, role, "group_delay_hz_ms",         "hz,ms",        asset->groupDelay,   dataFiles);
-    writeCurveCsv(dataDir, role, "energy_decay_seconds_db",   "seconds,dB",   asset->energyDecay,  dataFiles);
-    writeCurveCsv(dataDir, role, "dynamics_rms_seconds_dbfs", "seconds,dBFS", asset->dynamicsRms,  dataFiles);
+    auto curve = [&](const char* name, const char* header, const std::vector<PlotPoint>& points)
+    {
+        writeCurveFiles(dataDir, role, name, header, points, dataFiles, formats);
+    };
+
+    curve("spectrum_hz_db",            "hz,dB",        asset->spectrum);
+    if (formats.csv)
+        writeSpectrumPeakCsv(dataDir, role, asset->spectrumPeaks, dataFiles);
+    if (formats.npy)
+        writeSpectrumPeakNpy(dataDir, role, asset->spectrumPeaks, dataFiles);
+    curve("envelope_seconds_dbfs",     "seconds,dBFS", asset->envelope);
+    curve("group_delay_hz_ms",         "hz,ms",        asset->groupDelay);
+    curve("transfer_h1_hz_db",         "hz,dB",        asset->transferMagnitudeDb);
+    curve("transfer_h2_hz_db",         "hz,dB",        asset->transferMagnitudeH2Db);
+    curve("transfer_phase_hz_deg",     "hz,degrees",   asset->transferPhaseDegrees);
+    curve("coherence_hz",              "hz,coherence", asset->transferCoherence);
+    curve("energy_decay_seconds_db",   "seconds,dB",   asset->energyDecay);
+    curve("dynamics_rms_seconds_dbfs", "seconds,dBFS", asset->dynamicsRms);
+
+    // Small per-asset tables stay CSV in every format
     writeSpectrogramSummaryCsv(dataDir, role, asset, dataFiles);
     writeStageMarkersCsv(dataDir, role, asset, dataFiles);
 }
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+    AudioDoctorBatchRunner.h
+    GOODMETER Audio Doctor - runs many JSON jobs at once with one combined summary.
+
+    A batch is a directory of job files (every *.json, in name order) or a
+    manifest: { "jobs": [ "a.json", "sub/b.json", ... ] }, paths relative to
+    the manifest. Jobs run on a pool of threads sized to the machine; audio
+    files named by several jobs are decoded and analysed once through a
+    SharedAssetStore. Jobs that host plugins run one after another on the
+    calling thread, since plugin formats may need the message thread.
+
+    The summary (batch_summary.json next to the jobs, or <manifest>_summary.json)
+    lists every job's status, session, output directory and wall time.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "AudioDoctorJobRunner.h"
+
+namespace goodmeter::audio_doctor
+{
+
+class BatchRunner
+{
+public:
+    /** maxParallelJobs <= 0 uses one thread per core (the caller included). */
+    bool runBatch(const juce::File& source, juce::String& responseText, int maxParallelJobs = 0)
+    {
+        juce::String error;
+        const auto jobFiles = collectJobFiles(source, error);
+        if (jobFiles.isEmpty())
+        {
+            responseText = juce::JSON::toString(makeErrorResponse(error.isNotEmpty() ? error : "Batch contains no job files."), true);
+            return false;
+        }
+
+        const int threadCount = juce::jlimit(1, jobFiles.size(),
+                                             maxParallelJobs > 0 ? maxParallelJobs : juce::SystemStats::getNumCpus());
+
+        // Plugin jobs stay on this thread; everything else is shared out
+        outcomes.clear();
+        outcomes.resize(static_cast<size_t>(jobFiles.size()));
+        std::vector<int> parallelJobs;
+        std::vector<int> serialJobs;
+        std::vector<juce::String> sessionIds;
+
+        for (int i = 0; i < jobFiles.size(); ++i)
+        {
+            outcomes[(size_t) i].jobFile = jobFiles[i];
+            const auto parsed = juce::JSON::parse(jobFiles[i].loadFileAsString());
+            (hostsPlugins(parsed) ? serialJobs : parallelJobs).push_back(i);
+
+            // Unnamed sessions would otherwise collide on the same timestamp
+            auto sessionId = jobFiles[i].getFileNameWithoutExtension();
+            if (std::find(sessionIds.begin(), sessionIds.end(), sessionId) != sessionIds.end())
+                sessionId << "_" << (i + 1);
+            sessionIds.push_back(sessionId);
+            outcomes[(size_t) i].defaultSessionId = sessionId;
+        }
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        std::atomic<size_t> nextParallel { 0 };
+        auto runParallelJobs = [&]
+        {
+            for (size_t k = nextParallel++; k < parallelJobs.size(); k = nextParallel++)
+                runJob(outcomes[(size_t) parallelJobs[k]], false);
+        };
+
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threadCount; ++t)
+            workers.emplace_back(runParallelJobs);
+
+        for (const auto index : serialJobs)
+            runJob(outcomes[(size_t) index], true);
+
+        runParallelJobs();
+
+        for (auto& worker : workers)
+            worker.join();
+
+        const double wallMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+        const auto summary = makeSummary(source, threadCount, static_cast<int>(serialJobs.size()), wallMs);
+        responseText = juce::JSON::toString(summary, true);
+        summaryFileFor(source).replaceWithText(responseText);
+
+        return std::all_of(outcomes.begin(), outcomes.end(), [](const Outcome& o) { return o.ok; });
+    }
+
+    /** Every *.json job in a directory (sorted by name), or the "jobs" of a manifest. */
+    static juce::Array<juce::File> collectJobFiles(const juce::File& source, juce::String& error)
+    {
+        juce::Array<juce::File> files;
+
+        if (source.isDirectory())
+        {
+            for (const auto& entry : juce::RangedDirectoryIterator(source, false, "*.json", juce::File::findFiles))
+            {
+                const auto file = entry.getFile();
+                if (file.getFileName() == "batch_summary.json" || file.getFileName() == "response.json")
+                    continue;
+
+                if (isManifest(juce::JSON::parse(file.loadFileAsString())))
+                    continue;
+
+                files.add(file);
+            }
+
+            files.sort();
+            return files;
+        }
+
+        const auto manifest = juce::JSON::parse(source.loadFileAsString());
+        if (! isManifest(manifest))
+        {
+            error = "Batch source must be a directory of jobs or a manifest with a \"jobs\" array: " + source.getFullPathName();
+            return files;
+        }
+
+        if (auto* jobs = manifest.getProperty("jobs", {}).getArray())
+        {
+            for (const auto& item : *jobs)
+            {
+                const auto path = item.toString();
+                const auto file = juce::File::isAbsolutePath(path) ? juce::File(path) : source.getSiblingFile(path);
+                if (! file.existsAsFile())
+                {
+                    error = "Batch job not found: " + file.getFullPathName();
+                    return {};
+                }
+
+                files.add(file);
+            }
+        }
+
+        return files;
+    }
+
+private:
+    struct Outcome
+    {
+        juce::File jobFile;
+        juce::String defaultSessionId;
+        bool ok = false;
+        bool ranOnCallingThread = false;
+        juce::String responseText;
+        double wallMs = 0.0;
+    };
+
+    static bool isManifest(const juce::var& parsed)
+    {
+        return parsed.isObject() && parsed.getProperty("jobs", {}).isArray();
+    }
+
+    static bool hostsPlugins(const juce::var& job)
+    {
+        for (const auto* key : { "pluginA", "pluginB", "pluginC" })
+            if (job.getProperty(key, {}).isObject())
+                return true;
+        return false;
+    }
+
+    static juce::File summaryFileFor(const juce::File& source)
+    {
+        return source.isDirectory() ? source.getChildFile("batch_summary.json")
+                                    : source.getSiblingFile(source.getFileNameWithoutExtension() + "_summary.json");
+    }
+
+    static juce::var makeErrorResponse(const juce::String& message)
+    {
+        auto obj = std::make_unique<juce::DynamicObject>();
+        obj->setProperty("status", "error");
+        obj->setProperty("error", message);
+        return juce::var(obj.release());
+    }
+
+    void runJob(Outcome& outcome, bool onCallingThread)
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        JobRunner runner;
+        runner.setSharedAssets(&sharedAssets);
+        runner.setDefaultSessionId(outcome.defaultSessionId);
+        outcome.ok = runner.runJobFile(outcome.jobFile, outcome.responseText);
+        outcome.ranOnCallingThread = onCallingThread;
+        outcome.wallMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    }
+
+    juce::var makeSummary(const juce::File& source, int threadCount, int serialJobCount, double wallMs) const
+    {
+        juce::Array<juce::var> jobs;
+        int okCount = 0;
+        double jobMsTotal = 0.0;
+
+        for (const auto& outcome : outcomes)
+        {
+            const auto response = juce::JSON::parse(outcome.responseText);
+            auto entry = std::make_unique<juce::DynamicObject>();
+            entry->setProperty("jobPath", outcome.jobFile.getFullPathName());
+            entry->setProperty("status", outcome.ok ? "ok" : "error");
+            entry->setProperty("sessionId", response.getProperty("sessionId", {}));
+            entry->setProperty("outDir", response.getProperty("outDir", {}));
+            if (! outcome.ok)
+                entry->setProperty("error", response.getProperty("error", "Job failed without a response."));
+            entry->setProperty("wallMs", outcome.wallMs);
+            entry->setProperty("thread", outcome.ranOnCallingThread ? "caller" : "pool");
+            jobs.add(juce::var(entry.release()));
+
+            okCount += outcome.ok ? 1 : 0;
+            jobMsTotal += outcome.wallMs;
+        }
+
+        const int jobCount = static_cast<int>(outcomes.size());
+        auto obj = std::make_unique<juce::DynamicObject>();
+        obj->setProperty("status", okCount == jobCount ? "ok" : okCount > 0 ? "partial" : "error");
+        obj->setProperty("batchSource", source.getFullPathName());
+        obj->setProperty("jobCount", jobCount);
+        obj->setProperty("okCount", okCount);
+        obj->setProperty("failedCount", jobCount - okCount);
+        obj->setProperty("threads", threadCount);
+        obj->setProperty("serialPluginJobs", serialJobCount);
+        obj->setProperty("sharedAudioFiles", sharedAssets.getNumFiles());
+        obj->setProperty("wallMs", wallMs);
+        obj->setProperty("jobWallMsTotal", jobMsTotal);
+        obj->setProperty("jobs", juce::var(jobs));
+        return juce::var(obj.release());
+    }
+
+    SharedAssetStore sharedAssets;
+    std::vector<Outcome> outcomes;
+};
+
+inline bool runAudioDoctorBatch(const juce::File& source, juce::String& responseText, int maxParallelJobs = 0)
+{
+    BatchRunner runner;
+    return runner.runBatch(source, responseText, maxParallelJobs);
+}
+
+} // namespace goodmeter::audio_doctor
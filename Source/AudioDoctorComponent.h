@@ -2881,9 +2881,8 @@ private:
                 return;
 
             const double sampleRate = reference->sampleRate > 0.0 ? reference->sampleRate : wet->sampleRate;
-            wet->groupDelay = goodmeter::audio_doctor::computeTransferGroupDelay(reference->buffer,
-                                                                                 wet->buffer,
-                                                                                 sampleRate);
+            goodmeter::audio_doctor::applyTransferFunction(*wet,
+                goodmeter::audio_doctor::computeTransferFunction(reference->buffer, wet->buffer, sampleRate));
         };
 
         refreshFor(wetAsset, PluginSlot::A);
@@ -4207,6 +4206,7 @@ private:
                 obj->setProperty("selectionEndSeconds", selectionEnd);
                 obj->setProperty("analysisDurationSeconds", asset->metrics.durationSeconds);
                 obj->setProperty("peakDb", asset->metrics.peakDb);
+                obj->setProperty("truePeakDb", asset->metrics.truePeakDb);
                 obj->setProperty("rmsDb", asset->metrics.rmsDb);
                 obj->setProperty("crestDb", asset->metrics.crestDb);
 
@@ -66,11 +66,14 @@ struct FigureData
 class AudioDoctorFigureRenderer
 {
 public:
+    /** Safe to call from several threads at once: each call draws into its
+     *  own software image, and the palette switch is per thread. */
     static juce::Image renderImage(const FigureData& data, bool dark, int width = 1800, int height = 900,
                                    bool academicLight = false)
     {
         ScopedAcademicPalette academicScope(academicLight && !dark);
-        juce::Image image(juce::Image::RGB, juce::jmax(640, width), juce::jmax(420, height), true);
+        juce::Image image(juce::Image::RGB, juce::jmax(640, width), juce::jmax(420, height), true,
+                          juce::SoftwareImageType());
         juce::Graphics g(image);
         g.fillAll(backgroundColour(dark));
 
@@ -0,0 +1,306 @@
+/*
+  ==============================================================================
+    AudioDoctorJobProfiler.h
+    GOODMETER Audio Doctor - where a job's time and memory went.
+
+    JobRunner opens a ScopedStage around each of its stages (loading,
+    plugin render, sweep, transfer functions, outputs, figures). A stage
+    records its wall time and the process memory footprint at its start,
+    its end and its highest point in between (sampled by a background
+    thread every few milliseconds while any stage is open), so a
+    convolution render that balloons and frees again still shows up.
+    Task graph runs can be added so their tasks appear in the trace.
+
+    The result goes into the job response ("profile") and, on request, a
+    Chrome trace (chrome://tracing, Perfetto) with one track per thread.
+
+    Memory is the physical footprint on Apple platforms (what Activity
+    Monitor shows), resident size elsewhere. Benchmark builds
+    (GOODMETER_BENCHMARKS=1) also count heap allocations per stage through
+    the operator new hook in AllocationCounter.h; the count is process wide,
+    so it includes the stage's task graph workers (and anything else running
+    at the time). The peak stays the sampled footprint: the hook sees sizes
+    on allocation only, so it cannot keep a live-heap total.
+
+    Thread safety model:
+      - Stages are opened and closed by the job's own thread; the sampler
+        only touches the open stages' peaks, under a mutex.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AnalysisTaskGraph.h"
+#include "AllocationCounter.h"
+
+#if JUCE_MAC || JUCE_IOS
+ #include <mach/mach.h>
+#elif JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+namespace goodmeter::audio_doctor
+{
+
+class JobProfiler
+{
+public:
+    struct Stage
+    {
+        juce::String name;
+        int depth = 0;
+        double startMs = 0.0;
+        double durationMs = 0.0;
+        juce::int64 memoryStartBytes = 0;
+        juce::int64 memoryEndBytes = 0;
+        juce::int64 memoryPeakBytes = 0;
+        juce::uint64 allocationsStart = 0, allocations = 0;
+        juce::uint64 allocatedBytesStart = 0, allocatedBytes = 0;
+        bool open = true;
+    };
+
+    /** Times (and samples memory for) one stage for as long as it lives. */
+    class ScopedStage
+    {
+    public:
+        ScopedStage(JobProfiler& profilerToUse, const juce::String& name)
+            : profiler(profilerToUse), index(profiler.beginStage(name)) {}
+
+        ~ScopedStage()   { profiler.endStage(index); }
+
+    private:
+        JobProfiler& profiler;
+        const size_t index;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+    JobProfiler()
+        : startTicks(juce::Time::getHighResolutionTicks()),
+          sampler([this] { sampleLoop(); })
+    {
+    }
+
+    ~JobProfiler()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        sampler.join();
+    }
+
+    /** Milliseconds since the profiler was created. */
+    double nowMs() const
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    }
+
+    /** Current footprint of the whole process in bytes, 0 if unknown. */
+    static juce::int64 getProcessMemoryBytes()
+    {
+       #if JUCE_MAC || JUCE_IOS
+        task_vm_info_data_t info {};
+        mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+        if (task_info(mach_task_self(), TASK_VM_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+            return static_cast<juce::int64>(info.phys_footprint);
+        return 0;
+       #elif JUCE_LINUX
+        long pages = 0, resident = 0;
+        if (auto* statm = std::fopen("/proc/self/statm", "r"))
+        {
+            if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+                resident = 0;
+            std::fclose(statm);
+        }
+        return static_cast<juce::int64>(resident) * static_cast<juce::int64>(sysconf(_SC_PAGESIZE));
+       #else
+        return 0;
+       #endif
+    }
+
+    /** Add a task graph's last run to the trace; graphStartMs is nowMs()
+     *  taken just before run(). */
+    void addTaskTimings(const AnalysisTaskGraph& graph, double graphStartMs)
+    {
+        const auto timings = graph.getTimings();
+        const std::lock_guard<std::mutex> lock(mutex);
+        for (auto timing : timings)
+        {
+            timing.startMs += graphStartMs;
+            tasks.push_back(timing);
+        }
+    }
+
+    //==========================================================================
+    /** Stages in the order they were opened, with "depth" for nesting. */
+    juce::var toVar() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        juce::Array<juce::var> list;
+        juce::int64 processPeak = 0;
+        for (const auto& stage : stages)
+        {
+            auto obj = std::make_unique<juce::DynamicObject>();
+            obj->setProperty("stage", stage.name);
+            obj->setProperty("depth", stage.depth);
+            obj->setProperty("startMs", stage.startMs);
+            obj->setProperty("durationMs", stage.durationMs);
+            obj->setProperty("memoryStartBytes", stage.memoryStartBytes);
+            obj->setProperty("memoryEndBytes", stage.memoryEndBytes);
+            obj->setProperty("memoryPeakBytes", stage.memoryPeakBytes);
+            obj->setProperty("memoryPeakGrowthBytes", stage.memoryPeakBytes - stage.memoryStartBytes);
+            if (benchmark::AllocationCounter::available)
+            {
+                obj->setProperty("allocations", static_cast<juce::int64>(stage.allocations));
+                obj->setProperty("allocatedBytes", static_cast<juce::int64>(stage.allocatedBytes));
+            }
+            list.add(juce::var(obj.release()));
+            processPeak = juce::jmax(processPeak, stage.memoryPeakBytes);
+        }
+
+        auto root = std::make_unique<juce::DynamicObject>();
+        root->setProperty("wallMs", nowMs());
+        root->setProperty("memoryPeakBytes", processPeak);
+        root->setProperty("memorySampleIntervalMs", kSampleIntervalMs);
+        root->setProperty("allocationCounting", benchmark::AllocationCounter::available);
+        root->setProperty("stages", juce::var(list));
+        return juce::var(root.release());
+    }
+
+    /** Chrome trace event file: stages on the job's track, graph tasks on
+     *  one track per pool thread, memory as a counter. */
+    bool writeChromeTrace(const juce::File& file) const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        juce::Array<juce::var> events;
+
+        auto complete = [&](const juce::String& name, const juce::String& category, double startMs, double durationMs, int thread)
+        {
+            auto event = std::make_unique<juce::DynamicObject>();
+            event->setProperty("name", name);
+            event->setProperty("cat", category);
+            event->setProperty("ph", "X");
+            event->setProperty("ts", startMs * 1000.0);
+            event->setProperty("dur", durationMs * 1000.0);
+            event->setProperty("pid", 1);
+            event->setProperty("tid", thread);
+            events.add(juce::var(event.release()));
+        };
+
+        auto counter = [&](double atMs, juce::int64 bytes)
+        {
+            auto args = std::make_unique<juce::DynamicObject>();
+            args->setProperty("MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+            auto event = std::make_unique<juce::DynamicObject>();
+            event->setProperty("name", "memory");
+            event->setProperty("ph", "C");
+            event->setProperty("ts", atMs * 1000.0);
+            event->setProperty("pid", 1);
+            event->setProperty("args", juce::var(args.release()));
+            events.add(juce::var(event.release()));
+        };
+
+        for (const auto& stage : stages)
+        {
+            complete(stage.name, "stage", stage.startMs, stage.durationMs, 0);
+            counter(stage.startMs, stage.memoryStartBytes);
+            counter(stage.startMs + stage.durationMs, stage.memoryEndBytes);
+        }
+
+        // Thread 0 is the job's own thread, as in AnalysisTaskGraph
+        for (const auto& task : tasks)
+            complete(task.name, "task", task.startMs, task.durationMs, task.thread);
+
+        auto root = std::make_unique<juce::DynamicObject>();
+        root->setProperty("traceEvents", juce::var(events));
+        root->setProperty("displayTimeUnit", "ms");
+        return file.replaceWithText(juce::JSON::toString(juce::var(root.release()), true));
+    }
+
+private:
+    static constexpr int kSampleIntervalMs = 5;
+
+    size_t beginStage(const juce::String& name)
+    {
+        Stage stage;
+        stage.name = name;
+        stage.startMs = nowMs();
+        stage.memoryStartBytes = getProcessMemoryBytes();
+        stage.memoryPeakBytes = stage.memoryStartBytes;
+        stage.allocationsStart = benchmark::AllocationCounter::processCount.load(std::memory_order_relaxed);
+        stage.allocatedBytesStart = benchmark::AllocationCounter::processBytes.load(std::memory_order_relaxed);
+
+        size_t index = 0;
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            stage.depth = openStages;
+            ++openStages;
+            index = stages.size();
+            stages.push_back(stage);
+        }
+        wake.notify_all();
+        return index;
+    }
+
+    void endStage(size_t index)
+    {
+        const auto endMs = nowMs();
+        const auto memory = getProcessMemoryBytes();
+        const auto allocations = benchmark::AllocationCounter::processCount.load(std::memory_order_relaxed);
+        const auto allocatedBytes = benchmark::AllocationCounter::processBytes.load(std::memory_order_relaxed);
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto& stage = stages[index];
+        stage.durationMs = endMs - stage.startMs;
+        stage.allocations = allocations - stage.allocationsStart;
+        stage.allocatedBytes = allocatedBytes - stage.allocatedBytesStart;
+        stage.memoryEndBytes = memory;
+        stage.memoryPeakBytes = juce::jmax(stage.memoryPeakBytes, memory);
+        stage.open = false;
+        --openStages;
+    }
+
+    void sampleLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (! stopping)
+        {
+            if (openStages == 0)
+            {
+                wake.wait(lock, [this] { return stopping || openStages > 0; });
+                continue;
+            }
+
+            lock.unlock();
+            const auto memory = getProcessMemoryBytes();
+            lock.lock();
+
+            for (auto& stage : stages)
+                if (stage.open)
+                    stage.memoryPeakBytes = juce::jmax(stage.memoryPeakBytes, memory);
+
+            wake.wait_for(lock, std::chrono::milliseconds(kSampleIntervalMs), [this] { return stopping; });
+        }
+    }
+
+    const juce::int64 startTicks;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Stage> stages;
+    std::vector<AnalysisTaskGraph::TaskTiming> tasks;
+    int openStages = 0;
+    bool stopping = false;
+    std::thread sampler;    // last: starts once everything above exists
+
+    JUCE_DECLARE_NON_COPYABLE(JobProfiler)
+};
+
+} // namespace goodmeter::audio_doctor
@@ -9,12 +9,112 @@
 
 #include <JuceHeader.h>
 #include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "AudioDoctorPluginHost.h"
 #include "AudioDoctorFigureRenderer.h"
+#include "AudioDoctorJobProfiler.h"
 
 namespace goodmeter::audio_doctor
 {
 
+//==============================================================================
+/** Decoded and analysed audio files, loaded once and shared read-only by
+ *  every job of a batch; the decode and analysis happen once per file.
+ *  Jobs take the asset by shared pointer and work on a view of it (see
+ *  makeView()), so no job copies the decoded samples. */
+class SharedAssetStore
+{
+public:
+    /** The shared asset, or nullptr (with error set) if the file didn't load. */
+    std::shared_ptr<const Asset> load(const juce::File& file, juce::String& error)
+    {
+        std::shared_ptr<Entry> entry;
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            auto& slot = entries[file.getFullPathName()];
+            if (slot == nullptr)
+                slot = std::make_shared<Entry>();
+            entry = slot;
+        }
+
+        // Jobs wanting the same file wait for the first one to load it
+        const std::lock_guard<std::mutex> lock(entry->mutex);
+        if (! entry->attempted)
+        {
+            entry->attempted = true;
+            auto decoded = std::make_shared<Asset>();
+            if (readAudioFile(file, *decoded, entry->error))
+                entry->asset = std::move(decoded);
+        }
+
+        if (entry->asset == nullptr)
+            error = entry->error;
+
+        return entry->asset;
+    }
+
+    /** A job-owned Asset whose buffer reads the shared samples in place; the
+     *  rest (metrics, plots, images) is copied. Trims and edits replace the
+     *  buffer rather than writing into it, so the shared data stays intact.
+     *  The caller keeps the shared pointer alive for as long as the view. */
+    static Asset makeView(const Asset& shared)
+    {
+        Asset view;
+        view.name = shared.name;
+        view.sourcePath = shared.sourcePath;
+        if (shared.buffer.getNumChannels() > 0 && shared.buffer.getNumSamples() > 0)
+            view.buffer = juce::AudioBuffer<float>(const_cast<float* const*>(shared.buffer.getArrayOfReadPointers()),
+                                                   shared.buffer.getNumChannels(), shared.buffer.getNumSamples());
+        view.analysisOnly = shared.analysisOnly;
+        view.sampleRate = shared.sampleRate;
+        view.metrics = shared.metrics;
+        view.spaceMetrics = shared.spaceMetrics;
+        view.dynamicsMetrics = shared.dynamicsMetrics;
+        view.editMetadata = shared.editMetadata;
+        view.generatedSignal = shared.generatedSignal;
+        view.generatedSignalSpec = shared.generatedSignalSpec;
+        view.stageMarkers = shared.stageMarkers;
+        view.spectrum = shared.spectrum;
+        view.spectrumPeaks = shared.spectrumPeaks;
+        view.harmonicPeaks = shared.harmonicPeaks;
+        view.envelope = shared.envelope;
+        view.energyDecay = shared.energyDecay;
+        view.dynamicsRms = shared.dynamicsRms;
+        view.groupDelay = shared.groupDelay;
+        view.transferMagnitudeDb = shared.transferMagnitudeDb;
+        view.transferMagnitudeH2Db = shared.transferMagnitudeH2Db;
+        view.transferPhaseDegrees = shared.transferPhaseDegrees;
+        view.transferCoherence = shared.transferCoherence;
+        view.spectrogramBlue = shared.spectrogramBlue;
+        view.spectrogramYellow = shared.spectrogramYellow;
+        view.spectrogramPink = shared.spectrogramPink;
+        view.analysisTimings = shared.analysisTimings;
+        return view;
+    }
+
+    int getNumFiles() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<int>(entries.size());
+    }
+
+private:
+    struct Entry
+    {
+        std::mutex mutex;
+        bool attempted = false;
+        std::shared_ptr<const Asset> asset;
+        juce::String error;
+    };
+
+    mutable std::mutex mutex;
+    std::map<juce::String, std::shared_ptr<Entry>> entries;
+};
+
+//==============================================================================
 class JobRunner
 {
 public:
@@ -31,8 +131,10 @@ public:
         response->setProperty("jobPath", jobFile.getFullPathName());
 
         job = parsed;
+        profiler = std::make_unique<JobProfiler>();
         sessionId = getString(job, "sessionId",
-                    getString(job, "sessionName", "audio_doctor_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S")));
+                    getString(job, "sessionName", defaultSessionId.isNotEmpty() ? defaultSessionId
+                                                                                : "audio_doctor_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S")));
         outDir = juce::File(getString(getObject(job, "export"), "outDir", jobFile.getSiblingFile("AudioDoctor_Job_Exports").getFullPathName()))
                      .getChildFile(sanitizeFileToken(sessionId));
 
@@ -42,14 +144,19 @@ public:
         response->setProperty("sessionId", sessionId);
         response->setProperty("outDir", outDir.getFullPathName());
 
-        if (!loadDry())
+        if (!timeStage("loadDry", [this] { return loadDry(); }))
             return finish(responseText);
 
-        if (!loadPluginsAndRender())
+        if (!timeStage("loadPluginsAndRender", [this] { return loadPluginsAndRender(); }))
             return finish(responseText);
 
-        refreshTransfer();
-        writeOutputs();
+        if (!timeStage("parameterSweep", [this] { return runParameterSweep(); }))
+            return finish(responseText);
+
+        timeStage("refreshTransfer", [this] { refreshTransfer(); });
+        timeStage("writeOutputs", [this] { writeOutputs(); });
+        writeAnalysisTimings();
+        writeProfile();
 
         response->setProperty("status", "ok");
         responseText = juce::JSON::toString(juce::var(response.release()), true);
@@ -58,17 +165,44 @@ public:
         return true;
     }
 
+    /** Import audio files through a store shared with other runners (batch mode). */
+    void setSharedAssets(SharedAssetStore* store) noexcept          { sharedAssets = store; }
+
+    /** Session id for jobs that name none, instead of the current time. */
+    void setDefaultSessionId(const juce::String& id)                { defaultSessionId = id; }
+
 private:
     using AssetPtr = std::unique_ptr<Asset>;
 
+    bool importAudioFile(const juce::File& file, Asset& out, juce::String& error)
+    {
+        if (sharedAssets == nullptr)
+            return readAudioFile(file, out, error);
+
+        auto shared = sharedAssets->load(file, error);
+        if (shared == nullptr)
+            return false;
+
+        out = SharedAssetStore::makeView(*shared);
+
+        // Sources load concurrently (loadDry); the views read these samples
+        const std::lock_guard<std::mutex> lock(sharedSourcesMutex);
+        sharedSources.push_back(std::move(shared));
+        return true;
+    }
+
     struct RenderInfo
     {
         bool valid = false;
         juce::PluginDescription plugin;
         int latencySamples = 0;
         double tailSeconds = 0.0;
+        int segments = 1;
     };
 
+    static constexpr int kRenderBlockSize = 512;
+    static constexpr size_t kMaxSweepPoints = 4096;
+
     enum class MetricsKind
     {
         basic,
@@ -149,6 +283,7 @@ private:
 
     bool finish(juce::String& responseText)
     {
+        writeProfile();
         responseText = juce::JSON::toString(juce::var(response.release()), true);
         outDir.getChildFile("response.json").replaceWithText(responseText);
         return false;
@@ -160,12 +295,33 @@ private:
         const auto sources = getObject(job, "sources");
         if (sources.isObject())
         {
-            if (!loadSource("dryA", getObject(sources, "dryA"), dryAsset, error))
-                return false;
-            if (!loadSource("dryB", getObject(sources, "dryB"), dryBAsset, error))
-                return false;
-            if (!loadSource("dryC", getObject(sources, "dryC"), dryCAsset, error))
-                return false;
+            // The three sources are independent: import, edit and analyse them concurrently
+            struct SourceLoad
+            {
+                juce::String key;
+                AssetPtr* asset = nullptr;
+                bool ok = true;
+                juce::String error;
+            };
+
+            std::array<SourceLoad, 3> loads {{ { "dryA", &dryAsset }, { "dryB", &dryBAsset }, { "dryC", &dryCAsset } }};
+            AnalysisTaskGraph graph;
+            for (auto& load : loads)
+                graph.addTask("load " + load.key, [this, &sources, &load]
+                {
+                    load.ok = loadSource(load.key, getObject(sources, load.key), *load.asset, load.error);
+                });
+
+            runProfiledGraph(graph);
+
+            for (const auto& load : loads)
+            {
+                if (!load.ok)
+                {
+                    response->setProperty("error", load.error);
+                    return false;
+                }
+            }
 
             if (dryAsset == nullptr)
             {
@@ -182,7 +338,7 @@ private:
         if (drySpec.isObject() && getString(drySpec, "path").isNotEmpty())
         {
             dryAsset = std::make_unique<Asset>();
-            if (!readAudioFile(juce::File(getString(drySpec, "path")), *dryAsset, error))
+            if (!importAudioFile(juce::File(getString(drySpec, "path")), *dryAsset, error))
             {
                 response->setProperty("error", "Dry import failed: " + error);
                 return false;
@@ -225,9 +381,9 @@ private:
         if (path.isNotEmpty())
         {
             asset = std::make_unique<Asset>();
-            if (!readAudioFile(juce::File(path), *asset, error))
+            if (!importAudioFile(juce::File(path), *asset, error))
             {
-                response->setProperty("error", key + " import failed: " + error);
+                error = key + " import failed: " + error;
                 return false;
             }
         }
@@ -243,7 +399,12 @@ private:
 
         asset->name = key.toUpperCase() + " " + asset->name;
         applySelection(*asset, getObject(spec, "selection"));
-        return applySourceEdits(key, *asset, spec, error);
+        if (!applySourceEdits(key, *asset, spec, error))
+        {
+            error = key + " edit failed: " + error;
+            return false;
+        }
+        return true;
     }
 
     bool applySourceEdits(const juce::String& key, Asset& asset, const juce::var& spec, juce::String& error)
@@ -337,7 +498,25 @@ private:
         return source;
     }
 
+    /** Generated signals are deterministic in their spec: reuse a stored artifact when one exists. */
     Asset generateSignal(const juce::var& spec)
+    {
+        const auto signal = readGeneratedSignalSpec(spec);
+        const auto key = makeArtifactKey({ "generated", hashGeneratedSignalSpec(signal) });
+
+        Asset asset;
+        if (loadArtifact("generated", key, [&](juce::InputStream& in) { return readAssetArtifact(in, asset); }))
+        {
+            asset.generatedSignalSpec = normaliseGeneratedSignalSpec(signal);
+            return asset;
+        }
+
+        asset = makeGeneratedSignalAsset(signal);
+        storeArtifact("generated", key, [&](juce::OutputStream& out) { writeAssetArtifact(out, asset); });
+        return asset;
+    }
+
+    GeneratedSignalSpec readGeneratedSignalSpec(const juce::var& spec) const
     {
         const auto params = getObject(spec, "params");
         auto readString = [&](const juce::String& name, const juce::String& fallback)
@@ -398,7 +577,78 @@ private:
         signal.fundamentalBHz = readDouble("fundamentalBHz", signal.fundamentalBHz);
         signal.detuneCents = readDouble("detuneCents", signal.detuneCents);
         signal.overlapAmount = readDouble("overlapAmount", signal.overlapAmount);
-        return makeGeneratedSignalAsset(signal);
+        return signal;
+    }
+
+    //==========================================================================
+    // Artifact cache: generated signals and plugin renders keyed by everything
+    // that determines them, so an unchanged stage is not recomputed on re-run.
+    // Disabled per job with "artifactCache": false.
+    //==========================================================================
+    bool artifactCacheEnabled() const
+    {
+        return getBool(job, "artifactCache", true);
+    }
+
+    template <typename Reader>
+    bool loadArtifact(const juce::String& stage, const juce::String& key, Reader&& read)
+    {
+        if (! artifactCacheEnabled())
+            return false;
+
+        juce::MemoryBlock payload;
+        const bool hit = AnalysisResultCache::getInstance().load(key, "job-" + stage, kJobArtifactVersion, payload);
+        bool ok = false;
+        if (hit)
+        {
+            juce::MemoryInputStream in(payload, false);
+            ok = read(in);
+        }
+
+        noteArtifact(stage, key, ok ? "hit" : "miss");
+        return ok;
+    }
+
+    template <typename Writer>
+    void storeArtifact(const juce::String& stage, const juce::String& key, Writer&& write)
+    {
+        if (! artifactCacheEnabled())
+            return;
+
+        juce::MemoryOutputStream out;
+        write(out);
+        AnalysisResultCache::getInstance().store(key, "job-" + stage, kJobArtifactVersion, out.getMemoryBlock());
+    }
+
+    void noteArtifact(const juce::String& stage, const juce::String& key, const juce::String& result)
+    {
+        auto entry = std::make_unique<juce::DynamicObject>();
+        entry->setProperty("stage", stage);
+        entry->setProperty("key", key);
+        entry->setProperty("result", result);
+
+        // Sources load concurrently
+        const std::lock_guard<std::mutex> lock(artifactMutex);
+        artifactEvents.add(juce::var(entry.release()));
+    }
+
+    /** Plugin identity for render keys: identifier, version, and the size and
+     *  modification time of the executable (inside the bundle, not the bundle
+     *  folder), so rebuilding or updating the plugin invalidates. */
+    static juce::String pluginIdentityForKey(const PluginHost& host)
+    {
+        const auto* description = host.getCurrentPlugin();
+        if (description == nullptr)
+            return {};
+
+        juce::String identity = description->createIdentifierString() + "|" + description->version;
+        if (juce::File::isAbsolutePath(description->fileOrIdentifier))
+        {
+            const auto binary = PluginInstanceCache::getPluginBinary(juce::File(description->fileOrIdentifier));
+            identity << "|" << juce::String(binary.getSize()) << "|" << juce::String(binary.getLastModificationTime().toMilliseconds());
+        }
+
+        return identity;
     }
 
     void applySelection(Asset& asset, const juce::var& selection)
@@ -433,16 +683,51 @@ private:
         refreshAnalysis(asset);
     }
 
+    /** A slot whose render input is ready; with "render": { "concurrent": true }
+     *  its plugin instances are created up front and processed later. */
+    struct PendingRender
+    {
+        juce::String key;
+        juce::String wetId;
+        AssetPtr* wet = nullptr;
+        RenderInfo* renderInfo = nullptr;
+        AssetPtr renderInput;
+        juce::String artifactKey;
+        OfflineRenderPlan plan;
+    };
+
     bool loadPluginsAndRender()
     {
+        std::array<PendingRender, 3> pending;
         bool ok = true;
-        ok = loadPluginAndMaybeRender("pluginA", hostA, wetA, renderInfoA) && ok;
-        ok = loadPluginAndMaybeRender("pluginB", hostB, wetB, renderInfoB) && ok;
-        ok = loadPluginAndMaybeRender("pluginC", hostC, wetC, renderInfoC) && ok;
+        ok = loadPluginAndMaybeRender("pluginA", hostA, wetA, renderInfoA, pending[0]) && ok;
+        ok = loadPluginAndMaybeRender("pluginB", hostB, wetB, renderInfoB, pending[1]) && ok;
+        ok = loadPluginAndMaybeRender("pluginC", hostC, wetC, renderInfoC, pending[2]) && ok;
+
+        // Concurrent mode: every slot's segments in one graph, then assemble
+        AnalysisTaskGraph graph;
+        for (auto& render : pending)
+            if (! render.plan.instances.empty())
+                PluginHost::addOfflineRenderTasks(graph, render.plan);
+
+        if (graph.getNumTasks() == 0)
+            return ok;
+
+        runProfiledGraph(graph);
+        for (auto& render : pending)
+        {
+            if (render.plan.instances.empty())
+                continue;
+
+            PluginHost::finishOfflineRender(render.plan);
+            completeRender(render, std::move(render.plan.result), false);
+        }
+
         return ok;
     }
 
-    bool loadPluginAndMaybeRender(const juce::String& key, PluginHost& host, AssetPtr& wet, RenderInfo& renderInfo)
+    bool loadPluginAndMaybeRender(const juce::String& key, PluginHost& host, AssetPtr& wet, RenderInfo& renderInfo,
+                                  PendingRender& pending)
     {
         const auto pluginSpec = getObject(job, key);
         if (!pluginSpec.isObject())
@@ -498,16 +783,82 @@ private:
         }
 
         const double tailSeconds = getTailSeconds(renderSpec);
-        auto result = host.renderOffline(*renderInput, &state, 512, tailSeconds);
+        const bool concurrent = getBool(renderSpec, "concurrent", false);
+        const int maxInstances = concurrent ? juce::jmax(1, static_cast<int>(getDouble(renderSpec, "maxInstances", juce::SystemStats::getNumCpus())))
+                                            : 1;
+
+        juce::StringArray keyParts { "render",
+                                     hashAudioBuffer(renderInput->buffer, renderInput->sampleRate),
+                                     pluginIdentityForKey(host),
+                                     juce::String::toHexString(static_cast<juce::int64>(fnv1a64Bytes(state.getData(), state.getSize()))),
+                                     juce::String(kRenderBlockSize),
+                                     stableJsonNumber(tailSeconds) };
+        if (maxInstances > 1)
+            keyParts.add("instances" + juce::String(maxInstances));   // segment splices differ from one instance
+
+        pending.key = key;
+        pending.wetId = wetId;
+        pending.wet = &wet;
+        pending.renderInfo = &renderInfo;
+        pending.artifactKey = makeArtifactKey(keyParts);
+
+        OfflineRenderResult result;
+        const bool cached = loadArtifact("render" + wetId.substring(3), pending.artifactKey, [&](juce::InputStream& in)
+        {
+            result.latencySamples = in.readInt();
+            result.tailSeconds = in.readDouble();
+            result.segments = in.readInt();
+            return readAssetArtifact(in, result.wet);
+        });
+
+        pending.renderInput = std::move(renderInput);
+
+        if (cached)
+        {
+            result.pluginDescription = *host.getCurrentPlugin();
+            completeRender(pending, std::move(result), true);
+            return true;
+        }
+
+        if (concurrent)
+        {
+            // Instances now, on this thread; processing happens in loadPluginsAndRender()
+            if (!host.prepareOfflineRender(*pending.renderInput, &state, kRenderBlockSize, tailSeconds, maxInstances, pending.plan))
+            {
+                response->setProperty("error", "Render " + key + " failed: " + pending.plan.error);
+                return false;
+            }
+            return true;
+        }
+
+        result = host.renderOffline(*pending.renderInput, &state, kRenderBlockSize, tailSeconds);
         if (result.error.isNotEmpty())
         {
             response->setProperty("error", "Render " + key + " failed: " + result.error);
             return false;
         }
 
+        completeRender(pending, std::move(result), false);
+        return true;
+    }
+
+    void completeRender(PendingRender& pending, OfflineRenderResult result, bool fromCache)
+    {
+        const auto& wetId = pending.wetId;
+        if (!fromCache)
+            storeArtifact("render" + wetId.substring(3), pending.artifactKey, [&](juce::OutputStream& out)
+            {
+                out.writeInt(result.latencySamples);
+                out.writeDouble(result.tailSeconds);
+                out.writeInt(result.segments);
+                writeAssetArtifact(out, result.wet);
+            });
+
+        auto& wet = *pending.wet;
+        auto& renderInput = pending.renderInput;
         wet = std::make_unique<Asset>(std::move(result.wet));
         wet->name = labelForSourceId(wetId) + " " + wet->name;
-        wet->groupDelay = computeTransferGroupDelay(renderInput->buffer, wet->buffer, renderInput->sampleRate);
+        applyTransferFunction(*wet, computeTransferFunction(renderInput->buffer, wet->buffer, renderInput->sampleRate));
         if (wetId == "wetA")
             renderReferenceA = std::move(renderInput);
         else if (wetId == "wetB")
@@ -515,10 +866,220 @@ private:
         else if (wetId == "wetC")
             renderReferenceC = std::move(renderInput);
 
+        auto& renderInfo = *pending.renderInfo;
         renderInfo.plugin = result.pluginDescription;
         renderInfo.latencySamples = result.latencySamples;
         renderInfo.tailSeconds = result.tailSeconds;
+        renderInfo.segments = result.segments;
         renderInfo.valid = true;
+    }
+
+    /** Optional "sweep": render a grid of parameter values through one loaded
+     *  plugin slot, starting from that slot's state, on a pool of instances.
+     *
+     *      "sweep": { "plugin": "A", "parallelSafe": true, "maxInstances": 8,
+     *                 "parameters": [ { "id": "mix", "values": [0, 0.5, 1] },
+     *                                 { "id": "decay", "from": 0, "to": 1, "steps": 10 } ] }
+     *
+     *  Every combination is one point (the last parameter varies fastest).
+     *  Points render one at a time unless "parallelSafe" vouches that the
+     *  plugin's instances can render concurrently; only then is
+     *  "maxInstances" honoured.
+     *  Renders go straight into analysis; only the per-point metrics and
+     *  spectra are written, as data/sweep_<slot>_*.csv. */
+    bool runParameterSweep()
+    {
+        const auto sweepSpec = getObject(job, "sweep");
+        if (!sweepSpec.isObject())
+            return true;
+
+        const auto key = "plugin" + getString(sweepSpec, "plugin", "A").trim()
+                                        .fromLastOccurrenceOf("plugin", false, true).toUpperCase();
+        const auto wetId = wetIdForPluginKey(key);
+        auto& host = key == "pluginB" ? hostB : key == "pluginC" ? hostC : hostA;
+        if (host.getCurrentPlugin() == nullptr)
+        {
+            response->setProperty("error", "Sweep plugin slot is not loaded: " + key);
+            return false;
+        }
+
+        struct Axis
+        {
+            juce::String key;
+            std::vector<float> values;
+        };
+
+        std::vector<Axis> axes;
+        if (auto* params = getObject(sweepSpec, "parameters").getArray())
+        {
+            for (const auto& p : *params)
+            {
+                Axis axis;
+                axis.key = getString(p, "id", getString(p, "name", getString(p, "index")));
+                if (auto* values = getObject(p, "values").getArray())
+                {
+                    for (const auto& value : *values)
+                        axis.values.push_back(static_cast<float>(static_cast<double>(value)));
+                }
+                else
+                {
+                    const int steps = juce::jmax(1, static_cast<int>(getDouble(p, "steps", 5.0)));
+                    const double from = getDouble(p, "from", 0.0);
+                    const double to = getDouble(p, "to", 1.0);
+                    for (int i = 0; i < steps; ++i)
+                        axis.values.push_back(static_cast<float>(steps == 1 ? from : from + (to - from) * i / (steps - 1)));
+                }
+
+                if (axis.key.isEmpty() || axis.values.empty())
+                {
+                    response->setProperty("error", "Sweep parameters need an id and at least one value.");
+                    return false;
+                }
+
+                axes.push_back(std::move(axis));
+            }
+        }
+
+        size_t pointCount = axes.empty() ? 0 : 1;
+        for (const auto& axis : axes)
+            pointCount = juce::jmin(pointCount * axis.values.size(), kMaxSweepPoints + 1);
+
+        if (pointCount == 0 || pointCount > kMaxSweepPoints)
+        {
+            response->setProperty("error", pointCount == 0 ? juce::String("Sweep has no parameters.")
+                                                           : "Sweep exceeds " + juce::String(static_cast<int>(kMaxSweepPoints)) + " points.");
+            return false;
+        }
+
+        std::vector<ParameterSweepPoint> points(pointCount);
+        for (size_t i = 0; i < pointCount; ++i)
+        {
+            auto& values = points[i].values;
+            values.resize(axes.size());
+            size_t rest = i;
+            for (size_t a = axes.size(); a-- > 0;)
+            {
+                values[a] = { axes[a].key, axes[a].values[rest % axes[a].values.size()] };
+                rest /= axes[a].values.size();
+            }
+        }
+
+        juce::String error;
+        AssetPtr input;
+        juce::MemoryBlock state;
+        if (!makeRenderInputAsset(wetId, input, error) || !host.captureCurrentState(state, error))
+        {
+            response->setProperty("error", "Sweep " + key + " failed: " + error);
+            return false;
+        }
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        std::vector<ParameterSweepResult> results;
+        if (!host.renderParameterSweep(*input, &state, points, results, error,
+                                       getBool(sweepSpec, "parallelSafe", false)
+                                           ? static_cast<int>(getDouble(sweepSpec, "maxInstances", 0.0)) : 1,
+                                       kRenderBlockSize, getTailSeconds(getObject(job, "render"))))
+        {
+            response->setProperty("error", "Sweep " + key + " failed: " + error);
+            return false;
+        }
+        const double wallMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+
+        const auto dataDir = outDir.getChildFile("data");
+        dataDir.createDirectory();
+        const auto role = "sweep_" + key.substring(6);
+        const auto metricsFile = dataDir.getChildFile(role + "_metrics").withFileExtension(".csv");
+        const auto spectrumFile = dataDir.getChildFile(role + "_spectrum_hz_db").withFileExtension(".csv");
+
+        juce::String metricsText = "point";
+        for (const auto& axis : axes)
+            metricsText << "," << csvEscape(axis.key);
+        metricsText << ",status,peakDb,truePeakDb,rmsDb,crestDb,lowEnergyDb,midEnergyDb,highEnergyDb,latencySamples,tailSeconds,instance,renderMs\n";
+
+        juce::String spectrumText = "point,hz,dB\n";
+        juce::Array<juce::var> errors;
+        int okCount = 0;
+        int instancesUsed = 0;
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+            const auto& m = result.metrics;
+            const bool ok = result.error.isEmpty();
+            okCount += ok ? 1 : 0;
+            instancesUsed = juce::jmax(instancesUsed, result.instance);
+            if (!ok && errors.size() < 16)
+                errors.add("point " + juce::String(static_cast<int>(i)) + ": " + result.error);
+
+            metricsText << static_cast<int>(i);
+            for (const auto& value : points[i].values)
+                metricsText << "," << juce::String(value.second, 6);
+
+            if (!ok)
+            {
+                metricsText << ",error,,,,,,,,,," << result.instance << "," << juce::String(result.renderMs, 3) << "\n";
+                continue;
+            }
+
+            metricsText << ",ok,"
+                        << juce::String(m.peakDb, 6) << ","
+                        << juce::String(m.truePeakDb, 6) << ","
+                        << juce::String(m.rmsDb, 6) << ","
+                        << juce::String(m.crestDb, 6) << ","
+                        << juce::String(averageSpectrumBandDb(result.spectrum, 20.0f, 250.0f), 6) << ","
+                        << juce::String(averageSpectrumBandDb(result.spectrum, 250.0f, 2000.0f), 6) << ","
+                        << juce::String(averageSpectrumBandDb(result.spectrum, 2000.0f, 20000.0f), 6) << ","
+                        << result.latencySamples << ","
+                        << juce::String(result.tailSeconds, 6) << ","
+                        << result.instance << ","
+                        << juce::String(result.renderMs, 3) << "\n";
+
+            for (const auto& point : result.spectrum)
+                spectrumText << static_cast<int>(i) << "," << juce::String(point.x, 6) << "," << juce::String(point.y, 6) << "\n";
+        }
+
+        metricsFile.replaceWithText(metricsText);
+        spectrumFile.replaceWithText(spectrumText);
+
+        if (getDataFileFormats().npy)
+        {
+            // Same long format as the CSV: point int32, hz and dB float32
+            std::vector<juce::uint8> rows;
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const juce::int32 index = static_cast<juce::int32>(i);
+                for (const auto& point : results[i].spectrum)
+                {
+                    const auto offset = rows.size();
+                    rows.resize(offset + 12);
+                    std::memcpy(rows.data() + offset, &index, 4);
+                    std::memcpy(rows.data() + offset + 4, &point, 8);
+                }
+            }
+
+            writeNpyRecords(spectrumFile.withFileExtension(".npy"), { "point", "hz", "dB" }, { "i4", "f4", "f4" },
+                            rows.data(), rows.size() / 12, 12);
+        }
+
+        auto sweep = std::make_unique<juce::DynamicObject>();
+        sweep->setProperty("plugin", key);
+        sweep->setProperty("renderInput", input->name);
+        sweep->setProperty("points", static_cast<int>(results.size()));
+        sweep->setProperty("okPoints", okCount);
+        sweep->setProperty("instances", instancesUsed);
+        sweep->setProperty("wallMs", wallMs);
+        sweep->setProperty("metrics", metricsFile.getFullPathName());
+        sweep->setProperty("spectrum", spectrumFile.getFullPathName());
+        if (!errors.isEmpty())
+            sweep->setProperty("errors", juce::var(errors));
+        response->setProperty("sweep", juce::var(sweep.release()));
+
+        if (okCount == 0)
+        {
+            response->setProperty("error", "Sweep " + key + " failed: " + results.front().error);
+            return false;
+        }
+
         return true;
     }
 
@@ -651,12 +1212,69 @@ private:
             if (wet == nullptr || ref == nullptr)
                 return;
 
-            wet->groupDelay = computeTransferGroupDelay(ref->buffer, wet->buffer, ref->sampleRate);
+            applyTransferFunction(*wet, computeTransferFunction(ref->buffer, wet->buffer, ref->sampleRate));
         };
 
-        refreshFor(wetA, renderReferenceA);
-        refreshFor(wetB, renderReferenceB);
-        refreshFor(wetC, renderReferenceC);
+        AnalysisTaskGraph graph;
+        graph.addTask("transfer wetA", [&] { refreshFor(wetA, renderReferenceA); });
+        graph.addTask("transfer wetB", [&] { refreshFor(wetB, renderReferenceB); });
+        graph.addTask("transfer wetC", [&] { refreshFor(wetC, renderReferenceC); });
+        runProfiledGraph(graph);
+    }
+
+    template <typename Fn>
+    auto timeStage(const char* name, Fn&& fn)
+    {
+        const JobProfiler::ScopedStage stage(*profiler, name);
+        return fn();
+    }
+
+    /** run(), with the graph's tasks added to the job's trace. */
+    void runProfiledGraph(AnalysisTaskGraph& graph)
+    {
+        const auto startMs = profiler->nowMs();
+        graph.run();
+        profiler->addTaskTimings(graph, startMs);
+    }
+
+    /** Wall time and memory of every stage; trace.json as well when the
+     *  job sets export.trace. */
+    void writeProfile()
+    {
+        auto profile = profiler->toVar();
+        if (getBool(getObject(job, "export"), "trace", false))
+        {
+            const auto traceFile = outDir.getChildFile("trace.json");
+            if (profiler->writeChromeTrace(traceFile))
+                profile.getDynamicObject()->setProperty("traceFile", traceFile.getFullPathName());
+        }
+
+        response->setProperty("profile", profile);
+    }
+
+    /** Per-stage timing of each asset's last analysis (empty for cache hits). */
+    void writeAnalysisTimings()
+    {
+        auto timings = std::make_unique<juce::DynamicObject>();
+        for (const auto* id : { "dryA", "dryB", "dryC", "wetA", "wetB", "wetC" })
+            if (const auto* asset = getAssetById(id))
+                timings->setProperty(id, analysisTimingsToVar(*asset));
+
+        response->setProperty("analysisTimings", juce::var(timings.release()));
+
+        auto artifacts = std::make_unique<juce::DynamicObject>();
+        artifacts->setProperty("enabled", artifactCacheEnabled());
+        artifacts->setProperty("version", kJobArtifactVersion);
+        artifacts->setProperty("events", juce::var(artifactEvents));
+        response->setProperty("artifactCache", juce::var(artifacts.release()));
+
+        const auto pluginStats = PluginInstanceCache::getInstance().getStats();
+        auto plugins = std::make_unique<juce::DynamicObject>();
+        plugins->setProperty("instancesCreated", pluginStats.instancesCreated);
+        plugins->setProperty("instanceHits", pluginStats.instanceHits);
+        plugins->setProperty("descriptionHits", pluginStats.descriptionHits);
+        plugins->setProperty("idleInstances", pluginStats.idleInstances);
+        response->setProperty("pluginCache", juce::var(plugins.release()));
     }
 
     void writeOutputs()
@@ -672,33 +1290,28 @@ private:
 
         const auto views = getViews();
         const auto preset = getExportPreset();
+        std::vector<PendingFigure> pendingFigures;
         for (const auto& view : views)
         {
             const auto png = figureDir.getChildFile(sanitizeFileToken(sessionId + "_" + view + "_" + preset)).withFileExtension(".png");
-            writeFigure(png, view, preset);
+            pendingFigures.push_back({ png, makeFigureData(view), isDarkPreset(preset), isAcademicLightPreset(preset),
+                                       getExportWidth(), getExportHeight() });
             figures.add(png.getFullPathName());
         }
 
-        writeThesisFigures(figureDir, preset, figures, thesisFigures);
+        collectThesisFigures(figureDir, preset, figures, thesisFigures, pendingFigures);
 
-        writeAssetCurves(dataDir, "dry", dryAsset.get(), dataFiles);
-        writeAssetCurves(dataDir, "dryA", dryAsset.get(), dataFiles);
-        writeAssetCurves(dataDir, "dryB", dryBAsset.get(), dataFiles);
-        writeAssetCurves(dataDir, "dryC", dryCAsset.get(), dataFiles);
-        writeAssetCurves(dataDir, "wetA", wetA.get(), dataFiles);
-        writeAssetCurves(dataDir, "wetB", wetB.get(), dataFiles);
-        writeAssetCurves(dataDir, "wetC", wetC.get(), dataFiles);
-        writeVisibleSlotCurves(dataDir, dataFiles);
-        writeApparentAttenuationCsv(dataDir, "display2_vs_display1",
-                                    getAssetById(displaySlotSources[0]), getAssetById(displaySlotSources[1]), dataFiles);
-        writeApparentAttenuationCsv(dataDir, "display3_vs_display1",
-                                    getAssetById(displaySlotSources[0]), getAssetById(displaySlotSources[2]), dataFiles);
-        writeApparentAttenuationCsv(dataDir, "wetA_vs_render_reference",
-                                    renderReferenceA != nullptr ? renderReferenceA.get() : dryAsset.get(), wetA.get(), dataFiles);
-        writeApparentAttenuationCsv(dataDir, "wetB_vs_render_reference",
-                                    renderReferenceB != nullptr ? renderReferenceB.get() : dryAsset.get(), wetB.get(), dataFiles);
-        writeApparentAttenuationCsv(dataDir, "wetC_vs_render_reference",
-                                    renderReferenceC != nullptr ? renderReferenceC.get() : dryAsset.get(), wetC.get(), dataFiles);
+        // Every figure is drawn and encoded on its own task; the CSVs are
+        // written alongside, and the manifests wait for all of them
+        AnalysisTaskGraph graph;
+        for (auto& figure : pendingFigures)
+            graph.addTask("figure " + figure.file.getFileNameWithoutExtension(), [&figure]
+            {
+                AudioDoctorFigureRenderer::writePng(figure.file, figure.data, figure.dark,
+                                                    figure.width, figure.height, figure.academicLight);
+            });
+        graph.addTask("data files", [&] { writeDataFiles(dataDir, dataFiles); });
+        timeStage("figures", [&] { runProfiledGraph(graph); });
 
         const auto manifestFile = outDir.getChildFile("manifest.json");
         const auto appendixFile = outDir.getChildFile("appendix_table.csv");
@@ -714,7 +1327,31 @@ private:
         response->setProperty("summary", summaryFile.getFullPathName());
     }
 
-    void writeVisibleSlotCurves(const juce::File& dataDir, juce::Array<juce::var>& dataFiles) const
+    /** Every per-asset and comparison data file under data/. */
+    void writeDataFiles(const juce::File& dataDir, juce::Array<juce::var>& dataFiles) const
+    {
+        const auto formats = getDataFileFormats();
+        writeAssetCurves(dataDir, "dry", dryAsset.get(), dataFiles, formats);
+        writeAssetCurves(dataDir, "dryA", dryAsset.get(), dataFiles, formats);
+        writeAssetCurves(dataDir, "dryB", dryBAsset.get(), dataFiles, formats);
+        writeAssetCurves(dataDir, "dryC", dryCAsset.get(), dataFiles, formats);
+        writeAssetCurves(dataDir, "wetA", wetA.get(), dataFiles, formats);
+        writeAssetCurves(dataDir, "wetB", wetB.get(), dataFiles, formats);
+        writeAssetCurves(dataDir, "wetC", wetC.get(), dataFiles, formats);
+        writeVisibleSlotCurves(dataDir, dataFiles, formats);
+        writeApparentAttenuationCsv(dataDir, "display2_vs_display1",
+                                    getAssetById(displaySlotSources[0]), getAssetById(displaySlotSources[1]), dataFiles, formats);
+        writeApparentAttenuationCsv(dataDir, "display3_vs_display1",
+                                    getAssetById(displaySlotSources[0]), getAssetById(displaySlotSources[2]), dataFiles, formats);
+        writeApparentAttenuationCsv(dataDir, "wetA_vs_render_reference",
+                                    renderReferenceA != nullptr ? renderReferenceA.get() : dryAsset.get(), wetA.get(), dataFiles, formats);
+        writeApparentAttenuationCsv(dataDir, "wetB_vs_render_reference",
+                                    renderReferenceB != nullptr ? renderReferenceB.get() : dryAsset.get(), wetB.get(), dataFiles, formats);
+        writeApparentAttenuationCsv(dataDir, "wetC_vs_render_reference",
+                                    renderReferenceC != nullptr ? renderReferenceC.get() : dryAsset.get(), wetC.get(), dataFiles, formats);
+    }
+
+    void writeVisibleSlotCurves(const juce::File& dataDir, juce::Array<juce::var>& dataFiles, DataFileFormats formats) const
     {
         for (size_t i = 0; i < displaySlotSources.size(); ++i)
         {
@@ -722,7 +1359,7 @@ private:
             if (asset == nullptr)
                 continue;
 
-            writeAssetCurves(dataDir, "display" + juce::String(static_cast<int>(i + 1)), asset, dataFiles);
+            writeAssetCurves(dataDir, "display" + juce::String(static_cast<int>(i + 1)), asset, dataFiles, formats);
         }
     }
 
@@ -746,6 +1383,16 @@ private:
         return !preset.contains("light") && !isAcademicLightPreset(preset);
     }
 
+    /** export.dataFormat: "csv" (default), "npy" or "both". */
+    DataFileFormats getDataFileFormats() const
+    {
+        const auto format = getString(getObject(job, "export"), "dataFormat", "csv").trim().toLowerCase();
+        DataFileFormats formats;
+        formats.csv = format != "npy";
+        formats.npy = format == "npy" || format == "both";
+        return formats;
+    }
+
     int getExportWidth() const
     {
         return juce::jlimit(640, 6000, static_cast<int>(std::round(getDouble(getObject(job, "export"), "width", 1800.0))));
@@ -768,16 +1415,21 @@ private:
         return views;
     }
 
-    void writeFigure(const juce::File& file, const juce::String& view, const juce::String& preset)
+    /** A figure queued for writeOutputs() to draw and encode on the task graph. */
+    struct PendingFigure
     {
-        AudioDoctorFigureRenderer::writePng(file, makeFigureData(view), isDarkPreset(preset),
-                                            getExportWidth(), getExportHeight(),
-                                            isAcademicLightPreset(preset));
-    }
+        juce::File file;
+        FigureData data;
+        bool dark = false;
+        bool academicLight = false;
+        int width = 1800;
+        int height = 900;
+    };
 
-    void writeThesisFigures(const juce::File& figureDir, const juce::String& preset,
-                            juce::Array<juce::var>& figures,
-                            juce::Array<juce::var>& thesisFigures)
+    void collectThesisFigures(const juce::File& figureDir, const juce::String& preset,
+                              juce::Array<juce::var>& figures,
+                              juce::Array<juce::var>& thesisFigures,
+                              std::vector<PendingFigure>& pendingFigures)
     {
         const auto specs = getThesisFigureSpecs();
         const bool dark = isDarkPreset(preset);
@@ -791,10 +1443,6 @@ private:
             auto figureData = makeThesisFigureData(spec, token);
             const auto png = figureDir.getChildFile(sanitizeFileToken(sessionId + "_thesis_" + token + "_" + preset))
                                       .withFileExtension(".png");
-            AudioDoctorFigureRenderer::writePng(png, figureData, dark,
-                                                juce::jmax(1800, getExportWidth()),
-                                                juce::jmax(1050, getExportHeight()),
-                                                academicLight);
             figures.add(png.getFullPathName());
 
             auto obj = std::make_unique<juce::DynamicObject>();
@@ -808,6 +1456,9 @@ private:
             obj->setProperty("sources", writeThesisFigureSources(figureData));
             obj->setProperty("notes", thesisTemplateBoundaryNote(token));
             thesisFigures.add(juce::var(obj.release()));
+
+            pendingFigures.push_back({ png, std::move(figureData), dark, academicLight,
+                                       juce::jmax(1800, getExportWidth()), juce::jmax(1050, getExportHeight()) });
         }
     }
 
@@ -1783,6 +2434,7 @@ private:
         obj->setProperty("selectionEndSeconds", selectionEnd);
         obj->setProperty("analysisDurationSeconds", asset->metrics.durationSeconds);
         obj->setProperty("peakDb", asset->metrics.peakDb);
+        obj->setProperty("truePeakDb", asset->metrics.truePeakDb);
         obj->setProperty("rmsDb", asset->metrics.rmsDb);
         obj->setProperty("crestDb", asset->metrics.crestDb);
         obj->setProperty("reverbSpace", writeSpaceMetrics(asset->spaceMetrics));
@@ -1864,6 +2516,9 @@ private:
         obj->setProperty("ceilingDb", getDouble(exportSpec, "ceilingDb", 0.0));
         obj->setProperty("width", getExportWidth());
         obj->setProperty("height", getExportHeight());
+        const auto formats = getDataFileFormats();
+        obj->setProperty("dataFormat", formats.csv && formats.npy ? "both" : (formats.npy ? "npy" : "csv"));
+        obj->setProperty("trace", getBool(getObject(job, "export"), "trace", false));
         return juce::var(obj.release());
     }
 
@@ -1912,6 +2567,7 @@ private:
         obj->setProperty("identifier", desc->createIdentifierString());
         obj->setProperty("latencySamples", renderInfo.latencySamples);
         obj->setProperty("tailSeconds", renderInfo.tailSeconds);
+        obj->setProperty("renderSegments", renderInfo.segments);
 
         juce::Array<juce::var> params;
         for (const auto& p : host.listParameters())
@@ -1950,11 +2606,18 @@ private:
         return juce::var(obj.release());
     }
 
+    SharedAssetStore* sharedAssets = nullptr;
+    std::mutex sharedSourcesMutex;
+    std::vector<std::shared_ptr<const Asset>> sharedSources;   // declared before the assets viewing them
+    std::mutex artifactMutex;
+    juce::Array<juce::var> artifactEvents;
+    juce::String defaultSessionId;
     juce::var job;
     int schemaVersion = 1;
     juce::String sessionId;
     juce::File outDir;
     std::unique_ptr<juce::DynamicObject> response;
+    std::unique_ptr<JobProfiler> profiler;
     std::array<juce::String, 3> displaySlotSources { "dryA", "wetA", "wetB" };
     AssetPtr dryAsset;
     AssetPtr dryBAsset;
@@ -0,0 +1,269 @@
+/*
+  ==============================================================================
+    AudioDoctorPluginCache.h
+    GOODMETER Audio Doctor - process-wide cache of plugin scans and instances.
+
+    Every job (and every reload in the Audio Doctor window) used to scan the
+    plugin file and instantiate it from scratch; for convolution reverbs and
+    ML denoisers that costs more than the render. Two things are kept here:
+
+      - Descriptions, by plugin file path and the size and modification
+        time of its executable (inside the bundle for .vst3/.component), so
+        an unchanged plugin is scanned once per process.
+      - Idle, prepared instances, keyed by plugin identifier (file + format),
+        sample rate, block size and host channel count. A released instance
+        is returned to its factory state (the state captured when the first
+        instance of that key was created) and reset() before it is parked;
+        PluginHost applies the caller's own state when it takes it again.
+
+    Idle instances are evicted least recently parked first above a limit
+    of two per core. clear() must run before JUCE shuts down (see
+    StandaloneApp::shutdown), since plugins can't be destroyed after that.
+
+    Thread safety model:
+      - Any thread that may create plugin instances. The maps are guarded by
+        a mutex; scans, state restores and destruction run outside it.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace goodmeter::audio_doctor
+{
+
+class PluginInstanceCache
+{
+public:
+    struct Key
+    {
+        juce::String identifier;        // PluginDescription::createIdentifierString()
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        int channels = 2;
+
+        bool operator<(const Key& other) const
+        {
+            if (identifier != other.identifier)  return identifier < other.identifier;
+            if (sampleRate != other.sampleRate)  return sampleRate < other.sampleRate;
+            if (blockSize != other.blockSize)    return blockSize < other.blockSize;
+            return channels < other.channels;
+        }
+    };
+
+    /** Shared by every PluginHost in the process. */
+    static PluginInstanceCache& getInstance()
+    {
+        static PluginInstanceCache cache;
+        return cache;
+    }
+
+    /** The file whose size and modification time tell whether a plugin
+     *  changed. For a bundle that is its executable (Contents/MacOS/<name>,
+     *  or the VST3 Contents/<architecture>/<name>.*): a rebuild rewrites it
+     *  while the bundle's directories can keep their sizes and timestamps. */
+    static juce::File getPluginBinary(const juce::File& file)
+    {
+        if (! file.isDirectory())
+            return file;
+
+        const auto contents = file.getChildFile("Contents");
+        const auto name = file.getFileNameWithoutExtension();
+
+        const auto macBinary = contents.getChildFile("MacOS").getChildFile(name);
+        if (macBinary.existsAsFile())
+            return macBinary;
+
+        for (const auto& folder : contents.findChildFiles(juce::File::findDirectories, false))
+            for (const auto& candidate : folder.findChildFiles(juce::File::findFiles, false))
+                if (candidate.getFileNameWithoutExtension() == name)
+                    return candidate;
+
+        // CFBundleExecutable differs from the bundle name: the only file in MacOS
+        const auto executables = contents.getChildFile("MacOS").findChildFiles(juce::File::findFiles, false);
+        return executables.size() == 1 ? executables.getFirst() : file;
+    }
+
+    //==========================================================================
+    /** First plugin type in a file, scanned only when the file changed. */
+    bool findDescription(juce::AudioPluginFormatManager& formatManager,
+                         juce::KnownPluginList& knownPlugins,
+                         const juce::File& file,
+                         juce::PluginDescription& description,
+                         juce::String& error)
+    {
+        // A bundle folder's own size and mtime don't follow a rebuild
+        const auto path = file.getFullPathName();
+        const auto binary = getPluginBinary(file);
+        const auto size = binary.getSize();
+        const auto modified = binary.getLastModificationTime().toMilliseconds();
+
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            const auto it = scans.find(path);
+            if (it != scans.end() && it->second.size == size && it->second.modifiedMs == modified)
+            {
+                description = it->second.description;
+                ++descriptionHits;
+                return true;
+            }
+        }
+
+        juce::OwnedArray<juce::PluginDescription> found;
+        juce::StringArray paths;
+        paths.add(path);
+        knownPlugins.scanAndAddDragAndDroppedFiles(formatManager, paths, found);
+
+        if (found.isEmpty())
+        {
+            error = "No AU/VST3 plugin type found in selected package.";
+            return false;
+        }
+
+        description = *found.getFirst();
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        scans[path] = { size, modified, description };
+        return true;
+    }
+
+    //==========================================================================
+    /** A parked instance for this key, already prepared at its rate and
+     *  block size and back at factory state; nullptr when none is idle. */
+    std::unique_ptr<juce::AudioPluginInstance> acquire(const Key& key)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = idle.begin(); it != idle.end(); ++it)
+        {
+            if (it->key < key || key < it->key)
+                continue;
+
+            auto instance = std::move(it->instance);
+            idle.erase(it);
+            ++instanceHits;
+            return instance;
+        }
+
+        return {};
+    }
+
+    /** Record a freshly created instance's state as its key's factory
+     *  state, before any caller state is applied. */
+    void noteCreated(const Key& key, juce::AudioPluginInstance& instance)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            ++instancesCreated;
+            if (factoryStates.find(key) != factoryStates.end())
+                return;
+        }
+
+        juce::MemoryBlock state;
+        instance.getStateInformation(state);
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        factoryStates.emplace(key, std::move(state));
+    }
+
+    /** Park an instance for reuse: factory state restored, DSP state reset. */
+    void recycle(const Key& key, std::unique_ptr<juce::AudioPluginInstance> instance)
+    {
+        if (instance == nullptr)
+            return;
+
+        juce::MemoryBlock state;
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            const auto it = factoryStates.find(key);
+            if (it != factoryStates.end())
+                state = it->second;
+        }
+
+        if (state.getSize() > 0)
+            instance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        instance->reset();
+
+        std::vector<std::unique_ptr<juce::AudioPluginInstance>> evicted;
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back({ key, std::move(instance) });
+
+            while (idle.size() > getMaxIdleInstances())
+            {
+                evicted.push_back(std::move(idle.front().instance));
+                idle.erase(idle.begin());
+            }
+        }
+
+        for (auto& old : evicted)
+            old->releaseResources();
+    }
+
+    /** Destroy every parked instance and forget all scans. */
+    void clear()
+    {
+        std::vector<Idle> released;
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            released.swap(idle);
+            scans.clear();
+            factoryStates.clear();
+        }
+
+        for (auto& entry : released)
+            entry.instance->releaseResources();
+    }
+
+    //==========================================================================
+    struct Stats
+    {
+        int idleInstances = 0;
+        int instancesCreated = 0;
+        int instanceHits = 0;
+        int descriptionHits = 0;
+    };
+
+    Stats getStats() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return { static_cast<int>(idle.size()), instancesCreated, instanceHits, descriptionHits };
+    }
+
+private:
+    PluginInstanceCache() = default;
+
+    struct Scan
+    {
+        juce::int64 size = 0;
+        juce::int64 modifiedMs = 0;
+        juce::PluginDescription description;
+    };
+
+    struct Idle
+    {
+        Key key;
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+    };
+
+    static size_t getMaxIdleInstances()
+    {
+        return static_cast<size_t>(juce::jmax(4, 2 * juce::SystemStats::getNumCpus()));
+    }
+
+    mutable std::mutex mutex;
+    std::map<juce::String, Scan> scans;
+    std::map<Key, juce::MemoryBlock> factoryStates;
+    std::vector<Idle> idle;             // oldest first
+    int instancesCreated = 0;
+    int instanceHits = 0;
+    int descriptionHits = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(PluginInstanceCache)
+};
+
+} // namespace goodmeter::audio_doctor
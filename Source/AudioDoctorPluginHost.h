@@ -8,7 +8,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
 #include "AudioDoctorAnalysis.h"
+#include "AudioDoctorPluginCache.h"
 
 namespace goodmeter::audio_doctor
 {
@@ -20,6 +22,46 @@ struct OfflineRenderResult
     juce::PluginDescription pluginDescription;
     int latencySamples = 0;
     double tailSeconds = 0.0;
+    int segments = 1;                   // plugin instances the render was split over
+};
+
+/** Instances and buffers of one offline render, possibly split into
+ *  segments rendered concurrently (PluginHost::prepareOfflineRender). */
+struct OfflineRenderPlan
+{
+    const Asset* dry = nullptr;
+    juce::PluginDescription description;
+    juce::AudioBuffer<float> input;     // stereo dry
+    juce::AudioBuffer<float> output;    // input length + tail, latency compensated
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+    std::vector<int> segmentStarts;     // one per instance, plus the input length
+    int blockSize = 512;
+    int latencySamples = 0;
+    int prerollSamples = 0;
+    double tailSeconds = 0.0;
+    juce::String error;
+    OfflineRenderResult result;
+};
+
+/** One point of a parameter sweep: normalised values keyed like
+ *  PluginHost::setParameterValue() (index, parameter ID or name). */
+struct ParameterSweepPoint
+{
+    std::vector<std::pair<juce::String, float>> values;
+};
+
+/** A rendered sweep point: only the metrics and the spectrum the sweep
+ *  tables are written from. Neither the audio nor the analysed asset's
+ *  spectrogram images outlive the point's render. */
+struct ParameterSweepResult
+{
+    Metrics metrics;
+    std::vector<PlotPoint> spectrum;
+    juce::String error;
+    int latencySamples = 0;
+    double tailSeconds = 0.0;
+    int instance = 0;                   // pooled instance that rendered it, 1-based
+    double renderMs = 0.0;
 };
 
 struct PluginParameterSnapshot
@@ -55,6 +97,12 @@ public:
         formatManager.addDefaultFormats();
     }
 
+    /** The editable instance goes back to the cache for the next host. */
+    ~PluginHost()
+    {
+        recycleEditableInstance();
+    }
+
     const juce::PluginDescription* getCurrentPlugin() const
     {
         return hasPlugin ? &currentPlugin : nullptr;
@@ -140,21 +188,12 @@ public:
     {
         clearPlugin();
 
-        juce::OwnedArray<juce::PluginDescription> found;
-        juce::StringArray paths;
-        paths.add(file.getFullPathName());
-
-        knownPlugins.scanAndAddDragAndDroppedFiles(formatManager, paths, found);
-
-        if (found.isEmpty())
-        {
-            error = "No AU/VST3 plugin type found in selected package.";
+        juce::PluginDescription description;
+        if (!PluginInstanceCache::getInstance().findDescription(formatManager, knownPlugins, file, description, error))
             return false;
-        }
 
-        auto description = *found.getFirst();
         juce::String creationError;
-        auto instance = createPreparedInstance(description, 48000.0, 512, creationError, nullptr, false);
+        auto instance = createPreparedInstance(description, kEditableSampleRate, kEditableBlockSize, creationError, nullptr, false);
         if (instance == nullptr)
         {
             error = creationError.isNotEmpty() ? creationError : "Plugin instance creation failed.";
@@ -163,6 +202,7 @@ public:
 
         currentPlugin = description;
         editableInstance = std::move(instance);
+        editableInstanceReusable = true;
         savedState.reset();
         refreshChangedParameterSnapshot();
         hasPlugin = true;
@@ -172,12 +212,7 @@ public:
 
     void clearPlugin()
     {
-        if (editableInstance != nullptr)
-        {
-            editableInstance->releaseResources();
-            editableInstance.reset();
-        }
-
+        recycleEditableInstance();
         currentPlugin = {};
         savedState.reset();
         changedParameters.clear();
@@ -204,8 +239,8 @@ public:
         }
 
         auto instance = createPreparedInstance(currentPlugin,
-                                               48000.0,
-                                               512,
+                                               kEditableSampleRate,
+                                               kEditableBlockSize,
                                                error,
                                                savedState.getSize() > 0 ? &savedState : nullptr,
                                                false);
@@ -218,6 +253,7 @@ public:
         }
 
         editableInstance = std::move(instance);
+        editableInstanceReusable = true;
         error.clear();
         return true;
     }
@@ -233,8 +269,7 @@ public:
         savedState.reset();
         refreshChangedParameterSnapshot();
         editableInstance->getStateInformation(savedState);
-        editableInstance->releaseResources();
-        editableInstance.reset();
+        recycleEditableInstance();
         error.clear();
         return true;
     }
@@ -332,86 +367,228 @@ public:
                                       int blockSize = 512,
                                       double fallbackTailSeconds = 1.0) const
     {
-        OfflineRenderResult result;
+        OfflineRenderPlan plan;
+        if (!prepareOfflineRender(dry, stateToApply, blockSize, fallbackTailSeconds, 1, plan))
+        {
+            OfflineRenderResult result;
+            result.error = plan.error;
+            return result;
+        }
 
+        renderSegment(plan, 0);
+        finishOfflineRender(plan);
+        return std::move(plan.result);
+    }
+
+    /** Create the instances for an offline render. With maxInstances > 1 and a
+     *  long enough input, the input is cut into one segment per instance:
+     *  each instance starts a pre-roll (the plugin's tail, at least a second)
+     *  before its segment so its state has settled when its output is used,
+     *  and reads past the segment end by the plugin latency. Segments
+     *  shorter than 8 pre-rolls or 5 s are never split off. Only use several
+     *  instances with plugins that are safe to run as independent copies.
+     *
+     *  Instances are created here, on the calling thread (plugin formats may
+     *  need the message thread); addOfflineRenderTasks() then processes every
+     *  segment concurrently. */
+    bool prepareOfflineRender(const Asset& dry,
+                              const juce::MemoryBlock* stateToApply,
+                              int blockSize,
+                              double fallbackTailSeconds,
+                              int maxInstances,
+                              OfflineRenderPlan& plan) const
+    {
+        plan = {};
         if (!hasPlugin)
         {
-            result.error = "No plugin loaded.";
-            return result;
+            plan.error = "No plugin loaded.";
+            return false;
         }
 
         if (dry.buffer.getNumSamples() <= 0 || dry.sampleRate <= 0.0)
         {
-            result.error = "No dry audio available.";
-            return result;
+            plan.error = "No dry audio available.";
+            return false;
         }
 
         juce::String creationError;
-        auto instance = createPreparedInstance(currentPlugin,
-                                               dry.sampleRate,
-                                               blockSize,
-                                               creationError,
-                                               stateToApply,
-                                               true);
-
-        if (instance == nullptr)
+        auto first = createPreparedInstance(currentPlugin, dry.sampleRate, blockSize, creationError, stateToApply, true);
+        if (first == nullptr)
         {
-            result.error = creationError.isNotEmpty() ? creationError : "Plugin instance creation failed.";
-            return result;
+            plan.error = creationError.isNotEmpty() ? creationError : "Plugin instance creation failed.";
+            return false;
         }
 
-        const int hostChannels = 2;
-        auto input = toStereoBuffer(dry.buffer);
-
-        const double pluginTail = instance->getTailLengthSeconds();
-        const double tailSeconds = std::isfinite(pluginTail) && pluginTail > 0.0
+        const double pluginTail = first->getTailLengthSeconds();
+        plan.tailSeconds = std::isfinite(pluginTail) && pluginTail > 0.0
             ? juce::jlimit(0.0, 8.0, pluginTail)
             : fallbackTailSeconds;
+        plan.latencySamples = juce::jmax(0, first->getLatencySamples());
+        plan.blockSize = blockSize;
+        plan.description = currentPlugin;
+        plan.dry = &dry;
+        plan.input = toStereoBuffer(dry.buffer);
+
+        const int inputSamples = plan.input.getNumSamples();
+        const int tailSamples = static_cast<int>(plan.tailSeconds * dry.sampleRate);
+        plan.prerollSamples = static_cast<int>(juce::jmax(plan.tailSeconds, 1.0) * dry.sampleRate);
+        const int minSegment = juce::jmax(8 * plan.prerollSamples, static_cast<int>(5.0 * dry.sampleRate));
+        const int segments = juce::jlimit(1, juce::jmax(1, maxInstances), inputSamples / juce::jmax(1, minSegment));
+
+        plan.instances.push_back(std::move(first));
+        for (int k = 1; k < segments; ++k)
+        {
+            auto instance = createPreparedInstance(currentPlugin, dry.sampleRate, blockSize, creationError, stateToApply, true);
+            if (instance == nullptr)
+                break;      // render with the instances we have
+            plan.instances.push_back(std::move(instance));
+        }
 
-        const int tailSamples = static_cast<int>(tailSeconds * dry.sampleRate);
-        const int totalSamples = input.getNumSamples() + tailSamples;
+        const int count = static_cast<int>(plan.instances.size());
+        for (int k = 0; k <= count; ++k)
+            plan.segmentStarts.push_back(static_cast<int>(static_cast<juce::int64>(k) * inputSamples / count));
 
-        juce::AudioBuffer<float> output(hostChannels, totalSamples);
-        output.clear();
+        plan.output.setSize(2, inputSamples + tailSamples);
+        plan.output.clear();
+        return true;
+    }
 
-        const int blockChannels = totalChannelsForRender(*instance, hostChannels);
-        juce::AudioBuffer<float> block(blockChannels, blockSize);
-        juce::MidiBuffer midi;
+    /** One task per segment of a prepared plan; finishOfflineRender() once the graph has run. */
+    static void addOfflineRenderTasks(AnalysisTaskGraph& graph, OfflineRenderPlan& plan)
+    {
+        for (int k = 0; k < static_cast<int>(plan.instances.size()); ++k)
+            graph.addTask(plan.description.name + " segment " + juce::String(k + 1),
+                          [&plan, k] { renderSegment(plan, k); });
+    }
 
-        for (int pos = 0; pos < totalSamples; pos += blockSize)
+    /** Return the instances to the cache and analyse the assembled output into plan.result. */
+    static void finishOfflineRender(OfflineRenderPlan& plan)
+    {
+        const auto key = cacheKeyFor(plan.description, plan.dry->sampleRate, plan.blockSize);
+        for (auto& instance : plan.instances)
+            PluginInstanceCache::getInstance().recycle(key, std::move(instance));
+        plan.instances.clear();
+
+        auto& result = plan.result;
+        result.latencySamples = plan.latencySamples;
+        result.tailSeconds = plan.tailSeconds;
+        result.pluginDescription = plan.description;
+        result.segments = static_cast<int>(plan.segmentStarts.size()) - 1;
+        result.wet.name = plan.dry->name + " -> " + plan.description.name;
+        result.wet.sourcePath = plan.dry->sourcePath;
+        result.wet.sampleRate = plan.dry->sampleRate;
+        result.wet.buffer = std::move(plan.output);
+        refreshAnalysis(result.wet);
+    }
+
+    /** Render the dry asset once per sweep point on a pool of instances
+     *  (maxInstances <= 0: one per core), all created here on the calling
+     *  thread with baseState applied. Before each point its instance is
+     *  restored to the base snapshot with setStateInformation(), given the
+     *  point's values and reset, so results don't depend on which instance
+     *  or order a point ran in. Each render is streamed block by block into
+     *  a StreamingAssetAnalyzer; no wet audio is buffered or written.
+     *
+     *  State and parameter changes always happen on the calling thread,
+     *  like every other call PluginHost makes. With more than one instance,
+     *  points go out in rounds: the caller configures one point per
+     *  instance, then only the processBlock() renders run in parallel on
+     *  the analysis pool. Pass maxInstances = 1 (serial, everything on the
+     *  calling thread) unless the plugin is known to tolerate concurrent
+     *  rendering of separate instances.
+     *
+     *  Fails only when nothing can be rendered; a point whose parameters
+     *  can't be found gets its own error. */
+    bool renderParameterSweep(const Asset& dry,
+                              const juce::MemoryBlock* baseState,
+                              const std::vector<ParameterSweepPoint>& points,
+                              std::vector<ParameterSweepResult>& results,
+                              juce::String& error,
+                              int maxInstances = 0,
+                              int blockSize = 512,
+                              double fallbackTailSeconds = 1.0) const
+    {
+        results.clear();
+        if (!hasPlugin)
         {
-            const int numThisBlock = juce::jmin(blockSize, totalSamples - pos);
-            block.clear();
-            midi.clear();
+            error = "No plugin loaded.";
+            return false;
+        }
 
-            if (pos < input.getNumSamples())
-            {
-                const int inputSamples = juce::jmin(numThisBlock, input.getNumSamples() - pos);
-                for (int ch = 0; ch < hostChannels; ++ch)
-                    block.copyFrom(ch, 0, input, ch, pos, inputSamples);
-            }
+        if (dry.buffer.getNumSamples() <= 0 || dry.sampleRate <= 0.0)
+        {
+            error = "No dry audio available.";
+            return false;
+        }
 
-            instance->processBlock(block, midi);
+        if (points.empty())
+        {
+            error = "Parameter sweep has no points.";
+            return false;
+        }
 
-            for (int ch = 0; ch < hostChannels; ++ch)
-                output.copyFrom(ch, pos, block, ch, 0, numThisBlock);
+        const int wanted = juce::jlimit(1, static_cast<int>(points.size()),
+                                        maxInstances > 0 ? maxInstances : juce::SystemStats::getNumCpus());
+        std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+        juce::String creationError;
+        for (int k = 0; k < wanted; ++k)
+        {
+            auto instance = createPreparedInstance(currentPlugin, dry.sampleRate, blockSize, creationError, baseState, true);
+            if (instance == nullptr)
+                break;      // sweep with the instances we have
+            instances.push_back(std::move(instance));
         }
 
-        result.latencySamples = juce::jmax(0, instance->getLatencySamples());
-        result.tailSeconds = tailSeconds;
-        result.pluginDescription = currentPlugin;
+        if (instances.empty())
+        {
+            error = creationError.isNotEmpty() ? creationError : "Plugin instance creation failed.";
+            return false;
+        }
 
-        instance->releaseResources();
+        // Without a base state, a fresh instance's own state is the snapshot
+        juce::MemoryBlock snapshot;
+        if (baseState != nullptr && baseState->getSize() > 0)
+            snapshot = *baseState;
+        else
+            instances.front()->getStateInformation(snapshot);
 
-        if (result.latencySamples > 0)
-            compensateLatency(output, result.latencySamples);
+        const auto input = toStereoBuffer(dry.buffer);
+        results.resize(points.size());
 
-        result.wet.name = dry.name + " -> " + currentPlugin.name;
-        result.wet.sourcePath = dry.sourcePath;
-        result.wet.sampleRate = dry.sampleRate;
-        result.wet.buffer = std::move(output);
-        refreshAnalysis(result.wet);
-        return result;
+        for (size_t first = 0; first < points.size(); first += instances.size())
+        {
+            const size_t count = juce::jmin(instances.size(), points.size() - first);
+            std::vector<size_t> ready;
+            for (size_t k = 0; k < count; ++k)
+            {
+                auto& result = results[first + k];
+                result.instance = static_cast<int>(k) + 1;
+                if (configureSweepPoint(*instances[k], snapshot, points[first + k], fallbackTailSeconds, result))
+                    ready.push_back(k);
+            }
+
+            if (ready.size() == 1 || instances.size() == 1)
+            {
+                for (auto k : ready)
+                    renderSweepPoint(*instances[k], input, dry, blockSize, results[first + k]);
+                continue;
+            }
+
+            AnalysisTaskGraph graph;
+            for (auto k : ready)
+                graph.addTask(currentPlugin.name + " sweep " + juce::String(static_cast<int>(first + k)), [&, k, first]
+                {
+                    renderSweepPoint(*instances[k], input, dry, blockSize, results[first + k]);
+                });
+            graph.run();
+        }
+
+        const auto key = cacheKeyFor(currentPlugin, dry.sampleRate, blockSize);
+        for (auto& instance : instances)
+            PluginInstanceCache::getInstance().recycle(key, std::move(instance));
+
+        error.clear();
+        return true;
     }
 
     OfflineRenderResult renderEditableOffline(const Asset& dry,
@@ -438,10 +615,33 @@ public:
                                    result,
                                    blockSize,
                                    fallbackTailSeconds);
+        editableInstanceReusable = false;   // released at the render's rate, not the editor's
         return result;
     }
 
 private:
+    static constexpr double kEditableSampleRate = 48000.0;
+    static constexpr int kEditableBlockSize = 512;
+
+    static PluginInstanceCache::Key cacheKeyFor(const juce::PluginDescription& description, double sampleRate, int blockSize)
+    {
+        return { description.createIdentifierString(), sampleRate, blockSize, 2 };
+    }
+
+    void recycleEditableInstance()
+    {
+        if (editableInstance == nullptr)
+            return;
+
+        if (editableInstanceReusable)
+            PluginInstanceCache::getInstance().recycle(cacheKeyFor(currentPlugin, kEditableSampleRate, kEditableBlockSize),
+                                                       std::move(editableInstance));
+        else
+            editableInstance->releaseResources();
+
+        editableInstance.reset();
+    }
+
     static juce::String makeParameterFallbackId(int index)
     {
         return "param_" + juce::String(index).paddedLeft('0', 2);
@@ -449,16 +649,18 @@ private:
 
     juce::AudioProcessorParameter* findParameter(const juce::String& key) const
     {
-        if (editableInstance == nullptr)
-            return nullptr;
+        return editableInstance != nullptr ? findParameterIn(*editableInstance, key) : nullptr;
+    }
 
+    static juce::AudioProcessorParameter* findParameterIn(const juce::AudioPluginInstance& instance, const juce::String& key)
+    {
         const auto trimmed = key.trim();
         if (trimmed.isEmpty())
             return nullptr;
 
         const int index = trimmed.getIntValue();
         const bool indexLike = trimmed.containsOnly("0123456789");
-        const auto& params = editableInstance->getParameters();
+        const auto& params = instance.getParameters();
         if (indexLike && juce::isPositiveAndBelow(index, params.size()))
             return params[index];
 
@@ -524,6 +726,147 @@ private:
         }
     }
 
+    /** Render segment k of a plan into its part of plan.output, latency
+     *  compensated. Output sample t is the instance's stream at t + latency;
+     *  the last segment runs to the end of the tail, and, as with a single
+     *  instance, its final latency samples stay silent. */
+    static void renderSegment(OfflineRenderPlan& plan, int k)
+    {
+        auto& instance = *plan.instances[(size_t) k];
+        const int hostChannels = 2;
+        const int inputSamples = plan.input.getNumSamples();
+        const int outputSamples = plan.output.getNumSamples();
+        const bool last = k == static_cast<int>(plan.instances.size()) - 1;
+
+        const int segmentStart = plan.segmentStarts[(size_t) k];
+        const int segmentEnd = last ? outputSamples : plan.segmentStarts[(size_t) k + 1];
+        const int renderStart = k == 0 ? 0 : segmentStart - plan.prerollSamples;
+        const int renderEnd = last ? outputSamples : segmentEnd + plan.latencySamples;
+
+        const int blockSize = plan.blockSize;
+        const int blockChannels = totalChannelsForRender(instance, hostChannels);
+        juce::AudioBuffer<float> block(blockChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int pos = renderStart; pos < renderEnd; pos += blockSize)
+        {
+            const int numThisBlock = juce::jmin(blockSize, renderEnd - pos);
+            block.clear();
+            midi.clear();
+
+            if (pos < inputSamples)
+            {
+                const int available = juce::jmin(numThisBlock, inputSamples - pos);
+                for (int ch = 0; ch < hostChannels; ++ch)
+                    block.copyFrom(ch, 0, plan.input, ch, pos, available);
+            }
+
+            instance.processBlock(block, midi);
+
+            // Stream position pos + i lands at output pos + i - latency
+            const int from = juce::jmax(pos, segmentStart + plan.latencySamples);
+            const int to = juce::jmin(pos + numThisBlock, segmentEnd + plan.latencySamples);
+            for (int ch = 0; ch < hostChannels && from < to; ++ch)
+                plan.output.copyFrom(ch, from - plan.latencySamples, block, ch, from - pos, to - from);
+        }
+    }
+
+    /** Calling thread: restore the base snapshot, apply the point's values
+     *  and reset. False (with result.error set) if a parameter is missing. */
+    static bool configureSweepPoint(juce::AudioPluginInstance& instance,
+                                    const juce::MemoryBlock& snapshot,
+                                    const ParameterSweepPoint& point,
+                                    double fallbackTailSeconds,
+                                    ParameterSweepResult& result)
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        if (snapshot.getSize() > 0)
+            instance.setStateInformation(snapshot.getData(), static_cast<int>(snapshot.getSize()));
+
+        for (const auto& [key, value] : point.values)
+        {
+            auto* parameter = findParameterIn(instance, key);
+            if (parameter == nullptr)
+            {
+                result.error = "Plugin parameter not found: " + key;
+                return false;
+            }
+
+            parameter->setValue(juce::jlimit(0.0f, 1.0f, value));
+        }
+
+        instance.reset();
+
+        // Tail and latency may follow the swept parameters
+        const double pluginTail = instance.getTailLengthSeconds();
+        result.tailSeconds = std::isfinite(pluginTail) && pluginTail > 0.0
+            ? juce::jlimit(0.0, 8.0, pluginTail)
+            : fallbackTailSeconds;
+        result.latencySamples = juce::jmax(0, instance.getLatencySamples());
+
+        result.renderMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+        return true;
+    }
+
+    /** Render one configured sweep point, streaming the latency compensated
+     *  output into the analyser. The output matches renderOffline(): input
+     *  length plus tail, last latency samples silent. */
+    static void renderSweepPoint(juce::AudioPluginInstance& instance,
+                                 const juce::AudioBuffer<float>& input,
+                                 const Asset& dry,
+                                 int blockSize,
+                                 ParameterSweepResult& result)
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        const int hostChannels = 2;
+        const int inputSamples = input.getNumSamples();
+        const int totalSamples = inputSamples + static_cast<int>(result.tailSeconds * dry.sampleRate);
+        const int latency = result.latencySamples;
+
+        StreamingAssetAnalyzer analyzer(totalSamples, dry.sampleRate);
+        const int blockChannels = totalChannelsForRender(instance, hostChannels);
+        juce::AudioBuffer<float> block(blockChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int pos = 0; pos < totalSamples; pos += blockSize)
+        {
+            const int numThisBlock = juce::jmin(blockSize, totalSamples - pos);
+            block.clear();
+            midi.clear();
+
+            if (pos < inputSamples)
+            {
+                const int available = juce::jmin(numThisBlock, inputSamples - pos);
+                for (int ch = 0; ch < hostChannels; ++ch)
+                    block.copyFrom(ch, 0, input, ch, pos, available);
+            }
+
+            instance.processBlock(block, midi);
+
+            // The first `latency` stream samples precede output sample 0
+            const int skip = juce::jlimit(0, numThisBlock, latency - pos);
+            if (skip < numThisBlock)
+                analyzer.push(block.getReadPointer(0, skip), block.getReadPointer(1, skip), numThisBlock - skip);
+        }
+
+        const std::vector<float> silence(static_cast<size_t>(juce::jmin(latency, totalSamples)), 0.0f);
+        analyzer.push(silence.data(), silence.data(), static_cast<int>(silence.size()));
+
+        // The analysed asset (spectrogram images included) dies with this
+        // point; the sweep keeps only what its tables are written from
+        Asset wet;
+        wet.sampleRate = dry.sampleRate;
+        wet.buffer.setSize(2, 0);
+        wet.analysisOnly = true;
+        analyzer.finishInto(wet);
+        result.metrics = wet.metrics;
+        result.spectrum = std::move(wet.spectrum);
+
+        result.renderMs += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    }
+
     static void renderWithPreparedInstance(juce::AudioPluginInstance& instance,
                                            const juce::PluginDescription& description,
                                            const Asset& dry,
@@ -596,6 +939,20 @@ private:
                                                                       const juce::MemoryBlock* stateToApply,
                                                                       bool nonRealtime) const
     {
+        auto& cache = PluginInstanceCache::getInstance();
+        const auto key = cacheKeyFor(description, sampleRate, blockSize);
+
+        // A parked instance is already prepared and back at factory state
+        if (auto cached = cache.acquire(key))
+        {
+            cached->setNonRealtime(nonRealtime);
+            if (stateToApply != nullptr && stateToApply->getSize() > 0)
+                cached->setStateInformation(stateToApply->getData(),
+                                            static_cast<int>(stateToApply->getSize()));
+            cached->reset();
+            return cached;
+        }
+
         auto instance = formatManager.createPluginInstance(description,
                                                            sampleRate,
                                                            blockSize,
@@ -606,6 +963,7 @@ private:
         configurePluginBuses(*instance, 2);
         instance->setNonRealtime(nonRealtime);
         instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        cache.noteCreated(key, *instance);
 
         if (stateToApply != nullptr && stateToApply->getSize() > 0)
             instance->setStateInformation(stateToApply->getData(),
@@ -621,6 +979,7 @@ private:
     std::unique_ptr<juce::AudioPluginInstance> editableInstance;
     juce::MemoryBlock savedState;
     std::vector<PluginParameterSnapshot> changedParameters;
+    bool editableInstanceReusable = false;
     bool hasPlugin = false;
 };
 
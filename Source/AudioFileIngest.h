@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+    AudioFileIngest.h
+    GOODMETER - Shared file ingestion for the offline analysers
+
+    WAV and AIFF (almost all of our material) are opened through
+    juce::MemoryMappedAudioFormatReader: the sample data is mapped once and
+    every read converts straight out of the page cache, with no read() calls,
+    no intermediate I/O buffer, and nothing resident that the kernel can't
+    drop again under pressure. Several readers of the same file share one
+    set of physical pages, so the parallel loudness workers cost no extra
+    memory. Compressed formats (FLAC, MP3, AAC, Ogg) and files that cannot
+    be mapped (address space exhausted, truncated data chunk) fall back to
+    the ordinary decoding reader.
+
+    Callers that do not need the whole file in memory use forEachBlock(),
+    which hands out float views of one block at a time from a single
+    reusable buffer, so peak RSS stays at one block however long the file.
+
+    Thread safety model:
+      - Stateless; every call opens its own reader. A reader must only be
+        used by one thread at a time, as with any AudioFormatReader.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <limits>
+
+//==============================================================================
+class AudioFileIngest
+{
+public:
+    using ReaderFactory = std::function<std::unique_ptr<juce::AudioFormatReader>()>;
+
+    /** Open a reader, memory-mapped for WAV/AIFF, decoding otherwise.
+     *  fallbackFormats is used for everything that can't be mapped; when
+     *  null, a manager with the basic formats is created for the call. */
+    static std::unique_ptr<juce::AudioFormatReader> openReader(const juce::File& file,
+                                                               juce::AudioFormatManager* fallbackFormats = nullptr,
+                                                               bool* wasMapped = nullptr)
+    {
+        if (wasMapped != nullptr)
+            *wasMapped = false;
+
+        if (! file.existsAsFile())
+            return nullptr;
+
+        if (auto mapped = openMapped(file))
+        {
+            if (wasMapped != nullptr)
+                *wasMapped = true;
+            return mapped;
+        }
+
+        if (fallbackFormats != nullptr)
+            return std::unique_ptr<juce::AudioFormatReader>(fallbackFormats->createReaderFor(file));
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(file));
+    }
+
+    /** A factory for analysers that open one reader per worker thread. */
+    static ReaderFactory makeReaderFactory(const juce::File& file)
+    {
+        return [file] { return openReader(file); };
+    }
+
+    //==========================================================================
+    /** Stream the file through callback(channels, numChannels, startSample, numSamples)
+     *  in blocks of blockSize. The channel pointers are only valid during the
+     *  call. Returning false from the callback stops early. Returns false if
+     *  the file can't be opened or a read fails. */
+    template <typename Callback>
+    static bool forEachBlock(const juce::File& file, int blockSize, Callback&& callback,
+                             juce::AudioFormatManager* fallbackFormats = nullptr)
+    {
+        auto reader = openReader(file, fallbackFormats);
+        if (reader == nullptr || reader->numChannels == 0)
+            return false;
+
+        return forEachBlock(*reader, blockSize, std::forward<Callback>(callback));
+    }
+
+    template <typename Callback>
+    static bool forEachBlock(juce::AudioFormatReader& reader, int blockSize, Callback&& callback)
+    {
+        const int numChannels = static_cast<int>(reader.numChannels);
+        blockSize = juce::jmax(256, blockSize);
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+
+        for (juce::int64 pos = 0; pos < reader.lengthInSamples;)
+        {
+            const int n = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), reader.lengthInSamples - pos));
+            if (! reader.read(&block, 0, n, pos, true, true))
+                return false;
+
+            if (! callback(block.getArrayOfReadPointers(), numChannels, pos, n))
+                return true;
+
+            pos += n;
+        }
+
+        return true;
+    }
+
+    //==========================================================================
+    /** Read the first maxChannels channels of the whole file into dest
+     *  (resized to fit). A mono file is duplicated when maxChannels >= 2.
+     *  Only the requested channels are converted, so a 7.1 file read as
+     *  stereo never holds all eight channels in memory. */
+    static bool readIntoBuffer(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& dest, int maxChannels)
+    {
+        if (reader.lengthInSamples <= 0 || reader.lengthInSamples > std::numeric_limits<int>::max())
+            return false;
+
+        const int samples = static_cast<int>(reader.lengthInSamples);
+        const int sourceChannels = static_cast<int>(reader.numChannels);
+        const int channels = maxChannels <= 0 ? sourceChannels
+                           : sourceChannels == 1 ? maxChannels
+                                                 : juce::jmin(maxChannels, sourceChannels);
+
+        dest.setSize(channels, samples, false, false, true);
+        dest.clear();
+
+        if (! reader.read(&dest, 0, samples, 0, true, true))
+            return false;
+
+        if (sourceChannels == 1)
+            for (int ch = 1; ch < channels; ++ch)
+                dest.copyFrom(ch, 0, dest, 0, 0, samples);
+
+        return true;
+    }
+
+private:
+    //==========================================================================
+    static std::unique_ptr<juce::AudioFormatReader> openMapped(const juce::File& file)
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader;
+
+        if (file.hasFileExtension("wav;bwf;rf64"))
+            reader.reset(juce::WavAudioFormat().createMemoryMappedReader(file));
+        else if (file.hasFileExtension("aif;aiff"))
+            reader.reset(juce::AiffAudioFormat().createMemoryMappedReader(file));
+
+        // Mapping can fail on huge files (address space) or oddly laid out
+        // ones; the decoding reader still handles those
+        if (reader == nullptr || reader->lengthInSamples <= 0 || ! reader->mapEntireFile())
+            return nullptr;
+
+        return reader;
+    }
+};
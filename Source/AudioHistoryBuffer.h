@@ -4,49 +4,141 @@
     GOODMETER - Retroactive Recording Engine
 
     A lock-free circular buffer that continuously captures the last N seconds
-    of audio from processBlock. When the user triggers "Save Last 60s",
-    the buffer is snapshot-copied and written to WAV on a background thread.
+    of audio from processBlock. When the user triggers "Save Last 60s", an
+    export thread streams the range straight out of the ring into the WAV
+    writer in chunks; a write-head guard turns anything the audio thread
+    laps into silence instead of torn audio. Several exports may run at once.
 
     Thread safety model:
       - Audio thread: pushSamples() — single producer, writes at writePos
-      - Any thread:   exportLastSeconds() — copies snapshot, launches async WAV writer
-      - No mutex, no lock, no allocation on the audio thread
-
-    Memory: 305s × 48kHz × 2ch × 4 bytes = ~111 MB (constant, no growth)
+      - Any thread:   exportLastSeconds() — snapshots the range, launches an export thread
+      - Message thread / prepareToPlay: setEnabled(), prepare() — allocate, then
+        swap the ring in under a spin lock the audio thread only ever try-locks
+      - No blocking, no allocation on the audio thread
+
+    Memory: nothing until rewind is enabled. Then up to 305s × fs × 2ch × 4 bytes
+    (~111 MB at 48 kHz), granted from the process-wide SharedHistoryPool budget,
+    so many instances in one host cannot each reserve the worst case.
+
+    Compressed mode (long rewinds): the audio thread writes the same float
+    ring, shrunk to a 4 s staging area. A packer thread losslessly encodes
+    each finished 4096-frame block into a CompressedHistoryStore sized for
+    30 min at ~2 bytes per sample; export decodes block by block straight
+    into the WAV writer. Poorly compressible material only shortens the
+    window (oldest blocks are evicted), never the audio thread's budget.
+
+    Disk-backed mode (hour-long capture): same 4 s staging ring, but a
+    flusher thread copies it into a preallocated memory-mapped file ring in
+    the temp directory. Only the staging ring counts against the RAM budget;
+    export hands pointers into the mapped region straight to the WAV writer.
+    The file's blocks are reserved up front (posix_fallocate / F_PREALLOCATE,
+    as BroadcastWavWriter does), never left sparse: a full disk then fails
+    the allocation, which falls back to compressed mode, instead of faulting
+    (SIGBUS) on a later mapped write.
   ==============================================================================
 */
 
 #pragma once
 
 #include <JuceHeader.h>
+#include "SharedHistoryPool.h"
+#include "CompressedHistoryStore.h"
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
+
+#if JUCE_MAC || JUCE_IOS || JUCE_LINUX
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
 
 class AudioHistoryBuffer
 {
 public:
     static constexpr int kCapacitySeconds = 305;  // 5min max export + 5s safety margin
+    static constexpr int kMinimumSeconds = 35;    // 30s shortest export + 5s safety margin
+
+    // Compressed mode
+    static constexpr int kCompressedCapacitySeconds = 1805;  // 30min max export + 5s
+    static constexpr int kStagingSeconds = 4;                // float ring ahead of the packer
+    static constexpr int kBlockFrames = HistoryBlockCodec::kMaxFrames;
+    static constexpr int kPackedBytesPerSample = 2;          // arena sizing estimate (24-bit ≈ 1.5-2.2)
+
+    // Disk-backed mode
+    static constexpr int kDiskCapacitySeconds = 3605;        // 60min max export + 5s
+
+    enum class StorageMode { raw, compressed, diskBacked };
 
     AudioHistoryBuffer() = default;
 
     ~AudioHistoryBuffer()
     {
-        // Wait for any in-flight export thread to finish before destroying buffer
-        if (exportThread.joinable())
-            exportThread.join();
+        const std::lock_guard<std::mutex> lock(configMutex);
+        releaseStorage();
     }
 
     //==========================================================================
-    // Called from prepareToPlay — allocates buffer for current sample rate
+    // Called from prepareToPlay — (re)sizes the ring for the current sample
+    // rate if rewind is enabled, otherwise holds no memory. Hosts re-prepare
+    // often at an unchanged rate: the ring (and the history in it) is then
+    // kept as is, unless an earlier allocation was refused and can be retried
     //==========================================================================
     void prepare(double sampleRate)
     {
-        const int totalSamples = static_cast<int>(sampleRate * kCapacitySeconds);
-        buffer.setSize(2, totalSamples);
-        buffer.clear();
-        capacity = totalSamples;
-        writePos.store(0, std::memory_order_relaxed);
-        totalSamplesWritten.store(0, std::memory_order_relaxed);
+        const std::lock_guard<std::mutex> lock(configMutex);
+        if (sampleRate == cachedSampleRate && (capacity > 0 || ! enabled))
+            return;
+
         cachedSampleRate = sampleRate;
+        allocateStorage();
+    }
+
+    /** Opt in / out of rewind history. Enabling reserves from the shared pool. */
+    void setEnabled(bool shouldBeEnabled)
+    {
+        const std::lock_guard<std::mutex> lock(configMutex);
+        if (enabled == shouldBeEnabled)
+            return;
+
+        enabled = shouldBeEnabled;
+        allocateStorage();
+    }
+
+    bool isEnabled() const noexcept          { return enabled; }
+
+    /** Raw float ring, or staging ring + packed store / mapped file. Drops current history. */
+    void setStorageMode(StorageMode newMode)
+    {
+        const std::lock_guard<std::mutex> lock(configMutex);
+        if (mode == newMode)
+            return;
+
+        // Stop the staging worker and drop the old mode's storage before the
+        // mode changes, so nothing ever pairs the new mode with old storage
+        releaseStorage();
+        mode = newMode;
+        allocateStorage();
+    }
+
+    StorageMode getStorageMode() const noexcept  { return mode; }
+
+    /** Seconds the pool actually granted (may be below the mode's nominal length;
+     *  in compressed mode an estimate at kPackedBytesPerSample). */
+    double getCapacitySeconds() const noexcept
+    {
+        if (cachedSampleRate <= 0.0)
+            return 0.0;
+
+        if (mode == StorageMode::compressed)
+            return static_cast<double>(arenaBytes) / (cachedSampleRate * 2.0 * kPackedBytesPerSample);
+
+        if (mode == StorageMode::diskBacked)
+            return static_cast<double>(diskFrames) / cachedSampleRate;
+
+        return capacity / cachedSampleRate;
     }
 
     //==========================================================================
@@ -55,7 +147,9 @@ public:
     //==========================================================================
     void pushSamples(const float* srcL, const float* srcR, int numSamples)
     {
-        if (capacity <= 0 || srcL == nullptr)
+        // Never waits: while the ring is being swapped, this block is skipped
+        const juce::SpinLock::ScopedTryLockType lock(storageLock);
+        if (! lock.isLocked() || capacity <= 0 || srcL == nullptr)
             return;
 
         const int pos = writePos.load(std::memory_order_relaxed);
@@ -90,6 +184,14 @@ public:
             return 0.0;
 
         const int64_t written = totalSamplesWritten.load(std::memory_order_relaxed);
+
+        if (mode == StorageMode::compressed)
+            return static_cast<double>(juce::jmax<int64_t>(0, written - store.getOldestFrame())) / cachedSampleRate;
+
+        if (mode == StorageMode::diskBacked)
+            return static_cast<double>(juce::jmin(written, diskFrames - static_cast<int64_t>(cachedSampleRate * 5.0)))
+                     / cachedSampleRate;
+
         const int64_t available = juce::jmin(written, static_cast<int64_t>(capacity));
         return static_cast<double>(available) / cachedSampleRate;
     }
@@ -97,19 +199,36 @@ public:
     //==========================================================================
     // Export last N seconds to WAV file (called from message thread)
     //
-    // 1. Snapshots writePos (atomic acquire)
-    // 2. Copies ring buffer segment into linear AudioBuffer (~24MB, takes <50ms)
-    // 3. Launches detached thread to write WAV file (slow I/O off main thread)
+    // 1. Snapshots the write head (atomic acquire)
+    // 2. Launches an export thread that hands ring pointers to the WAV writer
+    //    in 64k-frame chunks (no linear copy of the range)
+    // 3. Before each chunk the guard checks the write head: frames lapped, or
+    //    about to be, become silence; a chunk lapped mid-write is reported
     //
-    // Safe because: copy completes in milliseconds, audio thread's write head
-    // is 5 seconds away from the oldest data we read (65s buffer, 60s max export).
+    // Starts 5 s clear of the write head, and the writer runs far faster than
+    // real time, so in practice the guard never fires. Exports do not wait
+    // for each other. Reallocating the ring (prepare / setStorageMode /
+    // setEnabled) cancels running exports at their next chunk, so it never
+    // waits behind a long export; a cancelled file keeps what was written.
     //==========================================================================
     void exportLastSeconds(int secondsToSave, const juce::File& outputFile)
     {
+        const std::lock_guard<std::mutex> lock(configMutex);
+
         if (capacity <= 0 || cachedSampleRate <= 0.0)
             return;
 
-        const int pos = writePos.load(std::memory_order_acquire);
+        if (mode != StorageMode::raw)
+        {
+            const auto framesToSave = static_cast<juce::int64>(cachedSampleRate * secondsToSave);
+
+            if (mode == StorageMode::compressed)
+                exportCompressed(framesToSave, outputFile);
+            else
+                exportFromDisk(framesToSave, outputFile);
+            return;
+        }
+
         const double sr = cachedSampleRate;
         const int cap = capacity;
 
@@ -129,75 +248,669 @@ public:
         if (samplesToSave <= 0)
             return;
 
-        // Snapshot-copy from ring buffer into linear buffer
-        auto exportBuffer = std::make_shared<juce::AudioBuffer<float>>(2, samplesToSave);
+        const juce::int64 startFrame = written - samplesToSave;
+
+        juce::Logger::outputDebugString("AudioHistoryBuffer: streaming "
+            + juce::String(samplesToSave) + " samples ("
+            + juce::String(samplesToSave / sr, 1) + "s) to "
+            + outputFile.getFullPathName());
 
-        const float* srcL = buffer.getReadPointer(0);
-        const float* srcR = buffer.getReadPointer(1);
-        float* dstL = exportBuffer->getWritePointer(0);
-        float* dstR = exportBuffer->getWritePointer(1);
+        launchExport([this, startFrame, written, outputFile, sr, cap]()
+        {
+            auto writer = createWavWriter(outputFile, sr);
+            if (writer == nullptr)
+                return;
 
-        int readPos = (pos - samplesToSave + cap) % cap;
+            const bool intact = streamRing(*writer, buffer.getReadPointer(0), buffer.getReadPointer(1), cap,
+                                           startFrame, written, static_cast<juce::int64>(sr),
+                                           [this] { return static_cast<juce::int64>(totalSamplesWritten.load(std::memory_order_acquire)); },
+                                           cancelExports);
 
-        // Block copy with wrap-around
-        const int block1 = juce::jmin(samplesToSave, cap - readPos);
-        juce::FloatVectorOperations::copy(dstL, srcL + readPos, block1);
-        juce::FloatVectorOperations::copy(dstR, srcR + readPos, block1);
+            logExportFinished(outputFile, intact);
+        });
+    }
 
-        const int block2 = samplesToSave - block1;
-        if (block2 > 0)
+private:
+    //==========================================================================
+    static std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& outputFile, double sr)
+    {
+        outputFile.getParentDirectory().createDirectory();
+
+        if (outputFile.existsAsFile())
+            outputFile.deleteFile();
+
+        auto stream = outputFile.createOutputStream();
+        if (stream == nullptr)
         {
-            juce::FloatVectorOperations::copy(dstL + block1, srcL, block2);
-            juce::FloatVectorOperations::copy(dstR + block1, srcR, block2);
+            juce::Logger::outputDebugString("AudioHistoryBuffer ERROR: cannot create " + outputFile.getFullPathName());
+            return nullptr;
         }
 
-        juce::Logger::outputDebugString("AudioHistoryBuffer: copying "
-            + juce::String(samplesToSave) + " samples ("
-            + juce::String(samplesToSave / sr, 1) + "s) to "
-            + outputFile.getFullPathName());
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wav.createWriterFor(stream.release(), sr, 2, 24, {}, 0));
 
-        // Write WAV on background thread (I/O-bound, must not block GUI)
-        // Join any previous export thread before launching a new one
-        if (exportThread.joinable())
-            exportThread.join();
+        if (writer == nullptr)
+            juce::Logger::outputDebugString("AudioHistoryBuffer ERROR: WAV writer creation failed");
 
-        exportThread = std::thread([exportBuffer, outputFile, sr]()
+        return writer;
+    }
+
+    //==========================================================================
+    // Staging ring consumers (compressed / disk-backed), one worker thread
+    //==========================================================================
+    class StagingWorker : public juce::Thread
+    {
+    public:
+        explicit StagingWorker(AudioHistoryBuffer& ownerToUse)
+            : Thread("GOODMETER-History"), owner(ownerToUse) {}
+
+        /** Storage mode this run serves; only set while the thread is stopped. */
+        void start(StorageMode modeToServe)
         {
-            outputFile.getParentDirectory().createDirectory();
+            jassert(! isThreadRunning());
+            servedMode = modeToServe;
+            startThread(juce::Thread::Priority::low);
+        }
 
-            if (outputFile.existsAsFile())
-                outputFile.deleteFile();
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                if (servedMode == StorageMode::compressed)
+                    owner.packPending();
+                else
+                    owner.flushPending();
+
+                wait(20);  // one 4096-frame block every 85 ms at 48 kHz
+            }
+        }
+
+    private:
+        AudioHistoryBuffer& owner;
+        StorageMode servedMode = StorageMode::compressed;   // written before startThread()
+    };
+
+    /** Message thread: copy frames still only held by the staging ring. */
+    std::shared_ptr<juce::AudioBuffer<float>> copyStagingRange(juce::int64 firstFrame, int numFrames) const
+    {
+        auto range = std::make_shared<juce::AudioBuffer<float>>(2, juce::jmax(1, numFrames));
+        if (numFrames <= 0)
+            return range;
 
-            auto stream = outputFile.createOutputStream();
-            if (stream == nullptr)
+        const int pos = static_cast<int>(firstFrame % capacity);
+        const int block1 = juce::jmin(numFrames, capacity - pos);
+        const int block2 = numFrames - block1;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            juce::FloatVectorOperations::copy(range->getWritePointer(ch), buffer.getReadPointer(ch) + pos, block1);
+            if (block2 > 0)
+                juce::FloatVectorOperations::copy(range->getWritePointer(ch, block1), buffer.getReadPointer(ch), block2);
+        }
+
+        return range;
+    }
+
+    //==========================================================================
+    // Export threads
+    //==========================================================================
+    struct ExportJob
+    {
+        std::thread thread;
+        std::atomic<bool> finished { false };
+    };
+
+    /** Start an export on its own thread; finished exports are joined here. */
+    template <typename Body>
+    void launchExport(Body&& body)
+    {
+        const std::lock_guard<std::mutex> lock(exportMutex);
+
+        for (auto it = exportJobs.begin(); it != exportJobs.end();)
+        {
+            if ((*it)->finished.load(std::memory_order_acquire))
             {
-                juce::Logger::outputDebugString("AudioHistoryBuffer ERROR: cannot create " + outputFile.getFullPathName());
-                return;
+                (*it)->thread.join();
+                it = exportJobs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        exportJobs.push_back(std::make_unique<ExportJob>());
+        auto* job = exportJobs.back().get();
+        job->thread = std::thread([job, body = std::forward<Body>(body)]()
+        {
+            body();
+            job->finished.store(true, std::memory_order_release);
+        });
+    }
+
+    /** Stop every export at its next chunk and wait for it; nothing reads the
+     *  ring, store or map afterwards. Bounded by one chunk write, not by the
+     *  length of the exports, since this runs under configMutex. */
+    void cancelExportsAndJoin()
+    {
+        const std::lock_guard<std::mutex> lock(exportMutex);
+
+        cancelExports.store(true, std::memory_order_release);
+        for (auto& job : exportJobs)
+            job->thread.join();
+
+        exportJobs.clear();
+        cancelExports.store(false, std::memory_order_release);
+    }
+
+    void logExportFinished(const juce::File& outputFile, bool intact) const
+    {
+        if (cancelExports.load(std::memory_order_acquire))
+            juce::Logger::outputDebugString("AudioHistoryBuffer: export cancelled, history was reallocated — " + outputFile.getFullPathName());
+        else
+            juce::Logger::outputDebugString(intact ? "AudioHistoryBuffer: export complete — " + outputFile.getFullPathName()
+                                                   : "AudioHistoryBuffer: export overtaken by the write head, lost frames written as silence — "
+                                                       + outputFile.getFullPathName());
+    }
+
+    static void writeSilence(juce::AudioFormatWriter& writer, juce::int64 frames)
+    {
+        static const std::array<float, kBlockFrames> silence {};
+        const float* channels[2] = { silence.data(), silence.data() };
+
+        for (; frames > 0; frames -= kBlockFrames)
+            writer.writeFromFloatArrays(channels, 2, static_cast<int>(juce::jmin<juce::int64>(frames, kBlockFrames)));
+    }
+
+    /** Export thread: write [first, end) of a planar ring (ringFrames long, frame f
+     *  at f % ringFrames) straight from its memory. getHead() is the producer's
+     *  frame count; it overwrites frame f once it reaches f + ringFrames.
+     *
+     *  Write-head guard: a chunk is only handed to the writer while it is at least
+     *  marginFrames + one chunk clear of the producer; anything closer is replaced
+     *  by silence of the same length. Returns false if frames were lost that way
+     *  or a chunk was lapped while the writer was reading it. Stops early once
+     *  cancel is set (the ring is about to be torn down). */
+    template <typename HeadFn>
+    static bool streamRing(juce::AudioFormatWriter& writer, const float* ringL, const float* ringR,
+                           juce::int64 ringFrames, juce::int64 first, juce::int64 end,
+                           juce::int64 marginFrames, HeadFn&& getHead, const std::atomic<bool>& cancel)
+    {
+        constexpr juce::int64 chunkFrames = 65536;
+        bool intact = true;
+
+        for (juce::int64 cursor = first; cursor < end;)
+        {
+            if (cancel.load(std::memory_order_acquire))
+                return false;
+
+            const juce::int64 safeFrom = getHead() + chunkFrames + marginFrames - ringFrames;
+            if (cursor < safeFrom)
+            {
+                const auto lost = juce::jmin(safeFrom, end) - cursor;
+                writeSilence(writer, lost);
+                cursor += lost;
+                intact = false;
+                continue;
+            }
+
+            const auto pos = cursor % ringFrames;
+            const int run = static_cast<int>(juce::jmin(end - cursor, ringFrames - pos, chunkFrames));
+            const float* channels[2] = { ringL + pos, ringR + pos };
+            writer.writeFromFloatArrays(channels, 2, run);
+
+            if (getHead() > cursor + ringFrames)
+                intact = false;
+
+            cursor += run;
+        }
+
+        return intact;
+    }
+
+    static void writeStagingTail(juce::AudioFormatWriter& writer, const juce::AudioBuffer<float>& tail,
+                                 int tailFrames, int offset)
+    {
+        if (tailFrames <= offset)
+            return;
+
+        const float* channels[2] = { tail.getReadPointer(0, offset), tail.getReadPointer(1, offset) };
+        writer.writeFromFloatArrays(channels, 2, tailFrames - offset);
+    }
+
+    //==========================================================================
+    // Compressed mode
+    //==========================================================================
+
+    /** Worker thread: encode every finished block of the staging ring. The ring
+     *  is never swapped while this runs (the worker is stopped around swaps). */
+    void packPending()
+    {
+        const int cap = capacity;
+        const juce::int64 written = totalSamplesWritten.load(std::memory_order_acquire);
+
+        // Fell a whole staging ring behind (stalled machine): skip the lost span
+        if (written - packedFrames > cap - kBlockFrames)
+            packedFrames = written - kBlockFrames;
+
+        while (written - packedFrames >= kBlockFrames)
+        {
+            const int pos = static_cast<int>(packedFrames % cap);
+            const int block1 = juce::jmin(kBlockFrames, cap - pos);
+            const int block2 = kBlockFrames - block1;
+
+            juce::FloatVectorOperations::copy(packL.data(), buffer.getReadPointer(0) + pos, block1);
+            juce::FloatVectorOperations::copy(packR.data(), buffer.getReadPointer(1) + pos, block1);
+            if (block2 > 0)
+            {
+                juce::FloatVectorOperations::copy(packL.data() + block1, buffer.getReadPointer(0), block2);
+                juce::FloatVectorOperations::copy(packR.data() + block1, buffer.getReadPointer(1), block2);
+            }
+
+            // Only keep the copy if the audio thread did not lap it meanwhile
+            if (totalSamplesWritten.load(std::memory_order_acquire) - packedFrames <= cap)
+            {
+                const auto size = packCodec->encode(packL.data(), packR.data(), kBlockFrames, encoded.data());
+                store.append(packedFrames, kBlockFrames, encoded.data(), size);
             }
 
-            juce::WavAudioFormat wav;
-            std::unique_ptr<juce::AudioFormatWriter> writer(
-                wav.createWriterFor(stream.release(), sr, 2, 24, {}, 0));
+            packedFrames += kBlockFrames;
+        }
+    }
 
+    void exportCompressed(juce::int64 framesToSave, const juce::File& outputFile)
+    {
+        const double sr = cachedSampleRate;
+        const int cap = capacity;
+        const juce::int64 written = totalSamplesWritten.load(std::memory_order_acquire);
+
+        // Frames not packed yet are still in the staging ring: copy them now,
+        // keeping 1 s clear of the audio thread's write head
+        const juce::int64 tailStart = juce::jmax(store.getEndFrame(),
+                                                 written - (cap - static_cast<int>(sr)));
+        const int tailFrames = static_cast<int>(juce::jmax<juce::int64>(0, written - tailStart));
+
+        const juce::int64 startFrame = juce::jmax(written - framesToSave,
+                                                  juce::jmin(store.getOldestFrame(), tailStart));
+        if (written - startFrame <= 0)
+            return;
+
+        auto tail = copyStagingRange(tailStart, tailFrames);
+
+        juce::Logger::outputDebugString("AudioHistoryBuffer: decoding "
+            + juce::String(static_cast<double>(written - startFrame) / sr, 1) + "s of packed history to "
+            + outputFile.getFullPathName());
+
+        launchExport([this, tail, tailStart, tailFrames, startFrame, outputFile, sr]()
+        {
+            auto writer = createWavWriter(outputFile, sr);
             if (writer == nullptr)
+                return;
+
+            // Decode one block at a time straight into the writer: no linear copy.
+            // The stored 24-bit codes go out as integers (left-justified, as
+            // AudioFormatWriter::write expects), so the file holds exactly what
+            // was packed; a float round trip would move negative codes by one
+            auto decoder = std::make_unique<HistoryBlockCodec>();
+            std::vector<juce::uint8> bytes;
+            std::vector<int> decodedL((size_t) kBlockFrames), decodedR((size_t) kBlockFrames);
+            juce::int64 cursor = startFrame;
+
+            juce::int64 blockFirst = 0;
+            int blockFrames = 0;
+
+            while (cursor < tailStart && ! cancelExports.load(std::memory_order_acquire)
+                   && store.fetchBlockEndingAfter(cursor, bytes, blockFirst, blockFrames)
+                   && blockFirst < tailStart)
+            {
+                // Gaps (evicted while exporting, or a packer overrun) keep their length as silence
+                if (blockFirst > cursor)
+                {
+                    writeSilence(*writer, blockFirst - cursor);
+                    cursor = blockFirst;
+                }
+
+                if (decoder->decodeCodes(bytes.data(), bytes.size(), decodedL.data(), decodedR.data()) != blockFrames)
+                {
+                    std::fill(decodedL.begin(), decodedL.end(), 0);
+                    std::fill(decodedR.begin(), decodedR.end(), 0);
+                }
+
+                const int skip = static_cast<int>(cursor - blockFirst);
+                const int count = static_cast<int>(juce::jmin<juce::int64>(blockFrames - skip, tailStart - cursor));
+                for (int i = skip; i < skip + count; ++i)
+                {
+                    decodedL[(size_t) i] = static_cast<int>(static_cast<juce::uint32>(decodedL[(size_t) i]) << 8);
+                    decodedR[(size_t) i] = static_cast<int>(static_cast<juce::uint32>(decodedR[(size_t) i]) << 8);
+                }
+
+                const int* channels[3] = { decodedL.data() + skip, decodedR.data() + skip, nullptr };
+                writer->write(channels, count);
+                cursor += count;
+            }
+
+            if (cancelExports.load(std::memory_order_acquire))
             {
-                juce::Logger::outputDebugString("AudioHistoryBuffer ERROR: WAV writer creation failed");
+                logExportFinished(outputFile, false);
                 return;
             }
 
-            writer->writeFromAudioSampleBuffer(*exportBuffer, 0, exportBuffer->getNumSamples());
+            if (cursor < tailStart)
+            {
+                writeSilence(*writer, tailStart - cursor);
+                cursor = tailStart;
+            }
 
-            juce::Logger::outputDebugString("AudioHistoryBuffer: export complete — "
-                + juce::String(exportBuffer->getNumSamples() / sr, 1) + "s written to "
-                + outputFile.getFullPathName());
+            writeStagingTail(*writer, *tail, tailFrames, static_cast<int>(cursor - tailStart));
+
+            logExportFinished(outputFile, true);
         });
     }
 
-private:
+    //==========================================================================
+    // Disk-backed mode
+    //==========================================================================
+    float* diskChannel(int ch) const noexcept
+    {
+        return static_cast<float*>(diskMap->getData()) + static_cast<size_t>(ch) * static_cast<size_t>(diskFrames);
+    }
+
+    /** Worker thread: copy everything the audio thread has staged into the mapped ring. */
+    void flushPending()
+    {
+        const int cap = capacity;
+        const juce::int64 written = totalSamplesWritten.load(std::memory_order_acquire);
+        juce::int64 flushed = diskFlushedFrames.load(std::memory_order_relaxed);
+
+        // Stalled for longer than the staging ring: the lost span becomes silence
+        if (written - flushed > cap - kBlockFrames)
+        {
+            const juce::int64 resume = written - kBlockFrames;
+            forEachDiskRun(flushed, resume - flushed, [this](juce::int64 frame, int run)
+            {
+                const auto pos = static_cast<size_t>(frame % diskFrames);
+                juce::FloatVectorOperations::clear(diskChannel(0) + pos, run);
+                juce::FloatVectorOperations::clear(diskChannel(1) + pos, run);
+            });
+            flushed = resume;
+        }
+
+        while (flushed < written)
+        {
+            const int n = static_cast<int>(juce::jmin<juce::int64>(written - flushed, kBlockFrames));
+
+            forEachDiskRun(flushed, n, [this, cap](juce::int64 frame, int run)
+            {
+                const auto dst = static_cast<size_t>(frame % diskFrames);
+                const int src = static_cast<int>(frame % cap);
+                juce::FloatVectorOperations::copy(diskChannel(0) + dst, buffer.getReadPointer(0) + src, run);
+                juce::FloatVectorOperations::copy(diskChannel(1) + dst, buffer.getReadPointer(1) + src, run);
+            });
+
+            flushed += n;
+            // release: export sees the mapped data before the new flushed count
+            diskFlushedFrames.store(flushed, std::memory_order_release);
+        }
+    }
+
+    /** Split [first, first + count) into runs that wrap in neither the staging ring nor the file. */
+    template <typename Callback>
+    void forEachDiskRun(juce::int64 first, juce::int64 count, Callback&& callback) const
+    {
+        for (juce::int64 done = 0; done < count;)
+        {
+            const juce::int64 frame = first + done;
+            const int run = static_cast<int>(juce::jmin(count - done,
+                                                        static_cast<juce::int64>(capacity - frame % capacity),
+                                                        diskFrames - frame % diskFrames));
+            callback(frame, run);
+            done += run;
+        }
+    }
+
+    void exportFromDisk(juce::int64 framesToSave, const juce::File& outputFile)
+    {
+        const double sr = cachedSampleRate;
+        const int cap = capacity;
+        const juce::int64 written = totalSamplesWritten.load(std::memory_order_acquire);
+        const juce::int64 flushed = diskFlushedFrames.load(std::memory_order_acquire);
+
+        // Unflushed frames come from the staging ring (1 s clear of the write head);
+        // the oldest mapped frames stay 5 s clear of the flusher lapping them
+        const juce::int64 tailStart = juce::jmax(flushed, written - (cap - static_cast<int>(sr)));
+        const int tailFrames = static_cast<int>(juce::jmax<juce::int64>(0, written - tailStart));
+        const juce::int64 oldest = juce::jmax<juce::int64>(0, flushed - (diskFrames - static_cast<juce::int64>(sr * 5.0)));
+
+        const juce::int64 startFrame = juce::jmax(written - framesToSave, juce::jmin(oldest, tailStart));
+        if (written - startFrame <= 0)
+            return;
+
+        auto tail = copyStagingRange(tailStart, tailFrames);
+
+        juce::Logger::outputDebugString("AudioHistoryBuffer: writing "
+            + juce::String(static_cast<double>(written - startFrame) / sr, 1) + "s from the mapped history to "
+            + outputFile.getFullPathName());
+
+        launchExport([this, tail, tailStart, tailFrames, startFrame, outputFile, sr]()
+        {
+            auto writer = createWavWriter(outputFile, sr);
+            if (writer == nullptr)
+                return;
+
+            // Zero-copy: the writer reads straight out of the mapped file, guarded
+            // against the flusher lapping it
+            const bool intact = streamRing(*writer, diskChannel(0), diskChannel(1), diskFrames,
+                                           startFrame, tailStart, static_cast<juce::int64>(sr),
+                                           [this] { return diskFlushedFrames.load(std::memory_order_acquire); },
+                                           cancelExports);
+
+            writeStagingTail(*writer, *tail, tailFrames, static_cast<int>(juce::jmax<juce::int64>(0, startFrame - tailStart)));
+
+            logExportFinished(outputFile, intact);
+        });
+    }
+
+    /** Preallocate and map the file ring; false (and nothing mapped) on failure. */
+    bool createDiskRing(juce::int64 frames)
+    {
+        diskFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                       .getNonexistentChildFile("GOODMETER-rewind", ".f32", false);
+        const juce::int64 bytes = frames * 2 * static_cast<juce::int64>(sizeof(float));
+
+        if (! preallocateFile(diskFile, bytes))
+        {
+            juce::Logger::outputDebugString("AudioHistoryBuffer ERROR: cannot preallocate " + diskFile.getFullPathName());
+            diskFile.deleteFile();
+            return false;
+        }
+
+        diskMap = std::make_unique<juce::MemoryMappedFile>(diskFile, juce::MemoryMappedFile::readWrite, true);
+        if (diskMap->getData() == nullptr || diskMap->getSize() < static_cast<size_t>(bytes))
+        {
+            juce::Logger::outputDebugString("AudioHistoryBuffer ERROR: cannot map " + diskFile.getFullPathName());
+            diskMap.reset();
+            diskFile.deleteFile();
+            return false;
+        }
+
+        diskFrames = frames;
+        diskFlushedFrames.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** Create file at bytes long with every block allocated on disk. */
+    static bool preallocateFile(const juce::File& file, juce::int64 bytes)
+    {
+        if (! file.create())
+            return false;
+
+#if JUCE_LINUX
+        const int fd = ::open(file.getFullPathName().toRawUTF8(), O_WRONLY);
+        if (fd < 0)
+            return false;
+
+        const bool ok = ::posix_fallocate(fd, 0, static_cast<off_t>(bytes)) == 0;
+        ::close(fd);
+        return ok;
+#elif JUCE_MAC || JUCE_IOS
+        const int fd = ::open(file.getFullPathName().toRawUTF8(), O_WRONLY);
+        if (fd < 0)
+            return false;
+
+        // All or nothing, contiguous if possible; then grow into the reserved blocks
+        fstore_t store { F_ALLOCATECONTIG | F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(bytes), 0 };
+        bool ok = ::fcntl(fd, F_PREALLOCATE, &store) != -1;
+        if (! ok)
+        {
+            store.fst_flags = F_ALLOCATEALL;
+            ok = ::fcntl(fd, F_PREALLOCATE, &store) != -1;
+        }
+
+        ok = ok && ::ftruncate(fd, static_cast<off_t>(bytes)) == 0;
+        ::close(fd);
+        return ok;
+#else
+        // NTFS allocates (and zeroes) an extended file unless it is marked sparse
+        juce::FileOutputStream stream(file);
+        if (stream.failedToOpen() || ! stream.setPosition(bytes - 1) || ! stream.writeByte(0))
+            return false;
+
+        stream.flush();
+        return stream.getStatus().wasOk();
+#endif
+    }
+
+    //==========================================================================
+    void allocateStorage()
+    {
+        releaseStorage();
+
+        if (! enabled || cachedSampleRate <= 0.0)
+            return;
+
+        constexpr size_t bytesPerFrame = 2 * sizeof(float);
+        const bool compressed = mode == StorageMode::compressed;
+        const bool staged = mode != StorageMode::raw;
+        const int ringSeconds = staged ? kStagingSeconds : kCapacitySeconds;
+        const auto ringFrames = juce::jmax(static_cast<size_t>(cachedSampleRate * ringSeconds), static_cast<size_t>(4 * kBlockFrames));
+        const auto ringBytes = ringFrames * bytesPerFrame;
+
+        // Compressed: staging ring + packed arena; disk: staging ring only (the
+        // mapped file is not RAM budget); raw: one float ring
+        const size_t packedBytesPerSecond = static_cast<size_t>(cachedSampleRate) * 2 * kPackedBytesPerSample;
+        const auto requested = compressed ? ringBytes + packedBytesPerSecond * kCompressedCapacitySeconds : ringBytes;
+        const auto minimum = compressed ? ringBytes + packedBytesPerSecond * kMinimumSeconds
+                           : staged     ? ringBytes
+                                        : static_cast<size_t>(cachedSampleRate * kMinimumSeconds) * bytesPerFrame;
+
+        grantedBytes = SharedHistoryPool::getInstance().acquire(requested, minimum);
+        if (grantedBytes == 0)
+        {
+            juce::Logger::outputDebugString("AudioHistoryBuffer: history budget exhausted, rewind unavailable");
+            return;
+        }
+
+        const int totalSamples = static_cast<int>((staged ? ringBytes : grantedBytes) / bytesPerFrame);
+
+        if (mode == StorageMode::diskBacked
+            && ! createDiskRing(static_cast<juce::int64>(cachedSampleRate * kDiskCapacitySeconds)))
+        {
+            // No room for the file ring: keep the longest window RAM can hold
+            SharedHistoryPool::getInstance().release(grantedBytes);
+            grantedBytes = 0;
+            juce::Logger::outputDebugString("AudioHistoryBuffer: disk ring unavailable, using compressed history");
+            mode = StorageMode::compressed;
+            allocateStorage();
+            return;
+        }
+
+        if (compressed)
+        {
+            arenaBytes = grantedBytes - ringBytes;
+            const int maxBlocks = static_cast<int>(cachedSampleRate * kCompressedCapacitySeconds) / kBlockFrames + 2;
+            store.allocate(arenaBytes, maxBlocks);
+            encoded.assign(HistoryBlockCodec::kMaxEncodedBytes, 0);
+            packL.assign((size_t) kBlockFrames, 0.0f);
+            packR.assign((size_t) kBlockFrames, 0.0f);
+            packCodec = std::make_unique<HistoryBlockCodec>();
+            packedFrames = 0;
+        }
+
+        // Allocate outside the lock; the audio thread only sees the final swap.
+        // Not cleared: every reader stops at totalSamplesWritten, so the pages
+        // are first touched when the audio thread writes them, not here
+        juce::AudioBuffer<float> newBuffer(2, totalSamples);
+        installStorage(newBuffer, totalSamples);
+
+        if (staged)
+            stagingWorker.start(mode);
+    }
+
+    void releaseStorage()
+    {
+        // Nothing may read the ring or the store while they are torn down
+        cancelExportsAndJoin();
+        stagingWorker.stopThread(2000);
+
+        juce::AudioBuffer<float> emptyBuffer;
+        installStorage(emptyBuffer, 0);   // old ring is freed here, outside the lock
+
+        store.release();
+        std::vector<juce::uint8>().swap(encoded);
+        std::vector<float>().swap(packL);
+        std::vector<float>().swap(packR);
+        packCodec.reset();
+        arenaBytes = 0;
+
+        diskMap.reset();
+        if (diskFile != juce::File())
+            diskFile.deleteFile();
+        diskFile = juce::File();
+        diskFrames = 0;
+
+        SharedHistoryPool::getInstance().release(grantedBytes);
+        grantedBytes = 0;
+    }
+
+    void installStorage(juce::AudioBuffer<float>& newBuffer, int newCapacity)
+    {
+        const juce::SpinLock::ScopedLockType lock(storageLock);
+        std::swap(buffer, newBuffer);
+        capacity = newCapacity;
+        writePos.store(0, std::memory_order_relaxed);
+        totalSamplesWritten.store(0, std::memory_order_relaxed);
+    }
+
+    std::mutex configMutex;       // prepareToPlay vs message thread (never the audio thread)
+    juce::SpinLock storageLock;
+    bool enabled = false;
+    std::atomic<StorageMode> mode { StorageMode::raw };   // changed only while the worker is stopped
+    size_t grantedBytes = 0;
+
     juce::AudioBuffer<float> buffer;
     std::atomic<int> writePos { 0 };
     int capacity = 0;
     double cachedSampleRate = 0.0;
     std::atomic<int64_t> totalSamplesWritten { 0 };
-    std::thread exportThread;  // Managed background export thread (joined in destructor)
+
+    std::mutex exportMutex;
+    std::list<std::unique_ptr<ExportJob>> exportJobs;  // cancelled and joined before the ring is reallocated
+    std::atomic<bool> cancelExports { false };
+
+    // Compressed mode (worker thread owns packCodec, packL/R, encoded, packedFrames)
+    CompressedHistoryStore store;
+    size_t arenaBytes = 0;
+    std::unique_ptr<HistoryBlockCodec> packCodec;
+    std::vector<float> packL, packR;
+    std::vector<juce::uint8> encoded;
+    juce::int64 packedFrames = 0;
+
+    // Disk-backed mode (planar L then R floats, diskFrames each)
+    juce::File diskFile;
+    std::unique_ptr<juce::MemoryMappedFile> diskMap;
+    juce::int64 diskFrames = 0;
+    std::atomic<juce::int64> diskFlushedFrames { 0 };
+
+    StagingWorker stagingWorker { *this };
 };
@@ -5,7 +5,7 @@
 
     DialogWindow content for offline audio processing:
       - Import audio files (WAV, AIFF, FLAC, MP3, M4A, OGG)
-      - Three display modes: Waveform (AudioThumbnail) / Holo-PSR (holographic grid)
+      - Three display modes: Waveform (PeakPyramid) / Holo-PSR (holographic grid)
                              / Spectrogram (STFT energy heatmap)
       - Room Tone extraction: VAD → spectral envelope → white noise synthesis
       - Three-track export:
@@ -14,6 +14,8 @@
           3. Synthesized Room Tone (_roomtone.wav) — VAD + spectral synthesis
 
     Performance: Holo-PSR peaks are pre-computed on import (max 512 floats).
+                 The waveform overview comes from the analysis cache when the
+                 file was imported before, else from one parallel pass.
                  Spectrogram image is pre-computed on import.
                  paint() never touches the raw audioData buffer.
   ==============================================================================
@@ -24,7 +26,9 @@
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
 #include "RoomToneExtractor.h"
+#include "AudioFileIngest.h"
 #include "DeepFilterProcessor.h"
+#include "PeakPyramid.h"
 
 //==============================================================================
 class AudioLabContent : public juce::Component, private juce::Timer
@@ -35,8 +39,7 @@ public:
 
     AudioLabContent(const juce::File& exportDir = {},
                     juce::AudioDeviceManager* sharedDevMgr = nullptr)
-        : thumbnail(512, formatManager, thumbCache),
-          exportDirectory(exportDir)
+        : exportDirectory(exportDir)
     {
         formatManager.registerBasicFormats();
 
@@ -421,8 +424,7 @@ private:
     //==========================================================================
     juce::AudioFormatManager formatManager;
     juce::AudioBuffer<float> audioData;
-    juce::AudioThumbnailCache thumbCache { 5 };
-    juce::AudioThumbnail thumbnail;
+    std::shared_ptr<PeakPyramid> peaks = std::make_shared<PeakPyramid>();   // waveform overview
 
     // Pre-computed peaks for Holo-PSR (paint() reads only this small array)
     std::vector<float> holoPsrPeaks;
@@ -468,29 +470,18 @@ private:
     /** Try to find and load DeepFilterNet3 ONNX models */
     void initDeepFilter()
     {
-        // Search for models relative to the executable or project directory
-        auto exe = juce::File::getSpecialLocation(
-            juce::File::currentExecutableFile);
-
-        // Try several paths: app bundle Resources, ThirdParty dev path
-        std::vector<juce::File> searchPaths = {
-            exe.getParentDirectory().getParentDirectory()
-                .getChildFile("Resources/DeepFilterNet3_onnx"),
-            exe.getParentDirectory().getParentDirectory()
-                .getChildFile("Frameworks/DeepFilterNet3_onnx"),
-            juce::File("/Users/MediaStorm/Desktop/GOODMETER/ThirdParty/DeepFilterNet3_onnx")
-        };
-
-        for (const auto& dir : searchPaths)
+        // App bundle Resources/Frameworks, then the ThirdParty dev path
+        const auto dir = DeepFilterProcessor::findModelDirectory();
+        if (dir != juce::File())
         {
-            if (dir.getChildFile("enc.onnx").existsAsFile())
+            DeepFilterProcessor::Options options;
+            options.useCoreML = true;
+            deepFilterReady = deepFilter.initialize(dir, options);
+            if (deepFilterReady)
             {
-                deepFilterReady = deepFilter.initialize(dir);
-                if (deepFilterReady)
-                {
-                    DBG("DeepFilterNet3 loaded from: " << dir.getFullPathName());
-                    return;
-                }
+                DBG("DeepFilterNet3 loaded from: " << dir.getFullPathName()
+                    << (deepFilter.isUsingCoreML() ? " (CoreML)" : " (CPU)"));
+                return;
             }
         }
         DBG("DeepFilterNet3 models not found — denoising disabled");
@@ -511,26 +502,32 @@ private:
                 auto file = fc.getResult();
                 if (file == juce::File{}) return;
 
-                std::unique_ptr<juce::AudioFormatReader> reader(
-                    formatManager.createReaderFor(file));
+                // Memory-mapped for WAV/AIFF, decoded for everything else
+                auto reader = AudioFileIngest::openReader(file, &formatManager);
                 if (!reader) return;
 
+                // Load entire file into memory (offline processing)
+                juce::AudioBuffer<float> loaded;
+                if (!AudioFileIngest::readIntoBuffer(*reader, loaded, 0)) return;
+
+                audioData = std::move(loaded);
                 sourceFile = file;
                 fileSampleRate = reader->sampleRate;
                 fileNumChannels = static_cast<int>(reader->numChannels);
                 fileLengthSamples = reader->lengthInSamples;
 
-                // Load entire file into memory (offline processing)
-                audioData.setSize(fileNumChannels,
-                    static_cast<int>(fileLengthSamples));
-                reader->read(&audioData, 0,
-                    static_cast<int>(fileLengthSamples), 0, true, true);
-
-                // Update thumbnail for Waterfall mode
-                thumbnail.clear();
-                thumbnail.reset(fileNumChannels, fileSampleRate, fileLengthSamples);
-                thumbnail.addBlock(0, audioData, 0,
-                    static_cast<int>(fileLengthSamples));
+                // Waveform overview: the stored pyramid if this exact file was
+                // seen before, else one parallel pass over the loaded audio
+                // (stored in the background so the next open skips it)
+                auto overview = std::make_shared<PeakPyramid>();
+                if (! overview->loadIfKnown(file)
+                    || overview->getNumSamples() != audioData.getNumSamples()
+                    || overview->getNumChannels() != audioData.getNumChannels())
+                {
+                    overview->build(audioData, fileSampleRate);
+                    AnalysisThreadPool::getInstance().submit([overview, file] { overview->storeFor(file); });
+                }
+                peaks = std::move(overview);
 
                 // Pre-compute peaks for Holo-PSR mode (avoids paint() scanning raw data)
                 precomputeHoloPeaks();
@@ -586,7 +583,7 @@ private:
     }
 
     //==========================================================================
-    // Waveform mode — AudioThumbnail waveform on blueprint paper
+    // Waveform mode — peak pyramid waveform on blueprint paper
     //==========================================================================
     void drawWaveformMode(juce::Graphics& g, juce::Rectangle<float> area)
     {
@@ -594,21 +591,21 @@ private:
         g.setColour(juce::Colour(0x30000000));
         g.drawRect(area, 1.0f);
 
-        int numCh = thumbnail.getNumChannels();
+        int numCh = peaks->getNumChannels();
         if (numCh == 0)
         {
             drawPlaceholderText(g, area);
             return;
         }
 
-        double totalLen = thumbnail.getTotalLength();
+        double totalLen = peaks->getLengthSeconds();
         float chHeight = area.getHeight() / static_cast<float>(numCh);
 
         if (isProcessed && selectedChannel < 0)
         {
             // After full process (no solo): all channels in blue
             g.setColour(juce::Colour(scanBlue).withAlpha(0.6f));
-            thumbnail.drawChannels(g, area.toNearestInt(), 0.0, totalLen, 1.0f);
+            peaks->drawChannels(g, area.toNearestInt(), 0.0, totalLen, 1.0f);
         }
         else
         {
@@ -626,7 +623,7 @@ private:
                 else
                     g.setColour(getChannelColour(ch).withAlpha(0.75f));
 
-                thumbnail.drawChannel(g, chArea.toNearestInt(), 0.0, totalLen, ch, 1.0f);
+                peaks->drawChannel(g, chArea.toNearestInt(), 0.0, totalLen, ch, 1.0f);
             }
         }
 
@@ -1094,7 +1091,7 @@ private:
                 }
             }
         }
-        else if (displayMode == DisplayMode::Waveform && thumbnail.getNumChannels() > 0)
+        else if (displayMode == DisplayMode::Waveform && peaks->getNumChannels() > 0)
         {
             // Blue overlay on scanned portion of waveform — clipped to scanArea
             g.saveState();
@@ -1104,14 +1101,14 @@ private:
             {
                 // Only draw blue on the selected channel's strip
                 g.setColour(juce::Colour(scanBlue).withAlpha(0.5f));
-                thumbnail.drawChannel(g, scanArea.toNearestInt(),
-                    0.0, thumbnail.getTotalLength(), selectedChannel, 1.0f);
+                peaks->drawChannel(g, scanArea.toNearestInt(),
+                    0.0, peaks->getLengthSeconds(), selectedChannel, 1.0f);
             }
             else
             {
                 g.setColour(juce::Colour(scanBlue).withAlpha(0.5f));
-                thumbnail.drawChannels(g, area.toNearestInt(),
-                    0.0, thumbnail.getTotalLength(), 1.0f);
+                peaks->drawChannels(g, area.toNearestInt(),
+                    0.0, peaks->getLengthSeconds(), 1.0f);
             }
             g.restoreState();
         }
@@ -1294,23 +1291,14 @@ private:
 
             processingThread = std::thread([this, rtDuration, rtChannels]()
             {
-                // 1. VAD: detect silent segments (10%)
-                auto silentSegs = RoomToneExtractor::detectSilentSegments(
-                    audioData, fileSampleRate);
-                processingProgress.store(0.10f);
-
-                // 2. Spectral envelope from silent segments (15%)
-                auto envelope = RoomToneExtractor::extractSpectralEnvelope(
-                    audioData, silentSegs, fileSampleRate);
+                // 1-2. VAD, spectral envelope and noise floor in one pass (15%)
+                auto analysis = RoomToneExtractor::analyse(audioData, fileSampleRate);
                 processingProgress.store(0.15f);
 
-                // 2b. Measure actual noise floor RMS for calibration
-                float noiseFloorRms = RoomToneExtractor::measureNoiseFloorRms(
-                    audioData, silentSegs);
-
                 // 3. Synthesize Room Tone (20%) — calibrated to real noise floor
                 roomToneData = RoomToneExtractor::synthesizeRoomTone(
-                    envelope, fileSampleRate, rtDuration, rtChannels, noiseFloorRms);
+                    analysis.spectralEnvelope, fileSampleRate, rtDuration, rtChannels,
+                    analysis.noiseFloorRms);
                 processingProgress.store(0.20f);
 
                 // 4. DeepFilterNet3 denoise (20% → 95%)
@@ -1529,7 +1517,7 @@ private:
         holoPsrPeaks.clear();
         spectrogramImage = {};
         spectroMagnitudes.clear();
-        thumbnail.clear();
+        peaks = std::make_shared<PeakPyramid>();
 
         // Reset file info
         sourceFile = juce::File();
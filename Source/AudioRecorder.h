@@ -5,7 +5,11 @@
 
     Architecture:
       - processBlock() on the audio thread pushes samples into a lock-free FIFO
-      - A background Thread drains the FIFO and writes 24-bit WAV via JUCE
+      - A background Thread drains the FIFO and writes 24-bit audio, either
+        RF64/BWF through BroadcastWavWriter (default: preallocated, 1 MB
+        aligned batches, no 4 GB limit) or plain WAV via JUCE
+      - The FIFO is sized at start() from the write throughput and the
+        longest write stall measured on earlier recordings in this process
       - start()/stop() are safe to call from the GUI thread
   ==============================================================================
 */
@@ -13,6 +17,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BroadcastWavWriter.h"
+#include <atomic>
+#include <vector>
 
 #if JUCE_MAC || JUCE_LINUX
  #include <fcntl.h>
@@ -23,10 +30,19 @@
 class AudioRecorder : public juce::Thread
 {
 public:
+    static constexpr int kMaxChannels = 8;
+
+    enum class Format
+    {
+        broadcastWav,   // RF64/BWF with bext timecode (stays plain RIFF below 4 GB)
+        wav             // JUCE WavAudioFormat writer
+    };
+
     AudioRecorder()
         : Thread("GOODMETER-Recorder"),
-          fifo(fifoSize)
+          fifo(minFifoSize)
     {
+        fifoBuffer.resize(static_cast<size_t>(minFifoSize));
     }
 
     ~AudioRecorder() override
@@ -38,36 +54,64 @@ public:
     /** Start recording to a file. Call from GUI thread.
      *  @param file       Target WAV file
      *  @param sampleRate Current audio sample rate
-     *  @param numCh      Number of channels (1 or 2)
+     *  @param numCh      Number of channels (1 to kMaxChannels)
+     *  @param fileFormat RF64/BWF (default) or plain WAV
      */
-    bool start(const juce::File& file, double sampleRate, int numCh)
+    bool start(const juce::File& file, double sampleRate, int numCh, Format fileFormat = Format::broadcastWav)
     {
         if (isRecording.load()) return false;
 
-        numChannels = juce::jlimit(1, 2, numCh);
+        numChannels = juce::jlimit(1, kMaxChannels, numCh);
         currentSampleRate = sampleRate;
+        format = fileFormat;
 
         // Delete existing file
         if (file.existsAsFile())
             file.deleteFile();
 
-        // Create output stream
-        auto fos = file.createOutputStream();
-        if (fos == nullptr) return false;
-
-        // Create WAV writer (24-bit)
-        juce::WavAudioFormat wavFormat;
-        writer.reset(wavFormat.createWriterFor(
-            fos.release(),   // writer takes ownership
-            sampleRate,
-            static_cast<unsigned int>(numChannels),
-            24,              // bits per sample
-            {},              // metadata
-            0));
-
-        if (writer == nullptr) return false;
+        if (format == Format::broadcastWav)
+        {
+            const auto now = juce::Time::getCurrentTime();
+            const double secondsSinceMidnight = now.getHours() * 3600.0 + now.getMinutes() * 60.0
+                                              + now.getSeconds() + now.getMilliseconds() / 1000.0;
+
+            BroadcastWavWriter::Metadata metadata;
+            metadata.description = file.getFileNameWithoutExtension();
+            metadata.originationTime = now;
+            metadata.timeReference = static_cast<juce::uint64>(secondsSinceMidnight * sampleRate);
+            metadata.codingHistory = "A=PCM,F=" + juce::String(juce::roundToInt(sampleRate))
+                                   + ",W=24,M=" + (numChannels == 1 ? "mono" : numChannels == 2 ? "stereo" : "multichannel")
+                                   + ",T=GOODMETER\r\n";
+
+            if (! bwfWriter.open(file, sampleRate, numChannels, metadata))
+                return false;
+        }
+        else
+        {
+            // Create output stream
+            auto fos = file.createOutputStream();
+            if (fos == nullptr) return false;
+
+            // Create WAV writer (24-bit)
+            juce::WavAudioFormat wavFormat;
+            writer.reset(wavFormat.createWriterFor(
+                fos.release(),   // writer takes ownership
+                sampleRate,
+                static_cast<unsigned int>(numChannels),
+                24,              // bits per sample
+                {},              // metadata
+                0));
+
+            if (writer == nullptr) return false;
+        }
 
-        // Reset FIFO
+        // Size and reset the FIFO (the writer thread is not running yet)
+        const int newFifoSize = chooseFifoSize(sampleRate, numChannels);
+        if (newFifoSize != fifo.getTotalSize())
+        {
+            fifoBuffer.assign(static_cast<size_t>(newFifoSize), 0.0f);
+            fifo.setTotalSize(newFifoSize);
+        }
         fifo.reset();
         fifoOverrun = false;
 
@@ -92,6 +136,7 @@ public:
                 writer->flush();
                 writer.reset();
             }
+            bwfWriter.close();
             return;
         }
 
@@ -111,6 +156,9 @@ public:
             writer.reset();    // Close file handle (writes final WAV header chunk sizes)
         }
 
+        // Writes the last partial batch and the final RIFF / RF64 sizes
+        bwfWriter.close();
+
         // Force OS-level metadata sync so Finder indexes the file immediately.
         // Without this, macOS can delay file appearance by up to 2 minutes.
         if (recordingFile.existsAsFile())
@@ -144,19 +192,26 @@ public:
     /** Check if FIFO overran (audio came faster than disk could write) */
     bool didOverrun() const { return fifoOverrun; }
 
+    /** Seconds of audio the FIFO holds for the current / last recording */
+    double getFifoSeconds() const
+    {
+        return fifo.getTotalSize() / (currentSampleRate * numChannels);
+    }
+
     //==========================================================================
     /** Called from audio thread's processBlock.
-     *  Copies interleaved L/R samples into the FIFO.
+     *  Copies the first numChannels channels, interleaved, into the FIFO.
      *  Lock-free — safe for real-time use.
+     *  @returns frames that did not fit (FIFO overrun), 0 normally
      */
-    void pushSamples(const float* const* channelData, int numSamples)
+    int pushSamples(const float* const* channelData, int numSamples)
     {
-        if (!isRecording.load(std::memory_order_relaxed)) return;
-        if (numSamples <= 0) return;
+        if (!isRecording.load(std::memory_order_relaxed)) return 0;
+        if (numSamples <= 0) return 0;
 
         // Interleave into temp buffer then push to FIFO
         int totalFloats = numSamples * numChannels;
-        if (totalFloats > tempBufferSize) totalFloats = tempBufferSize;
+        if (totalFloats > tempBufferSize) totalFloats = tempBufferSize / numChannels * numChannels;
         int clampedSamples = totalFloats / numChannels;
 
         // Interleave
@@ -168,22 +223,29 @@ public:
                 tempBuffer[i * 2 + 1] = channelData[1][i];
             }
         }
-        else
+        else if (numChannels == 1)
         {
             for (int i = 0; i < clampedSamples; ++i)
                 tempBuffer[i] = channelData[0][i];
         }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < clampedSamples; ++i)
+                    tempBuffer[i * numChannels + ch] = channelData[ch][i];
+        }
 
-        // Push to FIFO (lock-free)
-        int start1, size1, start2, size2;
-        fifo.prepareToWrite(totalFloats, start1, size1, start2, size2);
-
-        if (size1 + size2 < totalFloats)
+        // Push to FIFO (lock-free); whole frames only, so channels never shift
+        const int writable = fifo.getFreeSpace() / numChannels * numChannels;
+        if (writable < totalFloats)
         {
             fifoOverrun = true;
             // Write what we can
         }
 
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(juce::jmin(totalFloats, writable), start1, size1, start2, size2);
+
         if (size1 > 0)
             std::memcpy(fifoBuffer.data() + start1, tempBuffer.data(),
                         static_cast<size_t>(size1) * sizeof(float));
@@ -192,6 +254,13 @@ public:
                         static_cast<size_t>(size2) * sizeof(float));
 
         fifo.finishedWrite(size1 + size2);
+        return numSamples - (size1 + size2) / numChannels;
+    }
+
+    /** FIFO fill level, 0..1 (audio thread or GUI) */
+    float getFifoFill() const
+    {
+        return static_cast<float>(fifo.getNumReady()) / static_cast<float>(fifo.getTotalSize());
     }
 
 private:
@@ -220,17 +289,34 @@ private:
     /** Drain available samples from FIFO and write to WAV */
     void drainFifo()
     {
-        if (writer == nullptr) return;
+        if (writer == nullptr && ! bwfWriter.isOpen()) return;
+
+        // Whole frames only, so a partially pushed frame never splits across drains
+        const int ready = fifo.getNumReady() / numChannels * numChannels;
+        if (ready <= 0) return;
 
         int start1, size1, start2, size2;
-        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+        fifo.prepareToRead(ready, start1, size1, start2, size2);
+
+        const double startMs = juce::Time::getMillisecondCounterHiRes();
 
         if (size1 > 0)
-            writeInterleavedToWav(fifoBuffer.data() + start1, size1);
+            writeInterleaved(fifoBuffer.data() + start1, size1);
         if (size2 > 0)
-            writeInterleavedToWav(fifoBuffer.data() + start2, size2);
+            writeInterleaved(fifoBuffer.data() + start2, size2);
 
         fifo.finishedRead(size1 + size2);
+
+        recordWriteTiming(static_cast<double>(size1 + size2) * 3.0,
+                          (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0);
+    }
+
+    void writeInterleaved(const float* interleaved, int numFloats)
+    {
+        if (format == Format::broadcastWav)
+            bwfWriter.write(interleaved, numFloats / numChannels);
+        else
+            writeInterleavedToWav(interleaved, numFloats);
     }
 
     /** Write interleaved float samples to WAV via AudioFormatWriter */
@@ -252,30 +338,95 @@ private:
                 outR[i] = interleaved[i * 2 + 1];
             }
         }
-        else
+        else if (numChannels == 1)
         {
             auto* out = writeBuffer.getWritePointer(0);
             std::memcpy(out, interleaved, static_cast<size_t>(numSamples) * sizeof(float));
         }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* out = writeBuffer.getWritePointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = interleaved[i * numChannels + ch];
+            }
+        }
 
         writer->writeFromAudioSampleBuffer(writeBuffer, 0, numSamples);
     }
 
+    //==========================================================================
+    // FIFO sizing from measured disk behaviour
+    //==========================================================================
+    struct DiskStats
+    {
+        std::atomic<double> bytesPerSecond { 0.0 };     // smoothed, over drains with real I/O
+        std::atomic<double> worstStallSeconds { 0.0 };  // longest single drain
+    };
+
+    /** Shared by every recorder in the process, so later takes start sized right. */
+    static DiskStats& getDiskStats()
+    {
+        static DiskStats stats;
+        return stats;
+    }
+
+    /** Writer thread: fold one drain (bytes of 24-bit output, seconds taken) into the stats. */
+    static void recordWriteTiming(double bytes, double seconds)
+    {
+        auto& stats = getDiskStats();
+
+        if (seconds > stats.worstStallSeconds.load(std::memory_order_relaxed))
+            stats.worstStallSeconds.store(seconds, std::memory_order_relaxed);
+
+        // Drains under 1 ms only touched memory (batch not full yet): not a throughput sample
+        if (seconds < 0.001)
+            return;
+
+        const double rate = bytes / seconds;
+        const double previous = stats.bytesPerSecond.load(std::memory_order_relaxed);
+        stats.bytesPerSecond.store(previous > 0.0 ? previous * 0.9 + rate * 0.1 : rate, std::memory_order_relaxed);
+    }
+
+    /** FIFO floats covering the worst stall seen so far twice over (never below
+     *  the old fixed size), maxed out if the disk barely keeps up. */
+    static int chooseFifoSize(double sampleRate, int channels)
+    {
+        const auto& stats = getDiskStats();
+        const double outputBytesPerSecond = sampleRate * channels * 3.0;
+        const double throughput = stats.bytesPerSecond.load(std::memory_order_relaxed);
+
+        double seconds = juce::jmax(minFifoSeconds, stats.worstStallSeconds.load(std::memory_order_relaxed) * 2.0 + 0.5);
+        if (throughput > 0.0 && throughput < outputBytesPerSecond * 2.0)
+            seconds = maxFifoSeconds;
+
+        const double floats = juce::jlimit(static_cast<double>(minFifoSize), static_cast<double>(maxFifoFloats),
+                                           juce::jmin(seconds, maxFifoSeconds) * sampleRate * channels);
+
+        // A multiple of the frame size, so reads split at the wrap on a frame boundary
+        return static_cast<int>(floats) / channels * channels;
+    }
+
     //==========================================================================
     std::atomic<bool> isRecording { false };
     int numChannels = 2;
+    Format format = Format::broadcastWav;
     double currentSampleRate = 48000.0;
     juce::File recordingFile;
     juce::File lastRecordedFile;
     bool fifoOverrun = false;
 
-    // FIFO: ~2 seconds at 48kHz stereo
-    static constexpr int fifoSize = 262144;
+    // FIFO: sized per recording, never below ~2 seconds at 48kHz stereo, at most 256 MB
+    static constexpr int minFifoSize = 262144;
+    static constexpr int maxFifoFloats = 64 * 1024 * 1024;
+    static constexpr double minFifoSeconds = 2.0;
+    static constexpr double maxFifoSeconds = 30.0;
     juce::AbstractFifo fifo;
-    std::array<float, fifoSize> fifoBuffer = {};
+    std::vector<float> fifoBuffer;
 
-    // Temp interleave buffer (audio thread side, max 4096 stereo samples)
-    static constexpr int tempBufferSize = 8192;
+    // Temp interleave buffer (audio thread side, max 4096 frames of kMaxChannels)
+    static constexpr int tempBufferSize = 4096 * kMaxChannels;
     std::array<float, tempBufferSize> tempBuffer = {};
 
     // Write buffer (writer thread side)
@@ -283,6 +434,7 @@ private:
 
     // WAV writer
     std::unique_ptr<juce::AudioFormatWriter> writer;
+    BroadcastWavWriter bwfWriter;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioRecorder)
 };
@@ -15,23 +15,24 @@
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
+#include "FrameScheduler.h"
 
 //==============================================================================
 class Band3Component : public juce::Component,
-                       public juce::Timer
+                       public FrameScheduler::Client
 {
 public:
     //==========================================================================
     Band3Component(GOODMETERAudioProcessor& processor)
-        : audioProcessor(processor)
+        : FrameScheduler::Client(this), audioProcessor(processor)
     {
         setSize(100, 280);
-        startTimerHz(60);
+        startFrames();
     }
 
     ~Band3Component() override
     {
-        stopTimer();
+        stopFrames();
     }
 
     void setMarathonDarkStyle(bool shouldUse)
@@ -59,6 +60,7 @@ public:
 private:
     //==========================================================================
     GOODMETERAudioProcessor& audioProcessor;
+    AnalysisDemand::Subscription bandDemand { audioProcessor.analysisDemand, AnalysisDemand::Analysis::bands };
 
     float currentLow = -90.0f;
     float currentMid = -90.0f;
@@ -79,7 +81,12 @@ private:
     bool marathonDarkStyle = false;
 
     //==========================================================================
-    void timerCallback() override
+    void onScreenChanged(bool isNowOnScreen) override
+    {
+        bandDemand.setActive(isNowOnScreen);
+    }
+
+    void frameTick() override
     {
         // 60Hz → 30Hz smart throttle during mouse drag
         if (juce::ModifierKeys::currentModifiers.isAnyMouseButtonDown())
@@ -88,9 +95,10 @@ private:
             if (++dragThrottleCounter % 2 != 0) return;
         }
 
-        currentLow = audioProcessor.rmsLevelLow.load(std::memory_order_relaxed);
-        currentMid = audioProcessor.rmsLevelMid3Band.load(std::memory_order_relaxed);
-        currentHigh = audioProcessor.rmsLevelHigh.load(std::memory_order_relaxed);
+        const auto& snapshot = audioProcessor.getMeterSnapshot();
+        currentLow = snapshot.rmsLow;
+        currentMid = snapshot.rmsMid3Band;
+        currentHigh = snapshot.rmsHigh;
 
         float targetLow = juce::jlimit(0.0f, 1.0f, juce::jmap(currentLow, minDb, maxDb, 0.0f, 1.0f));
         float targetMid = juce::jlimit(0.0f, 1.0f, juce::jmap(currentMid, minDb, maxDb, 0.0f, 1.0f));
@@ -112,7 +120,7 @@ private:
         if (displayMid < 0.005f) displayMid = 0.0f;
         if (displayHigh < 0.005f) displayHigh = 0.0f;
 
-        repaint();
+        repaintFrame();
     }
 
     //==========================================================================
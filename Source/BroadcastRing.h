@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+    BroadcastRing.h
+    GOODMETER - Single-producer / multi-consumer frame broadcast
+
+    One producer publishes each frame exactly once; any number of readers
+    (spectrum, spectrogram, iOS pages, future remote clients) follow it with
+    their own cursor. The producer never waits for readers: a slow reader is
+    lapped and finds out through its lost-frame count instead of stalling
+    everyone else.
+
+    Each slot carries a seqlock sequence number:
+      - odd  while the producer is writing frame n   (2n + 1)
+      - even once frame n is complete                (2n + 2)
+    A reader copies the slot and accepts it only if the sequence was the
+    expected even value both before and after the copy.
+
+    Readers register by constructing a Reader, so the producer can skip work
+    nobody is listening to (hasReaders()). The slots themselves are only
+    allocated when the first Reader registers: a plugin instance whose
+    editor never opens holds no frame memory at all. They then stay until
+    the ring is destroyed, so the producer never sees them go away.
+
+    Thread safety model:
+      - Producer: one thread (beginWrite/endWrite, only while hasReaders())
+      - Readers:  any threads, one Reader object per consumer
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+//==============================================================================
+template <typename T, size_t NumSlots, size_t SlotSize>
+class BroadcastRing
+{
+public:
+    static constexpr size_t numSlots = NumSlots;
+    static constexpr size_t slotSize = SlotSize;
+
+    BroadcastRing() = default;
+
+    ~BroadcastRing()
+    {
+        delete[] slots.load(std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    /** Per-consumer cursor. Construct one per reading component. */
+    class Reader
+    {
+    public:
+        explicit Reader(BroadcastRing& ringToFollow) noexcept
+            : ring(ringToFollow),
+              cursor(ringToFollow.published.load(std::memory_order_acquire))
+        {
+            ring.allocateSlots();
+            // release: a producer that sees the reader also sees the slots
+            ring.numReaders.fetch_add(1, std::memory_order_release);
+        }
+
+        ~Reader()
+        {
+            ring.numReaders.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /** Copy the next unread frame into dest. False when caught up. */
+        bool readNext(T* dest) noexcept
+        {
+            for (;;)
+            {
+                const auto head = ring.published.load(std::memory_order_acquire);
+                if (cursor >= head)
+                    return false;
+
+                // Lapped: jump to the oldest frame that can still be intact
+                if (head - cursor >= NumSlots)
+                {
+                    const auto oldest = head - (NumSlots - 1);
+                    lostFrames += oldest - cursor;
+                    cursor = oldest;
+                }
+
+                if (ring.tryCopy(cursor, dest))
+                {
+                    ++cursor;
+                    return true;
+                }
+
+                // Overwritten mid-copy: count it and try the next one
+                ++lostFrames;
+                ++cursor;
+            }
+        }
+
+        /** Copy the newest frame into dest, skipping anything older. False when caught up. */
+        bool readLatest(T* dest) noexcept
+        {
+            for (;;)
+            {
+                const auto head = ring.published.load(std::memory_order_acquire);
+                if (cursor >= head)
+                    return false;
+
+                const auto newest = head - 1;
+                if (ring.tryCopy(newest, dest))
+                {
+                    cursor = head;
+                    return true;
+                }
+
+                // A newer frame replaced it while copying — loop and take that one
+                cursor = newest;
+            }
+        }
+
+        /** Frames that were overwritten before this reader got to them */
+        juce::uint64 getLostFrames() const noexcept     { return lostFrames; }
+
+    private:
+        BroadcastRing& ring;
+        juce::uint64 cursor = 0;
+        juce::uint64 lostFrames = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(Reader)
+    };
+
+    //==========================================================================
+    // Producer side (single thread)
+    //==========================================================================
+
+    /** Slot for the next frame, filled in place. Call only after hasReaders()
+        returned true (the slots exist from the first reader on). */
+    T* beginWrite() noexcept
+    {
+        const auto frame = published.load(std::memory_order_relaxed);
+        auto* storage = slots.load(std::memory_order_acquire);
+        jassert(storage != nullptr);
+        auto& slot = storage[frame % NumSlots];
+
+        slot.sequence.store(frame * 2 + 1, std::memory_order_relaxed);
+        // Release fence: readers that see the data also see the odd sequence
+        std::atomic_thread_fence(std::memory_order_release);
+        return slot.data.data();
+    }
+
+    /** Publish the frame started by beginWrite(). */
+    void endWrite() noexcept
+    {
+        const auto frame = published.load(std::memory_order_relaxed);
+        slots.load(std::memory_order_relaxed)[frame % NumSlots].sequence.store(frame * 2 + 2, std::memory_order_release);
+        published.store(frame + 1, std::memory_order_release);
+    }
+
+    bool hasReaders() const noexcept        { return numReaders.load(std::memory_order_acquire) > 0; }
+    juce::uint64 getNumPublished() const noexcept { return published.load(std::memory_order_acquire); }
+
+private:
+    //==========================================================================
+    bool tryCopy(juce::uint64 frame, T* dest) const noexcept
+    {
+        const auto& slot = slots.load(std::memory_order_acquire)[frame % NumSlots];
+        const auto expected = frame * 2 + 2;
+
+        if (slot.sequence.load(std::memory_order_acquire) != expected)
+            return false;
+
+        std::memcpy(dest, slot.data.data(), sizeof(T) * SlotSize);
+
+        // Acquire fence: the copy completes before the sequence is re-checked
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == expected;
+    }
+
+    struct Slot
+    {
+        std::atomic<juce::uint64> sequence { 0 };
+        std::array<T, SlotSize> data {};
+    };
+
+    static_assert(NumSlots >= 2, "Readers need at least one slot the producer is not writing");
+
+    /** First reader: allocate the zeroed slots (a racing second reader's copy is discarded). */
+    void allocateSlots()
+    {
+        if (slots.load(std::memory_order_acquire) != nullptr)
+            return;
+
+        auto fresh = std::make_unique<Slot[]>(NumSlots);
+        Slot* expected = nullptr;
+        if (slots.compare_exchange_strong(expected, fresh.get(), std::memory_order_acq_rel))
+            fresh.release();
+    }
+
+    std::atomic<Slot*> slots { nullptr };
+    std::atomic<juce::uint64> published { 0 };
+    std::atomic<int> numReaders { 0 };
+};
@@ -0,0 +1,353 @@
+/*
+  ==============================================================================
+    BroadcastWavWriter.h
+    GOODMETER - RF64 / Broadcast Wave streaming writer
+
+    Writes 24-bit PCM for multi-hour, multichannel recordings:
+      - EBU Tech 3306 layout: the file starts as plain RIFF/WAVE with a JUNK
+        chunk reserved for ds64, and is only promoted to RF64 on close if it
+        grew past 4 GB, so short takes stay readable everywhere
+      - bext chunk (EBU Tech 3285 v1) with origination date/time and the
+        TimeReference timecode (samples since midnight)
+      - Sample data starts on a 4 KB boundary and reaches the OS in 1 MB
+        batches, so every write is large and aligned
+      - File space is reserved 256 MB ahead of the write position
+        (fallocate / F_PREALLOCATE, without changing the file size), so the
+        filesystem never has to find blocks mid-take
+
+    All metadata is written by open() and patched by close(); write() only
+    converts samples and issues batch writes.
+
+    Thread safety model:
+      - open()/close(): one thread while no write() is running
+      - write(): the recorder's writer thread
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+#include <vector>
+
+#if JUCE_MAC || JUCE_LINUX
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+class BroadcastWavWriter
+{
+public:
+    static constexpr int kBitsPerSample = 24;
+    static constexpr int kBytesPerSample = kBitsPerSample / 8;
+    static constexpr size_t kBatchBytes = size_t (1) << 20;               // one write() to the OS
+    static constexpr juce::int64 kDataAlignment = 4096;                   // data chunk payload offset
+    static constexpr juce::int64 kPreallocateBytes = juce::int64 (256) << 20;
+
+    /** Full scale of a 24-bit sample, as JUCE's own PCM writers use it: ±1.0
+        maps to ±8388607, so the code -8388608 is never produced. */
+    static constexpr double kPcm24Scale = 8388607.0;
+
+    /** Float sample → 24-bit code. Shared with HistoryBlockCodec so a sample
+        that went through the compressed rewind store exports bit-exactly:
+        both directions work in double, so fromPcm24(q) · scale lands less
+        than half a code from q and toPcm24(fromPcm24(q)) == q for every
+        24-bit q. */
+    static int toPcm24(float sample) noexcept
+    {
+        return juce::roundToInt(static_cast<double>(juce::jlimit(-1.0f, 1.0f, sample)) * kPcm24Scale);
+    }
+
+    static float fromPcm24(int code) noexcept   { return static_cast<float>(code / kPcm24Scale); }
+
+    struct Metadata
+    {
+        juce::String description;
+        juce::String originator = "GOODMETER";
+        juce::String originatorReference;
+        juce::Time originationTime;
+        juce::uint64 timeReference = 0;     // samples since midnight at the first frame
+        juce::String codingHistory;
+    };
+
+    BroadcastWavWriter() = default;
+
+    ~BroadcastWavWriter()
+    {
+        close();
+    }
+
+    //==========================================================================
+    /** Create the file and write every header chunk. False if it cannot be created. */
+    bool open(const juce::File& file, double sampleRate, int numChannelsToUse, const Metadata& metadata)
+    {
+        close();
+
+        numChannels = numChannelsToUse;
+        bytesPerFrame = numChannels * kBytesPerSample;
+
+        stream = std::make_unique<juce::FileOutputStream>(file);
+        if (stream->failedToOpen())
+        {
+            stream.reset();
+            return false;
+        }
+
+        const auto header = buildHeader(sampleRate, metadata);
+        if (! stream->write(header.data(), header.size()))
+        {
+            stream.reset();
+            return false;
+        }
+
+        dataStart = static_cast<juce::int64>(header.size());
+        dataBytes = 0;
+        failed = false;
+        batch.assign(kBatchBytes + kBytesPerSample, 0);
+        batchUsed = 0;
+
+#if JUCE_MAC || JUCE_LINUX
+        preallocateFd = ::open(file.getFullPathName().toRawUTF8(), O_WRONLY);
+#endif
+        reservedBytes = 0;
+        reserveAhead();
+        return true;
+    }
+
+    /** Writer thread: append interleaved float frames. False once an I/O error occurred. */
+    bool write(const float* interleaved, int numFrames)
+    {
+        if (stream == nullptr || failed)
+            return false;
+
+        const int numSamples = numFrames * numChannels;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int value = toPcm24(interleaved[i]);
+
+            batch[batchUsed++] = static_cast<char>(value & 0xff);
+            batch[batchUsed++] = static_cast<char>((value >> 8) & 0xff);
+            batch[batchUsed++] = static_cast<char>((value >> 16) & 0xff);
+
+            // kBatchBytes is not a multiple of 3: the bytes of a straddling
+            // sample carry over, so every batch write stays exactly kBatchBytes
+            if (batchUsed >= kBatchBytes)
+            {
+                flushBatch(kBatchBytes);
+                std::memmove(batch.data(), batch.data() + kBatchBytes, batchUsed - kBatchBytes);
+                batchUsed -= kBatchBytes;
+            }
+        }
+
+        return ! failed;
+    }
+
+    /** Write the partial batch, then patch the chunk sizes (RF64 if past 4 GB). */
+    bool close()
+    {
+        if (stream == nullptr)
+            return false;
+
+        flushBatch(batchUsed);
+        batchUsed = 0;
+
+        if ((dataBytes & 1) != 0)
+            stream->writeByte(0);            // RIFF chunks are word aligned
+
+        const bool ok = ! failed && patchSizes();
+
+        stream->flush();
+        stream.reset();
+
+#if JUCE_MAC || JUCE_LINUX
+        if (preallocateFd >= 0)
+        {
+            // Space reserved past the end is returned by truncating to the real size
+            ::ftruncate(preallocateFd, static_cast<off_t>(dataStart + dataBytes + (dataBytes & 1)));
+            ::close(preallocateFd);
+            preallocateFd = -1;
+        }
+#endif
+
+        batch.clear();
+        batch.shrink_to_fit();
+        return ok;
+    }
+
+    bool isOpen() const noexcept                 { return stream != nullptr; }
+    bool hasFailed() const noexcept              { return failed; }
+    juce::int64 getFramesWritten() const noexcept
+    {
+        return bytesPerFrame > 0 ? (dataBytes + static_cast<juce::int64>(batchUsed)) / bytesPerFrame : 0;
+    }
+
+private:
+    //==========================================================================
+    void flushBatch(size_t numBytes)
+    {
+        if (numBytes == 0 || failed)
+            return;
+
+        if (dataStart + dataBytes + static_cast<juce::int64>(numBytes) > reservedBytes)
+            reserveAhead();
+
+        if (! stream->write(batch.data(), numBytes))
+            failed = true;
+
+        dataBytes += static_cast<juce::int64>(numBytes);
+    }
+
+    /** Reserve the next kPreallocateBytes of disk space without changing the file size. */
+    void reserveAhead()
+    {
+        const juce::int64 from = dataStart + dataBytes;
+
+#if JUCE_LINUX
+        if (preallocateFd >= 0)
+            ::fallocate(preallocateFd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(from), static_cast<off_t>(kPreallocateBytes));
+#elif JUCE_MAC
+        if (preallocateFd >= 0)
+        {
+            // Bytes are counted from the current physical end of file
+            fstore_t store { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, static_cast<off_t>(kPreallocateBytes), 0 };
+            if (::fcntl(preallocateFd, F_PREALLOCATE, &store) == -1)
+            {
+                store.fst_flags = F_ALLOCATEALL;
+                ::fcntl(preallocateFd, F_PREALLOCATE, &store);
+            }
+        }
+#endif
+
+        // Unsupported filesystems simply allocate on write, as plain WAV did
+        reservedBytes = from + kPreallocateBytes;
+    }
+
+    //==========================================================================
+    std::vector<char> buildHeader(double sampleRate, const Metadata& metadata) const
+    {
+        std::vector<char> h;
+
+        auto put16 = [&h](juce::uint32 v) { h.push_back(char(v & 0xff)); h.push_back(char((v >> 8) & 0xff)); };
+        auto put32 = [&put16](juce::uint32 v) { put16(v & 0xffff); put16(v >> 16); };
+        auto putId = [&h](const char* id) { h.insert(h.end(), id, id + 4); };
+        auto putText = [&h](const juce::String& text, size_t width)
+        {
+            const auto utf8 = text.toStdString();
+            for (size_t i = 0; i < width; ++i)
+                h.push_back(i < utf8.size() ? utf8[i] : '\0');
+        };
+
+        putId("RIFF"); put32(0); putId("WAVE");
+
+        // ds64 placeholder: becomes the ds64 chunk if the take passes 4 GB
+        putId("JUNK"); put32(kDs64Size);
+        h.insert(h.end(), kDs64Size, '\0');
+
+        // fmt: WAVE_FORMAT_EXTENSIBLE above stereo so readers get a channel mask
+        const bool extensible = numChannels > 2;
+        putId("fmt "); put32(extensible ? 40 : 16);
+        put16(extensible ? 0xfffe : 0x0001);
+        put16(static_cast<juce::uint32>(numChannels));
+        put32(static_cast<juce::uint32>(juce::roundToInt(sampleRate)));
+        put32(static_cast<juce::uint32>(juce::roundToInt(sampleRate) * bytesPerFrame));
+        put16(static_cast<juce::uint32>(bytesPerFrame));
+        put16(kBitsPerSample);
+
+        if (extensible)
+        {
+            put16(22);                                   // extension size
+            put16(kBitsPerSample);                       // valid bits
+            put32(numChannels >= 32 ? 0xffffffffu : (1u << numChannels) - 1u);
+            put32(0x00000001); put16(0x0000); put16(0x0010);   // KSDATAFORMAT_SUBTYPE_PCM
+            const char guidTail[] = { '\x80', '\x00', '\x00', '\xaa', '\x00', '\x38', '\x9b', '\x71' };
+            h.insert(h.end(), guidTail, guidTail + 8);
+        }
+
+        // bext v1 (602 bytes + coding history)
+        const auto history = metadata.codingHistory.toStdString();
+        const auto bextSize = static_cast<juce::uint32>(602 + history.size() + (history.size() & 1));
+        const auto& t = metadata.originationTime;
+
+        putId("bext"); put32(bextSize);
+        putText(metadata.description, 256);
+        putText(metadata.originator, 32);
+        putText(metadata.originatorReference, 32);
+        putText(t.formatted("%Y-%m-%d"), 10);
+        putText(t.formatted("%H:%M:%S"), 8);
+        put32(static_cast<juce::uint32>(metadata.timeReference & 0xffffffffu));
+        put32(static_cast<juce::uint32>(metadata.timeReference >> 32));
+        put16(1);                                        // version
+        h.insert(h.end(), 64 + 10 + 180, '\0');          // UMID, loudness (v2 only), reserved
+        h.insert(h.end(), history.begin(), history.end());
+        if ((history.size() & 1) != 0)
+            h.push_back('\0');
+
+        // Pad with JUNK so the sample data starts on an aligned offset
+        const auto afterPad = [&h](juce::int64 padBytes) { return static_cast<juce::int64>(h.size()) + 8 + padBytes + 8; };
+        juce::int64 pad = 0;
+        while (afterPad(pad) % kDataAlignment != 0)
+            pad += 2;
+        putId("JUNK"); put32(static_cast<juce::uint32>(pad));
+        h.insert(h.end(), static_cast<size_t>(pad), '\0');
+
+        putId("data"); put32(0);
+        return h;
+    }
+
+    /** Rewrite the RIFF/data sizes, or the RF64 marker and ds64 chunk past 4 GB. */
+    bool patchSizes()
+    {
+        const juce::int64 fileBytes = dataStart + dataBytes + (dataBytes & 1);
+        const juce::int64 riffBytes = fileBytes - 8;
+        const bool rf64 = riffBytes > 0xffffffffLL;
+        const juce::int64 frames = getFramesWritten();
+
+        auto put32 = [this](juce::uint32 v) { return stream->writeInt(static_cast<int>(v)); };
+        auto put64 = [&put32](juce::int64 v)
+        {
+            return put32(static_cast<juce::uint32>(v & 0xffffffff)) && put32(static_cast<juce::uint32>(v >> 32));
+        };
+
+        bool ok = stream->setPosition(0);
+
+        if (rf64)
+        {
+            ok = ok && stream->write("RF64", 4) && put32(0xffffffffu) && stream->write("WAVE", 4)
+                    && stream->write("ds64", 4) && put32(kDs64Size)
+                    && put64(riffBytes) && put64(dataBytes) && put64(frames) && put32(0);
+        }
+        else
+        {
+            ok = ok && stream->write("RIFF", 4) && put32(static_cast<juce::uint32>(riffBytes));
+        }
+
+        ok = ok && stream->setPosition(dataStart - 4)
+                && put32(rf64 ? 0xffffffffu : static_cast<juce::uint32>(dataBytes));
+
+        ok = ok && stream->setPosition(fileBytes);
+        return ok;
+    }
+
+    //==========================================================================
+    static constexpr juce::uint32 kDs64Size = 28;    // riff, data, sampleCount (64-bit) + table length
+
+    std::unique_ptr<juce::FileOutputStream> stream;
+    int numChannels = 2;
+    int bytesPerFrame = 2 * kBytesPerSample;
+
+    std::vector<char> batch;
+    size_t batchUsed = 0;
+
+    juce::int64 dataStart = 0;
+    juce::int64 dataBytes = 0;          // sample bytes handed to the stream
+    juce::int64 reservedBytes = 0;      // file offset space is reserved up to
+    bool failed = false;
+
+#if JUCE_MAC || JUCE_LINUX
+    int preallocateFd = -1;
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BroadcastWavWriter)
+};
@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+    CrossoverFilterBank.h
+    GOODMETER - Vectorised Linkwitz-Riley band-energy filter bank
+
+    Splits a stereo signal into 2..8 bands at user-defined crossover
+    frequencies and accumulates the energy of each band.
+
+    Every band is an LR4 band-pass built from its two edges:
+      band 0      = LR4 low-pass  @ f0
+      band k      = LR4 high-pass @ f(k-1) -> LR4 low-pass @ fk
+      last band   = LR4 high-pass @ f(last)
+    (LR4 = two cascaded Butterworth biquads, -6 dB at the crossover, so
+    adjacent bands sum flat in magnitude.) Missing edges are unity stages.
+
+    Because bands are computed independently from the input, each
+    (band, channel) pair is one SIMD lane and all four cascaded stages run
+    lane-parallel: 3 bands × L/R = 6 lanes = 2 registers. Cost grows with
+    ceil(2·bands / SIMD width), not with the number of filters.
+
+    The allpass phase compensation of a summing crossover is omitted: it
+    does not change band energy, and the bank is for metering only.
+
+    Thread safety model: audio thread only. Pass new crossovers in through
+    the owner's atomics and call setCrossovers() from processBlock.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+class CrossoverFilterBank
+{
+public:
+    static constexpr int kMaxBands = 8;
+    static constexpr int kMaxCrossovers = kMaxBands - 1;
+    static constexpr int kMaxLanes = kMaxBands * 2;   // (band, channel) interleaved: L R L R ...
+    static constexpr int kStages = 4;                 // LR4 high-pass (2) + LR4 low-pass (2)
+    static constexpr int kChunkSize = 64;
+
+    //==========================================================================
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+        setCrossovers(crossovers.data(), numBands - 1);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& stage : z1) stage.fill(0.0f);
+        for (auto& stage : z2) stage.fill(0.0f);
+    }
+
+    /** Crossover frequencies in Hz, ascending. Keeps filter state for unchanged bands. */
+    void setCrossovers(const float* frequencies, int numCrossovers) noexcept
+    {
+        numCrossovers = juce::jlimit(1, kMaxCrossovers, numCrossovers);
+        numBands = numCrossovers + 1;
+
+        const float nyquistLimit = static_cast<float>(sampleRate * 0.45);
+        float previous = 10.0f;
+
+        for (int i = 0; i < numCrossovers; ++i)
+        {
+            // Strictly ascending, inside (10 Hz, 0.45·fs)
+            const float f = juce::jlimit(previous * 1.01f, nyquistLimit, frequencies[i]);
+            crossovers[(size_t) i] = f;
+            previous = f;
+        }
+
+        for (int band = 0; band < kMaxBands; ++band)
+        {
+            const bool active = band < numBands;
+            const bool hasLowEdge = active && band > 0;
+            const bool hasHighEdge = active && band < numBands - 1;
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                const int lane = band * 2 + channel;
+
+                for (int s = 0; s < 2; ++s)
+                {
+                    if (hasLowEdge)  setButterworth(s, lane, crossovers[(size_t) band - 1], true);
+                    else             setUnity(s, lane, active);
+
+                    if (hasHighEdge) setButterworth(s + 2, lane, crossovers[(size_t) band], false);
+                    else             setUnity(s + 2, lane, active);
+                }
+            }
+        }
+
+        numLanes = numBands * 2;
+    }
+
+    int getNumBands() const noexcept                 { return numBands; }
+    float getCrossover(int index) const noexcept
+    {
+        return juce::isPositiveAndBelow(index, numBands - 1) ? crossovers[(size_t) index] : 0.0f;
+    }
+
+    //==========================================================================
+    /** Filter one stereo run and add Σ(L² + R²) per band into bandEnergies[0..numBands). */
+    void process(const float* left, const float* right, int numSamples, float* bandEnergies) noexcept
+    {
+        alignas(16) std::array<float, kMaxLanes> laneEnergies {};
+
+        for (int offset = 0; offset < numSamples; offset += kChunkSize)
+        {
+            const int run = juce::jmin(kChunkSize, numSamples - offset);
+            processChunk(left + offset, right + offset, run, laneEnergies.data());
+        }
+
+        for (int band = 0; band < numBands; ++band)
+            bandEnergies[band] += laneEnergies[(size_t) band * 2] + laneEnergies[(size_t) band * 2 + 1];
+    }
+
+private:
+    //==========================================================================
+    void processChunk(const float* left, const float* right, int run, float* laneEnergies) noexcept
+    {
+#if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+        constexpr int width = static_cast<int>(Vec::SIMDNumElements);
+
+        if constexpr (width % 2 == 0 && width <= 4 && kMaxLanes % width == 0)
+        {
+            // Interleave once per chunk: every register sees L R L R ... for each sample
+            for (int i = 0; i < run; ++i)
+                for (int lane = 0; lane < width; lane += 2)
+                {
+                    interleaved[(size_t) (i * width + lane)] = left[i];
+                    interleaved[(size_t) (i * width + lane + 1)] = right[i];
+                }
+
+            for (int base = 0; base < numLanes; base += width)
+            {
+                Vec b0[kStages], b1[kStages], b2[kStages], a1[kStages], a2[kStages], s1[kStages], s2[kStages];
+
+                for (int s = 0; s < kStages; ++s)
+                {
+                    b0[s] = Vec::fromRawArray(coeffB0[(size_t) s].data() + base);
+                    b1[s] = Vec::fromRawArray(coeffB1[(size_t) s].data() + base);
+                    b2[s] = Vec::fromRawArray(coeffB2[(size_t) s].data() + base);
+                    a1[s] = Vec::fromRawArray(coeffA1[(size_t) s].data() + base);
+                    a2[s] = Vec::fromRawArray(coeffA2[(size_t) s].data() + base);
+                    s1[s] = Vec::fromRawArray(z1[(size_t) s].data() + base);
+                    s2[s] = Vec::fromRawArray(z2[(size_t) s].data() + base);
+                }
+
+                Vec energy = Vec::fromRawArray(laneEnergies + base);
+
+                for (int i = 0; i < run; ++i)
+                {
+                    Vec x = Vec::fromRawArray(interleaved.data() + i * width);
+
+                    // TDF-II: y = b0·x + z1; z1 = b1·x - a1·y + z2; z2 = b2·x - a2·y
+                    for (int s = 0; s < kStages; ++s)
+                    {
+                        const Vec y = b0[s] * x + s1[s];
+                        s1[s] = b1[s] * x - a1[s] * y + s2[s];
+                        s2[s] = b2[s] * x - a2[s] * y;
+                        x = y;
+                    }
+
+                    energy = Vec::multiplyAdd(energy, x, x);
+                }
+
+                for (int s = 0; s < kStages; ++s)
+                {
+                    s1[s].copyToRawArray(z1[(size_t) s].data() + base);
+                    s2[s].copyToRawArray(z2[(size_t) s].data() + base);
+                }
+
+                energy.copyToRawArray(laneEnergies + base);
+            }
+            return;
+        }
+#endif
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const float* input = (lane & 1) ? right : left;
+            float energy = 0.0f;
+
+            for (int i = 0; i < run; ++i)
+            {
+                float x = input[i];
+                for (size_t s = 0; s < (size_t) kStages; ++s)
+                {
+                    const float y = coeffB0[s][(size_t) lane] * x + z1[s][(size_t) lane];
+                    z1[s][(size_t) lane] = coeffB1[s][(size_t) lane] * x - coeffA1[s][(size_t) lane] * y + z2[s][(size_t) lane];
+                    z2[s][(size_t) lane] = coeffB2[s][(size_t) lane] * x - coeffA2[s][(size_t) lane] * y;
+                    x = y;
+                }
+                energy += x * x;
+            }
+
+            laneEnergies[lane] += energy;
+        }
+    }
+
+    //==========================================================================
+    /** RBJ Butterworth (Q = 1/√2) section; two in series form one LR4 slope. */
+    void setButterworth(int stage, int lane, float frequency, bool highPass) noexcept
+    {
+        const double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const double cosW0 = std::cos(w0);
+        const double alpha = std::sin(w0) / (2.0 * 0.70710678118654752);
+        const double a0 = 1.0 + alpha;
+
+        const double b1 = highPass ? -(1.0 + cosW0) : (1.0 - cosW0);
+        const double b0 = highPass ? (1.0 + cosW0) * 0.5 : (1.0 - cosW0) * 0.5;
+
+        setStage(stage, lane, b0 / a0, b1 / a0, b0 / a0, (-2.0 * cosW0) / a0, (1.0 - alpha) / a0);
+    }
+
+    void setUnity(int stage, int lane, bool active) noexcept
+    {
+        // Inactive lanes output silence so their energy stays zero
+        setStage(stage, lane, active ? 1.0 : 0.0, 0.0, 0.0, 0.0, 0.0);
+    }
+
+    void setStage(int stage, int lane, double b0, double b1, double b2, double a1, double a2) noexcept
+    {
+        const auto s = (size_t) stage;
+        const auto l = (size_t) lane;
+        coeffB0[s][l] = static_cast<float>(b0);
+        coeffB1[s][l] = static_cast<float>(b1);
+        coeffB2[s][l] = static_cast<float>(b2);
+        coeffA1[s][l] = static_cast<float>(a1);
+        coeffA2[s][l] = static_cast<float>(a2);
+    }
+
+    //==========================================================================
+    using LaneArray = std::array<float, kMaxLanes>;
+
+    double sampleRate = 48000.0;
+    int numBands = 3;
+    int numLanes = 6;
+    std::array<float, kMaxCrossovers> crossovers { 250.0f, 2000.0f };
+
+    alignas(16) std::array<LaneArray, kStages> coeffB0 {};
+    alignas(16) std::array<LaneArray, kStages> coeffB1 {};
+    alignas(16) std::array<LaneArray, kStages> coeffB2 {};
+    alignas(16) std::array<LaneArray, kStages> coeffA1 {};
+    alignas(16) std::array<LaneArray, kStages> coeffA2 {};
+    alignas(16) std::array<LaneArray, kStages> z1 {};
+    alignas(16) std::array<LaneArray, kStages> z2 {};
+
+    alignas(16) std::array<float, kChunkSize * 4> interleaved {};
+};
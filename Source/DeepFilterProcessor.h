@@ -4,8 +4,8 @@
     GOODMETER - DeepFilterNet3 Offline Noise Reduction via ONNX Runtime
 
     Pipeline (offline, entire file):
-      1. Mix to mono, resample to 48 kHz if needed
-      2. STFT (960-pt Vorbis window, hop 480, via Accelerate DFT)
+      1. Per channel, resample to 48 kHz if needed (PolyphaseResampler)
+      2. STFT (960-pt Vorbis window, hop 480, real-input RealFFT)
       3. Feature extraction: ERB bands (32) + complex spec (96 bins)
       4. ONNX inference: enc → erb_dec (ERB mask) + df_dec (DF coefficients)
       5. Apply ERB mask to full spectrum (481 bins)
@@ -13,7 +13,25 @@
       7. ISTFT → time domain
 
     Chunked processing with GRU warmup overlap for memory efficiency.
-    960 = 15 × 2^6 → Accelerate vDSP_DFT_zop handles it natively.
+    Steps 2-7 run chunk by chunk on FrameWindows (warm-up + one chunk of
+    spectra and features), overlap-adding each enhanced frame straight into
+    the output, so memory no longer grows with the file's STFT.
+    960 = 15 × 2^6: vDSP_DFT_zrop on Apple, mixed radix elsewhere.
+
+    Chunks carry their own kWarmUp context, so inference (steps 4-6) runs
+    for several chunks at once on the AnalysisTaskGraph pool; STFT/features
+    (running means) and overlap-add stay in frame order. Sessions can use
+    the CoreML execution provider (ANE/GPU), with ONNX Runtime's CPU
+    kernels taking any node CoreML can't, and plain CPU sessions if the
+    provider fails to initialise.
+
+    Each window owns its inference tensors (~100 MB for a full chunk, e0
+    and c0 being most of it), bound once through Ort::IoBinding: the
+    encoder writes into them and the decoders read the same Ort::Values.
+
+    FrameStream runs the same steps 2-7 on a live 48 kHz channel, a few
+    hops at a time, over a short window of recent frames (see below);
+    DeepFilterRealtime puts it on its own thread behind the audio thread.
 
     Bug fixes v2 (matching Rust reference libDF):
       - ERB features: mean_power with subtractive normalization /40
@@ -30,8 +48,14 @@
 
 #include <JuceHeader.h>
 #include <onnxruntime_cxx_api.h>
-#include <Accelerate/Accelerate.h>
+#if JUCE_MAC || JUCE_IOS
+ #include <coreml_provider_factory.h>
+#endif
+#include "AnalysisTaskGraph.h"
+#include "PolyphaseResampler.h"
+#include "RealFFT.h"
 #include <complex>
+#include <cstring>
 #include <vector>
 #include <array>
 #include <atomic>
@@ -43,39 +67,92 @@ class DeepFilterProcessor
 public:
     DeepFilterProcessor() = default;
 
-    ~DeepFilterProcessor()
+    struct Options
     {
-        if (fwdDFTSetup) vDSP_DFT_DestroySetup(fwdDFTSetup);
-        if (invDFTSetup) vDSP_DFT_DestroySetup(invDFTSetup);
-    }
+        bool useCoreML        = false;  // CoreML EP (ANE/GPU), CPU for the rest
+        int  parallelChunks   = 0;      // chunks inferred at once, 0 = auto
+        int  intraOpThreads   = 0;      // per session run, 0 = cores / parallelChunks
+    };
 
     /** Load 3 ONNX models + build precomputed tables.
         modelDir must contain enc.onnx, erb_dec.onnx, df_dec.onnx */
     bool initialize(const juce::File& modelDir)
+    {
+        return initialize(modelDir, Options {});
+    }
+
+    bool initialize(const juce::File& modelDir, const Options& options)
     {
         try
         {
             env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "DeepFilter");
 
-            Ort::SessionOptions opts;
-            opts.SetIntraOpNumThreads(4);
-            opts.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            const int cores = juce::jmax(1, juce::SystemStats::getNumCpus());
+            parallelChunks = options.parallelChunks > 0 ? options.parallelChunks
+                                                        : juce::jlimit(1, 4, cores / 2);
+            const int intraThreads = options.intraOpThreads > 0 ? options.intraOpThreads
+                                                                : juce::jmax(1, cores / parallelChunks);
 
-            auto load = [&](const juce::String& name) {
-                auto path = modelDir.getChildFile(name).getFullPathName().toStdString();
-                return std::make_unique<Ort::Session>(*env, path.c_str(), opts);
+            // Chunks already run side by side; keep each run's own pool small
+            // and its nodes sequential so the two levels don't oversubscribe
+            auto makeOptions = [intraThreads](bool coreML)
+            {
+                Ort::SessionOptions opts;
+                opts.SetIntraOpNumThreads(intraThreads);
+                opts.SetInterOpNumThreads(1);
+                opts.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+                opts.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+               #if JUCE_MAC || JUCE_IOS
+                if (coreML)
+                    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_CoreML(opts, COREML_FLAG_CREATE_MLPROGRAM));
+               #else
+                juce::ignoreUnused(coreML);
+               #endif
+                return opts;
             };
 
-            encSession     = load("enc.onnx");
-            erbDecSession  = load("erb_dec.onnx");
-            dfDecSession   = load("df_dec.onnx");
+            auto loadAll = [&](const Ort::SessionOptions& opts)
+            {
+                auto load = [&](const juce::String& name) {
+                    auto path = modelDir.getChildFile(name).getFullPathName().toStdString();
+                    return std::make_unique<Ort::Session>(*env, path.c_str(), opts);
+                };
+
+                encSession     = load("enc.onnx");
+                erbDecSession  = load("erb_dec.onnx");
+                dfDecSession   = load("df_dec.onnx");
+            };
+
+            usingCoreML = false;
+           #if JUCE_MAC || JUCE_IOS
+            if (options.useCoreML)
+            {
+                try
+                {
+                    loadAll(makeOptions(true));
+                    usingCoreML = true;
+                }
+                catch (const Ort::Exception& e)
+                {
+                    DBG("DeepFilter: CoreML unavailable, using CPU: " << e.what());
+                }
+            }
+           #endif
+
+            if (!usingCoreML)
+                loadAll(makeOptions(false));
+
+            if (!inputShapesMatch(*encSession) || !inputShapesMatch(*erbDecSession)
+                || !inputShapesMatch(*dfDecSession))
+            {
+                DBG("DeepFilter: model tensor shapes don't match DFN3");
+                return false;
+            }
 
             buildVorbisWindow();
             buildERBBands();
 
-            fwdDFTSetup = vDSP_DFT_zop_CreateSetup(nullptr, kFFTSize, vDSP_DFT_FORWARD);
-            invDFTSetup = vDSP_DFT_zop_CreateSetup(nullptr, kFFTSize, vDSP_DFT_INVERSE);
-            if (!fwdDFTSetup || !invDFTSetup) return false;
+            fft = std::make_unique<RealFFT>(kFFTSize);
 
             initialized = true;
             return true;
@@ -89,6 +166,25 @@ public:
 
     bool isInitialized() const { return initialized; }
 
+    /** True when the sessions were created with the CoreML execution provider. */
+    bool isUsingCoreML() const { return usingCoreML; }
+
+    /** The bundled DeepFilterNet3_onnx folder (app Resources or Frameworks,
+        then the ThirdParty dev checkout), or File() if none has the models. */
+    static juce::File findModelDirectory()
+    {
+        auto contents = juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+                            .getParentDirectory().getParentDirectory();
+
+        for (const auto& dir : { contents.getChildFile("Resources/DeepFilterNet3_onnx"),
+                                 contents.getChildFile("Frameworks/DeepFilterNet3_onnx"),
+                                 juce::File("/Users/MediaStorm/Desktop/GOODMETER/ThirdParty/DeepFilterNet3_onnx") })
+            if (dir.getChildFile("enc.onnx").existsAsFile())
+                return dir;
+
+        return {};
+    }
+
     //==========================================================================
     /** Offline denoise: processes EACH channel independently through DFN3.
         Returns denoised buffer with same channel count and sample rate.
@@ -125,7 +221,7 @@ public:
             // Resample to 48 kHz if needed
             bool needsResample = (std::abs(inputSampleRate - kSR) > 1.0);
             if (needsResample)
-                chanBuf = resampleLinear(chanBuf, inputSampleRate, kSR);
+                chanBuf = PolyphaseResampler::resample(chanBuf, inputSampleRate, kSR);
 
             int numSamples = chanBuf.getNumSamples();
 
@@ -138,38 +234,17 @@ public:
 
             const float* paddedData = padded.getReadPointer(0);
 
-            // STFT
             int numFrames = (paddedLen - kFFTSize) / kHopSize + 1;
             if (numFrames < 3) continue;
 
-            std::vector<float> specRe(numFrames * kNbBins);
-            std::vector<float> specIm(numFrames * kNbBins);
-            computeSTFT(paddedData, paddedLen, numFrames, specRe, specIm);
-            progress.store(chBase + chSpan * 0.06f);
-
-            // Feature extraction (EMA states are local → fresh per channel)
-            std::vector<float> featERB(numFrames * kNbERB);
-            std::vector<float> featSpec(2 * numFrames * kNbDF);
-            computeFeatures(specRe, specIm, numFrames, featERB, featSpec);
-            progress.store(chBase + chSpan * 0.10f);
-
-            // Enhanced spectra (start as copy of original)
-            std::vector<float> enhRe = specRe;
-            std::vector<float> enhIm = specIm;
-
-            // Chunked ONNX inference + post-processing
-            // Use a sub-progress that maps to this channel's portion
-            std::atomic<float> subProgress { 0.0f };
-            processChunked(featERB, featSpec, specRe, specIm,
-                           enhRe, enhIm, numFrames, subProgress);
-            progress.store(chBase + chSpan * 0.90f);
-
-            // ISTFT
+            // STFT → features → ONNX → ISTFT, one chunk at a time
+            // (EMA states live in the window → fresh per channel)
             int outputLen = (numFrames - 1) * kHopSize + kFFTSize;
             juce::AudioBuffer<float> paddedOut(1, outputLen);
             paddedOut.clear();
-            computeISTFT(enhRe, enhIm, numFrames,
-                         paddedOut.getWritePointer(0), outputLen);
+            processChunked(paddedData, numFrames, paddedOut.getWritePointer(0),
+                           progress, chBase + chSpan * 0.02f, chSpan * 0.88f);
+            progress.store(chBase + chSpan * 0.90f);
 
             // Remove padding — extract the original-length segment
             juce::AudioBuffer<float> chanOut(1, numSamples);
@@ -180,7 +255,7 @@ public:
 
             // Resample back if needed
             if (needsResample)
-                chanOut = resampleLinear(chanOut, kSR, inputSampleRate);
+                chanOut = PolyphaseResampler::resample(chanOut, kSR, inputSampleRate);
 
             // Wet/dry blend and write to result
             int finalLen = juce::jmin(chanOut.getNumSamples(), inputLen);
@@ -190,8 +265,8 @@ public:
 
             float w = juce::jlimit(0.0f, 1.0f, wetDry);
             float d = 1.0f - w;
-            for (int s = 0; s < finalLen; ++s)
-                dst[s] = wet[s] * w + dry[s] * d;
+            juce::FloatVectorOperations::copyWithMultiply(dst, wet, w, finalLen);
+            juce::FloatVectorOperations::addWithMultiply(dst, dry, d, finalLen);
 
             progress.store(chBase + chSpan);
           }
@@ -213,6 +288,13 @@ public:
         return result;
     }
 
+    //==========================================================================
+    /** Live denoising of one channel, hop by hop (defined below). */
+    class FrameStream;
+
+    static constexpr int getStreamSampleRate() noexcept   { return kSR; }
+    static constexpr int getStreamHopSize() noexcept      { return kHopSize; }
+
 private:
     //==========================================================================
     // Constants (from DeepFilterNet3 config.ini)
@@ -238,6 +320,8 @@ private:
     // State
     //==========================================================================
     bool initialized = false;
+    bool usingCoreML = false;
+    int  parallelChunks = 1;
 
     std::unique_ptr<Ort::Env>     env;
     std::unique_ptr<Ort::Session> encSession, erbDecSession, dfDecSession;
@@ -248,8 +332,7 @@ private:
     std::vector<int> erbBandWidths;    // [32] — bins per band
     std::vector<int> erbBandOffsets;   // [33] — cumulative bin offsets
 
-    vDSP_DFT_Setup fwdDFTSetup = nullptr;
-    vDSP_DFT_Setup invDFTSetup = nullptr;
+    std::unique_ptr<RealFFT> fft;
 
     //==========================================================================
     // Precomputed tables
@@ -265,11 +348,14 @@ private:
         }
     }
 
-    /** Build ERB band partition: 481 FFT bins → 32 ERB bands (contiguous). */
+    /** Build ERB band partition: 481 FFT bins → 32 ERB bands (contiguous).
+        Port of libDF erb_fb(): band edges at equal ERB steps rounded to bins,
+        narrow bands widened to kMinERBFreqs and the excess taken from the
+        next band, so the widths always sum to kNbBins. */
     void buildERBBands()
     {
-        auto fToErb = [](float f) { return 21.4f * std::log10(1.0f + 0.00437f * f); };
-        auto erbToF = [](float e) { return (std::pow(10.0f, e / 21.4f) - 1.0f) / 0.00437f; };
+        auto fToErb = [](float f) { return 9.265f * std::log1p(f / (24.7f * 9.265f)); };
+        auto erbToF = [](float e) { return 24.7f * 9.265f * (std::exp(e / 9.265f) - 1.0f); };
 
         float nyquist  = kSR / 2.0f;
         float minErb   = fToErb(0.0f);
@@ -278,21 +364,19 @@ private:
         float freqRes  = static_cast<float>(kSR) / static_cast<float>(kFFTSize); // 50 Hz
 
         erbBandWidths.resize(kNbERB);
-        float curFreq = 0.0f;
+        int prevBin = 0, overflow = 0;
 
         for (int b = 0; b < kNbERB; ++b)
         {
-            float curErb   = fToErb(curFreq);
-            float tgtFreq  = erbToF(curErb + erbStep);
-            int nbFreqs    = juce::jmax(kMinERBFreqs,
-                static_cast<int>(std::round((tgtFreq - curFreq) / freqRes)));
-            erbBandWidths[b] = nbFreqs;
-            curFreq += nbFreqs * freqRes;
+            int edgeBin = static_cast<int>(std::round(erbToF(minErb + (b + 1) * erbStep) / freqRes));
+            int nbFreqs = edgeBin - prevBin - overflow;
+            overflow = juce::jmax(0, kMinERBFreqs - nbFreqs);
+            erbBandWidths[b] = juce::jmax(kMinERBFreqs, nbFreqs);
+            prevBin = edgeBin;
         }
 
-        // Adjust last band so total = kNbBins
-        int total = 0;
-        for (int w : erbBandWidths) total += w;
+        // Edges stop at bin 480: the last band also takes the Nyquist bin
+        int total = std::accumulate(erbBandWidths.begin(), erbBandWidths.end(), 0);
         erbBandWidths.back() += kNbBins - total;
 
         // Cumulative offsets (size 33)
@@ -321,59 +405,171 @@ private:
         return m;
     }
 
-    static juce::AudioBuffer<float> resampleLinear(
-        const juce::AudioBuffer<float>& src, double srcRate, double dstRate)
+    //==========================================================================
+    // Inference tensors — every input/output of one chunk's three runs.
+    // Shapes are DFN3's, -1 = frame axis (S). The ONNX files declare the
+    // encoder's outputs symbolically, so initialize() checks these against
+    // the declared encoder/decoder inputs instead.
+    //==========================================================================
+    enum Tensor
     {
-        double ratio = dstRate / srcRate;
-        int newLen = static_cast<int>(src.getNumSamples() * ratio);
-        juce::AudioBuffer<float> dst(src.getNumChannels(), newLen);
+        featErbT, featSpecT,                                // encoder inputs
+        e0T, e1T, e2T, e3T, embT, c0T, lsnrT,               // encoder outputs
+        maskT,                                              // erb_dec output
+        coefsT, alphaT,                                     // df_dec outputs
+        numTensors
+    };
 
-        for (int ch = 0; ch < src.getNumChannels(); ++ch)
-        {
-            const float* s = src.getReadPointer(ch);
-            float* d = dst.getWritePointer(ch);
-            int srcLen = src.getNumSamples();
-            for (int i = 0; i < newLen; ++i)
-            {
-                double pos = i / ratio;
-                int i0 = static_cast<int>(pos);
-                int i1 = juce::jmin(i0 + 1, srcLen - 1);
-                float f = static_cast<float>(pos - i0);
-                d[i] = s[i0] * (1.0f - f) + s[i1] * f;
-            }
-        }
-        return dst;
+    struct TensorSpec
+    {
+        const char* name;
+        std::array<int64_t, 4> shape;
+        size_t rank;
+    };
+
+    static const TensorSpec& tensorSpec(int t)
+    {
+        static const std::array<TensorSpec, numTensors> specs {{
+            { "feat_erb",  { 1, 1, -1, kNbERB },          4 },
+            { "feat_spec", { 1, 2, -1, kNbDF },           4 },
+            { "e0",        { 1, 64, -1, 32 },             4 },
+            { "e1",        { 1, 64, -1, 16 },             4 },
+            { "e2",        { 1, 64, -1, 8 },              4 },
+            { "e3",        { 1, 64, -1, 8 },              4 },
+            { "emb",       { 1, -1, 512 },                3 },
+            { "c0",        { 1, 64, -1, kNbDF },          4 },
+            { "lsnr",      { 1, -1, 1 },                  3 },
+            { "m",         { 1, 1, -1, kNbERB },          4 },
+            { "coefs",     { 1, -1, kNbDF, kDFOrder * 2 }, 4 },
+            { "235",       { 1, -1, 1 },                  3 },   // alpha
+        }};
+        return specs[(size_t) t];
+    }
+
+    static size_t tensorValuesPerFrame(int t)
+    {
+        const auto& spec = tensorSpec(t);
+        size_t n = 1;
+        for (size_t d = 0; d < spec.rank; ++d)
+            if (spec.shape[d] > 0) n *= static_cast<size_t>(spec.shape[d]);
+        return n;
     }
 
+    /** Output storage and IoBindings of one window. Encoder outputs are
+        bound as the decoders' inputs as they are: nothing is copied. */
+    struct InferenceBuffers
+    {
+        std::array<std::vector<float>, numTensors> data;    // inputs live in the window itself
+        std::vector<Ort::Value> values;                     // bound tensors, alive with the bindings
+        std::unique_ptr<Ort::IoBinding> enc, erbDec, dfDec;
+        int boundFrames = -1;
+    };
+
     //==========================================================================
-    // STFT (forward) — 960-pt complex DFT via Accelerate
+    // Frame window — spectra + features of the frames one chunk needs
+    // (kWarmUp + kChunkStride offline, context + block + lookahead when
+    // streaming). Each window is filled from its predecessor (the warm-up
+    // overlap) plus newly analysed frames.
+    // All buffers are sized once; nothing here allocates per frame.
     //==========================================================================
-    void computeSTFT(const float* input, int numSamples, int numFrames,
-                     std::vector<float>& outRe, std::vector<float>& outIm)
+    struct FrameWindow
     {
-        std::vector<float> dftIr(kFFTSize), dftIi(kFFTSize, 0.0f);
-        std::vector<float> dftOr(kFFTSize), dftOi(kFFTSize);
+        static constexpr int kChunkCapacity = kWarmUp + kChunkStride;
 
-        for (int f = 0; f < numFrames; ++f)
+        FrameWindow(const RealFFT& fftToUse, int capacityToUse)
+            : capacity(capacityToUse), fftScratch(fftToUse.makeScratch())
         {
-            int pos = f * kHopSize;
-            for (int n = 0; n < kFFTSize; ++n)
-            {
-                int idx = pos + n;
-                dftIr[n] = (idx < numSamples) ? input[idx] * vorbisWindow[n] : 0.0f;
-                dftIi[n] = 0.0f;
-            }
+            const auto frames = static_cast<size_t>(capacity);
+            specRe.resize(frames * kNbBins);
+            specIm.resize(frames * kNbBins);
+            featERB.resize(frames * kNbERB);
+            featSpecRe.resize(frames * kNbDF);
+            featSpecIm.resize(frames * kNbDF);
+            chunkSpec.resize(2 * frames * kNbDF);
+            localRe.resize(frames * kNbBins);
+            localIm.resize(frames * kNbBins);
+            enhRe.resize(frames * kNbBins);
+            enhIm.resize(frames * kNbBins);
+
+            for (int t = e0T; t < numTensors; ++t)
+                inference.data[(size_t) t].resize(tensorValuesPerFrame(t) * frames);
+        }
+
+        const int capacity;                     // frames the buffers hold
 
-            vDSP_DFT_Execute(fwdDFTSetup,
-                dftIr.data(), dftIi.data(), dftOr.data(), dftOi.data());
+        int firstFrame = 0;                     // global index of slot 0 (= chunk inStart)
+        int numFrames  = 0;                     // = chunk S
+        int warmOff    = 0;                     // slots before the chunk's usable frames
+        bool inferred  = false;                 // enhRe/enhIm valid for usable slots
 
-            int off = f * kNbBins;
-            for (int k = 0; k < kNbBins; ++k)
+        std::vector<float> specRe, specIm;      // [slot][kNbBins]
+        std::vector<float> featERB;             // [slot][kNbERB] — encoder layout as is
+        std::vector<float> featSpecRe, featSpecIm;  // [slot][kNbDF]
+
+        // Per-chunk scratch
+        std::vector<float> chunkSpec;           // [2][S][kNbDF] for the encoder
+        std::vector<float> localRe, localIm;    // ERB-masked [slot][kNbBins]
+        std::vector<float> enhRe, enhIm;        // enhanced [slot][kNbBins]
+        std::array<float, kFFTSize> frameTime {};
+        RealFFT::Scratch fftScratch;
+        InferenceBuffers inference;
+    };
+
+    /** Running-mean normalization state — starts at 0 (matching Rust
+        reference) and carries across chunks in frame order. */
+    struct FeatureState
+    {
+        std::array<float, kNbERB> erb {};
+        std::array<float, kNbDF>  spec {};
+    };
+
+    /** Fill w with frames [inStart, outEnd): those prev already holds are
+        copied (prev may be w itself), the rest analysed. Frame gf's samples
+        start at samples + (gf - samplesFirstFrame) * kHopSize. */
+    void fillWindow(FrameWindow& w, const FrameWindow& prev, FeatureState& state,
+                    const float* samples, int samplesFirstFrame, int inStart, int outEnd)
+    {
+        jassert(outEnd - inStart <= w.capacity);
+
+        const int drop = juce::jlimit(0, prev.numFrames, inStart - prev.firstFrame);
+        const int keep = prev.numFrames - drop;
+
+        if (keep > 0 && (&w != &prev || drop > 0))
+        {
+            auto take = [keep, drop](std::vector<float>& dst, const std::vector<float>& src, int stride)
             {
-                outRe[off + k] = dftOr[k];
-                outIm[off + k] = dftOi[k];
-            }
+                std::copy_n(src.begin() + drop * stride, keep * stride, dst.begin());
+            };
+            take(w.specRe, prev.specRe, kNbBins);
+            take(w.specIm, prev.specIm, kNbBins);
+            take(w.featERB, prev.featERB, kNbERB);
+            take(w.featSpecRe, prev.featSpecRe, kNbDF);
+            take(w.featSpecIm, prev.featSpecIm, kNbDF);
         }
+
+        w.firstFrame = inStart;
+        w.numFrames  = juce::jmax(0, keep);
+        w.inferred   = false;
+
+        for (int gf = inStart + w.numFrames; gf < outEnd; ++gf)
+            analyseFrame(w, state, samples + (gf - samplesFirstFrame) * kHopSize, w.numFrames++);
+    }
+
+    //==========================================================================
+    // STFT (forward) — window + 960-pt real FFT, one frame into one slot
+    //==========================================================================
+    void analyseFrame(FrameWindow& w, FeatureState& state, const float* frameSamples, int slot)
+    {
+        juce::FloatVectorOperations::multiply(w.frameTime.data(), frameSamples,
+                                              vorbisWindow.data(), kFFTSize);
+
+        float* re = &w.specRe[slot * kNbBins];
+        float* im = &w.specIm[slot * kNbBins];
+        fft->forward(w.frameTime.data(), re, im, w.fftScratch);
+
+        computeFeatures(re, im, state.erb, state.spec,
+                        &w.featERB[slot * kNbERB],
+                        &w.featSpecRe[slot * kNbDF], &w.featSpecIm[slot * kNbDF]);
     }
 
     //==========================================================================
@@ -382,46 +578,12 @@ private:
     //      the Princen-Bradley condition (w²(n) + w²(n+N/2) = 1), so
     //      analysis_window × synthesis_window overlap-add = unity gain.
     //==========================================================================
-    void computeISTFT(const std::vector<float>& inRe,
-                      const std::vector<float>& inIm,
-                      int numFrames, float* output, int numSamples)
+    void synthesizeFrame(FrameWindow& w, const float* re, const float* im,
+                         float* output, int frame)
     {
-        std::vector<float> dftIr(kFFTSize), dftIi(kFFTSize);
-        std::vector<float> dftOr(kFFTSize), dftOi(kFFTSize);
-
-        float invN = 1.0f / static_cast<float>(kFFTSize);
-
-        for (int f = 0; f < numFrames; ++f)
-        {
-            int off = f * kNbBins;
-
-            // Reconstruct full spectrum (Hermitian symmetry)
-            for (int k = 0; k < kNbBins; ++k)
-            {
-                dftIr[k] = inRe[off + k];
-                dftIi[k] = inIm[off + k];
-            }
-            for (int k = kNbBins; k < kFFTSize; ++k)
-            {
-                dftIr[k] =  inRe[off + (kFFTSize - k)];
-                dftIi[k] = -inIm[off + (kFFTSize - k)];
-            }
-
-            vDSP_DFT_Execute(invDFTSetup,
-                dftIr.data(), dftIi.data(), dftOr.data(), dftOi.data());
-
-            int pos = f * kHopSize;
-            for (int n = 0; n < kFFTSize; ++n)
-            {
-                int idx = pos + n;
-                if (idx < numSamples)
-                {
-                    float w = vorbisWindow[n];
-                    output[idx] += dftOr[n] * invN * w;
-                    // No winSum accumulation or division — Princen-Bradley
-                }
-            }
-        }
+        fft->inverse(re, im, w.frameTime.data(), w.fftScratch);
+        juce::FloatVectorOperations::addWithMultiply(output + frame * kHopSize, w.frameTime.data(),
+                                                     vorbisWindow.data(), kFFTSize);
     }
 
     //==========================================================================
@@ -432,65 +594,50 @@ private:
     //   Spec: band_unit_norm    → X_norm = X / sqrt(running_mean_of_mag)
     //   EMA state starts at 0 (not first-frame value)
     //==========================================================================
-    void computeFeatures(const std::vector<float>& specRe,
-                         const std::vector<float>& specIm,
-                         int numFrames,
-                         std::vector<float>& featERB,
-                         std::vector<float>& featSpec)
+    void computeFeatures(const float* specRe, const float* specIm,
+                         std::array<float, kNbERB>& erbState,
+                         std::array<float, kNbDF>& specState,
+                         float* featERB, float* featSpecRe, float* featSpecIm) const
     {
-        // Running-mean normalization state — initialized to 0 (matching Rust reference)
-        std::vector<float> erbState(kNbERB, 0.0f);
-        std::vector<float> specState(kNbDF, 0.0f);
-
-        for (int f = 0; f < numFrames; ++f)
+        // ── feat_erb: mean power per band, subtractive normalization / 40 ──
+        // Reference: compute_band_erb → band_mean_norm_erb
+        //   mean_power = sum(|X|²) / bandwidth
+        //   state = state * alpha + mean_power * (1 - alpha)
+        //   feature = (mean_power - state) / 40.0
+        for (int b = 0; b < kNbERB; ++b)
         {
-            int sOff = f * kNbBins;
-
-            // ── feat_erb: mean power per band, subtractive normalization / 40 ──
-            // Reference: compute_band_erb → band_mean_norm_erb
-            //   mean_power = sum(|X|²) / bandwidth
-            //   state = state * alpha + mean_power * (1 - alpha)
-            //   feature = (mean_power - state) / 40.0
-            for (int b = 0; b < kNbERB; ++b)
-            {
-                float power = 0.0f;
-                int bs = erbBandOffsets[b], be = erbBandOffsets[b + 1];
-                for (int k = bs; k < be; ++k)
-                {
-                    float re = specRe[sOff + k], im = specIm[sOff + k];
-                    power += re * re + im * im;
-                }
-                float meanPower = power / static_cast<float>(be - bs);
-
-                // EMA update: state starts at 0, NOT initialized to first frame
-                erbState[b] = erbState[b] * kNormAlpha
-                              + meanPower * (1.0f - kNormAlpha);
-
-                // Subtractive normalization with constant scaling
-                featERB[f * kNbERB + b] = (meanPower - erbState[b]) / 40.0f;
-            }
-
-            // ── feat_spec: complex bins 0..95, unit-norm by sqrt(running_mean_of_mag) ──
-            // Reference: band_unit_norm
-            //   state = state * alpha + |X| * (1 - alpha)
-            //   X_norm = X / sqrt(state)
-            for (int k = 0; k < kNbDF; ++k)
-            {
-                float re  = specRe[sOff + k];
-                float im  = specIm[sOff + k];
-                float mag = std::sqrt(re * re + im * im);
-
-                // EMA update: state starts at 0
-                specState[k] = specState[k] * kNormAlpha
-                               + mag * (1.0f - kNormAlpha);
-
-                // Divide by sqrt of running mean (the "sqrt quirk" from Issue #514)
-                float inv = 1.0f / (std::sqrt(specState[k]) + 1e-10f);
+            float power = 0.0f;
+            int bs = erbBandOffsets[b], be = erbBandOffsets[b + 1];
+            for (int k = bs; k < be; ++k)
+                power += specRe[k] * specRe[k] + specIm[k] * specIm[k];
+            float meanPower = power / static_cast<float>(be - bs);
+
+            // EMA update: state starts at 0, NOT initialized to first frame
+            erbState[b] = erbState[b] * kNormAlpha
+                          + meanPower * (1.0f - kNormAlpha);
+
+            // Subtractive normalization with constant scaling
+            featERB[b] = (meanPower - erbState[b]) / 40.0f;
+        }
 
-                // Layout: [channel0 = real][channel1 = imag], each [S, 96]
-                featSpec[f * kNbDF + k]                      = re * inv;
-                featSpec[numFrames * kNbDF + f * kNbDF + k]  = im * inv;
-            }
+        // ── feat_spec: complex bins 0..95, unit-norm by sqrt(running_mean_of_mag) ──
+        // Reference: band_unit_norm
+        //   state = state * alpha + |X| * (1 - alpha)
+        //   X_norm = X / sqrt(state)
+        for (int k = 0; k < kNbDF; ++k)
+        {
+            float re  = specRe[k];
+            float im  = specIm[k];
+            float mag = std::sqrt(re * re + im * im);
+
+            // EMA update: state starts at 0
+            specState[k] = specState[k] * kNormAlpha
+                           + mag * (1.0f - kNormAlpha);
+
+            // Divide by sqrt of running mean (the "sqrt quirk" from Issue #514)
+            float inv = 1.0f / (std::sqrt(specState[k]) + 1e-10f);
+            featSpecRe[k] = re * inv;
+            featSpecIm[k] = im * inv;
         }
     }
 
@@ -499,283 +646,434 @@ private:
     //
     // FIXED:
     //   - ERB mask applied to local cache for all chunk frames (needed by DF taps)
-    //   - Only usable (non-warmup) frames written to output enhRe/enhIm
+    //   - Only usable (non-warmup) frames written to output
     //   - DF tap order: f + kDFLookahead - tap (matching Rust reference)
+    //
+    // Chunks go in groups of parallelChunks: windows filled in order, then
+    // every chunk of the group inferred at once, then overlap-added in order.
     //==========================================================================
-    void processChunked(const std::vector<float>& featERB,
-                        const std::vector<float>& featSpec,
-                        const std::vector<float>& specRe,
-                        const std::vector<float>& specIm,
-                        std::vector<float>& enhRe,
-                        std::vector<float>& enhIm,
+    void processChunked(const float* padded,
                         int totalFrames,
-                        std::atomic<float>& progress)
+                        float* output,
+                        std::atomic<float>& progress,
+                        float progressBase,
+                        float progressSpan)
     {
         int numChunks = (totalFrames + kChunkStride - 1) / kChunkStride;
+        int groupSize = juce::jlimit(1, juce::jmax(1, numChunks), parallelChunks);
+
+        std::vector<std::unique_ptr<FrameWindow>> windows;
+        for (int i = 0; i < groupSize; ++i)
+            windows.push_back(std::make_unique<FrameWindow>(*fft, FrameWindow::kChunkCapacity));
+
+        FeatureState state;
+        const FrameWindow* previous = windows.back().get();   // empty to start
 
-        for (int ch = 0; ch < numChunks; ++ch)
+        for (int first = 0; first < numChunks; first += groupSize)
         {
-            int outStart = ch * kChunkStride;
-            int outEnd   = juce::jmin(outStart + kChunkStride, totalFrames);
-            int inStart  = juce::jmax(0, outStart - kWarmUp);
-            int S        = outEnd - inStart;   // frames in this chunk
-            int warmOff  = outStart - inStart; // warmup frames to skip
+            const int count = juce::jmin(groupSize, numChunks - first);
 
-            if (S <= 0) continue;
+            for (int i = 0; i < count; ++i)
+            {
+                int ch       = first + i;
+                int outStart = ch * kChunkStride;
+                int outEnd   = juce::jmin(outStart + kChunkStride, totalFrames);
+                int inStart  = juce::jmax(0, outStart - kWarmUp);
+
+                auto& window = *windows[(size_t) i];
+                fillWindow(window, *previous, state, padded, 0, inStart, outEnd);
+                window.warmOff = outStart - inStart; // warmup frames to skip
+                previous = &window;
+            }
 
-            // ── Slice features for this chunk ──
-            std::vector<float> cERB(S * kNbERB);
-            std::vector<float> cSpec(2 * S * kNbDF);
+            AnalysisTaskGraph graph;
+            for (int i = 0; i < count; ++i)
+                graph.addTask("deepfilter chunk " + juce::String(first + i),
+                              [this, &window = *windows[(size_t) i]] { enhanceChunk(window); });
+            graph.run();
 
-            for (int f = 0; f < S; ++f)
+            for (int i = 0; i < count; ++i)
             {
-                int gf = inStart + f;
-                std::copy_n(&featERB[gf * kNbERB],  kNbERB,
-                            &cERB[f * kNbERB]);
-                std::copy_n(&featSpec[gf * kNbDF],   kNbDF,
-                            &cSpec[f * kNbDF]);
-                std::copy_n(&featSpec[totalFrames * kNbDF + gf * kNbDF], kNbDF,
-                            &cSpec[S * kNbDF + f * kNbDF]);
+                auto& window = *windows[(size_t) i];
+                const auto& re = window.inferred ? window.enhRe : window.specRe;
+                const auto& im = window.inferred ? window.enhIm : window.specIm;
+
+                for (int f = window.warmOff; f < window.numFrames; ++f)
+                    synthesizeFrame(window, &re[f * kNbBins], &im[f * kNbBins],
+                                    output, window.firstFrame + f);
             }
 
-            try
+            progress.store(progressBase + progressSpan
+                * static_cast<float>(first + count) / static_cast<float>(numChunks));
+        }
+    }
+
+    /** Inference + ERB mask + deep filtering for one filled window. Touches
+        only the window and the (thread-safe) sessions. On an ONNX error the
+        chunk is left uninferred and passes through unenhanced. */
+    void enhanceChunk(FrameWindow& window)
+    {
+        const int S = window.numFrames;
+        const int warmOff = window.warmOff;
+        if (S <= 0) return;
+
+        // ── Encoder spec input: [channel0 = real][channel1 = imag], each [S, 96] ──
+        std::copy_n(window.featSpecRe.data(), S * kNbDF, window.chunkSpec.data());
+        std::copy_n(window.featSpecIm.data(), S * kNbDF, window.chunkSpec.data() + S * kNbDF);
+
+        try
+        {
+            runInference(window);
+        }
+        catch (const Ort::Exception& e)
+        {
+            DBG("DeepFilter ONNX chunk error: " << e.what());
+            window.inference.boundFrames = -1;
+            return;
+        }
+
+        // ERB mask [1, 1, S, 32], DF coefs [1, S, 96, 10], alpha [1, S, 1]
+        const float* mask  = window.inference.data[maskT].data();
+        const float* coefs = window.inference.data[coefsT].data();
+        const float* alphas = window.inference.data[alphaT].data();
+
+        const auto& specRe = window.specRe;
+        const auto& specIm = window.specIm;
+        auto& localRe = window.localRe;
+        auto& localIm = window.localIm;
+        auto& enhRe = window.enhRe;
+        auto& enhIm = window.enhIm;
+
+        // ── Apply ERB mask to LOCAL cache for ALL chunk frames ──
+        // We need all frames (including warmup) available for DF taps
+        for (int f = 0; f < S; ++f)
+        {
+            int lOff = f * kNbBins;
+
+            for (int b = 0; b < kNbERB; ++b)
             {
-                // ── Encoder ──
-                auto enc = runEncoder(cERB, cSpec, S);
+                float gain = mask[f * kNbERB + b];
+                int bs = erbBandOffsets[b], be = erbBandOffsets[b + 1];
+                juce::FloatVectorOperations::copyWithMultiply(&localRe[lOff + bs], &specRe[lOff + bs], gain, be - bs);
+                juce::FloatVectorOperations::copyWithMultiply(&localIm[lOff + bs], &specIm[lOff + bs], gain, be - bs);
+            }
+        }
 
-                // ── ERB decoder → mask [1, 1, S, 32] ──
-                auto mask = runERBDecoder(enc.emb, enc.e3, enc.e2, enc.e1, enc.e0,
-                                          enc.embShape, enc.e3Shape, enc.e2Shape,
-                                          enc.e1Shape, enc.e0Shape);
+        // ── Deep filtering (only usable frames) ──
+        for (int f = warmOff; f < S; ++f)
+        {
+            int lOff = f * kNbBins;
 
-                // ── DF decoder → coefs [1, S, 96, 10], alpha [1, S, 1] ──
-                auto df = runDFDecoder(enc.emb, enc.c0,
-                                       enc.embShape, enc.c0Shape);
+            // ERB-masked result for bins >= kNbDF (DF doesn't touch these)
+            std::copy_n(&localRe[lOff + kNbDF], kNbBins - kNbDF, &enhRe[lOff + kNbDF]);
+            std::copy_n(&localIm[lOff + kNbDF], kNbBins - kNbDF, &enhIm[lOff + kNbDF]);
 
-                // ── Apply ERB mask to LOCAL cache for ALL chunk frames ──
-                // We need all frames (including warmup) available for DF taps
-                // Local cache: all 481 bins per frame, stored as [S][kNbBins]
-                std::vector<float> localRe(S * kNbBins);
-                std::vector<float> localIm(S * kNbBins);
+            // Alpha blending factor from df_dec (sigmoid output)
+            float alpha = alphas[f];
 
-                for (int f = 0; f < S; ++f)
-                {
-                    int gf   = inStart + f;
-                    int gOff = gf * kNbBins;
-                    int lOff = f * kNbBins;
-
-                    for (int b = 0; b < kNbERB; ++b)
-                    {
-                        float gain = mask[f * kNbERB + b];
-                        int bs = erbBandOffsets[b], be = erbBandOffsets[b + 1];
-                        for (int k = bs; k < be; ++k)
-                        {
-                            localRe[lOff + k] = specRe[gOff + k] * gain;
-                            localIm[lOff + k] = specIm[gOff + k] * gain;
-                        }
-                    }
-                }
+            for (int k = 0; k < kNbDF; ++k)
+            {
+                float dfRe = 0.0f, dfIm = 0.0f;
 
-                // ── Deep filtering (only usable frames written to output) ──
-                for (int f = warmOff; f < S; ++f)
+                for (int tap = 0; tap < kDFOrder; ++tap)
                 {
-                    int gf   = inStart + f;
-                    int gOff = gf * kNbBins;
-                    int lOff = f * kNbBins;
-
-                    // Write ERB-masked result for bins >= kNbDF (DF doesn't touch these)
-                    for (int k = kNbDF; k < kNbBins; ++k)
-                    {
-                        enhRe[gOff + k] = localRe[lOff + k];
-                        enhIm[gOff + k] = localIm[lOff + k];
-                    }
-
-                    // Alpha blending factor from df_dec (sigmoid output)
-                    float alpha = (f < static_cast<int>(df.alpha.size()))
-                                  ? df.alpha[f] : 0.5f;
-
-                    for (int k = 0; k < kNbDF; ++k)
-                    {
-                        float dfRe = 0.0f, dfIm = 0.0f;
-
-                        for (int tap = 0; tap < kDFOrder; ++tap)
-                        {
-                            // FIX: Correct tap order matching Rust reference
-                            // tap 0 → future frame (f + lookahead)
-                            // tap 4 → past frame (f + lookahead - 4 = f - 2)
-                            int srcLocalF = f + kDFLookahead - tap;
-                            if (srcLocalF < 0 || srcLocalF >= S) continue;
-
-                            float sRe = localRe[srcLocalF * kNbBins + k];
-                            float sIm = localIm[srcLocalF * kNbBins + k];
-
-                            // coefs layout: [S, 96, 10] → 10 = 5 taps × (re,im)
-                            int ci = f * kNbDF * (kDFOrder * 2)
-                                   + k * (kDFOrder * 2) + tap * 2;
-                            float cRe = df.coefs[ci];
-                            float cIm = df.coefs[ci + 1];
-
-                            // Complex multiply: coef × source
-                            dfRe += cRe * sRe - cIm * sIm;
-                            dfIm += cRe * sIm + cIm * sRe;
-                        }
-
-                        // Blend DF result with ERB-only result
-                        float eRe = localRe[lOff + k];
-                        float eIm = localIm[lOff + k];
-                        enhRe[gOff + k] = alpha * dfRe + (1.0f - alpha) * eRe;
-                        enhIm[gOff + k] = alpha * dfIm + (1.0f - alpha) * eIm;
-                    }
+                    // FIX: Correct tap order matching Rust reference
+                    // tap 0 → future frame (f + lookahead)
+                    // tap 4 → past frame (f + lookahead - 4 = f - 2)
+                    int srcLocalF = f + kDFLookahead - tap;
+                    if (srcLocalF < 0 || srcLocalF >= S) continue;
+
+                    float sRe = localRe[srcLocalF * kNbBins + k];
+                    float sIm = localIm[srcLocalF * kNbBins + k];
+
+                    // coefs layout: [S, 96, 10] → 10 = 5 taps × (re,im)
+                    int ci = f * kNbDF * (kDFOrder * 2)
+                           + k * (kDFOrder * 2) + tap * 2;
+                    float cRe = coefs[ci];
+                    float cIm = coefs[ci + 1];
+
+                    // Complex multiply: coef × source
+                    dfRe += cRe * sRe - cIm * sIm;
+                    dfIm += cRe * sIm + cIm * sRe;
                 }
-            }
-            catch (const Ort::Exception& e)
-            {
-                DBG("DeepFilter ONNX chunk error: " << e.what());
-            }
 
-            progress.store(0.10f + 0.85f
-                * static_cast<float>(ch + 1) / static_cast<float>(numChunks));
+                // Blend DF result with ERB-only result
+                float eRe = localRe[lOff + k];
+                float eIm = localIm[lOff + k];
+                enhRe[lOff + k] = alpha * dfRe + (1.0f - alpha) * eRe;
+                enhIm[lOff + k] = alpha * dfIm + (1.0f - alpha) * eIm;
+            }
         }
+
+        window.inferred = true;
     }
 
     //==========================================================================
-    // ONNX inference helpers
+    // ONNX inference — IoBinding over the window's preallocated buffers
     //==========================================================================
 
-    /** Container for encoder outputs + their shapes (for decoder inputs). */
-    struct EncOut
+    /** Bind every tensor for the window's frame count. Rebuilt only when
+        that count changes (first and last chunk of a file). */
+    void bindChunk(FrameWindow& window)
     {
-        std::vector<float> e0, e1, e2, e3, emb, c0, lsnr;
-        std::vector<int64_t> e0Shape, e1Shape, e2Shape, e3Shape;
-        std::vector<int64_t> embShape, c0Shape;
-    };
+        auto& inf = window.inference;
+        const int S = window.numFrames;
+        if (inf.boundFrames == S)
+            return;
+
+        inf.boundFrames = -1;
+        inf.enc.reset();
+        inf.erbDec.reset();
+        inf.dfDec.reset();
+        inf.values.clear();
+        inf.values.reserve(numTensors);
+
+        std::array<Ort::Value*, numTensors> values {};
+        for (int t = 0; t < numTensors; ++t)
+        {
+            const auto& spec = tensorSpec(t);
+            auto shape = spec.shape;
+            for (size_t d = 0; d < spec.rank; ++d)
+                if (shape[d] < 0) shape[d] = S;
+
+            float* data = t == featErbT  ? window.featERB.data()
+                        : t == featSpecT ? window.chunkSpec.data()
+                                         : inf.data[(size_t) t].data();
+
+            inf.values.push_back(Ort::Value::CreateTensor<float>(
+                memInfo, data, tensorValuesPerFrame(t) * static_cast<size_t>(S),
+                shape.data(), spec.rank));
+            values[(size_t) t] = &inf.values.back();
+        }
+
+        auto bind = [&values](Ort::IoBinding& binding,
+                              std::initializer_list<int> inputs,
+                              std::initializer_list<int> outputs)
+        {
+            for (int t : inputs)  binding.BindInput(tensorSpec(t).name, *values[(size_t) t]);
+            for (int t : outputs) binding.BindOutput(tensorSpec(t).name, *values[(size_t) t]);
+        };
+
+        inf.enc    = std::make_unique<Ort::IoBinding>(*encSession);
+        inf.erbDec = std::make_unique<Ort::IoBinding>(*erbDecSession);
+        inf.dfDec  = std::make_unique<Ort::IoBinding>(*dfDecSession);
+
+        bind(*inf.enc,    { featErbT, featSpecT }, { e0T, e1T, e2T, e3T, embT, c0T, lsnrT });
+        bind(*inf.erbDec, { embT, e3T, e2T, e1T, e0T }, { maskT });
+        bind(*inf.dfDec,  { embT, c0T }, { coefsT, alphaT });
 
-    EncOut runEncoder(const std::vector<float>& erbFeat,
-                      const std::vector<float>& specFeat,
-                      int S)
+        inf.boundFrames = S;
+    }
+
+    /** enc → erb_dec + df_dec on the window's features; results land in
+        window.inference.data. */
+    void runInference(FrameWindow& window)
     {
-        int64_t erbDims[]  = {1, 1, static_cast<int64_t>(S), kNbERB};
-        int64_t specDims[] = {1, 2, static_cast<int64_t>(S), kNbDF};
+        bindChunk(window);
 
-        auto erbT  = Ort::Value::CreateTensor<float>(
-            memInfo, const_cast<float*>(erbFeat.data()),
-            erbFeat.size(), erbDims, 4);
-        auto specT = Ort::Value::CreateTensor<float>(
-            memInfo, const_cast<float*>(specFeat.data()),
-            specFeat.size(), specDims, 4);
+        auto& inf = window.inference;
+        encSession->Run(Ort::RunOptions{nullptr}, *inf.enc);
+        erbDecSession->Run(Ort::RunOptions{nullptr}, *inf.erbDec);
+        dfDecSession->Run(Ort::RunOptions{nullptr}, *inf.dfDec);
+    }
 
-        const char* inNames[]  = {"feat_erb", "feat_spec"};
-        const char* outNames[] = {"e0","e1","e2","e3","emb","c0","lsnr"};
+    /** False if a model declares an input whose fixed dims differ from
+        tensorSpec (a different DFN export than the one bundled). */
+    static bool inputShapesMatch(Ort::Session& session)
+    {
+        Ort::AllocatorWithDefaultOptions allocator;
+        for (size_t i = 0; i < session.GetInputCount(); ++i)
+        {
+            const auto name = session.GetInputNameAllocated(i, allocator);
+            const auto declared = session.GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
 
-        std::vector<Ort::Value> inputs;
-        inputs.push_back(std::move(erbT));
-        inputs.push_back(std::move(specT));
+            for (int t = 0; t < numTensors; ++t)
+            {
+                const auto& spec = tensorSpec(t);
+                if (std::strcmp(spec.name, name.get()) != 0)
+                    continue;
 
-        auto outs = encSession->Run(Ort::RunOptions{nullptr},
-            inNames, inputs.data(), 2, outNames, 7);
+                if (declared.size() != spec.rank)
+                    return false;
 
-        auto grab = [](Ort::Value& v) -> std::pair<std::vector<float>, std::vector<int64_t>> {
-            auto info = v.GetTensorTypeAndShapeInfo();
-            auto shape = info.GetShape();
-            size_t n = info.GetElementCount();
-            const float* p = v.GetTensorData<float>();
-            return { std::vector<float>(p, p + n), shape };
-        };
+                for (size_t d = 0; d < spec.rank; ++d)
+                    if (declared[d] >= 0 && spec.shape[d] >= 0 && declared[d] != spec.shape[d])
+                        return false;
+            }
+        }
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeepFilterProcessor)
+};
 
-        EncOut r;
-        auto [d0, s0] = grab(outs[0]); r.e0 = std::move(d0); r.e0Shape = std::move(s0);
-        auto [d1, s1] = grab(outs[1]); r.e1 = std::move(d1); r.e1Shape = std::move(s1);
-        auto [d2, s2] = grab(outs[2]); r.e2 = std::move(d2); r.e2Shape = std::move(s2);
-        auto [d3, s3] = grab(outs[3]); r.e3 = std::move(d3); r.e3Shape = std::move(s3);
-        auto [de, se] = grab(outs[4]); r.emb = std::move(de); r.embShape = std::move(se);
-        auto [dc, sc] = grab(outs[5]); r.c0 = std::move(dc); r.c0Shape = std::move(sc);
-        { auto info = outs[6].GetTensorTypeAndShapeInfo();
-          size_t n = info.GetElementCount();
-          const float* p = outs[6].GetTensorData<float>();
-          r.lsnr.assign(p, p + n); }
-
-        return r;
+//==============================================================================
+/**
+    One 48 kHz channel through DFN3 as it arrives: pushHop() 480 samples
+    at a time, popHop() enhanced hops back in the same order, the first
+    one enhancing the first hop pushed.
+
+    The bundled ONNX exports run whole sequences and expose no GRU state
+    tensors, so recurrent state can't be handed from one run to the next.
+    The stream keeps what it can carry instead: the feature normalisation
+    state exactly, plus the last contextFrames frames, which are re-run as
+    warm-up ahead of every new block of blockFrames hops (the way each
+    offline chunk warms up over kWarmUp frames). Each run infers
+    context + block + kDFLookahead frames for blockFrames of output.
+
+    An enhanced hop is ready kDFLookahead + 1 hops after it was pushed at
+    the earliest and kDFLookahead + blockFrames hops at the latest
+    (getMaxLatencyHops()), depending on where it falls in its block.
+
+    Not thread safe: one thread pushes and pops. Streams only read their
+    DeepFilterProcessor, so several of them can share one.
+*/
+class DeepFilterProcessor::FrameStream
+{
+public:
+    struct Options
+    {
+        int blockFrames   = 4;      // hops per inference run
+        int contextFrames = 32;     // emitted frames re-run as warm-up
+    };
+
+    explicit FrameStream(DeepFilterProcessor& processorToUse)
+        : FrameStream(processorToUse, Options {})
+    {
     }
 
-    /** ERB decoder → gains mask [1, 1, S, 32], values in [0,1]. */
-    std::vector<float> runERBDecoder(
-        const std::vector<float>& emb,
-        const std::vector<float>& e3,
-        const std::vector<float>& e2,
-        const std::vector<float>& e1,
-        const std::vector<float>& e0,
-        const std::vector<int64_t>& embShape,
-        const std::vector<int64_t>& e3Shape,
-        const std::vector<int64_t>& e2Shape,
-        const std::vector<int64_t>& e1Shape,
-        const std::vector<int64_t>& e0Shape)
-    {
-        auto mkT = [&](const std::vector<float>& d, const std::vector<int64_t>& sh) {
-            return Ort::Value::CreateTensor<float>(
-                memInfo, const_cast<float*>(d.data()), d.size(),
-                sh.data(), sh.size());
-        };
+    FrameStream(DeepFilterProcessor& processorToUse, const Options& options)
+        : processor(processorToUse),
+          blockFrames(juce::jmax(1, options.blockFrames)),
+          contextFrames(juce::jmax(kDFOrder, options.contextFrames)),
+          window(*processorToUse.fft, contextFrames + blockFrames + kDFLookahead),
+          blockSamples(static_cast<size_t>((blockFrames + 1) * kHopSize)),
+          ready(static_cast<size_t>(2 * (blockFrames + kDFLookahead) * kHopSize))
+    {
+        jassert(processor.isInitialized());
+        reset();
+    }
 
-        std::vector<Ort::Value> ins;
-        ins.push_back(mkT(emb, embShape));
-        ins.push_back(mkT(e3, e3Shape));
-        ins.push_back(mkT(e2, e2Shape));
-        ins.push_back(mkT(e1, e1Shape));
-        ins.push_back(mkT(e0, e0Shape));
+    /** Back to silence: no history, nothing ready. */
+    void reset()
+    {
+        state = {};
+        window.firstFrame = 0;
+        window.numFrames = 0;
+        window.inferred = false;
+
+        // The first frame starts half a frame early, on kHopSize of silence,
+        // as the offline path zero-pads the file
+        std::fill(blockSamples.begin(), blockSamples.end(), 0.0f);
+        bufferedHops = 1;
+        nextFrame = 0;
+        emitStart = 0;
+        overlap.fill(0.0f);
+        readyStart = 0;
+        readyHops = 0;
+    }
 
-        const char* inN[] = {"emb","e3","e2","e1","e0"};
-        const char* outN[] = {"m"};
+    int getBlockFrames() const noexcept      { return blockFrames; }
+    int getMaxLatencyHops() const noexcept   { return kDFLookahead + blockFrames; }
 
-        auto outs = erbDecSession->Run(Ort::RunOptions{nullptr},
-            inN, ins.data(), 5, outN, 1);
+    /** Hops popHop() can return now. */
+    int getNumReadyHops() const noexcept     { return readyHops; }
 
-        auto info = outs[0].GetTensorTypeAndShapeInfo();
-        size_t n = info.GetElementCount();
-        const float* p = outs[0].GetTensorData<float>();
-        return std::vector<float>(p, p + n);
+    /** Add kHopSize samples; every blockFrames-th call runs inference. */
+    void pushHop(const float* samples)
+    {
+        std::copy_n(samples, kHopSize, blockSamples.data() + bufferedHops * kHopSize);
+        if (++bufferedHops <= blockFrames)
+            return;
+
+        runBlock();
+
+        // The block's last hop is the first half of the next block's first frame
+        std::copy_n(blockSamples.data() + blockFrames * kHopSize, kHopSize, blockSamples.data());
+        bufferedHops = 1;
     }
 
-    /** DF decoder output container. */
-    struct DFOut
+    /** Oldest ready enhanced hop into dest (kHopSize samples); false if none. */
+    bool popHop(float* dest)
     {
-        std::vector<float> coefs;  // [1, S, 96, 10]
-        std::vector<float> alpha;  // [1, S, 1] → flattened to [S]
-    };
+        if (readyHops == 0)
+            return false;
+
+        std::copy_n(ready.data() + readyStart * kHopSize, kHopSize, dest);
+        readyStart = (readyStart + 1) % getReadyCapacity();
+        --readyHops;
+        return true;
+    }
 
-    DFOut runDFDecoder(
-        const std::vector<float>& emb,
-        const std::vector<float>& c0,
-        const std::vector<int64_t>& embShape,
-        const std::vector<int64_t>& c0Shape)
+private:
+    /** Analyse the buffered block, enhance everything whose lookahead is
+        now known, overlap-add it into the ready queue. */
+    void runBlock()
     {
-        auto mkT = [&](const std::vector<float>& d, const std::vector<int64_t>& sh) {
-            return Ort::Value::CreateTensor<float>(
-                memInfo, const_cast<float*>(d.data()), d.size(),
-                sh.data(), sh.size());
-        };
+        const int end = nextFrame + blockFrames;
+        const int inStart = juce::jmax(0, end - window.capacity);
+        processor.fillWindow(window, window, state, blockSamples.data(), nextFrame, inStart, end);
+        nextFrame = end;
+
+        // DF taps reach kDFLookahead frames ahead: those wait for the next block
+        const int emitEnd = end - kDFLookahead;
+        if (emitEnd <= emitStart)
+            return;
+
+        window.warmOff = emitStart - inStart;
+        processor.enhanceChunk(window);
+
+        const auto& re = window.inferred ? window.enhRe : window.specRe;
+        const auto& im = window.inferred ? window.enhIm : window.specIm;
 
-        std::vector<Ort::Value> ins;
-        ins.push_back(mkT(emb, embShape));
-        ins.push_back(mkT(c0, c0Shape));
+        for (int gf = emitStart; gf < emitEnd; ++gf)
+        {
+            const int slot = gf - inStart;
+            processor.synthesizeFrame(window, &re[slot * kNbBins], &im[slot * kNbBins], overlap.data(), 0);
+
+            // The first half of the overlap is final now; frame 0's is the pad
+            if (gf > 0)
+                pushReady(overlap.data());
 
-        const char* inN[] = {"emb","c0"};
-        const char* outN[] = {"coefs","235"};
+            std::copy(overlap.begin() + kHopSize, overlap.end(), overlap.begin());
+            std::fill(overlap.begin() + kHopSize, overlap.end(), 0.0f);
+        }
 
-        auto outs = dfDecSession->Run(Ort::RunOptions{nullptr},
-            inN, ins.data(), 2, outN, 2);
+        emitStart = emitEnd;
+    }
 
-        DFOut r;
-        { auto info = outs[0].GetTensorTypeAndShapeInfo();
-          size_t n = info.GetElementCount();
-          const float* p = outs[0].GetTensorData<float>();
-          r.coefs.assign(p, p + n); }
-        { auto info = outs[1].GetTensorTypeAndShapeInfo();
-          size_t n = info.GetElementCount();
-          const float* p = outs[1].GetTensorData<float>();
-          r.alpha.assign(p, p + n); }
+    void pushReady(const float* hop)
+    {
+        // A caller that stops popping loses the oldest hops, not the newest
+        if (readyHops == getReadyCapacity())
+        {
+            jassertfalse;
+            readyStart = (readyStart + 1) % getReadyCapacity();
+            --readyHops;
+        }
 
-        return r;
+        const int slot = (readyStart + readyHops) % getReadyCapacity();
+        std::copy_n(hop, kHopSize, ready.data() + slot * kHopSize);
+        ++readyHops;
     }
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeepFilterProcessor)
+    int getReadyCapacity() const noexcept    { return static_cast<int>(ready.size()) / kHopSize; }
+
+    DeepFilterProcessor& processor;
+    const int blockFrames;
+    const int contextFrames;
+
+    FrameWindow window;
+    FeatureState state;
+    std::vector<float> blockSamples;        // (blockFrames + 1) hops: frames [nextFrame, +blockFrames)
+    int bufferedHops = 1;
+    int nextFrame = 0;                      // frames analysed so far
+    int emitStart = 0;                      // first frame not yet overlap-added
+
+    std::array<float, kFFTSize> overlap {};
+    std::vector<float> ready;               // ring of finished hops
+    int readyStart = 0;
+    int readyHops = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(FrameStream)
 };
@@ -0,0 +1,418 @@
+/*
+  ==============================================================================
+    DeepFilterRealtime.h
+    GOODMETER - Live DeepFilterNet3 denoising behind the audio thread
+
+    Architecture:
+      - process() (audio thread) copies the block into a lock-free input
+        FIFO and replaces it, in place, with enhanced samples from an
+        output FIFO — two copies per channel, no inference, no locks
+      - An inference thread drains whole hops from the input FIFO into one
+        DeepFilterProcessor::FrameStream per channel and writes the
+        enhanced hops (blended with the time-aligned dry signal) to the
+        output FIFO
+      - The output FIFO starts with getLatencySamples() of silence, which
+        covers the stream's lookahead and block batching plus one block of
+        inference time; report it with AudioProcessor::setLatencySamples()
+
+    If the thread falls behind, the audio thread plays silence for the
+    missing samples and skips as many once the thread has caught up, so
+    the delay stays at getLatencySamples() instead of creeping.
+
+    At other host rates the thread converts to DFN3's 48 kHz and back
+    with streaming PolyphaseResamplers; their lookahead is part of the
+    reported latency.
+
+    Thread safety model:
+      - prepare()/release() and the setters: message thread
+      - process(): audio thread, lock-free, no allocation
+      - The FrameStreams are owned by the inference thread
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DeepFilterProcessor.h"
+#include "PolyphaseResampler.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+class DeepFilterRealtime : private juce::Thread
+{
+public:
+    static constexpr int kMaxChannels = 2;
+
+    /** processor must be initialised and outlive this object. */
+    explicit DeepFilterRealtime(DeepFilterProcessor& processorToUse)
+        : Thread("GOODMETER-DeepFilter"),
+          processor(processorToUse)
+    {
+    }
+
+    ~DeepFilterRealtime() override
+    {
+        release();
+    }
+
+    //==========================================================================
+    /** (Re)start from silence. Call from prepareToPlay; false (and
+     *  process() passes audio through) if the processor isn't ready. */
+    bool prepare(double sampleRate, int maxBlockSize, int numChannelsToUse,
+                 const DeepFilterProcessor::FrameStream::Options& streamOptions = {})
+    {
+        release();
+
+        if (! processor.isInitialized() || sampleRate <= 0.0)
+            return false;
+
+        numChannels = juce::jlimit(1, kMaxChannels, numChannelsToUse);
+        for (int ch = 0; ch < numChannels; ++ch)
+            streams[(size_t) ch] = std::make_unique<DeepFilterProcessor::FrameStream>(processor, streamOptions);
+
+        const int blockFrames = streams[0]->getBlockFrames();
+        blockBudgetMs = 1000.0 * blockFrames * hopSize / DeepFilterProcessor::getStreamSampleRate();
+
+        // Lookahead + a whole block waiting for its last hop, one more block
+        // for the thread to infer it, a hop of polling slack (all at 48 kHz),
+        // the resamplers' lookahead, and the host block
+        const double modelRate = DeepFilterProcessor::getStreamSampleRate();
+        const bool convert = std::abs(sampleRate - modelRate) > 0.5;
+        int modelLatency = (streams[0]->getMaxLatencyHops() + blockFrames + 1) * hopSize;
+        int hostLatency = juce::jmax(1, maxBlockSize);
+
+        toModel.reset();
+        fromModel.reset();
+        if (convert)
+        {
+            toModel = std::make_unique<PolyphaseResampler>(sampleRate, modelRate, numChannels, convertBlock);
+            fromModel = std::make_unique<PolyphaseResampler>(modelRate, sampleRate, numChannels, hopSize);
+            hostLatency += toModel->getLatencyInputSamples() + 1;
+            modelLatency += fromModel->getLatencyInputSamples() + 1;
+
+            const auto maxModelSamples = static_cast<size_t>(hopSize + toModel->getMaxOutputSamples(convertBlock));
+            const auto maxHostSamples = static_cast<size_t>(fromModel->getMaxOutputSamples(hopSize));
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                hostIn[(size_t) ch].assign(static_cast<size_t>(convertBlock), 0.0f);
+                modelIn[(size_t) ch].assign(maxModelSamples, 0.0f);
+                hostOut[(size_t) ch].assign(maxHostSamples, 0.0f);
+            }
+        }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                modelIn[(size_t) ch].assign(static_cast<size_t>(hopSize), 0.0f);
+        }
+        modelFill = 0;
+
+        latencySamples = static_cast<int>(std::ceil(modelLatency * sampleRate / modelRate)) + hostLatency;
+
+        fifoSize = juce::nextPowerOfTwo(2 * latencySamples + 4 * juce::jmax(1, maxBlockSize));
+        inputFifo.setTotalSize(fifoSize);
+        outputFifo.setTotalSize(fifoSize);
+        inputData.assign(static_cast<size_t>(numChannels * fifoSize), 0.0f);
+        outputData.assign(static_cast<size_t>(numChannels * fifoSize), 0.0f);
+
+        // Dry ring: every hop still inside a stream, plus the one in flight
+        dryHops = streams[0]->getMaxLatencyHops() + 2;
+        dryData.assign(static_cast<size_t>(numChannels * dryHops * hopSize), 0.0f);
+        dryWriteHop = dryReadHop = 0;
+
+        // The delay the host is told about, as silence up front
+        inputFifo.reset();
+        outputFifo.reset();
+        int start1, size1, start2, size2;
+        outputFifo.prepareToWrite(latencySamples, start1, size1, start2, size2);
+        outputFifo.finishedWrite(size1 + size2);
+
+        outputDebt = 0;
+        underruns.store(0, std::memory_order_relaxed);
+        droppedSamples.store(0, std::memory_order_relaxed);
+        lateBlocks.store(0, std::memory_order_relaxed);
+        worstBlockMs.store(0.0f, std::memory_order_relaxed);
+
+        active.store(true, std::memory_order_release);
+        startThread(juce::Thread::Priority::high);
+        return true;
+    }
+
+    /** Stop the thread; process() passes audio through. */
+    void release()
+    {
+        active.store(false, std::memory_order_release);
+        if (isThreadRunning())
+            stopThread(2000);
+
+        for (auto& stream : streams)
+            stream.reset();
+    }
+
+    bool isActive() const noexcept            { return active.load(std::memory_order_acquire); }
+
+    /** Fixed input → output delay in samples while active. */
+    int getLatencySamples() const noexcept    { return isActive() ? latencySamples : 0; }
+
+    /** 1.0 = fully denoised, 0.0 = dry (still delayed). */
+    void setWetDry(float wet) noexcept        { wetDry.store(juce::jlimit(0.0f, 1.0f, wet), std::memory_order_relaxed); }
+
+    //==========================================================================
+    struct Stats
+    {
+        int underruns = 0;          // callbacks that played silence for missing samples
+        int droppedSamples = 0;     // input samples lost to a full FIFO
+        int lateBlocks = 0;         // inference runs slower than the audio they cover
+        float worstBlockMs = 0.0f;
+    };
+
+    Stats getStats() const noexcept
+    {
+        return { underruns.load(std::memory_order_relaxed),
+                 droppedSamples.load(std::memory_order_relaxed),
+                 lateBlocks.load(std::memory_order_relaxed),
+                 worstBlockMs.load(std::memory_order_relaxed) };
+    }
+
+    //==========================================================================
+    /** Audio thread: denoise the first prepared channels of the block in
+     *  place (any further channels are left alone). Lock-free, no allocation. */
+    void process(float* const* channelData, int numChannelsInBlock, int numSamples) noexcept
+    {
+        const int channels = juce::jmin(numChannels, numChannelsInBlock);
+        if (! active.load(std::memory_order_acquire) || numSamples <= 0 || channels <= 0)
+            return;
+
+        // ── In: whatever fits; lost input means that much less output later ──
+        int start1, size1, start2, size2;
+        inputFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* src = channelData[juce::jmin(ch, channels - 1)];
+            float* fifo = inputData.data() + ch * fifoSize;
+            std::copy_n(src, size1, fifo + start1);
+            std::copy_n(src + size1, size2, fifo + start2);
+        }
+        inputFifo.finishedWrite(size1 + size2);
+
+        if (const int lost = numSamples - (size1 + size2); lost > 0)
+        {
+            droppedSamples.fetch_add(lost, std::memory_order_relaxed);
+            outputDebt -= lost;
+        }
+
+        // ── Catch up on silence played earlier, without starving this block ──
+        if (outputDebt > 0)
+        {
+            const int spare = outputFifo.getNumReady() - numSamples;
+            if (spare > 0)
+            {
+                const int skip = juce::jmin(spare, outputDebt);
+                outputFifo.prepareToRead(skip, start1, size1, start2, size2);
+                outputFifo.finishedRead(size1 + size2);
+                outputDebt -= size1 + size2;
+            }
+        }
+
+        // ── Out ──
+        outputFifo.prepareToRead(numSamples, start1, size1, start2, size2);
+        const int got = size1 + size2;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            const float* fifo = outputData.data() + ch * fifoSize;
+            float* dst = channelData[ch];
+            std::copy_n(fifo + start1, size1, dst);
+            std::copy_n(fifo + start2, size2, dst + size1);
+            std::fill(dst + got, dst + numSamples, 0.0f);
+        }
+        outputFifo.finishedRead(got);
+
+        if (got < numSamples)
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            outputDebt += numSamples - got;
+        }
+    }
+
+private:
+    static constexpr int hopSize = DeepFilterProcessor::getStreamHopSize();
+
+    //==========================================================================
+    // Thread: whole hops in, enhanced hops out
+    //==========================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (toModel != nullptr)
+            {
+                convertInput();
+            }
+            else
+            {
+                while (inputFifo.getNumReady() >= hopSize && ! threadShouldExit())
+                {
+                    readHostSamples(modelIn, 0, hopSize);
+                    processHop();
+                }
+            }
+
+            wait(2);    // well under one hop (10 ms)
+        }
+    }
+
+    /** Planar FIFO → dest[ch] + offset, numSamples of each channel. */
+    void readHostSamples(std::array<std::vector<float>, kMaxChannels>& dest, int offset, int numSamples)
+    {
+        int start1, size1, start2, size2;
+        inputFifo.prepareToRead(numSamples, start1, size1, start2, size2);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* fifo = inputData.data() + ch * fifoSize;
+            float* dst = dest[(size_t) ch].data() + offset;
+            std::copy_n(fifo + start1, size1, dst);
+            std::copy_n(fifo + start2, size2, dst + size1);
+        }
+        inputFifo.finishedRead(size1 + size2);
+    }
+
+    /** Host-rate input → 48 kHz, one hop through the streams at a time. */
+    void convertInput()
+    {
+        while (inputFifo.getNumReady() > 0 && ! threadShouldExit())
+        {
+            const int numIn = juce::jmin(inputFifo.getNumReady(), convertBlock);
+            readHostSamples(hostIn, 0, numIn);
+
+            std::array<const float*, kMaxChannels> in {};
+            std::array<float*, kMaxChannels> out {};
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                in[(size_t) ch] = hostIn[(size_t) ch].data();
+                out[(size_t) ch] = modelIn[(size_t) ch].data() + modelFill;
+            }
+            modelFill += toModel->process(in.data(), numIn, out.data(),
+                                          static_cast<int>(modelIn[0].size()) - modelFill);
+
+            int used = 0;
+            for (; modelFill - used >= hopSize; used += hopSize)
+                processHop(used);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::copy(modelIn[(size_t) ch].begin() + used, modelIn[(size_t) ch].begin() + modelFill,
+                          modelIn[(size_t) ch].begin());
+            modelFill -= used;
+        }
+    }
+
+    /** One 48 kHz hop (modelIn[ch] + offset) through every stream; whatever
+        comes out, blended with the matching dry hop, goes to the output FIFO. */
+    void processHop(int offset = 0)
+    {
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* hop = modelIn[(size_t) ch].data() + offset;
+            std::copy_n(hop, hopSize, dryData.data() + (ch * dryHops + dryWriteHop) * hopSize);
+            streams[(size_t) ch]->pushHop(hop);
+        }
+        dryWriteHop = (dryWriteHop + 1) % dryHops;
+
+        // Every stream got the same hops, so they have the same number ready
+        const float wet = wetDry.load(std::memory_order_relaxed);
+        const int readyHops = streams[0]->getNumReadyHops();
+        for (int h = 0; h < readyHops; ++h)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto& enhanced = hopOut[(size_t) ch];
+                streams[(size_t) ch]->popHop(enhanced.data());
+
+                const float* dry = dryData.data() + (ch * dryHops + dryReadHop) * hopSize;
+                juce::FloatVectorOperations::multiply(enhanced.data(), wet, hopSize);
+                juce::FloatVectorOperations::addWithMultiply(enhanced.data(), dry, 1.0f - wet, hopSize);
+            }
+            dryReadHop = (dryReadHop + 1) % dryHops;
+
+            if (fromModel != nullptr)
+            {
+                std::array<const float*, kMaxChannels> in {};
+                std::array<float*, kMaxChannels> out {};
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    in[(size_t) ch] = hopOut[(size_t) ch].data();
+                    out[(size_t) ch] = hostOut[(size_t) ch].data();
+                }
+                const int made = fromModel->process(in.data(), hopSize, out.data(),
+                                                    static_cast<int>(hostOut[0].size()));
+                writeOutput(hostOut, made);
+            }
+            else
+            {
+                writeOutput(hopOut, hopSize);
+            }
+        }
+
+        if (readyHops > 0)
+        {
+            const auto elapsedMs = static_cast<float>(juce::Time::getMillisecondCounterHiRes() - startMs);
+            if (elapsedMs > worstBlockMs.load(std::memory_order_relaxed))
+                worstBlockMs.store(elapsedMs, std::memory_order_relaxed);
+            if (elapsedMs > blockBudgetMs)
+                lateBlocks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename Channels>
+    void writeOutput(const Channels& source, int numSamples)
+    {
+        // A full FIFO means the audio thread stopped pulling; drop the tail
+        int start1, size1, start2, size2;
+        outputFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* src = source[(size_t) ch].data();
+            float* fifo = outputData.data() + ch * fifoSize;
+            std::copy_n(src, size1, fifo + start1);
+            std::copy_n(src + size1, size2, fifo + start2);
+        }
+        outputFifo.finishedWrite(size1 + size2);
+    }
+
+    //==========================================================================
+    DeepFilterProcessor& processor;
+    std::array<std::unique_ptr<DeepFilterProcessor::FrameStream>, kMaxChannels> streams;
+    int numChannels = 1;
+    int latencySamples = 0;
+    double blockBudgetMs = 0.0;
+
+    std::atomic<bool> active { false };
+    std::atomic<float> wetDry { 1.0f };
+
+    // Planar [channel][fifoSize], one AbstractFifo per direction
+    int fifoSize = 0;
+    juce::AbstractFifo inputFifo { 1 };
+    juce::AbstractFifo outputFifo { 1 };
+    std::vector<float> inputData, outputData;
+    int outputDebt = 0;                         // audio thread: silence played, not yet skipped
+
+    // Inference thread only
+    static constexpr int convertBlock = 4096;  // host samples per conversion pass
+    std::unique_ptr<PolyphaseResampler> toModel, fromModel;     // only off 48 kHz
+    std::array<std::vector<float>, kMaxChannels> hostIn, modelIn, hostOut;
+    int modelFill = 0;                          // 48 kHz samples waiting in modelIn
+    std::array<std::array<float, hopSize>, kMaxChannels> hopOut {};
+
+    std::vector<float> dryData;                 // [channel][dryHops][hopSize]
+    int dryHops = 0, dryWriteHop = 0, dryReadHop = 0;
+
+    std::atomic<int> underruns { 0 };
+    std::atomic<int> droppedSamples { 0 };
+    std::atomic<int> lateBlocks { 0 };
+    std::atomic<float> worstBlockMs { 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeepFilterRealtime)
+};
@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+    DriftBridgeBenchmark.h
+    GOODMETER - Offline clock-drift simulation of DriftCompensatingBridge
+
+    Run from the standalone binary, no audio device or tap needed:
+
+        GOODMETER --benchmark-drift-bridge [--tap-rates 48000,44100]
+                  [--drifts 200,-300,0,150] [--device-rate 48000]
+                  [--seconds 600] [--block-size 512] [--tap-chunk 512]
+                  [--jitter-ms 1]
+
+    Every tap rate / drift pair drives one freshly prepared bridge through
+    simulated time: the producer pushes tap-chunk frames on a clock running
+    `drift` ppm fast (negative: slow) against its nominal rate, the consumer
+    pulls block-size samples on the device clock, and each callback fires
+    up to jitter-ms late (deterministic random), so the two interleave the
+    way a tap IOProc and a device callback do. Everything runs on the
+    calling thread as fast as it can.
+
+    Per case it reports the final rate trim and its error against the
+    drift (a clock N ppm fast settles at a trim of 1 + N ppm), when the
+    trim last left a ±20 ppm band around it, the buffered latency range
+    over the second half of the run, and the underrun / overrun / resync
+    counts. Output is JSON.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DriftCompensatingBridge.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace goodmeter
+{
+namespace benchmark
+{
+
+//==============================================================================
+struct DriftBridgeOptions
+{
+    std::vector<double> tapRates { 48000.0, 44100.0 };
+    std::vector<double> driftsPpm { 200.0, -300.0, 0.0, 150.0 };
+    double deviceRate = 48000.0;
+    double seconds = 600.0;
+    int blockSize = 512;
+    int tapChunk = 512;
+    double jitterMs = 1.0;
+};
+
+struct DriftBridgeCaseResult
+{
+    double finalTrimPpm = 0.0;
+    double meanTrimErrorPpm = 0.0;          // second half of the run
+    double worstTrimErrorPpm = 0.0;         // second half of the run
+    double settledAfterSeconds = 0.0;       // last time the trim was outside ±kSettledPpm
+    double minLatencyMs = 0.0, maxLatencyMs = 0.0, meanLatencyMs = 0.0;
+    juce::uint64 underruns = 0, overruns = 0, resyncs = 0;
+    double wallSeconds = 0.0;
+};
+
+//==============================================================================
+inline DriftBridgeCaseResult runDriftBridgeCase(double tapRate, double driftPpm, const DriftBridgeOptions& options)
+{
+    static constexpr double kSettledPpm = 20.0;
+
+    const int blockSize = juce::jlimit(16, 8192, options.blockSize);
+    const int tapChunk = juce::jlimit(16, 8192, options.tapChunk);
+    const double deviceRate = juce::jlimit(8000.0, 384000.0, options.deviceRate);
+    const double jitterSeconds = juce::jlimit(0.0, 50.0, options.jitterMs) * 0.001;
+
+    DriftCompensatingBridge bridge;
+    bridge.prepare(tapRate, deviceRate);
+
+    // The tap's clock runs fast by driftPpm: more frames per true second
+    const double producerPeriod = tapChunk / (tapRate * (1.0 + driftPpm * 1.0e-6));
+    const double consumerPeriod = blockSize / deviceRate;
+
+    std::vector<float> chunk(static_cast<size_t>(tapChunk) * 2);
+    std::vector<float> outL(static_cast<size_t>(blockSize)), outR(static_cast<size_t>(blockSize));
+    const double phaseStep = juce::MathConstants<double>::twoPi * 997.0 / tapRate;
+    double phase = 0.0;
+
+    juce::Random random(0x5eed);
+    juce::int64 producerIndex = 0, consumerIndex = 0;
+    double producerLate = random.nextDouble() * jitterSeconds;
+    double consumerLate = random.nextDouble() * jitterSeconds;
+
+    DriftBridgeCaseResult result;
+    result.minLatencyMs = std::numeric_limits<double>::max();
+    const double halfway = options.seconds * 0.5;
+    double trimErrorSum = 0.0, latencySum = 0.0;
+    int settledPulls = 0;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (;;)
+    {
+        const double producerTime = producerIndex * producerPeriod + producerLate;
+        const double consumerTime = consumerIndex * consumerPeriod + consumerLate;
+        if (juce::jmin(producerTime, consumerTime) >= options.seconds)
+            break;
+
+        if (producerTime <= consumerTime)
+        {
+            for (int i = 0; i < tapChunk; ++i)
+            {
+                const float s = 0.5f * static_cast<float>(std::sin(phase));
+                chunk[(size_t) i * 2] = s;
+                chunk[(size_t) i * 2 + 1] = -s;
+                phase = std::fmod(phase + phaseStep, juce::MathConstants<double>::twoPi);
+            }
+
+            bridge.push(chunk.data(), tapChunk, 2, producerTime);
+            ++producerIndex;
+            producerLate = random.nextDouble() * jitterSeconds;
+            continue;
+        }
+
+        bridge.pull(outL.data(), outR.data(), blockSize, consumerTime);
+        ++consumerIndex;
+        consumerLate = random.nextDouble() * jitterSeconds;
+
+        const double trimErrorPpm = std::abs((bridge.getRatioTrim() - 1.0) * 1.0e6 - driftPpm);
+        if (trimErrorPpm > kSettledPpm)
+            result.settledAfterSeconds = consumerTime;
+
+        if (consumerTime >= halfway)
+        {
+            const double latencyMs = bridge.getLatencySeconds() * 1000.0;
+            result.minLatencyMs = juce::jmin(result.minLatencyMs, latencyMs);
+            result.maxLatencyMs = juce::jmax(result.maxLatencyMs, latencyMs);
+            result.worstTrimErrorPpm = juce::jmax(result.worstTrimErrorPpm, trimErrorPpm);
+            latencySum += latencyMs;
+            trimErrorSum += trimErrorPpm;
+            ++settledPulls;
+        }
+    }
+
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    result.finalTrimPpm = (bridge.getRatioTrim() - 1.0) * 1.0e6;
+
+    if (settledPulls > 0)
+    {
+        result.meanTrimErrorPpm = trimErrorSum / settledPulls;
+        result.meanLatencyMs = latencySum / settledPulls;
+    }
+    else
+    {
+        result.minLatencyMs = 0.0;
+    }
+
+    result.underruns = bridge.getUnderrunCount();
+    result.overruns = bridge.getOverrunCount();
+    result.resyncs = bridge.getResyncCount();
+    return result;
+}
+
+//==============================================================================
+/** Every tap rate × drift; returns the JSON report. */
+inline juce::String runDriftBridgeBenchmark(const DriftBridgeOptions& options)
+{
+    juce::Array<juce::var> cases;
+    double worstTrimErrorPpm = 0.0;
+    juce::uint64 totalUnderruns = 0;
+
+    for (const double rawTapRate : options.tapRates)
+    {
+        const double tapRate = juce::jlimit(8000.0, 384000.0, rawTapRate);
+
+        for (const double driftPpm : options.driftsPpm)
+        {
+            const auto r = runDriftBridgeCase(tapRate, driftPpm, options);
+            worstTrimErrorPpm = juce::jmax(worstTrimErrorPpm, r.worstTrimErrorPpm);
+            totalUnderruns += r.underruns;
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("tapRate", tapRate);
+            entry->setProperty("driftPpm", driftPpm);
+            entry->setProperty("finalTrimPpm", r.finalTrimPpm);
+            entry->setProperty("meanTrimErrorPpm", r.meanTrimErrorPpm);
+            entry->setProperty("worstTrimErrorPpm", r.worstTrimErrorPpm);
+            entry->setProperty("settledAfterSeconds", r.settledAfterSeconds);
+            entry->setProperty("minLatencyMs", r.minLatencyMs);
+            entry->setProperty("meanLatencyMs", r.meanLatencyMs);
+            entry->setProperty("maxLatencyMs", r.maxLatencyMs);
+            entry->setProperty("underruns", static_cast<juce::int64>(r.underruns));
+            entry->setProperty("overruns", static_cast<juce::int64>(r.overruns));
+            entry->setProperty("resyncs", static_cast<juce::int64>(r.resyncs));
+            entry->setProperty("timesRealTime", r.wallSeconds > 0.0 ? options.seconds / r.wallSeconds : 0.0);
+            cases.add(juce::var(entry));
+        }
+    }
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("benchmark", "driftBridge");
+    result->setProperty("deviceRate", options.deviceRate);
+    result->setProperty("seconds", options.seconds);
+    result->setProperty("blockSize", options.blockSize);
+    result->setProperty("tapChunk", options.tapChunk);
+    result->setProperty("jitterMs", options.jitterMs);
+    result->setProperty("worstTrimErrorPpm", worstTrimErrorPpm);
+    result->setProperty("totalUnderruns", static_cast<juce::int64>(totalUnderruns));
+    result->setProperty("cases", cases);
+
+    return juce::JSON::toString(juce::var(result));
+}
+
+} // namespace benchmark
+} // namespace goodmeter
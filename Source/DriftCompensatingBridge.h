@@ -0,0 +1,327 @@
+/*
+  ==============================================================================
+    DriftCompensatingBridge.h
+    GOODMETER - Adaptive-rate bridge between two free-running audio clocks
+
+    System audio arrives on the tap's IOProc; processBlock runs on the JUCE
+    device. Even when both claim the same nominal rate the clocks drift
+    apart, so a plain FIFO slowly fills (latency grows) or empties (periodic
+    dropouts). The bridge keeps the FIFO at a small target fill instead:
+
+      - push(): producer side, interleaved frames into a lock-free SPSC ring
+        (excess frames are dropped and counted as overruns)
+      - pull(): consumer side, through a variable-ratio PolyphaseResampler
+        (tap rate → device rate) whose step is trimmed by a PI controller
+        on the smoothed fill error, within ±kMaxTrim
+      - The fill the controller sees does not depend on where the two
+        callbacks sit relative to each other: the producer stamps each push
+        with its time, and pull() counts the frames pushed so far as a
+        straight line through the middle of each chunk's step (plus the
+        input still held in the resampler). Sampling the raw ring at pull
+        time instead swings by a whole chunk as the callbacks slowly slide
+        past each other, which at equal nominal rates looks like drift
+      - The target is the largest producer chunk plus the largest consumer
+        demand seen so far, plus a margin that grows with every underrun
+        (up to kMaxMarginSeconds), so latency settles at what the two
+        callbacks' jitter actually needs
+      - After an underrun the bridge re-primes (silence until the target is
+        reached again); a fill far above the target (after a stall) is
+        skipped back down to it
+
+    pull() always writes every requested sample; whatever could not be
+    served from the ring is silence. Both sides pass their callback time in
+    seconds on one shared clock (see nowSeconds()).
+
+    Thread safety model:
+      - prepare() / reset(): not while either side is running
+      - push(): one producer thread (real-time safe); its time stamp
+        reaches pull() through a SeqlockSnapshot
+      - pull(): one consumer thread (real-time safe)
+      - Counters: any thread
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PolyphaseResampler.h"
+#include "MeterSnapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+class DriftCompensatingBridge
+{
+public:
+    static constexpr int kRingFrames = 131072;          // ~2.7 s at 48 kHz
+    static constexpr double kMaxTrim = 0.002;           // ±2000 ppm around the nominal ratio
+    static constexpr double kMaxMarginSeconds = 0.05;
+
+    DriftCompensatingBridge() = default;
+
+    /** The clock push() and pull() callers should stamp their callbacks with. */
+    static double nowSeconds() noexcept   { return juce::Time::getMillisecondCounterHiRes() * 0.001; }
+
+    /** Allocates: call before either side starts. */
+    void prepare(double sourceRate, double targetRate)
+    {
+        sourceSampleRate = sourceRate > 0.0 ? sourceRate : targetRate;
+        targetSampleRate = targetRate > 0.0 ? targetRate : sourceSampleRate;
+
+        ring.assign(static_cast<size_t>(kRingFrames) * 2, 0.0f);
+        resampler = std::make_unique<PolyphaseResampler>(sourceSampleRate, targetSampleRate, 2, kInputBlock, true);
+        inL.assign(static_cast<size_t>(kInputBlock), 0.0f);
+        inR.assign(static_cast<size_t>(kInputBlock), 0.0f);
+        outR.assign(static_cast<size_t>(kOutputBlock), 0.0f);
+        reset();
+    }
+
+    /** Empty the ring and restart the controller; keeps the counters. */
+    void reset()
+    {
+        fifo.reset();
+        if (resampler != nullptr)
+            resampler->reset();
+
+        priming = true;
+        smoothedError = 0.0;
+        integral = 0.0;
+        framesRead = 0;
+        framesPushed = 0;
+        pushStamps.publish({});
+        lastStamp = {};
+        marginFrames = 0;
+        maxConsumerNeed = 0;
+        maxProducerChunk.store(0, std::memory_order_relaxed);
+        trim.store(1.0, std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    /** Producer: numFrames frames of numChannels interleaved samples (mono is
+        duplicated), delivered at timeSeconds. */
+    void push(const float* interleaved, int numFrames, int numChannels, double timeSeconds) noexcept
+    {
+        if (ring.empty() || interleaved == nullptr || numFrames <= 0 || numChannels < 1)
+            return;
+
+        if (numFrames > maxProducerChunk.load(std::memory_order_relaxed))
+            maxProducerChunk.store(numFrames, std::memory_order_relaxed);
+
+        const int accepted = juce::jmin(numFrames, fifo.getFreeSpace());
+        if (accepted < numFrames)
+            overruns.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            const auto scope = fifo.write(accepted);
+            auto copy = [&] (int start, int size, int srcOffset)
+            {
+                for (int i = 0; i < size; ++i)
+                {
+                    const float* frame = interleaved + static_cast<size_t>(srcOffset + i) * static_cast<size_t>(numChannels);
+                    float* dst = ring.data() + static_cast<size_t>(start + i) * 2;
+                    dst[0] = frame[0];
+                    dst[1] = numChannels >= 2 ? frame[1] : frame[0];
+                }
+            };
+            copy(scope.startIndex1, scope.blockSize1, 0);
+            copy(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+        }
+
+        // Stamped once the scope has committed the frames, so pull() never
+        // counts frames it can't read yet
+        framesPushed += accepted;
+        pushStamps.publish({ timeSeconds, framesPushed, numFrames });
+    }
+
+    /** Consumer: write numSamples converted samples (destR may be nullptr)
+        for the callback at timeSeconds. Returns how many came from the
+        ring; the rest are silence. */
+    int pull(float* destL, float* destR, int numSamples, double timeSeconds) noexcept
+    {
+        if (numSamples <= 0)
+            return 0;
+
+        if (resampler == nullptr)
+        {
+            silence(destL, destR, 0, numSamples);
+            return 0;
+        }
+
+        maxConsumerNeed = juce::jmax(maxConsumerNeed, resampler->getInputSamplesNeeded(numSamples));
+        const int target = targetFill();
+        const int ready = fifo.getNumReady();
+
+        if (priming)
+        {
+            if (ready < target)
+            {
+                silence(destL, destR, 0, numSamples);
+                return 0;
+            }
+
+            priming = false;
+            smoothedError = 0.0;
+            integral = 0.0;
+        }
+
+        // Far too much buffered (the consumer stalled): drop back to the target
+        if (ready > kResyncFactor * target)
+        {
+            fifo.finishedRead(ready - target);
+            framesRead += ready - target;
+            smoothedError = 0.0;
+            resyncs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        updateTrim(static_cast<double>(numSamples) / targetSampleRate, target, timeSeconds);
+
+        int written = 0;
+        while (written < numSamples)
+        {
+            const int want = juce::jmin(numSamples - written, kOutputBlock);
+            const int need = juce::jmin(resampler->getInputSamplesNeeded(want), kInputBlock);
+            const int got = readRing(need);
+
+            const float* in[2] = { inL.data(), inR.data() };
+            float* out[2] = { destL + written, destR != nullptr ? destR + written : outR.data() };
+            const int made = resampler->process(in, got, out, want);
+            written += made;
+
+            // A need estimate that rounded one input short just loops once
+            // more; only an empty ring ends the block early
+            if (made == 0 && got == 0)
+                break;
+        }
+
+        if (written < numSamples)
+        {
+            // Ran dry: silence, a little more headroom, and prime again
+            silence(destL, destR, written, numSamples);
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            marginFrames = juce::jmin(marginFrames + juce::jmax(32, maxProducerChunk.load(std::memory_order_relaxed) / 2),
+                                      static_cast<int>(kMaxMarginSeconds * sourceSampleRate));
+            priming = true;
+        }
+
+        return written;
+    }
+
+    //==========================================================================
+    juce::uint64 getUnderrunCount() const noexcept   { return underruns.load(std::memory_order_relaxed); }
+    juce::uint64 getOverrunCount() const noexcept    { return overruns.load(std::memory_order_relaxed); }
+    juce::uint64 getResyncCount() const noexcept     { return resyncs.load(std::memory_order_relaxed); }
+
+    /** Current rate trim (1 = nominal). */
+    double getRatioTrim() const noexcept             { return trim.load(std::memory_order_relaxed); }
+
+    /** Audio currently held in the ring, in seconds. */
+    double getLatencySeconds() const noexcept
+    {
+        return sourceSampleRate > 0.0 ? fifo.getNumReady() / sourceSampleRate : 0.0;
+    }
+
+private:
+    static constexpr int kOutputBlock = 2048;
+    static constexpr int kInputBlock = 16384;           // covers tap rates up to 8× the device's
+    static constexpr int kResyncFactor = 4;
+    static constexpr double kErrorSmoothingSeconds = 2.0;
+    static constexpr double kProportionalGain = 0.16;   // trim per second of fill error
+    static constexpr double kIntegralGain = 0.01;       // trim per second of fill error, per second
+
+    int targetFill() const noexcept
+    {
+        return juce::jmax(64, maxProducerChunk.load(std::memory_order_relaxed) + maxConsumerNeed + marginFrames);
+    }
+
+    struct PushStamp
+    {
+        double time = 0.0;
+        juce::int64 framesPushed = 0;   // frames in the ring's history up to this push
+        int chunk = 0;                  // frames the producer delivered with it
+    };
+
+    /** Frames buffered between the callbacks, without their relative phase:
+        the pushed count runs as a line through the middle of each chunk's
+        step, so it reads the same wherever in the producer's period the
+        consumer happens to look. */
+    double phaseFreeFill(double timeSeconds) noexcept
+    {
+        pushStamps.read(lastStamp);   // a raced read keeps the previous stamp
+
+        const double chunk = lastStamp.chunk;
+        const double sinceStamp = juce::jlimit(0.0, chunk, (timeSeconds - lastStamp.time) * sourceSampleRate);
+        const double pushed = static_cast<double>(lastStamp.framesPushed) - 0.5 * chunk + sinceStamp;
+
+        return pushed - static_cast<double>(framesRead) + resampler->getBufferedInputSamples();
+    }
+
+    /** PI control of the step on the fill error in seconds of audio: above
+        the target, consume faster. */
+    void updateTrim(double blockSeconds, int target, double timeSeconds) noexcept
+    {
+        const double error = (phaseFreeFill(timeSeconds) - target) / sourceSampleRate;
+        const double alpha = 1.0 - std::exp(-blockSeconds / kErrorSmoothingSeconds);
+        smoothedError += (error - smoothedError) * alpha;
+
+        integral = juce::jlimit(-kMaxTrim / kIntegralGain, kMaxTrim / kIntegralGain,
+                                integral + smoothedError * blockSeconds);
+
+        const double newTrim = 1.0 + juce::jlimit(-kMaxTrim, kMaxTrim,
+                                                  kProportionalGain * smoothedError + kIntegralGain * integral);
+        resampler->setRatioTrim(newTrim);
+        trim.store(newTrim, std::memory_order_relaxed);
+    }
+
+    int readRing(int maxFrames) noexcept
+    {
+        const auto scope = fifo.read(juce::jmin(maxFrames, fifo.getNumReady()));
+        auto copy = [this] (int start, int size, int dstOffset)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                const float* frame = ring.data() + static_cast<size_t>(start + i) * 2;
+                inL[(size_t) (dstOffset + i)] = frame[0];
+                inR[(size_t) (dstOffset + i)] = frame[1];
+            }
+        };
+        copy(scope.startIndex1, scope.blockSize1, 0);
+        copy(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+        framesRead += scope.blockSize1 + scope.blockSize2;
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    static void silence(float* destL, float* destR, int from, int to) noexcept
+    {
+        std::fill(destL + from, destL + to, 0.0f);
+        if (destR != nullptr)
+            std::fill(destR + from, destR + to, 0.0f);
+    }
+
+    //==========================================================================
+    juce::AbstractFifo fifo { kRingFrames };
+    std::vector<float> ring;                            // stereo interleaved [L0, R0, L1, R1, ...]
+    double sourceSampleRate = 48000.0, targetSampleRate = 48000.0;
+
+    // Consumer side
+    std::unique_ptr<PolyphaseResampler> resampler;
+    std::vector<float> inL, inR, outR;
+    bool priming = true;
+    double smoothedError = 0.0;         // seconds of audio above the target
+    double integral = 0.0;
+    juce::int64 framesRead = 0;         // frames taken from the ring (or skipped)
+    PushStamp lastStamp;
+
+    // Producer side
+    juce::int64 framesPushed = 0;
+    SeqlockSnapshot<PushStamp> pushStamps;
+    int marginFrames = 0;
+    int maxConsumerNeed = 0;
+
+    std::atomic<int> maxProducerChunk { 0 };
+    std::atomic<double> trim { 1.0 };
+    std::atomic<juce::uint64> underruns { 0 }, overruns { 0 }, resyncs { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(DriftCompensatingBridge)
+};
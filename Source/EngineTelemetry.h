@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+    EngineTelemetry.h
+    GOODMETER - Real-time engine counters for stutter reports
+
+    What the audio engine does when a user hears a glitch:
+      - processBlock duration, as a log2-bucketed histogram (1 µs .. 0.5 s)
+        plus over-budget callbacks (took longer than the block lasts)
+      - Drops: goniometer FIFO full, recorder FIFO overruns, spectrum worker
+        FIFO overruns
+      - Recorder FIFO peak fill
+      - Spectrogram columns drawn / skipped (frames lapped before the
+        spectrogram worker thread got to them)
+
+    Counters are grouped by the thread that writes them, one cache line per
+    group, so writers never share a line. Audio thread counters have a single
+    writer and are bumped with a plain load + store (no locked RMW).
+
+    Cost when nobody is looking: one relaxed load per callback plus the
+    callback count; drop counters only move on the (rare) drop paths.
+    Callback timing runs only while at least one Watch exists (the
+    diagnostics panel, a JSON export).
+
+    Thread safety model:
+      - Audio thread: CallbackTimer, countStereoFifoFull(), ...
+      - Spectrogram worker(s): countSpectrogramColumns()
+      - Any thread: Watch, getSnapshot(), toJSON()
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+class EngineTelemetry
+{
+public:
+    // Bucket 0 is < 1 µs; bucket b covers [2^(b-1), 2^b) µs; the last is open-ended
+    static constexpr int kNumDurationBuckets = 20;
+
+    struct Snapshot
+    {
+        juce::uint64 callbacks = 0;
+        juce::uint64 timedCallbacks = 0;
+        juce::uint64 overBudgetCallbacks = 0;
+        juce::uint32 maxCallbackMicros = 0;
+        std::array<juce::uint64, kNumDurationBuckets> durationBuckets {};
+
+        juce::uint64 stereoFifoFull = 0;           // goniometer batches not delivered
+        juce::uint64 recorderFramesDropped = 0;
+        float recorderFifoPeakFill = 0.0f;          // 0..1
+        juce::uint64 spectrumSamplesDropped = 0;
+
+        juce::uint64 spectrogramColumnsDrawn = 0;
+        juce::uint64 spectrogramColumnsSkipped = 0;
+
+        /** Upper edge of a duration bucket in µs (bucket 0 = 1 µs). */
+        static juce::uint32 bucketUpperMicros(int bucket) noexcept   { return juce::uint32 (1) << bucket; }
+    };
+
+    //==========================================================================
+    /** Enables callback timing for as long as it lives. Any thread. */
+    class Watch
+    {
+    public:
+        explicit Watch(EngineTelemetry& telemetryToWatch) noexcept : telemetry(telemetryToWatch)
+        {
+            telemetry.watchers.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ~Watch()
+        {
+            telemetry.watchers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+    private:
+        EngineTelemetry& telemetry;
+        JUCE_DECLARE_NON_COPYABLE(Watch)
+    };
+
+    bool isWatched() const noexcept     { return watchers.load(std::memory_order_relaxed) > 0; }
+
+    //==========================================================================
+    /** Audio thread: construct at the top of processBlock. */
+    class CallbackTimer
+    {
+    public:
+        CallbackTimer(EngineTelemetry& telemetryToUse, int numSamples, double sampleRate) noexcept
+            : telemetry(telemetryToUse)
+        {
+            bump(telemetry.audio.callbacks);
+
+            if (! telemetry.isWatched() || sampleRate <= 0.0)
+                return;
+
+            budgetSeconds = numSamples / sampleRate;
+            startTicks = juce::Time::getHighResolutionTicks();
+        }
+
+        ~CallbackTimer()
+        {
+            if (startTicks != 0)
+                telemetry.recordCallbackDuration(juce::Time::getHighResolutionTicks() - startTicks, budgetSeconds);
+        }
+
+    private:
+        EngineTelemetry& telemetry;
+        juce::int64 startTicks = 0;
+        double budgetSeconds = 0.0;
+        JUCE_DECLARE_NON_COPYABLE(CallbackTimer)
+    };
+
+    //==========================================================================
+    // Audio thread
+    //==========================================================================
+    void countStereoFifoFull() noexcept                  { bump(audio.stereoFifoFull); }
+    void countSpectrumSamplesDropped(int n) noexcept     { bump(audio.spectrumSamplesDropped, static_cast<juce::uint64>(n)); }
+
+    void countRecorder(int framesDropped, float fifoFill) noexcept
+    {
+        if (framesDropped > 0)
+            bump(audio.recorderFramesDropped, static_cast<juce::uint64>(framesDropped));
+
+        const auto permille = static_cast<juce::uint32>(juce::jlimit(0.0f, 1.0f, fifoFill) * 1000.0f);
+        if (permille > audio.recorderFifoPeakPermille.load(std::memory_order_relaxed))
+            audio.recorderFifoPeakPermille.store(permille, std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    // Spectrogram worker threads (one per open spectrogram, hence fetch_add)
+    //==========================================================================
+    void countSpectrogramColumns(juce::uint64 drawn, juce::uint64 skipped) noexcept
+    {
+        if (drawn > 0)   spectrogram.columnsDrawn.fetch_add(drawn, std::memory_order_relaxed);
+        if (skipped > 0) spectrogram.columnsSkipped.fetch_add(skipped, std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    // Readers
+    //==========================================================================
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot s;
+        s.callbacks = audio.callbacks.load(std::memory_order_relaxed);
+        s.overBudgetCallbacks = audio.overBudgetCallbacks.load(std::memory_order_relaxed);
+        s.maxCallbackMicros = audio.maxCallbackMicros.load(std::memory_order_relaxed);
+
+        for (int b = 0; b < kNumDurationBuckets; ++b)
+        {
+            s.durationBuckets[(size_t) b] = audio.durationBuckets[(size_t) b].load(std::memory_order_relaxed);
+            s.timedCallbacks += s.durationBuckets[(size_t) b];
+        }
+
+        s.stereoFifoFull = audio.stereoFifoFull.load(std::memory_order_relaxed);
+        s.recorderFramesDropped = audio.recorderFramesDropped.load(std::memory_order_relaxed);
+        s.recorderFifoPeakFill = audio.recorderFifoPeakPermille.load(std::memory_order_relaxed) / 1000.0f;
+        s.spectrumSamplesDropped = audio.spectrumSamplesDropped.load(std::memory_order_relaxed);
+
+        s.spectrogramColumnsDrawn = spectrogram.columnsDrawn.load(std::memory_order_relaxed);
+        s.spectrogramColumnsSkipped = spectrogram.columnsSkipped.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /** Zero the histogram and peaks. Best effort: a value the audio thread
+     *  stores at the same moment may survive the reset. */
+    void resetTimings() noexcept
+    {
+        for (auto& bucket : audio.durationBuckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        audio.overBudgetCallbacks.store(0, std::memory_order_relaxed);
+        audio.maxCallbackMicros.store(0, std::memory_order_relaxed);
+        audio.recorderFifoPeakPermille.store(0, std::memory_order_relaxed);
+    }
+
+    static juce::var toVar(const Snapshot& s)
+    {
+        auto root = std::make_unique<juce::DynamicObject>();
+        root->setProperty("capturedAt", juce::Time::getCurrentTime().toISO8601(true));
+
+        auto callbacks = std::make_unique<juce::DynamicObject>();
+        callbacks->setProperty("total", static_cast<juce::int64>(s.callbacks));
+        callbacks->setProperty("timed", static_cast<juce::int64>(s.timedCallbacks));
+        callbacks->setProperty("overBudget", static_cast<juce::int64>(s.overBudgetCallbacks));
+        callbacks->setProperty("maxMicros", static_cast<int>(s.maxCallbackMicros));
+
+        juce::Array<juce::var> histogram;
+        for (int b = 0; b < kNumDurationBuckets; ++b)
+        {
+            auto bucket = std::make_unique<juce::DynamicObject>();
+            bucket->setProperty("upToMicros", b + 1 < kNumDurationBuckets ? juce::var(static_cast<int>(Snapshot::bucketUpperMicros(b)))
+                                                                          : juce::var());
+            bucket->setProperty("count", static_cast<juce::int64>(s.durationBuckets[(size_t) b]));
+            histogram.add(juce::var(bucket.release()));
+        }
+        callbacks->setProperty("durationHistogram", histogram);
+        root->setProperty("processBlock", juce::var(callbacks.release()));
+
+        auto drops = std::make_unique<juce::DynamicObject>();
+        drops->setProperty("stereoFifoFull", static_cast<juce::int64>(s.stereoFifoFull));
+        drops->setProperty("recorderFramesDropped", static_cast<juce::int64>(s.recorderFramesDropped));
+        drops->setProperty("recorderFifoPeakFill", s.recorderFifoPeakFill);
+        drops->setProperty("spectrumSamplesDropped", static_cast<juce::int64>(s.spectrumSamplesDropped));
+        drops->setProperty("spectrogramColumnsDrawn", static_cast<juce::int64>(s.spectrogramColumnsDrawn));
+        drops->setProperty("spectrogramColumnsSkipped", static_cast<juce::int64>(s.spectrogramColumnsSkipped));
+        root->setProperty("pipelines", juce::var(drops.release()));
+
+        return juce::var(root.release());
+    }
+
+    juce::String toJSON() const
+    {
+        return juce::JSON::toString(toVar(getSnapshot()), false);
+    }
+
+private:
+    //==========================================================================
+    /** Single-writer increment: no locked instruction on the audio thread. */
+    static void bump(std::atomic<juce::uint64>& counter, juce::uint64 n = 1) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void recordCallbackDuration(juce::int64 ticks, double budgetSeconds) noexcept
+    {
+        const double seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+        const auto micros = static_cast<juce::uint32>(juce::jlimit(0.0, 4.0e9, seconds * 1.0e6));
+
+        // Bit width of the µs count: 0 → 0, 1 → 1, 2-3 → 2, 4-7 → 3, ...
+        const int bucket = micros == 0 ? 0 : juce::jmin(kNumDurationBuckets - 1, juce::findHighestSetBit(micros) + 1);
+        bump(audio.durationBuckets[(size_t) bucket]);
+
+        if (seconds > budgetSeconds)
+            bump(audio.overBudgetCallbacks);
+
+        if (micros > audio.maxCallbackMicros.load(std::memory_order_relaxed))
+            audio.maxCallbackMicros.store(micros, std::memory_order_relaxed);
+    }
+
+    struct alignas(64) AudioThreadCounters
+    {
+        std::atomic<juce::uint64> callbacks { 0 };
+        std::atomic<juce::uint64> overBudgetCallbacks { 0 };
+        std::atomic<juce::uint32> maxCallbackMicros { 0 };
+        std::array<std::atomic<juce::uint64>, kNumDurationBuckets> durationBuckets {};
+
+        std::atomic<juce::uint64> stereoFifoFull { 0 };
+        std::atomic<juce::uint64> recorderFramesDropped { 0 };
+        std::atomic<juce::uint32> recorderFifoPeakPermille { 0 };
+        std::atomic<juce::uint64> spectrumSamplesDropped { 0 };
+    };
+
+    struct alignas(64) SpectrogramCounters
+    {
+        std::atomic<juce::uint64> columnsDrawn { 0 };
+        std::atomic<juce::uint64> columnsSkipped { 0 };
+    };
+
+    AudioThreadCounters audio;
+    SpectrogramCounters spectrogram;
+    alignas(64) std::atomic<int> watchers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(EngineTelemetry)
+};
@@ -0,0 +1,377 @@
+/*
+  ==============================================================================
+    FrameScheduler.h
+    GOODMETER - One display-synced frame clock for every animated component
+
+    Meters used to run their own startTimerHz(60): a dozen unsynchronised
+    message-thread timers, each repainting on its own schedule. Components
+    now derive from FrameScheduler::Client instead of juce::Timer and get
+    frameTick() from a single clock:
+
+      - Driven by a juce::VBlankAttachment on one on-screen client, paced
+        to kFrameHz whatever the display runs at (120 Hz ProMotion still
+        ticks at 60, so per-frame smoothing constants keep their meaning)
+      - Clients that are hidden, collapsed to nothing, scrolled or clipped
+        out of their parents, or in a minimised window are not ticked;
+        onScreenChanged() tells them when that state flips, so they can
+        drop their AnalysisDemand subscriptions while nobody sees them
+      - Repaints requested during a tick are collected per window and
+        issued together, consolidated, once every client has ticked
+
+    If no vertical blank arrives for a few frames (the driving component
+    left the screen), a timed callback re-picks the driver and keeps
+    ticking at kFrameHz until vsync resumes.
+
+    setFrameDivider() (PowerPolicy) ticks only every Nth frame of the grid
+    while the device is hot or saving power.
+
+    A FrameStart runs before any client in every tick: shared per-frame
+    state (the meter snapshot) is read there once and every client of that
+    frame draws from the same copy.
+
+    Thread safety model:
+      - Message thread only, like the juce::Timer it replaces.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class FrameScheduler
+{
+public:
+    static constexpr int kFrameHz = 60;
+
+    //==========================================================================
+    /** Base for components that animate; replaces juce::Timer. */
+    class Client
+    {
+    public:
+        /** Pass this from the component: Client(this). */
+        explicit Client(juce::Component* ownerComponent) : owner(*ownerComponent) { jassert(ownerComponent != nullptr); }
+
+        virtual ~Client()   { stopFrames(); }
+
+        /** Called once per frame while the component is on screen. */
+        virtual void frameTick() = 0;
+
+        /** Called from a tick when the component comes on screen or leaves
+         *  it (clients start out counted as on screen). */
+        virtual void onScreenChanged(bool /*isNowOnScreen*/) {}
+
+        void startFrames()
+        {
+            if (! receivingFrames)
+                FrameScheduler::getInstance().add(*this);
+        }
+
+        void stopFrames()
+        {
+            if (receivingFrames)
+                FrameScheduler::getInstance().remove(*this);
+        }
+
+        bool isReceivingFrames() const noexcept   { return receivingFrames; }
+
+    protected:
+        /** repaint(), batched with the other clients' repaints this frame. */
+        void repaintFrame()                                  { FrameScheduler::getInstance().repaint(owner); }
+        void repaintFrame(juce::Rectangle<int> area)         { FrameScheduler::getInstance().repaint(owner, area); }
+
+    private:
+        friend class FrameScheduler;
+        juce::Component& owner;
+        bool receivingFrames = false;
+        bool onScreen = true;
+
+        JUCE_DECLARE_NON_COPYABLE(Client)
+    };
+
+    //==========================================================================
+    /** Callback run at the start of every tick, before any client, for as
+     *  long as this object exists. Does not keep the clock running by itself. */
+    class FrameStart
+    {
+    public:
+        explicit FrameStart(std::function<void()> callbackToUse)
+            : callback(std::move(callbackToUse))
+        {
+            FrameScheduler::getInstance().frameStarts.push_back(this);
+        }
+
+        ~FrameStart()
+        {
+            auto& starts = FrameScheduler::getInstance().frameStarts;
+            starts.erase(std::remove(starts.begin(), starts.end(), this), starts.end());
+        }
+
+    private:
+        friend class FrameScheduler;
+        std::function<void()> callback;
+
+        JUCE_DECLARE_NON_COPYABLE(FrameStart)
+    };
+
+    //==========================================================================
+    static FrameScheduler& getInstance()
+    {
+        static FrameScheduler scheduler;
+        return scheduler;
+    }
+
+    /** Repaint component (or area of it) with this frame's batch; outside a
+     *  tick this is a plain repaint. */
+    void repaint(juce::Component& component)
+    {
+        repaint(component, component.getLocalBounds());
+    }
+
+    void repaint(juce::Component& component, juce::Rectangle<int> area)
+    {
+        if (! ticking)
+        {
+            component.repaint(area);
+            return;
+        }
+
+        auto* window = component.getTopLevelComponent();
+        const auto windowArea = window->getLocalArea(&component, area).getIntersection(window->getLocalBounds());
+        if (windowArea.isEmpty())
+            return;
+
+        for (auto& pending : dirty)
+        {
+            if (pending.window == window)
+            {
+                pending.areas.add(windowArea);
+                return;
+            }
+        }
+
+        dirty.push_back({ window, juce::RectangleList<int>(windowArea) });
+    }
+
+    /** Visible, non-empty, not clipped away by any parent, window not minimised. */
+    static bool isOnScreen(const juce::Component& component)
+    {
+        if (! component.isShowing() || component.getWidth() <= 0 || component.getHeight() <= 0)
+            return false;
+
+        auto area = component.getLocalBounds();
+        for (auto* child = &component; auto* parent = child->getParentComponent(); child = parent)
+        {
+            area = parent->getLocalArea(child, area).getIntersection(parent->getLocalBounds());
+            if (area.isEmpty())
+                return false;
+        }
+
+        return true;
+    }
+
+    /** Tick at kFrameHz / divider (1 = full rate). */
+    void setFrameDivider(int divider)
+    {
+        frameDivider = juce::jlimit(1, 4, divider);
+        if (fallbackRunning && watchdog != nullptr)
+            watchdog->startTimerHz(kFrameHz / frameDivider);
+    }
+
+    int getFrameDivider() const noexcept    { return frameDivider; }
+
+private:
+    static constexpr double kFrameMs = 1000.0 / kFrameHz;
+    static constexpr double kEarlyToleranceMs = 2.0;     // vsync jitter accepted as "due"
+    static constexpr int kStallFrames = 3;               // no vblank for this long → fallback
+    static constexpr int kWatchdogHz = 10;
+
+    FrameScheduler() = default;
+    ~FrameScheduler() = default;
+
+    //==========================================================================
+    void add(Client& client)
+    {
+        client.receivingFrames = true;
+        clients.push_back(&client);
+
+        if (watchdog == nullptr)
+            watchdog = std::make_unique<juce::TimedCallback>([this] { watchdogTick(); });
+        if (! watchdog->isTimerRunning())
+            watchdog->startTimerHz(kWatchdogHz);
+
+        // Never swap the attachment from inside its own callback
+        if (driver == nullptr && ! ticking)
+            pickDriver();
+    }
+
+    void remove(Client& client)
+    {
+        client.receivingFrames = false;
+
+        // Ticks may be iterating: null the slot, compact afterwards
+        const auto it = std::find(clients.begin(), clients.end(), &client);
+        if (it != clients.end())
+            *it = nullptr;
+        if (! ticking)
+            compact();
+
+        // Mid-tick, the old attachment stays until the watchdog sees it stall
+        if (driver == &client)
+        {
+            driver = nullptr;
+            if (! ticking)
+            {
+                vblank.reset();
+                pickDriver();
+            }
+        }
+
+        if (! ticking && ! hasClients())
+        {
+            vblank.reset();
+            watchdog.reset();
+            fallbackRunning = false;
+        }
+    }
+
+    bool hasClients() const
+    {
+        return std::any_of(clients.begin(), clients.end(), [] (const Client* c) { return c != nullptr; });
+    }
+
+    void compact()
+    {
+        clients.erase(std::remove(clients.begin(), clients.end(), nullptr), clients.end());
+    }
+
+    /** Attach the vblank callback to the first on-screen client. */
+    void pickDriver()
+    {
+        for (auto* client : clients)
+        {
+            if (client != nullptr && isOnScreen(client->owner))
+            {
+                driver = client;
+                vblank = std::make_unique<juce::VBlankAttachment>(&client->owner, [this] { onVBlank(); });
+                lastVBlankMs = juce::Time::getMillisecondCounterHiRes();
+                return;
+            }
+        }
+    }
+
+    //==========================================================================
+    void onVBlank()
+    {
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        lastVBlankMs = now;
+
+        if (fallbackRunning)
+        {
+            fallbackRunning = false;
+            watchdog->startTimerHz(kWatchdogHz);
+        }
+
+        if (now >= nextFrameMs - kEarlyToleranceMs)
+            tick(now);
+    }
+
+    void watchdogTick()
+    {
+        if (! hasClients())
+        {
+            vblank.reset();
+            driver = nullptr;
+            fallbackRunning = false;
+            watchdog->stopTimer();
+            return;
+        }
+
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        if (now - lastVBlankMs < kStallFrames * kFrameMs)
+            return;
+
+        // Vsync stopped: the driver is off screen (or was never on a peer)
+        if (driver == nullptr || ! isOnScreen(driver->owner))
+        {
+            vblank.reset();
+            driver = nullptr;
+            pickDriver();
+        }
+
+        if (! fallbackRunning)
+        {
+            fallbackRunning = true;
+            watchdog->startTimerHz(kFrameHz / frameDivider);
+        }
+
+        tick(now);
+    }
+
+    double frameIntervalMs() const noexcept   { return kFrameMs * frameDivider; }
+
+    void tick(double now)
+    {
+        // Keep to the frame grid; after a stall, restart it from now
+        const double interval = frameIntervalMs();
+        nextFrameMs = (now - nextFrameMs > interval) ? now + interval : nextFrameMs + interval;
+
+        ticking = true;
+        for (auto* start : frameStarts)
+            start->callback();
+
+        for (size_t i = 0; i < clients.size(); ++i)      // clients may add / remove themselves
+        {
+            auto* client = clients[i];
+            if (client == nullptr)
+                continue;
+
+            const bool shown = isOnScreen(client->owner);
+            if (shown != client->onScreen)
+            {
+                client->onScreen = shown;
+                client->onScreenChanged(shown);
+                if (clients[i] != client)        // removed itself from the callback
+                    continue;
+            }
+
+            if (shown)
+                client->frameTick();
+        }
+        ticking = false;
+        compact();
+
+        auto batch = std::move(dirty);
+        dirty.clear();
+        for (auto& pending : batch)
+        {
+            pending.areas.consolidate();
+            for (const auto& area : pending.areas)
+                pending.window->repaint(area);
+        }
+    }
+
+    //==========================================================================
+    struct DirtyWindow
+    {
+        juce::Component* window = nullptr;
+        juce::RectangleList<int> areas;
+    };
+
+    std::vector<Client*> clients;
+    std::vector<FrameStart*> frameStarts;
+    std::vector<DirtyWindow> dirty;
+    Client* driver = nullptr;
+    std::unique_ptr<juce::VBlankAttachment> vblank;
+    std::unique_ptr<juce::TimedCallback> watchdog;
+    double lastVBlankMs = 0.0;
+    double nextFrameMs = 0.0;
+    int frameDivider = 1;
+    bool ticking = false;
+    bool fallbackRunning = false;
+
+    JUCE_DECLARE_NON_COPYABLE(FrameScheduler)
+};
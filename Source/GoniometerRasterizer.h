@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+    GoniometerRasterizer.h
+    GOODMETER - Phosphor-style goniometer accumulation buffer
+
+    The goniometer used to fade its ARGB image with a translucent fillAll,
+    then alpha-blend Bresenham lines between every 4th sample through
+    BitmapData::setPixelColour. This keeps a float energy buffer instead:
+
+      - decay(): the persistence, one vector multiply over the buffer, with
+        denormals flushed so long-faded cells don't fall onto the slow path
+      - plot(): every L/R sample, mapped to M/S pixel coordinates and
+        clamped to the diamond with vector ops, deposited as a bilinear
+        splat (sub-pixel positions, no stair-stepping). The splat itself is
+        a scatter into cells that neighbouring samples often share, so it
+        stays scalar
+      - render(): energy → colour through a 256-entry ramp from the
+        background to the trace colour, written row by row into the image
+
+    Dense regions saturate towards the trace colour instead of clipping,
+    and traces fade smoothly whatever the frame rate of the plotting.
+
+    Thread safety model:
+      - Message thread only (owned and driven by StereoImageComponent).
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+class GoniometerRasterizer
+{
+public:
+    GoniometerRasterizer() = default;
+
+    /** Buffer size in image pixels; clears the buffer when it changes. 0 × 0 releases it. */
+    void setSize(int newWidth, int newHeight)
+    {
+        newWidth = juce::jmax(0, newWidth);
+        newHeight = juce::jmax(0, newHeight);
+        if (newWidth == width && newHeight == height)
+            return;
+
+        width = newWidth;
+        height = newHeight;
+        if (width == 0 || height == 0)
+            energy = {};
+        else
+            energy.assign(static_cast<size_t>(width * height), 0.0f);
+    }
+
+    int getWidth() const noexcept    { return width; }
+    int getHeight() const noexcept   { return height; }
+
+    void clear()
+    {
+        std::fill(energy.begin(), energy.end(), 0.0f);
+    }
+
+    /** Diamond centre and radius in buffer pixels; scale is pixels per unit of M and S. */
+    void setGeometry(float centreX, float centreY, float radius, float unitScale) noexcept
+    {
+        cx = centreX;
+        cy = centreY;
+        r = radius;
+        scale = unitScale;
+    }
+
+    //==========================================================================
+    /** Multiply every pixel's energy by keep (0..1). */
+    void decay(float keep) noexcept
+    {
+        // Repeated decay walks every untouched cell down through the
+        // denormal range; flush to zero instead of paying for it each frame
+        juce::ScopedNoDenormals noDenormals;
+
+        if (! energy.empty())
+            juce::FloatVectorOperations::multiply(energy.data(), keep, static_cast<int>(energy.size()));
+    }
+
+    /** Deposit numSamples L/R pairs, weight energy each. */
+    void plot(const float* left, const float* right, int numSamples, float weight) noexcept
+    {
+        if (energy.empty() || width < 2 || height < 2)
+            return;
+
+        juce::ScopedNoDenormals noDenormals;
+        const float maxX = static_cast<float>(width) - 1.001f;
+        const float maxY = static_cast<float>(height) - 1.001f;
+        const float radius = juce::jmax(r, 1.0e-6f);    // keeps 0 / 0 out of shrink
+
+        for (int start = 0; start < numSamples; start += kBlock)
+        {
+            const int n = juce::jmin(kBlock, numSamples - start);
+            float* xs = blockX.data();
+            float* ys = blockY.data();
+            float* shrink = blockShrink.data();
+
+            // Offsets from the centre: S to the right, M upwards
+            juce::FloatVectorOperations::subtract(xs, left + start, right + start, n);
+            juce::FloatVectorOperations::add(ys, left + start, right + start, n);
+            juce::FloatVectorOperations::multiply(xs, scale, n);
+            juce::FloatVectorOperations::multiply(ys, -scale, n);
+
+            // Pull anything outside the diamond (|x| + |y| > r) back onto its
+            // edge: shrink = r / max(|x| + |y|, r), 1 inside. Branch-free so
+            // the one loop FloatVectorOperations has no op for vectorises too
+            juce::FloatVectorOperations::abs(shrink, xs, n);
+            for (int i = 0; i < n; ++i)
+                shrink[i] = radius / std::max(shrink[i] + std::abs(ys[i]), radius);
+
+            juce::FloatVectorOperations::multiply(xs, shrink, n);
+            juce::FloatVectorOperations::multiply(ys, shrink, n);
+            juce::FloatVectorOperations::add(xs, cx, n);
+            juce::FloatVectorOperations::add(ys, cy, n);
+            juce::FloatVectorOperations::clip(xs, xs, 0.0f, maxX, n);
+            juce::FloatVectorOperations::clip(ys, ys, 0.0f, maxY, n);
+
+            for (int i = 0; i < n; ++i)
+                splat(xs[i], ys[i], weight);
+        }
+    }
+
+    //==========================================================================
+    /** Tone-map the buffer into image (same size, ARGB). */
+    void render(juce::Image& image, juce::Colour background, juce::Colour trace)
+    {
+        if (energy.empty() || image.getWidth() != width || image.getHeight() != height
+            || image.getFormat() != juce::Image::ARGB)
+            return;
+
+        if (background != rampBackground || trace != rampTrace || ! rampValid)
+            buildRamp(background, trace);
+
+        juce::Image::BitmapData bmp(image, juce::Image::BitmapData::writeOnly);
+        const float toIndex = static_cast<float>(kRampSize - 1) / kMaxEnergy;
+
+        for (int y = 0; y < height; ++y)
+        {
+            const float* src = energy.data() + static_cast<size_t>(y * width);
+            auto* dst = reinterpret_cast<juce::PixelARGB*>(bmp.getLinePointer(y));
+
+            for (int x = 0; x < width; ++x)
+            {
+                const int index = juce::jmin(kRampSize - 1, static_cast<int>(src[x] * toIndex));
+                dst[x] = ramp[(size_t) index];
+            }
+        }
+    }
+
+private:
+    static constexpr int kBlock = 256;
+    static constexpr int kRampSize = 256;
+    static constexpr float kGain = 0.8f;        // one full hit ≈ 55% of the way to the trace colour
+    static constexpr float kMaxEnergy = 6.0f / kGain;   // where the ramp is within 0.25% of saturated
+
+    //==========================================================================
+    void splat(float x, float y, float weight) noexcept
+    {
+        const int x0 = static_cast<int>(x);
+        const int y0 = static_cast<int>(y);
+        const float fx = x - static_cast<float>(x0);
+        const float fy = y - static_cast<float>(y0);
+
+        float* row = energy.data() + static_cast<size_t>(y0 * width + x0);
+        const float top = weight * (1.0f - fy);
+        const float bottom = weight * fy;
+        row[0]         += top * (1.0f - fx);
+        row[1]         += top * fx;
+        row[width]     += bottom * (1.0f - fx);
+        row[width + 1] += bottom * fx;
+    }
+
+    void buildRamp(juce::Colour background, juce::Colour trace)
+    {
+        for (int i = 0; i < kRampSize; ++i)
+        {
+            const float e = kMaxEnergy * static_cast<float>(i) / static_cast<float>(kRampSize - 1);
+            const float t = 1.0f - std::exp(-e * kGain);
+            ramp[(size_t) i] = background.interpolatedWith(trace, t).getPixelARGB();
+        }
+
+        rampBackground = background;
+        rampTrace = trace;
+        rampValid = true;
+    }
+
+    //==========================================================================
+    int width = 0, height = 0;
+    std::vector<float> energy;                          // [height][width]
+    float cx = 0.0f, cy = 0.0f, r = 1.0f, scale = 1.0f;
+
+    std::array<float, kBlock> blockX {}, blockY {}, blockShrink {};
+    std::array<juce::PixelARGB, kRampSize> ramp {};
+    juce::Colour rampBackground, rampTrace;
+    bool rampValid = false;
+
+    JUCE_DECLARE_NON_COPYABLE(GoniometerRasterizer)
+};
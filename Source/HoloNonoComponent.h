@@ -16,6 +16,9 @@
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
+#include "FrameScheduler.h"
+#include "NonoSpriteCache.h"
+#include "OfflineLoudnessAnalyzer.h"
 
 //==============================================================================
 #ifndef GOODMETER_NONO_ANALYSIS_RESULT_DEFINED
@@ -33,7 +36,7 @@ struct NonoAnalysisResult
 
 //==============================================================================
 class HoloNonoComponent : public juce::Component,
-                           public juce::Timer
+                           public FrameScheduler::Client
 #if ! JUCE_IOS
                          , public juce::FileDragAndDropTarget
 #endif
@@ -43,10 +46,10 @@ public:
     enum class SkinType { Guoba, Nono };
 
     HoloNonoComponent(GOODMETERAudioProcessor& processor)
-        : audioProcessor(processor)
+        : FrameScheduler::Client(this), audioProcessor(processor)
     {
         setSize(100, 200);
-        startTimerHz(60);
+        startFrames();
 
         // Load GUOBA sprite from BinaryData
         guobaSprite = juce::ImageCache::getFromMemory(
@@ -56,6 +59,16 @@ public:
         guobaNose = juce::ImageCache::getFromMemory(
             BinaryData::guoba_nose_png, BinaryData::guoba_nose_pngSize);
 
+        // Static layers are blitted from pre-rendered atlases; the cache paints
+        // them off-thread from its own software copy of the sprite
+        spriteCache = std::make_unique<NonoSpriteCache>(numSpriteLayers,
+            [sprite = juce::SoftwareImageType().convert(guobaSprite)]
+            (juce::Graphics& g, int pose, int layer, float x, float y, float r)
+            {
+                paintSpriteLayer(g, spriteStyle(pose, sprite), layer, x, y, r);
+            },
+            [] (int pose, int layer) { return spriteLayerBounds(pose, layer); });
+
         lastScreenPos = getScreenPosition();
         lastW = getWidth();
         lastH = getHeight();
@@ -72,7 +85,7 @@ public:
 
     ~HoloNonoComponent() override
     {
-        stopTimer();
+        stopFrames();
         if (analysisThread)
         {
             analysisThread->signalThreadShouldExit();
@@ -125,6 +138,7 @@ public:
         // Reset holo visor when switching skins
         isHoloVisor = false;
         holoTransition = 0.0f;
+        prewarmSprites();
         repaint();
     }
     SkinType getSkin() const { return currentSkin; }
@@ -237,6 +251,16 @@ public:
         }
     }
 
+    /** Loudness already measured while the file was being produced (video
+        audio streamed through OfflineLoudnessAnalyzer::Stream during
+        extraction). The next analyzeFile() of that file shows it instead of
+        reading the file again. */
+    void providePrecomputedAnalysis(const juce::File& file, OfflineLoudnessResult analysis)
+    {
+        precomputedAnalysisFile = file;
+        precomputedAnalysis = std::move(analysis);
+    }
+
     /** Optional external import hook.
         If set, HoloNono's built-in file picker will delegate the selected URL
         to the host page instead of starting standalone analysis internally. */
@@ -618,15 +642,31 @@ public:
         // Store visor hit path for back-face click detection (uses same coords as drawVisor/drawBackFace)
         visorHitPath = buildVisorPath(cx, cy - radius * 0.06f, radius, hScale);
 
-        // Draw layers
-        drawAntiGravityGlow(g, cx, cy, radius);
-        drawShadow(g, cx, cy, radius);
-        drawHolographicEars(g, cx, cy, radius, hScale);
-        drawBody(g, cx, cy, radius, hScale);
+        // Draw layers — static ones are atlas blits once the sprite cache has
+        // them; mid-flip (squashed every frame) they are drawn procedurally
+        const auto style = shellStyle();
+        const float pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const int bodyPose = isGuoba() ? guobaFurPose : nonoPose;
+        auto blit = [&] (int pose, int layer, float offsetY)
+        {
+            return hScale >= 1.0f && pose >= 0
+                && spriteCache->draw(g, pose, layer, cx, cy + offsetY, radius, pixelScale);
+        };
+
+        if (! blit(bodyPose, groundLayer, 0.0f))
+        {
+            drawAntiGravityGlow(g, style, cx, cy, radius);
+            drawShadow(g, cx, cy, radius);
+        }
+        if (! blit(bodyPose, earsLayer, earBobOffset))
+            drawHolographicEars(g, style, cx, cy, radius, hScale);
+        if (! blit(bodyPose, bodyLayer, 0.0f))
+            drawBody(g, style, cx, cy, radius, hScale);
 
         if (showFront)
         {
-            drawVisor(g, cx, cy, radius, hScale);
+            if (! blit(visorPose(), visorLayer, 0.0f))
+                drawVisor(g, style, cx, cy, radius, hScale);
 
             if (audioProcessor.audioRecorder.getIsRecording())
                 drawRecordingGrid(g, cx, cy, radius, hScale);
@@ -664,7 +704,10 @@ public:
             drawLightningVFX(g, cx, cy, radius);
     }
 
-    void resized() override {}
+    void resized() override
+    {
+        prewarmSprites();
+    }
 
     //==========================================================================
     // Hit test: only return true for Nono's visible body/tube regions.
@@ -885,53 +928,6 @@ private:
     int dizzyRecoveryFrames = 0;
     int osQueryCounter = 0;
 
-    //==========================================================================
-    // Inner: Biquad filter for K-weighting
-    //==========================================================================
-    struct Biquad
-    {
-        double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
-        double z1 = 0, z2 = 0;
-
-        double process(double x)
-        {
-            double y = b0 * x + z1;
-            z1 = b1 * x - a1 * y + z2;
-            z2 = b2 * x - a2 * y;
-            return y;
-        }
-
-        void reset() { z1 = z2 = 0; }
-    };
-
-    static void computeKWeighting(double sampleRate, Biquad& stage1, Biquad& stage2)
-    {
-        // Stage 1: High shelf pre-filter (ITU-R BS.1770-4)
-        {
-            const double Vh = 1.58489319246111; // 10^(4/20)
-            const double K = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
-            const double Ksq = K * K;
-            const double denom = 1.0 + std::sqrt(2.0) * K + Ksq;
-            stage1.b0 = (Vh + std::sqrt(2.0 * Vh) * K + Ksq) / denom;
-            stage1.b1 = 2.0 * (Ksq - Vh) / denom;
-            stage1.b2 = (Vh - std::sqrt(2.0 * Vh) * K + Ksq) / denom;
-            stage1.a1 = 2.0 * (Ksq - 1.0) / denom;
-            stage1.a2 = (1.0 - std::sqrt(2.0) * K + Ksq) / denom;
-        }
-        // Stage 2: High-pass RLB weighting
-        {
-            const double Q = 0.5003270373238773;
-            const double K = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
-            const double Ksq = K * K;
-            const double denom = 1.0 + K / Q + Ksq;
-            stage2.b0 = 1.0 / denom;
-            stage2.b1 = -2.0 / denom;
-            stage2.b2 = 1.0 / denom;
-            stage2.a1 = 2.0 * (Ksq - 1.0) / denom;
-            stage2.a2 = (1.0 - K / Q + Ksq) / denom;
-        }
-    }
-
     //==========================================================================
     // Inner: Analysis Thread (async, EBU R128 compliant)
     //==========================================================================
@@ -939,266 +935,29 @@ private:
     {
     public:
         AnalysisThread(const juce::File& file,
-                       juce::Component::SafePointer<HoloNonoComponent> owner)
-            : Thread("NONO-Analysis"), audioFile(file), safeOwner(owner) {}
+                       juce::Component::SafePointer<HoloNonoComponent> owner,
+                       OfflineLoudnessResult precomputedResult = {})
+            : Thread("NONO-Analysis"), audioFile(file), safeOwner(owner),
+              precomputed(std::move(precomputedResult)) {}
 
         void run() override
         {
-            juce::AudioFormatManager fmt;
-            fmt.registerBasicFormats();
-
-            std::unique_ptr<juce::AudioFormatReader> reader(fmt.createReaderFor(audioFile));
-            if (!reader)
-            {
-                callbackResult(NonoAnalysisResult{});
+            // Whole file, chunked across cores; reopened files come from the cache
+            const auto analysis = precomputed.valid
+                ? precomputed
+                : OfflineLoudnessAnalyzer::analyseFileCached(audioFile, [this] { return threadShouldExit(); });
+            if (threadShouldExit())
                 return;
-            }
-
-            const int numCh = juce::jmin((int)reader->numChannels, 64);
-            const double sr = reader->sampleRate;
-            const juce::int64 maxSamples = (juce::int64)(sr * 600.0); // 10 min cap
-            const juce::int64 totalSamples = juce::jmin(reader->lengthInSamples, maxSamples);
-
-            if (totalSamples <= 0 || sr <= 0)
-            {
-                callbackResult(NonoAnalysisResult{});
-                return;
-            }
-
-            // ---- ITU-R BS.1770-4 channel weighting ----
-            // Standard layout: L R C LFE Ls Rs ...
-            // LFE (ch index 3 for >= 6ch) is excluded (weight = 0)
-            // Surround/height channels (index >= 4 for >= 6ch) get +1.5 dB (G_i = ~1.41)
-            // For stereo (2ch) or unknown layouts: equal weight 1.0
-            std::vector<double> channelWeight(numCh, 1.0);
-            if (numCh >= 6)
-            {
-                // ch0=L, ch1=R, ch2=C: weight 1.0
-                channelWeight[3] = 0.0;  // LFE — excluded per BS.1770
-                for (int ch = 4; ch < numCh; ++ch)
-                    channelWeight[ch] = 1.41253754;  // +1.5 dB = 10^(1.5/10)
-            }
-
-            // ---- K-weighting filters (one pair per channel) ----
-            std::vector<Biquad> s1(numCh), s2(numCh);
-            for (int ch = 0; ch < numCh; ++ch)
-                computeKWeighting(sr, s1[ch], s2[ch]);
-
-            // ---- 100ms sub-block accumulators ----
-            const int subBlockSize = (int)(sr * 0.1);
-            if (subBlockSize <= 0) { callbackResult(NonoAnalysisResult{}); return; }
-
-            std::vector<double> subMS;              // weighted mean-square per 100ms sub-block
-            std::vector<double> subBlockPower(numCh, 0.0); // running sum per channel
-            int subBlockPos = 0;                     // sample position within current sub-block
-
-            // Center channel (ch[2]) separate accumulator for dialogue loudness
-            const bool hasCenter = (numCh >= 6);
-            std::vector<double> centerSubMS;         // center-only mean-square per 100ms
-            double centerBlockPower = 0.0;
 
             NonoAnalysisResult result;
-            float globalMaxMag = 0.0f;
-
-            // ==== CHUNKED READ LOOP (never loads entire file) ====
-            // For large channel counts, reduce block size to limit memory
-            const int blockSize = (numCh <= 8) ? 65536 : juce::jmax(4096, 65536 * 2 / numCh);
-            juce::AudioBuffer<float> buffer(numCh, blockSize);
-            juce::int64 samplesRead = 0;
-
-            while (samplesRead < totalSamples)
-            {
-                if (threadShouldExit()) return;
-
-                const int toRead = (int)juce::jmin((juce::int64)blockSize, totalSamples - samplesRead);
-                buffer.clear();
-
-                // Read all channels: JUCE AudioFormatReader::read with
-                // destBuffer having numCh channels reads channels 0..numCh-1
-                reader->read(&buffer, 0, toRead, samplesRead, true, true);
-                samplesRead += toRead;
-
-                // ---- True Peak (before K-weighting, all channels) ----
-                for (int ch = 0; ch < numCh; ++ch)
-                {
-                    if (channelWeight[ch] > 0.0)  // skip LFE for peak too
-                        globalMaxMag = juce::jmax(globalMaxMag,
-                                                  buffer.getMagnitude(ch, 0, toRead));
-                }
-
-                // ---- K-weight in-place + accumulate 100ms sub-blocks ----
-                for (int i = 0; i < toRead; ++i)
-                {
-                    for (int ch = 0; ch < numCh; ++ch)
-                    {
-                        if (channelWeight[ch] <= 0.0) continue;  // skip LFE
-                        double x = (double)buffer.getSample(ch, i);
-                        x = s1[ch].process(x);
-                        x = s2[ch].process(x);
-                        subBlockPower[ch] += x * x;
-
-                        // Accumulate center channel separately
-                        if (hasCenter && ch == 2)
-                            centerBlockPower += x * x;
-                    }
-
-                    ++subBlockPos;
-                    if (subBlockPos >= subBlockSize)
-                    {
-                        double ms = 0.0;
-                        for (int ch = 0; ch < numCh; ++ch)
-                        {
-                            ms += channelWeight[ch] * subBlockPower[ch] / subBlockSize;
-                            subBlockPower[ch] = 0.0;
-                        }
-                        subMS.push_back(ms);
-
-                        // Center channel sub-block (weight 1.0, single channel)
-                        if (hasCenter)
-                        {
-                            centerSubMS.push_back(centerBlockPower / subBlockSize);
-                            centerBlockPower = 0.0;
-                        }
-
-                        subBlockPos = 0;
-                    }
-                }
-            }
-
-            reader.reset(); // release file handle immediately
-
-            // ---- Peak dBFS ----
-            result.peakDBFS = juce::Decibels::gainToDecibels(globalMaxMag, -100.0f);
-            result.numChannels = numCh;
-
-            if (threadShouldExit()) return;
-
-            // ---- LUFS calculations from sub-block data ----
-            const int numSubBlocks = (int)subMS.size();
-
-            auto toLUFS = [](double power) -> float {
-                return (power > 0.0) ? (float)(-0.691 + 10.0 * std::log10(power)) : -100.0f;
-            };
-
-            // Momentary max (400ms = 4 sub-blocks)
-            {
-                const int win = 4;
-                float maxVal = -100.0f;
-                for (int i = 0; i <= numSubBlocks - win; ++i)
-                {
-                    double sum = 0;
-                    for (int j = 0; j < win; ++j) sum += subMS[i + j];
-                    maxVal = juce::jmax(maxVal, toLUFS(sum / win));
-                }
-                result.momentaryMaxLUFS = maxVal;
-            }
-
-            // Short-term max (3000ms = 30 sub-blocks)
-            {
-                const int win = 30;
-                float maxVal = -100.0f;
-                for (int i = 0; i <= numSubBlocks - win; ++i)
-                {
-                    double sum = 0;
-                    for (int j = 0; j < win; ++j) sum += subMS[i + j];
-                    maxVal = juce::jmax(maxVal, toLUFS(sum / win));
-                }
-                result.shortTermMaxLUFS = maxVal;
-            }
-
-            // Integrated LUFS (EBU R128 dual gating)
+            if (analysis.valid)
             {
-                const int win = 4;
-                std::vector<double> winPower;
-                std::vector<float> winLUFS;
-
-                for (int i = 0; i <= numSubBlocks - win; ++i)
-                {
-                    double sum = 0;
-                    for (int j = 0; j < win; ++j) sum += subMS[i + j];
-                    double pwr = sum / win;
-                    winPower.push_back(pwr);
-                    winLUFS.push_back(toLUFS(pwr));
-                }
-
-                // Absolute gate (-70 LUFS)
-                double absSum = 0;
-                int absCnt = 0;
-                for (size_t i = 0; i < winPower.size(); ++i)
-                {
-                    if (winLUFS[i] > -70.0f)
-                    {
-                        absSum += winPower[i];
-                        absCnt++;
-                    }
-                }
-
-                if (absCnt > 0)
-                {
-                    float relThresh = toLUFS(absSum / absCnt) - 10.0f;
-
-                    double relSum = 0;
-                    int relCnt = 0;
-                    for (size_t i = 0; i < winPower.size(); ++i)
-                    {
-                        if (winLUFS[i] > -70.0f && winLUFS[i] > relThresh)
-                        {
-                            relSum += winPower[i];
-                            relCnt++;
-                        }
-                    }
-                    result.integratedLUFS = (relCnt > 0) ? toLUFS(relSum / relCnt) : -100.0f;
-                }
-                else
-                {
-                    result.integratedLUFS = -100.0f;
-                }
-            }
-
-            // Center channel integrated LUFS (EBU R128 dual gating, ch[2] only)
-            if (hasCenter && !centerSubMS.empty())
-            {
-                const int win = 4;
-                const int numCenterSubs = (int)centerSubMS.size();
-                std::vector<double> cWinPower;
-                std::vector<float> cWinLUFS;
-
-                for (int i = 0; i <= numCenterSubs - win; ++i)
-                {
-                    double sum = 0;
-                    for (int j = 0; j < win; ++j) sum += centerSubMS[i + j];
-                    double pwr = sum / win;
-                    cWinPower.push_back(pwr);
-                    cWinLUFS.push_back(toLUFS(pwr));
-                }
-
-                // Absolute gate (-70 LUFS)
-                double absSum = 0;
-                int absCnt = 0;
-                for (size_t i = 0; i < cWinPower.size(); ++i)
-                {
-                    if (cWinLUFS[i] > -70.0f)
-                    {
-                        absSum += cWinPower[i];
-                        absCnt++;
-                    }
-                }
-
-                if (absCnt > 0)
-                {
-                    float relThresh = toLUFS(absSum / absCnt) - 10.0f;
-                    double relSum = 0;
-                    int relCnt = 0;
-                    for (size_t i = 0; i < cWinPower.size(); ++i)
-                    {
-                        if (cWinLUFS[i] > -70.0f && cWinLUFS[i] > relThresh)
-                        {
-                            relSum += cWinPower[i];
-                            relCnt++;
-                        }
-                    }
-                    result.centerLUFS = (relCnt > 0) ? toLUFS(relSum / relCnt) : -100.0f;
-                }
+                result.peakDBFS = analysis.truePeakDb;
+                result.momentaryMaxLUFS = analysis.momentaryMaxLufs;
+                result.shortTermMaxLUFS = analysis.shortTermMaxLufs;
+                result.integratedLUFS = analysis.integratedLufs;
+                result.centerLUFS = analysis.centreIntegratedLufs;
+                result.numChannels = analysis.numChannels;
             }
 
             callbackResult(result);
@@ -1207,6 +966,7 @@ private:
     private:
         juce::File audioFile;
         juce::Component::SafePointer<HoloNonoComponent> safeOwner;
+        OfflineLoudnessResult precomputed;
 
         void callbackResult(const NonoAnalysisResult& r)
         {
@@ -1317,6 +1077,8 @@ private:
     float ripplePhase = 0.0f;
     bool isDragHovering = false;
     juce::File pendingAnalysisFile;
+    juce::File precomputedAnalysisFile;
+    OfflineLoudnessResult precomputedAnalysis;
     std::unique_ptr<juce::FileChooser> fileChooser;
 
     // Smile + orbit animation state
@@ -1392,6 +1154,95 @@ private:
     juce::Image guobaSprite;
     juce::Image guobaNose;
 
+    //==========================================================================
+    // Sprite cache: glow/shadow, ears, body and visor don't change between
+    // frames (only move), so they are pre-rendered per pose and pixel scale
+    //==========================================================================
+    enum SpritePose  { nonoPose, guobaFurPose, guobaHoloPose };
+    enum SpriteLayer { groundLayer, earsLayer, bodyLayer, visorLayer, numSpriteLayers };
+
+    /** What the static layers are drawn from, by value so the cache can paint off-thread. */
+    struct ShellStyle
+    {
+        bool guoba = false;
+        juce::Colour accent;
+        juce::Image sprite;             // GUOBA body
+        float earBob = 0.0f;
+        float visorAlpha = 1.0f;
+        float holoTransition = 0.0f;
+    };
+
+    std::unique_ptr<NonoSpriteCache> spriteCache;
+
+    ShellStyle shellStyle() const
+    {
+        return { isGuoba(), accentCol(), guobaSprite, earBobOffset, visorAlpha, holoTransition };
+    }
+
+    /** Cached poses are at rest: ears unbobbed (the bob is a blit offset), visor fully in. */
+    static ShellStyle spriteStyle(int pose, const juce::Image& sprite)
+    {
+        ShellStyle style;
+        style.guoba = (pose != nonoPose);
+        style.accent = style.guoba ? guobaGold : nonoBlue;
+        style.sprite = sprite;
+        style.holoTransition = (pose == guobaHoloPose) ? 1.0f : 0.0f;
+        return style;
+    }
+
+    /** GUOBA's visor only has a sprite between fades (fur or holo, fully opaque). */
+    int visorPose() const
+    {
+        if (! isGuoba())
+            return nonoPose;
+        if (visorAlpha < 1.0f)
+            return -1;
+        if (holoTransition <= 0.0f)
+            return guobaFurPose;
+        return holoTransition >= 1.0f ? guobaHoloPose : -1;
+    }
+
+    /** Extent of each layer around the body centre, in radii (see the draw functions). */
+    static juce::Rectangle<float> spriteLayerBounds(int pose, int layer)
+    {
+        const bool nono = (pose == nonoPose);
+        switch (layer)
+        {
+            case groundLayer:  return pose == guobaHoloPose ? juce::Rectangle<float>() : juce::Rectangle<float>(-0.85f, 1.05f, 1.7f, 0.75f);
+            case earsLayer:    return nono ? juce::Rectangle<float>(-1.15f, -2.05f, 2.3f, 1.2f) : juce::Rectangle<float>();
+            case bodyLayer:    return nono ? juce::Rectangle<float>(-1.05f, -1.05f, 2.1f, 2.1f)
+                                           : (pose == guobaFurPose ? juce::Rectangle<float>(-2.0f, -1.65f, 4.0f, 4.05f)
+                                                                   : juce::Rectangle<float>());
+            case visorLayer:   return { -0.9f, -0.85f, 1.8f, 1.6f };
+            default:           return {};
+        }
+    }
+
+    static void paintSpriteLayer(juce::Graphics& g, const ShellStyle& style, int layer, float cx, float cy, float r)
+    {
+        switch (layer)
+        {
+            case groundLayer:  drawAntiGravityGlow(g, style, cx, cy, r); drawShadow(g, cx, cy, r); break;
+            case earsLayer:    drawHolographicEars(g, style, cx, cy, r, 1.0f); break;
+            case bodyLayer:    drawBody(g, style, cx, cy, r, 1.0f); break;
+            case visorLayer:   drawVisor(g, style, cx, cy, r, 1.0f); break;
+            default:           break;
+        }
+    }
+
+    /** Queue this size's atlases before the first frames ask for them. */
+    void prewarmSprites()
+    {
+        if (spriteCache == nullptr || getHeight() < 40)
+            return;
+
+        const float radius = static_cast<float>(juce::jmin(getWidth(), getHeight())) * 0.18f;
+        const float pixelScale = juce::Component::getApproximateScaleFactorForComponent(this);
+        spriteCache->prewarm(isGuoba() ? guobaFurPose : nonoPose, radius, pixelScale);
+        if (isGuoba())
+            spriteCache->prewarm(guobaHoloPose, radius, pixelScale);
+    }
+
     // Skin selector dropdown
     juce::ComboBox skinMenu;
 
@@ -1400,9 +1251,9 @@ private:
     float visorAlphaTarget = 1.0f;
 
     //==========================================================================
-    // Timer
+    // Frame tick
     //==========================================================================
-    void timerCallback() override
+    void frameTick() override
     {
         // 60Hz → 30Hz smart throttle during mouse drag
         if (juce::ModifierKeys::currentModifiers.isAnyMouseButtonDown())
@@ -1460,9 +1311,8 @@ private:
         }
 
         // Audio level
-        float peakL = audioProcessor.peakLevelL.load(std::memory_order_relaxed);
-        float peakR = audioProcessor.peakLevelR.load(std::memory_order_relaxed);
-        float peak = juce::jmax(peakL, peakR);
+        const auto& snapshot = audioProcessor.getMeterSnapshot();
+        float peak = juce::jmax(snapshot.peakL, snapshot.peakR);
         float rawLevel = juce::jmap(juce::jlimit(-60.0f, 0.0f, peak), -60.0f, 0.0f, 0.0f, 1.0f);
         audioLevel += (rawLevel - audioLevel) * 0.2f;
 
@@ -1593,7 +1443,7 @@ private:
             }
 
             if (mouseChanged)
-                repaint();
+                repaintFrame();
         }
 
         float collLerp = (frontAnim == FrontAnim::CollisionHit) ? 0.4f : 0.25f;
@@ -1837,7 +1687,7 @@ private:
                 isOrbitLocked = false;
         }
 
-        repaint();
+        repaintFrame();
     }
 
     //==========================================================================
@@ -2037,8 +1887,13 @@ private:
         liquidHeight = 1.0f;       // refill tube
         bubbleFadeAlpha = 1.0f;    // reset bubble opacity
 
+        OfflineLoudnessResult precomputed;
+        if (file == precomputedAnalysisFile)
+            precomputed = std::move(precomputedAnalysis);
+        precomputedAnalysisFile = juce::File();
+
         auto safeThis = juce::Component::SafePointer<HoloNonoComponent>(this);
-        analysisThread = std::make_unique<AnalysisThread>(file, safeThis);
+        analysisThread = std::make_unique<AnalysisThread>(file, safeThis, std::move(precomputed));
         analysisThread->startThread();
     }
 
@@ -2091,28 +1946,28 @@ private:
     //==========================================================================
     // Drawing: Common
     //==========================================================================
-    void drawAntiGravityGlow(juce::Graphics& g, float cx, float cy, float r)
+    static void drawAntiGravityGlow(juce::Graphics& g, const ShellStyle& style, float cx, float cy, float r)
     {
         const float glowY = cy + r + r * 0.08f;
         juce::ColourGradient grad(
-            accentCol().withAlpha(0.18f), cx, glowY,
-            accentCol().withAlpha(0.0f), cx, glowY + r * 0.7f, false);
+            style.accent.withAlpha(0.18f), cx, glowY,
+            style.accent.withAlpha(0.0f), cx, glowY + r * 0.7f, false);
         g.setGradientFill(grad);
         g.fillEllipse(cx - r * 0.8f, glowY, r * 1.6f, r * 0.65f);
     }
 
-    void drawShadow(juce::Graphics& g, float cx, float cy, float r)
+    static void drawShadow(juce::Graphics& g, float cx, float cy, float r)
     {
         g.setColour(juce::Colour(0x18000000));
         g.fillEllipse(cx - r * 0.8f, cy + r + r * 0.15f, r * 1.6f, r * 0.24f);
     }
 
-    void drawBody(juce::Graphics& g, float cx, float cy, float r, float hScale)
+    static void drawBody(juce::Graphics& g, const ShellStyle& style, float cx, float cy, float r, float hScale)
     {
-        if (isGuoba())
+        if (style.guoba)
         {
             // === GUOBA: sprite image ===
-            if (hScale < 0.1f || guobaSprite.isNull()) return;
+            if (hScale < 0.1f || style.sprite.isNull()) return;
 
             float spriteH = r * 4.0f;
             float spriteW = spriteH;
@@ -2120,9 +1975,9 @@ private:
             float spriteY = anchorY - spriteH * 0.38f;
             float sw = spriteW * hScale;
             g.setOpacity(1.0f);
-            g.drawImage(guobaSprite,
+            g.drawImage(style.sprite,
                 cx - sw * 0.5f, spriteY, sw, spriteH,
-                0, 0, guobaSprite.getWidth(), guobaSprite.getHeight());
+                0, 0, style.sprite.getWidth(), style.sprite.getHeight());
         }
         else
         {
@@ -2163,9 +2018,9 @@ private:
     //==========================================================================
     // Drawing: Holographic Ears (Seer-style solid base + energy blade)
     //==========================================================================
-    void drawHolographicEars(juce::Graphics& g, float cx, float cy, float r, float hScale)
+    static void drawHolographicEars(juce::Graphics& g, const ShellStyle& style, float cx, float cy, float r, float hScale)
     {
-        if (isGuoba())
+        if (style.guoba)
             return;  // GUOBA: ears are part of the sprite image
 
         // === NONO: Seer-style solid base capsule + energy blade ===
@@ -2178,8 +2033,8 @@ private:
 
         struct EarSpec { float xOff, yOff, scale, bob; };
         EarSpec specs[2] = {
-            { -0.72f, -0.18f, 0.95f, earBobOffset },
-            {  0.72f, -0.18f, 0.95f, earBobOffset }
+            { -0.72f, -0.18f, 0.95f, style.earBob },
+            {  0.72f, -0.18f, 0.95f, style.earBob }
         };
 
         for (int i = 0; i < 2; ++i)
@@ -2698,7 +2553,7 @@ private:
     // Width 81.5, top-half 32.5, bottom-half 24 (shortened), fold at chord-width=40
     // Bottom edge: gentle chin-wave ("M" bump) inspired by 喵喵 face shape
     //==========================================================================
-    juce::Path buildVisorPath(float cx, float vcy, float r, float hScale) const
+    static juce::Path buildVisorPath(float cx, float vcy, float r, float hScale)
     {
         const float a    = r * 0.8094f * hScale;  // semi-width
         const float bTop = r * 0.6448f;           // upper semi-height (unchanged)
@@ -2747,9 +2602,9 @@ private:
     //==========================================================================
     // Drawing: Front face
     //==========================================================================
-    void drawVisor(juce::Graphics& g, float cx, float cy, float r, float hScale)
+    static void drawVisor(juce::Graphics& g, const ShellStyle& style, float cx, float cy, float r, float hScale)
     {
-        if (!isGuoba())
+        if (!style.guoba)
         {
             // === NONO: dark elliptical visor with blue neon frame ===
             float vw = r * 1.7f * hScale;
@@ -2759,17 +2614,17 @@ private:
             g.setColour(screenDark);
             g.fillEllipse(cx - vw / 2.0f, vcy - vh / 2.0f, vw, vh);
 
-            g.setColour(accentCol().withAlpha(0.08f));
+            g.setColour(style.accent.withAlpha(0.08f));
             g.drawEllipse(cx - vw / 2.0f, vcy - vh / 2.0f, vw, vh, 8.0f);
-            g.setColour(accentCol().withAlpha(0.30f));
+            g.setColour(style.accent.withAlpha(0.30f));
             g.drawEllipse(cx - vw / 2.0f, vcy - vh / 2.0f, vw, vh, 3.5f);
-            g.setColour(accentCol().withAlpha(0.85f));
+            g.setColour(style.accent.withAlpha(0.85f));
             g.drawEllipse(cx - vw / 2.0f, vcy - vh / 2.0f, vw, vh, 1.5f);
             return;
         }
 
         // === GUOBA: fur pattern / holo visor with yellow frame ===
-        if (visorAlpha < 0.01f) return;
+        if (style.visorAlpha < 0.01f) return;
 
         float vcy = cy - r * 0.06f;  // shifted up slightly
         auto visorPath = buildVisorPath(cx, vcy, r, hScale);
@@ -2782,17 +2637,17 @@ private:
         g.saveState();
         g.reduceClipRegion(visorPath);
 
-        if (holoTransition > 0.99f)
+        if (style.holoTransition > 0.99f)
         {
             // ===== FULL HOLO: gray-white gradient fill (translucent, airy) =====
             juce::ColourGradient holoGrad(
-                juce::Colour(0xFFF6F6F8).withAlpha(visorAlpha), cx, vTop,
-                juce::Colour(0xFFD8D8DE).withAlpha(visorAlpha), cx, vBot, false);
-            holoGrad.addColour(0.35, juce::Colour(0xFFECECF0).withAlpha(visorAlpha));
+                juce::Colour(0xFFF6F6F8).withAlpha(style.visorAlpha), cx, vTop,
+                juce::Colour(0xFFD8D8DE).withAlpha(style.visorAlpha), cx, vBot, false);
+            holoGrad.addColour(0.35, juce::Colour(0xFFECECF0).withAlpha(style.visorAlpha));
             g.setGradientFill(holoGrad);
             g.fillRect(maskL - r, vTop, (maskR - maskL) + r * 2.0f, vBot - vTop);
         }
-        else if (holoTransition < 0.01f)
+        else if (style.holoTransition < 0.01f)
         {
             // ===== FULL NORMAL: three-arch fur pattern =====
             float leftEyeX  = cx - r * 0.30f * hScale;
@@ -2805,7 +2660,7 @@ private:
             float transY = vcy + r * 0.05f;
 
             // White base
-            g.setColour(juce::Colour(0xFFFFFEFA).withAlpha(visorAlpha));
+            g.setColour(juce::Colour(0xFFFFFEFA).withAlpha(style.visorAlpha));
             g.fillRect(maskL - r, vTop, (maskR - maskL) + r * 2.0f, vBot - vTop);
 
             // Gray top with three upward arches
@@ -2820,13 +2675,13 @@ private:
             grayTopPath.quadraticTo(lcCtrlX, cheekCtrlY, maskL, baseY);
             grayTopPath.closeSubPath();
 
-            g.setColour(juce::Colour(0xFFCCCCCC).withAlpha(visorAlpha * 0.65f));
+            g.setColour(juce::Colour(0xFFCCCCCC).withAlpha(style.visorAlpha * 0.65f));
             g.fillPath(grayTopPath);
         }
         else
         {
             // ===== TRANSITION: cross-fade between fur and solid =====
-            float na = 1.0f - holoTransition;
+            float na = 1.0f - style.holoTransition;
 
             // Fur layer
             {
@@ -2839,7 +2694,7 @@ private:
                 float rightEyeInnerX = rightEyeX - r * 0.15f * hScale;
                 float transY = vcy + r * 0.05f;
 
-                g.setColour(juce::Colour(0xFFFFFEFA).withAlpha(visorAlpha * na));
+                g.setColour(juce::Colour(0xFFFFFEFA).withAlpha(style.visorAlpha * na));
                 g.fillRect(maskL - r, vTop, (maskR - maskL) + r * 2.0f, vBot - vTop);
 
                 juce::Path grayTopPath;
@@ -2853,15 +2708,15 @@ private:
                 grayTopPath.quadraticTo(lcCtrlX, cheekCtrlY, maskL, baseY);
                 grayTopPath.closeSubPath();
 
-                g.setColour(juce::Colour(0xFFCCCCCC).withAlpha(visorAlpha * na * 0.65f));
+                g.setColour(juce::Colour(0xFFCCCCCC).withAlpha(style.visorAlpha * na * 0.65f));
                 g.fillPath(grayTopPath);
             }
 
             // Holo gradient layer on top
             juce::ColourGradient holoGrad(
-                juce::Colour(0xFFF6F6F8).withAlpha(visorAlpha * holoTransition), cx, vTop,
-                juce::Colour(0xFFD8D8DE).withAlpha(visorAlpha * holoTransition), cx, vBot, false);
-            holoGrad.addColour(0.35, juce::Colour(0xFFECECF0).withAlpha(visorAlpha * holoTransition));
+                juce::Colour(0xFFF6F6F8).withAlpha(style.visorAlpha * style.holoTransition), cx, vTop,
+                juce::Colour(0xFFD8D8DE).withAlpha(style.visorAlpha * style.holoTransition), cx, vBot, false);
+            holoGrad.addColour(0.35, juce::Colour(0xFFECECF0).withAlpha(style.visorAlpha * style.holoTransition));
             g.setGradientFill(holoGrad);
             g.fillRect(maskL - r, vTop, (maskR - maskL) + r * 2.0f, vBot - vTop);
         }
@@ -2869,11 +2724,11 @@ private:
         g.restoreState();
 
         // Yellow visor frame glow rings (always visible)
-        g.setColour(accentCol().withAlpha(0.08f * visorAlpha));
+        g.setColour(style.accent.withAlpha(0.08f * style.visorAlpha));
         g.strokePath(visorPath, juce::PathStrokeType(8.0f));
-        g.setColour(accentCol().withAlpha(0.30f * visorAlpha));
+        g.setColour(style.accent.withAlpha(0.30f * style.visorAlpha));
         g.strokePath(visorPath, juce::PathStrokeType(3.5f));
-        g.setColour(accentCol().withAlpha(0.85f * visorAlpha));
+        g.setColour(style.accent.withAlpha(0.85f * style.visorAlpha));
         g.strokePath(visorPath, juce::PathStrokeType(1.5f));
     }
 
@@ -3733,7 +3588,7 @@ private:
 
         // Build metrics array: 4 base + optional center
         MetricInfo baseMetrics[5] = {
-            { u8"\u5cf0\u503c",             analysisResult.peakDBFS,         "dBFS" },
+            { u8"\u5cf0\u503c",             analysisResult.peakDBFS,         "dBTP" },
             { u8"\u77ac\u65f6\u6700\u5927", analysisResult.momentaryMaxLUFS, "LUFS" },
             { u8"\u77ed\u671f\u6700\u5927", analysisResult.shortTermMaxLUFS, "LUFS" },
             { u8"\u5e73\u5747\u54cd\u5ea6", analysisResult.integratedLUFS,   "LUFS" },
@@ -4,7 +4,8 @@
     GOODMETER - Peak and LUFS Level Meters
 
     Translated from Levels.tsx
-    Features: Peak bars with gradient, peak hold indicators, LUFS readout
+    Features: Peak bars with gradient, peak hold indicators, LUFS readout,
+    and a per-channel momentary loudness strip on surround buses
   ==============================================================================
 */
 
@@ -13,10 +14,10 @@
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
+#include "FrameScheduler.h"
 
 //==============================================================================
-class LevelsMeterComponent : public juce::Component,
-                             public juce::Timer
+class LevelsMeterComponent : public juce::Component
 {
 public:
     //==========================================================================
@@ -24,12 +25,6 @@ public:
         : audioProcessor(processor)
     {
         setSize(100, 200);
-        startTimerHz(60);  // 60Hz visual refresh
-    }
-
-    ~LevelsMeterComponent() override
-    {
-        stopTimer();
     }
 
     //==========================================================================
@@ -121,9 +116,11 @@ public:
             auto barsBounds = bounds.removeFromLeft(barsWidth);
             bounds.removeFromLeft(spacing);
             auto infoBounds = bounds;
+            auto stripBounds = infoBounds.removeFromBottom(channelStripHeight(infoBounds.getHeight()));
 
             drawVerticalPeakBars(g, barsBounds);
             drawLUFSInfo(g, infoBounds);
+            drawChannelLoudness(g, stripBounds);
         }
         else
         {
@@ -137,7 +134,9 @@ public:
 
             bounds.removeFromTop(spacing);
             auto infoBounds = bounds;
+            auto stripBounds = infoBounds.removeFromBottom(channelStripHeight(infoBounds.getHeight()));
             drawLUFSInfo(g, infoBounds);
+            drawChannelLoudness(g, stripBounds);
         }
     }
 
@@ -148,7 +147,7 @@ public:
 
     //==========================================================================
     /**
-     * Update meter values from processor (called from PluginEditor::timerCallback)
+     * Update meter values from processor (called once per frame by the owner)
      */
     void updateMetrics(float peakL_dB, float peakR_dB, float momentaryLUFS,
                        float shortTermLUFS, float integratedLUFS, float luRangeVal)
@@ -217,44 +216,63 @@ public:
             }
         }
 
-        // Pre-render text caches (moves drawText out of paint/CATransaction)
+        // Pre-render text caches (moves drawText out of paint/CATransaction);
+        // off screen only the smoothing above keeps running
+        if (FrameScheduler::isOnScreen(*this))
         {
             auto bounds = getLocalBounds();
-            if (!bounds.isEmpty())
+            const bool useVerticalLayout = shouldUseVerticalLayout(bounds);
+            int infoW, infoH;
+
+            if (useVerticalLayout)
+            {
+                // Vertical layout: bars on left, info on right
+                const int spacing = juce::jlimit(5, 12, static_cast<int>(bounds.getWidth() * 0.02f));
+                const int barsWidth = juce::jlimit(60, 160, static_cast<int>(bounds.getWidth() * 0.25f));
+                infoW = bounds.getWidth() - barsWidth - spacing;
+                infoH = bounds.getHeight();
+            }
+            else
+            {
+                // Horizontal layout: bars on top, info below
+                const int totalHeight = bounds.getHeight();
+                const int barsHeight = static_cast<int>(totalHeight * 0.55f);
+                const int spacing = 10;
+                infoW = bounds.getWidth();
+                infoH = totalHeight - barsHeight - spacing;
+            }
+
+            infoH -= channelStripHeight(infoH);
+            prerenderLUFSText(infoW, infoH);
+
+            // Tick labels: compute bar width same as drawPeakBars
+            if (!useVerticalLayout)
             {
-                const bool useVerticalLayout = shouldUseVerticalLayout(bounds);
-                int infoW, infoH;
-
-                if (useVerticalLayout)
-                {
-                    // Vertical layout: bars on left, info on right
-                    const int spacing = juce::jlimit(5, 12, static_cast<int>(bounds.getWidth() * 0.02f));
-                    const int barsWidth = juce::jlimit(60, 160, static_cast<int>(bounds.getWidth() * 0.25f));
-                    infoW = bounds.getWidth() - barsWidth - spacing;
-                    infoH = bounds.getHeight();
-                }
-                else
-                {
-                    // Horizontal layout: bars on top, info below
-                    const int totalHeight = bounds.getHeight();
-                    const int barsHeight = static_cast<int>(totalHeight * 0.55f);
-                    const int spacing = 10;
-                    infoW = bounds.getWidth();
-                    infoH = totalHeight - barsHeight - spacing;
-                }
-
-                prerenderLUFSText(infoW, infoH);
-
-                // Tick labels: compute bar width same as drawPeakBars
-                if (!useVerticalLayout)
-                {
-                    auto barArea = bounds.reduced(20, 0).withTrimmedTop(16);
-                    prerenderTickText(barArea.getWidth());
-                }
+                auto barArea = bounds.reduced(20, 0).withTrimmedTop(16);
+                prerenderTickText(barArea.getWidth());
             }
         }
 
-        repaint();
+        FrameScheduler::getInstance().repaint(*this);
+    }
+
+    /**
+     * Per-channel momentary LUFS (called once per frame by the owner, before
+     * updateMetrics so the text cache is laid out for it). Only buses wider
+     * than stereo get the strip.
+     */
+    void updateChannelLoudness(const float* channelLufs, int numChannels)
+    {
+        numChannels = juce::jlimit(0, maxChannelStrips, numChannels);
+        if ((numChannels > 2) != (numChannelStrips > 2))
+        {
+            lufsTextCache = {};     // the info box changes height
+            displayChannelLufs.fill(-70.0f);
+        }
+        numChannelStrips = numChannels;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            displayChannelLufs[(size_t) ch] += (channelLufs[ch] - displayChannelLufs[(size_t) ch]) * 0.3f;
     }
 
     /**
@@ -326,6 +344,11 @@ private:
     // Loudness standard
     juce::String standard = "EBU R128";
 
+    // Per-channel loudness strip (surround only)
+    static constexpr int maxChannelStrips = MeterSnapshot::maxLoudnessChannels;
+    std::array<float, maxChannelStrips> displayChannelLufs {};
+    int numChannelStrips = 0;
+
     // Constants (from Levels.tsx)
     static constexpr float minDb = -60.0f;
     static constexpr float maxDb = 0.0f;
@@ -342,13 +365,6 @@ private:
     int lastLufsHeight = 0;
     float lastLufsScale = 0.0f;
 
-    //==========================================================================
-    void timerCallback() override
-    {
-        // Peak hold decay is handled in updateMetrics()
-        // This timer just ensures smooth repaints
-    }
-
     //==========================================================================
     bool shouldUseVerticalLayout(juce::Rectangle<int> bounds) const
     {
@@ -362,6 +378,33 @@ private:
             || (mobileCharts && bounds.getWidth() < widthThreshold);
     }
 
+    int channelStripHeight(int infoHeight) const
+    {
+        return numChannelStrips > 2 && infoHeight >= 56 ? 14 : 0;
+    }
+
+    /** One thin bar per channel, -60..0 LUFS on the peak bars' scale. */
+    void drawChannelLoudness(juce::Graphics& g, juce::Rectangle<int> bounds) const
+    {
+        if (bounds.isEmpty() || numChannelStrips <= 2)
+            return;
+
+        auto area = bounds.toFloat().withTrimmedTop(4.0f);
+        const float cellW = area.getWidth() / static_cast<float>(numChannelStrips);
+
+        for (int ch = 0; ch < numChannelStrips; ++ch)
+        {
+            const auto cell = juce::Rectangle<float>(area.getX() + cellW * ch, area.getY(), cellW, area.getHeight())
+                                  .reduced(1.0f, 0.0f);
+            g.setColour(dataGridInk(0.10f));
+            g.fillRoundedRectangle(cell, 2.0f);
+
+            const float fill = dbToX(displayChannelLufs[(size_t) ch], cell.getWidth());
+            g.setColour(GoodMeterLookAndFeel::accentPink.withAlpha(0.85f));
+            g.fillRoundedRectangle(cell.withWidth(fill), 2.0f);
+        }
+    }
+
     juce::Colour dataPlateFill() const
     {
         return marathonDarkStyle ? juce::Colour(0xFF0A0D13)
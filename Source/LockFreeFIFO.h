@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+    LockFreeFIFO.h
+    GOODMETER - Single-producer / single-consumer frame FIFO
+
+    Fixed-capacity ring of fixed-size frames, used to hand spectra and
+    goniometer sample batches from the DSP side to the GUI side without locks.
+
+    Slot count and slot size are both template parameters, so each path pays
+    only for the frames it carries (a 2048-bin spectrum, a 512-sample
+    goniometer batch).
+
+    Besides copying push()/pop(), both sides can work in place:
+      - Producer: reserveWrite() → fill the slot → commitWrite()
+      - Consumer: peekRead() / peekLatest() → read the slot → commitRead()
+    A reserved or peeked slot is never touched by the other side until it
+    is committed.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+ * Lock-free FIFO for passing frames from the DSP side (audio thread or
+ * analysis worker) to the GUI thread
+ */
+template <typename T, size_t NumSlots, size_t SlotSize>
+class LockFreeFIFO
+{
+public:
+    static constexpr size_t numSlots = NumSlots;
+    static constexpr size_t slotSize = SlotSize;
+
+    LockFreeFIFO() : writeIndex(0), readIndex(0) {}
+
+    //==========================================================================
+    // Producer side
+    //==========================================================================
+
+    /** Slot to fill in place, or nullptr when full. Repeated calls return the same slot. */
+    T* reserveWrite() noexcept
+    {
+        // Writer owns writeIndex → relaxed load is sufficient
+        const auto currentWrite = writeIndex.load(std::memory_order_relaxed);
+
+        // Must acquire readIndex to see consumer's latest progress
+        if ((currentWrite + 1) % NumSlots == readIndex.load(std::memory_order_acquire))
+            return nullptr; // Buffer full
+
+        return buffer[currentWrite].data();
+    }
+
+    /** Publish the slot returned by reserveWrite(). */
+    void commitWrite() noexcept
+    {
+        const auto currentWrite = writeIndex.load(std::memory_order_relaxed);
+        // Release: ensure slot writes are visible before index advances
+        writeIndex.store((currentWrite + 1) % NumSlots, std::memory_order_release);
+    }
+
+    bool push(const T* data, size_t numSamples) noexcept
+    {
+        auto* slot = reserveWrite();
+        if (slot == nullptr)
+            return false;
+
+        std::copy(data, data + juce::jmin(numSamples, SlotSize), slot);
+        commitWrite();
+        return true;
+    }
+
+    //==========================================================================
+    // Consumer side
+    //==========================================================================
+
+    /** Oldest ready slot, or nullptr when empty. */
+    const T* peekRead() noexcept
+    {
+        // Reader owns readIndex → relaxed load is sufficient
+        const auto currentRead = readIndex.load(std::memory_order_relaxed);
+
+        // Must acquire writeIndex to see producer's latest data
+        if (currentRead == writeIndex.load(std::memory_order_acquire))
+            return nullptr; // Buffer empty
+
+        return buffer[currentRead].data();
+    }
+
+    /** Drop everything but the newest ready slot and return it (nullptr when empty). */
+    const T* peekLatest() noexcept
+    {
+        const auto currentWrite = writeIndex.load(std::memory_order_acquire);
+        const auto currentRead = readIndex.load(std::memory_order_relaxed);
+
+        if (currentRead == currentWrite)
+            return nullptr;
+
+        const auto newest = (currentWrite + NumSlots - 1) % NumSlots;
+        // Release: hand the skipped slots back to the producer
+        readIndex.store(newest, std::memory_order_release);
+        return buffer[newest].data();
+    }
+
+    /** Release the slot returned by peekRead() / peekLatest(). */
+    void commitRead() noexcept
+    {
+        const auto currentRead = readIndex.load(std::memory_order_relaxed);
+        // Release: ensure slot reads complete before index advances
+        readIndex.store((currentRead + 1) % NumSlots, std::memory_order_release);
+    }
+
+    bool pop(T* dest, size_t numSamples) noexcept
+    {
+        const auto* slot = peekRead();
+        if (slot == nullptr)
+            return false;
+
+        std::copy(slot, slot + juce::jmin(numSamples, SlotSize), dest);
+        commitRead();
+        return true;
+    }
+
+private:
+    static_assert(NumSlots >= 2, "One slot is always kept free to tell full from empty");
+
+    std::array<std::array<T, SlotSize>, NumSlots> buffer;
+    std::atomic<size_t> writeIndex;
+    std::atomic<size_t> readIndex;
+};
@@ -0,0 +1,630 @@
+/*
+  ==============================================================================
+    LoudnessEngine.h
+    GOODMETER - Incremental BS.1770 loudness engine
+
+    Momentary (400 ms) and Short-Term (3 s) loudness are built from running
+    100 ms sub-block power sums instead of re-summing whole sample windows:
+
+      - Every K-weighted sample is squared into the current sub-block sum
+        (channel-vectorised filter bank, BS.1770-4 channel weights)
+      - A finished sub-block is pushed into a 32-entry ring (3.2 s of history)
+      - Momentary = partial sub-block + last 3 full + leading fraction of the 4th
+        Short-Term = partial sub-block + last 29 full + leading fraction of the 30th
+
+    Cost per callback is O(numSamples) plus O(30) every 100 ms — independent
+    of window length. Memory is a few hundred bytes instead of two large
+    circular sample arrays.
+
+    Integrated loudness uses 400 ms gating blocks with 75% overlap (one per
+    finished sub-block, as BS.1770-4 specifies). Each block lands in a fixed
+    0.02 LU histogram that also keeps the exact power sum per bin, so the
+    absolute (-70 LUFS) and relative (-10 LU) gates are evaluated in constant
+    time and memory for sessions of any length.
+
+    Loudness Range (EBU Tech 3342) feeds every full 3 s short-term value
+    (10 Hz) into a second histogram; the -20 LU relative gate and the
+    10th/95th percentiles are read from it without sorting or allocation.
+
+    Every length is derived from the sample rate (sub-block = 100 ms), so
+    the windows and gating blocks are exact at any rate. 44.1 / 48 / 88.2 /
+    96 / 176.4 / 192 kHz get a kernel with the sub-block length as a
+    compile-time constant, picked once in prepare(); other rates use the
+    generic kernel with the length rounded to the nearest sample.
+
+    Thread safety model:
+      - Audio thread only: prepare()/reset()/process()/processStereo()
+      - Results are published by the caller through its own atomics
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+
+//==============================================================================
+/**
+ * Channel-vectorised K-weighting filter bank (ITU-R BS.1770-4)
+ *
+ * Pre-filter (high shelf, +4 dB) and RLB high-pass as two TDF-II biquads,
+ * with coefficients from the standard's analogue prototypes via bilinear
+ * transform (identical to the published 48 kHz table, valid at any rate).
+ * Channels are packed into SIMD lanes, so one pass filters 4 channels.
+ */
+class KWeightingBank
+{
+public:
+    static constexpr int kMaxChannels = 16;  // 7.1.4 = 12, padded to SIMD width
+
+    void prepare(double sampleRate, int numChannelsToUse)
+    {
+        numChannels = juce::jlimit(1, kMaxChannels, numChannelsToUse);
+
+        // Stage 1: high shelf pre-filter
+        {
+            const double Vh = 1.58489319246111; // 10^(4/20)
+            const double Vb = std::sqrt(Vh);
+            const double K = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+            const double Q = 0.7071752369554196;
+            const double denom = 1.0 + K / Q + K * K;
+            shelf = { static_cast<float>((Vh + Vb * K / Q + K * K) / denom),
+                      static_cast<float>(2.0 * (K * K - Vh) / denom),
+                      static_cast<float>((Vh - Vb * K / Q + K * K) / denom),
+                      static_cast<float>(2.0 * (K * K - 1.0) / denom),
+                      static_cast<float>((1.0 - K / Q + K * K) / denom) };
+        }
+        // Stage 2: RLB high-pass
+        {
+            const double Q = 0.5003270373238773;
+            const double K = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+            const double denom = 1.0 + K / Q + K * K;
+            highPass = { static_cast<float>(1.0 / denom),
+                         static_cast<float>(-2.0 / denom),
+                         static_cast<float>(1.0 / denom),
+                         static_cast<float>(2.0 * (K * K - 1.0) / denom),
+                         static_cast<float>((1.0 - K / Q + K * K) / denom) };
+        }
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto* state : { &shelfZ1, &shelfZ2, &highPassZ1, &highPassZ2 })
+            state->fill(0.0f);
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    //==========================================================================
+    /** Filter numSamples from the first numActive channels (offset applied)
+     *  and add each channel's sum of squared K-weighted samples to
+     *  energies[ch]. Channels past numActive are neither read nor advanced. */
+    void processAndAccumulate(const float* const* channels, int numActive, int offset,
+                              int numSamples, float* energies) noexcept
+    {
+        numActive = juce::jlimit(0, numChannels, numActive);
+
+#if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+        constexpr int width = static_cast<int>(Vec::SIMDNumElements);
+
+        const Vec sb0 = Vec::expand(shelf.b0), sb1 = Vec::expand(shelf.b1), sb2 = Vec::expand(shelf.b2);
+        const Vec sa1 = Vec::expand(shelf.a1), sa2 = Vec::expand(shelf.a2);
+        const Vec hb0 = Vec::expand(highPass.b0), hb1 = Vec::expand(highPass.b1), hb2 = Vec::expand(highPass.b2);
+        const Vec ha1 = Vec::expand(highPass.a1), ha2 = Vec::expand(highPass.a2);
+
+        for (int first = 0; first < numActive; first += width)
+        {
+            const int lanes = juce::jmin(width, numActive - first);
+            auto* s1 = shelfZ1.data() + first;
+            auto* s2 = shelfZ2.data() + first;
+            auto* h1 = highPassZ1.data() + first;
+            auto* h2 = highPassZ2.data() + first;
+
+            Vec z1 = Vec::fromRawArray(s1), z2 = Vec::fromRawArray(s2);
+            Vec w1 = Vec::fromRawArray(h1), w2 = Vec::fromRawArray(h2);
+            Vec energy = Vec::expand(0.0f);
+
+            alignas(16) float gathered[width] = {};
+
+            for (int i = offset; i < offset + numSamples; ++i)
+            {
+                for (int lane = 0; lane < lanes; ++lane)
+                    gathered[lane] = channels[first + lane][i];
+
+                const Vec x = Vec::fromRawArray(gathered);
+
+                const Vec y = sb0 * x + z1;
+                z1 = sb1 * x - sa1 * y + z2;
+                z2 = sb2 * x - sa2 * y;
+
+                const Vec k = hb0 * y + w1;
+                w1 = hb1 * y - ha1 * k + w2;
+                w2 = hb2 * y - ha2 * k;
+
+                energy = Vec::multiplyAdd(energy, k, k);
+            }
+
+            z1.copyToRawArray(s1);
+            z2.copyToRawArray(s2);
+            w1.copyToRawArray(h1);
+            w2.copyToRawArray(h2);
+
+            alignas(16) float laneEnergy[width];
+            energy.copyToRawArray(laneEnergy);
+            for (int lane = 0; lane < lanes; ++lane)
+                energies[first + lane] += laneEnergy[lane];
+        }
+#else
+        for (int ch = 0; ch < numActive; ++ch)
+        {
+            const float* x = channels[ch];
+            float z1 = shelfZ1[(size_t) ch], z2 = shelfZ2[(size_t) ch];
+            float w1 = highPassZ1[(size_t) ch], w2 = highPassZ2[(size_t) ch];
+            float energy = 0.0f;
+
+            for (int i = offset; i < offset + numSamples; ++i)
+            {
+                const float y = shelf.b0 * x[i] + z1;
+                z1 = shelf.b1 * x[i] - shelf.a1 * y + z2;
+                z2 = shelf.b2 * x[i] - shelf.a2 * y;
+
+                const float k = highPass.b0 * y + w1;
+                w1 = highPass.b1 * y - highPass.a1 * k + w2;
+                w2 = highPass.b2 * y - highPass.a2 * k;
+
+                energy += k * k;
+            }
+
+            shelfZ1[(size_t) ch] = z1; shelfZ2[(size_t) ch] = z2;
+            highPassZ1[(size_t) ch] = w1; highPassZ2[(size_t) ch] = w2;
+            energies[ch] += energy;
+        }
+#endif
+    }
+
+private:
+    struct Biquad { float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f; };
+
+    Biquad shelf, highPass;
+    int numChannels = 2;
+
+    // TDF-II state, one slot per channel (lane)
+    alignas(16) std::array<float, kMaxChannels> shelfZ1 {};
+    alignas(16) std::array<float, kMaxChannels> shelfZ2 {};
+    alignas(16) std::array<float, kMaxChannels> highPassZ1 {};
+    alignas(16) std::array<float, kMaxChannels> highPassZ2 {};
+};
+
+//==============================================================================
+/** Mean-square K-weighted power → LUFS (BS.1770-4 channel-sum convention) */
+inline float meanSquareToLufs(double meanSquare) noexcept
+{
+    return meanSquare > 1e-10 ? static_cast<float>(-0.691 + 10.0 * std::log10(meanSquare))
+                              : -70.0f;
+}
+
+//==============================================================================
+/**
+ * Fixed-size loudness histogram for gated statistics (BS.1770-4 / EBU Tech 3342)
+ *
+ * Blocks at or below the -70 LUFS absolute gate are discarded on entry.
+ * Each bin keeps a count and the exact sum of block powers, so gated means
+ * are exact apart from the single bin straddling the relative gate.
+ */
+template <int NumBins>
+class LoudnessHistogram
+{
+public:
+    static constexpr double kMinLufs = -70.0;
+    static constexpr double kMaxLufs = 10.0;
+    static constexpr double kBinWidth = (kMaxLufs - kMinLufs) / NumBins;
+
+    /** Clears only the bins touched since the last reset (a session rarely
+        spans more than a few hundred of the 4000), so re-preparing is cheap. */
+    void reset()
+    {
+        if (highestBin >= lowestBin)
+        {
+            std::fill(counts.begin() + lowestBin, counts.begin() + highestBin + 1, 0u);
+            std::fill(powers.begin() + lowestBin, powers.begin() + highestBin + 1, 0.0);
+        }
+
+        lowestBin = NumBins;
+        highestBin = -1;
+        totalCount = 0;
+        totalPower = 0.0;
+    }
+
+    void addBlock(double meanSquare)
+    {
+        const double lufs = meanSquareToLufs(meanSquare);
+        if (lufs <= kMinLufs)
+            return;  // absolute gate
+
+        const int bin = juce::jlimit(0, NumBins - 1,
+                                     static_cast<int>((lufs - kMinLufs) / kBinWidth));
+        ++counts[static_cast<size_t>(bin)];
+        powers[static_cast<size_t>(bin)] += meanSquare;
+        lowestBin = juce::jmin(lowestBin, bin);
+        highestBin = juce::jmax(highestBin, bin);
+        ++totalCount;
+        totalPower += meanSquare;
+    }
+
+    juce::uint64 getNumBlocks() const noexcept  { return totalCount; }
+
+    /** Loudness threshold relativeLU below the mean of all absolute-gated blocks. */
+    double getRelativeGate(double relativeLU) const noexcept
+    {
+        return totalCount > 0 ? meanSquareToLufs(totalPower / static_cast<double>(totalCount)) + relativeLU
+                              : kMinLufs;
+    }
+
+    /** Power-mean loudness of blocks above gateLufs (-70 when none pass). */
+    float getGatedLufs(double gateLufs) const noexcept
+    {
+        double power = 0.0;
+        juce::uint64 count = 0;
+
+        for (int bin = firstBinAbove(gateLufs); bin < NumBins; ++bin)
+        {
+            power += powers[static_cast<size_t>(bin)];
+            count += counts[static_cast<size_t>(bin)];
+        }
+
+        return count > 0 ? meanSquareToLufs(power / static_cast<double>(count)) : -70.0f;
+    }
+
+    /** Number of blocks above gateLufs. */
+    juce::uint64 countAbove(double gateLufs) const noexcept
+    {
+        juce::uint64 count = 0;
+        for (int bin = firstBinAbove(gateLufs); bin < NumBins; ++bin)
+            count += counts[static_cast<size_t>(bin)];
+        return count;
+    }
+
+    /** Loudness (bin centre) at the given fraction of blocks above gateLufs, sorted ascending. */
+    float getGatedPercentile(double gateLufs, double fraction) const noexcept
+    {
+        const int firstBin = firstBinAbove(gateLufs);
+        const juce::uint64 count = countAbove(gateLufs);
+        if (count == 0)
+            return static_cast<float>(kMinLufs);
+
+        const auto target = juce::jmin(count - 1, static_cast<juce::uint64>(static_cast<double>(count) * fraction));
+        juce::uint64 cumulative = 0;
+
+        for (int bin = firstBin; bin < NumBins; ++bin)
+        {
+            cumulative += counts[static_cast<size_t>(bin)];
+            if (cumulative > target)
+                return static_cast<float>(binCentre(bin));
+        }
+
+        return static_cast<float>(binCentre(NumBins - 1));
+    }
+
+private:
+    static double binCentre(int bin) noexcept
+    {
+        return kMinLufs + (bin + 0.5) * kBinWidth;
+    }
+
+    static int firstBinAbove(double gateLufs) noexcept
+    {
+        if (gateLufs < kMinLufs)
+            return 0;
+
+        const int bin = static_cast<int>((gateLufs - kMinLufs) / kBinWidth);
+        if (bin >= NumBins)
+            return NumBins;
+
+        // Straddling bin counts as "above" when its centre clears the gate
+        return binCentre(bin) > gateLufs ? bin : bin + 1;
+    }
+
+    std::array<juce::uint32, NumBins> counts {};
+    std::array<double, NumBins> powers {};
+    int lowestBin = NumBins, highestBin = -1;   // touched range, for reset()
+    juce::uint64 totalCount = 0;
+    double totalPower = 0.0;
+};
+
+//==============================================================================
+/**
+ * Sliding-window loudness engine (ITU-R BS.1770-4 / EBU R128 M + S)
+ *
+ * Accepts 1..16 channels with BS.1770-4 position weights (LFE = 0,
+ * side surrounds = +1.5 dB). Per-channel sub-block energies are kept as
+ * well, so individual channel loudness can be shown next to the sum.
+ */
+class LoudnessEngine
+{
+public:
+    static constexpr int kMaxChannels = KWeightingBank::kMaxChannels;
+    static constexpr int kSubBlocksMomentary = 4;    // 4 × 100 ms = 400 ms
+    static constexpr int kSubBlocksShortTerm = 30;   // 30 × 100 ms = 3 s
+    static constexpr int kSubBlockRingSize = 32;     // power of two ≥ kSubBlocksShortTerm
+    static constexpr int kHistogramBins = 4000;      // 0.02 LU over -70..+10 LUFS
+    static constexpr float kSilenceLufs = -70.0f;
+
+    LoudnessEngine() = default;
+
+    //==========================================================================
+    // Called from prepareToPlay
+    //==========================================================================
+    void prepare(double sampleRate, int numChannelsToUse = 2, const float* weights = nullptr)
+    {
+        kWeighting.prepare(sampleRate, numChannelsToUse);
+        numChannels = kWeighting.getNumChannels();
+
+        for (int ch = 0; ch < kMaxChannels; ++ch)
+            channelWeights[(size_t) ch] = (ch < numChannels) ? (weights != nullptr ? weights[ch] : 1.0f) : 0.0f;
+
+        subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+        processKernel = selectKernel(subBlockLength);
+        reset();
+    }
+
+    void reset()
+    {
+        kWeighting.reset();
+
+        for (auto& ring : channelSubBlockEnergies)
+            ring.fill(0.0);
+        channelEnergies.fill(0.0);
+        runEnergies.fill(0.0f);
+        channelMomentaryLufs.fill(kSilenceLufs);
+
+        subBlockEnergies.fill(0.0);
+        subBlocksCompleted = 0;
+        subBlockHead = 0;
+        subBlockFill = 0;
+        subBlockEnergy = 0.0;
+        fullMomentaryEnergy = 0.0;
+        fullShortTermEnergy = 0.0;
+        oldestMomentaryEnergy = 0.0;
+        oldestShortTermEnergy = 0.0;
+        momentaryLufs = kSilenceLufs;
+        shortTermLufs = kSilenceLufs;
+
+        integratedHistogram.reset();
+        integratedLufs = kSilenceLufs;
+
+        shortTermHistogram.reset();
+        loudnessRange = 0.0f;
+    }
+
+    //==========================================================================
+    // Audio thread: K-weight and accumulate one block (numChannels pointers)
+    //==========================================================================
+    void process(const float* const* channels, int numSamples)
+    {
+        (this->*processKernel)(channels, numChannels, numSamples);
+    }
+
+    /** Only the first two channels are read, whatever the prepared count, so
+     *  a surround-prepared engine can fall back to the stereo pair when the
+     *  host delivers fewer channels. The remaining channels read silence. */
+    void processStereo(const float* left, const float* right, int numSamples)
+    {
+        const float* channels[2] = { left, right };
+        (this->*processKernel)(channels, juce::jmin(2, numChannels), numSamples);
+    }
+
+    int getNumChannels() const noexcept      { return numChannels; }
+    float getChannelMomentaryLufs(int ch) const noexcept
+    {
+        return juce::isPositiveAndBelow(ch, numChannels) ? channelMomentaryLufs[(size_t) ch] : kSilenceLufs;
+    }
+
+    /** BS.1770-4 Table 4 weight for a channel position (LFE excluded). */
+    static float getChannelWeight(juce::AudioChannelSet::ChannelType type) noexcept
+    {
+        switch (type)
+        {
+            case juce::AudioChannelSet::LFE:
+            case juce::AudioChannelSet::LFE2:
+                return 0.0f;
+
+            // |azimuth| 60°–120°, elevation < 30° → +1.5 dB
+            case juce::AudioChannelSet::leftSurround:
+            case juce::AudioChannelSet::rightSurround:
+            case juce::AudioChannelSet::leftSurroundSide:
+            case juce::AudioChannelSet::rightSurroundSide:
+                return 1.41253754f;
+
+            default:
+                return 1.0f;
+        }
+    }
+
+    float getMomentaryLufs() const noexcept  { return momentaryLufs; }
+    float getShortTermLufs() const noexcept  { return shortTermLufs; }
+    float getIntegratedLufs() const noexcept { return integratedLufs; }
+    float getLoudnessRange() const noexcept  { return loudnessRange; }
+
+private:
+    //==========================================================================
+    // Rate-specialised kernels
+    //==========================================================================
+    using Kernel = void (LoudnessEngine::*)(const float* const*, int, int);
+
+    static Kernel selectKernel(int length) noexcept
+    {
+        switch (length)
+        {
+            case 4410:  return &LoudnessEngine::processRuns<4410>;   // 44.1 kHz
+            case 4800:  return &LoudnessEngine::processRuns<4800>;   // 48 kHz
+            case 8820:  return &LoudnessEngine::processRuns<8820>;   // 88.2 kHz
+            case 9600:  return &LoudnessEngine::processRuns<9600>;   // 96 kHz
+            case 17640: return &LoudnessEngine::processRuns<17640>;  // 176.4 kHz
+            case 19200: return &LoudnessEngine::processRuns<19200>;  // 192 kHz
+            default:    return &LoudnessEngine::processRuns<0>;
+        }
+    }
+
+    /** FixedLength > 0: sub-block length known at compile time, so the run
+     *  split and window normalisation fold to constants. 0 = generic rate. */
+    template <int FixedLength>
+    void processRuns(const float* const* channels, int numActive, int numSamples)
+    {
+        const int length = FixedLength > 0 ? FixedLength : subBlockLength;
+        int offset = 0;
+
+        while (offset < numSamples)
+        {
+            // Never let one run cross a sub-block boundary
+            const int run = juce::jmin(numSamples - offset, length - subBlockFill);
+
+            std::fill(runEnergies.begin(), runEnergies.begin() + numActive, 0.0f);
+            kWeighting.processAndAccumulate(channels, numActive, offset, run, runEnergies.data());
+
+            for (int ch = 0; ch < numActive; ++ch)
+            {
+                channelEnergies[(size_t) ch] += runEnergies[(size_t) ch];
+                subBlockEnergy += channelWeights[(size_t) ch] * runEnergies[(size_t) ch];
+            }
+
+            subBlockFill += run;
+            offset += run;
+
+            if (subBlockFill >= length)
+                commitSubBlock();
+        }
+
+        updateWindows<FixedLength>();
+    }
+
+    //==========================================================================
+    // Sub-block bookkeeping — O(30) every 100 ms, exact (no running-sum drift)
+    //==========================================================================
+    double subBlockAt(int ageInBlocks) const noexcept
+    {
+        // age 0 = newest completed sub-block
+        return subBlockEnergies[static_cast<size_t>((subBlockHead - 1 - ageInBlocks) & (kSubBlockRingSize - 1))];
+    }
+
+    void commitSubBlock()
+    {
+        // Per-channel history: momentary loudness of each channel (unweighted)
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& ring = channelSubBlockEnergies[(size_t) ch];
+            ring[static_cast<size_t>(subBlockHead)] = channelEnergies[(size_t) ch];
+            channelEnergies[(size_t) ch] = 0.0;
+
+            double energy = 0.0;
+            for (int age = 0; age < kSubBlocksMomentary; ++age)
+                energy += ring[static_cast<size_t>((subBlockHead - age) & (kSubBlockRingSize - 1))];
+            channelMomentaryLufs[(size_t) ch] = meanSquareToLufs(energy / (static_cast<double>(subBlockLength) * kSubBlocksMomentary));
+        }
+
+        subBlockEnergies[static_cast<size_t>(subBlockHead)] = subBlockEnergy;
+        subBlockHead = (subBlockHead + 1) & (kSubBlockRingSize - 1);
+        subBlockEnergy = 0.0;
+        subBlockFill = 0;
+
+        fullMomentaryEnergy = 0.0;
+        for (int age = 0; age < kSubBlocksMomentary - 1; ++age)
+            fullMomentaryEnergy += subBlockAt(age);
+
+        fullShortTermEnergy = fullMomentaryEnergy;
+        for (int age = kSubBlocksMomentary - 1; age < kSubBlocksShortTerm - 1; ++age)
+            fullShortTermEnergy += subBlockAt(age);
+
+        oldestMomentaryEnergy = subBlockAt(kSubBlocksMomentary - 1);
+        oldestShortTermEnergy = subBlockAt(kSubBlocksShortTerm - 1);
+
+        subBlocksCompleted = juce::jmin(subBlocksCompleted + 1, kSubBlocksShortTerm);
+
+        // Every finished sub-block closes one 400 ms gating block (75% overlap)
+        if (subBlocksCompleted >= kSubBlocksMomentary)
+        {
+            const double blockEnergy = fullMomentaryEnergy + oldestMomentaryEnergy;
+            integratedHistogram.addBlock(blockEnergy / (static_cast<double>(subBlockLength) * kSubBlocksMomentary));
+            integratedLufs = integratedHistogram.getGatedLufs(integratedHistogram.getRelativeGate(-10.0));
+        }
+
+        // LRA: one short-term measurement per sub-block once the 3 s window is full
+        if (subBlocksCompleted >= kSubBlocksShortTerm)
+        {
+            const double stEnergy = fullShortTermEnergy + oldestShortTermEnergy;
+            shortTermHistogram.addBlock(stEnergy / (static_cast<double>(subBlockLength) * kSubBlocksShortTerm));
+            updateLoudnessRange();
+        }
+    }
+
+    void updateLoudnessRange()
+    {
+        const double gate = shortTermHistogram.getRelativeGate(-20.0);
+        if (shortTermHistogram.countAbove(gate) < 2)
+        {
+            loudnessRange = 0.0f;
+            return;
+        }
+
+        const float low = shortTermHistogram.getGatedPercentile(gate, 0.10);
+        const float high = shortTermHistogram.getGatedPercentile(gate, 0.95);
+        loudnessRange = juce::jmax(0.0f, high - low);
+    }
+
+    template <int FixedLength>
+    void updateWindows()
+    {
+        const double length = FixedLength > 0 ? static_cast<double>(FixedLength) : static_cast<double>(subBlockLength);
+
+        // The oldest sub-block only partially overlaps the sliding window:
+        // weight it by the fraction not yet displaced by the current partial block.
+        const double tailWeight = 1.0 - static_cast<double>(subBlockFill) / length;
+
+        const double momentaryEnergy = subBlockEnergy + fullMomentaryEnergy
+                                     + tailWeight * oldestMomentaryEnergy;
+        const double shortTermEnergy = subBlockEnergy + fullShortTermEnergy
+                                     + tailWeight * oldestShortTermEnergy;
+
+        momentaryLufs = meanSquareToLufs(momentaryEnergy / (length * kSubBlocksMomentary));
+        shortTermLufs = meanSquareToLufs(shortTermEnergy / (length * kSubBlocksShortTerm));
+    }
+
+    KWeightingBank kWeighting;
+    Kernel processKernel = &LoudnessEngine::processRuns<4800>;
+    int numChannels = 2;
+    std::array<float, kMaxChannels> channelWeights {};
+    std::array<float, kMaxChannels> runEnergies {};
+
+    // Per-channel sub-block energies (unweighted) for per-channel readouts
+    std::array<std::array<double, kSubBlockRingSize>, kMaxChannels> channelSubBlockEnergies {};
+    std::array<double, kMaxChannels> channelEnergies {};
+    std::array<float, kMaxChannels> channelMomentaryLufs {};
+
+    // Completed 100 ms sub-block energies (channel-weighted sum of K-weighted squares)
+    std::array<double, kSubBlockRingSize> subBlockEnergies {};
+    int subBlocksCompleted = 0; // saturates at kSubBlocksShortTerm
+    int subBlockHead = 0;       // next slot to write
+    int subBlockLength = 4800;  // samples per 100 ms
+    int subBlockFill = 0;       // samples accumulated in the current sub-block
+    double subBlockEnergy = 0.0;
+
+    // Cached window partial sums (refreshed on each sub-block commit)
+    double fullMomentaryEnergy = 0.0;
+    double fullShortTermEnergy = 0.0;
+    double oldestMomentaryEnergy = 0.0;
+    double oldestShortTermEnergy = 0.0;
+
+    float momentaryLufs = kSilenceLufs;
+    float shortTermLufs = kSilenceLufs;
+
+    // Integrated (gated, whole session)
+    LoudnessHistogram<kHistogramBins> integratedHistogram;
+    float integratedLufs = kSilenceLufs;
+
+    // Loudness Range (short-term distribution, whole programme)
+    LoudnessHistogram<kHistogramBins> shortTermHistogram;
+    float loudnessRange = 0.0f;
+};
@@ -0,0 +1,457 @@
+/*
+  ==============================================================================
+    LoudnessTimelineLog.h
+    GOODMETER - Whole-session metering timeline in a compact binary file
+
+    The on-screen histories are short (PsrMeterComponent ~6.7 s, the LRA
+    window 5 min). The timeline log keeps the whole session on disk so
+    loudness plots and compliance reports can cover hours:
+
+      - processBlock hands each published MeterSnapshot to process(); every
+        100 ms of audio becomes one fixed 64-byte Record (momentary / short-
+        term / integrated, max dBTP and sample peak, PSR, mean correlation,
+        power-averaged band levels) pushed into a lock-free FIFO
+      - A writer thread appends records to <app data>/GOODMETER/Timeline/
+        <session>.gmtl: a 64-byte header, then records back to back. Nothing
+        is ever rewritten, so the record count is simply the file size
+      - View maps a log read-only: random access to any record without
+        loading the file, plus re-gating (integrated loudness, LRA, peak)
+        over any range
+
+    Record times stay on an exact 100 ms grid (the overshoot of each host
+    block is carried into the next record), but the loudness values are
+    the meters' readings at the end of the block that crossed the step, so
+    they lag the BS.1770-4 gating block grid (400 ms blocks, 75% overlap)
+    by less than one host block. Re-gating a range from the log therefore
+    approximates what the meter would have read for that range alone: close
+    at small block sizes, not bit-exact. A host block longer than 100 ms
+    repeats its reading for every step it covers.
+    About 2.3 MB per hour; only the newest kMaxSessions logs are kept.
+
+    Records are written in native byte order (every supported target is
+    little-endian).
+
+    Thread safety model:
+      - setEnabled() / prepare(): message thread / prepareToPlay
+      - process(): audio thread (no locks, no allocation)
+      - File writing: the log's own background thread
+      - View: any thread, one View per reader
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LockFreeFIFO.h"
+#include "MeterSnapshot.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class LoudnessTimelineLog : private juce::Thread
+{
+public:
+    static constexpr double kRecordsPerSecond = 10.0;
+    static constexpr int kMaxBands = 8;
+    static constexpr int kMaxSessions = 50;
+    static constexpr int kHeaderBytes = 64;
+
+    //==========================================================================
+    struct Record
+    {
+        enum Flags : juce::uint8
+        {
+            bandsMeasured = 1 << 0,     // band levels are real (the bands analysis was running)
+            discontinuity = 1 << 1      // first record after prepareToPlay (meters were reset)
+        };
+
+        double timeSeconds = 0.0;       // audio time since the session began, at the record's end
+        float momentary = -70.0f;       // LUFS at the end of the interval
+        float shortTerm = -70.0f;
+        float integrated = -70.0f;
+        float luRange = 0.0f;
+        float truePeak = -90.0f;        // dBTP, max of both channels over the interval
+        float samplePeak = -90.0f;      // dBFS, same
+        float psr = 0.0f;               // sample peak - short-term, as PsrMeterComponent shows it
+        float correlation = 0.0f;       // mean over the interval
+        std::array<juce::int16, kMaxBands> bandCentiDb {};   // lowest band first, 0.01 dB steps
+        juce::uint8 numBands = 0;
+        juce::uint8 flags = 0;
+        juce::uint8 reserved[6] {};
+
+        float getBandDb(int band) const noexcept    { return bandCentiDb[(size_t) band] * 0.01f; }
+    };
+
+    static_assert(sizeof(Record) == 64, "Records are a fixed 64 bytes on disk");
+    static_assert(std::is_trivially_copyable<Record>::value, "Records are written as raw bytes");
+
+    //==========================================================================
+    /** Read-only, memory-mapped access to one log file. */
+    class View
+    {
+    public:
+        explicit View(const juce::File& logFile)
+            : map(logFile, juce::MemoryMappedFile::readOnly)
+        {
+            const auto* header = static_cast<const juce::uint8*>(map.getData());
+            if (header == nullptr || map.getSize() < (size_t) kHeaderBytes
+                || juce::ByteOrder::littleEndianInt(header) != (juce::uint32) kMagic
+                || juce::ByteOrder::littleEndianInt(header + 8) != (juce::uint32) sizeof(Record))
+                return;
+
+            startTime = juce::Time((juce::int64) juce::ByteOrder::littleEndianInt64(header + 16));
+            records = reinterpret_cast<const Record*>(header + kHeaderBytes);
+            numRecords = (juce::int64) ((map.getSize() - (size_t) kHeaderBytes) / sizeof(Record));
+        }
+
+        bool isValid() const noexcept                   { return records != nullptr; }
+        juce::int64 getNumRecords() const noexcept      { return numRecords; }
+        juce::Time getStartTime() const noexcept        { return startTime; }
+
+        /** Records present when the View was made; make a new View to see later ones. */
+        const Record& operator[](juce::int64 index) const noexcept
+        {
+            jassert(juce::isPositiveAndBelow(index, numRecords));
+            return records[index];
+        }
+
+        /** BS.1770-4 style integrated loudness of records [first, end): two-
+            stage gate (-70 LUFS absolute, -10 LU relative) over the momentary
+            readings, which approximate the gating blocks (see above). */
+        float integratedLufs(juce::int64 first, juce::int64 end) const noexcept
+        {
+            clampRange(first, end);
+
+            auto gatedMean = [&] (float gate)
+            {
+                double sum = 0.0;
+                juce::int64 count = 0;
+                for (auto i = first; i < end; ++i)
+                {
+                    if (records[i].momentary > gate)
+                    {
+                        sum += lufsToPower(records[i].momentary);
+                        ++count;
+                    }
+                }
+                return count > 0 ? powerToLufs(sum / (double) count) : kSilence;
+            };
+
+            const float ungated = gatedMean(kSilence);
+            return ungated <= kSilence ? kSilence : gatedMean(juce::jmax(kSilence, ungated - 10.0f));
+        }
+
+        /** EBU Tech 3342 loudness range of records [first, end) from the
+            short-term values (-70 absolute, -20 LU relative, 10th-95th percentile). */
+        float loudnessRange(juce::int64 first, juce::int64 end) const
+        {
+            clampRange(first, end);
+
+            std::vector<float> values;
+            double sum = 0.0;
+            for (auto i = first; i < end; ++i)
+            {
+                if (records[i].shortTerm > kSilence)
+                {
+                    values.push_back(records[i].shortTerm);
+                    sum += lufsToPower(records[i].shortTerm);
+                }
+            }
+            if (values.empty())
+                return 0.0f;
+
+            const float relativeGate = powerToLufs(sum / (double) values.size()) - 20.0f;
+            values.erase(std::remove_if(values.begin(), values.end(), [relativeGate] (float v) { return v <= relativeGate; }),
+                         values.end());
+            if (values.size() < 2)
+                return 0.0f;
+
+            auto percentile = [&values] (double p)
+            {
+                const auto n = static_cast<size_t>(std::round(p * (double) (values.size() - 1)));
+                std::nth_element(values.begin(), values.begin() + (std::ptrdiff_t) n, values.end());
+                return values[n];
+            };
+
+            const float low = percentile(0.10);
+            return percentile(0.95) - low;
+        }
+
+        /** Highest true peak (dBTP) in records [first, end). */
+        float maxTruePeak(juce::int64 first, juce::int64 end) const noexcept
+        {
+            clampRange(first, end);
+            float peak = -90.0f;
+            for (auto i = first; i < end; ++i)
+                peak = juce::jmax(peak, records[i].truePeak);
+            return peak;
+        }
+
+    private:
+        void clampRange(juce::int64& first, juce::int64& end) const noexcept
+        {
+            first = juce::jlimit<juce::int64>(0, numRecords, first);
+            end = juce::jlimit<juce::int64>(first, numRecords, end);
+        }
+
+        static double lufsToPower(float lufs) noexcept    { return std::pow(10.0, (lufs + 0.691) / 10.0); }
+        static float powerToLufs(double power) noexcept
+        {
+            return power > 0.0 ? juce::jmax(kSilence, (float) (-0.691 + 10.0 * std::log10(power))) : kSilence;
+        }
+
+        juce::MemoryMappedFile map;
+        const Record* records = nullptr;
+        juce::int64 numRecords = 0;
+        juce::Time startTime;
+
+        JUCE_DECLARE_NON_COPYABLE(View)
+    };
+
+    //==========================================================================
+    LoudnessTimelineLog() : Thread("GOODMETER-Timeline") {}
+
+    ~LoudnessTimelineLog() override
+    {
+        setEnabled(false);
+    }
+
+    /** Message thread: start a new session file, or stop and close it. */
+    void setEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled == isThreadRunning())
+            return;
+
+        if (! shouldBeEnabled)
+        {
+            active.store(false, std::memory_order_release);
+            stopThread(2000);
+            drain();
+            stream.reset();
+            return;
+        }
+
+        if (! openSession())
+            return;
+
+        pendingDiscontinuity = true;
+        active.store(true, std::memory_order_release);
+        startThread(juce::Thread::Priority::low);
+    }
+
+    bool isEnabled() const noexcept                 { return active.load(std::memory_order_relaxed); }
+
+    /** The file being written (empty when disabled). */
+    juce::File getSessionFile() const               { return sessionFile; }
+
+    static juce::File getLogDirectory()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("GOODMETER")
+            .getChildFile("Timeline");
+    }
+
+    /** Every session log, newest first. */
+    static juce::Array<juce::File> findSessions()
+    {
+        auto files = getLogDirectory().findChildFiles(juce::File::findFiles, false, "*.gmtl");
+        std::sort(files.begin(), files.end(), [] (const juce::File& a, const juce::File& b)
+        {
+            return a.getLastModificationTime() > b.getLastModificationTime();
+        });
+        return files;
+    }
+
+    //==========================================================================
+    /** prepareToPlay: restart the 100 ms grid with the meters (marks a discontinuity). */
+    void prepare(double sampleRate) noexcept
+    {
+        samplesPerRecord = juce::jmax(1, juce::roundToInt(sampleRate / kRecordsPerSecond));
+        currentSampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+        resetAccumulator();
+        pendingDiscontinuity = true;
+    }
+
+    /** Audio thread, after the snapshot for this block was published. */
+    void process(const MeterSnapshot& snapshot, int numSamples, bool bandsMeasured) noexcept
+    {
+        if (! active.load(std::memory_order_acquire) || numSamples <= 0)
+            return;
+
+        accumulated += numSamples;
+        summedSamples += numSamples;
+        truePeak = juce::jmax(truePeak, snapshot.truePeakL, snapshot.truePeakR);
+        samplePeak = juce::jmax(samplePeak, snapshot.peakL, snapshot.peakR);
+        correlationSum += snapshot.phaseCorrelation * (double) numSamples;
+
+        const int numBands = juce::jmin(snapshot.numBands, kMaxBands);
+        for (int band = 0; band < numBands; ++band)
+            bandPowerSum[(size_t) band] += std::pow(10.0, snapshot.bandRms[(size_t) band] / 10.0) * (double) numSamples;
+
+        if (accumulated >= samplesPerRecord)
+            emit(snapshot, numBands, bandsMeasured);
+    }
+
+    /** Records the writer could not keep up with. */
+    juce::uint64 getDroppedRecords() const noexcept     { return droppedRecords.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kMagic = 0x4c544d47;       // "GMTL"
+    static constexpr int kVersion = 1;
+    static constexpr float kSilence = -70.0f;
+
+    //==========================================================================
+    void emit(const MeterSnapshot& snapshot, int numBands, bool bandsMeasured) noexcept
+    {
+        Record record;
+        record.momentary = snapshot.lufsMomentary;
+        record.shortTerm = snapshot.lufsShortTerm;
+        record.integrated = snapshot.lufsIntegrated;
+        record.luRange = snapshot.luRange;
+        record.truePeak = truePeak;
+        record.samplePeak = samplePeak;
+        record.psr = (samplePeak > -60.0f && snapshot.lufsShortTerm > -60.0f)
+                   ? juce::jlimit(0.0f, 30.0f, samplePeak - snapshot.lufsShortTerm)
+                   : 0.0f;
+        record.correlation = (float) (correlationSum / (double) summedSamples);
+        record.numBands = (juce::uint8) numBands;
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            const double meanPower = bandPowerSum[(size_t) band] / (double) summedSamples;
+            const double db = meanPower > 1.0e-9 ? 10.0 * std::log10(meanPower) : -90.0;
+            record.bandCentiDb[(size_t) band] = (juce::int16) juce::jlimit(-9000, 2000, (int) std::lround(db * 100.0));
+        }
+
+        // One record per 100 ms step this block completed; the overshoot
+        // stays in accumulated so the next record ends on the grid too
+        while (accumulated >= samplesPerRecord)
+        {
+            accumulated -= samplesPerRecord;
+            sessionSamples += samplesPerRecord;
+            record.timeSeconds = (double) sessionSamples / currentSampleRate;
+            record.flags = (juce::uint8) ((bandsMeasured ? Record::bandsMeasured : 0)
+                                        | (pendingDiscontinuity ? Record::discontinuity : 0));
+            pendingDiscontinuity = false;
+
+            if (! records.push(&record, 1))
+                droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        resetSums();
+    }
+
+    void resetAccumulator() noexcept
+    {
+        accumulated = 0;
+        resetSums();
+    }
+
+    void resetSums() noexcept
+    {
+        summedSamples = 0;
+        truePeak = samplePeak = -90.0f;
+        correlationSum = 0.0;
+        bandPowerSum.fill(0.0);
+    }
+
+    //==========================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            drain();
+            wait(250);
+        }
+    }
+
+    /** Append everything queued and make it visible to new Views. */
+    void drain()
+    {
+        if (stream == nullptr)
+            return;
+
+        bool wroteAny = false;
+        Record record;
+        while (records.pop(&record, 1))
+        {
+            stream->write(&record, sizeof(Record));
+            wroteAny = true;
+        }
+
+        if (wroteAny)
+            stream->flush();
+    }
+
+    bool openSession()
+    {
+        const auto directory = getLogDirectory();
+        if (! directory.createDirectory())
+            return false;
+
+        pruneOldSessions();
+
+        // Records queued by an earlier session (after its last drain) must
+        // not open this one; the audio thread is not pushing while inactive
+        Record stale;
+        while (records.pop(&stale, 1)) {}
+
+        const auto now = juce::Time::getCurrentTime();
+        sessionFile = directory.getNonexistentChildFile("session-" + now.formatted("%Y%m%d-%H%M%S"), ".gmtl", false);
+        stream = std::make_unique<juce::FileOutputStream>(sessionFile);
+        if (stream->failedToOpen())
+        {
+            stream.reset();
+            sessionFile = juce::File();
+            return false;
+        }
+
+        // 64-byte header: magic, version, record size, reserved, start time (ms), padding
+        stream->writeInt(kMagic);
+        stream->writeInt(kVersion);
+        stream->writeInt((int) sizeof(Record));
+        stream->writeInt(0);
+        stream->writeInt64(now.toMilliseconds());
+        for (int i = 24; i < kHeaderBytes; i += 4)
+            stream->writeInt(0);
+        stream->flush();
+
+        sessionSamples = 0;
+        return true;
+    }
+
+    static void pruneOldSessions()
+    {
+        const auto sessions = findSessions();
+        for (int i = kMaxSessions - 1; i < sessions.size(); ++i)
+            sessions[i].deleteFile();
+    }
+
+    //==========================================================================
+    std::atomic<bool> active { false };
+    std::atomic<juce::uint64> droppedRecords { 0 };
+
+    // ~25 s of records between writer passes
+    LockFreeFIFO<Record, 256, 1> records;
+
+    // Audio thread accumulator for the current 100 ms
+    double currentSampleRate = 48000.0;
+    int samplesPerRecord = 4800;
+    int accumulated = 0;                // samples since the last 100 ms step
+    int summedSamples = 0;              // samples in the sums below
+    juce::int64 sessionSamples = 0;
+    float truePeak = -90.0f, samplePeak = -90.0f;
+    double correlationSum = 0.0;
+    std::array<double, kMaxBands> bandPowerSum {};
+    bool pendingDiscontinuity = true;
+
+    // Writer side
+    juce::File sessionFile;
+    std::unique_ptr<juce::FileOutputStream> stream;
+
+    JUCE_DECLARE_NON_COPYABLE(LoudnessTimelineLog)
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+    MeterAnalysisKernel.h
+    GOODMETER - Block-vectorised per-callback statistics
+
+    processBlock walks the input once, in L1-sized chunks. For each chunk this
+    kernel produces every non-recursive statistic in a single SIMD pass:
+
+      - Peak |L| / |R|            (lane-wise max/min, no per-sample branch)
+      - Sum of squares L / R      (RMS + phase correlation denominator)
+      - Sum of L·R                (phase correlation numerator)
+      - Sum of squares Mid / Side (stereo field RMS)
+
+    Recursive work (K-weighting, 3-band filters, true-peak FIR) and the FFT
+    ring run on the same chunk straight afterwards while it is cache-hot.
+
+    Lanes hold consecutive samples, so results differ from the old scalar
+    loops only by float summation order. Unaligned host buffers are staged
+    through an aligned stack copy; there is no allocation.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+struct StereoBlockStats
+{
+    float peakL = 0.0f;
+    float peakR = 0.0f;
+    float sumSquareL = 0.0f;
+    float sumSquareR = 0.0f;
+    float sumLR = 0.0f;
+    float sumSquareMid = 0.0f;
+    float sumSquareSide = 0.0f;
+};
+
+//==============================================================================
+struct MeterAnalysisKernel
+{
+    /** Samples per fused chunk: 2 × 64 floats stay well inside L1. */
+    static constexpr int kChunkSize = 64;
+
+    //==========================================================================
+    /** Fold one stereo run into the running block statistics. */
+    static void accumulateStereo(const float* left, const float* right,
+                                 int numSamples, StereoBlockStats& stats) noexcept
+    {
+        int offset = 0;
+
+#if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+        constexpr int lanes = static_cast<int>(Vec::SIMDNumElements);
+
+        const int vectorSamples = numSamples - (numSamples % lanes);
+
+        if (vectorSamples > 0)
+        {
+            Vec hiL = Vec::expand(0.0f), loL = Vec::expand(0.0f);
+            Vec hiR = Vec::expand(0.0f), loR = Vec::expand(0.0f);
+            Vec sumL = Vec::expand(0.0f), sumR = Vec::expand(0.0f), sumLR = Vec::expand(0.0f);
+            Vec sumMid = Vec::expand(0.0f), sumSide = Vec::expand(0.0f);
+            const Vec half = Vec::expand(0.5f);
+
+            alignas(16) std::array<float, kChunkSize> stageL;
+            alignas(16) std::array<float, kChunkSize> stageR;
+
+            while (offset < vectorSamples)
+            {
+                const int run = juce::jmin(vectorSamples - offset, kChunkSize);
+                const float* l = left + offset;
+                const float* r = right + offset;
+
+                if (! Vec::isSIMDAligned(l) || ! Vec::isSIMDAligned(r))
+                {
+                    std::copy(l, l + run, stageL.begin());
+                    std::copy(r, r + run, stageR.begin());
+                    l = stageL.data();
+                    r = stageR.data();
+                }
+
+                for (int i = 0; i < run; i += lanes)
+                {
+                    const Vec x = Vec::fromRawArray(l + i);
+                    const Vec y = Vec::fromRawArray(r + i);
+
+                    hiL = Vec::max(hiL, x);  loL = Vec::min(loL, x);
+                    hiR = Vec::max(hiR, y);  loR = Vec::min(loR, y);
+
+                    sumL  = Vec::multiplyAdd(sumL, x, x);
+                    sumR  = Vec::multiplyAdd(sumR, y, y);
+                    sumLR = Vec::multiplyAdd(sumLR, x, y);
+
+                    const Vec mid  = (x + y) * half;
+                    const Vec side = (x - y) * half;
+                    sumMid  = Vec::multiplyAdd(sumMid, mid, mid);
+                    sumSide = Vec::multiplyAdd(sumSide, side, side);
+                }
+
+                offset += run;
+            }
+
+            alignas(16) std::array<float, lanes> a {}, b {};
+            hiL.copyToRawArray(a.data());  loL.copyToRawArray(b.data());
+            for (int i = 0; i < lanes; ++i) stats.peakL = juce::jmax(stats.peakL, a[(size_t) i], -b[(size_t) i]);
+            hiR.copyToRawArray(a.data());  loR.copyToRawArray(b.data());
+            for (int i = 0; i < lanes; ++i) stats.peakR = juce::jmax(stats.peakR, a[(size_t) i], -b[(size_t) i]);
+
+            stats.sumSquareL    += sumL.sum();
+            stats.sumSquareR    += sumR.sum();
+            stats.sumLR         += sumLR.sum();
+            stats.sumSquareMid  += sumMid.sum();
+            stats.sumSquareSide += sumSide.sum();
+        }
+#endif
+
+        // Scalar tail (and the whole run when SIMD is unavailable)
+        for (int i = offset; i < numSamples; ++i)
+        {
+            const float x = left[i];
+            const float y = right[i];
+
+            stats.peakL = juce::jmax(stats.peakL, std::abs(x));
+            stats.peakR = juce::jmax(stats.peakR, std::abs(y));
+            stats.sumSquareL += x * x;
+            stats.sumSquareR += y * y;
+            stats.sumLR += x * y;
+
+            const float mid = (x + y) * 0.5f;
+            const float side = (x - y) * 0.5f;
+            stats.sumSquareMid += mid * mid;
+            stats.sumSquareSide += side * side;
+        }
+    }
+
+    //==========================================================================
+    /** Sum of squares of one channel (standalone channel-pair scan). */
+    static float sumOfSquares(const float* data, int numSamples) noexcept
+    {
+        float total = 0.0f;
+        int offset = 0;
+
+#if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+        constexpr int lanes = static_cast<int>(Vec::SIMDNumElements);
+
+        // Scalar lead-in up to the first aligned sample
+        while (offset < numSamples && ! Vec::isSIMDAligned(data + offset))
+        {
+            total += data[offset] * data[offset];
+            ++offset;
+        }
+
+        Vec acc = Vec::expand(0.0f);
+        for (; offset + lanes <= numSamples; offset += lanes)
+        {
+            const Vec x = Vec::fromRawArray(data + offset);
+            acc = Vec::multiplyAdd(acc, x, x);
+        }
+        total += acc.sum();
+#endif
+
+        for (; offset < numSamples; ++offset)
+            total += data[offset] * data[offset];
+
+        return total;
+    }
+};
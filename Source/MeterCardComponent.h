@@ -14,6 +14,7 @@
 
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
+#include "FrameScheduler.h"
 
 //==============================================================================
 /**
@@ -21,7 +22,7 @@
  * Implements hand-rolled animation to trigger parent relayout every frame
  */
 class MeterCardComponent : public juce::Component,
-                          public juce::Timer
+                          public FrameScheduler::Client
 {
 public:
     //==========================================================================
@@ -87,7 +88,8 @@ public:
     MeterCardComponent(const juce::String& title,
                       const juce::Colour& indicatorColour = GoodMeterLookAndFeel::accentPink,
                       bool defaultExpanded = false)
-        : cardTitle(title),
+        : FrameScheduler::Client(this),
+          cardTitle(title),
           statusColour(indicatorColour),
           isExpanded(defaultExpanded)
     {
@@ -103,7 +105,7 @@ public:
 
     ~MeterCardComponent() override
     {
-        stopTimer();
+        stopFrames();
     }
 
     //==========================================================================
@@ -484,7 +486,7 @@ public:
             isArrowHovered = false;
             isResizeHovered = false;
             currentHoverOffset = 4.0f;
-            stopTimer();
+            stopFrames();
         }
 
         if (contentComponent != nullptr)
@@ -739,7 +741,7 @@ public:
         if (mobileListMode) return;
         if (isDocked) return;
         isCardHovered = true;
-        ensureTimerRunning();
+        ensureFramesRunning();
     }
 
     void mouseExit(const juce::MouseEvent&) override
@@ -750,7 +752,7 @@ public:
         isHeaderHovered = false;
         isArrowHovered = false;
         isResizeHovered = false;
-        ensureTimerRunning();
+        ensureFramesRunning();
         repaint();
     }
 
@@ -816,7 +818,7 @@ public:
         {
             // Start hand-rolled 60Hz animation
             isAnimating = true;
-            ensureTimerRunning();
+            ensureFramesRunning();
 
             // Show content immediately for expand, hide after animation for collapse
             if (contentComponent != nullptr && shouldExpand)
@@ -880,10 +882,10 @@ public:
 
     //==========================================================================
     /**
-     * Hand-rolled 60Hz animation timer callback
+     * Hand-rolled 60Hz animation, one step per display frame
      * CRITICAL: Calls parent->resized() every frame for smooth push-down effect
      */
-    void timerCallback() override
+    void frameTick() override
     {
         bool needsMoreFrames = false;
 
@@ -931,15 +933,15 @@ public:
             currentHoverOffset = targetOffset;
         }
 
-        // Only repaint if still animating; stop timer when all done
+        // Only repaint if still animating; stop frames when all done
         if (needsMoreFrames || isAnimating)
         {
-            repaint();
+            repaintFrame();
         }
         else
         {
-            repaint();  // Final frame
-            stopTimer();
+            repaintFrame();  // Final frame
+            stopFrames();
         }
     }
 
@@ -1073,11 +1075,11 @@ private:
         return { cardX, cardY, cardW, cardH };
     }
 
-    /** Start the 60Hz timer if not already running */
-    void ensureTimerRunning()
+    /** Start receiving frames if not already */
+    void ensureFramesRunning()
     {
-        if (!isTimerRunning())
-            startTimerHz(60);
+        if (!isReceivingFrames())
+            startFrames();
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterCardComponent)
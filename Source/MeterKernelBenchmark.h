@@ -0,0 +1,314 @@
+/*
+  ==============================================================================
+    MeterKernelBenchmark.h
+    GOODMETER - Per-instance CPU cost of the real-time analysis path
+
+    Headless micro-benchmark, run from the standalone binary:
+
+        GOODMETER --benchmark-meter-kernel [blockSize] [sampleRate] [instances]
+
+    Three measurements on the same generated stereo programme:
+      1. legacy   - the previous scalar multi-pass loops (peak/RMS/correlation
+                    + FFT ring, then M/S, then 3-band, then decimation)
+      2. fused    - MeterAnalysisKernel chunked single pass doing the same work
+      3. process  - a full GOODMETERAudioProcessor::processBlock (loudness,
+                    true peak and the hand-off to the FFT worker included)
+
+    FFT transforms (now on SpectrumAnalysisWorker), loudness and true peak
+    are left out of 1 and 2, so the ratio isolates the pass structure. The
+    fused pass uses the LR4 CrossoverFilterBank (twice the filter order of
+    the legacy Butterworth bands), exactly as processBlock does. Results are
+    printed as JSON: ns/sample, µs per callback and the projected share of
+    the real-time budget for `instances` concurrent meters.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "MeterAnalysisKernel.h"
+#include "CrossoverFilterBank.h"
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace goodmeter
+{
+namespace benchmark
+{
+
+//==============================================================================
+/** Shared state for the legacy and fused passes (same filters, ring, decimator). */
+struct MeterPassState
+{
+    static constexpr int fftSize = GOODMETERAudioProcessor::fftSize;
+    static constexpr int fftHopSize = fftSize / 4;
+
+    void prepare(double sampleRate, int blockSize)
+    {
+        juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), 1 };
+
+        for (auto* f : { &lowL, &lowR })   *f->coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 250.0f, 0.707f);
+        for (auto* f : { &midHpL, &midHpR }) *f->coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 250.0f, 0.707f);
+        for (auto* f : { &midLpL, &midLpR }) *f->coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 2000.0f, 0.707f);
+        for (auto* f : { &highL, &highR }) *f->coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 2000.0f, 0.707f);
+
+        for (auto* f : { &lowL, &lowR, &midHpL, &midHpR, &midLpL, &midLpR, &highL, &highR })
+        {
+            f->prepare(spec);
+            f->reset();
+        }
+
+        bank.prepare(sampleRate);
+
+        ringL.fill(0.0f);
+        ringR.fill(0.0f);
+        ringIndex = 0;
+        samplesSinceHop = 0;
+        hops = 0;
+        stereoIndex = 0;
+    }
+
+    juce::dsp::IIR::Filter<float> lowL, lowR, midHpL, midHpR, midLpL, midLpR, highL, highR;
+    CrossoverFilterBank bank;
+    std::array<float, fftSize> ringL {}, ringR {};
+    std::array<float, 512> stereoL {}, stereoR {};
+    int ringIndex = 0, samplesSinceHop = 0, hops = 0, stereoIndex = 0;
+
+    // Consumed so the optimiser cannot drop the work
+    float sink = 0.0f;
+};
+
+//==============================================================================
+/** The pre-fusion processBlock loops, kept verbatim as the baseline. */
+inline void runLegacyPasses(MeterPassState& s, const float* channelDataL, const float* channelDataR, int numSamples)
+{
+    float localPeakL = 0.0f, localPeakR = 0.0f;
+    float localSumSquareL = 0.0f, localSumSquareR = 0.0f;
+    float localSumXY = 0.0f, localSumX2 = 0.0f, localSumY2 = 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float sampleL = channelDataL[i];
+        const float sampleR = channelDataR[i];
+
+        const float absL = std::abs(sampleL);
+        const float absR = std::abs(sampleR);
+        if (absL > localPeakL) localPeakL = absL;
+        if (absR > localPeakR) localPeakR = absR;
+
+        localSumSquareL += sampleL * sampleL;
+        localSumSquareR += sampleR * sampleR;
+
+        localSumXY += sampleL * sampleR;
+        localSumX2 += sampleL * sampleL;
+        localSumY2 += sampleR * sampleR;
+
+        s.ringL[(size_t) s.ringIndex] = sampleL;
+        s.ringR[(size_t) s.ringIndex] = sampleR;
+        s.ringIndex = (s.ringIndex + 1) % MeterPassState::fftSize;
+        if (++s.samplesSinceHop >= MeterPassState::fftHopSize)
+        {
+            ++s.hops;
+            s.samplesSinceHop = 0;
+        }
+    }
+
+    float localSumSquareMid = 0.0f, localSumSquareSide = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float mid = (channelDataL[i] + channelDataR[i]) * 0.5f;
+        const float side = (channelDataL[i] - channelDataR[i]) * 0.5f;
+        localSumSquareMid += mid * mid;
+        localSumSquareSide += side * side;
+    }
+
+    float localSumSquareLow = 0.0f, localSumSquareMid3Band = 0.0f, localSumSquareHigh = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float sampleL = channelDataL[i];
+        const float sampleR = channelDataR[i];
+
+        const float lowL = s.lowL.processSample(sampleL);
+        const float lowR = s.lowR.processSample(sampleR);
+        const float midL = s.midLpL.processSample(s.midHpL.processSample(sampleL));
+        const float midR = s.midLpR.processSample(s.midHpR.processSample(sampleR));
+        const float highL = s.highL.processSample(sampleL);
+        const float highR = s.highR.processSample(sampleR);
+
+        localSumSquareLow += (lowL * lowL + lowR * lowR);
+        localSumSquareMid3Band += (midL * midL + midR * midR);
+        localSumSquareHigh += (highL * highL + highR * highR);
+    }
+
+    for (int i = 0; i < numSamples; i += 2)
+    {
+        s.stereoL[(size_t) s.stereoIndex] = channelDataL[i];
+        s.stereoR[(size_t) s.stereoIndex] = channelDataR[i];
+        if (++s.stereoIndex >= 512)
+            s.stereoIndex = 0;
+    }
+
+    s.sink += localPeakL + localPeakR + localSumSquareL + localSumSquareR
+            + localSumXY / (1.0f + localSumX2 * localSumY2)
+            + localSumSquareMid + localSumSquareSide
+            + localSumSquareLow + localSumSquareMid3Band + localSumSquareHigh;
+}
+
+//==============================================================================
+/** The fused chunk loop used by processBlock, minus FFT/loudness/true peak. */
+inline void runFusedPass(MeterPassState& s, const float* channelDataL, const float* channelDataR, int numSamples)
+{
+    StereoBlockStats stats;
+    std::array<float, CrossoverFilterBank::kMaxBands> bandEnergies {};
+
+    // FFT hand-off: processBlock only copies the block to the analysis worker
+    for (int done = 0; done < numSamples;)
+    {
+        const int segment = juce::jmin(numSamples - done, MeterPassState::fftSize - s.ringIndex);
+        std::copy(channelDataL + done, channelDataL + done + segment, s.ringL.begin() + s.ringIndex);
+        std::copy(channelDataR + done, channelDataR + done + segment, s.ringR.begin() + s.ringIndex);
+        s.ringIndex = (s.ringIndex + segment) % MeterPassState::fftSize;
+        done += segment;
+    }
+
+    for (int offset = 0; offset < numSamples; offset += MeterAnalysisKernel::kChunkSize)
+    {
+        const int run = juce::jmin(MeterAnalysisKernel::kChunkSize, numSamples - offset);
+        const float* chunkL = channelDataL + offset;
+        const float* chunkR = channelDataR + offset;
+
+        MeterAnalysisKernel::accumulateStereo(chunkL, chunkR, run, stats);
+
+        s.bank.process(chunkL, chunkR, run, bandEnergies.data());
+
+        for (int i = 0; i < run; i += 2)
+        {
+            s.stereoL[(size_t) s.stereoIndex] = chunkL[i];
+            s.stereoR[(size_t) s.stereoIndex] = chunkR[i];
+            if (++s.stereoIndex >= 512)
+                s.stereoIndex = 0;
+        }
+    }
+
+    s.sink += stats.peakL + stats.peakR + stats.sumSquareL + stats.sumSquareR
+            + stats.sumLR / (1.0f + stats.sumSquareL * stats.sumSquareR)
+            + stats.sumSquareMid + stats.sumSquareSide
+            + bandEnergies[0] + bandEnergies[1] + bandEnergies[2];
+}
+
+//==============================================================================
+/** Broadband test programme: decorrelated noise with a slow level envelope. */
+inline juce::AudioBuffer<float> makeBenchmarkProgramme(double sampleRate, double seconds)
+{
+    const int numSamples = juce::jmax(1, static_cast<int>(sampleRate * seconds));
+    juce::AudioBuffer<float> programme(2, numSamples);
+    juce::Random random(0x600d);
+
+    auto* left = programme.getWritePointer(0);
+    auto* right = programme.getWritePointer(1);
+    const double envelopeStep = juce::MathConstants<double>::twoPi * 0.5 / sampleRate;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float envelope = 0.1f + 0.4f * (0.5f + 0.5f * static_cast<float>(std::sin(envelopeStep * i)));
+        const float common = random.nextFloat() * 2.0f - 1.0f;
+        left[i] = envelope * (0.7f * common + 0.3f * (random.nextFloat() * 2.0f - 1.0f));
+        right[i] = envelope * (0.7f * common + 0.3f * (random.nextFloat() * 2.0f - 1.0f));
+    }
+
+    return programme;
+}
+
+//==============================================================================
+/** Times `callback(offset, numSamples)` over the programme in blockSize steps. */
+template <typename Callback>
+inline double measureNanosecondsPerSample(int totalSamples, int blockSize, int passes, Callback&& callback)
+{
+    const auto ticksPerSecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    double best = std::numeric_limits<double>::max();
+
+    // Best of N: scheduler noise only ever adds time
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int offset = 0; offset + blockSize <= totalSamples; offset += blockSize)
+            callback(offset, blockSize);
+
+        const auto elapsed = static_cast<double>(juce::Time::getHighResolutionTicks() - start);
+        best = juce::jmin(best, elapsed / ticksPerSecond);
+    }
+
+    const int processed = (totalSamples / blockSize) * blockSize;
+    return processed > 0 ? best * 1.0e9 / processed : 0.0;
+}
+
+//==============================================================================
+inline juce::String runMeterKernelBenchmark(int blockSize = 512, double sampleRate = 48000.0, int instances = 20)
+{
+    blockSize = juce::jlimit(16, 8192, blockSize);
+    sampleRate = juce::jlimit(8000.0, 384000.0, sampleRate);
+    instances = juce::jmax(1, instances);
+
+    constexpr int passes = 5;
+    const auto programme = makeBenchmarkProgramme(sampleRate, 10.0);
+    const int totalSamples = programme.getNumSamples();
+    const float* left = programme.getReadPointer(0);
+    const float* right = programme.getReadPointer(1);
+
+    MeterPassState legacyState, fusedState;
+    legacyState.prepare(sampleRate, blockSize);
+    fusedState.prepare(sampleRate, blockSize);
+
+    const double legacyNs = measureNanosecondsPerSample(totalSamples, blockSize, passes,
+        [&](int offset, int n) { runLegacyPasses(legacyState, left + offset, right + offset, n); });
+
+    const double fusedNs = measureNanosecondsPerSample(totalSamples, blockSize, passes,
+        [&](int offset, int n) { runFusedPass(fusedState, left + offset, right + offset, n); });
+
+    // Full processBlock on a real instance (block-sized copy, as a host would pass)
+    GOODMETERAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+
+    const double processNs = measureNanosecondsPerSample(totalSamples, blockSize, passes,
+        [&](int offset, int n)
+        {
+            block.copyFrom(0, 0, programme, 0, offset, n);
+            block.copyFrom(1, 0, programme, 1, offset, n);
+            processor.processBlock(block, midi);
+        });
+
+    processor.releaseResources();
+
+    auto describe = [&](double nsPerSample)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("nsPerSample", nsPerSample);
+        entry->setProperty("usPerCallback", nsPerSample * blockSize * 1.0e-3);
+        // Share of one core's real-time budget for all instances together
+        entry->setProperty("realtimePercentAllInstances", nsPerSample * 1.0e-9 * sampleRate * instances * 100.0);
+        return juce::var(entry);
+    };
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("blockSize", blockSize);
+    result->setProperty("sampleRate", sampleRate);
+    result->setProperty("instances", instances);
+    result->setProperty("simd", static_cast<bool>(JUCE_USE_SIMD));
+    result->setProperty("legacy", describe(legacyNs));
+    result->setProperty("fused", describe(fusedNs));
+    result->setProperty("speedup", fusedNs > 0.0 ? legacyNs / fusedNs : 0.0);
+    result->setProperty("processBlock", describe(processNs));
+    result->setProperty("checksum", legacyState.sink + fusedState.sink);
+
+    return juce::JSON::toString(juce::var(result));
+}
+
+} // namespace benchmark
+} // namespace goodmeter
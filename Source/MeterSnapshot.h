@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+    MeterSnapshot.h
+    GOODMETER - Coherent per-block meter state for the GUI
+
+    processBlock fills one MeterSnapshot with every scalar it measured and
+    publishes it once, at the end of the block. GUI code reads the whole
+    snapshot in one go, so peak, RMS, LUFS, phase and band values on screen
+    always belong to the same audio block (the individual atomics could mix
+    blocks within a single frame).
+
+    SeqlockSnapshot is a single-slot seqlock:
+      - Writer (audio thread): never blocks, never allocates
+      - Reader (message thread): copies, retries if a publish raced the copy,
+        and keeps its last good copy if the writer stays busy
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CrossoverFilterBank.h"
+#include "LoudnessEngine.h"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+//==============================================================================
+struct MeterSnapshot
+{
+    static constexpr int maxBands = CrossoverFilterBank::kMaxBands;
+    static constexpr int maxLoudnessChannels = LoudnessEngine::kMaxChannels;
+
+    juce::uint64 blockIndex = 0;     // 0 = nothing published yet
+
+    float peakL = -90.0f, peakR = -90.0f;           // dBFS
+    float truePeakL = -90.0f, truePeakR = -90.0f;   // dBTP
+    float rmsL = -90.0f, rmsR = -90.0f;             // dBFS
+
+    float lufsMomentary = -70.0f;
+    float lufsShortTerm = -70.0f;
+    float lufsIntegrated = -70.0f;
+    float luRange = 0.0f;
+
+    // Momentary loudness of each metered channel (bus order; LFE included,
+    // though it is left out of the sum). Stereo fallback meters two.
+    std::array<float, maxLoudnessChannels> channelLufs {};
+    int numLoudnessChannels = 2;
+
+    float phaseCorrelation = 0.0f;
+    float rmsMid = -90.0f, rmsSide = -90.0f;
+
+    // LOW / MID / HIGH = first, second and last band
+    float rmsLow = -90.0f, rmsMid3Band = -90.0f, rmsHigh = -90.0f;
+    std::array<float, maxBands> bandRms {};
+    int numBands = 3;
+};
+
+static_assert(std::is_trivially_copyable<MeterSnapshot>::value, "MeterSnapshot is copied with memcpy");
+
+//==============================================================================
+template <typename T>
+class SeqlockSnapshot
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock payloads are copied with memcpy");
+
+    /** Writer thread only. */
+    void publish(const T& value) noexcept
+    {
+        const auto seq = sequence.load(std::memory_order_relaxed);
+
+        sequence.store(seq + 1, std::memory_order_relaxed);      // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&data, &value, sizeof(T));
+        sequence.store(seq + 2, std::memory_order_release);      // even: stable
+    }
+
+    /** Copy the latest published value. False if every attempt raced a publish. */
+    bool read(T& dest) const noexcept
+    {
+        for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+        {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            T copy;
+            std::memcpy(&copy, &data, sizeof(T));
+
+            // Acquire fence: the copy completes before the sequence is re-checked
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+            {
+                dest = copy;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    // A publish is one ~200 byte memcpy, so a handful of retries is plenty
+    static constexpr int maxReadAttempts = 8;
+
+    std::atomic<juce::uint64> sequence { 0 };
+    T data {};
+};
@@ -0,0 +1,326 @@
+/*
+  ==============================================================================
+    MultiResolutionSpectrum.h
+    GOODMETER - Constant-Q-like spectrum from several short FFTs
+
+    A single 4096-point FFT is 85 ms long at 48 kHz (slow for transients)
+    yet still only 11.7 Hz per bin (coarse under 100 Hz). This engine runs
+    one 1024-point FFT per octave tier instead:
+
+      - Tier 0 reads the newest 1024 samples of the worker's full-rate ring
+      - Tiers 1..4 read their own 1024-sample rings, fed by a cascade of
+        half-band decimators (÷2, ÷4, ÷8, ÷16)
+      - Each tier serves the octave starting kMinBinsPerTier of its bins
+        up (at 48 kHz: 21 ms windows above ~750 Hz, 5.9 Hz bins below
+        ~190 Hz, 2.9 Hz below ~94 Hz); the halves of an octave nearest a
+        seam are crossfaded with the neighbouring tier so seams don't show
+      - A tier is only re-transformed once its own 75%-overlap hop has
+        passed, so per published frame at hop 1024 the cost is ~3.75
+        1024-point transforms, less than one 4096-point transform
+
+    The result is kNumBins log-spaced magnitudes from kMinFrequency to
+    kMaxFrequency, scaled as magnitude / kFftSize (the same scale as the
+    linear frames divided by their FFT size). Since every tier uses the
+    same size and window, a sine reads at the same level in every tier.
+
+    Thread safety model:
+      - prepare(): before the owning worker starts
+      - push() / computeFrame(): the owning worker thread only
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+class MultiResolutionSpectrum
+{
+public:
+    static constexpr int kFftOrder = 10;
+    static constexpr int kFftSize = 1 << kFftOrder;     // every tier
+    static constexpr int kNumTiers = 5;                 // full rate, then ÷2 ... ÷16
+    static constexpr int kNumBins = 512;                // log-spaced output
+    static constexpr int kMinBinsPerTier = 16;          // lowest usable bin of a tier
+    static constexpr float kMinFrequency = 20.0f;
+    static constexpr float kMaxFrequency = 20000.0f;
+
+    /** Centre frequency of output bin (log-spaced). */
+    static float binFrequency(float bin) noexcept
+    {
+        return kMinFrequency * std::pow(kMaxFrequency / kMinFrequency, bin / static_cast<float>(kNumBins - 1));
+    }
+
+    MultiResolutionSpectrum()
+    {
+        designHalfband();
+        prepare(48000.0);
+    }
+
+    //==========================================================================
+    /** Build the bin map for this rate and start from silence. */
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+        buildBinMap();
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& ring : tierRings) ring.fill(0.0f);
+        for (auto& mags : tierMagnitudes) mags.fill(0.0f);
+        for (auto& stage : stages) stage = {};
+        tierRingIndex.fill(0);
+        samplesSinceTransform.fill(kNeverTransformed);
+    }
+
+    //==========================================================================
+    /** The same full-rate samples the shared ring receives, in order. */
+    void push(const float* samples, int numSamples) noexcept
+    {
+        for (auto& count : samplesSinceTransform)
+            count = juce::jmin(count + numSamples, kNeverTransformed);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = samples[i];
+            for (int tier = 1; tier < kNumTiers; ++tier)
+            {
+                // Each stage emits every second input; the next stage only runs then
+                if (! stages[(size_t) tier - 1].process(x, halfband, x))
+                    break;
+
+                auto& ring = tierRings[(size_t) tier];
+                auto& index = tierRingIndex[(size_t) tier];
+                ring[(size_t) index] = x;
+                index = (index + 1) & (kFftSize - 1);
+            }
+        }
+    }
+
+    /** Re-transform the tiers whose hop has passed and stitch dest[kNumBins].
+        sharedRing holds the newest ringSize full-rate samples, oldest at ringIndex. */
+    void computeFrame(const float* sharedRing, int ringSize, int ringIndex, float* dest)
+    {
+        jassert(ringSize >= kFftSize);
+
+        for (int tier = 0; tier < kNumTiers; ++tier)
+        {
+            if (samplesSinceTransform[(size_t) tier] < (kFftSize / 4) << tier)
+                continue;
+
+            if (tier == 0)
+            {
+                // Newest kFftSize samples of the shared ring
+                const int start = (ringIndex + ringSize - kFftSize) % ringSize;
+                const int first = juce::jmin(kFftSize, ringSize - start);
+                std::copy(sharedRing + start, sharedRing + start + first, work.begin());
+                std::copy(sharedRing, sharedRing + (kFftSize - first), work.begin() + first);
+            }
+            else
+            {
+                const auto& ring = tierRings[(size_t) tier];
+                const int oldest = tierRingIndex[(size_t) tier];
+                std::copy(ring.begin() + oldest, ring.end(), work.begin());
+                std::copy(ring.begin(), ring.begin() + oldest, work.begin() + (kFftSize - oldest));
+            }
+
+            transform(tierMagnitudes[(size_t) tier]);
+            samplesSinceTransform[(size_t) tier] = 0;
+        }
+
+        for (int bin = 0; bin < kNumBins; ++bin)
+        {
+            const auto& b = binMap[(size_t) bin];
+            const float own = b.own.read(tierMagnitudes[(size_t) b.tier]);
+            if (b.neighbourWeight <= 0.0f)
+            {
+                dest[bin] = own;
+                continue;
+            }
+
+            const float neighbour = b.neighbour.read(tierMagnitudes[(size_t) b.neighbourTier]);
+            dest[bin] = own + b.neighbourWeight * (neighbour - own);
+        }
+    }
+
+private:
+    //==========================================================================
+    static constexpr int kHalfbandTaps = 15;            // odd; every second tap off-centre is zero
+    static constexpr double kCrossfadeOctaves = 0.5;    // either side of a seam
+    static constexpr int kNeverTransformed = std::numeric_limits<int>::max() / 2;
+
+    /** Where in one tier's linear bins an output bin reads. */
+    struct Tap
+    {
+        int firstBin = 1, endBin = 1;       // max over [firstBin, endBin) ...
+        int interpBin = 1;                  // ... or, if that's empty, lerp interpBin → interpBin + 1
+        float fraction = 0.0f;
+
+        float read(const std::array<float, kFftSize / 2>& mags) const noexcept
+        {
+            if (endBin > firstBin)
+                return juce::FloatVectorOperations::findMaximum(mags.data() + firstBin, endBin - firstBin);
+
+            const float a = mags[(size_t) interpBin];
+            return a + fraction * (mags[(size_t) interpBin + 1] - a);
+        }
+    };
+
+    struct BinSource
+    {
+        int tier = 0, neighbourTier = 0;
+        Tap own, neighbour;
+        float neighbourWeight = 0.0f;       // 0.5 at a seam, 0 half an octave away from it
+    };
+
+    /** Half-band low-pass + ÷2, direct form with a doubled delay line. */
+    struct Decimator
+    {
+        std::array<float, kHalfbandTaps * 2> history {};
+        int pos = 0;
+        bool odd = false;
+
+        /** Store x; every second call writes the filtered output and returns true. */
+        bool process(float x, const std::array<float, kHalfbandTaps>& taps, float& out) noexcept
+        {
+            history[(size_t) pos] = history[(size_t) (pos + kHalfbandTaps)] = x;
+            pos = (pos + 1) % kHalfbandTaps;
+
+            odd = ! odd;
+            if (odd)
+                return false;
+
+            float sum = 0.0f;
+            const float* h = history.data() + pos;
+            for (int t = 0; t < kHalfbandTaps; ++t)
+                sum += taps[(size_t) t] * h[t];
+            out = sum;
+            return true;
+        }
+    };
+
+    //==========================================================================
+    void designHalfband()
+    {
+        // Blackman-windowed sinc at a quarter of the input rate; DC gain 1
+        constexpr int centre = kHalfbandTaps / 2;
+        float sum = 0.0f;
+        for (int t = 0; t < kHalfbandTaps; ++t)
+        {
+            const int k = t - centre;
+            const double sinc = k == 0 ? 0.5 : std::sin(juce::MathConstants<double>::pi * k / 2.0) / (juce::MathConstants<double>::pi * k);
+            const double phase = juce::MathConstants<double>::twoPi * t / (kHalfbandTaps - 1);
+            const double blackman = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+            halfband[(size_t) t] = static_cast<float>(sinc * blackman);
+            sum += halfband[(size_t) t];
+        }
+
+        for (auto& tap : halfband)
+            tap /= sum;
+    }
+
+    double tierBinHz(int tier) const noexcept
+    {
+        return sampleRate / static_cast<double>(kFftSize << tier);
+    }
+
+    /** Coarsest (fastest) tier that has at least kMinBinsPerTier bins below frequency. */
+    int tierFor(double frequency) const noexcept
+    {
+        for (int tier = kNumTiers - 1; tier > 0; --tier)
+            if (frequency < kMinBinsPerTier * tierBinHz(tier - 1))
+                return tier;
+        return 0;
+    }
+
+    Tap makeTap(int tier, double loHz, double hiHz, double centreHz) const noexcept
+    {
+        constexpr int numLinearBins = kFftSize / 2;
+        const double perBin = tierBinHz(tier);
+        const double lo = loHz / perBin, hi = hiHz / perBin, centre = centreHz / perBin;
+
+        Tap tap;
+        tap.firstBin = juce::jlimit(1, numLinearBins, static_cast<int>(std::ceil(lo)));
+        tap.endBin = juce::jlimit(tap.firstBin, numLinearBins, static_cast<int>(std::floor(hi)) + 1);
+        if (hi - lo < 1.0)
+            tap.endBin = tap.firstBin;          // narrower than a bin: interpolate instead
+
+        tap.interpBin = juce::jlimit(1, numLinearBins - 2, static_cast<int>(centre));
+        tap.fraction = juce::jlimit(0.0f, 1.0f, static_cast<float>(centre - tap.interpBin));
+        return tap;
+    }
+
+    void buildBinMap()
+    {
+        const double halfStep = std::pow(static_cast<double>(kMaxFrequency / kMinFrequency), 0.5 / (kNumBins - 1));
+
+        for (int bin = 0; bin < kNumBins; ++bin)
+        {
+            const double f = binFrequency(static_cast<float>(bin));
+            const double lo = f / halfStep, hi = f * halfStep;
+
+            auto& source = binMap[(size_t) bin];
+            source.tier = tierFor(f);
+            source.own = makeTap(source.tier, lo, hi, f);
+            source.neighbourTier = source.tier;
+            source.neighbourWeight = 0.0f;
+
+            // Tier k serves [seam k, seam k-1), one octave: the lower half fades
+            // towards the finer tier k+1, the upper half towards the coarser k-1
+            const double ownSeam = kMinBinsPerTier * tierBinHz(source.tier);
+            const double octavesAbove = std::log2(f / ownSeam);
+            const double octavesBelow = 1.0 - octavesAbove;
+
+            int neighbour = -1;
+            double distance = 0.0;
+            if (octavesAbove < kCrossfadeOctaves && source.tier < kNumTiers - 1 && octavesAbove >= 0.0)
+            {
+                neighbour = source.tier + 1;
+                distance = octavesAbove;
+            }
+            else if (octavesBelow < kCrossfadeOctaves && source.tier > 0)
+            {
+                neighbour = source.tier - 1;
+                distance = octavesBelow;
+            }
+
+            if (neighbour >= 0)
+            {
+                source.neighbourTier = neighbour;
+                source.neighbour = makeTap(neighbour, lo, hi, f);
+                source.neighbourWeight = static_cast<float>(0.5 * (1.0 - distance / kCrossfadeOctaves));
+            }
+        }
+    }
+
+    /** Window + magnitude FFT of work[0, kFftSize) into mags, scaled by 1 / kFftSize. */
+    void transform(std::array<float, kFftSize / 2>& mags)
+    {
+        std::fill(work.begin() + kFftSize, work.end(), 0.0f);
+        window.multiplyWithWindowingTable(work.data(), kFftSize);
+        fft.performFrequencyOnlyForwardTransform(work.data());
+        juce::FloatVectorOperations::multiply(mags.data(), work.data(), 1.0f / kFftSize, kFftSize / 2);
+    }
+
+    //==========================================================================
+    double sampleRate = 48000.0;
+    std::array<float, kHalfbandTaps> halfband {};
+    std::array<Decimator, kNumTiers - 1> stages {};
+
+    std::array<std::array<float, kFftSize>, kNumTiers> tierRings {};     // [0] unused: tier 0 reads the shared ring
+    std::array<int, kNumTiers> tierRingIndex {};
+    std::array<int, kNumTiers> samplesSinceTransform {};                 // at the full rate
+    std::array<std::array<float, kFftSize / 2>, kNumTiers> tierMagnitudes {};
+    std::array<BinSource, kNumBins> binMap {};
+
+    std::array<float, kFftSize * 2> work {};
+    juce::dsp::FFT fft { kFftOrder };
+    juce::dsp::WindowingFunction<float> window { kFftSize, juce::dsp::WindowingFunction<float>::hann };
+
+    JUCE_DECLARE_NON_COPYABLE(MultiResolutionSpectrum)
+};
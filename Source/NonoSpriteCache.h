@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+    NonoSpriteCache.h
+    GOODMETER - Pre-rendered, DPI-aware sprites for the NONO character
+
+    HoloNonoComponent builds NONO / GUOBA from paths, gradients and layered
+    glow strokes, and most of that is identical from one frame to the next:
+    the idle float, orbit and collisions only move the character, and the
+    ears only bob. The cache renders those static layers once per pose into
+    an atlas (one cell per layer) at the display's pixel scale, so a steady
+    frame is a handful of image blits plus the procedural dynamic parts
+    (eyes, recording grid, test tube, particles...).
+
+      - Atlases are keyed on pose, radius (quarter device pixels) and pixel
+        scale; a resize or a move to another display renders a new one
+      - Rendering happens on a low-priority background thread; until an
+        atlas is ready draw() returns false and the caller paints the layer
+        procedurally, so nothing ever waits for the cache
+      - Blits are snapped to device pixels, so the software renderer copies
+        rows instead of resampling
+      - At most kMaxAtlases are kept; the least recently drawn goes first
+
+    The painter runs on the background thread: it must draw only from its
+    arguments (pose, layer, geometry) and from data that never changes.
+
+    Thread safety model:
+      - prewarm() / draw(): message thread
+      - Painter: background thread, into a software image (no fonts)
+      - Requests and finished atlases are handed over under a SpinLock
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+class NonoSpriteCache : private juce::Thread
+{
+public:
+    static constexpr int kMaxAtlases = 6;
+
+    /** Draw one layer of a pose centred on (cx, cy) with the given radius. */
+    using Painter = std::function<void(juce::Graphics&, int pose, int layer, float cx, float cy, float r)>;
+
+    /** Area a layer covers around the centre, in radii; empty if the pose has no such layer. */
+    using LayerBounds = std::function<juce::Rectangle<float>(int pose, int layer)>;
+
+    NonoSpriteCache(int numLayersToUse, Painter painterToUse, LayerBounds boundsToUse,
+                    float paddingInPoints = 8.0f)
+        : Thread("GOODMETER-NonoSprites"),
+          numLayers(juce::jmax(1, numLayersToUse)),
+          painter(std::move(painterToUse)),
+          layerBounds(std::move(boundsToUse)),
+          padding(paddingInPoints)
+    {
+    }
+
+    ~NonoSpriteCache() override
+    {
+        stopThread(2000);
+    }
+
+    //==========================================================================
+    /** Queue the atlas for pose at this radius and pixel scale (no-op if present). */
+    void prewarm(int pose, float radius, float pixelScale)
+    {
+        collectFinished();
+        const auto key = makeKey(pose, radius, pixelScale);
+        if (key.radiusQ > 0 && find(key) == nullptr)
+            request(key);
+    }
+
+    /** Blit layer of pose with its centre at (cx, cy). Returns false (and
+        queues the atlas) when it isn't rendered yet or the layer is empty. */
+    bool draw(juce::Graphics& g, int pose, int layer, float cx, float cy, float radius, float pixelScale)
+    {
+        collectFinished();
+        const auto key = makeKey(pose, radius, pixelScale);
+        if (key.radiusQ <= 0 || layer < 0 || layer >= numLayers)
+            return false;
+
+        auto* atlas = find(key);
+        if (atlas == nullptr)
+        {
+            request(key);
+            return false;
+        }
+
+        atlas->lastUsed = ++useCounter;
+        const auto& cell = atlas->cells[(size_t) layer];
+        if (cell.image.isNull())
+            return false;
+
+        // Cell origin → centre offset, snapped to a device pixel
+        const float scale = key.pixelScale();
+        const float x = std::round((cx + cell.originX) * scale) / scale;
+        const float y = std::round((cy + cell.originY) * scale) / scale;
+        g.drawImageTransformed(cell.image, juce::AffineTransform::scale(1.0f / scale).translated(x, y));
+        return true;
+    }
+
+private:
+    //==========================================================================
+    struct Key
+    {
+        int pose = 0;
+        int radiusQ = 0;          // radius × pixel scale × 4
+        int scaleQ = 0;           // pixel scale × 100
+
+        float pixelScale() const noexcept   { return static_cast<float>(scaleQ) / 100.0f; }
+        float radius() const noexcept       { return static_cast<float>(radiusQ) / (4.0f * pixelScale()); }
+        bool operator== (const Key& o) const noexcept
+        {
+            return pose == o.pose && radiusQ == o.radiusQ && scaleQ == o.scaleQ;
+        }
+    };
+
+    struct Cell
+    {
+        juce::Image image;                  // sub-image of the atlas
+        float originX = 0.0f, originY = 0.0f;  // top-left relative to the centre, in points
+    };
+
+    struct Atlas
+    {
+        Key key;
+        juce::Image image;
+        std::vector<Cell> cells;
+        juce::uint64 lastUsed = 0;
+    };
+
+    static Key makeKey(int pose, float radius, float pixelScale) noexcept
+    {
+        Key key;
+        key.pose = pose;
+        key.scaleQ = juce::jmax(100, juce::roundToInt(pixelScale * 100.0f));
+        key.radiusQ = juce::roundToInt(radius * key.pixelScale() * 4.0f);
+        return key;
+    }
+
+    Atlas* find(const Key& key)
+    {
+        for (auto& atlas : atlases)
+            if (atlas.key == key)
+                return &atlas;
+        return nullptr;
+    }
+
+    void request(const Key& key)
+    {
+        {
+            const juce::SpinLock::ScopedLockType lock(handoverLock);
+            for (const auto& pendingKey : pending)
+                if (pendingKey == key)
+                    return;
+            for (const auto& done : finished)
+                if (done.key == key)
+                    return;
+
+            // A live resize asks for a new radius every frame: only the latest
+            // size of each pose is worth rendering (entry 0 may be in progress)
+            if (pending.size() > 1)
+                pending.erase(std::remove_if(pending.begin() + 1, pending.end(),
+                                             [&key] (const Key& k) { return k.pose == key.pose; }),
+                              pending.end());
+            pending.push_back(key);
+        }
+
+        if (! isThreadRunning())
+            startThread(juce::Thread::Priority::low);
+        notify();
+    }
+
+    /** Move atlases the worker has finished into the cache, evicting the stalest. */
+    void collectFinished()
+    {
+        std::vector<Atlas> done;
+        {
+            const juce::SpinLock::ScopedLockType lock(handoverLock);
+            if (finished.empty())
+                return;
+            done.swap(finished);
+        }
+
+        for (auto& atlas : done)
+        {
+            if (atlases.size() >= (size_t) kMaxAtlases)
+            {
+                auto stalest = std::min_element(atlases.begin(), atlases.end(),
+                                                [] (const Atlas& a, const Atlas& b) { return a.lastUsed < b.lastUsed; });
+                atlases.erase(stalest);
+            }
+
+            atlas.lastUsed = ++useCounter;
+            atlases.push_back(std::move(atlas));
+        }
+    }
+
+    //==========================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            Key key;
+            bool haveWork = false;
+            {
+                const juce::SpinLock::ScopedLockType lock(handoverLock);
+                if (! pending.empty())
+                {
+                    key = pending.front();
+                    haveWork = true;
+                }
+            }
+
+            if (! haveWork)
+            {
+                wait(-1);
+                continue;
+            }
+
+            auto atlas = render(key);
+
+            const juce::SpinLock::ScopedLockType lock(handoverLock);
+            pending.erase(pending.begin());
+            finished.push_back(std::move(atlas));
+        }
+    }
+
+    /** Lay the pose's layers out side by side and paint each into its cell. */
+    Atlas render(const Key& key) const
+    {
+        const float scale = key.pixelScale();
+        const float r = key.radius();
+
+        Atlas atlas;
+        atlas.key = key;
+        atlas.cells.resize((size_t) numLayers);
+
+        std::vector<juce::Rectangle<int>> pixelCells((size_t) numLayers);
+        int atlasW = 0, atlasH = 0;
+        for (int layer = 0; layer < numLayers; ++layer)
+        {
+            const auto area = layerBounds(key.pose, layer);
+            if (area.isEmpty())
+                continue;
+
+            auto& cell = atlas.cells[(size_t) layer];
+            cell.originX = area.getX() * r - padding;
+            cell.originY = area.getY() * r - padding;
+
+            const int w = static_cast<int>(std::ceil((area.getWidth() * r + padding * 2.0f) * scale));
+            const int h = static_cast<int>(std::ceil((area.getHeight() * r + padding * 2.0f) * scale));
+            pixelCells[(size_t) layer] = { atlasW, 0, w, h };
+            atlasW += w;
+            atlasH = juce::jmax(atlasH, h);
+        }
+
+        if (atlasW == 0 || atlasH == 0)
+            return atlas;
+
+        atlas.image = juce::Image(juce::Image::ARGB, atlasW, atlasH, true, juce::SoftwareImageType());
+        {
+            juce::Graphics g(atlas.image);
+            for (int layer = 0; layer < numLayers; ++layer)
+            {
+                const auto& pixelCell = pixelCells[(size_t) layer];
+                if (pixelCell.isEmpty())
+                    continue;
+
+                // Centre at -origin inside the cell, drawn at device resolution
+                const auto& cell = atlas.cells[(size_t) layer];
+                juce::Graphics::ScopedSaveState state(g);
+                g.reduceClipRegion(pixelCell);
+                g.addTransform(juce::AffineTransform::scale(scale).translated((float) pixelCell.getX(), 0.0f));
+                painter(g, key.pose, layer, -cell.originX, -cell.originY, r);
+            }
+        }
+
+        for (int layer = 0; layer < numLayers; ++layer)
+            if (! pixelCells[(size_t) layer].isEmpty())
+                atlas.cells[(size_t) layer].image = atlas.image.getClippedImage(pixelCells[(size_t) layer]);
+
+        return atlas;
+    }
+
+    //==========================================================================
+    const int numLayers;
+    const Painter painter;
+    const LayerBounds layerBounds;
+    const float padding;
+
+    std::vector<Atlas> atlases;             // message thread
+    juce::uint64 useCounter = 0;
+
+    juce::SpinLock handoverLock;
+    std::vector<Key> pending;               // front is being rendered
+    std::vector<Atlas> finished;
+
+    JUCE_DECLARE_NON_COPYABLE(NonoSpriteCache)
+};
@@ -0,0 +1,542 @@
+/*
+  ==============================================================================
+    OfflineAnalysisBenchmark.h
+    GOODMETER - Timings and memory of the heavy offline code paths
+
+    Run from the standalone binary, no audio device or window needed:
+
+        GOODMETER --benchmark-offline [--durations 5,30,120] [--channels 1,2,6]
+                  [--workloads refreshAnalysis,figures,...] [--passes 3]
+                  [--sample-rate 48000] [--plugin /path/to/Plugin.vst3]
+                  [--deepfilter-models /path/to/DeepFilterNet3_onnx]
+                  [--baseline baseline.json] [--write-baseline baseline.json]
+                  [--time-tolerance 0.15] [--memory-tolerance 0.25]
+
+    Each duration / channel count gets one deterministic programme, made
+    from a makeGeneratedSignalAsset() band_limited_noise spec. It is gated
+    3 s on / 1 s at a -66 dBFS floor so the room tone VAD has gaps to find.
+    Channels beyond the generator's two are offset copies. A fixed 2 ms
+    delay + one-pole low-pass of it is the "wet" side. The workloads run on
+    it one after the other:
+
+      - refreshAnalysis        full Audio Doctor analysis graph
+      - spectrogramImage       computeSpectrogramImage() (blue palette)
+      - transferGroupDelay     computeTransferGroupDelay(), dry -> wet
+      - roomTone               RoomToneExtractor::analyse() + synthesis
+      - figures                every FigureView drawn and PNG-encoded on a
+                               task graph, as JobRunner::writeOutputs() does
+      - deepFilter             DeepFilterProcessor::process() (needs models)
+      - pluginRender           PluginHost::renderOffline() (needs a plugin)
+
+    Per case the benchmark reports wall time (best of N passes), throughput
+    as × real time, and the peak memory footprint above the footprint
+    before the workload. Peak memory is sampled every 2 ms on a helper
+    thread, and freed memory is handed back to the OS between cases.
+    Output is JSON.
+
+    --write-baseline stores the result. With --baseline, every case is
+    compared to the stored one with the same workload / duration /
+    channels. A regression is slower wall time or higher peak memory by
+    more than the tolerance (and more than 10 ms / 1 MB outright, so tiny
+    cases don't flap). Regressions are listed in the output and the exit
+    code is 1.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisTaskGraph.h"
+#include "AudioDoctorAnalysis.h"
+#include "AudioDoctorFigureRenderer.h"
+#include "AudioDoctorPluginHost.h"
+#include "DeepFilterProcessor.h"
+#include "RoomToneExtractor.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <map>
+#include <vector>
+
+#if JUCE_MAC
+ #include <mach/mach.h>
+ #include <malloc/malloc.h>
+#elif JUCE_LINUX
+ #include <malloc.h>
+ #include <unistd.h>
+#endif
+
+namespace goodmeter
+{
+namespace benchmark
+{
+
+//==============================================================================
+/** Physical memory footprint of this process in bytes (0 where unsupported). */
+inline juce::int64 currentFootprintBytes() noexcept
+{
+#if JUCE_MAC
+    task_vm_info_data_t info {};
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+        return static_cast<juce::int64>(info.phys_footprint);
+    return 0;
+#elif JUCE_LINUX
+    long pages = 0, resident = 0;
+    if (auto* statm = std::fopen("/proc/self/statm", "r"))
+    {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose(statm);
+    }
+    return static_cast<juce::int64>(resident) * static_cast<juce::int64>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+/** Return freed heap pages to the OS so one case's leftovers don't hide the next one's peak. */
+inline void releaseFreedMemory() noexcept
+{
+#if JUCE_MAC
+    malloc_zone_pressure_relief(nullptr, 0);
+#elif JUCE_LINUX
+    malloc_trim(0);
+#endif
+}
+
+/** Highest footprint above the starting one while it lives, sampled every 2 ms. */
+class PeakMemorySampler : private juce::Thread
+{
+public:
+    PeakMemorySampler()
+        : Thread("GOODMETER-MemorySampler"),
+          baseline(currentFootprintBytes()),
+          peak(baseline)
+    {
+        startThread(juce::Thread::Priority::high);
+    }
+
+    ~PeakMemorySampler() override
+    {
+        stopThread(1000);
+    }
+
+    /** Stop sampling and return the peak above the starting footprint. */
+    juce::int64 finish()
+    {
+        stopThread(1000);
+        sample();
+        return juce::jmax<juce::int64>(0, peak.load(std::memory_order_relaxed) - baseline);
+    }
+
+private:
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            sample();
+            wait(2);
+        }
+    }
+
+    void sample() noexcept
+    {
+        const auto now = currentFootprintBytes();
+        auto previous = peak.load(std::memory_order_relaxed);
+        while (now > previous && ! peak.compare_exchange_weak(previous, now, std::memory_order_relaxed)) {}
+    }
+
+    const juce::int64 baseline;
+    std::atomic<juce::int64> peak;
+
+    JUCE_DECLARE_NON_COPYABLE(PeakMemorySampler)
+};
+
+//==============================================================================
+struct OfflineBenchmarkOptions
+{
+    std::vector<double> durations { 5.0, 30.0, 120.0 };      // the generator caps specs at 120 s
+    std::vector<int> channelCounts { 1, 2, 6 };
+    juce::StringArray workloads;                              // empty = all
+    double sampleRate = 48000.0;
+    int passes = 3;
+
+    juce::File pluginFile;                                    // pluginRender runs only with a plugin
+    juce::File deepFilterModels;                              // deepFilter runs only with models
+
+    juce::File baselineFile;                                  // compare against, if it exists
+    juce::File writeBaselineFile;                             // store this run, if set
+    double timeTolerance = 0.15;
+    double memoryTolerance = 0.25;
+};
+
+inline const juce::StringArray& offlineBenchmarkWorkloads()
+{
+    static const juce::StringArray names { "refreshAnalysis", "spectrogramImage", "transferGroupDelay",
+                                           "roomTone", "figures", "deepFilter", "pluginRender" };
+    return names;
+}
+
+//==============================================================================
+/** Dry programme and its fixed "wet" counterpart, both analysed. */
+struct OfflineBenchmarkInput
+{
+    audio_doctor::Asset dry;
+    audio_doctor::Asset wet;
+};
+
+inline OfflineBenchmarkInput makeOfflineBenchmarkInput(double seconds, int channels, double sampleRate)
+{
+    using namespace goodmeter::audio_doctor;
+
+    GeneratedSignalSpec spec;
+    spec.type = "band_limited_noise";
+    spec.preset = "offline_benchmark";
+    spec.sampleRate = sampleRate;
+    spec.channels = juce::jmin(2, channels);
+    spec.seconds = seconds;
+    spec.levelDb = -12.0;
+    spec.noiseBandLowHz = 40.0;
+    spec.noiseBandHighHz = 16000.0;
+
+    OfflineBenchmarkInput input;
+    input.dry = makeGeneratedSignalAsset(spec);
+
+    auto& buffer = input.dry.buffer;
+    const int n = buffer.getNumSamples();
+    const int period = static_cast<int>(4.0 * sampleRate);
+    const int gateOn = static_cast<int>(3.0 * sampleRate);
+    const float floorGain = static_cast<float>(juce::Decibels::decibelsToGain(-66.0));
+    juce::Random floorNoise(0xB3C4);
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (i % period < gateOn)
+            continue;
+
+        const float noise = (floorNoise.nextFloat() * 2.0f - 1.0f) * floorGain;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            buffer.setSample(ch, i, noise);
+    }
+
+    // Surround counts: decorrelated, slightly quieter copies (as in the processBlock programme)
+    if (channels > buffer.getNumChannels())
+    {
+        juce::AudioBuffer<float> wide(channels, n);
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            const int source = ch % buffer.getNumChannels();
+            const int offset = (ch * 37) % juce::jmax(1, n);
+            const float gain = 1.0f - 0.05f * static_cast<float>(ch);
+
+            wide.copyFrom(ch, 0, buffer, source, offset, n - offset, gain);
+            if (offset > 0)
+                wide.copyFrom(ch, n - offset, buffer, source, 0, offset, gain);
+        }
+        buffer = std::move(wide);
+    }
+
+    input.wet.name = input.dry.name + " -> benchmark filter";
+    input.wet.sourcePath = input.dry.sourcePath;
+    input.wet.sampleRate = sampleRate;
+    input.wet.buffer.setSize(buffer.getNumChannels(), n);
+
+    const int delay = juce::roundToInt(sampleRate * 0.002);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const float* src = buffer.getReadPointer(ch);
+        float* dst = input.wet.buffer.getWritePointer(ch);
+        float state = 0.0f;
+
+        for (int i = 0; i < n; ++i)
+        {
+            state += 0.35f * ((i >= delay ? src[i - delay] : 0.0f) - state);
+            dst[i] = state;
+        }
+    }
+
+    refreshAnalysis(std::vector<Asset*> { &input.dry, &input.wet });
+    applyTransferFunction(input.wet, computeTransferFunction(input.dry.buffer, input.wet.buffer, sampleRate));
+    return input;
+}
+
+//==============================================================================
+struct OfflineCaseResult
+{
+    bool supported = false;
+    juce::String skipReason;
+    double wallSeconds = 0.0;
+    juce::int64 peakMemoryBytes = 0;
+};
+
+/** Best-of-passes wall time and the largest peak over all passes. */
+inline OfflineCaseResult measureOfflineWorkload(const std::function<void()>& workload, int passes)
+{
+    OfflineCaseResult result;
+    result.supported = true;
+    result.wallSeconds = std::numeric_limits<double>::max();
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        releaseFreedMemory();
+        PeakMemorySampler memory;
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        workload();
+        const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+        result.peakMemoryBytes = juce::jmax(result.peakMemoryBytes, memory.finish());
+        result.wallSeconds = juce::jmin(result.wallSeconds, juce::Time::highResolutionTicksToSeconds(elapsed));
+    }
+
+    return result;
+}
+
+inline OfflineCaseResult skippedOfflineCase(const juce::String& reason)
+{
+    OfflineCaseResult result;
+    result.skipReason = reason;
+    return result;
+}
+
+/** One workload on one prepared input. Loading models and plugins is set-up, not timed. */
+inline OfflineCaseResult runOfflineCase(const juce::String& workload, const OfflineBenchmarkInput& input,
+                                        const OfflineBenchmarkOptions& options)
+{
+    using namespace goodmeter::audio_doctor;
+
+    const int passes = juce::jmax(1, options.passes);
+    const auto& dry = input.dry;
+    const double sr = dry.sampleRate;
+
+    if (workload == "refreshAnalysis")
+    {
+        Asset target;     // copied up front so the copy is neither timed nor counted
+        target.sampleRate = sr;
+        target.buffer = dry.buffer;
+        return measureOfflineWorkload([&] { refreshAnalysis(target); }, passes);
+    }
+
+    if (workload == "spectrogramImage")
+        return measureOfflineWorkload([&] { computeSpectrogramImage(dry.buffer, sr, SpectrogramPalette::Blue); }, passes);
+
+    if (workload == "transferGroupDelay")
+        return measureOfflineWorkload([&] { computeTransferGroupDelay(dry.buffer, input.wet.buffer, sr); }, passes);
+
+    if (workload == "roomTone")
+    {
+        return measureOfflineWorkload([&]
+        {
+            const auto analysis = RoomToneExtractor::analyse(dry.buffer, sr);
+            RoomToneExtractor::synthesizeRoomTone(analysis.spectralEnvelope, sr,
+                                                  static_cast<float>(dry.buffer.getNumSamples() / sr),
+                                                  dry.buffer.getNumChannels(), analysis.noiseFloorRms);
+        }, passes);
+    }
+
+    if (workload == "figures")
+    {
+        const auto figureDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                   .getNonexistentChildFile("GOODMETER-benchmark-figures", {}, false);
+        if (! figureDir.createDirectory())
+            return skippedOfflineCase("cannot create " + figureDir.getFullPathName());
+
+        std::vector<FigureData> figures;
+        for (int v = 0; v <= static_cast<int>(FigureView::dynamicsApparentDucking); ++v)
+        {
+            FigureData data;
+            data.dry = &dry;
+            data.wetA = &input.wet;
+            data.view = static_cast<FigureView>(v);
+            data.viewToken = "view_" + juce::String(v);
+            figures.push_back(data);
+        }
+
+        auto result = measureOfflineWorkload([&]
+        {
+            AnalysisTaskGraph graph;
+            for (size_t f = 0; f < figures.size(); ++f)
+                graph.addTask("figure " + juce::String((int) f), [&figures, &figureDir, f]
+                {
+                    AudioDoctorFigureRenderer::writePng(figureDir.getChildFile("figure_" + juce::String((int) f) + ".png"),
+                                                        figures[f], false);
+                });
+            graph.run();
+        }, passes);
+
+        figureDir.deleteRecursively();
+        return result;
+    }
+
+    if (workload == "deepFilter")
+    {
+        if (! options.deepFilterModels.getChildFile("enc.onnx").existsAsFile())
+            return skippedOfflineCase("no --deepfilter-models directory");
+
+        DeepFilterProcessor deepFilter;
+        if (! deepFilter.initialize(options.deepFilterModels))
+            return skippedOfflineCase("DeepFilterNet3 models failed to load");
+
+        return measureOfflineWorkload([&]
+        {
+            std::atomic<float> progress { 0.0f };
+            deepFilter.process(dry.buffer, sr, progress);
+        }, passes);
+    }
+
+    if (workload == "pluginRender")
+    {
+        if (! options.pluginFile.exists())
+            return skippedOfflineCase("no --plugin file");
+
+        PluginHost host;
+        juce::String error;
+        if (! host.loadPluginFromFile(options.pluginFile, error))
+            return skippedOfflineCase("plugin failed to load: " + error);
+
+        juce::String renderError;
+        auto result = measureOfflineWorkload([&]
+        {
+            const auto render = host.renderOffline(dry);
+            if (render.error.isNotEmpty())
+                renderError = render.error;
+        }, passes);
+
+        return renderError.isNotEmpty() ? skippedOfflineCase("render failed: " + renderError) : result;
+    }
+
+    return skippedOfflineCase("unknown workload");
+}
+
+//==============================================================================
+inline juce::String offlineCaseKey(const juce::var& entry)
+{
+    return entry["workload"].toString() + "/" + juce::String(static_cast<double>(entry["seconds"]), 1)
+         + "/" + juce::String(static_cast<int>(entry["channels"]));
+}
+
+/** Flag entries slower or hungrier than the baseline's by more than the tolerances. */
+inline int markOfflineRegressions(juce::Array<juce::var>& cases, const juce::var& baseline,
+                                  const OfflineBenchmarkOptions& options)
+{
+    constexpr double minTimeDelta = 0.010;
+    constexpr double minMemoryDelta = 1024.0 * 1024.0;
+
+    std::map<juce::String, juce::var> previous;
+    if (const auto* stored = baseline["cases"].getArray())
+        for (const auto& entry : *stored)
+            if (static_cast<bool>(entry["supported"]))
+                previous[offlineCaseKey(entry)] = entry;
+
+    int regressions = 0;
+    for (auto& entry : cases)
+    {
+        auto* object = entry.getDynamicObject();
+        const auto match = previous.find(offlineCaseKey(entry));
+        if (object == nullptr || ! static_cast<bool>(entry["supported"]) || match == previous.end())
+            continue;
+
+        const double time = entry["wallSeconds"], baseTime = match->second["wallSeconds"];
+        const double memory = entry["peakMemoryBytes"], baseMemory = match->second["peakMemoryBytes"];
+
+        juce::StringArray reasons;
+        if (time > baseTime * (1.0 + options.timeTolerance) && time - baseTime > minTimeDelta)
+            reasons.add("time");
+        if (memory > baseMemory * (1.0 + options.memoryTolerance) && memory - baseMemory > minMemoryDelta)
+            reasons.add("memory");
+
+        object->setProperty("baselineWallSeconds", baseTime);
+        object->setProperty("baselinePeakMemoryBytes", baseMemory);
+        object->setProperty("timeRatio", baseTime > 0.0 ? time / baseTime : 0.0);
+
+        if (! reasons.isEmpty())
+        {
+            object->setProperty("regression", reasons.joinIntoString(","));
+            ++regressions;
+        }
+    }
+
+    return regressions;
+}
+
+//==============================================================================
+/** Run every workload on every duration / channel count; returns the JSON
+ *  report and sets regressions to the number of flagged cases. */
+inline juce::String runOfflineBenchmark(const OfflineBenchmarkOptions& options, int& regressions)
+{
+    const double sampleRate = juce::jlimit(8000.0, 384000.0, options.sampleRate);
+    const auto& allWorkloads = offlineBenchmarkWorkloads();
+    const auto workloads = options.workloads.isEmpty() ? allWorkloads : options.workloads;
+
+    juce::Array<juce::var> cases;
+
+    for (const double rawSeconds : options.durations)
+    {
+        const double seconds = juce::jlimit(1.0, 120.0, rawSeconds);
+
+        for (const int rawChannels : options.channelCounts)
+        {
+            const int channels = juce::jlimit(1, 16, rawChannels);
+            const auto input = makeOfflineBenchmarkInput(seconds, channels, sampleRate);
+
+            for (const auto& workload : workloads)
+            {
+                const auto r = allWorkloads.contains(workload) ? runOfflineCase(workload, input, options)
+                                                               : skippedOfflineCase("unknown workload");
+
+                auto* entry = new juce::DynamicObject();
+                entry->setProperty("workload", workload);
+                entry->setProperty("seconds", seconds);
+                entry->setProperty("channels", channels);
+                entry->setProperty("sampleRate", sampleRate);
+                entry->setProperty("supported", r.supported);
+
+                if (r.supported)
+                {
+                    entry->setProperty("wallSeconds", r.wallSeconds);
+                    entry->setProperty("realtimeFactor", r.wallSeconds > 0.0 ? seconds / r.wallSeconds : 0.0);
+                    entry->setProperty("peakMemoryBytes", r.peakMemoryBytes);
+                }
+                else
+                {
+                    entry->setProperty("skipped", r.skipReason);
+                }
+
+                cases.add(juce::var(entry));
+            }
+        }
+    }
+
+    regressions = 0;
+    const bool compared = options.baselineFile.existsAsFile();
+    if (compared)
+        regressions = markOfflineRegressions(cases, juce::JSON::parse(options.baselineFile), options);
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("benchmark", "offline");
+    result->setProperty("programme", "band_limited_noise 40 Hz - 16 kHz, gated 3 s on / 1 s at -66 dBFS");
+    result->setProperty("passes", juce::jmax(1, options.passes));
+    result->setProperty("cpus", juce::SystemStats::getNumCpus());
+    result->setProperty("cases", cases);
+
+    if (compared)
+    {
+        result->setProperty("baseline", options.baselineFile.getFullPathName());
+        result->setProperty("timeTolerance", options.timeTolerance);
+        result->setProperty("memoryTolerance", options.memoryTolerance);
+        result->setProperty("regressions", regressions);
+    }
+
+    const auto json = juce::JSON::toString(juce::var(result));
+
+    if (options.writeBaselineFile != juce::File())
+        options.writeBaselineFile.replaceWithText(json);
+
+    return json;
+}
+
+} // namespace benchmark
+} // namespace goodmeter
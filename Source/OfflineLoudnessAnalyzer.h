@@ -0,0 +1,651 @@
+/*
+  ==============================================================================
+    OfflineLoudnessAnalyzer.h
+    GOODMETER - Parallel whole-file BS.1770 / EBU R128 analysis
+
+    One offline loudness path for every caller (Nono file analysis, batch
+    jobs), built on the same KWeightingBank and TruePeakFilter kernels as the
+    real-time LoudnessEngine, so offline and live numbers agree.
+
+    The file is cut into chunks on 100 ms sub-block boundaries and the chunks
+    are spread over a small worker pool. Every worker opens its own reader
+    (AudioFormatReader is not thread-safe) and:
+      - pre-rolls warmUpSeconds of audio before its chunk through the
+        K-weighting filters and true-peak interpolator, discarding the output,
+        so IIR/FIR state at the chunk start matches a sequential pass
+      - writes the channel-weighted mean-square of each of its sub-blocks
+        straight into a preallocated array (chunks own disjoint ranges)
+
+    After the join the sub-block powers are merged exactly as a single pass
+    would: momentary / short-term maxima from sliding sums, integrated
+    loudness from 400 ms gating blocks with 75% overlap and the -70 LUFS /
+    -10 LU gates, loudness range from 3 s blocks (EBU Tech 3342).
+
+    The K-weighting high-pass (38 Hz, Q 0.5) decays to below float precision
+    in well under a second, so a 1 s pre-roll makes the chunked result
+    indistinguishable from a sequential pass.
+
+    Stream runs the same per-chunk Pass once over blocks pushed as they are
+    decoded, so a caller with no file yet (video audio still being
+    extracted) gets the numbers as the last block arrives.
+
+    Thread safety model:
+      - analyse(): any non-audio thread; blocks until every worker is done
+      - shouldExit is polled by every worker between reads
+      - Stream: one thread at a time
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisResultCache.h"
+#include "AudioFileIngest.h"
+#include "LoudnessEngine.h"
+#include "TruePeakDetector.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+struct OfflineLoudnessResult
+{
+    static constexpr float kSilenceLufs = -100.0f;
+
+    bool valid = false;
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    juce::int64 samplesAnalysed = 0;
+
+    float truePeakDb = kSilenceLufs;          // dBTP, LFE excluded
+    float momentaryMaxLufs = kSilenceLufs;
+    float shortTermMaxLufs = kSilenceLufs;
+    float integratedLufs = kSilenceLufs;
+    float loudnessRange = 0.0f;
+    float centreIntegratedLufs = kSilenceLufs; // channel 2 alone, 6+ channel files only
+
+    /** Channel-weighted mean-square per 100 ms sub-block, in file order. */
+    std::vector<double> subBlockPowers;
+    std::vector<double> centreSubBlockPowers;
+};
+
+struct OfflineLoudnessOptions
+{
+    double maxSeconds = 0.0;       // 0 = whole file
+    double chunkSeconds = 30.0;    // work unit per worker
+    double warmUpSeconds = 1.0;    // pre-roll before each chunk
+    int maxThreads = 0;            // 0 = one per core
+};
+
+//==============================================================================
+class OfflineLoudnessAnalyzer
+{
+public:
+    using ReaderFactory = std::function<std::unique_ptr<juce::AudioFormatReader>()>;
+
+    using Options = OfflineLoudnessOptions;
+
+    //==========================================================================
+    /** Analyse whatever the factory opens. The factory is called once per
+     *  worker plus once up front, from several threads at once. */
+    static OfflineLoudnessResult analyse(const ReaderFactory& createReader,
+                                         const Options& options = {},
+                                         const std::function<bool()>& shouldExit = {})
+    {
+        OfflineLoudnessResult result;
+
+        auto probe = createReader();
+        if (probe == nullptr || probe->sampleRate <= 0.0 || probe->numChannels == 0)
+            return result;
+
+        const double sampleRate = probe->sampleRate;
+        const int numChannels = juce::jmin(static_cast<int>(probe->numChannels), kMaxChannels);
+        juce::int64 totalSamples = probe->lengthInSamples;
+        probe.reset();
+
+        if (options.maxSeconds > 0.0)
+            totalSamples = juce::jmin(totalSamples, static_cast<juce::int64>(sampleRate * options.maxSeconds));
+
+        const auto plan = makePlan(sampleRate, numChannels, totalSamples, options);
+
+        if (totalSamples <= 0)
+            return result;
+
+        result.numChannels = numChannels;
+        result.sampleRate = sampleRate;
+        result.samplesAnalysed = totalSamples;
+        result.subBlockPowers.assign(static_cast<size_t>(plan.numSubBlocks), 0.0);
+        if (plan.hasCentre)
+            result.centreSubBlockPowers.assign(static_cast<size_t>(plan.numSubBlocks), 0.0);
+
+        // Chunks cover every sample, including the trailing partial sub-block,
+        // so true peak sees the whole file
+        const int numChunks = static_cast<int>((totalSamples + chunkSamples(plan) - 1) / chunkSamples(plan));
+        const int cores = options.maxThreads > 0 ? options.maxThreads
+                                                 : static_cast<int>(juce::jmax(1u, std::thread::hardware_concurrency()));
+        const int numWorkers = juce::jlimit(1, numChunks, cores);
+
+        std::atomic<int> nextChunk { 0 };
+        std::atomic<bool> failed { false };
+        std::vector<float> workerPeaks(static_cast<size_t>(numWorkers), 0.0f);
+
+        const auto work = [&](int worker)
+        {
+            auto reader = createReader();
+            if (reader == nullptr)
+            {
+                failed.store(true);
+                return;
+            }
+
+            ChunkWorker chunkWorker(plan, *reader);
+
+            for (int chunk = nextChunk.fetch_add(1); chunk < numChunks; chunk = nextChunk.fetch_add(1))
+            {
+                if (failed.load(std::memory_order_relaxed) || (shouldExit && shouldExit()))
+                {
+                    failed.store(true);
+                    return;
+                }
+
+                if (! chunkWorker.run(chunk, result.subBlockPowers.data(),
+                                      plan.hasCentre ? result.centreSubBlockPowers.data() : nullptr, shouldExit))
+                {
+                    failed.store(true);
+                    return;
+                }
+            }
+
+            workerPeaks[(size_t) worker] = chunkWorker.getPeak();
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(static_cast<size_t>(numWorkers - 1));
+        for (int w = 1; w < numWorkers; ++w)
+            threads.emplace_back(work, w);
+
+        work(0);   // the calling thread is worker 0
+
+        for (auto& t : threads)
+            t.join();
+
+        if (failed.load())
+            return {};
+
+        float peak = 0.0f;
+        for (auto p : workerPeaks)
+            peak = juce::jmax(peak, p);
+
+        result.truePeakDb = juce::Decibels::gainToDecibels(peak, OfflineLoudnessResult::kSilenceLufs);
+        summarise(result);
+        result.valid = true;
+        return result;
+    }
+
+    /** Sequential measurement of audio pushed as it arrives (a decoder's
+     *  output, say), for when there is no file to hand to analyse() yet. */
+    class Stream;
+
+    /** Convenience for files: each worker gets its own reader, memory-mapped
+     *  for WAV/AIFF so all workers share the same page-cache pages. */
+    static OfflineLoudnessResult analyseFile(const juce::File& file,
+                                             const Options& options = {},
+                                             const std::function<bool()>& shouldExit = {})
+    {
+        return analyse(AudioFileIngest::makeReaderFactory(file), options, shouldExit);
+    }
+
+    /** analyseFile() through AnalysisResultCache: an unchanged file returns
+     *  its stored summary at once. Cached results carry the loudness figures
+     *  only; subBlockPowers is left empty. */
+    static OfflineLoudnessResult analyseFileCached(const juce::File& file,
+                                                   const std::function<bool()>& shouldExit = {})
+    {
+        auto& cache = AnalysisResultCache::getInstance();
+        const auto hash = cache.getContentHash(file);
+        juce::MemoryBlock payload;
+
+        OfflineLoudnessResult result;
+        if (cache.load(hash, "loudness", kCacheVersion, payload) && readSummary(payload, result))
+            return result;
+
+        result = analyseFile(file, {}, shouldExit);
+        if (result.valid)
+            cache.store(hash, "loudness", kCacheVersion, writeSummary(result));
+
+        return result;
+    }
+
+    /** BS.1770-4 weights by channel index for the usual L R C LFE Ls Rs ...
+     *  order: LFE (index 3 of 6+ channels) excluded, surrounds +1.5 dB. */
+    static std::vector<float> defaultChannelWeights(int numChannels)
+    {
+        std::vector<float> weights(static_cast<size_t>(juce::jmax(0, numChannels)), 1.0f);
+        if (numChannels >= 6)
+        {
+            weights[3] = 0.0f;
+            for (int ch = 4; ch < numChannels; ++ch)
+                weights[(size_t) ch] = 1.41253754f;
+        }
+        return weights;
+    }
+
+    //==========================================================================
+    /** Gated statistics from 100 ms sub-block powers (fills the LUFS fields). */
+    static void summarise(OfflineLoudnessResult& r)
+    {
+        const auto& blocks = r.subBlockPowers;
+
+        r.momentaryMaxLufs = maxWindowLufs(blocks, LoudnessEngine::kSubBlocksMomentary);
+        r.shortTermMaxLufs = maxWindowLufs(blocks, LoudnessEngine::kSubBlocksShortTerm);
+        r.integratedLufs = gatedLufs(windowPowers(blocks, LoudnessEngine::kSubBlocksMomentary), -10.0);
+        r.loudnessRange = loudnessRange(windowPowers(blocks, LoudnessEngine::kSubBlocksShortTerm));
+
+        if (! r.centreSubBlockPowers.empty())
+            r.centreIntegratedLufs = gatedLufs(windowPowers(r.centreSubBlockPowers, LoudnessEngine::kSubBlocksMomentary), -10.0);
+    }
+
+    //==========================================================================
+    /** Bump when the measurement changes, so cached summaries are not reused. */
+    static constexpr int kCacheVersion = 1;
+
+    static juce::MemoryBlock writeSummary(const OfflineLoudnessResult& r)
+    {
+        juce::MemoryOutputStream out;
+        out.writeInt(r.numChannels);
+        out.writeDouble(r.sampleRate);
+        out.writeInt64(r.samplesAnalysed);
+        for (auto v : { r.truePeakDb, r.momentaryMaxLufs, r.shortTermMaxLufs,
+                        r.integratedLufs, r.loudnessRange, r.centreIntegratedLufs })
+            out.writeFloat(v);
+        return out.getMemoryBlock();
+    }
+
+    static bool readSummary(const juce::MemoryBlock& payload, OfflineLoudnessResult& r)
+    {
+        if (payload.getSize() != 4 + 8 + 8 + 6 * 4)
+            return false;
+
+        juce::MemoryInputStream in(payload, false);
+        r.numChannels = in.readInt();
+        r.sampleRate = in.readDouble();
+        r.samplesAnalysed = in.readInt64();
+        for (auto* v : { &r.truePeakDb, &r.momentaryMaxLufs, &r.shortTermMaxLufs,
+                         &r.integratedLufs, &r.loudnessRange, &r.centreIntegratedLufs })
+            *v = in.readFloat();
+
+        r.valid = true;
+        return true;
+    }
+
+private:
+    static constexpr int kMaxChannels = 64;
+    static constexpr int kReadBlock = 65536;
+
+    //==========================================================================
+    struct Plan
+    {
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        int subBlockLength = 4800;
+        int numSubBlocks = 0;
+        int subBlocksPerChunk = 300;
+        int warmUpSamples = 48000;
+        juce::int64 totalSamples = 0;
+        bool hasCentre = false;
+        std::vector<float> weights;
+    };
+
+    static Plan makePlan(double sampleRate, int numChannels, juce::int64 totalSamples, const Options& options)
+    {
+        Plan plan;
+        plan.sampleRate = sampleRate;
+        plan.numChannels = numChannels;
+        plan.subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+        plan.numSubBlocks = static_cast<int>(juce::jmax(juce::int64 (0), totalSamples / plan.subBlockLength));
+        plan.totalSamples = totalSamples;
+        plan.subBlocksPerChunk = juce::jmax(1, juce::roundToInt(options.chunkSeconds * 10.0));
+        plan.warmUpSamples = static_cast<int>(juce::jmax(0.0, options.warmUpSeconds) * sampleRate);
+        plan.hasCentre = numChannels >= 6;
+        plan.weights = defaultChannelWeights(numChannels);
+        return plan;
+    }
+
+    static juce::int64 chunkSamples(const Plan& plan) noexcept
+    {
+        return static_cast<juce::int64>(plan.subBlocksPerChunk) * plan.subBlockLength;
+    }
+
+    //==========================================================================
+    /** K-weighting, true-peak and sub-block state for one sequential run of
+     *  samples: a chunk of the parallel analysis, or a whole Stream. */
+    class Pass
+    {
+    public:
+        explicit Pass(const Plan& planToUse)
+            : plan(planToUse),
+              banks(static_cast<size_t>((plan.numChannels + KWeightingBank::kMaxChannels - 1) / KWeightingBank::kMaxChannels)),
+              truePeak(static_cast<size_t>(plan.numChannels)),
+              energies(static_cast<size_t>(plan.numChannels), 0.0f),
+              scratch(static_cast<size_t>(plan.numChannels), 0.0f)
+        {
+            for (size_t b = 0; b < banks.size(); ++b)
+                banks[b].prepare(plan.sampleRate, juce::jmin(KWeightingBank::kMaxChannels,
+                                                             plan.numChannels - static_cast<int>(b) * KWeightingBank::kMaxChannels));
+        }
+
+        /** Back to silence at a sub-block boundary. */
+        void reset()
+        {
+            for (auto& bank : banks)
+                bank.reset();
+            for (auto& filter : truePeak)
+                filter.reset();
+
+            subBlockFill = 0;
+            std::fill(energies.begin(), energies.end(), 0.0f);
+        }
+
+        /** Pre-roll: settle the filters, keep nothing. */
+        void warmUp(const float* const* channels, int numSamples)
+        {
+            filterInto(channels, 0, numSamples, scratch.data());
+            for (int ch = 0; ch < plan.numChannels; ++ch)
+                truePeak[(size_t) ch].process(channels[ch], numSamples);
+        }
+
+        /** Measure numSamples, calling onSubBlock(power, centrePower) for
+         *  every sub-block completed. Returns the block's true peak. */
+        template <typename OnSubBlock>
+        float process(const float* const* channels, int numSamples, OnSubBlock&& onSubBlock)
+        {
+            float peak = 0.0f;
+            for (int ch = 0; ch < plan.numChannels; ++ch)
+                if (plan.weights[(size_t) ch] > 0.0f)
+                    peak = juce::jmax(peak, truePeak[(size_t) ch].process(channels[ch], numSamples));
+
+            // Split the read at sub-block boundaries
+            for (int offset = 0; offset < numSamples;)
+            {
+                const int run = juce::jmin(numSamples - offset, plan.subBlockLength - subBlockFill);
+                filterInto(channels, offset, run, energies.data());
+                offset += run;
+                subBlockFill += run;
+
+                if (subBlockFill == plan.subBlockLength)
+                {
+                    const double length = static_cast<double>(plan.subBlockLength);
+                    double power = 0.0;
+                    for (int ch = 0; ch < plan.numChannels; ++ch)
+                        power += plan.weights[(size_t) ch] * energies[(size_t) ch];
+
+                    onSubBlock(power / length, plan.hasCentre ? energies[2] / length : 0.0);
+
+                    subBlockFill = 0;
+                    std::fill(energies.begin(), energies.end(), 0.0f);
+                }
+            }
+
+            return peak;
+        }
+
+        /** End of the file: flush the interpolator so final overs are seen. */
+        float flushTruePeak()
+        {
+            const std::array<float, TruePeakFilter::kHistory> tail {};
+            float peak = 0.0f;
+            for (int ch = 0; ch < plan.numChannels; ++ch)
+                if (plan.weights[(size_t) ch] > 0.0f)
+                    peak = juce::jmax(peak, truePeak[(size_t) ch].process(tail.data(), static_cast<int>(tail.size())));
+            return peak;
+        }
+
+    private:
+        void filterInto(const float* const* channels, int offset, int numSamples, float* channelEnergies)
+        {
+            for (size_t b = 0; b < banks.size(); ++b)
+            {
+                const int first = static_cast<int>(b) * KWeightingBank::kMaxChannels;
+                banks[b].processAndAccumulate(channels + first, banks[b].getNumChannels(), offset, numSamples,
+                                              channelEnergies + first);
+            }
+        }
+
+        const Plan& plan;
+        std::vector<KWeightingBank> banks;
+        std::vector<TruePeakFilter> truePeak;
+        std::vector<float> energies, scratch;
+        int subBlockFill = 0;
+    };
+
+    //==========================================================================
+    /** One worker's reader, Pass and scratch, reused for every chunk it takes. */
+    class ChunkWorker
+    {
+    public:
+        ChunkWorker(const Plan& planToUse, juce::AudioFormatReader& readerToUse)
+            : plan(planToUse), reader(readerToUse),
+              buffer(plan.numChannels, kReadBlock),
+              pass(plan)
+        {
+        }
+
+        float getPeak() const noexcept   { return peak; }
+
+        bool run(int chunk, double* subBlockPowers, double* centrePowers, const std::function<bool()>& shouldExit)
+        {
+            const juce::int64 start = chunk * chunkSamples(plan);
+            const juce::int64 end = juce::jmin(plan.totalSamples, start + chunkSamples(plan));
+            const juce::int64 warmStart = juce::jmax(juce::int64 (0), start - plan.warmUpSamples);
+
+            pass.reset();
+
+            // Pre-roll: settle the filters, keep nothing
+            for (juce::int64 pos = warmStart; pos < start;)
+            {
+                const int n = static_cast<int>(juce::jmin(juce::int64 (kReadBlock), start - pos));
+                if (! read(pos, n))
+                    return false;
+
+                pass.warmUp(buffer.getArrayOfReadPointers(), n);
+                pos += n;
+            }
+
+            int subBlock = static_cast<int>(start / plan.subBlockLength);
+            const auto commit = [&](double power, double centrePower)
+            {
+                if (subBlock < plan.numSubBlocks)
+                {
+                    subBlockPowers[subBlock] = power;
+                    if (centrePowers != nullptr)
+                        centrePowers[subBlock] = centrePower;
+                }
+                ++subBlock;
+            };
+
+            for (juce::int64 pos = start; pos < end;)
+            {
+                if (shouldExit && shouldExit())
+                    return false;
+
+                const int n = static_cast<int>(juce::jmin(juce::int64 (kReadBlock), end - pos));
+                if (! read(pos, n))
+                    return false;
+
+                peak = juce::jmax(peak, pass.process(buffer.getArrayOfReadPointers(), n, commit));
+                pos += n;
+            }
+
+            // Last chunk: flush the interpolator so end-of-file overs are seen
+            if (end == plan.totalSamples)
+                peak = juce::jmax(peak, pass.flushTruePeak());
+
+            return true;
+        }
+
+    private:
+        bool read(juce::int64 pos, int n)
+        {
+            buffer.clear(0, n);
+            return reader.read(&buffer, 0, n, pos, true, true);
+        }
+
+        const Plan& plan;
+        juce::AudioFormatReader& reader;
+        juce::AudioBuffer<float> buffer;
+        Pass pass;
+        float peak = 0.0f;
+    };
+
+    //==========================================================================
+    static float toLufs(double power) noexcept
+    {
+        return power > 0.0 ? static_cast<float>(-0.691 + 10.0 * std::log10(power))
+                           : OfflineLoudnessResult::kSilenceLufs;
+    }
+
+    /** Mean power of every window of `length` consecutive sub-blocks (step 1). */
+    static std::vector<double> windowPowers(const std::vector<double>& blocks, int length)
+    {
+        std::vector<double> windows;
+        const int count = static_cast<int>(blocks.size()) - length + 1;
+        if (count <= 0)
+            return windows;
+
+        windows.reserve(static_cast<size_t>(count));
+        double sum = 0.0;
+        for (int i = 0; i < length; ++i)
+            sum += blocks[(size_t) i];
+
+        for (int i = 0; i < count; ++i)
+        {
+            windows.push_back(sum / length);
+            if (i + length < static_cast<int>(blocks.size()))
+                sum += blocks[(size_t) (i + length)] - blocks[(size_t) i];
+        }
+
+        return windows;
+    }
+
+    static float maxWindowLufs(const std::vector<double>& blocks, int length)
+    {
+        const auto windows = windowPowers(blocks, length);
+        return windows.empty() ? OfflineLoudnessResult::kSilenceLufs
+                               : toLufs(*std::max_element(windows.begin(), windows.end()));
+    }
+
+    /** -70 LUFS absolute gate, then relativeLU below the absolute-gated mean. */
+    static float gatedLufs(const std::vector<double>& blocks, double relativeLU)
+    {
+        double sum = 0.0;
+        int count = 0;
+        for (auto p : blocks)
+            if (toLufs(p) > -70.0f) { sum += p; ++count; }
+
+        if (count == 0)
+            return OfflineLoudnessResult::kSilenceLufs;
+
+        const double gate = toLufs(sum / count) + relativeLU;
+        double gatedSum = 0.0;
+        int gatedCount = 0;
+        for (auto p : blocks)
+        {
+            const float lufs = toLufs(p);
+            if (lufs > -70.0f && lufs > gate) { gatedSum += p; ++gatedCount; }
+        }
+
+        return gatedCount > 0 ? toLufs(gatedSum / gatedCount) : OfflineLoudnessResult::kSilenceLufs;
+    }
+
+    /** EBU Tech 3342: 10th..95th percentile of -20 LU gated 3 s blocks. */
+    static float loudnessRange(const std::vector<double>& shortTermBlocks)
+    {
+        double sum = 0.0;
+        int count = 0;
+        for (auto p : shortTermBlocks)
+            if (toLufs(p) > -70.0f) { sum += p; ++count; }
+
+        if (count == 0)
+            return 0.0f;
+
+        const double gate = toLufs(sum / count) - 20.0;
+        std::vector<float> gated;
+        for (auto p : shortTermBlocks)
+        {
+            const float lufs = toLufs(p);
+            if (lufs > -70.0f && lufs > gate)
+                gated.push_back(lufs);
+        }
+
+        if (gated.size() < 2)
+            return 0.0f;
+
+        std::sort(gated.begin(), gated.end());
+        const auto at = [&gated](double fraction)
+        {
+            return gated[juce::jmin(gated.size() - 1, static_cast<size_t>(fraction * static_cast<double>(gated.size())))];
+        };
+        return juce::jmax(0.0f, at(0.95) - at(0.10));
+    }
+};
+
+//==============================================================================
+/** One sequential Pass over pushed blocks: what a single-chunk analyse()
+ *  of the same samples gives, to float rounding of where the blocks split.
+ *  Push from one thread, then finish(). */
+class OfflineLoudnessAnalyzer::Stream
+{
+public:
+    Stream(double sampleRate, int numChannelsToUse)
+        : plan(makePlan(sampleRate, juce::jlimit(1, kMaxChannels, numChannelsToUse), 0, {})),
+          pass(plan)
+    {
+        pass.reset();
+    }
+
+    int getNumChannels() const noexcept     { return plan.numChannels; }
+
+    /** Measure the next numSamples of getNumChannels() channels. */
+    void push(const float* const* channels, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        peak = juce::jmax(peak, pass.process(channels, numSamples, [this](double power, double centrePower)
+        {
+            result.subBlockPowers.push_back(power);
+            if (plan.hasCentre)
+                result.centreSubBlockPowers.push_back(centrePower);
+        }));
+        samplesPushed += numSamples;
+    }
+
+    /** Summary of everything pushed; invalid if nothing was. */
+    OfflineLoudnessResult finish()
+    {
+        if (samplesPushed <= 0)
+            return {};
+
+        peak = juce::jmax(peak, pass.flushTruePeak());
+
+        result.numChannels = plan.numChannels;
+        result.sampleRate = plan.sampleRate;
+        result.samplesAnalysed = samplesPushed;
+        result.truePeakDb = juce::Decibels::gainToDecibels(peak, OfflineLoudnessResult::kSilenceLufs);
+        summarise(result);
+        result.valid = true;
+        return result;
+    }
+
+private:
+    const Plan plan;
+    Pass pass;
+    OfflineLoudnessResult result;
+    juce::int64 samplesPushed = 0;
+    float peak = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE(Stream)
+};
@@ -0,0 +1,458 @@
+/*
+  ==============================================================================
+    PeakPyramid.h
+    GOODMETER - Multi-resolution min/max/RMS overview of an audio file
+
+    Level 0 holds one bucket (min, max, RMS as 16-bit fractions of full
+    scale) per kBaseSamples samples of each channel; every level above merges
+    pairs of buckets from the one below. A view at any zoom reads the level
+    whose buckets are no wider than one pixel, so each column touches at most
+    three buckets: drawing an hour-long file costs the same as a ten-second
+    one, O(pixels) at every zoom and scroll position.
+
+    Building:
+      - Level 0 is split into chunks on the shared AnalysisThreadPool, from
+        audio already in memory or by streaming the file (one reader per
+        chunk; WAV/AIFF readers share the mapped pages)
+      - Upper levels are derived per channel from level 0 once it is done
+
+    Persistence: level 0 is stored in the AnalysisResultCache under the
+    file's content hash ("peaks", kCacheVersion); the upper levels are
+    rebuilt on load in a few milliseconds. Reopening a file only reads the
+    cache entry, never the audio.
+
+    Thread safety model:
+      - build / load on any non-audio thread; once built, a pyramid is
+        read-only and may be queried from any number of threads.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisResultCache.h"
+#include "AnalysisTaskGraph.h"
+#include "AudioFileIngest.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+class PeakPyramid
+{
+public:
+    static constexpr int kBaseSamples = 256;
+    static constexpr int kCacheVersion = 1;
+
+    /** One column (or bucket) of one channel, in linear full-scale units. */
+    struct Range
+    {
+        float min = 0.0f, max = 0.0f, rms = 0.0f;
+    };
+
+    PeakPyramid() = default;
+
+    bool isEmpty() const noexcept                 { return levels.empty(); }
+    int getNumChannels() const noexcept           { return numChannels; }
+    juce::int64 getNumSamples() const noexcept    { return numSamples; }
+    double getSampleRate() const noexcept         { return sampleRate; }
+    double getLengthSeconds() const noexcept      { return sampleRate > 0.0 ? (double) numSamples / sampleRate : 0.0; }
+
+    void clear()
+    {
+        levels.clear();
+        numChannels = 0;
+        numSamples = 0;
+        sampleRate = 0.0;
+    }
+
+    //==========================================================================
+    /** Build from audio already in memory. */
+    void build(const juce::AudioBuffer<float>& audio, double rate)
+    {
+        buildLevels(audio.getNumChannels(), audio.getNumSamples(), rate,
+                    [&audio] (juce::int64 start, int count, std::vector<std::vector<Bucket>>& base, size_t firstBucket)
+                    {
+                        for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+                            scanBlock(audio.getReadPointer(ch) + start, count, base[(size_t) ch].data() + firstBucket);
+                        return true;
+                    });
+    }
+
+    /** Build by streaming the file; false if it can't be read. */
+    bool build(const juce::File& file)
+    {
+        auto probe = AudioFileIngest::openReader(file);
+        if (probe == nullptr || probe->numChannels == 0 || probe->lengthInSamples <= 0)
+            return false;
+
+        const int channels = static_cast<int>(probe->numChannels);
+        const auto factory = AudioFileIngest::makeReaderFactory(file);
+
+        return buildLevels(channels, probe->lengthInSamples, probe->sampleRate,
+                           [&factory, channels] (juce::int64 start, int count, std::vector<std::vector<Bucket>>& base, size_t firstBucket)
+                           {
+                               auto reader = factory();
+                               if (reader == nullptr)
+                                   return false;
+
+                               juce::AudioBuffer<float> block(channels, kReadBlock);
+                               for (int done = 0; done < count;)
+                               {
+                                   const int n = juce::jmin(kReadBlock, count - done);
+                                   if (! reader->read(&block, 0, n, start + done, true, true))
+                                       return false;
+
+                                   const auto bucket = firstBucket + (size_t) (done / kBaseSamples);
+                                   for (int ch = 0; ch < channels; ++ch)
+                                       scanBlock(block.getReadPointer(ch), n, base[(size_t) ch].data() + bucket);
+                                   done += n;
+                               }
+                               return true;
+                           });
+    }
+
+    //==========================================================================
+    /** The stored pyramid for this file, or a fresh one (then stored). */
+    bool loadOrBuild(const juce::File& file)
+    {
+        auto& cache = AnalysisResultCache::getInstance();
+        const auto hash = cache.getContentHash(file);
+
+        juce::MemoryBlock payload;
+        if (hash.isNotEmpty() && cache.load(hash, "peaks", kCacheVersion, payload) && restore(payload))
+            return true;
+
+        if (! build(file))
+            return false;
+
+        if (hash.isNotEmpty())
+            cache.store(hash, "peaks", kCacheVersion, serialise());
+        return true;
+    }
+
+    /** Cache lookup without hashing: only succeeds for files the cache has
+        already identified (size and modification time unchanged). */
+    bool loadIfKnown(const juce::File& file)
+    {
+        auto& cache = AnalysisResultCache::getInstance();
+        const auto hash = cache.getKnownContentHash(file);
+
+        juce::MemoryBlock payload;
+        return hash.isNotEmpty() && cache.load(hash, "peaks", kCacheVersion, payload) && restore(payload);
+    }
+
+    /** Hash the file and store this pyramid for it (slow: call off the message thread). */
+    void storeFor(const juce::File& file) const
+    {
+        auto& cache = AnalysisResultCache::getInstance();
+        const auto hash = cache.getContentHash(file);
+        if (hash.isNotEmpty() && ! isEmpty())
+            cache.store(hash, "peaks", kCacheVersion, serialise());
+    }
+
+    //==========================================================================
+    /** Column c of numColumns covers samples [start + c × spp, start + (c + 1) × spp). */
+    void getColumns(int channel, double startSample, double samplesPerColumn, Range* out, int numColumns) const
+    {
+        if (isEmpty() || channel < 0 || channel >= numChannels || samplesPerColumn <= 0.0)
+        {
+            std::fill(out, out + juce::jmax(0, numColumns), Range());
+            return;
+        }
+
+        // Coarsest level whose buckets still fit inside one column
+        size_t level = 0;
+        while (level + 1 < levels.size() && static_cast<double>(bucketSize(level + 1)) <= samplesPerColumn)
+            ++level;
+
+        const auto& buckets = levels[level][(size_t) channel];
+        const auto count = static_cast<juce::int64>(buckets.size());
+        const double size = static_cast<double>(bucketSize(level));
+
+        for (int c = 0; c < numColumns; ++c)
+        {
+            const double s0 = startSample + c * samplesPerColumn;
+            const double s1 = s0 + samplesPerColumn;
+            auto first = static_cast<juce::int64>(std::floor(s0 / size));
+            auto last = juce::jmax(first + 1, static_cast<juce::int64>(std::ceil(s1 / size)));
+            first = juce::jlimit(juce::int64 (0), count, first);
+            last = juce::jlimit(juce::int64 (0), count, last);
+
+            if (first >= last || s1 <= 0.0 || s0 >= (double) numSamples)
+            {
+                out[c] = {};
+                continue;
+            }
+
+            int lo = 32767, hi = -32767;
+            double squares = 0.0;
+            for (auto i = first; i < last; ++i)
+            {
+                const auto& b = buckets[(size_t) i];
+                lo = juce::jmin(lo, (int) b.min);
+                hi = juce::jmax(hi, (int) b.max);
+                squares += (double) b.rms * (double) b.rms;
+            }
+
+            out[c].min = (float) lo * kToFloat;
+            out[c].max = (float) hi * kToFloat;
+            out[c].rms = static_cast<float>(std::sqrt(squares / (double) (last - first))) * kToFloat;
+        }
+    }
+
+    /** Min/max bars of one channel over [startSeconds, endSeconds), in the
+        current colour (the same look as AudioThumbnail::drawChannel). */
+    void drawChannel(juce::Graphics& g, juce::Rectangle<int> area, double startSeconds, double endSeconds,
+                     int channel, float verticalZoom) const
+    {
+        drawBars(g, area, startSeconds, endSeconds, channel, verticalZoom, false);
+    }
+
+    /** RMS core of one channel, drawn the same way; usually over drawChannel in a stronger colour. */
+    void drawChannelRms(juce::Graphics& g, juce::Rectangle<int> area, double startSeconds, double endSeconds,
+                        int channel, float verticalZoom) const
+    {
+        drawBars(g, area, startSeconds, endSeconds, channel, verticalZoom, true);
+    }
+
+    /** Every channel in its own horizontal strip of area. */
+    void drawChannels(juce::Graphics& g, juce::Rectangle<int> area, double startSeconds, double endSeconds,
+                      float verticalZoom) const
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const int y0 = area.getY() + area.getHeight() * ch / numChannels;
+            const int y1 = area.getY() + area.getHeight() * (ch + 1) / numChannels;
+            drawChannel(g, { area.getX(), y0, area.getWidth(), y1 - y0 }, startSeconds, endSeconds, ch, verticalZoom);
+        }
+    }
+
+    //==========================================================================
+    juce::MemoryBlock serialise() const
+    {
+        juce::MemoryOutputStream out;
+        out.writeInt(kPayloadMagic);
+        out.writeInt(numChannels);
+        out.writeDouble(sampleRate);
+        out.writeInt64(numSamples);
+
+        const auto count = levels.empty() ? size_t (0) : levels[0][0].size();
+        out.writeInt64(static_cast<juce::int64>(count));
+        for (int ch = 0; ch < numChannels && count > 0; ++ch)
+            writeBuckets(out, levels[0][(size_t) ch]);
+
+        return out.getMemoryBlock();
+    }
+
+    bool restore(const juce::MemoryBlock& payload)
+    {
+        juce::MemoryInputStream in(payload, false);
+        if (in.readInt() != kPayloadMagic)
+            return false;
+
+        const int channels = in.readInt();
+        const double rate = in.readDouble();
+        const auto length = in.readInt64();
+        const auto count = in.readInt64();
+
+        if (channels <= 0 || channels > 64 || rate <= 0.0 || length <= 0
+            || count != (length + kBaseSamples - 1) / kBaseSamples
+            || in.getNumBytesRemaining() != count * channels * (juce::int64) sizeof(Bucket))
+            return false;
+
+        std::vector<std::vector<Bucket>> base((size_t) channels, std::vector<Bucket>((size_t) count));
+        for (auto& channel : base)
+            readBuckets(in, channel);
+
+        numChannels = channels;
+        sampleRate = rate;
+        numSamples = length;
+        levels.clear();
+        levels.push_back(std::move(base));
+        buildUpperLevels(nullptr);
+        return true;
+    }
+
+private:
+    struct Bucket
+    {
+        juce::int16 min = 0, max = 0, rms = 0;
+    };
+
+    static constexpr int kPayloadMagic = 0x4b504d47;     // "GMPK"
+    static constexpr int kChunkBuckets = 4096;           // 1 M samples per build task
+    static constexpr int kReadBlock = kBaseSamples * 64;
+    static constexpr float kToFloat = 1.0f / 32767.0f;
+
+    static juce::int64 bucketSize(size_t level) noexcept   { return juce::int64 (kBaseSamples) << level; }
+
+    static juce::int16 quantise(float v) noexcept
+    {
+        return static_cast<juce::int16>(juce::jlimit(-32767, 32767, juce::roundToInt(v * 32767.0f)));
+    }
+
+    /** Level-0 buckets for n samples starting on a bucket boundary. */
+    static void scanBlock(const float* samples, int n, Bucket* out) noexcept
+    {
+        for (int start = 0; start < n; start += kBaseSamples, ++out)
+        {
+            const int count = juce::jmin(kBaseSamples, n - start);
+            const auto range = juce::FloatVectorOperations::findMinAndMax(samples + start, count);
+
+            float squares = 0.0f;
+            for (int i = 0; i < count; ++i)
+                squares += samples[start + i] * samples[start + i];
+
+            out->min = quantise(range.getStart());
+            out->max = quantise(range.getEnd());
+            out->rms = quantise(std::sqrt(squares / (float) count));
+        }
+    }
+
+    //==========================================================================
+    using ChunkScanner = std::function<bool(juce::int64 start, int count,
+                                            std::vector<std::vector<Bucket>>& base, size_t firstBucket)>;
+
+    /** Level 0 in parallel chunks, then the upper levels per channel. */
+    bool buildLevels(int channels, juce::int64 length, double rate, ChunkScanner scanChunk)
+    {
+        clear();
+        if (channels <= 0 || length <= 0)
+            return false;
+
+        const auto count = static_cast<size_t>((length + kBaseSamples - 1) / kBaseSamples);
+        std::vector<std::vector<Bucket>> base((size_t) channels, std::vector<Bucket>(count));
+
+        const juce::int64 chunkSamples = juce::int64 (kChunkBuckets) * kBaseSamples;
+        const auto numChunks = static_cast<int>((length + chunkSamples - 1) / chunkSamples);
+        std::vector<char> ok((size_t) numChunks, 0);
+
+        AnalysisTaskGraph graph;
+        for (int chunk = 0; chunk < numChunks; ++chunk)
+        {
+            graph.addTask("peaks " + juce::String(chunk), [&, chunk]
+            {
+                const auto start = chunk * chunkSamples;
+                const auto n = static_cast<int>(juce::jmin(chunkSamples, length - start));
+                ok[(size_t) chunk] = scanChunk(start, n, base, (size_t) (start / kBaseSamples)) ? 1 : 0;
+            });
+        }
+        graph.run();
+
+        if (std::find(ok.begin(), ok.end(), 0) != ok.end())
+            return false;
+
+        numChannels = channels;
+        numSamples = length;
+        sampleRate = rate;
+        levels.push_back(std::move(base));
+
+        AnalysisTaskGraph upper;
+        buildUpperLevels(&upper);
+        upper.run();
+        return true;
+    }
+
+    /** Pairwise merges up to a single bucket; per-channel tasks when a graph is given. */
+    void buildUpperLevels(AnalysisTaskGraph* graph)
+    {
+        size_t numLevels = 1;
+        for (auto n = levels[0][0].size(); n > 1; n = (n + 1) / 2)
+            ++numLevels;
+
+        levels.resize(numLevels, std::vector<std::vector<Bucket>>((size_t) numChannels));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto work = [this, ch]
+            {
+                for (size_t level = 1; level < levels.size(); ++level)
+                {
+                    const auto& below = levels[level - 1][(size_t) ch];
+                    auto& merged = levels[level][(size_t) ch];
+                    merged.resize((below.size() + 1) / 2);
+
+                    for (size_t i = 0; i < merged.size(); ++i)
+                    {
+                        const auto& a = below[2 * i];
+                        const auto& b = 2 * i + 1 < below.size() ? below[2 * i + 1] : a;
+                        merged[i].min = juce::jmin(a.min, b.min);
+                        merged[i].max = juce::jmax(a.max, b.max);
+                        merged[i].rms = static_cast<juce::int16>(std::sqrt(0.5 * ((double) a.rms * a.rms + (double) b.rms * b.rms)));
+                    }
+                }
+            };
+
+            if (graph != nullptr)
+                graph->addTask("peak levels " + juce::String(ch), work);
+            else
+                work();
+        }
+    }
+
+    //==========================================================================
+    void drawBars(juce::Graphics& g, juce::Rectangle<int> area, double startSeconds, double endSeconds,
+                  int channel, float verticalZoom, bool rmsOnly) const
+    {
+        if (isEmpty() || area.isEmpty() || endSeconds <= startSeconds)
+            return;
+
+        const int width = area.getWidth();
+        columns.resize((size_t) width);
+        const double samplesPerColumn = (endSeconds - startSeconds) * sampleRate / width;
+        getColumns(channel, startSeconds * sampleRate, samplesPerColumn, columns.data(), width);
+
+        const float midY = (float) area.getCentreY();
+        const float halfH = (float) area.getHeight() * 0.5f * verticalZoom;
+        juce::RectangleList<float> bars;
+        bars.ensureStorageAllocated(width);
+
+        for (int x = 0; x < width; ++x)
+        {
+            const auto& column = columns[(size_t) x];
+            const float top = rmsOnly ? column.rms : column.max;
+            const float bottom = rmsOnly ? -column.rms : column.min;
+            const float y0 = midY - juce::jlimit(-1.0f, 1.0f, top) * halfH;
+            const float y1 = midY - juce::jlimit(-1.0f, 1.0f, bottom) * halfH;
+            bars.addWithoutMerging({ (float) (area.getX() + x), y0, 1.0f, juce::jmax(0.5f, y1 - y0) });
+        }
+
+        g.fillRectList(bars);
+    }
+
+    static void writeBuckets(juce::OutputStream& out, const std::vector<Bucket>& buckets)
+    {
+        // Little-endian int16 triples
+        std::vector<juce::int16> raw(buckets.size() * 3);
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            raw[3 * i]     = static_cast<juce::int16>(juce::ByteOrder::swapIfBigEndian((juce::uint16) buckets[i].min));
+            raw[3 * i + 1] = static_cast<juce::int16>(juce::ByteOrder::swapIfBigEndian((juce::uint16) buckets[i].max));
+            raw[3 * i + 2] = static_cast<juce::int16>(juce::ByteOrder::swapIfBigEndian((juce::uint16) buckets[i].rms));
+        }
+        out.write(raw.data(), raw.size() * sizeof(juce::int16));
+    }
+
+    static void readBuckets(juce::InputStream& in, std::vector<Bucket>& buckets)
+    {
+        std::vector<juce::int16> raw(buckets.size() * 3);
+        in.read(raw.data(), static_cast<int>(raw.size() * sizeof(juce::int16)));
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            buckets[i].min = static_cast<juce::int16>(juce::ByteOrder::swapIfBigEndian((juce::uint16) raw[3 * i]));
+            buckets[i].max = static_cast<juce::int16>(juce::ByteOrder::swapIfBigEndian((juce::uint16) raw[3 * i + 1]));
+            buckets[i].rms = static_cast<juce::int16>(juce::ByteOrder::swapIfBigEndian((juce::uint16) raw[3 * i + 2]));
+        }
+    }
+
+    //==========================================================================
+    int numChannels = 0;
+    juce::int64 numSamples = 0;
+    double sampleRate = 0.0;
+    std::vector<std::vector<std::vector<Bucket>>> levels;   // [level][channel][bucket]
+
+    mutable std::vector<Range> columns;                     // drawing scratch (message thread)
+
+    JUCE_DECLARE_NON_COPYABLE(PeakPyramid)
+};
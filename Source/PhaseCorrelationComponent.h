@@ -16,22 +16,16 @@
 
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
+#include "FrameScheduler.h"
 
 //==============================================================================
-class PhaseCorrelationComponent : public juce::Component,
-                                  public juce::Timer
+class PhaseCorrelationComponent : public juce::Component
 {
 public:
     //==========================================================================
     PhaseCorrelationComponent()
     {
         setSize(100, 180);
-        startTimerHz(60);  // 60Hz visual refresh
-    }
-
-    ~PhaseCorrelationComponent() override
-    {
-        stopTimer();
     }
 
     //==========================================================================
@@ -73,13 +67,13 @@ public:
 
         if (GoodMeterLookAndFeel::preferDirectChartText())
         {
-            repaint();
+            FrameScheduler::getInstance().repaint(*this);
             return;
         }
 
         // Pre-render value text to offscreen cache
         auto bounds = getLocalBounds();
-        if (!bounds.isEmpty())
+        if (FrameScheduler::isOnScreen(*this))
         {
             const int labelH = juce::jlimit(18, 35, static_cast<int>(bounds.getHeight() * 0.15f));
             const float padX = juce::jlimit(10.0f, 40.0f, bounds.getWidth() * 0.08f);
@@ -110,7 +104,7 @@ public:
             }
         }
 
-        repaint();
+        FrameScheduler::getInstance().repaint(*this);
     }
 
 private:
@@ -131,9 +125,6 @@ private:
     float lastSideLabelsScale = 0.0f;
     float lastValueScale = 0.0f;
 
-    //==========================================================================
-    void timerCallback() override {}
-
     juce::Colour marathonPanelFill() const
     {
         return juce::Colour(0xFF0A0D13);
@@ -3,7 +3,7 @@
     PluginEditor.cpp
     GOODMETER - Main plugin editor implementation
 
-    60Hz Timer-driven UI with vertical meter layout
+    60Hz display-synced UI (FrameScheduler) with vertical meter layout
   ==============================================================================
 */
 
@@ -12,11 +12,14 @@
 
 //==============================================================================
 GOODMETERAudioProcessorEditor::GOODMETERAudioProcessorEditor(GOODMETERAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), FrameScheduler::Client(this), audioProcessor(p)
 {
     // Set custom LookAndFeel
     setLookAndFeel(&customLookAndFeel);
 
+    // Session timeline from the first time the meters were opened on
+    audioProcessor.setTimelineLoggingEnabled(true);
+
     // Create viewport and content container
     viewport = std::make_unique<juce::Viewport>();
     contentComponent = std::make_unique<juce::Component>();
@@ -199,13 +202,25 @@ GOODMETERAudioProcessorEditor::GOODMETERAudioProcessorEditor(GOODMETERAudioProce
     // Register mouse listener on contentComponent to receive drag events from cards
     contentComponent->addMouseListener(this, true);
 
-    // Start 60Hz timer for UI updates
-    startTimerHz(60);
+    // Receive the diagnostics shortcut
+    setWantsKeyboardFocus(true);
+
+    // 60Hz UI updates from the shared frame clock
+    startFrames();
+
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+    openGLContext.setOpenGLVersionRequired(juce::OpenGLContext::openGL3_2);   // float textures
+    openGLContext.attachTo(*this);
+   #endif
 }
 
 GOODMETERAudioProcessorEditor::~GOODMETERAudioProcessorEditor()
 {
-    stopTimer();
+    stopFrames();
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+    openGLContext.detach();   // frees the spectrogram's textures while the meters still exist
+   #endif
+    telemetryPanel.reset();
     contentComponent->removeMouseListener(this);
     setLookAndFeel(nullptr);
 }
@@ -222,6 +237,9 @@ void GOODMETERAudioProcessorEditor::resized()
     auto bounds = getLocalBounds();
     viewport->setBounds(bounds);
 
+    if (telemetryPanel != nullptr)
+        telemetryPanel->setBounds(bounds.reduced(8).removeFromTop(300));
+
     // 【防跳顶】缓存当前滚动位置
     auto prevScrollPos = viewport->getViewPosition();
 
@@ -376,7 +394,7 @@ void GOODMETERAudioProcessorEditor::resized()
 }
 
 //==============================================================================
-void GOODMETERAudioProcessorEditor::timerCallback()
+void GOODMETERAudioProcessorEditor::frameTick()
 {
     // 60Hz → 30Hz smart throttle during mouse drag (host window move etc.)
     // But NOT during jiggle mode — jiggle wobble + drag-swap needs full 60Hz
@@ -386,44 +404,28 @@ void GOODMETERAudioProcessorEditor::timerCallback()
         if (++dragThrottleCounter % 2 != 0) return;
     }
 
-    // Read atomic values from processor (thread-safe)
-    float peakL = audioProcessor.peakLevelL.load(std::memory_order_relaxed);
-    float peakR = audioProcessor.peakLevelR.load(std::memory_order_relaxed);
-    float rmsL = audioProcessor.rmsLevelL.load(std::memory_order_relaxed);
-    float rmsR = audioProcessor.rmsLevelR.load(std::memory_order_relaxed);
-    float momentary = audioProcessor.lufsLevel.load(std::memory_order_relaxed);
-    float shortTerm = audioProcessor.lufsShortTerm.load(std::memory_order_relaxed);
-    float integrated = audioProcessor.lufsIntegrated.load(std::memory_order_relaxed);
-    float phase = audioProcessor.phaseCorrelation.load(std::memory_order_relaxed);
-
-    // Push Short-Term LUFS to LRA history (~60Hz = every ~16ms)
-    // We want ~100ms intervals, so push every 6th frame
-    static int lraFrameCounter = 0;
-    if (++lraFrameCounter >= 6)
-    {
-        audioProcessor.pushShortTermLUFSForLRA(shortTerm);
-        audioProcessor.calculateLRARealtime();
-        lraFrameCounter = 0;
-    }
-
-    float luRangeVal = audioProcessor.luRange.load(std::memory_order_relaxed);
+    // One coherent snapshot per frame: every meter shows the same audio block
+    const auto& snapshot = audioProcessor.getMeterSnapshot();
 
     // Update Levels Meter
     if (levelsMeter != nullptr)
     {
-        levelsMeter->updateMetrics(peakL, peakR, momentary, shortTerm, integrated, luRangeVal);
+        levelsMeter->updateChannelLoudness(snapshot.channelLufs.data(), snapshot.numLoudnessChannels);
+        levelsMeter->updateMetrics(snapshot.truePeakL, snapshot.truePeakR,
+                                   snapshot.lufsMomentary, snapshot.lufsShortTerm,
+                                   snapshot.lufsIntegrated, snapshot.luRange);
     }
 
     // Update VU Meter
     if (vuMeter != nullptr)
     {
-        vuMeter->updateVU(rmsL, rmsR);
+        vuMeter->updateVU(snapshot.rmsL, snapshot.rmsR);
     }
 
     // Update Phase Correlation Meter
     if (phaseMeter != nullptr)
     {
-        phaseMeter->updateCorrelation(phase);
+        phaseMeter->updateCorrelation(snapshot.phaseCorrelation);
     }
 
     // Jiggle animation: apply micro-rotation transforms to all cards
@@ -701,3 +703,24 @@ void GOODMETERAudioProcessorEditor::mouseDoubleClick(const juce::MouseEvent&)
     if (juce::Time::getMillisecondCounter() - jiggleEnteredTime < 500) return;
     exitJiggleMode();
 }
+
+//==============================================================================
+bool GOODMETERAudioProcessorEditor::keyPressed(const juce::KeyPress& key)
+{
+    const auto diagnosticsKey = juce::KeyPress('d', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0);
+    if (key != diagnosticsKey)   // case-insensitive key code, exact modifiers
+        return false;
+
+    if (telemetryPanel != nullptr)
+    {
+        telemetryPanel.reset();
+    }
+    else
+    {
+        telemetryPanel = std::make_unique<TelemetryPanelComponent>(audioProcessor.telemetry);
+        addAndMakeVisible(telemetryPanel.get());
+        resized();
+    }
+
+    return true;
+}
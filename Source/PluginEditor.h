@@ -3,7 +3,7 @@
     PluginEditor.h
     GOODMETER - Main plugin editor
 
-    60Hz Timer-driven UI with vertical meter layout
+    60Hz display-synced UI (FrameScheduler) with vertical meter layout
   ==============================================================================
 */
 
@@ -22,13 +22,15 @@
 #include "Band3Component.h"
 #include "PsrMeterComponent.h"
 #include "HoloNonoComponent.h"
+#include "TelemetryPanelComponent.h"
+#include "FrameScheduler.h"
 
 //==============================================================================
 /**
- * Main plugin editor with 60Hz update timer
+ * Main plugin editor, fed one meter snapshot per display frame
  */
 class GOODMETERAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                      public juce::Timer
+                                      public FrameScheduler::Client
 {
 public:
     GOODMETERAudioProcessorEditor(GOODMETERAudioProcessor&);
@@ -39,7 +41,7 @@ public:
     void resized() override;
 
     //==========================================================================
-    void timerCallback() override;
+    void frameTick() override;
 
     //==========================================================================
     // Mouse handlers for jiggle drag-drop reorder
@@ -48,12 +50,24 @@ public:
     void mouseUp(const juce::MouseEvent&) override;
     void mouseDoubleClick(const juce::MouseEvent&) override;
 
+    // Cmd/Ctrl+Shift+D toggles the hidden engine diagnostics panel
+    bool keyPressed(const juce::KeyPress&) override;
+
 private:
     GOODMETERAudioProcessor& audioProcessor;
 
+    // One meter snapshot read per frame, before any meter ticks
+    FrameScheduler::FrameStart meterFrame { [this] { audioProcessor.updateMeterSnapshot(); } };
+
     // Custom LookAndFeel
     GoodMeterLookAndFeel customLookAndFeel;
 
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+    // The whole editor composites on the GPU; the spectrogram draws its
+    // waterfall from a texture ring through it
+    juce::OpenGLContext openGLContext;
+   #endif
+
     // Meter components (raw pointers - owned by MeterCardComponents)
     LevelsMeterComponent* levelsMeter = nullptr;
     PhaseCorrelationComponent* phaseMeter = nullptr;
@@ -76,6 +90,9 @@ private:
     std::unique_ptr<MeterCardComponent> psrCard;
     std::unique_ptr<MeterCardComponent> nonoCard;
 
+    // Engine diagnostics overlay (only exists while shown; its Watch enables timing)
+    std::unique_ptr<TelemetryPanelComponent> telemetryPanel;
+
     // Viewport for scrolling (if needed)
     std::unique_ptr<juce::Viewport> viewport;
     std::unique_ptr<juce::Component> contentComponent;
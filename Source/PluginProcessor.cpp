@@ -30,32 +30,26 @@ GOODMETERAudioProcessor::GOODMETERAudioProcessor()
                      .withInput("Input", juce::AudioChannelSet::stereo(), true)
                      .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 {
-    // Initialize LUFS buffer to zero
-    lufsBufferL.fill(0.0f);
-    lufsBufferR.fill(0.0f);
-
-    // Initialize Short-Term LUFS buffer
-    stLufsBufferL.fill(0.0f);
-    stLufsBufferR.fill(0.0f);
-
-    // Initialize FFT ring buffer to zero
-    fftRingL.fill(0.0f);
-    fftRingR.fill(0.0f);
-    fftWorkBuffer.fill(0.0f);
-
-    // Reserve LRA history
-    lraHistory.reserve(lraMaxSamples);
-
-    // Zero integrated block storage
-    std::fill(std::begin(integratedBlockStorage), std::end(integratedBlockStorage), 0.0f);
-
 #if JUCE_MAC && JucePlugin_Build_Standalone
     systemAudioCapture = std::make_unique<SystemAudioCapture>();
 #endif
+
+    // Mirror the crossover bank's default edges so saved state starts from them
+    requestedCrossovers[0].store(250.0f, std::memory_order_relaxed);
+    requestedCrossovers[1].store(2000.0f, std::memory_order_relaxed);
+
+    // A single app owns the process: keep rewind always-on there. Plugin
+    // instances defer until their rewind UI is opened (shared history budget).
+    if (wrapperType == wrapperType_Standalone)
+    {
+        setRewindEnabled(true);
+        setTimelineLoggingEnabled(true);
+    }
 }
 
 GOODMETERAudioProcessor::~GOODMETERAudioProcessor()
 {
+    spectrumWorker.release();
 }
 
 //==============================================================================
@@ -117,103 +111,125 @@ void GOODMETERAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlo
 
     currentSampleRate = sampleRate;
 
-    // Prepare K-Weighting filters for LUFS
-    kWeightingL.prepare(sampleRate);
-    kWeightingR.prepare(sampleRate);
-
-    // Prepare 3-Band frequency filters
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = 1;
-
-    // LOW band: Butterworth Low-pass @ 250Hz (4th order)
-    *lowPassL_250Hz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 250.0f, 0.707f);
-    *lowPassR_250Hz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 250.0f, 0.707f);
-
-    // MID band: HP @ 250Hz cascaded with LP @ 2kHz (flat summing crossover)
-    *midHpL_250Hz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 250.0f, 0.707f);
-    *midHpR_250Hz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 250.0f, 0.707f);
-    *midLpL_2kHz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 2000.0f, 0.707f);
-    *midLpR_2kHz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 2000.0f, 0.707f);
-
-    // HIGH band: Butterworth High-pass @ 2kHz (4th order)
-    *highPassL_2kHz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 2000.0f, 0.707f);
-    *highPassR_2kHz.coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 2000.0f, 0.707f);
-
-    lowPassL_250Hz.prepare(spec);
-    lowPassR_250Hz.prepare(spec);
-    midHpL_250Hz.prepare(spec);
-    midHpR_250Hz.prepare(spec);
-    midLpL_2kHz.prepare(spec);
-    midLpR_2kHz.prepare(spec);
-    highPassL_2kHz.prepare(spec);
-    highPassR_2kHz.prepare(spec);
-
-    // Reset all DSP state
-    kWeightingL.reset();
-    kWeightingR.reset();
-
-    lowPassL_250Hz.reset();
-    lowPassR_250Hz.reset();
-    midHpL_250Hz.reset();
-    midHpR_250Hz.reset();
-    midLpL_2kHz.reset();
-    midLpR_2kHz.reset();
-    highPassL_2kHz.reset();
-    highPassR_2kHz.reset();
-
-    lufsBufferL.fill(0.0f);
-    lufsBufferR.fill(0.0f);
-    lufsBufferIndex = 0;
-
-    stLufsBufferL.fill(0.0f);
-    stLufsBufferR.fill(0.0f);
-    stLufsBufferIndex = 0;
-
-    // Reset integrated LUFS state (lock-free — only accessed from audio thread)
-    std::fill(std::begin(integratedBlockStorage), std::end(integratedBlockStorage), 0.0f);
-    integratedBlockCount = 0;
-    integratedBlockSampleCount = 0;
-
-    // Reset LRA history
+    // Prepare loudness engine (K-weighting + sub-block ring, also resets state)
+    // Surround buses meter every channel with BS.1770-4 position weights;
+    // stereo (and the standalone auto-detected pair) uses equal weights.
     {
-        std::lock_guard<std::mutex> lock(lraMutex);
-        lraHistory.clear();
+        const auto layout = getChannelLayoutOfBus(true, 0);
+        const int layoutChannels = juce::jmin(layout.size(), maxLoudnessChannels);
+        std::array<float, maxLoudnessChannels> weights {};
+
+        for (int ch = 0; ch < layoutChannels; ++ch)
+            weights[(size_t) ch] = LoudnessEngine::getChannelWeight(layout.getTypeOfChannel(ch));
+
+#if JucePlugin_Build_Standalone && ! JUCE_IOS
+        meterAllChannelsForLoudness = false;
+#else
+        meterAllChannelsForLoudness = layoutChannels > 2;
+#endif
+
+        if (meterAllChannelsForLoudness)
+            loudnessEngine.prepare(sampleRate, layoutChannels, weights.data());
+        else
+            loudnessEngine.prepare(sampleRate);
     }
+    truePeakFilterL.reset();
+    truePeakFilterR.reset();
+
+    // Prepare multiband crossover bank (picks up any pending band edges)
+    applyPendingCrossovers();
+    bandFilterBank.prepare(sampleRate);
+    for (auto& value : bandRmsLevels)
+        value.store(-90.0f, std::memory_order_relaxed);
 
-    fftRingL.fill(0.0f);
-    fftRingR.fill(0.0f);
-    fftRingIndex = 0;
-    fftSamplesSinceLastPush = 0;
-    spectrogramSamplesSinceLastPush = 0;
+    // Restart the FFT worker from an empty window
+    spectrumWorker.prepare(sampleRate);
 
-    // Prepare retroactive recording history buffer
+    // Prepare retroactive recording history buffer (an unchanged rate keeps
+    // the ring and its history rather than reallocating ~111 MB)
     audioHistoryBuffer.prepare(sampleRate);
+
+    // Timeline records restart on the meters' 100 ms grid
+    timelineLog.prepare(sampleRate);
+
+#if JUCE_MAC && JucePlugin_Build_Standalone
+    prepareLiveDenoise(sampleRate, samplesPerBlock);
+#endif
 }
 
 void GOODMETERAudioProcessor::releaseResources()
 {
     // Reset when playback stops
+    spectrumWorker.release();
+
+#if JUCE_MAC && JucePlugin_Build_Standalone
+    if (liveDenoise != nullptr)
+        liveDenoise->release();
+#endif
 }
 
-bool GOODMETERAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+#if JUCE_MAC && JucePlugin_Build_Standalone
+//==============================================================================
+void GOODMETERAudioProcessor::prepareLiveDenoise(double sampleRate, int samplesPerBlock)
 {
-    // Only support stereo
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    if (liveDenoise == nullptr)
+        return;
 
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    if (liveDenoiseWanted)
+        liveDenoise->prepare(sampleRate, samplesPerBlock, 2);
+    else
+        liveDenoise->release();
+
+    setLatencySamples(liveDenoise->getLatencySamples());
+}
+
+bool GOODMETERAudioProcessor::setLiveDenoiseEnabled(bool shouldDenoise)
+{
+    // ONNX sessions load here, outside the callback lock
+    std::unique_ptr<DeepFilterProcessor> model;
+    if (shouldDenoise && liveDenoiseModel == nullptr)
+    {
+        const auto dir = DeepFilterProcessor::findModelDirectory();
+        model = std::make_unique<DeepFilterProcessor>();
+        if (dir == juce::File() || ! model->initialize(dir))
+            return false;
+    }
+
+    // Suspended: processBlock is not running while the stream is swapped
+    suspendProcessing(true);
+    if (model != nullptr)
+    {
+        liveDenoiseModel = std::move(model);
+        liveDenoise = std::make_unique<DeepFilterRealtime>(*liveDenoiseModel);
+    }
+    liveDenoiseWanted = shouldDenoise;
+    if (getSampleRate() > 0.0)
+        prepareLiveDenoise(getSampleRate(), getBlockSize());
+    suspendProcessing(false);
 
     return true;
 }
+#endif
+
+bool GOODMETERAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Stereo plus the surround/immersive layouts the loudness engine weights
+    const auto mainIn = layouts.getMainInputChannelSet();
+    if (layouts.getMainOutputChannelSet() != mainIn)
+        return false;
+
+    return mainIn == juce::AudioChannelSet::stereo()
+        || mainIn == juce::AudioChannelSet::create5point1()
+        || mainIn == juce::AudioChannelSet::create7point1()
+        || mainIn == juce::AudioChannelSet::create7point1point4();
+}
 
 //==============================================================================
 void GOODMETERAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    const EngineTelemetry::CallbackTimer callbackTimer(telemetry, buffer.getNumSamples(), getSampleRate());
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -275,15 +291,15 @@ void GOODMETERAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
         float* writeL = buffer.getWritePointer(0);
         float* writeR = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
 
-        int read = systemAudioCapture->readSamples(writeL, writeR, numSamplesOverride);
-
-        // Zero-fill remainder if ring buffer didn't have enough samples
-        if (read < numSamplesOverride)
-        {
-            std::fill(writeL + read, writeL + numSamplesOverride, 0.0f);
-            if (writeR) std::fill(writeR + read, writeR + numSamplesOverride, 0.0f);
-        }
+        // Always fills the block: the bridge pads underruns with silence
+        // and re-primes at its target latency
+        systemAudioCapture->readSamples(writeL, writeR, numSamplesOverride);
     }
+
+    // Live denoise: the first pair is replaced, delayed by the reported latency
+    if (liveDenoise != nullptr)
+        liveDenoise->process(buffer.getArrayOfWritePointers(),
+                             juce::jmin(2, buffer.getNumChannels()), buffer.getNumSamples());
 #endif
 
     const int numSamples = buffer.getNumSamples();
@@ -298,14 +314,8 @@ void GOODMETERAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
         float maxRMS = 0.0f;
         for (int ch = 0; ch < totalNumInputChannels - 1; ch += 2)
         {
-            float sumL = 0.0f, sumR = 0.0f;
-            const float* dataL = buffer.getReadPointer(ch);
-            const float* dataR = buffer.getReadPointer(ch + 1);
-            for (int i = 0; i < numSamples; ++i)
-            {
-                sumL += dataL[i] * dataL[i];
-                sumR += dataR[i] * dataR[i];
-            }
+            const float sumL = MeterAnalysisKernel::sumOfSquares(buffer.getReadPointer(ch), numSamples);
+            const float sumR = MeterAnalysisKernel::sumOfSquares(buffer.getReadPointer(ch + 1), numSamples);
             float rms = std::sqrt((sumL + sumR) / (numSamples * 2));
             if (rms > maxRMS)
             {
@@ -329,105 +339,122 @@ void GOODMETERAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
     if (audioRecorder.getIsRecording())
     {
         const float* recChannels[2] = { channelDataL, channelDataR };
-        audioRecorder.pushSamples(recChannels, numSamples);
+        const int dropped = audioRecorder.pushSamples(recChannels, numSamples);
+        telemetry.countRecorder(dropped, audioRecorder.getFifoFill());
     }
 
     // Retroactive recording — always push into history buffer (lock-free, ~zero cost)
     audioHistoryBuffer.pushSamples(channelDataL, channelDataR, numSamples);
 
+    // Optional analyses run only while a component subscribes to them.
+    // Loudness, peaks, true peak and the stereo statistics always run.
+    const bool wantStereoSamples = analysisDemand.isWanted(AnalysisDemand::Analysis::stereoSamples);
+    const bool wantBands = analysisDemand.isWanted(AnalysisDemand::Analysis::bands);
+
+    // Spectrum / spectrogram — raw samples to the FFT worker (lock-free copy),
+    // at the slowest hop the subscribers and the power policy allow
+    if (analysisDemand.isWanted(AnalysisDemand::Analysis::spectrum))
+    {
+        spectrumWorker.setHopMultiple(analysisDemand.getSpectrumHopMultiple(currentSampleRate / spectrumFrameHopSize));
+        if (const int dropped = spectrumWorker.pushSamples(channelDataL, channelDataR, numSamples))
+            telemetry.countSpectrumSamplesDropped(dropped);
+    }
+
+    // Band edges changed from the GUI? (coefficients only, no allocation)
+    applyPendingCrossovers();
+
+    // Filter state from before a pause in demand would ring into the first block
+    if (wantBands && ! bandsRunning)
+        bandFilterBank.reset();
+    bandsRunning = wantBands;
+
     //==========================================================================
     // Local accumulators (stack-allocated, real-time safe)
     //==========================================================================
-    float localPeakL = 0.0f;
-    float localPeakR = 0.0f;
-    float localSumSquareL = 0.0f;
-    float localSumSquareR = 0.0f;
-    float localSumXY = 0.0f;
-    float localSumX2 = 0.0f;
-    float localSumY2 = 0.0f;
-
-    auto runFftFromRing = [this](const std::array<float, fftSize>& ring)
-    {
-        for (int j = 0; j < fftSize; ++j)
-            fftWorkBuffer[j] = ring[(fftRingIndex + j) % fftSize];
+    StereoBlockStats stats;
+    std::array<float, maxMeterBands> localBandEnergies {};
+    float localTruePeakL = 0.0f;
+    float localTruePeakR = 0.0f;
 
-        std::fill(fftWorkBuffer.begin() + fftSize, fftWorkBuffer.end(), 0.0f);
-        window.multiplyWithWindowingTable(fftWorkBuffer.data(), fftSize);
-        fft.performFrequencyOnlyForwardTransform(fftWorkBuffer.data());
-    };
+    const bool meterLoudnessChannels = meterAllChannelsForLoudness
+                                    && totalNumInputChannels >= loudnessEngine.getNumChannels();
+    std::array<const float*, maxLoudnessChannels> loudnessChannels {};
 
     //==========================================================================
-    // Sample-by-sample processing
+    // Fused single pass: every analysis stage consumes one L1-hot chunk
+    // before moving on, instead of re-reading the whole block per stage.
     //==========================================================================
-    for (int i = 0; i < numSamples; ++i)
+    for (int offset = 0; offset < numSamples; offset += MeterAnalysisKernel::kChunkSize)
     {
-        const float sampleL = channelDataL[i];
-        const float sampleR = channelDataR[i];
+        const int run = juce::jmin(MeterAnalysisKernel::kChunkSize, numSamples - offset);
+        const float* chunkL = channelDataL + offset;
+        const float* chunkR = channelDataR + offset;
 
         //======================================================================
-        // 1. Peak Detection
+        // 1. Peak / RMS / Phase Correlation / Mid-Side energy (SIMD)
         //======================================================================
-        const float absL = std::abs(sampleL);
-        const float absR = std::abs(sampleR);
-        if (absL > localPeakL) localPeakL = absL;
-        if (absR > localPeakR) localPeakR = absR;
+        MeterAnalysisKernel::accumulateStereo(chunkL, chunkR, run, stats);
 
         //======================================================================
-        // 2. RMS Accumulation
+        // 2. True Peak (4x polyphase FIR) + K-weighted loudness
         //======================================================================
-        localSumSquareL += sampleL * sampleL;
-        localSumSquareR += sampleR * sampleR;
+        localTruePeakL = juce::jmax(localTruePeakL, truePeakFilterL.process(chunkL, run));
+        localTruePeakR = juce::jmax(localTruePeakR, truePeakFilterR.process(chunkR, run));
 
-        //======================================================================
-        // 3. Phase Correlation Accumulation
-        //======================================================================
-        localSumXY += sampleL * sampleR;
-        localSumX2 += sampleL * sampleL;
-        localSumY2 += sampleR * sampleR;
+        if (meterLoudnessChannels)
+        {
+            for (int ch = 0; ch < loudnessEngine.getNumChannels(); ++ch)
+                loudnessChannels[(size_t) ch] = buffer.getReadPointer(ch, offset);
+            loudnessEngine.process(loudnessChannels.data(), run);
+        }
+        else
+        {
+            loudnessEngine.processStereo(chunkL, chunkR, run);
+        }
 
         //======================================================================
-        // 4. K-Weighted LUFS Processing
+        // 3. Multiband Frequency Analysis (LR4 crossover bank, SIMD lanes)
+        //    Unsubscribed: energies stay zero and the bands read -90 dB
         //======================================================================
-        const float kWeightedL = kWeightingL.processSample(sampleL);
-        const float kWeightedR = kWeightingR.processSample(sampleR);
-
-        // Store in circular buffer
-        lufsBufferL[lufsBufferIndex] = kWeightedL;
-        lufsBufferR[lufsBufferIndex] = kWeightedR;
-        lufsBufferIndex = (lufsBufferIndex + 1) % lufsBufferSize;
+        if (wantBands)
+            bandFilterBank.process(chunkL, chunkR, run, localBandEnergies.data());
 
         //======================================================================
-        // 5. FFT Ring Buffer with 50% Overlap (doubles FFT frame rate)
+        // 4. Stereo Image Sample Buffer (for Goniometer/Lissajous)
+        // 🎯 批量打包推送 512 个点到 FIFO（解决容量瓶颈 Bug）
+        // Downsample: push every 2nd sample (chunk size is even, so the
+        // block-relative phase is preserved). Last stage: skipped outright
+        // while no goniometer is showing.
         //======================================================================
-        fftRingL[fftRingIndex] = sampleL;
-        fftRingR[fftRingIndex] = sampleR;
-        fftRingIndex = (fftRingIndex + 1) % fftSize;
-        fftSamplesSinceLastPush++;
-        spectrogramSamplesSinceLastPush++;
-
-#if JUCE_IOS
-        if (spectrogramSamplesSinceLastPush >= spectrogramHopSize)
-        {
-            runFftFromRing(fftRingL);
-            fftFifoSpectrogramL.push(fftWorkBuffer.data(), fftSize / 2);
-            spectrogramSamplesSinceLastPush = 0;
-        }
-#endif
+        if (! wantStereoSamples)
+            continue;
 
-        if (fftSamplesSinceLastPush >= fftHopSize)
+        for (int i = 0; i < run; i += 2)
         {
-            // Apply window + FFT for L channel
-            runFftFromRing(fftRingL);
-            fftFifoL.push(fftWorkBuffer.data(), fftSize / 2);
-#if ! JUCE_IOS
-            fftFifoSpectrogramL.push(fftWorkBuffer.data(), fftSize / 2);
-#endif
+            // Write straight into the next free FIFO slot; skip while the GUI is behind
+            if (stereoSlotL == nullptr || stereoSlotR == nullptr)
+            {
+                stereoSlotL = stereoSampleFifoL.reserveWrite();
+                stereoSlotR = stereoSampleFifoR.reserveWrite();
+                tempStereoIndex = 0;
+                if (stereoSlotL == nullptr || stereoSlotR == nullptr)
+                {
+                    telemetry.countStereoFifoFull();
+                    break;
+                }
+            }
 
-            // Same for R channel
-            runFftFromRing(fftRingR);
-            fftFifoR.push(fftWorkBuffer.data(), fftSize / 2);
+            stereoSlotL[tempStereoIndex] = chunkL[i];
+            stereoSlotR[tempStereoIndex] = chunkR[i];
+            tempStereoIndex++;
 
-            fftSamplesSinceLastPush = 0;
+            // 🎯 攒满 512 个点后，一次性发布整个槽位！
+            if (tempStereoIndex >= stereoBatchSize)
+            {
+                stereoSampleFifoL.commitWrite();
+                stereoSampleFifoR.commitWrite();
+                stereoSlotL = stereoSlotR = nullptr;
+            }
         }
     }
 
@@ -435,262 +462,106 @@ void GOODMETERAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
     // Calculate and update atomic metrics
     //==========================================================================
 
+    MeterSnapshot snapshot;
+    snapshot.blockIndex = ++meterBlockCounter;
+
     // Peak (convert to dB)
-    const float peakL_dB = localPeakL > 1e-8f ? 20.0f * std::log10(localPeakL) : -90.0f;
-    const float peakR_dB = localPeakR > 1e-8f ? 20.0f * std::log10(localPeakR) : -90.0f;
+    const float peakL_dB = stats.peakL > 1e-8f ? 20.0f * std::log10(stats.peakL) : -90.0f;
+    const float peakR_dB = stats.peakR > 1e-8f ? 20.0f * std::log10(stats.peakR) : -90.0f;
     peakLevelL.store(peakL_dB, std::memory_order_relaxed);
     peakLevelR.store(peakR_dB, std::memory_order_relaxed);
+    snapshot.peakL = peakL_dB;
+    snapshot.peakR = peakR_dB;
+
+    // True Peak (4x oversampled, dBTP)
+    snapshot.truePeakL = localTruePeakL > 1e-8f ? 20.0f * std::log10(localTruePeakL) : -90.0f;
+    snapshot.truePeakR = localTruePeakR > 1e-8f ? 20.0f * std::log10(localTruePeakR) : -90.0f;
+    truePeakLevelL.store(snapshot.truePeakL, std::memory_order_relaxed);
+    truePeakLevelR.store(snapshot.truePeakR, std::memory_order_relaxed);
 
     // RMS (convert to dB)
-    const float rmsL = std::sqrt(localSumSquareL / numSamples);
-    const float rmsR = std::sqrt(localSumSquareR / numSamples);
+    const float rmsL = std::sqrt(stats.sumSquareL / numSamples);
+    const float rmsR = std::sqrt(stats.sumSquareR / numSamples);
     const float rmsL_dB = rmsL > 1e-8f ? 20.0f * std::log10(rmsL) : -90.0f;
     const float rmsR_dB = rmsR > 1e-8f ? 20.0f * std::log10(rmsR) : -90.0f;
     rmsLevelL.store(rmsL_dB, std::memory_order_relaxed);
     rmsLevelR.store(rmsR_dB, std::memory_order_relaxed);
+    snapshot.rmsL = rmsL_dB;
+    snapshot.rmsR = rmsR_dB;
 
     // Phase Correlation (-1.0 to +1.0)
-    const float denominator = std::sqrt(localSumX2 * localSumY2);
-    const float correlation = (denominator > 1e-8f) ? (localSumXY / denominator) : 0.0f;
+    const float denominator = std::sqrt(stats.sumSquareL * stats.sumSquareR);
+    const float correlation = (denominator > 1e-8f) ? (stats.sumLR / denominator) : 0.0f;
     phaseCorrelation.store(correlation, std::memory_order_relaxed);
+    snapshot.phaseCorrelation = correlation;
 
     //==========================================================================
-    // LUFS Calculation (Momentary - 400ms window)
-    //==========================================================================
-    const int windowSamples = static_cast<int>(currentSampleRate * 0.4);
-    const int startIdx = juce::jmax(0, lufsBufferIndex - windowSamples);
-    const int endIdx = lufsBufferIndex;
-
-    float lufsSumL = 0.0f;
-    float lufsSumR = 0.0f;
-    int lufsCount = 0;
-
-    // Handle circular buffer wrap-around
-    if (endIdx >= startIdx)
-    {
-        for (int i = startIdx; i < endIdx; ++i)
-        {
-            lufsSumL += lufsBufferL[i] * lufsBufferL[i];
-            lufsSumR += lufsBufferR[i] * lufsBufferR[i];
-            lufsCount++;
-        }
-    }
-    else
-    {
-        // Wrap around
-        for (int i = startIdx; i < lufsBufferSize; ++i)
-        {
-            lufsSumL += lufsBufferL[i] * lufsBufferL[i];
-            lufsSumR += lufsBufferR[i] * lufsBufferR[i];
-            lufsCount++;
-        }
-        for (int i = 0; i < endIdx; ++i)
-        {
-            lufsSumL += lufsBufferL[i] * lufsBufferL[i];
-            lufsSumR += lufsBufferR[i] * lufsBufferR[i];
-            lufsCount++;
-        }
-    }
-
-    if (lufsCount > 0)
-    {
-        const float meanSquareL = lufsSumL / lufsCount;
-        const float meanSquareR = lufsSumR / lufsCount;
-        const float sumMeanSquare = meanSquareL + meanSquareR;
-
-        float lufs_dB = -70.0f;
-        if (sumMeanSquare > 1e-10f)
-        {
-            lufs_dB = -0.691f + 10.0f * std::log10(sumMeanSquare);
-        }
-        lufsLevel.store(lufs_dB, std::memory_order_relaxed);
-    }
-
-    //==========================================================================
-    // Short-Term LUFS (3s window) — same K-weighted data, longer window
+    // LUFS Momentary (400ms) + Short-Term (3s)
+    // Incremental: K-weighted power is folded into 100ms sub-block sums,
+    // so cost is O(numSamples) regardless of window length.
     //==========================================================================
-    // Store K-weighted samples in short-term buffer too (reuse from lufs buffer)
-    // We already wrote K-weighted samples to lufsBuffer above. Copy them to stLufs buffer.
-    {
-        // Walk backwards from current lufsBufferIndex by numSamples
-        for (int i = 0; i < numSamples; ++i)
-        {
-            int srcIdx = (lufsBufferIndex - numSamples + i + lufsBufferSize) % lufsBufferSize;
-            stLufsBufferL[stLufsBufferIndex] = lufsBufferL[srcIdx];
-            stLufsBufferR[stLufsBufferIndex] = lufsBufferR[srcIdx];
-            stLufsBufferIndex = (stLufsBufferIndex + 1) % stLufsBufferSize;
-        }
-    }
-
-    // Calculate Short-Term LUFS (3s window)
-    {
-        const int stWindowSamples = juce::jmin(static_cast<int>(currentSampleRate * 3.0), stLufsBufferSize);
-        float stSumL = 0.0f, stSumR = 0.0f;
-        int stCount = 0;
-
-        for (int i = 0; i < stWindowSamples; ++i)
-        {
-            int idx = (stLufsBufferIndex - stWindowSamples + i + stLufsBufferSize) % stLufsBufferSize;
-            stSumL += stLufsBufferL[idx] * stLufsBufferL[idx];
-            stSumR += stLufsBufferR[idx] * stLufsBufferR[idx];
-            stCount++;
-        }
-
-        if (stCount > 0)
-        {
-            float stMeanSq = stSumL / stCount + stSumR / stCount;
-            float st_dB = (stMeanSq > 1e-10f) ? (-0.691f + 10.0f * std::log10(stMeanSq)) : -70.0f;
-            lufsShortTerm.store(st_dB, std::memory_order_relaxed);
-        }
-    }
+    snapshot.lufsMomentary = loudnessEngine.getMomentaryLufs();
+    snapshot.lufsShortTerm = loudnessEngine.getShortTermLufs();
+    lufsLevel.store(snapshot.lufsMomentary, std::memory_order_relaxed);
+    lufsShortTerm.store(snapshot.lufsShortTerm, std::memory_order_relaxed);
 
     //==========================================================================
-    // Integrated LUFS — accumulate 400ms blocks for gating (BS.1770-4)
+    // Integrated LUFS — gated 400ms blocks (75% overlap) in a fixed histogram
     // Lock-free: all data stays on audio thread, no mutex, no allocation.
     //==========================================================================
-    integratedBlockSampleCount += numSamples;
-    if (integratedBlockSampleCount >= static_cast<int>(currentSampleRate * 0.4))
-    {
-        // We have one 400ms block worth — compute its loudness
-        float blockLufs = lufsLevel.load(std::memory_order_relaxed);
+    snapshot.lufsIntegrated = loudnessEngine.getIntegratedLufs();
+    lufsIntegrated.store(snapshot.lufsIntegrated, std::memory_order_relaxed);
 
-        // Store in fixed-size array (cap at max to prevent overflow)
-        if (integratedBlockCount < integratedBlockMaxCount)
-            integratedBlockStorage[integratedBlockCount++] = blockLufs;
+    // LU Range (EBU Tech 3342) — streaming short-term histogram, whole programme
+    snapshot.luRange = loudnessEngine.getLoudnessRange();
+    luRange.store(snapshot.luRange, std::memory_order_relaxed);
 
-        integratedBlockSampleCount = 0;
-
-        // Compute Integrated LUFS with absolute + relative gating
-        // All data is local to audio thread — no lock needed
-        if (integratedBlockCount > 0)
-        {
-            // Step 1: Absolute gate — count blocks > -70 LUFS
-            double linSum1 = 0.0;
-            int gated1Count = 0;
-            for (int idx = 0; idx < integratedBlockCount; ++idx)
-            {
-                if (integratedBlockStorage[idx] > -70.0f)
-                {
-                    linSum1 += std::pow(10.0, integratedBlockStorage[idx] / 10.0);
-                    gated1Count++;
-                }
-            }
-
-            if (gated1Count > 0)
-            {
-                // Step 2: Calculate average of gated blocks (in linear power)
-                double avgLin = linSum1 / gated1Count;
-                float relativeGate = static_cast<float>(10.0 * std::log10(avgLin)) - 10.0f;
-
-                // Step 3: Relative gate — sum blocks above relativeGate
-                double finalSum = 0.0;
-                int finalCount = 0;
-                for (int idx = 0; idx < integratedBlockCount; ++idx)
-                {
-                    if (integratedBlockStorage[idx] > -70.0f &&
-                        integratedBlockStorage[idx] > relativeGate)
-                    {
-                        finalSum += std::pow(10.0, integratedBlockStorage[idx] / 10.0);
-                        finalCount++;
-                    }
-                }
-
-                if (finalCount > 0)
-                {
-                    float intLufs = static_cast<float>(10.0 * std::log10(finalSum / finalCount));
-                    lufsIntegrated.store(intLufs, std::memory_order_relaxed);
-                }
-            }
-        }
-    }
+    // Per channel: every bus channel on the surround path, the pair otherwise
+    snapshot.numLoudnessChannels = meterLoudnessChannels ? loudnessEngine.getNumChannels()
+                                                         : juce::jmin(2, loudnessEngine.getNumChannels());
+    for (int ch = 0; ch < snapshot.numLoudnessChannels; ++ch)
+        snapshot.channelLufs[(size_t) ch] = loudnessEngine.getChannelMomentaryLufs(ch);
 
     //==========================================================================
-    // Mid/Side (M/S) Calculation
+    // Mid/Side (M/S) RMS
     //==========================================================================
-    float localSumSquareMid = 0.0f;
-    float localSumSquareSide = 0.0f;
-
-    for (int i = 0; i < numSamples; ++i)
-    {
-        const float sampleL = channelDataL[i];
-        const float sampleR = channelDataR[i];
-
-        const float mid = (sampleL + sampleR) * 0.5f;
-        const float side = (sampleL - sampleR) * 0.5f;
-
-        localSumSquareMid += mid * mid;
-        localSumSquareSide += side * side;
-    }
-
-    const float rmsMid = std::sqrt(localSumSquareMid / numSamples);
-    const float rmsSide = std::sqrt(localSumSquareSide / numSamples);
+    const float rmsMid = std::sqrt(stats.sumSquareMid / numSamples);
+    const float rmsSide = std::sqrt(stats.sumSquareSide / numSamples);
     const float rmsMid_dB = rmsMid > 1e-8f ? 20.0f * std::log10(rmsMid) : -90.0f;
     const float rmsSide_dB = rmsSide > 1e-8f ? 20.0f * std::log10(rmsSide) : -90.0f;
     rmsLevelMid.store(rmsMid_dB, std::memory_order_relaxed);
     rmsLevelSide.store(rmsSide_dB, std::memory_order_relaxed);
+    snapshot.rmsMid = rmsMid_dB;
+    snapshot.rmsSide = rmsSide_dB;
 
     //==========================================================================
-    // 3-Band Frequency Analysis (LOW/MID/HIGH)
+    // Multiband RMS (stereo sum, convert to dB)
+    // LOW/MID/HIGH keep their meaning: first, second and last band.
     //==========================================================================
-    float localSumSquareLow = 0.0f;
-    float localSumSquareMid3Band = 0.0f;
-    float localSumSquareHigh = 0.0f;
+    const int numBands = bandFilterBank.getNumBands();
+    auto& bandDb = snapshot.bandRms;
 
-    for (int i = 0; i < numSamples; ++i)
+    for (int band = 0; band < numBands; ++band)
     {
-        const float sampleL = channelDataL[i];
-        const float sampleR = channelDataR[i];
-
-        // Apply band filters
-        const float lowL = lowPassL_250Hz.processSample(sampleL);
-        const float lowR = lowPassR_250Hz.processSample(sampleR);
-        const float midL = midLpL_2kHz.processSample(midHpL_250Hz.processSample(sampleL));
-        const float midR = midLpR_2kHz.processSample(midHpR_250Hz.processSample(sampleR));
-        const float highL = highPassL_2kHz.processSample(sampleL);
-        const float highR = highPassR_2kHz.processSample(sampleR);
-
-        // Accumulate RMS for each band (stereo sum)
-        localSumSquareLow += (lowL * lowL + lowR * lowR);
-        localSumSquareMid3Band += (midL * midL + midR * midR);
-        localSumSquareHigh += (highL * highL + highR * highR);
+        const float rmsBand = std::sqrt(localBandEnergies[(size_t) band] / (numSamples * 2));
+        bandDb[(size_t) band] = rmsBand > 1e-8f ? 20.0f * std::log10(rmsBand) : -90.0f;
+        bandRmsLevels[(size_t) band].store(bandDb[(size_t) band], std::memory_order_relaxed);
     }
+    numMeterBands.store(numBands, std::memory_order_relaxed);
+    snapshot.numBands = numBands;
 
-    // Calculate RMS and convert to dB
-    const float rmsLow = std::sqrt(localSumSquareLow / (numSamples * 2));
-    const float rmsMid3Band = std::sqrt(localSumSquareMid3Band / (numSamples * 2));
-    const float rmsHigh = std::sqrt(localSumSquareHigh / (numSamples * 2));
+    snapshot.rmsLow = bandDb[0];
+    snapshot.rmsMid3Band = numBands > 2 ? bandDb[1] : -90.0f;
+    snapshot.rmsHigh = bandDb[(size_t) numBands - 1];
+    rmsLevelLow.store(snapshot.rmsLow, std::memory_order_relaxed);
+    rmsLevelMid3Band.store(snapshot.rmsMid3Band, std::memory_order_relaxed);
+    rmsLevelHigh.store(snapshot.rmsHigh, std::memory_order_relaxed);
 
-    const float rmsLow_dB = rmsLow > 1e-8f ? 20.0f * std::log10(rmsLow) : -90.0f;
-    const float rmsMid3Band_dB = rmsMid3Band > 1e-8f ? 20.0f * std::log10(rmsMid3Band) : -90.0f;
-    const float rmsHigh_dB = rmsHigh > 1e-8f ? 20.0f * std::log10(rmsHigh) : -90.0f;
+    // One publish per block: the GUI sees all of the above or none of it
+    meterSnapshot.publish(snapshot);
 
-    rmsLevelLow.store(rmsLow_dB, std::memory_order_relaxed);
-    rmsLevelMid3Band.store(rmsMid3Band_dB, std::memory_order_relaxed);
-    rmsLevelHigh.store(rmsHigh_dB, std::memory_order_relaxed);
-
-    //==========================================================================
-    // Stereo Image Sample Buffer (for Goniometer/Lissajous)
-    // 🎯 批量打包推送 512 个点到 FIFO（解决容量瓶颈 Bug）
-    //==========================================================================
-    // Downsample: push every 2nd sample (更密集的线条)
-    for (int i = 0; i < numSamples; i += 2)
-    {
-        const float sampleL = channelDataL[i];
-        const float sampleR = channelDataR[i];
-
-        // 积攒到本地缓冲区
-        tempStereoBufL[tempStereoIndex] = sampleL;
-        tempStereoBufR[tempStereoIndex] = sampleR;
-        tempStereoIndex++;
-
-        // 🎯 攒满 512 个点后，一次性打包推入 FIFO！
-        if (tempStereoIndex >= 512)
-        {
-            stereoSampleFifoL.push(tempStereoBufL.data(), 512);
-            stereoSampleFifoR.push(tempStereoBufR.data(), 512);
-            tempStereoIndex = 0;
-        }
-    }
+    // Decimated to 10 Hz for the session timeline (lock-free FIFO to its writer)
+    timelineLog.process(snapshot, numSamples, wantBands);
 
     //==========================================================================
     // Standalone mode: mute output to prevent feedback loop.
@@ -703,6 +574,50 @@ void GOODMETERAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
 #endif
 }
 
+//==============================================================================
+void GOODMETERAudioProcessor::setMeterBandCrossovers(const float* frequencies, int numCrossovers)
+{
+    numCrossovers = juce::jlimit(1, CrossoverFilterBank::kMaxCrossovers, numCrossovers);
+
+    for (int i = 0; i < numCrossovers; ++i)
+        requestedCrossovers[(size_t) i].store(frequencies[i], std::memory_order_relaxed);
+
+    requestedNumCrossovers.store(numCrossovers, std::memory_order_relaxed);
+    // Release: frequencies above are visible once the new version is seen
+    crossoverRequestVersion.fetch_add(1, std::memory_order_release);
+}
+
+int GOODMETERAudioProcessor::getMeterBandCrossovers(float* frequencies) const noexcept
+{
+    const int count = requestedNumCrossovers.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i)
+        frequencies[i] = requestedCrossovers[(size_t) i].load(std::memory_order_relaxed);
+    return count;
+}
+
+void GOODMETERAudioProcessor::applyPendingCrossovers() noexcept
+{
+    const auto version = crossoverRequestVersion.load(std::memory_order_acquire);
+    if (version == appliedCrossoverVersion)
+        return;
+
+    std::array<float, CrossoverFilterBank::kMaxCrossovers> frequencies {};
+    const int count = requestedNumCrossovers.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i)
+        frequencies[(size_t) i] = requestedCrossovers[(size_t) i].load(std::memory_order_relaxed);
+
+    bandFilterBank.setCrossovers(frequencies.data(), count);
+    appliedCrossoverVersion = version;
+}
+
+//==============================================================================
+const MeterSnapshot& GOODMETERAudioProcessor::updateMeterSnapshot()
+{
+    // A failed read (publish raced every retry) keeps the previous frame's copy
+    meterSnapshot.read(guiMeterSnapshot);
+    return guiMeterSnapshot;
+}
+
 //==============================================================================
 juce::AudioProcessorEditor* GOODMETERAudioProcessor::createEditor()
 {
@@ -723,84 +638,35 @@ bool GOODMETERAudioProcessor::hasEditor() const
 //==============================================================================
 void GOODMETERAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    juce::ignoreUnused(destData);
-    // TODO: Save plugin state if needed
-}
+    std::array<float, CrossoverFilterBank::kMaxCrossovers> frequencies {};
+    const int count = getMeterBandCrossovers(frequencies.data());
 
-void GOODMETERAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
-{
-    juce::ignoreUnused(data, sizeInBytes);
-    // TODO: Restore plugin state if needed
-}
+    juce::StringArray edges;
+    for (int i = 0; i < count; ++i)
+        edges.add(juce::String(frequencies[(size_t) i], 1));
 
-//==============================================================================
-void GOODMETERAudioProcessor::pushShortTermLUFSForLRA(float stLufs)
-{
-    std::lock_guard<std::mutex> lock(lraMutex);
-    if (static_cast<int>(lraHistory.size()) >= lraMaxSamples)
-        lraHistory.erase(lraHistory.begin()); // FIFO: drop oldest
-    lraHistory.push_back(stLufs);
+    juce::XmlElement state("GOODMETER");
+    state.setAttribute("bandCrossovers", edges.joinIntoString(" "));
+    copyXmlToBinary(state, destData);
 }
 
-//==============================================================================
-void GOODMETERAudioProcessor::calculateLRARealtime()
+void GOODMETERAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    // Copy history under lock
-    std::vector<float> data;
-    {
-        std::lock_guard<std::mutex> lock(lraMutex);
-        data = lraHistory;
-    }
-
-    if (data.size() < 2)
-    {
-        luRange.store(0.0f, std::memory_order_relaxed);
-        return;
-    }
-
-    // Step 1: Absolute gate — remove <= -70.0 LUFS
-    std::vector<float> gated1;
-    gated1.reserve(data.size());
-    for (float v : data)
-        if (v > -70.0f) gated1.push_back(v);
-
-    if (gated1.size() < 2)
-    {
-        luRange.store(0.0f, std::memory_order_relaxed);
-        return;
-    }
-
-    // Step 2: Calculate average (in linear power domain)
-    double linSum = 0.0;
-    for (float v : gated1)
-        linSum += std::pow(10.0, v / 10.0);
-    double avgLin = linSum / gated1.size();
-    float relativeGate = static_cast<float>(10.0 * std::log10(avgLin)) - 20.0f;
-
-    // Step 3: Relative gate — remove below relativeGate
-    std::vector<float> gated2;
-    gated2.reserve(gated1.size());
-    for (float v : gated1)
-        if (v > relativeGate) gated2.push_back(v);
-
-    if (gated2.size() < 2)
-    {
-        luRange.store(0.0f, std::memory_order_relaxed);
+    const auto state = getXmlFromBinary(data, sizeInBytes);
+    if (state == nullptr || ! state->hasTagName("GOODMETER"))
         return;
-    }
-
-    // Step 4: Sort and get percentiles
-    std::sort(gated2.begin(), gated2.end());
-
-    size_t idx10 = static_cast<size_t>(gated2.size() * 0.10);
-    size_t idx95 = static_cast<size_t>(gated2.size() * 0.95);
-
-    // Clamp indices
-    if (idx10 >= gated2.size()) idx10 = 0;
-    if (idx95 >= gated2.size()) idx95 = gated2.size() - 1;
 
-    float lra = gated2[idx95] - gated2[idx10];
-    luRange.store(juce::jmax(0.0f, lra), std::memory_order_relaxed);
+    // Older sessions saved nothing; keep the defaults rather than clearing them
+    const auto edges = juce::StringArray::fromTokens(state->getStringAttribute("bandCrossovers"), " ", "");
+    std::array<float, CrossoverFilterBank::kMaxCrossovers> frequencies {};
+    int count = 0;
+    for (const auto& edge : edges)
+        if (count < CrossoverFilterBank::kMaxCrossovers && edge.getFloatValue() > 0.0f)
+            frequencies[(size_t) count++] = edge.getFloatValue();
+
+    // The bank clamps edges to ascending, in-range values when it applies them
+    if (count > 0)
+        setMeterBandCrossovers(frequencies.data(), count);
 }
 
 //==============================================================================
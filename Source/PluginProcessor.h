@@ -16,108 +16,25 @@
 #include <atomic>
 #include "AudioRecorder.h"
 #include "AudioHistoryBuffer.h"
+#include "LoudnessEngine.h"
+#include "TruePeakDetector.h"
+#include "MeterAnalysisKernel.h"
+#include "CrossoverFilterBank.h"
+#include "LockFreeFIFO.h"
+#include "SpectrumAnalysisWorker.h"
+#include "MeterSnapshot.h"
+#include "EngineTelemetry.h"
+#include "AnalysisDemand.h"
+#include "LoudnessTimelineLog.h"
 #if JUCE_MAC && JucePlugin_Build_Standalone
 #include "SystemAudioCapture.h"
+#include "DeepFilterRealtime.h"
 #endif
 #include <array>
 #include <vector>
 #include <algorithm>
 #include <mutex>
 
-//==============================================================================
-/**
- * Lock-free FIFO for passing FFT data from audio thread to GUI thread
- */
-template <typename T, size_t Size>
-class LockFreeFIFO
-{
-public:
-    LockFreeFIFO() : writeIndex(0), readIndex(0) {}
-
-    bool push(const T* data, size_t numSamples)
-    {
-        // Writer owns writeIndex → relaxed load is sufficient
-        const auto currentWrite = writeIndex.load(std::memory_order_relaxed);
-        const auto nextWrite = (currentWrite + 1) % Size;
-
-        // Must acquire readIndex to see consumer's latest progress
-        if (nextWrite == readIndex.load(std::memory_order_acquire))
-            return false; // Buffer full
-
-        std::copy(data, data + numSamples, buffer[currentWrite].data());
-        // Release: ensure buffer[] writes are visible before index advances
-        writeIndex.store(nextWrite, std::memory_order_release);
-        return true;
-    }
-
-    bool pop(T* dest, size_t numSamples)
-    {
-        // Reader owns readIndex → relaxed load is sufficient
-        const auto currentRead = readIndex.load(std::memory_order_relaxed);
-
-        // Must acquire writeIndex to see producer's latest data
-        if (currentRead == writeIndex.load(std::memory_order_acquire))
-            return false; // Buffer empty
-
-        std::copy(buffer[currentRead].begin(), buffer[currentRead].begin() + numSamples, dest);
-        // Release: ensure buffer[] reads complete before index advances
-        readIndex.store((currentRead + 1) % Size, std::memory_order_release);
-        return true;
-    }
-
-private:
-    std::array<std::array<T, 2048>, Size> buffer;
-    std::atomic<size_t> writeIndex;
-    std::atomic<size_t> readIndex;
-};
-
-//==============================================================================
-/**
- * K-Weighting Filter (ITU-R BS.1770-4)
- * Used for LUFS measurement
- */
-class KWeightingFilter
-{
-public:
-    KWeightingFilter() = default;
-
-    void prepare(double sampleRate)
-    {
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sampleRate;
-        spec.maximumBlockSize = 512;
-        spec.numChannels = 1;
-
-        // ITU-R BS.1770-4 K-weighting: high-shelf @ 1500Hz +4dB, highpass @ 38Hz
-        // Using IIR filters for proper high-shelf
-        auto highShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-            sampleRate, 1500.0f, 0.707f, juce::Decibels::decibelsToGain(4.0f));
-        highShelf.coefficients = highShelfCoeffs;
-
-        auto highPassCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(
-            sampleRate, 38.0f, 0.5f);
-        highPass.coefficients = highPassCoeffs;
-
-        highShelf.prepare(spec);
-        highPass.prepare(spec);
-    }
-
-    float processSample(float sample)
-    {
-        return highPass.processSample(highShelf.processSample(sample));
-    }
-
-    void reset()
-    {
-        highShelf.reset();
-        highPass.reset();
-    }
-
-private:
-    juce::dsp::IIR::Filter<float> highShelf;
-    juce::dsp::IIR::Filter<float> highPass;
-};
-
 //==============================================================================
 /**
  * Main Audio Processor
@@ -168,6 +85,10 @@ public:
     std::atomic<float> peakLevelL { -90.0f };
     std::atomic<float> peakLevelR { -90.0f };
 
+    // True peak levels (dBTP, BS.1770-4 4x oversampled)
+    std::atomic<float> truePeakLevelL { -90.0f };
+    std::atomic<float> truePeakLevelR { -90.0f };
+
     // RMS levels (dBFS)
     std::atomic<float> rmsLevelL { -90.0f };
     std::atomic<float> rmsLevelR { -90.0f };
@@ -181,7 +102,10 @@ public:
     // LUFS Integrated (from start of playback)
     std::atomic<float> lufsIntegrated { -70.0f };
 
-    // LU Range (EBU Tech 3342) — calculated on timer thread
+    // Surround buses feed every channel into the BS.1770-4 weighted sum above
+    static constexpr int maxLoudnessChannels = LoudnessEngine::kMaxChannels;
+
+    // LU Range (EBU Tech 3342) — streaming short-term histogram, audio thread
     std::atomic<float> luRange { 0.0f };
 
     // Phase Correlation (-1.0 to +1.0)
@@ -191,26 +115,81 @@ public:
     std::atomic<float> rmsLevelMid { -90.0f };
     std::atomic<float> rmsLevelSide { -90.0f };
 
-    // 3-Band Frequency RMS (LOW/MID/HIGH)
+    // 3-Band Frequency RMS (LOW/MID/HIGH) — first, second and last band of the crossover bank
     std::atomic<float> rmsLevelLow { -90.0f };   // 20-250Hz
     std::atomic<float> rmsLevelMid3Band { -90.0f };  // 250-2kHz (renamed to avoid conflict)
     std::atomic<float> rmsLevelHigh { -90.0f };  // 2k-20kHz
 
+    // Multiband RMS (Linkwitz-Riley bank, 2..8 bands, lowest first)
+    static constexpr int maxMeterBands = CrossoverFilterBank::kMaxBands;
+    std::array<std::atomic<float>, maxMeterBands> bandRmsLevels {};
+    std::atomic<int> numMeterBands { 3 };
+
+    // Band edges in Hz, ascending (GUI thread; applied at the next processBlock).
+    // Saved with the plugin state, so host sessions restore them.
+    void setMeterBandCrossovers(const float* frequencies, int numCrossovers);
+    // Last requested edges (not necessarily applied yet); returns how many
+    int getMeterBandCrossovers(float* frequencies) const noexcept;
+
+    // All of the above from one audio block, published once per processBlock.
+    // Message thread only. Whoever owns a GUI frame calls updateMeterSnapshot()
+    // once at its start (the editors through a FrameScheduler::FrameStart,
+    // timer-driven pages in their timer); everything drawn in that frame
+    // reads the same copy through getMeterSnapshot(), with no seqlock traffic.
+    const MeterSnapshot& updateMeterSnapshot();
+    const MeterSnapshot& getMeterSnapshot() const noexcept   { return guiMeterSnapshot; }
+
     // Audio recorder (public — GUI thread starts/stops, audio thread pushes samples)
     AudioRecorder audioRecorder;
 
+    // Callback timing and drop counters (public — diagnostics panel, JSON export)
+    EngineTelemetry telemetry;
+
+    // Components subscribe to the optional analyses they display (goniometer
+    // samples, bands, spectrum); processBlock skips the ones nobody reads
+    AnalysisDemand analysisDemand;
+
 #if JUCE_MAC && JucePlugin_Build_Standalone
     // System audio capture via CoreAudio Process Tap (macOS 14.2+)
     std::unique_ptr<SystemAudioCapture> systemAudioCapture;
     std::atomic<bool> useSystemAudio { false };
+
+    // Live DeepFilterNet3 denoise of the input (mic or system audio) before
+    // metering; message thread. Loads the models on first use, false if
+    // they're missing. Reports the stream's delay with setLatencySamples().
+    bool setLiveDenoiseEnabled(bool shouldDenoise);
+    bool isLiveDenoiseEnabled() const noexcept   { return liveDenoiseWanted; }
 #endif
 
-    // Retroactive recording — always-on audio history buffer
+    // Retroactive recording — audio history buffer, opt-in per instance
     AudioHistoryBuffer audioHistoryBuffer;
 
-    // Rewind duration setting (seconds): 30, 60, 120, 300
+    // Enabling reserves history memory from the process-wide budget; the
+    // standalone app enables it at start, plugin instances when the rewind UI opens
+    void setRewindEnabled(bool shouldBeEnabled)   { audioHistoryBuffer.setEnabled(shouldBeEnabled); }
+    bool isRewindEnabled() const noexcept         { return audioHistoryBuffer.isEnabled(); }
+
+    // Whole-session metering timeline (10 Hz records on disk), opt-in per
+    // instance like rewind: the standalone app logs from start, plugin
+    // instances once their editor has been opened
+    LoudnessTimelineLog timelineLog;
+    void setTimelineLoggingEnabled(bool shouldBeEnabled)   { timelineLog.setEnabled(shouldBeEnabled); }
+
+    // Rewind duration setting (seconds): 30, 60, 120, 300, 1800, 3600
     std::atomic<int> rewindSeconds { 60 };
 
+    // Message thread: longer than the raw ring holds switches history to the
+    // compressed store, longer than that to the mapped file ring
+    // (drops history captured so far)
+    void setRewindSeconds(int seconds)
+    {
+        using Mode = AudioHistoryBuffer::StorageMode;
+        rewindSeconds.store(seconds, std::memory_order_relaxed);
+        audioHistoryBuffer.setStorageMode(seconds > AudioHistoryBuffer::kCompressedCapacitySeconds - 5 ? Mode::diskBacked
+                                        : seconds > AudioHistoryBuffer::kCapacitySeconds - 5           ? Mode::compressed
+                                                                                                       : Mode::raw);
+    }
+
     // Shared audio device manager (set by StandaloneApp, used by AudioLab preview)
     // Avoids creating a second CoreAudio device that conflicts with the main app.
     juce::AudioDeviceManager* sharedDeviceManager = nullptr;
@@ -219,106 +198,81 @@ public:
     void exportRetrospectiveRecording(int secondsToSave = 60,
                                       const juce::File& exportDir = {});
 
-    // FFT Data (lock-free FIFOs — separate channels for Spectrum and Spectrogram)
-    LockFreeFIFO<float, 256> fftFifoL;            // Spectrum analyzer
-    LockFreeFIFO<float, 256> fftFifoR;            // Spectrum analyzer
-    LockFreeFIFO<float, 256> fftFifoSpectrogramL; // Spectrogram (independent)
-
-    // Stereo Image Sample Buffer (for Goniometer/Lissajous)
-    // Stores recent raw (L, R) sample pairs for XY plotting
-    static constexpr int stereoSampleBufferSize = 1024;
-    LockFreeFIFO<float, 256> stereoSampleFifoL;  // Left channel samples
-    LockFreeFIFO<float, 256> stereoSampleFifoR;  // Right channel samples
+    // FFT Engine (runs on SpectrumAnalysisWorker)
+    static constexpr int fftOrder = SpectrumAnalysisWorker::fftOrder; // 2^12 = 4096
+    static constexpr int fftSize = SpectrumAnalysisWorker::fftSize;
 
-    // FFT Engine
-    static constexpr int fftOrder = 12; // 2^12 = 4096
-    static constexpr int fftSize = 1 << fftOrder;
+    // FFT Data (broadcast rings — each frame published once by the analysis
+    // worker; Spectrum, Spectrogram etc. follow with their own Reader cursor)
+    using SpectrumRing = SpectrumAnalysisWorker::SpectrumRing;
+    SpectrumRing spectrumFramesL;
+    SpectrumRing spectrumFramesR;
 
-    /**
-     * Calculate LRA in real-time (EBU Tech 3342)
-     * Call from GUI timer thread, NOT audio thread!
-     */
-    void calculateLRARealtime();
+    // Multi-resolution log-frequency frames (20 Hz - 20 kHz, same broadcast
+    // scheme): fast treble, few-Hz bass resolution; Spectrum reads these
+    using LogSpectrumRing = SpectrumAnalysisWorker::LogSpectrumRing;
+    static constexpr int numLogSpectrumBins = SpectrumAnalysisWorker::numLogBins;
+    LogSpectrumRing logSpectrumFramesL;
+    LogSpectrumRing logSpectrumFramesR;
 
-    /**
-     * Push a Short-Term LUFS sample into the LRA history pool.
-     * Called from GUI timer every ~100ms.
-     */
-    void pushShortTermLUFSForLRA(float stLufs);
+    // Stereo Image Sample Buffer (for Goniometer/Lissajous)
+    // Stores recent raw (L, R) sample pairs for XY plotting, 512 per slot
+    static constexpr int stereoSampleBufferSize = 1024;
+    static constexpr int stereoBatchSize = 512;
+    using StereoSampleFIFO = LockFreeFIFO<float, 64, stereoBatchSize>;
+    StereoSampleFIFO stereoSampleFifoL;  // Left channel samples
+    StereoSampleFIFO stereoSampleFifoR;  // Right channel samples
 
 private:
     //==============================================================================
     // Internal DSP state (WRITE-ONLY from audio thread)
     //==============================================================================
 
-    // K-Weighting filters for LUFS
-    KWeightingFilter kWeightingL;
-    KWeightingFilter kWeightingR;
-
-    // 3-Band frequency filters (LOW/MID/HIGH)
-    // LOW: 20-250Hz, MID: 250-2kHz, HIGH: 2k-20kHz
-    juce::dsp::IIR::Filter<float> lowPassL_250Hz;
-    juce::dsp::IIR::Filter<float> lowPassR_250Hz;
-    juce::dsp::IIR::Filter<float> midHpL_250Hz;   // MID band: HP @ 250Hz
-    juce::dsp::IIR::Filter<float> midHpR_250Hz;
-    juce::dsp::IIR::Filter<float> midLpL_2kHz;   // MID band: LP @ 2kHz
-    juce::dsp::IIR::Filter<float> midLpR_2kHz;
-    juce::dsp::IIR::Filter<float> highPassL_2kHz;
-    juce::dsp::IIR::Filter<float> highPassR_2kHz;
-
-    // LUFS circular buffer (400ms = 19200 samples at 48kHz)
-    static constexpr int lufsBufferSize = 32768;
-    std::array<float, lufsBufferSize> lufsBufferL;
-    std::array<float, lufsBufferSize> lufsBufferR;
-    int lufsBufferIndex = 0;
-
-    // FFT accumulation ring buffer (75% overlap for ~43Hz FFT frame rate)
-    // performFrequencyOnlyForwardTransform requires fftSize * 2 working space
-    std::array<float, fftSize> fftRingL;
-    std::array<float, fftSize> fftRingR;
-    int fftRingIndex = 0;
-    int fftSamplesSinceLastPush = 0;
-    int spectrogramSamplesSinceLastPush = 0;
-    static constexpr int fftHopSize = fftSize / 4;  // 75% overlap → hop = 1024
+    // Momentary / Short-Term loudness (K-weighting + 100ms sub-block sums)
+    LoudnessEngine loudnessEngine;
+    bool meterAllChannelsForLoudness = false;  // true for surround main bus (plugin)
+
+    // True-peak interpolators (4x polyphase FIR, state carried across blocks)
+    TruePeakFilter truePeakFilterL;
+    TruePeakFilter truePeakFilterR;
+
+    // Multiband crossover bank (LOW/MID/HIGH by default: 250 Hz, 2 kHz)
+    CrossoverFilterBank bandFilterBank;
+    std::array<std::atomic<float>, CrossoverFilterBank::kMaxCrossovers> requestedCrossovers {};
+    std::atomic<int> requestedNumCrossovers { 2 };
+    std::atomic<juce::uint32> crossoverRequestVersion { 0 };
+    juce::uint32 appliedCrossoverVersion = 0;
+    bool bandsRunning = false;   // audio thread: bank state is current (reset when resuming)
+
+    // FFT analysis worker (75% overlap, ~43Hz frame rate; audio thread only copies samples)
 #if JUCE_IOS
-    static constexpr int spectrogramHopSize = fftSize / 8; // 87.5% overlap -> hop = 512 for smoother iPhone waterfall
+    static constexpr int spectrumFrameHopSize = fftSize / 8; // 87.5% overlap -> hop = 512 for smoother iPhone waterfall
 #else
-    static constexpr int spectrogramHopSize = fftHopSize;
+    static constexpr int spectrumFrameHopSize = SpectrumAnalysisWorker::spectrumHopSize;
 #endif
+    SpectrumAnalysisWorker spectrumWorker { spectrumFramesL, spectrumFramesR,
+                                            logSpectrumFramesL, logSpectrumFramesR, spectrumFrameHopSize };
 
-    // Temporary FFT working buffer (in-place transform needs fftSize * 2)
-    std::array<float, fftSize * 2> fftWorkBuffer;
-
-    // FFT engine
-    juce::dsp::FFT fft { fftOrder };
-    juce::dsp::WindowingFunction<float> window { fftSize, juce::dsp::WindowingFunction<float>::hann };
-
-    // 🎯 Stereo sample accumulation buffers (batch push to FIFO)
-    std::array<float, 512> tempStereoBufL;
-    std::array<float, 512> tempStereoBufR;
+    // 🎯 Stereo sample batch, written in place into reserved FIFO slots
+    float* stereoSlotL = nullptr;
+    float* stereoSlotR = nullptr;
     int tempStereoIndex = 0;
 
+    // Coherent meter state: audio thread publishes, GUI frame reads once
+    SeqlockSnapshot<MeterSnapshot> meterSnapshot;
+    MeterSnapshot guiMeterSnapshot;
+    juce::uint64 meterBlockCounter = 0;
+
     // Sample rate
     double currentSampleRate = 48000.0;
 
-    // Short-Term LUFS circular buffer (3s window = ~144000 samples at 48kHz)
-    static constexpr int stLufsBufferSize = 196608;  // ~4s at 48kHz for safety
-    std::array<float, stLufsBufferSize> stLufsBufferL;
-    std::array<float, stLufsBufferSize> stLufsBufferR;
-    int stLufsBufferIndex = 0;
-
-    // Integrated LUFS gating (BS.1770-4 with absolute + relative gating)
-    // Lock-free: all data stays on audio thread. Only lufsIntegrated atomic is read by GUI.
-    static constexpr int integratedBlockMaxCount = 8192;   // ~55 min at 400ms blocks
-    float integratedBlockStorage[integratedBlockMaxCount];  // Fixed-size ring (no allocation)
-    int integratedBlockCount = 0;                          // Number of blocks stored
-    int integratedBlockSampleCount = 0;                    // Counter for 400ms blocks
-    static constexpr int integratedBlockSamples400ms = 19200; // at 48kHz
-
-    // LRA history pool (Short-Term LUFS samples, ~100ms intervals, up to 5 min)
-    std::vector<float> lraHistory;
-    std::mutex lraMutex;
-    static constexpr int lraMaxSamples = 3000; // 5 min at 100ms intervals
+#if JUCE_MAC && JucePlugin_Build_Standalone
+    // Model before stream: the stream's thread uses the model until it stops
+    std::unique_ptr<DeepFilterProcessor> liveDenoiseModel;
+    std::unique_ptr<DeepFilterRealtime> liveDenoise;
+    bool liveDenoiseWanted = false;
+    void prepareLiveDenoise(double sampleRate, int samplesPerBlock);
+#endif
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GOODMETERAudioProcessor)
@@ -0,0 +1,359 @@
+/*
+  ==============================================================================
+    PolyphaseResampler.h
+    GOODMETER - Windowed-sinc sample rate conversion, offline and streaming
+
+    One Kaiser-windowed sinc (64 taps at the lower of the two rates, about
+    80 dB stopband, passband to 0.41 × that rate) split into polyphase rows
+    once, in the constructor:
+
+      - Integer rates whose ratio reduces to at most kMaxPhases phases
+        (44.1 ↔ 48, 88.2/96/192 → 48, 8/16/22.05 → 48, ...) step through
+        the rows exactly with an integer phase accumulator
+      - Anything else uses kMaxPhases rows and blends the two either side
+        of each output's position
+
+    A variable-ratio resampler always takes the blended path, so its step
+    can be trimmed while streaming (setRatioTrim, for clock drift).
+
+    Each output is one dot product of a row with the input history
+    (vDSP_dotpr on Apple, four-way unrolled elsewhere): no division, no
+    per-sample allocation.
+
+    resample() converts a whole buffer with the filter delay removed, so
+    output sample j sits at input time j × source/target. A streaming
+    resampler gives the same timing, and only needs getLatencyInputSamples()
+    of input ahead of each output before it can produce that output.
+
+    Thread safety model:
+      - The tables are read-only after construction; process() is meant
+        for one thread at a time (each stream keeps its own history).
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <Accelerate/Accelerate.h>
+#endif
+
+class PolyphaseResampler
+{
+public:
+    static constexpr int kMaxPhases = 1024;
+
+    /** maxInputBlock sizes the history; process() splits larger calls.
+        variableRatio allows setRatioTrim(). Allocates, so not on the audio thread. */
+    PolyphaseResampler(double sourceRate, double targetRate, int numChannelsToUse, int maxInputBlock = 4096,
+                       bool variableRatio = false)
+        : numChannels(juce::jmax(1, numChannelsToUse)),
+          blockCapacity(juce::jmax(1, maxInputBlock))
+    {
+        jassert(sourceRate > 0.0 && targetRate > 0.0);
+        step = sourceRate / targetRate;
+        nominalStep = step;
+
+        // Exact rational ratio when both rates are whole Hz and it stays small
+        const auto src = static_cast<long long>(std::llround(sourceRate));
+        const auto dst = static_cast<long long>(std::llround(targetRate));
+        const bool wholeHz = std::abs(sourceRate - (double) src) < 1.0e-6
+                          && std::abs(targetRate - (double) dst) < 1.0e-6;
+        const auto divisor = wholeHz ? std::gcd(src, dst) : 0;
+
+        if (! variableRatio && divisor > 0 && dst / divisor <= kMaxPhases)
+        {
+            upFactor = static_cast<int>(dst / divisor);
+            downFactor = static_cast<int>(src / divisor);
+            exact = true;
+            numPhases = upFactor;
+        }
+        else
+        {
+            exact = false;
+            numPhases = kMaxPhases;
+        }
+
+        buildTable(juce::jmin(1.0, 1.0 / step));
+
+        history.resize(static_cast<size_t>(numChannels));
+        for (auto& channel : history)
+            channel.assign(static_cast<size_t>(numTaps + blockCapacity), 0.0f);
+
+        reset();
+    }
+
+    //==========================================================================
+    /** Convert a whole buffer. Output length is numSamples × target / source. */
+    static juce::AudioBuffer<float> resample(const juce::AudioBuffer<float>& source,
+                                             double sourceRate, double targetRate)
+    {
+        const int numIn = source.getNumSamples();
+        const int numOut = static_cast<int>(static_cast<double>(numIn) * targetRate / sourceRate);
+        juce::AudioBuffer<float> result(source.getNumChannels(), juce::jmax(0, numOut));
+        if (numOut <= 0 || source.getNumChannels() == 0)
+            return result;
+
+        PolyphaseResampler resampler(sourceRate, targetRate, source.getNumChannels());
+        const std::vector<float> silence(static_cast<size_t>(resampler.getLatencyInputSamples() + 1), 0.0f);
+        std::vector<const float*> tail(static_cast<size_t>(source.getNumChannels()), silence.data());
+
+        auto written = resampler.process(source.getArrayOfReadPointers(), numIn,
+                                         result.getArrayOfWritePointers(), numOut);
+
+        // Flush the filter with silence so the last outputs see their lookahead
+        if (written < numOut)
+        {
+            std::vector<float*> rest;
+            for (int ch = 0; ch < source.getNumChannels(); ++ch)
+                rest.push_back(result.getWritePointer(ch) + written);
+            written += resampler.process(tail.data(), static_cast<int>(silence.size()), rest.data(), numOut - written);
+        }
+
+        jassert(written == numOut);
+        return result;
+    }
+
+    //==========================================================================
+    /** Back to silence before the first input sample. */
+    void reset()
+    {
+        // numTaps / 2 - 1 zeros ahead of input 0 centre the first output on it
+        buffered = numTaps / 2 - 1;
+        for (auto& channel : history)
+            std::fill(channel.begin(), channel.end(), 0.0f);
+        readPos = 0;
+        phase = 0;
+        fraction = 0.0;
+    }
+
+    double getRatio() const noexcept               { return 1.0 / step; }     // target / source
+
+    /** Variable-ratio only: consume trim × the nominal input per output
+        (above 1 drains the input faster). Real-time safe. */
+    void setRatioTrim(double trim) noexcept
+    {
+        jassert(! exact);
+        if (! exact)
+            step = nominalStep * trim;
+    }
+    int getNumChannels() const noexcept            { return numChannels; }
+
+    /** Input taken in but not yet passed by the output position, lookahead
+        included (fractional: the position moves in sub-sample steps). */
+    double getBufferedInputSamples() const noexcept
+    {
+        const double position = exact ? readPos + static_cast<double>(phase) / upFactor
+                                      : readPos + fraction;
+        return buffered - position;
+    }
+
+    /** Input samples each output waits for beyond its own time. */
+    int getLatencyInputSamples() const noexcept    { return numTaps / 2; }
+
+    /** Most process() can return for numInput samples, whatever is buffered
+        (less than one output's taps ever stays behind between calls). */
+    int getMaxOutputSamples(int numInput) const noexcept
+    {
+        return static_cast<int>(std::ceil(juce::jmax(0, numInput) / step)) + 2;
+    }
+
+    /** Input process() still needs before it can return numOutput samples
+        (0 if what's buffered already covers them). */
+    int getInputSamplesNeeded(int numOutput) const noexcept
+    {
+        if (numOutput <= 0)
+            return 0;
+
+        // Input index of the last tap of output numOutput - 1
+        double lastStart = 0.0;
+        if (exact)
+            lastStart = readPos + std::floor((phase + (double) (numOutput - 1) * downFactor) / upFactor);
+        else
+            lastStart = std::floor(readPos + fraction + (numOutput - 1) * step);
+
+        return juce::jmax(0, static_cast<int>(lastStart) + numTaps - buffered);
+    }
+
+    /** Streaming: take numInput samples per channel, write up to maxOutput
+        converted samples, keep the rest of the history for next time.
+        Returns the number of samples written per channel. With maxOutput
+        below getMaxOutputSamples(numInput), input that no longer fits the
+        history is dropped. */
+    int process(const float* const* input, int numInput, float* const* output, int maxOutput) noexcept
+    {
+        int written = render(output, 0, maxOutput);
+        compact();
+
+        for (int done = 0; done < numInput;)
+        {
+            const int chunk = juce::jmin(numInput - done, static_cast<int>(history[0].size()) - buffered);
+            if (chunk <= 0)
+                break;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::copy_n(input[ch] + done, chunk, history[(size_t) ch].data() + buffered);
+            buffered += chunk;
+            done += chunk;
+
+            written += render(output, written, maxOutput - written);
+            compact();
+        }
+        return written;
+    }
+
+private:
+    //==========================================================================
+    /** Outputs from the buffered history while the taps are all there. */
+    int render(float* const* output, int offset, int maxOutput) noexcept
+    {
+        int count = 0;
+        while (count < maxOutput && readPos + numTaps <= buffered)
+        {
+            if (exact)
+            {
+                const float* row = table.data() + static_cast<size_t>(phase * numTaps);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    output[ch][offset + count] = dot(row, history[(size_t) ch].data() + readPos);
+
+                phase += downFactor;
+                readPos += phase / upFactor;
+                phase %= upFactor;
+            }
+            else
+            {
+                // Position between two rows of the kMaxPhases table
+                const double rowPos = fraction * numPhases;
+                const int rowIndex = juce::jmin(numPhases - 1, static_cast<int>(rowPos));
+                const auto blend = static_cast<float>(rowPos - rowIndex);
+                const float* rowA = table.data() + static_cast<size_t>(rowIndex * numTaps);
+                const float* rowB = rowA + numTaps;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    const float* x = history[(size_t) ch].data() + readPos;
+                    const float a = dot(rowA, x);
+                    output[ch][offset + count] = a + blend * (dot(rowB, x) - a);
+                }
+
+                fraction += step;
+                const auto whole = static_cast<int>(fraction);
+                readPos += whole;
+                fraction -= whole;
+            }
+
+            ++count;
+        }
+        return count;
+    }
+
+    /** Slide the unread history back to the start of the buffer. */
+    void compact() noexcept
+    {
+        const int keepFrom = juce::jmin(readPos, buffered);
+        if (keepFrom <= 0)
+            return;
+
+        for (auto& channel : history)
+            std::copy(channel.begin() + keepFrom, channel.begin() + buffered, channel.begin());
+
+        buffered -= keepFrom;
+        readPos -= keepFrom;
+    }
+
+    float dot(const float* row, const float* x) const noexcept
+    {
+       #if JUCE_MAC || JUCE_IOS
+        float result = 0.0f;
+        vDSP_dotpr(row, 1, x, 1, &result, static_cast<vDSP_Length>(numTaps));
+        return result;
+       #else
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        for (int k = 0; k < numTaps; k += 4)     // numTaps is a multiple of 4
+        {
+            s0 += row[k]     * x[k];
+            s1 += row[k + 1] * x[k + 1];
+            s2 += row[k + 2] * x[k + 2];
+            s3 += row[k + 3] * x[k + 3];
+        }
+        return (s0 + s1) + (s2 + s3);
+       #endif
+    }
+
+    //==========================================================================
+    /** Rows of the Kaiser-windowed sinc; cutoff is relative to the source
+        rate, so downsampling widens the filter by the same factor. */
+    void buildTable(double cutoffScale)
+    {
+        static constexpr int kHalfTaps = 32;
+        static constexpr double kCutoff = 0.45;     // of the lower rate
+        static constexpr double kBeta = 8.0;
+
+        const int halfTaps = static_cast<int>(std::ceil(kHalfTaps / cutoffScale));
+        numTaps = 2 * ((halfTaps + 1) / 2) * 2;      // even, multiple of 4
+        const double cutoff = kCutoff * cutoffScale;
+        const double half = numTaps / 2.0;
+
+        auto besselI0 = [](double x)
+        {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        };
+        const double window0 = besselI0(kBeta);
+
+        // numPhases + 1 rows: the last is row 0 one input later, for blending
+        table.assign(static_cast<size_t>((numPhases + 1) * numTaps), 0.0f);
+        for (int p = 0; p <= numPhases; ++p)
+        {
+            const double frac = static_cast<double>(p) / numPhases;
+            float* row = table.data() + static_cast<size_t>(p * numTaps);
+            double sum = 0.0;
+            std::vector<double> taps(static_cast<size_t>(numTaps));
+
+            for (int k = 0; k < numTaps; ++k)
+            {
+                // Distance of tap k from the output's position (tap half - 1 + frac)
+                const double d = k - (half - 1.0) - frac;
+                const double x = 2.0 * cutoff * d;
+                const double sinc = std::abs(x) < 1.0e-12 ? 1.0
+                                  : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                const double r = d / half;
+                const double w = std::abs(r) >= 1.0 ? 0.0 : besselI0(kBeta * std::sqrt(1.0 - r * r)) / window0;
+                taps[(size_t) k] = sinc * w;
+                sum += taps[(size_t) k];
+            }
+
+            // Unity gain at DC for every phase
+            for (int k = 0; k < numTaps; ++k)
+                row[k] = static_cast<float>(taps[(size_t) k] / sum);
+        }
+    }
+
+    //==========================================================================
+    const int numChannels;
+    const int blockCapacity;
+    double step = 1.0;                      // input samples per output
+    double nominalStep = 1.0;               // source / target, before any trim
+    bool exact = false;
+    int upFactor = 1, downFactor = 1;       // exact: target / source = up / down
+    int numPhases = 1;
+    int numTaps = 4;
+    std::vector<float> table;               // [numPhases + 1][numTaps]
+
+    std::vector<std::vector<float>> history;   // [channel][numTaps + blockCapacity]
+    int buffered = 0;                       // valid history samples
+    int readPos = 0;                        // first tap of the next output
+    int phase = 0;                          // exact: row of the next output
+    double fraction = 0.0;                  // otherwise: position past readPos, [0, 1)
+
+    JUCE_DECLARE_NON_COPYABLE(PolyphaseResampler)
+};
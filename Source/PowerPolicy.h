@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+    PowerPolicy.h
+    GOODMETER - Trade display smoothness for heat and battery when asked to
+
+    A metering app left running on a phone or a laptop on battery should
+    not keep the FFT and the 60 Hz UI at full speed while the system is
+    throttling. The policy polls NSProcessInfo once a second:
+
+      - thermalState serious, or Low Power Mode on: Level::reduced
+        (UI at 30 Hz, spectrum hop ×2)
+      - thermalState critical: Level::minimal (UI at 20 Hz, spectrum hop ×4)
+      - otherwise Level::full
+
+    The UI rate goes straight to the FrameScheduler; analysis owners
+    (AnalysisDemand) listen for the level. Loudness metering is never
+    throttled. NSProcessInfo is reached through the Objective-C runtime, so
+    this stays a plain C++ header; other platforms always report full.
+
+    Polling only runs while someone listens, so the singleton holds no live
+    timer at shutdown.
+
+    Thread safety model:
+      - Message thread only (the level is also readable from any thread)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FrameScheduler.h"
+#include <atomic>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <objc/message.h>
+ #include <objc/runtime.h>
+#endif
+
+class PowerPolicy : private juce::Timer
+{
+public:
+    enum class Level
+    {
+        full = 0,
+        reduced,
+        minimal
+    };
+
+    struct Listener
+    {
+        virtual ~Listener() = default;
+
+        /** Message thread, after the level changed. */
+        virtual void powerLevelChanged(Level newLevel) = 0;
+    };
+
+    static PowerPolicy& getInstance()
+    {
+        static PowerPolicy policy;
+        return policy;
+    }
+
+    Level getLevel() const noexcept     { return level.load(std::memory_order_relaxed); }
+
+    static int getFrameDivider(Level l) noexcept        { return l == Level::minimal ? 3 : l == Level::reduced ? 2 : 1; }
+    static int getSpectrumHopFactor(Level l) noexcept   { return l == Level::minimal ? 4 : l == Level::reduced ? 2 : 1; }
+
+    //==========================================================================
+    void addListener(Listener* listener)
+    {
+        listeners.add(listener);
+        if (! isTimerRunning())
+        {
+            update();
+            startTimer(kPollMs);
+        }
+    }
+
+    void removeListener(Listener* listener)
+    {
+        listeners.remove(listener);
+        if (listeners.isEmpty())
+        {
+            stopTimer();
+            apply(Level::full);
+        }
+    }
+
+private:
+    static constexpr int kPollMs = 1000;
+
+    PowerPolicy() = default;
+    ~PowerPolicy() override = default;
+
+    void timerCallback() override   { update(); }
+
+    void update()                   { apply(queryPlatform()); }
+
+    void apply(Level newLevel)
+    {
+        if (newLevel == level.exchange(newLevel, std::memory_order_relaxed))
+            return;
+
+        FrameScheduler::getInstance().setFrameDivider(getFrameDivider(newLevel));
+        listeners.call([newLevel] (Listener& l) { l.powerLevelChanged(newLevel); });
+    }
+
+    static Level queryPlatform()
+    {
+#if JUCE_MAC || JUCE_IOS
+        using GetObject = id (*)(id, SEL);
+        using GetInteger = long (*)(id, SEL);
+        using GetBool = BOOL (*)(id, SEL);
+        using RespondsTo = BOOL (*)(id, SEL, SEL);
+
+        auto* infoClass = reinterpret_cast<id>(objc_getClass("NSProcessInfo"));
+        if (infoClass == nullptr)
+            return Level::full;
+
+        const id info = reinterpret_cast<GetObject>(objc_msgSend)(infoClass, sel_registerName("processInfo"));
+        auto respondsTo = [info] (const char* selector)
+        {
+            return info != nullptr
+                && reinterpret_cast<RespondsTo>(objc_msgSend)(info, sel_registerName("respondsToSelector:"),
+                                                              sel_registerName(selector));
+        };
+
+        // NSProcessInfoThermalState: nominal, fair, serious, critical
+        long thermal = 0;
+        if (respondsTo("thermalState"))
+            thermal = reinterpret_cast<GetInteger>(objc_msgSend)(info, sel_registerName("thermalState"));
+
+        const bool lowPower = respondsTo("isLowPowerModeEnabled")
+                           && reinterpret_cast<GetBool>(objc_msgSend)(info, sel_registerName("isLowPowerModeEnabled"));
+
+        if (thermal >= 3)
+            return Level::minimal;
+        if (thermal >= 2 || lowPower)
+            return Level::reduced;
+#endif
+        return Level::full;
+    }
+
+    //==========================================================================
+    std::atomic<Level> level { Level::full };
+    juce::ListenerList<Listener> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE(PowerPolicy)
+};
@@ -0,0 +1,268 @@
+/*
+  ==============================================================================
+    ProcessBlockBenchmark.h
+    GOODMETER - Headless processBlock sweep for catching engine regressions
+
+    Run from the standalone binary, no audio device or window needed:
+
+        GOODMETER --benchmark-process-block [--block-sizes 32,64,...]
+                  [--sample-rates 44100,...] [--channels 2,6,8,12] [--seconds 3]
+
+    Every combination of block size, sample rate and channel layout drives a
+    freshly prepared GOODMETERAudioProcessor with the same programme: the
+    Audio Doctor sine, pink noise and log sweep generators back to back, so
+    tonal, broadband and moving content are all covered. Per case it reports
+    ns/sample (best pass), the worst and 99th percentile single callback, the
+    share of the real-time budget the worst callback used, and heap
+    allocations made on the calling thread inside processBlock.
+
+    Only layouts isBusesLayoutSupported() accepts are meaningful: 2 (stereo),
+    6 (5.1), 8 (7.1) and 12 (7.1.4). Others are reported as skipped.
+
+    Allocation counting needs the global operator new replacement defined in
+    StandaloneApp.cpp, which is only compiled in when GOODMETER_BENCHMARKS=1
+    (see AllocationCounter.h; shipping builds never replace the global
+    allocator). Without it the counters stay at zero and the report says
+    "allocationCounting": false.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "AudioDoctorAnalysis.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace goodmeter
+{
+namespace benchmark
+{
+
+//==============================================================================
+struct ProcessBlockSweepOptions
+{
+    std::vector<int> blockSizes { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    std::vector<double> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    std::vector<int> channelCounts { 2, 6, 8, 12 };
+    double secondsPerSignal = 1.0;
+    int passes = 3;
+};
+
+/** Main bus layout for a channel count, or disabled() if the meter rejects it. */
+inline juce::AudioChannelSet layoutForChannelCount(int channels)
+{
+    switch (channels)
+    {
+        case 2:  return juce::AudioChannelSet::stereo();
+        case 6:  return juce::AudioChannelSet::create5point1();
+        case 8:  return juce::AudioChannelSet::create7point1();
+        case 12: return juce::AudioChannelSet::create7point1point4();
+        default: return juce::AudioChannelSet::disabled();
+    }
+}
+
+//==============================================================================
+/** Sine, pink noise and sweep from the Audio Doctor generators, spread over
+ *  `channels` with a small per-channel gain and offset so channels differ. */
+inline juce::AudioBuffer<float> makeProcessBlockProgramme(double sampleRate, int channels, double secondsPerSignal)
+{
+    using namespace goodmeter::audio_doctor;
+
+    const Asset assets[] = {
+        makeSineAsset(997.0, sampleRate, secondsPerSignal, -6.0),
+        makeNoiseAsset(true, sampleRate, secondsPerSignal, -12.0),
+        makeSweepAsset(sampleRate, secondsPerSignal, 20.0, juce::jmin(20000.0, sampleRate * 0.45), -6.0)
+    };
+
+    int total = 0;
+    for (const auto& asset : assets)
+        total += asset.buffer.getNumSamples();
+
+    juce::AudioBuffer<float> programme(channels, juce::jmax(1, total));
+    programme.clear();
+
+    int start = 0;
+    for (const auto& asset : assets)
+    {
+        const int n = asset.buffer.getNumSamples();
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            const int source = ch % asset.buffer.getNumChannels();
+            const int offset = (ch * 37) % juce::jmax(1, n);   // decorrelate the copies
+            const float gain = 1.0f - 0.05f * static_cast<float>(ch);
+
+            programme.copyFrom(ch, start, asset.buffer, source, offset, n - offset, gain);
+            if (offset > 0)
+                programme.copyFrom(ch, start + n - offset, asset.buffer, source, 0, offset, gain);
+        }
+        start += n;
+    }
+
+    return programme;
+}
+
+//==============================================================================
+struct ProcessBlockCaseResult
+{
+    bool supported = false;
+    double nsPerSample = 0.0;
+    double worstCallbackMicros = 0.0;
+    double p99CallbackMicros = 0.0;
+    juce::uint64 allocations = 0;
+    int allocatingCallbacks = 0;
+    int callbacks = 0;
+};
+
+/** One block size / rate / layout: best-of-N ns/sample, per-callback worst case. */
+inline ProcessBlockCaseResult runProcessBlockCase(const juce::AudioBuffer<float>& programme,
+                                                  int blockSize, double sampleRate, int passes)
+{
+    ProcessBlockCaseResult result;
+    const int channels = programme.getNumChannels();
+    const auto layout = layoutForChannelCount(channels);
+    if (layout.isDisabled())
+        return result;
+
+    GOODMETERAudioProcessor processor;
+
+    // Worst case: every optional analysis running, as with all meters on screen
+    using Analysis = AnalysisDemand::Analysis;
+    const AnalysisDemand::Subscription stereoSamples { processor.analysisDemand, Analysis::stereoSamples };
+    const AnalysisDemand::Subscription bands { processor.analysisDemand, Analysis::bands };
+    const AnalysisDemand::Subscription spectrum { processor.analysisDemand, Analysis::spectrum };
+
+    juce::AudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(layout);
+    buses.outputBuses.add(layout);
+    if (! processor.setBusesLayout(buses))
+        return result;
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    result.supported = true;
+
+    juce::AudioBuffer<float> block(channels, blockSize);
+    juce::MidiBuffer midi;
+    const int numBlocks = programme.getNumSamples() / blockSize;
+    const double ticksPerMicro = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) * 1.0e-6;
+
+    std::vector<double> callbackMicros;
+    callbackMicros.reserve(static_cast<size_t>(numBlocks * passes));
+    double bestPassSeconds = std::numeric_limits<double>::max();
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        double passSeconds = 0.0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < channels; ++ch)
+                block.copyFrom(ch, 0, programme, ch, b * blockSize, blockSize);
+
+            const ScopedAllocationCount allocations;
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+            const double micros = static_cast<double>(elapsed) / ticksPerMicro;
+            callbackMicros.push_back(micros);
+            passSeconds += micros * 1.0e-6;
+
+            if (const auto n = allocations.get(); n > 0)
+            {
+                result.allocations += n;
+                ++result.allocatingCallbacks;
+            }
+        }
+
+        bestPassSeconds = juce::jmin(bestPassSeconds, passSeconds);
+    }
+
+    processor.releaseResources();
+
+    result.callbacks = static_cast<int>(callbackMicros.size());
+    if (numBlocks > 0)
+        result.nsPerSample = bestPassSeconds * 1.0e9 / (static_cast<double>(numBlocks) * blockSize);
+
+    if (! callbackMicros.empty())
+    {
+        const auto p99 = callbackMicros.begin() + static_cast<std::ptrdiff_t>((callbackMicros.size() - 1) * 99 / 100);
+        std::nth_element(callbackMicros.begin(), p99, callbackMicros.end());
+        result.p99CallbackMicros = *p99;
+        result.worstCallbackMicros = *std::max_element(callbackMicros.begin(), callbackMicros.end());
+    }
+
+    return result;
+}
+
+//==============================================================================
+inline juce::String runProcessBlockSweep(const ProcessBlockSweepOptions& options)
+{
+    const int passes = juce::jmax(1, options.passes);
+    const double seconds = juce::jlimit(0.1, 60.0, options.secondsPerSignal);
+
+    juce::Array<juce::var> cases;
+    juce::uint64 totalAllocations = 0;
+    double worstBudgetPercent = 0.0;
+
+    for (const double rawRate : options.sampleRates)
+    {
+        const double sampleRate = juce::jlimit(8000.0, 384000.0, rawRate);
+
+        for (const int channels : options.channelCounts)
+        {
+            const auto programme = makeProcessBlockProgramme(sampleRate, juce::jlimit(1, 64, channels), seconds);
+
+            for (const int rawBlockSize : options.blockSizes)
+            {
+                const int blockSize = juce::jlimit(16, 8192, rawBlockSize);
+                const auto r = runProcessBlockCase(programme, blockSize, sampleRate, passes);
+
+                auto* entry = new juce::DynamicObject();
+                entry->setProperty("blockSize", blockSize);
+                entry->setProperty("sampleRate", sampleRate);
+                entry->setProperty("channels", programme.getNumChannels());
+                entry->setProperty("supported", r.supported);
+
+                if (r.supported)
+                {
+                    const double budgetMicros = blockSize * 1.0e6 / sampleRate;
+                    const double budgetPercent = r.worstCallbackMicros * 100.0 / budgetMicros;
+                    worstBudgetPercent = juce::jmax(worstBudgetPercent, budgetPercent);
+                    totalAllocations += r.allocations;
+
+                    entry->setProperty("nsPerSample", r.nsPerSample);
+                    entry->setProperty("nsPerSamplePerChannel", r.nsPerSample / programme.getNumChannels());
+                    entry->setProperty("worstCallbackMicros", r.worstCallbackMicros);
+                    entry->setProperty("p99CallbackMicros", r.p99CallbackMicros);
+                    entry->setProperty("worstCallbackBudgetPercent", budgetPercent);
+                    entry->setProperty("callbacks", r.callbacks);
+                    entry->setProperty("allocations", static_cast<juce::int64>(r.allocations));
+                    entry->setProperty("allocatingCallbacks", r.allocatingCallbacks);
+                }
+
+                cases.add(juce::var(entry));
+            }
+        }
+    }
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("benchmark", "processBlock");
+    result->setProperty("programme", "sine 997 Hz, pink noise, log sweep; "
+                                     + juce::String(seconds, 2) + " s each");
+    result->setProperty("passes", passes);
+    result->setProperty("simd", static_cast<bool>(JUCE_USE_SIMD));
+    result->setProperty("allocationCounting", AllocationCounter::available);
+    result->setProperty("totalAllocations", static_cast<juce::int64>(totalAllocations));
+    result->setProperty("worstCallbackBudgetPercent", worstBudgetPercent);
+    result->setProperty("cases", cases);
+
+    return juce::JSON::toString(juce::var(result));
+}
+
+} // namespace benchmark
+} // namespace goodmeter
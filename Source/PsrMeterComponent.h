@@ -17,25 +17,26 @@
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
+#include "FrameScheduler.h"
 
 //==============================================================================
 class PsrMeterComponent : public juce::Component,
-                           public juce::Timer
+                           public FrameScheduler::Client
 {
 public:
     //==========================================================================
     PsrMeterComponent(GOODMETERAudioProcessor& processor)
-        : audioProcessor(processor)
+        : FrameScheduler::Client(this), audioProcessor(processor)
     {
         psrHistory.resize(historySize, 0.0f);
         recHistory.resize(historySize, 0);
         setSize(100, 200);
-        startTimerHz(60);
+        startFrames();
     }
 
     ~PsrMeterComponent() override
     {
-        stopTimer();
+        stopFrames();
     }
 
     void setMarathonDarkStyle(bool shouldUse)
@@ -129,7 +130,7 @@ private:
     float recBreathPhase = 0.0f;
 
     //==========================================================================
-    void timerCallback() override
+    void frameTick() override
     {
         // 60Hz → 30Hz smart throttle during mouse drag
         if (juce::ModifierKeys::currentModifiers.isAnyMouseButtonDown())
@@ -138,11 +139,10 @@ private:
             if (++dragThrottleCounter % 2 != 0) return;
         }
 
-        // Read peak and short-term LUFS from processor
-        const float peakL = audioProcessor.peakLevelL.load(std::memory_order_relaxed);
-        const float peakR = audioProcessor.peakLevelR.load(std::memory_order_relaxed);
-        const float peak = juce::jmax(peakL, peakR);
-        const float shortTerm = audioProcessor.lufsShortTerm.load(std::memory_order_relaxed);
+        // Read peak and short-term LUFS from the same audio block
+        const auto& snapshot = audioProcessor.getMeterSnapshot();
+        const float peak = juce::jmax(snapshot.peakL, snapshot.peakR);
+        const float shortTerm = snapshot.lufsShortTerm;
 
         // Calculate PSR
         float psr = 0.0f;
@@ -186,7 +186,7 @@ private:
             }
         }
 
-        repaint();
+        repaintFrame();
     }
 
     //==========================================================================
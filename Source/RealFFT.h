@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+    RealFFT.h
+    GOODMETER - Real-input FFT for the sizes juce::dsp::FFT can't do
+
+    DeepFilterNet works on 960-point frames (15 × 2^6), which rules out the
+    power-of-two juce::dsp::FFT. RealFFT transforms N real samples to the
+    N/2 + 1 non-negative bins and back:
+
+      - Apple: vDSP_DFT_zrop (N = f × 2^n, f in {1, 3, 5, 15})
+      - Elsewhere: an N/2-point mixed-radix complex FFT (factors 4, 2, 3, 5,
+        then any leftover prime) with the usual real split/merge step
+
+    Scaling follows the textbook DFT, whichever backend runs: forward()
+    is unscaled (bin 0 of a constant 1 is N) and inverse() divides by N,
+    so inverse(forward(x)) == x.
+
+    Thread safety model:
+      - The tables are read-only after construction, so one RealFFT can
+        serve several threads as long as each brings its own Scratch.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+#include <vector>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <Accelerate/Accelerate.h>
+#endif
+
+class RealFFT
+{
+public:
+    /** Per-caller work area, sized by RealFFT::makeScratch(). */
+    struct Scratch
+    {
+        std::vector<float> re, im, outRe, outIm;
+        std::vector<std::complex<float>> cpx, cpxOut, butterfly;
+    };
+
+    explicit RealFFT(int size)
+        : n(size), half(size / 2)
+    {
+        jassert(size >= 4 && size % 2 == 0);
+
+       #if JUCE_MAC || JUCE_IOS
+        forwardSetup = vDSP_DFT_zrop_CreateSetup(nullptr, static_cast<vDSP_Length>(n), vDSP_DFT_FORWARD);
+        inverseSetup = vDSP_DFT_zrop_CreateSetup(forwardSetup, static_cast<vDSP_Length>(n), vDSP_DFT_INVERSE);
+        if (forwardSetup != nullptr && inverseSetup != nullptr)
+            return;
+       #endif
+
+        buildPortableTables();
+    }
+
+    ~RealFFT()
+    {
+       #if JUCE_MAC || JUCE_IOS
+        if (inverseSetup != nullptr)  vDSP_DFT_DestroySetup(inverseSetup);
+        if (forwardSetup != nullptr)  vDSP_DFT_DestroySetup(forwardSetup);
+       #endif
+    }
+
+    int getSize() const noexcept      { return n; }
+    int getNumBins() const noexcept   { return half + 1; }
+
+    Scratch makeScratch() const
+    {
+        Scratch s;
+        s.re.resize(static_cast<size_t>(half));
+        s.im.resize(static_cast<size_t>(half));
+        s.outRe.resize(static_cast<size_t>(half));
+        s.outIm.resize(static_cast<size_t>(half));
+        s.cpx.resize(static_cast<size_t>(half));
+        s.cpxOut.resize(static_cast<size_t>(half));
+        s.butterfly.resize(static_cast<size_t>(maxRadix));
+        return s;
+    }
+
+    //==========================================================================
+    /** time[n] → re/im[n/2 + 1]. */
+    void forward(const float* time, float* re, float* im, Scratch& s) const
+    {
+       #if JUCE_MAC || JUCE_IOS
+        if (forwardSetup != nullptr)
+        {
+            // zrop takes even/odd samples split and returns 2× the DFT, packed
+            // with the Nyquist bin in im[0]
+            DSPSplitComplex split { s.re.data(), s.im.data() };
+            vDSP_ctoz(reinterpret_cast<const DSPComplex*>(time), 2, &split, 1, static_cast<vDSP_Length>(half));
+            DSPSplitComplex out { re, im };
+            vDSP_DFT_Execute(forwardSetup, split.realp, split.imagp, out.realp, out.imagp);
+
+            const float nyquist = im[0];
+            const float scale = 0.5f;
+            vDSP_vsmul(re, 1, &scale, re, 1, static_cast<vDSP_Length>(half));
+            vDSP_vsmul(im, 1, &scale, im, 1, static_cast<vDSP_Length>(half));
+            re[half] = nyquist * scale;
+            im[0] = 0.0f;
+            im[half] = 0.0f;
+            return;
+        }
+       #endif
+
+        for (int i = 0; i < half; ++i)
+            s.cpx[(size_t) i] = { time[2 * i], time[2 * i + 1] };
+
+        transform(s.cpx.data(), s.cpxOut.data(), s);
+
+        // Split the packed spectrum Z into the even/odd sample spectra and merge
+        const auto* z = s.cpxOut.data();
+        for (int k = 0; k <= half; ++k)
+        {
+            const auto zk  = z[k % half];
+            const auto zmk = std::conj(z[(half - k) % half]);
+            const auto even = 0.5f * (zk + zmk);
+            const auto odd  = std::complex<float>(0.0f, -0.5f) * (zk - zmk);
+            const auto x = even + realTwiddles[(size_t) k] * odd;
+            re[k] = x.real();
+            im[k] = x.imag();
+        }
+    }
+
+    /** re/im[n/2 + 1] → time[n]; the imaginary parts of bins 0 and n/2 are ignored. */
+    void inverse(const float* re, const float* im, float* time, Scratch& s) const
+    {
+       #if JUCE_MAC || JUCE_IOS
+        if (inverseSetup != nullptr)
+        {
+            // Packed input as zrop expects it; the result comes back even/odd
+            // split and N× the mathematical inverse
+            std::copy_n(re, half, s.re.data());
+            std::copy_n(im, half, s.im.data());
+            s.im[0] = re[half];
+
+            DSPSplitComplex split { s.outRe.data(), s.outIm.data() };
+            vDSP_DFT_Execute(inverseSetup, s.re.data(), s.im.data(), split.realp, split.imagp);
+            vDSP_ztoc(&split, 1, reinterpret_cast<DSPComplex*>(time), 2, static_cast<vDSP_Length>(half));
+
+            const float scale = 1.0f / static_cast<float>(n);
+            vDSP_vsmul(time, 1, &scale, time, 1, static_cast<vDSP_Length>(n));
+            return;
+        }
+       #endif
+
+        // Rebuild Z from the half spectrum, then an inverse complex FFT via conjugation
+        for (int k = 0; k < half; ++k)
+        {
+            const std::complex<float> xk(re[k], k == 0 ? 0.0f : im[k]);
+            const std::complex<float> xmk(re[half - k], half - k == half ? 0.0f : -im[half - k]);
+            const auto even = xk + xmk;
+            const auto odd  = (xk - xmk) * std::conj(realTwiddles[(size_t) k]);
+            s.cpx[(size_t) k] = std::conj(even + std::complex<float>(0.0f, 1.0f) * odd);
+        }
+
+        transform(s.cpx.data(), s.cpxOut.data(), s);
+
+        const float scale = 1.0f / static_cast<float>(n);
+        for (int i = 0; i < half; ++i)
+        {
+            time[2 * i]     =  s.cpxOut[(size_t) i].real() * scale;
+            time[2 * i + 1] = -s.cpxOut[(size_t) i].imag() * scale;
+        }
+    }
+
+private:
+    //==========================================================================
+    void buildPortableTables()
+    {
+        for (int remaining = half; remaining > 1;)
+        {
+            int p = 2;
+            if (remaining % 4 == 0)                             p = 4;
+            else if (remaining % 2 == 0)                        p = 2;
+            else if (remaining % 3 == 0)                        p = 3;
+            else if (remaining % 5 == 0)                        p = 5;
+            else for (p = 7; remaining % p != 0; p += 2) {}
+
+            remaining /= p;
+            factors.push_back(p);
+            factors.push_back(remaining);
+            maxRadix = juce::jmax(maxRadix, p);
+        }
+
+        twiddles.resize(static_cast<size_t>(half));
+        for (int i = 0; i < half; ++i)
+            twiddles[(size_t) i] = std::complex<float>(std::polar(1.0, -juce::MathConstants<double>::twoPi * i / half));
+
+        realTwiddles.resize(static_cast<size_t>(half + 1));
+        for (int k = 0; k <= half; ++k)
+            realTwiddles[(size_t) k] = std::complex<float>(std::polar(1.0, -juce::MathConstants<double>::twoPi * k / n));
+    }
+
+    /** Forward complex FFT of half points, out of place. */
+    void transform(const std::complex<float>* in, std::complex<float>* out, Scratch& s) const
+    {
+        if (half == 1)
+            out[0] = in[0];
+        else
+            work(out, in, 1, factors.data(), s);
+    }
+
+    /** Decimation in time, one radix per recursion level. */
+    void work(std::complex<float>* out, const std::complex<float>* in,
+              int stride, const int* factor, Scratch& s) const
+    {
+        const int p = factor[0];
+        const int m = factor[1];
+        auto* const begin = out;
+        auto* const end = out + p * m;
+
+        if (m == 1)
+        {
+            for (auto* o = out; o != end; ++o, in += stride)
+                *o = *in;
+        }
+        else
+        {
+            for (auto* o = out; o != end; o += m, in += stride)
+                work(o, in, stride * p, factor + 2, s);
+        }
+
+        butterfly(begin, stride, p, m, s);
+    }
+
+    void butterfly(std::complex<float>* out, int stride, int p, int m, Scratch& s) const
+    {
+        auto* scratch = s.butterfly.data();
+        const auto* tw = twiddles.data();
+
+        if (p == 2)
+        {
+            for (int u = 0; u < m; ++u)
+            {
+                const auto t = out[u + m] * tw[u * stride];
+                out[u + m] = out[u] - t;
+                out[u] += t;
+            }
+            return;
+        }
+
+        if (p == 4)
+        {
+            for (int u = 0; u < m; ++u)
+            {
+                const auto a0 = out[u];
+                const auto a1 = out[u + m]     * tw[u * stride];
+                const auto a2 = out[u + 2 * m] * tw[2 * u * stride];
+                const auto a3 = out[u + 3 * m] * tw[3 * u * stride];
+                const auto s02 = a0 + a2, d02 = a0 - a2;
+                const auto s13 = a1 + a3;
+                const auto d13 = std::complex<float>((a1 - a3).imag(), -(a1 - a3).real());   // -i (a1 - a3)
+                out[u]         = s02 + s13;
+                out[u + m]     = d02 + d13;
+                out[u + 2 * m] = s02 - s13;
+                out[u + 3 * m] = d02 - d13;
+            }
+            return;
+        }
+
+        // Any other radix: direct p-point DFT of the twiddled inputs
+        for (int u = 0; u < m; ++u)
+        {
+            for (int q = 0; q < p; ++q)
+                scratch[q] = out[u + q * m];
+
+            for (int q1 = 0; q1 < p; ++q1)
+            {
+                const int k = u + q1 * m;
+                auto sum = scratch[0];
+                int index = 0;
+                for (int q = 1; q < p; ++q)
+                {
+                    index += stride * k;
+                    if (index >= half)
+                        index %= half;
+                    sum += scratch[q] * tw[index];
+                }
+                out[k] = sum;
+            }
+        }
+    }
+
+    const int n;
+    const int half;
+    int maxRadix = 5;
+    std::vector<int> factors;                               // radix, remaining length, ...
+    std::vector<std::complex<float>> twiddles;              // e^{-2πi k / half}
+    std::vector<std::complex<float>> realTwiddles;          // e^{-2πi k / n}, k = 0..half
+
+   #if JUCE_MAC || JUCE_IOS
+    vDSP_DFT_Setup forwardSetup = nullptr;
+    vDSP_DFT_Setup inverseSetup = nullptr;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(RealFFT)
+};
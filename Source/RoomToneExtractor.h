@@ -5,9 +5,18 @@
 
     Pipeline:
       1. VAD: detect silent segments (energy + spectral flatness)
-      2. Spectral envelope: FFT on silent segments → average magnitude
+      2. Spectral envelope: average magnitude of the silent frames
       3. Synthesis: filter white noise with spectral envelope (overlap-add)
 
+    analyse() does 1 and 2 (and the noise floor) in a single STFT pass:
+    frames are classified in parallel on the AnalysisTaskGraph pool, and
+    each silent frame's magnitudes are kept for step 2, up to
+    kCachedFrameBudget frames (~64 MB); silent frames past the budget
+    are transformed again when the envelope is built. Synthesis runs its
+    channels in parallel and overlap-adds straight into the output, so
+    it needs no take- or duration-sized workspace. Results match the
+    original three-pass version sample for sample.
+
     All functions are static — no persistent state needed.
   ==============================================================================
 */
@@ -15,7 +24,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "AnalysisTaskGraph.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <numeric>
 #include <vector>
 #include <cmath>
 
@@ -37,6 +50,9 @@ public:
     static constexpr int halfFFT = fftSize / 2;  // 2048 bins
     static constexpr int hopSize = 1024;          // 75% overlap
 
+    static constexpr int kFramesPerTask = 256;        // ~5 s of frames per pool task at 48 kHz
+    static constexpr int kCachedFrameBudget = 8192;   // silent magnitude frames kept (× 8 KB)
+
     //==========================================================================
     // 1. VAD — Voice Activity Detection (energy + spectral flatness)
     //==========================================================================
@@ -64,32 +80,196 @@ public:
         return mono;
     }
 
-    static std::vector<SilentSegment> detectSilentSegments(
-        const juce::AudioBuffer<float>& audio, double sampleRate)
+    //==========================================================================
+    /** Everything synthesis needs from a take, from one pass over it. */
+    struct Analysis
+    {
+        std::vector<SilentSegment> silentSegments;
+        std::array<float, halfFFT> spectralEnvelope {};
+        float noiseFloorRms = 0.0f;     // time-domain RMS of the silent segments
+    };
+
+    /** VAD, spectral envelope and noise floor in one pass: frames are
+     *  classified in parallel on the AnalysisTaskGraph pool, and the
+     *  magnitude frames of silent frames are kept (up to kCachedFrameBudget)
+     *  for the envelope instead of being transformed again. */
+    static Analysis analyse(const juce::AudioBuffer<float>& audio, double sampleRate)
     {
         juce::ignoreUnused(sampleRate);
 
+        Analysis result;
         const int totalSamples = audio.getNumSamples();
-        if (totalSamples < fftSize) return {};
+        if (totalSamples < fftSize) return result;
 
-        // Mix to mono for analysis (handles 5ch, stereo, etc.)
+        // Mix to mono once for every stage (handles 5ch, stereo, etc.)
         auto mono = mixToMono(audio);
         const float* data = mono.getReadPointer(0);
 
+        const int numFrames = (totalSamples - fftSize) / hopSize + 1;
+        std::vector<FrameInfo> frames(static_cast<size_t>(numFrames));
+
+        const int numTasks = (numFrames + kFramesPerTask - 1) / kFramesPerTask;
+        std::vector<SpectrumCache> caches(static_cast<size_t>(numTasks));
+        std::atomic<int> cachedFrames { 0 };
+
+        AnalysisTaskGraph graph;
+        for (int t = 0; t < numTasks; ++t)
+        {
+            graph.addTask("room tone frames " + juce::String(t), [&, t]
+            {
+                classifyFrames(data, t * kFramesPerTask,
+                               juce::jmin(numFrames, (t + 1) * kFramesPerTask),
+                               frames, caches[(size_t) t], cachedFrames);
+            });
+        }
+        graph.run();
+
+        result.silentSegments = mergeSilentFrames(frames);
+        result.spectralEnvelope = averageSpectrum(data, frames, caches, result.silentSegments);
+        result.noiseFloorRms = measureNoiseFloorRms(mono, result.silentSegments);
+        return result;
+    }
+
+    //==========================================================================
+    // 2b. Measure actual time-domain RMS of silent segments (for calibration)
+    //==========================================================================
+    static float measureNoiseFloorRms(
+        const juce::AudioBuffer<float>& mono,
+        const std::vector<SilentSegment>& silentSegments)
+    {
+        const float* data = mono.getReadPointer(0);
+        int totalSamples = mono.getNumSamples();
+
+        float sumSq = 0.0f;
+        int count = 0;
+
+        for (const auto& seg : silentSegments)
+        {
+            for (int s = seg.startSample; s < seg.endSample && s < totalSamples; ++s)
+            {
+                sumSq += data[s] * data[s];
+                count++;
+            }
+        }
+
+        if (count == 0) return 0.0f;
+        return std::sqrt(sumSq / static_cast<float>(count));
+    }
+
+    //==========================================================================
+    // 3. Room Tone synthesis (overlap-add: random phase + spectral envelope)
+    //     noiseFloorRms: if > 0, calibrate each channel's RMS to this value
+    //                    (scaled down by 0.75 to ensure room tone <= original noise)
+    //==========================================================================
+    static juce::AudioBuffer<float> synthesizeRoomTone(
+        const std::array<float, halfFFT>& spectralEnvelope,
+        double sampleRate,
+        float durationSeconds,
+        int numChannels = 2,
+        float noiseFloorRms = -1.0f)
+    {
+        int totalSamples = static_cast<int>(sampleRate * durationSeconds);
+        if (totalSamples <= 0) totalSamples = static_cast<int>(sampleRate * 30.0);
+        if (numChannels < 1) numChannels = 1;
+
+        juce::AudioBuffer<float> output(numChannels, totalSamples);
+        output.clear();
+
+        // Check if envelope has any energy
+        float envSum = 0.0f;
+        for (auto v : spectralEnvelope) envSum += v;
+        if (envSum < 1e-10f) return output;  // no noise detected, return silence
+
+        // ── High-pass filter the spectral envelope ──
+        // Roll off below ~80 Hz to prevent boomy low-frequency buildup.
+        // At 48kHz/4096 = 11.72 Hz per bin → 80 Hz ≈ bin 7
+        float binHz = static_cast<float>(sampleRate) / static_cast<float>(fftSize);
+        int hpfBin = juce::jmax(1, static_cast<int>(80.0f / binHz));
+        std::array<float, halfFFT> filteredEnvelope = spectralEnvelope;
+        for (int i = 0; i < hpfBin && i < halfFFT; ++i)
+        {
+            float ratio = static_cast<float>(i) / static_cast<float>(hpfBin);
+            filteredEnvelope[static_cast<size_t>(i)] *= ratio * ratio;  // quadratic roll-off
+        }
+        // Also kill DC completely
+        filteredEnvelope[0] = 0.0f;
+
+        // ── Target RMS ──
+        // If measured noise floor provided, use it (scaled to 75% for safety margin).
+        // Otherwise fall back to envelope-derived estimate.
+        float targetRms;
+        if (noiseFloorRms > 0.0f)
+            targetRms = noiseFloorRms * 0.75f;
+        else
+        {
+            targetRms = 0.0f;
+            for (auto v : filteredEnvelope) targetRms += v * v;
+            targetRms = std::sqrt(targetRms / static_cast<float>(halfFFT)) * 0.03f;
+        }
+
+        // Synthesize EACH channel independently with its own random phases
+        // This avoids comb filtering caused by time-shifted copies
+        AnalysisTaskGraph graph;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            graph.addTask("room tone channel " + juce::String(ch), [&, ch]
+            {
+                synthesizeChannel(filteredEnvelope, targetRms, ch, output.getWritePointer(ch), totalSamples);
+            });
+        }
+        graph.run();
+
+        return output;
+    }
+private:
+    //==========================================================================
+    struct FrameInfo
+    {
+        bool isSilent = false;
+        int startSample = 0;
+        float rmsDb = -120.0f;
+        float energy = 0.0f;        // sum of squared magnitudes (transient gate)
+        int cacheIndex = -1;        // frame in its task's SpectrumCache, -1 = not kept
+    };
+
+    /** Silent frames' magnitudes from one classification task. */
+    struct SpectrumCache
+    {
+        std::vector<float> magnitudes;      // [frame][halfFFT]
+    };
+
+    /** Hann window + magnitude FFT of the fftSize samples at frame. */
+    static void computeMagnitudes(const float* frame,
+                                  const juce::dsp::FFT& fft,
+                                  juce::dsp::WindowingFunction<float>& window,
+                                  std::array<float, fftSize * 2>& fftBuf)
+    {
+        std::fill(fftBuf.begin() + fftSize, fftBuf.end(), 0.0f);
+        std::copy(frame, frame + fftSize, fftBuf.begin());
+        window.multiplyWithWindowingTable(fftBuf.data(), fftSize);
+        fft.performFrequencyOnlyForwardTransform(fftBuf.data());
+    }
+
+    //==========================================================================
+    /** RMS, spectral flatness and energy of frames [begin, end); silent
+     *  frames' magnitudes go into cache while the budget lasts. */
+    static void classifyFrames(const float* data, int begin, int end,
+                               std::vector<FrameInfo>& frames,
+                               SpectrumCache& cache,
+                               std::atomic<int>& cachedFrames)
+    {
         const float energyThresholdDb = -35.0f;   // relaxed from -40 for production audio
         const float spectralFlatnessMin = 0.2f;    // relaxed from 0.3
-        const int minSilentFrames = 4;             // relaxed from 10 (~80ms minimum)
 
         juce::dsp::FFT fft(fftOrder);
         juce::dsp::WindowingFunction<float> window(
             fftSize, juce::dsp::WindowingFunction<float>::hann);
+        std::array<float, fftSize * 2> fftBuf = {};
 
-        // Scan frames — also record RMS for fallback ranking
-        struct FrameInfo { bool isSilent; int startSample; float rmsDb; };
-        std::vector<FrameInfo> frames;
-
-        for (int pos = 0; pos + fftSize <= totalSamples; pos += hopSize)
+        for (int f = begin; f < end; ++f)
         {
+            const int pos = f * hopSize;
+
             // Compute RMS
             float sumSq = 0.0f;
             for (int i = 0; i < fftSize; ++i)
@@ -102,11 +282,7 @@ public:
                 ? 20.0f * std::log10(rms) : -120.0f;
 
             // Compute spectral flatness
-            std::array<float, fftSize * 2> fftBuf = {};
-            for (int i = 0; i < fftSize; ++i)
-                fftBuf[static_cast<size_t>(i)] = data[pos + i];
-            window.multiplyWithWindowingTable(fftBuf.data(), fftSize);
-            fft.performFrequencyOnlyForwardTransform(fftBuf.data());
+            computeMagnitudes(data + pos, fft, window, fftBuf);
 
             // Spectral flatness = exp(mean(log(mag))) / mean(mag)
             float logSum = 0.0f;
@@ -123,9 +299,30 @@ public:
             float arithMean = magSum / n;
             float flatness = (arithMean > 1e-10f) ? geoMean / arithMean : 0.0f;
 
-            bool silent = (rmsDb < energyThresholdDb && flatness > spectralFlatnessMin);
-            frames.push_back({ silent, pos, rmsDb });
+            float frameEnergy = 0.0f;
+            for (int i = 0; i < halfFFT; ++i)
+                frameEnergy += fftBuf[static_cast<size_t>(i)]
+                             * fftBuf[static_cast<size_t>(i)];
+
+            auto& info = frames[static_cast<size_t>(f)];
+            info.isSilent = (rmsDb < energyThresholdDb && flatness > spectralFlatnessMin);
+            info.startSample = pos;
+            info.rmsDb = rmsDb;
+            info.energy = frameEnergy;
+
+            if (info.isSilent && cachedFrames.fetch_add(1, std::memory_order_relaxed) < kCachedFrameBudget)
+            {
+                info.cacheIndex = static_cast<int>(cache.magnitudes.size() / halfFFT);
+                cache.magnitudes.insert(cache.magnitudes.end(), fftBuf.begin(), fftBuf.begin() + halfFFT);
+            }
         }
+    }
+
+    /** Runs of at least minSilentFrames silent frames; if there are none,
+     *  the quietest 10% of frames (quietest first). */
+    static std::vector<SilentSegment> mergeSilentFrames(const std::vector<FrameInfo>& frames)
+    {
+        const int minSilentFrames = 4;             // relaxed from 10 (~80ms minimum)
 
         // Merge consecutive silent frames into segments
         std::vector<SilentSegment> segments;
@@ -187,27 +384,22 @@ public:
         return segments;
     }
 
-    //==========================================================================
-    // 2. Spectral envelope extraction (average magnitude over silent segments)
-    //==========================================================================
-    static std::array<float, halfFFT> extractSpectralEnvelope(
-        const juce::AudioBuffer<float>& audio,
-        const std::vector<SilentSegment>& silentSegments,
-        double sampleRate)
+    /** Average magnitude over the segments' frames, skipping transients;
+     *  cached frames are read back, the rest transformed again. */
+    static std::array<float, halfFFT> averageSpectrum(
+        const float* data,
+        const std::vector<FrameInfo>& frames,
+        const std::vector<SpectrumCache>& caches,
+        const std::vector<SilentSegment>& silentSegments)
     {
-        juce::ignoreUnused(sampleRate);
-
         std::array<float, halfFFT> avgMagnitude = {};
         int frameCount = 0;
 
         if (silentSegments.empty()) return avgMagnitude;
 
-        // Mix to mono for spectral analysis
-        auto mono = mixToMono(audio);
-
-        juce::dsp::FFT fft(fftOrder);
-        juce::dsp::WindowingFunction<float> window(
-            fftSize, juce::dsp::WindowingFunction<float>::hann);
+        std::unique_ptr<juce::dsp::FFT> fft;
+        std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+        std::array<float, fftSize * 2> fftBuf = {};
 
         // Running average for transient detection
         float runningAvgEnergy = 0.0f;
@@ -219,19 +411,11 @@ public:
                  pos + fftSize <= seg.endSample;
                  pos += hopSize)
             {
-                std::array<float, fftSize * 2> fftBuf = {};
-                for (int i = 0; i < fftSize; ++i)
-                    fftBuf[static_cast<size_t>(i)] = mono.getSample(0, pos + i);
-
-                window.multiplyWithWindowingTable(fftBuf.data(), fftSize);
-                fft.performFrequencyOnlyForwardTransform(fftBuf.data());
+                const int f = pos / hopSize;
+                const auto& info = frames[static_cast<size_t>(f)];
 
                 // Transient detection: skip frames with energy >> running average
-                float frameEnergy = 0.0f;
-                for (int i = 0; i < halfFFT; ++i)
-                    frameEnergy += fftBuf[static_cast<size_t>(i)]
-                                 * fftBuf[static_cast<size_t>(i)];
-
+                const float frameEnergy = info.energy;
                 if (energyCount > 3 && runningAvgEnergy > 1e-10f
                     && frameEnergy / runningAvgEnergy > 3.0f)
                 {
@@ -244,10 +428,27 @@ public:
                                    / static_cast<float>(energyCount + 1);
                 energyCount++;
 
+                const float* magnitudes = nullptr;
+                if (info.cacheIndex >= 0)
+                {
+                    magnitudes = caches[static_cast<size_t>(f / kFramesPerTask)].magnitudes.data()
+                               + static_cast<size_t>(info.cacheIndex) * halfFFT;
+                }
+                else
+                {
+                    if (fft == nullptr)
+                    {
+                        fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+                        window = std::make_unique<juce::dsp::WindowingFunction<float>>(
+                            fftSize, juce::dsp::WindowingFunction<float>::hann);
+                    }
+                    computeMagnitudes(data + pos, *fft, *window, fftBuf);
+                    magnitudes = fftBuf.data();
+                }
+
                 // Accumulate magnitude
                 for (int i = 0; i < halfFFT; ++i)
-                    avgMagnitude[static_cast<size_t>(i)]
-                        += fftBuf[static_cast<size_t>(i)];
+                    avgMagnitude[static_cast<size_t>(i)] += magnitudes[i];
                 frameCount++;
             }
         }
@@ -263,139 +464,61 @@ public:
     }
 
     //==========================================================================
-    // 2b. Measure actual time-domain RMS of silent segments (for calibration)
-    //==========================================================================
-    static float measureNoiseFloorRms(
-        const juce::AudioBuffer<float>& audio,
-        const std::vector<SilentSegment>& silentSegments)
-    {
-        auto mono = mixToMono(audio);
-        const float* data = mono.getReadPointer(0);
-        int totalSamples = mono.getNumSamples();
-
-        float sumSq = 0.0f;
-        int count = 0;
-
-        for (const auto& seg : silentSegments)
-        {
-            for (int s = seg.startSample; s < seg.endSample && s < totalSamples; ++s)
-            {
-                sumSq += data[s] * data[s];
-                count++;
-            }
-        }
-
-        if (count == 0) return 0.0f;
-        return std::sqrt(sumSq / static_cast<float>(count));
-    }
-
-    //==========================================================================
-    // 3. Room Tone synthesis (overlap-add: random phase + spectral envelope)
-    //     noiseFloorRms: if > 0, calibrate each channel's RMS to this value
-    //                    (scaled down by 0.75 to ensure room tone <= original noise)
-    //==========================================================================
-    static juce::AudioBuffer<float> synthesizeRoomTone(
-        const std::array<float, halfFFT>& spectralEnvelope,
-        double sampleRate,
-        float durationSeconds,
-        int numChannels = 2,
-        float noiseFloorRms = -1.0f)
+    /** One channel of random-phase noise: each frame's first hop is final
+     *  once it is added, so it goes straight to dest. */
+    static void synthesizeChannel(const std::array<float, halfFFT>& filteredEnvelope,
+                                  float targetRms, int channel,
+                                  float* dest, int totalSamples)
     {
-        int totalSamples = static_cast<int>(sampleRate * durationSeconds);
-        if (totalSamples <= 0) totalSamples = static_cast<int>(sampleRate * 30.0);
-        if (numChannels < 1) numChannels = 1;
-
-        juce::AudioBuffer<float> output(numChannels, totalSamples);
-        output.clear();
-
         juce::dsp::FFT fft(fftOrder);
-
-        // Check if envelope has any energy
-        float envSum = 0.0f;
-        for (auto v : spectralEnvelope) envSum += v;
-        if (envSum < 1e-10f) return output;  // no noise detected, return silence
-
         juce::dsp::WindowingFunction<float> window(
             fftSize, juce::dsp::WindowingFunction<float>::hann);
 
-        // ── High-pass filter the spectral envelope ──
-        // Roll off below ~80 Hz to prevent boomy low-frequency buildup.
-        // At 48kHz/4096 = 11.72 Hz per bin → 80 Hz ≈ bin 7
-        float binHz = static_cast<float>(sampleRate) / static_cast<float>(fftSize);
-        int hpfBin = juce::jmax(1, static_cast<int>(80.0f / binHz));
-        std::array<float, halfFFT> filteredEnvelope = spectralEnvelope;
-        for (int i = 0; i < hpfBin && i < halfFFT; ++i)
-        {
-            float ratio = static_cast<float>(i) / static_cast<float>(hpfBin);
-            filteredEnvelope[static_cast<size_t>(i)] *= ratio * ratio;  // quadratic roll-off
-        }
-        // Also kill DC completely
-        filteredEnvelope[0] = 0.0f;
-
-        // ── Target RMS ──
-        // If measured noise floor provided, use it (scaled to 75% for safety margin).
-        // Otherwise fall back to envelope-derived estimate.
-        float targetRms;
-        if (noiseFloorRms > 0.0f)
-            targetRms = noiseFloorRms * 0.75f;
-        else
-        {
-            targetRms = 0.0f;
-            for (auto v : filteredEnvelope) targetRms += v * v;
-            targetRms = std::sqrt(targetRms / static_cast<float>(halfFFT)) * 0.03f;
-        }
+        juce::Random rng(static_cast<int64_t>(channel + 1) * 31337);  // unique seed per channel
+        std::array<float, fftSize> overlap = {};
 
-        // Synthesize EACH channel independently with its own random phases
-        // This avoids comb filtering caused by time-shifted copies
-        for (int ch = 0; ch < numChannels; ++ch)
+        for (int pos = 0; pos <= totalSamples; pos += hopSize)
         {
-            juce::Random rng(static_cast<int64_t>(ch + 1) * 31337);  // unique seed per channel
-            int workLen = totalSamples + fftSize;
-            std::vector<float> workspace(static_cast<size_t>(workLen), 0.0f);
+            // Build frequency-domain frame: envelope magnitude + random phase
+            std::array<float, fftSize * 2> frame = {};
 
-            for (int pos = 0; pos + fftSize <= workLen; pos += hopSize)
+            for (int bin = 0; bin < halfFFT; ++bin)
             {
-                // Build frequency-domain frame: envelope magnitude + random phase
-                std::array<float, fftSize * 2> frame = {};
+                float magnitude = filteredEnvelope[static_cast<size_t>(bin)];
+                float phase = rng.nextFloat() * juce::MathConstants<float>::twoPi;
 
-                for (int bin = 0; bin < halfFFT; ++bin)
-                {
-                    float magnitude = filteredEnvelope[static_cast<size_t>(bin)];
-                    float phase = rng.nextFloat() * juce::MathConstants<float>::twoPi;
+                frame[static_cast<size_t>(bin * 2)]     = magnitude * std::cos(phase);
+                frame[static_cast<size_t>(bin * 2 + 1)] = magnitude * std::sin(phase);
+            }
 
-                    frame[static_cast<size_t>(bin * 2)]     = magnitude * std::cos(phase);
-                    frame[static_cast<size_t>(bin * 2 + 1)] = magnitude * std::sin(phase);
-                }
+            // IFFT
+            fft.performRealOnlyInverseTransform(frame.data());
 
-                // IFFT
-                fft.performRealOnlyInverseTransform(frame.data());
+            // Windowing + overlap-add
+            window.multiplyWithWindowingTable(frame.data(), fftSize);
 
-                // Windowing + overlap-add
-                window.multiplyWithWindowingTable(frame.data(), fftSize);
+            for (int i = 0; i < fftSize; ++i)
+                overlap[static_cast<size_t>(i)] += frame[static_cast<size_t>(i)];
 
-                for (int i = 0; i < fftSize && (pos + i) < workLen; ++i)
-                    workspace[static_cast<size_t>(pos + i)] += frame[static_cast<size_t>(i)];
-            }
+            const int done = juce::jmin(hopSize, totalSamples - pos);
+            if (done > 0)
+                std::copy(overlap.begin(), overlap.begin() + done, dest + pos);
 
-            // Normalize: match RMS to envelope RMS
-            float rmsOut = 0.0f;
-            for (int i = 0; i < totalSamples; ++i)
-                rmsOut += workspace[static_cast<size_t>(i)]
-                        * workspace[static_cast<size_t>(i)];
-            rmsOut = std::sqrt(rmsOut / static_cast<float>(totalSamples));
+            std::copy(overlap.begin() + hopSize, overlap.end(), overlap.begin());
+            std::fill(overlap.end() - hopSize, overlap.end(), 0.0f);
+        }
 
-            if (rmsOut > 1e-10f)
-            {
-                float gain = targetRms / rmsOut;
-                for (int i = 0; i < totalSamples; ++i)
-                    workspace[static_cast<size_t>(i)] *= gain;
-            }
+        // Normalize: match RMS to envelope RMS
+        float rmsOut = 0.0f;
+        for (int i = 0; i < totalSamples; ++i)
+            rmsOut += dest[i] * dest[i];
+        rmsOut = std::sqrt(rmsOut / static_cast<float>(totalSamples));
 
-            // Copy to this channel
+        if (rmsOut > 1e-10f)
+        {
+            float gain = targetRms / rmsOut;
             for (int i = 0; i < totalSamples; ++i)
-                output.setSample(ch, i, workspace[static_cast<size_t>(i)]);
+                dest[i] *= gain;
         }
-
-        return output;
     }
 };
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+    SharedHistoryPool.h
+    GOODMETER - Process-wide memory budget for rewind history
+
+    Every plugin instance in a host process shares one pool. An instance only
+    asks for history memory once rewind is enabled on it, and the pool grants
+    what is left of a global budget instead of each instance reserving the
+    305 s worst case up front. Instances without rewind cost nothing.
+
+    The pool only does accounting; each AudioHistoryBuffer still owns its
+    ring, so the audio thread never touches shared state.
+
+    Thread safety model:
+      - acquire()/release()/setBudgetBytes(): any non-audio thread (mutex)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <mutex>
+
+//==============================================================================
+class SharedHistoryPool
+{
+public:
+    // 512 MB: one 192 kHz stereo instance at full length, or four at 48 kHz
+    static constexpr size_t kDefaultBudgetBytes = size_t (512) * 1024 * 1024;
+
+    /** Created on first use; shared by every instance loaded from this binary. */
+    static SharedHistoryPool& getInstance()
+    {
+        static SharedHistoryPool pool;
+        return pool;
+    }
+
+    //==========================================================================
+    /** Reserve up to requestedBytes. Returns the bytes granted (0 if fewer than
+     *  minimumBytes are left, so callers never get a uselessly short history). */
+    size_t acquire(size_t requestedBytes, size_t minimumBytes)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+
+        const size_t remaining = budgetBytes > usedBytes ? budgetBytes - usedBytes : 0;
+        const size_t granted = juce::jmin(requestedBytes, remaining);
+
+        if (granted == 0 || granted < minimumBytes)
+            return 0;
+
+        usedBytes += granted;
+        return granted;
+    }
+
+    void release(size_t grantedBytes)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        usedBytes -= juce::jmin(usedBytes, grantedBytes);
+    }
+
+    /** Lowering the budget never revokes existing grants; it limits new ones. */
+    void setBudgetBytes(size_t newBudget)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        budgetBytes = newBudget;
+    }
+
+    size_t getBudgetBytes() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return budgetBytes;
+    }
+
+    size_t getUsedBytes() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return usedBytes;
+    }
+
+private:
+    SharedHistoryPool() = default;
+
+    mutable std::mutex mutex;
+    size_t budgetBytes = kDefaultBudgetBytes;
+    size_t usedBytes = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(SharedHistoryPool)
+};
@@ -5,14 +5,20 @@
 
     Industrial-grade: raw FFT history + lossless rebuild on resize
     Features: 60Hz single-column scroll, zero-stretch paint, instant resize
+
+    Under an OpenGL context the history goes straight to a GPU texture ring
+    (SpectrogramGpuRenderer) and the CPU image is only rebuilt, from the
+    history, if painting ever falls back to it.
   ==============================================================================
 */
 
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
+#include "SpectrogramGpuRenderer.h"
 
 //==============================================================================
 class SpectrogramComponent : public juce::Component,
@@ -29,6 +35,12 @@ public:
         fftHistory.resize(historySize);
         for (auto& frame : fftHistory)
             frame.fill(0.0f);
+        referenceHistory.assign(historySize, adaptivePeakDb);
+
+       #if JUCE_MODULE_AVAILABLE_juce_opengl
+        gpuRenderer.setPalettes([this](float level) { return getColourForDb(juce::jmap(level, minDb, maxDb)); },
+                                [this](float level) { return getMarathonDarkColourForLevel(level); });
+       #endif
 
         setSize(100, 300);
         startThread(juce::Thread::Priority::high);
@@ -69,6 +81,16 @@ public:
 
         const juce::ScopedLock sl(imageLock);
 
+       #if JUCE_MODULE_AVAILABLE_juce_opengl
+        if (drawWithGpu(g, plotBounds))
+        {
+            drawFreqScaleOverlay(g, plotBounds);
+            return;
+        }
+       #endif
+        gpuDrawing = false;
+        ensureCpuImageLocked();
+
         if (spectrogramImage.isNull())
         {
             drawFreqScaleOverlay(g, plotBounds);
@@ -118,6 +140,11 @@ public:
     {
     }
 
+    // Not a FrameScheduler client (its own thread scrolls it): a collapsed
+    // card or hidden page stops asking for spectrum frames here instead
+    void visibilityChanged() override        { spectrumDemand.setActive(isShowing()); }
+    void parentHierarchyChanged() override   { spectrumDemand.setActive(isShowing()); }
+
     //==========================================================================
     void handleAsyncUpdate() override
     {
@@ -131,6 +158,14 @@ private:
     // 多线程保护锁 (OpenGL 渲染线程 vs 主线程)
     juce::CriticalSection imageLock;
 
+    // Set by paint: while the GPU draws, the worker leaves the CPU image alone
+    std::atomic<bool> gpuDrawing { false };
+    bool cpuImageStale = false;            // columns have been skipped since the last rebuild
+
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+    SpectrogramGpuRenderer gpuRenderer;
+   #endif
+
     // 离屏缓冲区与环形游标 (固定 historySize 宽)
     juce::Image spectrogramImage;
     int drawX = 0;
@@ -139,10 +174,17 @@ private:
     static constexpr int historySize = 2048;
     static constexpr int internalHeight = 512;  // 固定内部渲染高度，永不改变
     std::vector<std::array<float, GOODMETERAudioProcessor::fftSize / 2>> fftHistory;
+    std::vector<float> referenceHistory;   // adaptive peak dB each row was coloured against
     int historyHead = 0;
+    juce::uint64 rowsWritten = 0;          // all rows ever written (GPU uploads the new ones)
+    juce::uint32 historyGeneration = 0;    // bumped whenever every row is recoloured
 
-    // FFT data storage
+    // FFT data storage (own cursor into the processor's broadcast spectrum ring)
     static constexpr int numBins = GOODMETERAudioProcessor::fftSize / 2;
+    GOODMETERAudioProcessor::SpectrumRing::Reader frameReader { audioProcessor.spectrumFramesL };
+    AnalysisDemand::Subscription spectrumDemand { audioProcessor.analysisDemand,
+                                                  AnalysisDemand::Analysis::spectrum };   // one column per frame
+    juce::uint64 reportedLostFrames = 0;   // worker thread: lost frames already counted
     std::array<float, numBins> fftData;
 
     // 时间平滑缓冲
@@ -191,20 +233,12 @@ private:
             {
                 const juce::ScopedLock sl(imageLock);
 
-                if (spectrogramImage.isNull())
-                {
-#if JUCE_IOS
-                    spectrogramImage = juce::Image(juce::Image::ARGB, historySize, internalHeight, true,
-                                                   juce::SoftwareImageType());
-#else
-                    spectrogramImage = juce::Image(juce::Image::ARGB, historySize, internalHeight, true);
-#endif
-                    spectrogramImage.clear(spectrogramImage.getBounds(), juce::Colours::transparentBlack);
-                    drawX = 0;
-                }
+                const bool drawCpu = ! gpuDrawing.load();
+                if (drawCpu)
+                    ensureCpuImageLocked();
 
                 while (processedColumns < maxColumnsPerPass
-                       && audioProcessor.fftFifoSpectrogramL.pop(fftData.data(), numBins))
+                       && frameReader.readNext(fftData.data()))
                 {
                     if (threadShouldExit()) return;
 
@@ -221,15 +255,27 @@ private:
 
                     updateAdaptivePeakDbFromFrame(smoothedFftData);
                     fftHistory[static_cast<size_t>(historyHead)] = smoothedFftData;
+                    referenceHistory[static_cast<size_t>(historyHead)] = adaptivePeakDb;
                     historyHead = (historyHead + 1) % historySize;
+                    ++rowsWritten;
 
-                    drawOneColumn(internalHeight);
+                    // drawX moves with historyHead either way, so a rebuild lines up
+                    if (drawCpu)
+                        drawOneColumn(internalHeight);
+                    else
+                        cpuImageStale = true;
                     drawX = (drawX + 1) % historySize;
                     drewAny = true;
                     ++processedColumns;
                 }
             } // ScopedLock released — GPU paint() can proceed
 
+            // Frames the ring lapped before this reader got to them never become columns
+            const auto lost = frameReader.getLostFrames();
+            audioProcessor.telemetry.countSpectrogramColumns(static_cast<juce::uint64>(processedColumns),
+                                                             lost - reportedLostFrames);
+            reportedLostFrames = lost;
+
             if (drewAny)
             {
                 triggerAsyncUpdate();  // 自带合并：冻结期间只记1次标记，不积压消息
@@ -290,10 +336,6 @@ private:
     juce::Colour getMarathonDarkColourForDb(float db, float referencePeakDb) const
     {
         const juce::Colour bg(0xFF0A0D13);
-        const juce::Colour haze(0xFF10265E);
-        const juce::Colour low(0xFF2D66EA);
-        const juce::Colour hot(0xFF54DFFF);
-        const juce::Colour peak(0xFF9DEEFF);
 
         // Codex: 主人拿 Audio Lab 对比后指出我们现在这张图“又白又暗”，
         // 真正差异不在换粉还是换蓝，而在于 Audio Lab 是按整条素材的相对峰值
@@ -307,6 +349,18 @@ private:
             (db - effectiveFloorDb) / juce::jmax(18.0f, referencePeakDb - effectiveFloorDb));
         normalized = std::pow(juce::jlimit(0.0f, 1.0f, normalized * 1.10f), 0.68f);
 
+        return getMarathonDarkColourForLevel(normalized);
+    }
+
+    /** The marathon ramp over the normalised level (also the GPU palette). */
+    juce::Colour getMarathonDarkColourForLevel(float normalized) const
+    {
+        const juce::Colour bg(0xFF0A0D13);
+        const juce::Colour haze(0xFF10265E);
+        const juce::Colour low(0xFF2D66EA);
+        const juce::Colour hot(0xFF54DFFF);
+        const juce::Colour peak(0xFF9DEEFF);
+
         if (normalized < 0.02f)
             return bg;
         if (normalized < 0.16f)
@@ -474,13 +528,9 @@ private:
         }
     }
 
+    /** Style change: recolour every row against one reference. */
     void rebuildSpectrogramImageLocked()
     {
-        if (spectrogramImage.isNull())
-            return;
-
-        spectrogramImage.clear(spectrogramImage.getBounds(), juce::Colours::transparentBlack);
-
         float referencePeakDbForRebuild = adaptivePeakDb;
         if (marathonDarkStyle)
         {
@@ -491,15 +541,82 @@ private:
             adaptivePeakDb = referencePeakDbForRebuild;
         }
 
-        for (int i = 0; i < historySize; ++i)
+        std::fill(referenceHistory.begin(), referenceHistory.end(), referencePeakDbForRebuild);
+        ++historyGeneration;
+
+        if (spectrogramImage.isNull())
+            return;
+
+        cpuImageStale = true;
+        if (! gpuDrawing.load())
+            ensureCpuImageLocked();
+    }
+
+    /** Create the CPU image if needed and redraw it from the history if
+     *  columns were skipped while the GPU was drawing. */
+    void ensureCpuImageLocked()
+    {
+        if (spectrogramImage.isNull())
+        {
+#if JUCE_IOS
+            spectrogramImage = juce::Image(juce::Image::ARGB, historySize, internalHeight, true,
+                                           juce::SoftwareImageType());
+#else
+            spectrogramImage = juce::Image(juce::Image::ARGB, historySize, internalHeight, true);
+#endif
+            spectrogramImage.clear(spectrogramImage.getBounds(), juce::Colours::transparentBlack);
+            cpuImageStale = rowsWritten > 0;
+        }
+
+        if (! cpuImageStale)
+            return;
+
+        cpuImageStale = false;
+        spectrogramImage.clear(spectrogramImage.getBounds(), juce::Colours::transparentBlack);
+
+        // Only rows that were ever written; the rest stays transparent as at start-up
+        const int filled = static_cast<int>(juce::jmin<juce::uint64>(rowsWritten, historySize));
+        for (int i = historySize - filled; i < historySize; ++i)
         {
             const int sourceIndex = (historyHead + i) % historySize;
             const int imageX = (drawX + i) % historySize;
 
             drawColumnFromFrame(fftHistory[static_cast<size_t>(sourceIndex)], imageX, internalHeight,
-                                referencePeakDbForRebuild);
+                                referenceHistory[static_cast<size_t>(sourceIndex)]);
         }
     }
 
+   #if JUCE_MODULE_AVAILABLE_juce_opengl
+    /** Paint through the GPU texture ring if this is a GL context; caller holds imageLock. */
+    bool drawWithGpu(juce::Graphics& g, juce::Rectangle<int> plotBounds)
+    {
+        static_assert(sizeof(std::array<float, numBins>) == sizeof(float) * numBins,
+                      "fftHistory rows must be contiguous for the texture upload");
+
+        SpectrogramGpuRenderer::History history;
+        history.magnitudes = fftHistory.front().data();
+        history.referenceDb = referenceHistory.data();
+        history.historySize = historySize;
+        history.numBins = numBins;
+        history.rowsWritten = rowsWritten;
+        history.generation = historyGeneration;
+
+        SpectrogramGpuRenderer::Mapping mapping;
+        mapping.sampleRate = static_cast<float>(audioProcessor.getSampleRate());
+        mapping.fftSize = static_cast<float>(GOODMETERAudioProcessor::fftSize);
+        mapping.minFreq = minFreq;
+        mapping.maxFreq = maxFreq;
+        mapping.minDb = minDb;
+        mapping.maxDb = maxDb;
+        mapping.marathonStyle = marathonDarkStyle;
+
+        if (mapping.sampleRate <= 0.0f || ! gpuRenderer.draw(g, *this, plotBounds, history, mapping))
+            return false;
+
+        gpuDrawing = true;
+        return true;
+    }
+   #endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramComponent)
 };
@@ -0,0 +1,381 @@
+/*
+  ==============================================================================
+    SpectrogramGpuRenderer.h
+    GOODMETER - Waterfall drawn from a GPU texture ring
+
+    When SpectrogramComponent is painted through a juce::OpenGLContext (the
+    plugin editor attaches one), the waterfall skips the CPU image entirely:
+
+      - Magnitude history lives in a numBins × historySize float texture,
+        written as a ring; each paint uploads only the rows added since
+        the last one (a full upload after a style rebuild or a new context)
+      - One OpenGLGraphicsContextCustomShader quad covers the plot: the
+        fragment shader picks the history row for its column (scrolling),
+        the FFT bin for its log-frequency height (interpolated by the
+        texture unit), converts to dB and looks the colour up in a palette
+        texture built from the component's own colour ramps
+
+    Columns are one logical pixel wide and the newest sits at the right
+    edge, exactly as in the CPU path. The transform from the GL target
+    back to component space goes to the shader, so rotated jiggle cards
+    still line up.
+
+    If there is no GL context, or the shader or float textures aren't
+    available, draw() returns false and the component paints its CPU image.
+
+    Thread safety model:
+      - draw() runs wherever the context paints (its render thread, with
+        the message manager locked); the caller holds the lock that guards
+        the history while it runs.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <functional>
+
+#if JUCE_MODULE_AVAILABLE_juce_opengl
+
+class SpectrogramGpuRenderer
+{
+public:
+    /** The component's history ring, read during draw(). */
+    struct History
+    {
+        const float* magnitudes = nullptr;      // [historySize][numBins] raw FFT magnitudes
+        const float* referenceDb = nullptr;     // [historySize] marathon palette reference per row
+        int historySize = 0;
+        int numBins = 0;
+        juce::uint64 rowsWritten = 0;           // newest row is (rowsWritten - 1) % historySize
+        juce::uint32 generation = 0;            // bumped when every row may have changed
+    };
+
+    /** How rows map to pixels and colours. */
+    struct Mapping
+    {
+        float sampleRate = 48000.0f;
+        float fftSize = 4096.0f;
+        float minFreq = 30.0f, maxFreq = 20000.0f;
+        float minDb = -80.0f, maxDb = -10.0f;   // classic palette range
+        bool marathonStyle = false;
+    };
+
+    using ColourRamp = std::function<juce::Colour(float level)>;   // level 0..1
+
+    SpectrogramGpuRenderer()
+        : instanceName("GoodmeterSpectrogram" + juce::String(nextInstanceId()))
+    {
+    }
+
+    /** Sample each style's ramp into the palette (before the first draw). */
+    void setPalettes(const ColourRamp& classic, const ColourRamp& marathon)
+    {
+        for (int i = 0; i < kPaletteSize; ++i)
+        {
+            const float level = static_cast<float>(i) / (kPaletteSize - 1);
+            storePaletteEntry(0, i, classic(level));
+            storePaletteEntry(1, i, marathon(level));
+        }
+    }
+
+    /** Draw the waterfall into plotArea (component coordinates). False if
+     *  g isn't a GL context we can use; nothing has been drawn then. */
+    bool draw(juce::Graphics& g, juce::Component& component, juce::Rectangle<int> plotArea,
+              const History& history, const Mapping& mapping)
+    {
+        using namespace juce::gl;
+
+        auto* context = juce::OpenGLContext::getCurrentContext();
+        if (unavailable || context == nullptr || plotArea.isEmpty() || history.historySize <= 0)
+            return false;
+
+        auto* target = context->getTargetComponent();
+        if (target == nullptr || ! (target == &component || target->isParentOf(&component)))
+            return false;
+
+        if (shader == nullptr)
+        {
+            shader = std::make_unique<juce::OpenGLGraphicsContextCustomShader>(makeShaderCode());
+            shader->onShaderActivated = [this] (juce::OpenGLShaderProgram& program) { setUniforms(program); };
+            if (shader->checkCompilation(g.getInternalContext()).failed())
+            {
+                unavailable = true;
+                return false;
+            }
+        }
+
+        auto* textures = getTextures(*context, history);
+        if (textures == nullptr)
+            return false;
+
+        upload(*textures, history);
+        bindTextures(*textures);
+
+        // Target pixels (what the shader sees as pixelPos) back to component space
+        const float scale = static_cast<float>(context->getRenderingScale());
+        const auto origin = target->getLocalPoint(&component, juce::Point<float>(0.0f, 0.0f)) * scale;
+        const auto unitX  = target->getLocalPoint(&component, juce::Point<float>(1.0f, 0.0f)) * scale;
+        const auto unitY  = target->getLocalPoint(&component, juce::Point<float>(0.0f, 1.0f)) * scale;
+        toLocal = juce::AffineTransform::fromTargetPoints(origin.x, origin.y, unitX.x, unitX.y, unitY.x, unitY.y)
+                      .inverted();
+
+        plot = plotArea.toFloat();
+        frame = history;
+        map = mapping;
+
+        shader->fillRect(g.getInternalContext(), plotArea);
+        return true;
+    }
+
+private:
+    static constexpr int kPaletteSize = 256;
+    static constexpr int kFirstUnit = 4;          // above the units JUCE's 2D renderer uses
+
+    /** Per-context GL objects; the context deletes them (while current) on shutdown. */
+    struct Textures : public juce::ReferenceCountedObject
+    {
+        ~Textures() override
+        {
+            using namespace juce::gl;
+            glDeleteTextures(3, ids);
+        }
+
+        GLuint ids[3] {};                         // levels, references, palette
+        int historySize = 0, numBins = 0;
+        juce::uint64 rowsUploaded = 0;
+        juce::uint32 generation = 0;
+        bool everUploaded = false;
+    };
+
+    static int nextInstanceId()
+    {
+        static std::atomic<int> counter { 0 };
+        return ++counter;
+    }
+
+    void storePaletteEntry(int row, int index, juce::Colour colour)
+    {
+        const auto premultiplied = colour.getPixelARGB();
+        auto* texel = palette.data() + (row * kPaletteSize + index) * 4;
+        texel[0] = premultiplied.getRed();
+        texel[1] = premultiplied.getGreen();
+        texel[2] = premultiplied.getBlue();
+        texel[3] = premultiplied.getAlpha();
+    }
+
+    //==========================================================================
+    juce::String makeShaderCode() const
+    {
+        // The instance name keeps each component's program (and its
+        // onShaderActivated) separate in the context's shader cache
+        return "// " + instanceName + "\n"
+               "uniform sampler2D levels;\n"
+               "uniform sampler2D references;\n"
+               "uniform sampler2D palette;\n"
+               "uniform " JUCE_HIGHP " vec3 toLocalX;\n"
+               "uniform " JUCE_HIGHP " vec3 toLocalY;\n"
+               "uniform " JUCE_HIGHP " vec4 plot;\n"       // x, y, w, h
+               "uniform " JUCE_HIGHP " vec3 ring;\n"       // next row to write, rows filled, history size
+               "uniform " JUCE_HIGHP " vec4 bins;\n"       // min freq, max / min freq, fftSize / sampleRate, numBins
+               "uniform " JUCE_HIGHP " vec3 levelScale;\n" // 1 / fftSize, classic min dB, classic max dB
+               "uniform float marathon;\n"
+               "\n"
+               "void main()\n"
+               "{\n"
+               "    " JUCE_HIGHP " vec3 p = vec3 (pixelPos, 1.0);\n"
+               "    " JUCE_HIGHP " vec2 local = vec2 (dot (toLocalX, p), dot (toLocalY, p));\n"
+               "    " JUCE_HIGHP " float age = floor (plot.x + plot.z - local.x);\n"
+               "    if (age < 0.0 || age >= ring.y || local.y < plot.y || local.y >= plot.y + plot.w)\n"
+               "    {\n"
+               "        gl_FragColor = vec4 (0.0);\n"
+               "        return;\n"
+               "    }\n"
+               "\n"
+               "    " JUCE_HIGHP " float row = mod (ring.x - 1.0 - age, ring.z);\n"
+               "    " JUCE_HIGHP " float v = (row + 0.5) / ring.z;\n"
+               "    " JUCE_HIGHP " float normY = 1.0 - (local.y - plot.y) / plot.w;\n"
+               "    " JUCE_HIGHP " float bin = bins.x * pow (bins.y, normY) * bins.z;\n"
+               "    " JUCE_HIGHP " float amplitude = texture2D (levels, vec2 ((bin + 0.5) / bins.w, v)).r * levelScale.x;\n"
+               "    " JUCE_HIGHP " float db = amplitude > 0.0 ? 20.0 * log (amplitude) / log (10.0) : -1000.0;\n"
+               "    " JUCE_HIGHP " float level;\n"
+               "    if (marathon > 0.5)\n"
+               "    {\n"
+               "        db = max (db, -120.0);\n"
+               "        " JUCE_HIGHP " float reference = texture2D (references, vec2 (v, 0.5)).r;\n"
+               "        " JUCE_HIGHP " float floorDb = max (-92.0, reference - 72.0);\n"
+               "        level = clamp ((db - floorDb) / max (18.0, reference - floorDb), 0.0, 1.0);\n"
+               "        level = pow (clamp (level * 1.10, 0.0, 1.0), 0.68);\n"
+               "        if (db <= floorDb || level < 0.02)\n"
+               "            level = 0.0;\n"
+               "    }\n"
+               "    else\n"
+               "    {\n"
+               "        db = max (db, -100.0);\n"
+               "        level = clamp ((db - levelScale.y) / (levelScale.z - levelScale.y), 0.0, 1.0);\n"
+               "    }\n"
+               "\n"
+               "    " JUCE_HIGHP " float u = (level * " + juce::String(kPaletteSize - 1) + ".0 + 0.5) / "
+                                                      + juce::String(kPaletteSize) + ".0;\n"
+               "    gl_FragColor = pixelAlpha * texture2D (palette, vec2 (u, marathon > 0.5 ? 0.75 : 0.25));\n"
+               "}\n";
+    }
+
+    void setUniforms(juce::OpenGLShaderProgram& program)
+    {
+        bindTexturesForProgram();
+
+        program.setUniform("levels", (GLint) kFirstUnit);
+        program.setUniform("references", (GLint) (kFirstUnit + 1));
+        program.setUniform("palette", (GLint) (kFirstUnit + 2));
+        program.setUniform("toLocalX", toLocal.mat00, toLocal.mat01, toLocal.mat02);
+        program.setUniform("toLocalY", toLocal.mat10, toLocal.mat11, toLocal.mat12);
+        program.setUniform("plot", plot.getX(), plot.getY(), plot.getWidth(), plot.getHeight());
+
+        const auto nextRow = static_cast<float>(frame.rowsWritten % (juce::uint64) frame.historySize);
+        const auto filled = static_cast<float>(juce::jmin<juce::uint64>(frame.rowsWritten, (juce::uint64) frame.historySize));
+        program.setUniform("ring", nextRow, filled, static_cast<float>(frame.historySize));
+        program.setUniform("bins", map.minFreq, map.maxFreq / map.minFreq, map.fftSize / map.sampleRate,
+                           static_cast<float>(frame.numBins));
+        program.setUniform("levelScale", 1.0f / map.fftSize, map.minDb, map.maxDb);
+        program.setUniform("marathon", map.marathonStyle ? 1.0f : 0.0f);
+    }
+
+    //==========================================================================
+    Textures* getTextures(juce::OpenGLContext& context, const History& history)
+    {
+        using namespace juce::gl;
+
+        if (auto* existing = dynamic_cast<Textures*>(context.getAssociatedObject(instanceName.toRawUTF8())))
+            if (existing->historySize == history.historySize && existing->numBins == history.numBins)
+                return existing;
+
+        juce::ReferenceCountedObjectPtr<Textures> textures = new Textures();
+        textures->historySize = history.historySize;
+        textures->numBins = history.numBins;
+
+        for (int i = 0; i < 16 && glGetError() != GL_NO_ERROR; ++i) {}    // don't blame earlier errors on us
+
+        GLint previousUnit = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &previousUnit);
+        glGenTextures(3, textures->ids);
+
+        auto create = [] (GLuint id, GLint internalFormat, int w, int h, GLenum format, GLenum type,
+                          const void* data, GLint filter)
+        {
+            glBindTexture(GL_TEXTURE_2D, id);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w, h, 0, format, type, data);
+        };
+
+        glActiveTexture(GL_TEXTURE0 + kFirstUnit);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        create(textures->ids[0], GL_R32F, history.numBins, history.historySize, GL_RED, GL_FLOAT, nullptr, GL_LINEAR);
+        glActiveTexture(GL_TEXTURE0 + kFirstUnit + 1);
+        create(textures->ids[1], GL_R32F, history.historySize, 1, GL_RED, GL_FLOAT, nullptr, GL_NEAREST);
+        glActiveTexture(GL_TEXTURE0 + kFirstUnit + 2);
+        create(textures->ids[2], GL_RGBA, kPaletteSize, 2, GL_RGBA, GL_UNSIGNED_BYTE, palette.data(), GL_LINEAR);
+        glActiveTexture((GLenum) previousUnit);
+
+        if (glGetError() != GL_NO_ERROR)
+        {
+            // No float textures on this context: stay on the CPU image
+            unavailable = true;
+            return nullptr;
+        }
+
+        context.setAssociatedObject(instanceName.toRawUTF8(), textures.get());
+        return textures.get();
+    }
+
+    /** Rows written since the last upload, or all of them after a rebuild. */
+    void upload(Textures& textures, const History& history)
+    {
+        using namespace juce::gl;
+
+        const auto size = static_cast<juce::uint64>(history.historySize);
+        const bool full = ! textures.everUploaded
+                       || textures.generation != history.generation
+                       || history.rowsWritten < textures.rowsUploaded
+                       || history.rowsWritten - textures.rowsUploaded >= size;
+
+        const int count = full ? history.historySize
+                               : static_cast<int>(history.rowsWritten - textures.rowsUploaded);
+        const int first = full ? 0 : static_cast<int>(textures.rowsUploaded % size);
+
+        textures.rowsUploaded = history.rowsWritten;
+        textures.generation = history.generation;
+        textures.everUploaded = true;
+        if (count == 0)
+            return;
+
+        GLint previousUnit = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &previousUnit);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        // At most two runs of rows: up to the end of the ring, then from its start
+        const int firstRun = juce::jmin(count, history.historySize - first);
+        const int runs[2][2] = { { first, firstRun }, { 0, count - firstRun } };
+
+        for (const auto& run : runs)
+        {
+            if (run[1] <= 0)
+                continue;
+
+            glActiveTexture(GL_TEXTURE0 + kFirstUnit);
+            glBindTexture(GL_TEXTURE_2D, textures.ids[0]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, run[0], history.numBins, run[1], GL_RED, GL_FLOAT,
+                            history.magnitudes + static_cast<size_t>(run[0]) * static_cast<size_t>(history.numBins));
+
+            glActiveTexture(GL_TEXTURE0 + kFirstUnit + 1);
+            glBindTexture(GL_TEXTURE_2D, textures.ids[1]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, run[0], 0, run[1], 1, GL_RED, GL_FLOAT,
+                            history.referenceDb + run[0]);
+        }
+
+        glActiveTexture((GLenum) previousUnit);
+    }
+
+    void bindTextures(const Textures& textures)
+    {
+        bound = { textures.ids[0], textures.ids[1], textures.ids[2] };
+        bindTexturesForProgram();
+    }
+
+    /** Also from onShaderActivated, in case another program used the units in between. */
+    void bindTexturesForProgram()
+    {
+        using namespace juce::gl;
+
+        GLint previousUnit = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &previousUnit);
+        for (int i = 0; i < 3; ++i)
+        {
+            glActiveTexture(GL_TEXTURE0 + (GLenum) (kFirstUnit + i));
+            glBindTexture(GL_TEXTURE_2D, bound[(size_t) i]);
+        }
+        glActiveTexture((GLenum) previousUnit);
+    }
+
+    //==========================================================================
+    const juce::String instanceName;
+    std::array<juce::uint8, kPaletteSize * 2 * 4> palette {};   // RGBA rows: classic, marathon
+    std::unique_ptr<juce::OpenGLGraphicsContextCustomShader> shader;
+    bool unavailable = false;
+
+    // What the current draw() hands to onShaderActivated
+    std::array<GLuint, 3> bound {};
+    juce::AffineTransform toLocal;
+    juce::Rectangle<float> plot;
+    History frame;
+    Mapping map;
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrogramGpuRenderer)
+};
+
+#endif // JUCE_MODULE_AVAILABLE_juce_opengl
@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+    SpectrumAnalysisWorker.h
+    GOODMETER - Off-audio-thread FFT analysis
+
+    Architecture:
+      - processBlock() copies raw L/R samples into a lock-free sample FIFO
+        (two memcpy per callback, nothing else)
+      - A background Thread drains the FIFO into a 4096-sample sliding ring
+        and, every hop, runs window + 4096-point magnitude FFT
+      - Each finished magnitude frame is written once, in place, into a
+        per-channel BroadcastRing; spectrum, spectrogram and any other
+        reader follow it with their own cursor (same frame format as before)
+      - A channel with no registered readers is not transformed
+      - setHopMultiple() stretches the hop (fewer frames per second) when
+        no reader needs the full rate or the device is throttling
+      - Log-frequency frames (LogSpectrumRing) come from a
+        MultiResolutionSpectrum per channel: 1024-point FFTs over the same
+        sliding ring plus decimated copies for the low octaves, published
+        on the same hop; again only for channels somebody reads
+
+    This keeps the transforms out of the audio callback, so the worst-case
+    callback time no longer spikes every 512-1024 samples.
+    Display-rate smoothing and dB mapping stay with each consumer, since
+    they run at the GUI frame rate rather than the FFT hop rate.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BroadcastRing.h"
+#include "MultiResolutionSpectrum.h"
+#include <array>
+
+//==============================================================================
+class SpectrumAnalysisWorker : public juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12; // 2^12 = 4096
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int spectrumHopSize = fftSize / 4;  // 75% overlap → hop = 1024
+
+    // 32 frames ≈ 0.75 s of spectra at the 1024 hop; readers keep their own cursor
+    using SpectrumRing = BroadcastRing<float, 32, fftSize / 2>;
+
+    // Stitched multi-resolution frames: kNumBins log-spaced magnitudes / 1024
+    static constexpr int numLogBins = MultiResolutionSpectrum::kNumBins;
+    using LogSpectrumRing = BroadcastRing<float, 32, numLogBins>;
+
+    SpectrumAnalysisWorker(SpectrumRing& framesLeft, SpectrumRing& framesRight,
+                           LogSpectrumRing& logFramesLeft, LogSpectrumRing& logFramesRight, int frameHop)
+        : Thread("GOODMETER-Spectrum"),
+          framesL(framesLeft),
+          framesR(framesRight),
+          logFramesL(logFramesLeft),
+          logFramesR(logFramesRight),
+          hopSize(juce::jlimit(1, fftSize, frameHop)),
+          sampleFifo(fifoSize)
+    {
+        ringL.fill(0.0f);
+        ringR.fill(0.0f);
+        workBuffer.fill(0.0f);
+    }
+
+    ~SpectrumAnalysisWorker() override
+    {
+        release();
+    }
+
+    //==========================================================================
+    /** (Re)start analysis from silence. Call from prepareToPlay. */
+    void prepare(double sampleRate)
+    {
+        release();
+
+        multiResL.prepare(sampleRate);
+        multiResR.prepare(sampleRate);
+        sampleFifo.reset();
+        ringL.fill(0.0f);
+        ringR.fill(0.0f);
+        ringIndex = 0;
+        samplesSinceHop = 0;
+        fifoOverrun.store(false, std::memory_order_relaxed);
+
+        active.store(true, std::memory_order_release);
+        startThread(juce::Thread::Priority::normal);
+    }
+
+    /** Stop the worker; pushSamples() becomes a no-op. */
+    void release()
+    {
+        active.store(false, std::memory_order_release);
+        if (isThreadRunning())
+        {
+            // Wake the poll now instead of waiting it out: every re-prepare
+            // goes through here, once per instance
+            signalThreadShouldExit();
+            notify();
+            stopThread(2000);
+        }
+    }
+
+    /** Any thread: one frame every multiple × frameHop samples (capped so
+     *  consecutive windows still overlap or touch). */
+    void setHopMultiple(int multiple) noexcept
+    {
+        hopMultiple.store(juce::jlimit(1, juce::jmax(1, fftSize / hopSize), multiple), std::memory_order_relaxed);
+    }
+
+    /** Samples dropped because the worker fell more than fifoSize behind */
+    bool didOverrun() const noexcept { return fifoOverrun.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    /** Audio thread: copy one block of raw samples. Lock-free, no allocation.
+     *  Returns the number of samples dropped because the FIFO was full. */
+    int pushSamples(const float* left, const float* right, int numSamples) noexcept
+    {
+        if (! active.load(std::memory_order_acquire) || numSamples <= 0)
+            return 0;
+
+        int start1, size1, start2, size2;
+        sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        if (size1 + size2 < numSamples)
+            fifoOverrun.store(true, std::memory_order_relaxed);
+
+        if (size1 > 0)
+        {
+            std::copy(left, left + size1, fifoL.begin() + start1);
+            std::copy(right, right + size1, fifoR.begin() + start1);
+        }
+        if (size2 > 0)
+        {
+            std::copy(left + size1, left + size1 + size2, fifoL.begin() + start2);
+            std::copy(right + size1, right + size1 + size2, fifoR.begin() + start2);
+        }
+
+        sampleFifo.finishedWrite(size1 + size2);
+        return numSamples - (size1 + size2);
+    }
+
+private:
+    //==========================================================================
+    // Thread: drain sample FIFO, run FFTs on hop boundaries
+    //==========================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            drainFifo();
+            wait(5);  // ~200Hz polling: well under one hop (21 ms @ 48k)
+        }
+    }
+
+    void drainFifo()
+    {
+        int start1, size1, start2, size2;
+        sampleFifo.prepareToRead(sampleFifo.getNumReady(), start1, size1, start2, size2);
+
+        if (size1 > 0) consume(fifoL.data() + start1, fifoR.data() + start1, size1);
+        if (size2 > 0) consume(fifoL.data() + start2, fifoR.data() + start2, size2);
+
+        sampleFifo.finishedRead(size1 + size2);
+    }
+
+    /** Block copies into the sliding ring, split at hop boundaries so every
+        frame sees exactly the samples of the old per-sample loop. */
+    void consume(const float* left, const float* right, int numSamples)
+    {
+        const int hop = hopSize * hopMultiple.load(std::memory_order_relaxed);
+        const bool logLeft = logFramesL.hasReaders();
+        const bool logRight = logFramesR.hasReaders();
+
+        for (int done = 0; done < numSamples;)
+        {
+            // max(1, ...): the hop may just have shrunk below samplesSinceHop
+            const int segment = juce::jmin(numSamples - done,
+                                           fftSize - ringIndex,
+                                           juce::jmax(1, hop - samplesSinceHop));
+
+            std::copy(left + done, left + done + segment, ringL.begin() + ringIndex);
+            std::copy(right + done, right + done + segment, ringR.begin() + ringIndex);
+            if (logLeft)  multiResL.push(left + done, segment);
+            if (logRight) multiResR.push(right + done, segment);
+            ringIndex = (ringIndex + segment) % fftSize;
+            samplesSinceHop += segment;
+            done += segment;
+
+            if (samplesSinceHop >= hop)
+            {
+                // One transform per channel per hop, published once for every reader;
+                // channels nobody is reading are not transformed at all
+                if (framesL.hasReaders()) publishFrame(ringL, framesL);
+                if (framesR.hasReaders()) publishFrame(ringR, framesR);
+                if (logLeft)  publishLogFrame(multiResL, ringL, logFramesL);
+                if (logRight) publishLogFrame(multiResR, ringR, logFramesR);
+                samplesSinceHop = 0;
+            }
+        }
+    }
+
+    void publishFrame(const std::array<float, fftSize>& ring, SpectrumRing& frames)
+    {
+        runFftFromRing(ring);
+        std::copy(workBuffer.begin(), workBuffer.begin() + fftSize / 2, frames.beginWrite());
+        frames.endWrite();
+    }
+
+    void publishLogFrame(MultiResolutionSpectrum& engine, const std::array<float, fftSize>& ring, LogSpectrumRing& frames)
+    {
+        engine.computeFrame(ring.data(), fftSize, ringIndex, frames.beginWrite());
+        frames.endWrite();
+    }
+
+    void runFftFromRing(const std::array<float, fftSize>& ring)
+    {
+        // Oldest sample sits at ringIndex: two contiguous copies unwrap the ring
+        const int tail = fftSize - ringIndex;
+        std::copy(ring.begin() + ringIndex, ring.end(), workBuffer.begin());
+        std::copy(ring.begin(), ring.begin() + ringIndex, workBuffer.begin() + tail);
+
+        std::fill(workBuffer.begin() + fftSize, workBuffer.end(), 0.0f);
+        window.multiplyWithWindowingTable(workBuffer.data(), fftSize);
+        fft.performFrequencyOnlyForwardTransform(workBuffer.data());
+    }
+
+    //==========================================================================
+    SpectrumRing& framesL;
+    SpectrumRing& framesR;
+    LogSpectrumRing& logFramesL;
+    LogSpectrumRing& logFramesR;
+    const int hopSize;
+    std::atomic<int> hopMultiple { 1 };
+
+    std::atomic<bool> active { false };
+    std::atomic<bool> fifoOverrun { false };
+
+    // Sample FIFO: ~340 ms at 48kHz, planar L/R sharing one AbstractFifo
+    // (not zeroed: only ranges the audio thread has written are ever read)
+    static constexpr int fifoSize = 16384;
+    juce::AbstractFifo sampleFifo;
+    std::array<float, fifoSize> fifoL;
+    std::array<float, fifoSize> fifoR;
+
+    // Worker-side sliding window (never touched by the audio thread)
+    std::array<float, fftSize> ringL;
+    std::array<float, fftSize> ringR;
+    int ringIndex = 0;
+    int samplesSinceHop = 0;
+
+    // In-place transform needs fftSize * 2
+    std::array<float, fftSize * 2> workBuffer;
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { fftSize, juce::dsp::WindowingFunction<float>::hann };
+
+    // Multi-resolution engines (tier 0 reads ringL / ringR)
+    MultiResolutionSpectrum multiResL, multiResR;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalysisWorker)
+};
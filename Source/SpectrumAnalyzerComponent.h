@@ -4,38 +4,49 @@
     GOODMETER - FFT Spectrum Analyzer
 
     Commercial-Grade 75% Overlap + Independent GUI Lerp Architecture:
-    - Backend: 75% overlap (hop=1024) → ~43Hz FFT frame rate
-    - FIFO: 16-slot lock-free ring buffer, zero contention with Spectrogram
+    - Backend: multi-resolution log-frequency frames (1024-point FFT per
+      octave tier, hop=1024 → ~43Hz frame rate): 21 ms windows in the
+      treble, ~3-6 Hz bins under 190 Hz
+    - FIFO: 32-slot broadcast ring, own cursor, zero contention with Spectrogram
     - Frontend: targetData / smoothedData separation, 60Hz independent lerp
+    - Drawing: a per-width column map (rebuilt on resize) reduces the log
+      bins to one value per couple of pixels, so the per-frame cost follows
+      the component width
   ==============================================================================
 */
 
 #pragma once
 
 #include <JuceHeader.h>
+#include <cmath>
+#include <vector>
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
+#include "FrameScheduler.h"
+
+#if JUCE_MAC || JUCE_IOS
+ #include <Accelerate/Accelerate.h>
+#endif
 
 //==============================================================================
 class SpectrumAnalyzerComponent : public juce::Component,
-                                   public juce::Timer
+                                   public FrameScheduler::Client
 {
 public:
     //==========================================================================
     SpectrumAnalyzerComponent(GOODMETERAudioProcessor& processor)
-        : audioProcessor(processor)
+        : FrameScheduler::Client(this), audioProcessor(processor)
     {
         targetData.fill(0.0f);
         smoothedData.fill(0.0f);
-        tempBuffer.fill(0.0f);
 
         setSize(100, 200);
-        startTimerHz(60);
+        startFrames();
     }
 
     ~SpectrumAnalyzerComponent() override
     {
-        stopTimer();
+        stopFrames();
     }
 
     void setMarathonDarkStyle(bool shouldUse)
@@ -77,42 +88,51 @@ public:
 
     void resized() override
     {
-        auto bounds = getChartBounds();
-
-        if (bounds.isEmpty() || bounds.getWidth() <= 0)
-            return;
-
-        const float width = bounds.getWidth();
-
-        cachedXCoords.resize(numBins);
-        for (int bin = 0; bin < numBins; ++bin)
-        {
-            const float freq = binToFrequency(bin);
-            cachedXCoords[bin] = bounds.getX() + frequencyToX(freq, width);
-        }
+        rebuildColumnMap(getChartBounds());
     }
 
 private:
     //==========================================================================
     GOODMETERAudioProcessor& audioProcessor;
 
-    static constexpr int numBins = GOODMETERAudioProcessor::fftSize / 2;
+    static constexpr int numBins = GOODMETERAudioProcessor::numLogSpectrumBins;
+
+    // Own cursor into the processor's log-frequency spectrum ring; the 35% GUI
+    // lerp hides anything faster than ~30 new frames a second
+    GOODMETERAudioProcessor::LogSpectrumRing::Reader frameReader { audioProcessor.logSpectrumFramesL };
+    AnalysisDemand::Subscription spectrumDemand { audioProcessor.analysisDemand,
+                                                  AnalysisDemand::Analysis::spectrum, 30.0f };
 
-    // Three-tier data architecture:
-    // tempBuffer  → raw FIFO drain buffer (transient, overwritten each pop)
+    // Two-tier data architecture (the ring copies straight into targetData):
     // targetData  → latest FFT snapshot (the "truth" the display chases)
     // smoothedData → what actually gets rendered (lerps toward targetData every frame)
-    std::array<float, numBins> tempBuffer;
     std::array<float, numBins> targetData;
     std::array<float, numBins> smoothedData;
     bool hasValidData = false;
 
-    // X coordinate lookup table (recomputed only on resize)
-    std::vector<float> cachedXCoords;
+    // Bin → pixel column map (recomputed only on resize). Columns wider than
+    // a log bin take the loudest bin they cover; narrower ones interpolate.
+    struct Column
+    {
+        int firstBin = 0;       // reduce [firstBin, endBin) ...
+        int endBin = 0;
+        int interpBin = 0;      // ... or, if that's empty, lerp interpBin → interpBin + 1
+        float fraction = 0.0f;
+    };
+    static constexpr float pixelsPerColumn = 2.0f;
+    std::vector<Column> columns;
+    std::vector<float> columnX;
+    std::vector<float> columnY;                // per frame: magnitude → dB → y, in place
+    juce::Rectangle<float> columnMapBounds;
+
+    // Reused every frame (Path::clear keeps the storage)
+    juce::Path linePath, fillPath;
 
     // Frequency range
     static constexpr float minFreq = 20.0f;
     static constexpr float maxFreq = 20000.0f;
+    static_assert(minFreq == MultiResolutionSpectrum::kMinFrequency && maxFreq == MultiResolutionSpectrum::kMaxFrequency,
+                  "The chart's log axis is the log bins' axis");
 
     // Y axis dynamic range
     static constexpr float minDb = -100.0f;
@@ -131,7 +151,12 @@ private:
     }
 
     //==========================================================================
-    void timerCallback() override
+    void onScreenChanged(bool isNowOnScreen) override
+    {
+        spectrumDemand.setActive(isNowOnScreen);
+    }
+
+    void frameTick() override
     {
         // 60Hz → 30Hz smart throttle during mouse drag
         if (juce::ModifierKeys::currentModifiers.isAnyMouseButtonDown())
@@ -140,27 +165,18 @@ private:
             if (++dragThrottleCounter % 2 != 0) return;
         }
 
-        // === 1. Flush FIFO: drain everything, keep only the latest frame ===
-        bool gotNewData = false;
-        while (audioProcessor.fftFifoL.pop(tempBuffer.data(), numBins))
-        {
-            std::copy(tempBuffer.begin(), tempBuffer.end(), targetData.begin());
-            gotNewData = true;
-        }
-
-        if (gotNewData)
+        // === 1. Take the latest published frame (older ones are skipped) ===
+        if (frameReader.readLatest(targetData.data()))
             hasValidData = true;
 
         // === 2. Independent GUI lerp: ALWAYS runs, even without new FFT data ===
         // smoothedData chases targetData at 35% per frame → silky 60Hz animation
         const float smoothing = 0.35f;
-        for (int i = 0; i < numBins; ++i)
-        {
-            smoothedData[i] += (targetData[i] - smoothedData[i]) * smoothing;
-        }
+        juce::FloatVectorOperations::multiply(smoothedData.data(), 1.0f - smoothing, numBins);
+        juce::FloatVectorOperations::addWithMultiply(smoothedData.data(), targetData.data(), smoothing, numBins);
 
-        // === 3. Unconditional repaint: full 60Hz visual refresh ===
-        repaint();
+        // === 3. Repaint every frame we are on screen for (batched per window) ===
+        repaintFrame();
     }
 
     //==========================================================================
@@ -173,10 +189,9 @@ private:
         return ((logFreq - logMin) / (logMax - logMin)) * width;
     }
 
-    float binToFrequency(int bin) const
+    float xToFrequency(float x, float width) const
     {
-        const float sampleRate = static_cast<float>(audioProcessor.getSampleRate());
-        return (bin * sampleRate) / static_cast<float>(GOODMETERAudioProcessor::fftSize);
+        return minFreq * std::pow(maxFreq / minFreq, x / width);
     }
 
     float dbToY(float db, float height, float topY) const
@@ -186,39 +201,112 @@ private:
     }
 
     //==========================================================================
-    void drawSpectrum(juce::Graphics& g, const juce::Rectangle<float>& bounds)
+    /** One column every pixelsPerColumn px across bounds, with the bins each covers. */
+    void rebuildColumnMap(const juce::Rectangle<float>& bounds)
     {
-        const float height = bounds.getHeight();
-        const float topY = bounds.getY();
+        columnMapBounds = bounds;
+        columns.clear();
+        columnX.clear();
 
-        if (cachedXCoords.empty())
+        const float width = bounds.getWidth();
+        if (width <= 0.0f)
             return;
 
-        juce::Path linePath;
-        linePath.startNewSubPath(bounds.getX(), bounds.getBottom());
+        auto binAt = [&](float x)     // fractional log bin under chart x
+        {
+            return juce::jlimit(0.0f, width, x) / width * static_cast<float>(numBins - 1);
+        };
 
-        const int maxPoints = 250;
-        const int step = juce::jmax(1, numBins / maxPoints);
+        const int numColumns = static_cast<int>(std::ceil(width / pixelsPerColumn)) + 1;
+        columns.reserve(static_cast<size_t>(numColumns));
+        columnX.reserve(static_cast<size_t>(numColumns));
 
-        for (int bin = 1; bin < numBins; bin += step)
+        for (int c = 0; c < numColumns; ++c)
         {
-            if (bin >= static_cast<int>(cachedXCoords.size()))
-                break;
+            const float x = juce::jmin(width, static_cast<float>(c) * pixelsPerColumn);
+            const float lo = binAt(x - 0.5f * pixelsPerColumn);
+            const float hi = binAt(x + 0.5f * pixelsPerColumn);
+
+            Column column;
+            column.firstBin = juce::jlimit(0, numBins, static_cast<int>(std::ceil(lo)));
+            column.endBin = juce::jlimit(column.firstBin, numBins, static_cast<int>(std::floor(hi)) + 1);
+            if (hi - lo < 1.0f)
+                column.endBin = column.firstBin;     // narrower than a bin: interpolate instead
+
+            const float centre = binAt(x);
+            column.interpBin = juce::jlimit(0, numBins - 2, static_cast<int>(centre));
+            column.fraction = juce::jlimit(0.0f, 1.0f, centre - static_cast<float>(column.interpBin));
+
+            columns.push_back(column);
+            columnX.push_back(bounds.getX() + x);
+        }
+
+        columnY.resize(columns.size());
+        linePath.preallocateSpace(3 * numColumns + 8);
+        fillPath.preallocateSpace(3 * numColumns + 16);
+    }
+
+    /** Column values for this frame: reduce, then dB and y for all columns at once. */
+    void computeColumnY(float height, float topY)
+    {
+        const int numColumns = static_cast<int>(columns.size());
+        for (int c = 0; c < numColumns; ++c)
+        {
+            const auto& column = columns[static_cast<size_t>(c)];
+            float magnitude;
+            if (column.endBin > column.firstBin)
+            {
+                magnitude = juce::FloatVectorOperations::findMaximum(smoothedData.data() + column.firstBin,
+                                                                     column.endBin - column.firstBin);
+            }
+            else
+            {
+                const float a = smoothedData[static_cast<size_t>(column.interpBin)];
+                const float b = smoothedData[static_cast<size_t>(column.interpBin + 1)];
+                magnitude = a + column.fraction * (b - a);
+            }
+            columnY[static_cast<size_t>(c)] = magnitude;
+        }
 
-            const float freq = binToFrequency(bin);
-            if (freq < minFreq || freq > maxFreq)
-                continue;
+        // gainToDecibels(m, -100) (log frames are already magnitude / FFT size):
+        // clamp at 1e-5, 20·log10, then the dbToY line
+        auto* y = columnY.data();
+        juce::FloatVectorOperations::max(y, y, 1.0e-5f, numColumns);
+       #if JUCE_MAC || JUCE_IOS
+        vvlog10f(y, y, &numColumns);
+       #else
+        for (int c = 0; c < numColumns; ++c)
+            y[c] = std::log10(y[c]);
+       #endif
+
+        const float bottom = topY + height;
+        const float top = topY + height * 0.2f;
+        const float slope = (top - bottom) / (maxDb - minDb);
+        juce::FloatVectorOperations::multiply(y, 20.0f * slope, numColumns);
+        juce::FloatVectorOperations::add(y, bottom - minDb * slope, numColumns);
+    }
 
-            const float x = cachedXCoords[bin];
-            const float rawMagnitude = smoothedData[bin];
-            const float scaledAmplitude = rawMagnitude / static_cast<float>(GOODMETERAudioProcessor::fftSize);
-            const float db = juce::Decibels::gainToDecibels(scaledAmplitude, -100.0f);
-            const float y = dbToY(db, height, topY);
+    void drawSpectrum(juce::Graphics& g, const juce::Rectangle<float>& bounds)
+    {
+        if (bounds != columnMapBounds)
+            rebuildColumnMap(bounds);
 
-            linePath.lineTo(x, y);
+        if (columns.empty())
+            return;
+
+        computeColumnY(bounds.getHeight(), bounds.getY());
+
+        linePath.clear();
+        fillPath.clear();
+        linePath.startNewSubPath(bounds.getX(), bounds.getBottom());
+        fillPath.startNewSubPath(bounds.getX(), bounds.getBottom());
+
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            linePath.lineTo(columnX[c], columnY[c]);
+            fillPath.lineTo(columnX[c], columnY[c]);
         }
 
-        juce::Path fillPath(linePath);
         fillPath.lineTo(bounds.getRight(), bounds.getBottom());
         fillPath.closeSubPath();
 
@@ -17,7 +17,9 @@
 */
 
 #include <JuceHeader.h>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 
 #if JucePlugin_Build_Standalone
 
@@ -26,7 +28,11 @@
 #include "GoodMeterLookAndFeel.h"
 #include "AudioLabComponent.h"
 #include "StandaloneNonoEditor.h"
-#include "AudioDoctorJobRunner.h"
+#include "AudioDoctorBatchRunner.h"
+#include "MeterKernelBenchmark.h"
+#include "ProcessBlockBenchmark.h"
+#include "OfflineAnalysisBenchmark.h"
+#include "DriftBridgeBenchmark.h"
 
 #if JUCE_MAC
  #include <objc/message.h>
@@ -305,7 +311,12 @@ public:
     bool moreThanOneInstanceAllowed() override
     {
         const auto args = juce::JUCEApplicationBase::getCommandLineParameterArray();
-        return args.indexOf("--audio-doctor-job") >= 0 || args.indexOf("--doctor-job") >= 0;
+        return args.indexOf("--audio-doctor-job") >= 0 || args.indexOf("--doctor-job") >= 0
+            || args.indexOf("--audio-doctor-batch") >= 0
+            || args.indexOf("--benchmark-meter-kernel") >= 0
+            || args.indexOf("--benchmark-process-block") >= 0
+            || args.indexOf("--benchmark-offline") >= 0
+            || args.indexOf("--benchmark-drift-bridge") >= 0;
     }
 
     //==========================================================================
@@ -314,6 +325,21 @@ public:
         if (runAudioDoctorJobIfRequested(commandLine, true))
             return;
 
+        if (runAudioDoctorBatchIfRequested(commandLine))
+            return;
+
+        if (runMeterBenchmarkIfRequested(commandLine))
+            return;
+
+        if (runProcessBlockBenchmarkIfRequested(commandLine))
+            return;
+
+        if (runOfflineBenchmarkIfRequested(commandLine))
+            return;
+
+        if (runDriftBridgeBenchmarkIfRequested(commandLine))
+            return;
+
         if (juce::Desktop::getInstance().getDisplays().displays.isEmpty())
             return;
 
@@ -355,6 +381,7 @@ public:
         juce::MenuBarModel::setMacMainMenu(nullptr);
 #endif
         mainWindow = nullptr;
+        goodmeter::audio_doctor::PluginInstanceCache::getInstance().clear();   // before JUCE goes away
         appProperties.saveIfNeeded();
         juce::LookAndFeel::setDefaultLookAndFeel(nullptr);
     }
@@ -410,6 +437,237 @@ public:
         return true;
     }
 
+    bool runAudioDoctorBatchIfRequested(const juce::String& commandLine)
+    {
+        juce::StringArray args;
+        args.addTokens(commandLine, true);
+        args.trim();
+        args.removeEmptyStrings();
+
+        // --audio-doctor-batch <job directory | manifest.json> [--batch-jobs N]
+        const int index = args.indexOf("--audio-doctor-batch");
+        if (index < 0 || index + 1 >= args.size())
+            return false;
+
+        const auto batchPath = args[index + 1].unquoted().trim();
+        const int jobsIndex = args.indexOf("--batch-jobs");
+        const int maxParallelJobs = jobsIndex >= 0 && jobsIndex + 1 < args.size() ? args[jobsIndex + 1].getIntValue() : 0;
+
+        juce::String response;
+        const bool ok = goodmeter::audio_doctor::runAudioDoctorBatch(juce::File(batchPath), response, maxParallelJobs);
+        std::cout << response << std::endl;
+        setApplicationReturnValue(ok ? 0 : 1);
+        quit();
+        return true;
+    }
+
+    bool runMeterBenchmarkIfRequested(const juce::String& commandLine)
+    {
+        juce::StringArray args;
+        args.addTokens(commandLine, true);
+        args.trim();
+        args.removeEmptyStrings();
+
+        const int index = args.indexOf("--benchmark-meter-kernel");
+        if (index < 0)
+            return false;
+
+        // Optional positional overrides: [blockSize] [sampleRate] [instances]
+        auto numericArg = [&args](int i, double fallback)
+        {
+            return (i < args.size() && ! args[i].startsWith("--")) ? args[i].getDoubleValue() : fallback;
+        };
+
+        const int blockSize = static_cast<int>(numericArg(index + 1, 512.0));
+        const double sampleRate = numericArg(index + 2, 48000.0);
+        const int instances = static_cast<int>(numericArg(index + 3, 20.0));
+
+        std::cout << goodmeter::benchmark::runMeterKernelBenchmark(blockSize, sampleRate, instances) << std::endl;
+        quit();
+        return true;
+    }
+
+    bool runProcessBlockBenchmarkIfRequested(const juce::String& commandLine)
+    {
+        juce::StringArray args;
+        args.addTokens(commandLine, true);
+        args.trim();
+        args.removeEmptyStrings();
+
+        if (args.indexOf("--benchmark-process-block") < 0)
+            return false;
+
+        // Optional comma-separated overrides, e.g. --block-sizes 64,512 --channels 2
+        auto listArg = [&args](const char* flag)
+        {
+            juce::StringArray values;
+            const int i = args.indexOf(flag);
+            if (i >= 0 && i + 1 < args.size())
+                values.addTokens(args[i + 1], ",", {});
+            values.removeEmptyStrings();
+            return values;
+        };
+
+        goodmeter::benchmark::ProcessBlockSweepOptions options;
+
+        if (const auto values = listArg("--block-sizes"); ! values.isEmpty())
+        {
+            options.blockSizes.clear();
+            for (const auto& v : values)
+                options.blockSizes.push_back(v.getIntValue());
+        }
+
+        if (const auto values = listArg("--sample-rates"); ! values.isEmpty())
+        {
+            options.sampleRates.clear();
+            for (const auto& v : values)
+                options.sampleRates.push_back(v.getDoubleValue());
+        }
+
+        if (const auto values = listArg("--channels"); ! values.isEmpty())
+        {
+            options.channelCounts.clear();
+            for (const auto& v : values)
+                options.channelCounts.push_back(v.getIntValue());
+        }
+
+        if (const auto values = listArg("--seconds"); ! values.isEmpty())
+            options.secondsPerSignal = values[0].getDoubleValue();
+
+        std::cout << goodmeter::benchmark::runProcessBlockSweep(options) << std::endl;
+        quit();
+        return true;
+    }
+
+    bool runDriftBridgeBenchmarkIfRequested(const juce::String& commandLine)
+    {
+        juce::StringArray args;
+        args.addTokens(commandLine, true);
+        args.trim();
+        args.removeEmptyStrings();
+
+        if (args.indexOf("--benchmark-drift-bridge") < 0)
+            return false;
+
+        // Optional overrides, e.g. --drifts 200,-300 --tap-rates 44100 --seconds 60
+        auto listArg = [&args](const char* flag)
+        {
+            juce::StringArray values;
+            const int i = args.indexOf(flag);
+            if (i >= 0 && i + 1 < args.size())
+                values.addTokens(args[i + 1], ",", {});
+            values.removeEmptyStrings();
+            return values;
+        };
+
+        goodmeter::benchmark::DriftBridgeOptions options;
+
+        if (const auto values = listArg("--tap-rates"); ! values.isEmpty())
+        {
+            options.tapRates.clear();
+            for (const auto& v : values)
+                options.tapRates.push_back(v.getDoubleValue());
+        }
+
+        if (const auto values = listArg("--drifts"); ! values.isEmpty())
+        {
+            options.driftsPpm.clear();
+            for (const auto& v : values)
+                options.driftsPpm.push_back(v.getDoubleValue());
+        }
+
+        if (const auto values = listArg("--device-rate"); ! values.isEmpty())
+            options.deviceRate = values[0].getDoubleValue();
+
+        if (const auto values = listArg("--seconds"); ! values.isEmpty())
+            options.seconds = values[0].getDoubleValue();
+
+        if (const auto values = listArg("--block-size"); ! values.isEmpty())
+            options.blockSize = values[0].getIntValue();
+
+        if (const auto values = listArg("--tap-chunk"); ! values.isEmpty())
+            options.tapChunk = values[0].getIntValue();
+
+        if (const auto values = listArg("--jitter-ms"); ! values.isEmpty())
+            options.jitterMs = values[0].getDoubleValue();
+
+        std::cout << goodmeter::benchmark::runDriftBridgeBenchmark(options) << std::endl;
+        quit();
+        return true;
+    }
+
+    bool runOfflineBenchmarkIfRequested(const juce::String& commandLine)
+    {
+        juce::StringArray args;
+        args.addTokens(commandLine, true);
+        args.trim();
+        args.removeEmptyStrings();
+
+        if (args.indexOf("--benchmark-offline") < 0)
+            return false;
+
+        auto valueArg = [&args](const char* flag)
+        {
+            const int i = args.indexOf(flag);
+            return (i >= 0 && i + 1 < args.size()) ? args[i + 1].unquoted().trim() : juce::String();
+        };
+
+        auto listArg = [&valueArg](const char* flag)
+        {
+            juce::StringArray values;
+            values.addTokens(valueArg(flag), ",", {});
+            values.trim();
+            values.removeEmptyStrings();
+            return values;
+        };
+
+        goodmeter::benchmark::OfflineBenchmarkOptions options;
+
+        if (const auto values = listArg("--durations"); ! values.isEmpty())
+        {
+            options.durations.clear();
+            for (const auto& v : values)
+                options.durations.push_back(v.getDoubleValue());
+        }
+
+        if (const auto values = listArg("--channels"); ! values.isEmpty())
+        {
+            options.channelCounts.clear();
+            for (const auto& v : values)
+                options.channelCounts.push_back(v.getIntValue());
+        }
+
+        options.workloads = listArg("--workloads");
+
+        if (const auto v = valueArg("--passes"); v.isNotEmpty())
+            options.passes = v.getIntValue();
+        if (const auto v = valueArg("--sample-rate"); v.isNotEmpty())
+            options.sampleRate = v.getDoubleValue();
+        if (const auto v = valueArg("--time-tolerance"); v.isNotEmpty())
+            options.timeTolerance = v.getDoubleValue();
+        if (const auto v = valueArg("--memory-tolerance"); v.isNotEmpty())
+            options.memoryTolerance = v.getDoubleValue();
+
+        // Relative paths resolve against the working directory
+        auto fileArg = [&valueArg](const char* flag)
+        {
+            const auto path = valueArg(flag);
+            return path.isEmpty() ? juce::File()
+                                  : juce::File::getCurrentWorkingDirectory().getChildFile(path);
+        };
+
+        options.pluginFile = fileArg("--plugin");
+        options.deepFilterModels = fileArg("--deepfilter-models");
+        options.baselineFile = fileArg("--baseline");
+        options.writeBaselineFile = fileArg("--write-baseline");
+
+        int regressions = 0;
+        std::cout << goodmeter::benchmark::runOfflineBenchmark(options, regressions) << std::endl;
+        setApplicationReturnValue(regressions > 0 ? 1 : 0);
+        quit();
+        return true;
+    }
+
     void systemRequestedQuit() override
     {
         if (mainWindow != nullptr)
@@ -496,6 +754,8 @@ public:
             rewindMenu.addItem(611, "1 min", true, curSec == 60);
             rewindMenu.addItem(612, "2 min", true, curSec == 120);
             rewindMenu.addItem(613, "5 min", true, curSec == 300);
+            rewindMenu.addItem(614, "30 min (compressed)", true, curSec == 1800);
+            rewindMenu.addItem(615, "60 min (on disk)", true, curSec == 3600);
             menu.addSubMenu(juce::CharPointer_UTF8(u8"\u23ea Rewind Duration"), rewindMenu);
         }
 
@@ -516,6 +776,9 @@ public:
             bool sysActive = (proc != nullptr && proc->useSystemAudio.load(std::memory_order_relaxed));
             menu.addItem(700, "Microphone Input", true, !sysActive);
             menu.addItem(701, "System Audio (CoreAudio Tap)", true, sysActive);
+            menu.addSeparator();
+            menu.addItem(702, "Denoise Live Input (DeepFilterNet3)", proc != nullptr,
+                         proc != nullptr && proc->isLiveDenoiseEnabled());
 #else
             menu.addItem(-1, "System audio requires macOS 14.2+", false);
 #endif
@@ -523,6 +786,10 @@ public:
         else if (menuIndex == 2)
         {
             menu.addItem(803, "Open Audio Doctor");
+
+            // Hidden: only listed while Option/Alt is held as the menu opens
+            if (juce::ModifierKeys::getCurrentModifiersRealtime().isAltDown())
+                menu.addItem(804, "Engine Diagnostics...");
             menu.addSeparator();
 
             // ── Audio Lab export mode: radio group ──
@@ -602,14 +869,14 @@ public:
             if (target.existsAsFile())
                 target.revealToUser();
         }
-        else if (menuItemID >= 610 && menuItemID <= 613)
+        else if (menuItemID >= 610 && menuItemID <= 615)
         {
-            // Rewind Duration: 610=30s, 611=60s, 612=120s, 613=300s
-            static constexpr int durations[] = { 30, 60, 120, 300 };
+            // Rewind Duration: 610=30s, 611=60s, 612=120s, 613=300s, 614=1800s, 615=3600s
+            static constexpr int durations[] = { 30, 60, 120, 300, 1800, 3600 };
             int idx = menuItemID - 610;
             auto* proc = getProcessor();
             if (proc != nullptr)
-                proc->rewindSeconds.store(durations[idx], std::memory_order_relaxed);
+                proc->setRewindSeconds(durations[idx]);
             menuItemsChanged();
         }
         else if (menuItemID == 60)
@@ -672,6 +939,16 @@ public:
             }
             menuItemsChanged();
         }
+        else if (menuItemID == 702)  // Live denoise toggle
+        {
+            if (auto* proc = getProcessor())
+            {
+                // Stays unticked when the models are missing
+                if (! proc->setLiveDenoiseEnabled(! proc->isLiveDenoiseEnabled()))
+                    DBG("DeepFilterNet3 models not found — live denoise unavailable");
+            }
+            menuItemsChanged();
+        }
 #endif
         else if (menuItemID >= 800 && menuItemID <= 802)
         {
@@ -685,6 +962,12 @@ public:
                 if (auto* editor = dynamic_cast<StandaloneNonoEditor*>(mainWindow->getEditor()))
                     editor->openAudioDoctorDialog();
         }
+        else if (menuItemID == 804)
+        {
+            if (mainWindow != nullptr)
+                if (auto* editor = dynamic_cast<StandaloneNonoEditor*>(mainWindow->getEditor()))
+                    editor->openDiagnosticsWindow();
+        }
         else if (menuItemID == 900)
         {
             setCurrentSkin(HoloNonoComponent::SkinType::Guoba);
@@ -769,4 +1052,35 @@ private:
 // Register our custom app with JUCE's application framework
 JUCE_CREATE_APPLICATION_DEFINE(goodmeter::GoodMeterStandaloneApp)
 
+//==============================================================================
+// Global operator new so the benchmarks can count allocations: per thread
+// inside processBlock for --benchmark-process-block, process wide for the
+// Audio Doctor JobProfiler. Benchmark builds only (GOODMETER_BENCHMARKS=1,
+// set by the Xcode "Benchmark" configuration): the shipping app keeps the
+// system allocator. Plain malloc/free pass-through; every allocation pays
+// two relaxed atomic adds on shared counters (count and bytes) plus a
+// thread_local flag test that bumps the per-thread count only while a
+// goodmeter::benchmark::ScopedAllocationCount has armed the calling thread.
+// The shared counters contend between threads, so allocation-heavy
+// parallel work runs somewhat slower in this build.
+// Aligned and nothrow forms use the library defaults, which end up here or
+// in aligned_alloc.
+#if GOODMETER_BENCHMARKS
+void* operator new(std::size_t size)
+{
+    goodmeter::benchmark::AllocationCounter::noteAllocation(size);
+
+    if (auto* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)                  { return ::operator new(size); }
+void operator delete(void* p) noexcept                  { std::free(p); }
+void operator delete[](void* p) noexcept                { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept     { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept   { std::free(p); }
+#endif // GOODMETER_BENCHMARKS
+
 #endif // JucePlugin_Build_Standalone
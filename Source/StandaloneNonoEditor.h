@@ -24,6 +24,7 @@
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
 #include "HoloNonoComponent.h"
+#include "FrameScheduler.h"
 #include "MeterCardComponent.h"
 #include "LevelsMeterComponent.h"
 #include "VUMeterComponent.h"
@@ -37,20 +38,24 @@
 #include "SkillTreeComponent.h"
 #include "AudioLabComponent.h"
 #include "AudioDoctorComponent.h"
+#include "TelemetryPanelComponent.h"
 #include <juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h>
 
 //==============================================================================
 class StandaloneNonoEditor : public juce::AudioProcessorEditor,
-                             public juce::Timer
+                             public FrameScheduler::Client
 {
 public:
     //==========================================================================
     StandaloneNonoEditor(GOODMETERAudioProcessor& p)
-        : AudioProcessorEditor(&p), audioProcessor(p)
+        : AudioProcessorEditor(&p), FrameScheduler::Client(this), audioProcessor(p)
     {
         setLookAndFeel(&customLookAndFeel);
         setOpaque(false);
 
+        // This editor hosts the rewind export, so history starts here at the latest
+        audioProcessor.setRewindEnabled(true);
+
         // =================================================================
         // Create 8 REAL meter cards — ALL COLLAPSED (folded header only)
         // =================================================================
@@ -240,12 +245,12 @@ public:
         // Load skill loadout from settings
         equippedSkills = SkillPersistence::loadLoadout();
 
-        startTimerHz(60);
+        startFrames();
     }
 
     ~StandaloneNonoEditor() override
     {
-        stopTimer();
+        stopFrames();
         setLookAndFeel(nullptr);
     }
 
@@ -487,32 +492,17 @@ public:
     }
 
     //==========================================================================
-    void timerCallback() override
+    void frameTick() override
     {
-        // 60Hz meter data feed
-        float peakL     = audioProcessor.peakLevelL.load(std::memory_order_relaxed);
-        float peakR     = audioProcessor.peakLevelR.load(std::memory_order_relaxed);
-        float rmsL      = audioProcessor.rmsLevelL.load(std::memory_order_relaxed);
-        float rmsR      = audioProcessor.rmsLevelR.load(std::memory_order_relaxed);
-        float momentary = audioProcessor.lufsLevel.load(std::memory_order_relaxed);
-        float shortTerm = audioProcessor.lufsShortTerm.load(std::memory_order_relaxed);
-        float integrated= audioProcessor.lufsIntegrated.load(std::memory_order_relaxed);
-        float phaseVal  = audioProcessor.phaseCorrelation.load(std::memory_order_relaxed);
-
-        if (++lraFrameCounter >= 6)
-        {
-            audioProcessor.pushShortTermLUFSForLRA(shortTerm);
-            audioProcessor.calculateLRARealtime();
-            lraFrameCounter = 0;
-        }
-
-        float luRangeVal = audioProcessor.luRange.load(std::memory_order_relaxed);
-
+        // Meter data feed: the snapshot meterFrame read for this frame
         if (phase != AnimPhase::compact)
         {
-            if (levelsMeter)  levelsMeter->updateMetrics(peakL, peakR, momentary, shortTerm, integrated, luRangeVal);
-            if (vuMeter)      vuMeter->updateVU(rmsL, rmsR);
-            if (phaseMeter)   phaseMeter->updateCorrelation(phaseVal);
+            const auto& s = audioProcessor.getMeterSnapshot();
+            if (levelsMeter)  levelsMeter->updateChannelLoudness(s.channelLufs.data(), s.numLoudnessChannels);
+            if (levelsMeter)  levelsMeter->updateMetrics(s.truePeakL, s.truePeakR, s.lufsMomentary,
+                                                         s.lufsShortTerm, s.lufsIntegrated, s.luRange);
+            if (vuMeter)      vuMeter->updateVU(s.rmsL, s.rmsR);
+            if (phaseMeter)   phaseMeter->updateCorrelation(s.phaseCorrelation);
         }
 
         // =================================================================
@@ -634,6 +624,65 @@ public:
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioDoctorWindow)
     };
 
+    //==========================================================================
+    // Engine diagnostics window (hidden: Option-click the Audio Lab menu)
+    //==========================================================================
+    class DiagnosticsWindow final : public juce::DocumentWindow
+    {
+    public:
+        DiagnosticsWindow(EngineTelemetry& telemetry,
+                          juce::LookAndFeel& lookAndFeel,
+                          std::function<void()> closeCallback)
+            : juce::DocumentWindow("ENGINE DIAGNOSTICS",
+                                   GoodMeterLookAndFeel::bgPanel,
+                                   juce::DocumentWindow::closeButton),
+              onClose(std::move(closeCallback))
+        {
+            setUsingNativeTitleBar(false);
+            setResizable(true, false);
+            setLookAndFeel(&lookAndFeel);
+
+            auto* content = new TelemetryPanelComponent(telemetry);
+            content->setSize(560, 300);
+            setContentOwned(content, true);
+
+            setResizeLimits(460, 260, 1200, 800);
+            centreWithSize(getWidth(), getHeight());
+            setVisible(true);
+            toFront(true);
+        }
+
+        ~DiagnosticsWindow() override
+        {
+            setLookAndFeel(nullptr);
+        }
+
+        void closeButtonPressed() override
+        {
+            if (onClose != nullptr)
+                juce::MessageManager::callAsync(onClose);
+        }
+
+    private:
+        std::function<void()> onClose;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiagnosticsWindow)
+    };
+
+    void openDiagnosticsWindow()
+    {
+        if (diagnosticsWindow != nullptr)
+        {
+            diagnosticsWindow->toFront(true);
+            return;
+        }
+
+        diagnosticsWindow = std::make_unique<DiagnosticsWindow>(
+            audioProcessor.telemetry,
+            customLookAndFeel,
+            [this] { diagnosticsWindow.reset(); });
+    }
+
     void openAudioDoctorDialog()
     {
         if (audioDoctorWindow != nullptr)
@@ -651,10 +700,13 @@ public:
 
 private:
     GOODMETERAudioProcessor& audioProcessor;
+
+    // One meter snapshot read per scheduler frame, before any meter ticks
+    FrameScheduler::FrameStart meterFrame { [this] { audioProcessor.updateMeterSnapshot(); } };
     GoodMeterLookAndFeel customLookAndFeel;
     std::unique_ptr<AudioDoctorWindow> audioDoctorWindow;
+    std::unique_ptr<DiagnosticsWindow> diagnosticsWindow;
     std::unique_ptr<HoloNonoComponent> holoNono;
-    int lraFrameCounter = 0;
 
     // Meter components (raw pointers — owned by MeterCardComponents)
     LevelsMeterComponent*       levelsMeter       = nullptr;
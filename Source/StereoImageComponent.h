@@ -15,6 +15,8 @@
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
 #include "PluginProcessor.h"
+#include "FrameScheduler.h"
+#include "GoniometerRasterizer.h"
 
 //==============================================================================
 /**
@@ -23,12 +25,12 @@
  * Compact mode: Lissajous hidden, LRMS tubes fill full width (saves CPU)
  */
 class StereoImageComponent : public juce::Component,
-                              public juce::Timer
+                              public FrameScheduler::Client
 {
 public:
     //==========================================================================
     StereoImageComponent(GOODMETERAudioProcessor& processor)
-        : audioProcessor(processor)
+        : FrameScheduler::Client(this), audioProcessor(processor)
     {
         // Initialize sample buffers
         sampleBufferL.fill(0.0f);
@@ -37,13 +39,13 @@ public:
         // Set fixed height
         setSize(100, 350);
 
-        // Start 60Hz timer for smooth updates
-        startTimerHz(60);
+        // 60Hz frames from the shared display clock
+        startFrames();
     }
 
     ~StereoImageComponent() override
     {
-        stopTimer();
+        stopFrames();
     }
 
     //==========================================================================
@@ -122,6 +124,7 @@ public:
         bool wasCompact = compactMode;
         compactMode = (gonMaxDiameter < static_cast<int>(tubeRenderH))
                    || (bounds.getWidth() + scaleWidth < 250);
+        stereoSampleDemand.setActive(shownOnScreen && ! compactMode);
 
         if (compactMode)
         {
@@ -129,9 +132,10 @@ public:
             layoutTubeBounds = bounds;
             layoutGonBounds = {};
 
-            // Release offscreen buffer to save memory
+            // Release offscreen buffers to save memory
             if (!goniometerImage.isNull())
                 goniometerImage = juce::Image();
+            phosphor.setSize(0, 0);
         }
         else
         {
@@ -173,6 +177,10 @@ private:
     GOODMETERAudioProcessor& audioProcessor;
     bool marathonDarkStyle = false;
 
+    // Goniometer samples are only produced while the Lissajous is laid out
+    AnalysisDemand::Subscription stereoSampleDemand { audioProcessor.analysisDemand,
+                                                      AnalysisDemand::Analysis::stereoSamples };
+
     // Sample buffers for Goniometer (stores recent L/R pairs)
     static constexpr int bufferSize = GOODMETERAudioProcessor::stereoSampleBufferSize;
     std::array<float, bufferSize> sampleBufferL;
@@ -193,12 +201,14 @@ private:
 
     // 🎯 Offscreen ghosting buffer for Goniometer
     juce::Image goniometerImage;
+    GoniometerRasterizer phosphor;      // persistent energy behind goniometerImage
     float lastGoniometerWidth = 0.0f;
     float lastGoniometerHeight = 0.0f;
     float lastGoniometerScale = 0.0f;
 
     // Responsive layout: cached rects computed in resized()
     bool compactMode = false;                   // true = Lissajous hidden, tubes fill width
+    bool shownOnScreen = true;                  // last FrameScheduler on-screen state
     juce::Rectangle<int> layoutScaleBounds;     // dB scale (left 35px)
     juce::Rectangle<int> layoutTubeBounds;      // LRMS cylinder area
     juce::Rectangle<int> layoutGonBounds;       // Goniometer area (empty in compact mode)
@@ -218,7 +228,13 @@ private:
     float lastDbScaleScale = 0.0f;
 
     //==========================================================================
-    void timerCallback() override
+    void onScreenChanged(bool isNowOnScreen) override
+    {
+        shownOnScreen = isNowOnScreen;
+        stereoSampleDemand.setActive(shownOnScreen && ! compactMode);
+    }
+
+    void frameTick() override
     {
         // 60Hz → 30Hz smart throttle during mouse drag
         if (juce::ModifierKeys::currentModifiers.isAnyMouseButtonDown())
@@ -228,10 +244,11 @@ private:
         }
 
         // Update LRMS levels (RMS dB values from processor)
-        currentL = audioProcessor.rmsLevelL.load(std::memory_order_relaxed);
-        currentR = audioProcessor.rmsLevelR.load(std::memory_order_relaxed);
-        currentM = audioProcessor.rmsLevelMid.load(std::memory_order_relaxed);
-        currentS = audioProcessor.rmsLevelSide.load(std::memory_order_relaxed);
+        const auto& snapshot = audioProcessor.getMeterSnapshot();
+        currentL = snapshot.rmsL;
+        currentR = snapshot.rmsR;
+        currentM = snapshot.rmsMid;
+        currentS = snapshot.rmsSide;
 
         const float smoothing = 0.35f;
         displayL += (currentL - displayL) * smoothing;
@@ -239,25 +256,25 @@ private:
         displayM += (currentM - displayM) * smoothing;
         displayS += (currentS - displayS) * smoothing;
 
-        // Flush stereo FIFO: drain all, keep only the latest batch
-        float tempL[512];
-        float tempR[512];
+        // Flush stereo FIFO: skip to the latest batch, copy it once from the slot
+        // (L and R are published in lockstep, so both FIFOs hold the same batch)
+        constexpr int batchSize = GOODMETERAudioProcessor::stereoBatchSize;
         sampleCount = 0;
-        while (audioProcessor.stereoSampleFifoL.pop(tempL, 512) &&
-               audioProcessor.stereoSampleFifoR.pop(tempR, 512))
+        const float* latestL = audioProcessor.stereoSampleFifoL.peekLatest();
+        const float* latestR = audioProcessor.stereoSampleFifoR.peekLatest();
+        if (latestL != nullptr && latestR != nullptr)
         {
-            for (int i = 0; i < 512; ++i)
-            {
-                sampleBufferL[i] = tempL[i];
-                sampleBufferR[i] = tempR[i];
-            }
-            sampleCount = 512;
+            std::copy(latestL, latestL + batchSize, sampleBufferL.begin());
+            std::copy(latestR, latestR + batchSize, sampleBufferR.begin());
+            sampleCount = batchSize;
         }
+        if (latestL != nullptr) audioProcessor.stereoSampleFifoL.commitRead();
+        if (latestR != nullptr) audioProcessor.stereoSampleFifoR.commitRead();
 
         // Render Goniometer trails to offscreen SoftwareImage (zero MML)
         renderGoniometerOffscreen();
 
-        repaint();
+        repaintFrame();
     }
 
     juce::Colour panelBackFill() const
@@ -449,8 +466,9 @@ private:
 
     //==========================================================================
     /**
-     * Render Goniometer trails to offscreen SoftwareImage (called from timerCallback)
-     * Zero CoreGraphics — pure BitmapData pixel writing + Bresenham lines
+     * Render Goniometer trails to offscreen SoftwareImage (called from frameTick)
+     * Zero CoreGraphics — every sample splatted into the phosphor buffer,
+     * which decays each frame and is tone-mapped straight into the image
      */
     void renderGoniometerOffscreen()
     {
@@ -474,8 +492,8 @@ private:
             std::abs(lastGoniometerScale - imageScale) > 0.01f)
         {
             goniometerImage = juce::Image(juce::Image::ARGB, pixelW, pixelH, true, juce::SoftwareImageType());
-            juce::Graphics initG(goniometerImage);
-            initG.fillAll(juce::Colours::black);
+            phosphor.setSize(pixelW, pixelH);
+            phosphor.clear();
             lastGoniometerWidth = static_cast<float>(pixelW);
             lastGoniometerHeight = static_cast<float>(pixelH);
             lastGoniometerScale = imageScale;
@@ -490,100 +508,21 @@ private:
         const float labelMargin = juce::jmin(20.0f * imageScale, localH * 0.1f);
         const float r = juce::jmax(5.0f * imageScale, juce::jmin(localW, localH) / 2.0f - labelMargin);
 
-        // Phase 1: Ghost trail fade (single Graphics call, then release)
-        {
-            juce::Graphics imageG(goniometerImage);
-            imageG.fillAll((marathonDarkStyle ? juce::Colour(0xFF0A0D13) : juce::Colours::black)
-                               .withAlpha(GoodMeterLookAndFeel::isMobileCharts() ? 0.18f : 0.06f));
-        }
+        // Phase 1: Phosphor decay (the old 6% / 18% fade towards the background)
+        const bool mobile = GoodMeterLookAndFeel::isMobileCharts();
+        phosphor.decay(mobile ? 0.82f : 0.94f);
 
-        // Phase 2: BitmapData pixel-level rendering (zero CoreGraphics)
+        // Phase 2: Every sample of the latest batch, bilinear-splatted
         if (sampleCount > 2)
         {
-            const float scale = r * 0.8f;
-            const juce::Colour pink = GoodMeterLookAndFeel::accentPink;
-            const uint8_t pr = pink.getRed(), pg = pink.getGreen(), pb = pink.getBlue();
-
-            // Precompute decimated points (step-4 for 30Hz: same visual density as step-2@60Hz)
-            static constexpr int maxPts = bufferSize / 4 + 1;
-            int ptX[maxPts], ptY[maxPts];
-            int numPts = 0;
-            for (int i = 0; i < sampleCount && numPts < maxPts; i += 4)
-            {
-                float fx, fy;
-                computeGonPoint(i, imgCx, imgCy, r, scale, fx, fy);
-                ptX[numPts] = juce::roundToInt(fx);
-                ptY[numPts] = juce::roundToInt(fy);
-                numPts++;
-            }
-
-            juce::Image::BitmapData bmp(goniometerImage, juce::Image::BitmapData::readWrite);
-
-            // Bresenham core lines + soft glow at sample points
-            for (int j = 0; j < numPts - 1; ++j)
-            {
-                bresenhamLine(bmp, ptX[j], ptY[j], ptX[j + 1], ptY[j + 1],
-                              pixelW, pixelH, pr, pg, pb, 0.55f);
-            }
-
-            // Glow pass: 4-neighbor soft halo at each sample point
-            for (int j = 0; j < numPts; ++j)
-            {
-                const float haloAlpha = GoodMeterLookAndFeel::isMobileCharts() ? 0.08f : 0.18f;
-                blendPixel(bmp, ptX[j] - 1, ptY[j],         pixelW, pixelH, pr, pg, pb, haloAlpha);
-                blendPixel(bmp, ptX[j] + 1, ptY[j],         pixelW, pixelH, pr, pg, pb, haloAlpha);
-                blendPixel(bmp, ptX[j],     ptY[j] - 1,     pixelW, pixelH, pr, pg, pb, haloAlpha);
-                blendPixel(bmp, ptX[j],     ptY[j] + 1,     pixelW, pixelH, pr, pg, pb, haloAlpha);
-            }
+            phosphor.setGeometry(imgCx, imgCy, r, r * 0.8f);
+            phosphor.plot(sampleBufferL.data(), sampleBufferR.data(), sampleCount, mobile ? 0.7f : 1.0f);
         }
-    }
-
-    /** Alpha-blend a single pixel into BitmapData (no CoreGraphics) */
-    static inline void blendPixel(juce::Image::BitmapData& bmp, int x, int y, int w, int h,
-                                  uint8_t r, uint8_t g, uint8_t b, float alpha)
-    {
-        if (x < 0 || x >= w || y < 0 || y >= h) return;
-        auto existing = bmp.getPixelColour(x, y);
-        bmp.setPixelColour(x, y, existing.interpolatedWith(juce::Colour(r, g, b), alpha));
-    }
-
-    /** Bresenham line rasterizer — pure integer math, zero CoreGraphics */
-    static inline void bresenhamLine(juce::Image::BitmapData& bmp,
-                                     int x0, int y0, int x1, int y1,
-                                     int w, int h,
-                                     uint8_t r, uint8_t g, uint8_t b, float alpha)
-    {
-        int dx = std::abs(x1 - x0), dy = std::abs(y1 - y0);
-        int sx = (x0 < x1) ? 1 : -1;
-        int sy = (y0 < y1) ? 1 : -1;
-        int err = dx - dy;
 
-        for (int step = 0; step < 2000; ++step)  // safety cap
-        {
-            blendPixel(bmp, x0, y0, w, h, r, g, b, alpha);
-            if (x0 == x1 && y0 == y1) break;
-            int e2 = err * 2;
-            if (e2 > -dy) { err -= dy; x0 += sx; }
-            if (e2 <  dx) { err += dx; y0 += sy; }
-        }
-    }
-
-    inline void computeGonPoint(int i, float cx, float cy, float r, float scale,
-                                float& outX, float& outY) const
-    {
-        const float mid  = sampleBufferL[i] + sampleBufferR[i];
-        const float side = sampleBufferL[i] - sampleBufferR[i];
-        float x = cx + side * scale;
-        float y = cy - mid * scale;
-        const float dist = std::abs(x - cx) + std::abs(y - cy);
-        if (dist > r)
-        {
-            const float sf = r / dist;
-            x = cx + (x - cx) * sf;
-            y = cy + (y - cy) * sf;
-        }
-        outX = x;
-        outY = y;
+        // Phase 3: Tone-map energy → background..pink into the image
+        phosphor.render(goniometerImage,
+                        marathonDarkStyle ? juce::Colour(0xFF0A0D13) : juce::Colours::black,
+                        GoodMeterLookAndFeel::accentPink);
     }
 
     //==========================================================================
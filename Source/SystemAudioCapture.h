@@ -36,13 +36,22 @@ public:
     bool isActive() const;
 
     // Pull captured samples into destination buffers (called from processBlock).
-    // destR may be nullptr for mono output.
-    // Returns actual number of samples read (may be < maxSamples).
+    // destR may be nullptr for mono output. Samples are at expectedSampleRate,
+    // converted from the tap's rate and drift-compensated against its clock.
+    // Always writes maxSamples; returns how many were captured audio (the
+    // rest, after an underrun or while priming, are silence).
     int readSamples(float* destL, float* destR, int maxSamples);
 
-    // Get the stream's native sample rate (may differ from JUCE's).
+    // Get the tap's native sample rate (may differ from JUCE's).
     double getStreamSampleRate() const;
 
+    // Bridge health: pulls that ran dry, pushes that didn't fit, audio
+    // buffered between the two clocks, and the current rate trim (1 = nominal).
+    juce::uint64 getUnderrunCount() const;
+    juce::uint64 getOverrunCount() const;
+    double getBridgeLatencySeconds() const;
+    double getDriftTrim() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> pImpl;
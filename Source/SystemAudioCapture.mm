@@ -8,8 +8,10 @@
       - AudioHardwareCreateProcessTap → tapObjectID
       - Aggregate Device wraps the tap as an input source
       - IOProc callback on hardware audio thread reads Float32 PCM
-      - Samples pushed to AbstractFifo ring buffer (lock-free SPSC)
-      - processBlock reads from AbstractFifo
+      - Samples pushed into a DriftCompensatingBridge (lock-free SPSC ring)
+      - processBlock pulls through the bridge's variable-ratio resampler,
+        which converts tap rate → device rate and trims the ratio to hold
+        the ring at a small, constant fill however the two clocks drift
 
     Permission: NSAudioCaptureUsageDescription → "仅系统录音 (System Audio Recording Only)"
     Requires macOS 14.2+ (Sonoma) for AudioHardwareCreateProcessTap.
@@ -17,6 +19,7 @@
 */
 
 #include "SystemAudioCapture.h"
+#include "DriftCompensatingBridge.h"
 
 #if JUCE_MAC && JucePlugin_Build_Standalone
 
@@ -32,11 +35,8 @@
 //==============================================================================
 struct SystemAudioCapture::Impl
 {
-    static constexpr int fifoSize = 131072;  // ~2.7s at 48kHz
-
-    // Ring buffer (lock-free SPSC bridge: IOProc → processBlock)
-    std::unique_ptr<juce::AbstractFifo> fifo;
-    std::vector<float> ringBuffer;  // stereo interleaved: [L0, R0, L1, R1, ...]
+    // IOProc → processBlock, tap clock → device clock (prepared before active)
+    DriftCompensatingBridge bridge;
 
     // CoreAudio objects
     AudioObjectID tapObjectID          = kAudioObjectUnknown;
@@ -53,8 +53,7 @@ struct SystemAudioCapture::Impl
 
     Impl()
     {
-        fifo = std::make_unique<juce::AbstractFifo>(fifoSize);
-        ringBuffer.resize(static_cast<size_t>(fifoSize) * 2, 0.0f);
+        bridge.prepare(48000.0, 48000.0);
     }
 
     ~Impl()
@@ -97,46 +96,8 @@ struct SystemAudioCapture::Impl
         if (totalFrames <= 0)
             return noErr;
 
-        // Write to ring buffer (always store as stereo interleaved)
-        const auto scope = impl->fifo->write(totalFrames);
-
-        // Write block 1
-        for (int i = 0; i < scope.blockSize1; ++i)
-        {
-            int srcIdx = i;
-            int dstIdx = (scope.startIndex1 + i) * 2;
-
-            if (numChannels >= 2)
-            {
-                impl->ringBuffer[static_cast<size_t>(dstIdx)]     = floatData[srcIdx * numChannels];
-                impl->ringBuffer[static_cast<size_t>(dstIdx + 1)] = floatData[srcIdx * numChannels + 1];
-            }
-            else
-            {
-                float sample = floatData[srcIdx];
-                impl->ringBuffer[static_cast<size_t>(dstIdx)]     = sample;
-                impl->ringBuffer[static_cast<size_t>(dstIdx + 1)] = sample;
-            }
-        }
-
-        // Write block 2 (wrap-around portion)
-        for (int i = 0; i < scope.blockSize2; ++i)
-        {
-            int srcIdx = scope.blockSize1 + i;
-            int dstIdx = (scope.startIndex2 + i) * 2;
-
-            if (numChannels >= 2)
-            {
-                impl->ringBuffer[static_cast<size_t>(dstIdx)]     = floatData[srcIdx * numChannels];
-                impl->ringBuffer[static_cast<size_t>(dstIdx + 1)] = floatData[srcIdx * numChannels + 1];
-            }
-            else
-            {
-                float sample = floatData[srcIdx];
-                impl->ringBuffer[static_cast<size_t>(dstIdx)]     = sample;
-                impl->ringBuffer[static_cast<size_t>(dstIdx + 1)] = sample;
-            }
-        }
+        // Into the drift-compensating bridge (stereo; mono is duplicated)
+        impl->bridge.push(floatData, totalFrames, numChannels, DriftCompensatingBridge::nowSeconds());
 
         // Zero output buffers (we are input-only, but must clear output to avoid noise)
         if (outOutputData != nullptr)
@@ -250,6 +211,12 @@ struct SystemAudioCapture::Impl
                 }
             }
 
+            // Step 4b: Bridge tap rate → device rate (drift-compensated even when equal)
+            const double tapRate = sampleRate.load(std::memory_order_relaxed);
+            bridge.prepare(tapRate, expectedSampleRate > 0.0 ? expectedSampleRate : tapRate);
+            juce::Logger::outputDebugString("CoreAudioTap: bridging " + juce::String(tapRate)
+                + " -> " + juce::String(expectedSampleRate));
+
             // Step 5: Create Aggregate Device with the tap as input
             NSString* tapUUIDStr = tapUUID.UUIDString;
             NSDictionary* aggDesc = @{
@@ -312,7 +279,8 @@ struct SystemAudioCapture::Impl
                 return;
             }
 
-            active.store(true, std::memory_order_relaxed);
+            // Release: the bridge is prepared before processBlock can see active
+            active.store(true, std::memory_order_release);
             juce::Logger::outputDebugString("CoreAudioTap: capture started successfully!");
         }
     }
@@ -363,30 +331,11 @@ struct SystemAudioCapture::Impl
     }
 
     //==========================================================================
-    // Read samples from ring buffer (called from processBlock)
+    // Read samples through the bridge (called from processBlock)
     //==========================================================================
     int readSamples(float* destL, float* destR, int maxSamples)
     {
-        const auto scope = fifo->read(juce::jmin(maxSamples, fifo->getNumReady()));
-
-        // Read block 1
-        for (int i = 0; i < scope.blockSize1; ++i)
-        {
-            int srcIdx = (scope.startIndex1 + i) * 2;
-            destL[i] = ringBuffer[static_cast<size_t>(srcIdx)];
-            if (destR) destR[i] = ringBuffer[static_cast<size_t>(srcIdx + 1)];
-        }
-
-        // Read block 2 (wrap-around)
-        for (int i = 0; i < scope.blockSize2; ++i)
-        {
-            int srcIdx = (scope.startIndex2 + i) * 2;
-            int dstIdx = scope.blockSize1 + i;
-            destL[dstIdx] = ringBuffer[static_cast<size_t>(srcIdx)];
-            if (destR) destR[dstIdx] = ringBuffer[static_cast<size_t>(srcIdx + 1)];
-        }
-
-        return scope.blockSize1 + scope.blockSize2;
+        return bridge.pull(destL, destR, maxSamples, DriftCompensatingBridge::nowSeconds());
     }
 };
 
@@ -413,7 +362,7 @@ void SystemAudioCapture::stop()
 
 bool SystemAudioCapture::isActive() const
 {
-    return pImpl->active.load(std::memory_order_relaxed);
+    return pImpl->active.load(std::memory_order_acquire);
 }
 
 int SystemAudioCapture::readSamples(float* destL, float* destR, int maxSamples)
@@ -426,4 +375,24 @@ double SystemAudioCapture::getStreamSampleRate() const
     return pImpl->sampleRate.load(std::memory_order_relaxed);
 }
 
+juce::uint64 SystemAudioCapture::getUnderrunCount() const
+{
+    return pImpl->bridge.getUnderrunCount();
+}
+
+juce::uint64 SystemAudioCapture::getOverrunCount() const
+{
+    return pImpl->bridge.getOverrunCount();
+}
+
+double SystemAudioCapture::getBridgeLatencySeconds() const
+{
+    return pImpl->bridge.getLatencySeconds();
+}
+
+double SystemAudioCapture::getDriftTrim() const
+{
+    return pImpl->bridge.getRatioTrim();
+}
+
 #endif // JUCE_MAC && JucePlugin_Build_Standalone
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+    TelemetryPanelComponent.h
+    GOODMETER - Hidden engine diagnostics panel
+
+    Shows EngineTelemetry at 4 Hz: processBlock duration histogram, over-
+    budget callbacks and pipeline drop counters. Callback timing is only
+    switched on while the panel exists (it holds an EngineTelemetry::Watch).
+
+    Opened from the plugin editor with Cmd/Ctrl+Shift+D, and from the
+    standalone app by holding Option/Alt while opening the Audio Lab menu.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "GoodMeterLookAndFeel.h"
+#include "EngineTelemetry.h"
+
+//==============================================================================
+class TelemetryPanelComponent : public juce::Component,
+                                private juce::Timer
+{
+public:
+    explicit TelemetryPanelComponent(EngineTelemetry& telemetryToShow)
+        : telemetry(telemetryToShow),
+          watch(telemetryToShow)
+    {
+        for (auto* button : { &resetButton, &copyButton, &saveButton })
+            addAndMakeVisible(button);
+
+        resetButton.onClick = [this] { telemetry.resetTimings(); refresh(); };
+        copyButton.onClick = [this] { juce::SystemClipboard::copyTextToClipboard(exportJSON()); };
+        saveButton.onClick = [this] { saveJSON(); };
+
+        refresh();
+        startTimerHz(4);
+    }
+
+    //==========================================================================
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(GoodMeterLookAndFeel::bgPanel);
+        g.setColour(GoodMeterLookAndFeel::border);
+        g.drawRect(getLocalBounds(), 3);
+
+        auto area = getLocalBounds().reduced(12);
+        area.removeFromBottom(buttonRowHeight);
+
+        g.setColour(GoodMeterLookAndFeel::textMain);
+        g.setFont(juce::Font(13.0f));
+
+        const auto line = [&g, &area](const juce::String& text)
+        {
+            g.drawText(text, area.removeFromTop(18), juce::Justification::centredLeft, true);
+        };
+
+        line("ENGINE DIAGNOSTICS");
+        line("Callbacks " + juce::String(static_cast<juce::int64>(snapshot.callbacks))
+             + "   timed " + juce::String(static_cast<juce::int64>(snapshot.timedCallbacks))
+             + "   over budget " + juce::String(static_cast<juce::int64>(snapshot.overBudgetCallbacks))
+             + "   max " + juce::String(static_cast<int>(snapshot.maxCallbackMicros)) + " us");
+        line("Goniometer FIFO full " + juce::String(static_cast<juce::int64>(snapshot.stereoFifoFull))
+             + "   spectrum samples dropped " + juce::String(static_cast<juce::int64>(snapshot.spectrumSamplesDropped)));
+        line("Recorder frames dropped " + juce::String(static_cast<juce::int64>(snapshot.recorderFramesDropped))
+             + "   FIFO peak " + juce::String(snapshot.recorderFifoPeakFill * 100.0f, 1) + " %");
+        line("Spectrogram columns " + juce::String(static_cast<juce::int64>(snapshot.spectrogramColumnsDrawn))
+             + "   skipped " + juce::String(static_cast<juce::int64>(snapshot.spectrogramColumnsSkipped)));
+
+        area.removeFromTop(8);
+        paintHistogram(g, area);
+    }
+
+    void resized() override
+    {
+        auto row = getLocalBounds().reduced(12).removeFromBottom(buttonRowHeight - 6);
+        resetButton.setBounds(row.removeFromLeft(80));
+        row.removeFromLeft(8);
+        copyButton.setBounds(row.removeFromLeft(100));
+        row.removeFromLeft(8);
+        saveButton.setBounds(row.removeFromLeft(100));
+    }
+
+private:
+    //==========================================================================
+    void timerCallback() override   { refresh(); }
+
+    void refresh()
+    {
+        snapshot = telemetry.getSnapshot();
+        repaint();
+    }
+
+    /** One bar per duration bucket, log-scaled counts so rare slow callbacks stay visible. */
+    void paintHistogram(juce::Graphics& g, juce::Rectangle<int> area) const
+    {
+        if (area.getHeight() < 40)
+            return;
+
+        const auto labels = area.removeFromBottom(16);
+        const int n = EngineTelemetry::kNumDurationBuckets;
+        const float barWidth = static_cast<float>(area.getWidth()) / static_cast<float>(n);
+
+        juce::uint64 largest = 1;
+        for (auto count : snapshot.durationBuckets)
+            largest = juce::jmax(largest, count);
+
+        const float logLargest = std::log10(static_cast<float>(largest) + 1.0f);
+
+        for (int b = 0; b < n; ++b)
+        {
+            const auto count = snapshot.durationBuckets[(size_t) b];
+            const float fraction = count > 0 ? std::log10(static_cast<float>(count) + 1.0f) / logLargest : 0.0f;
+            const float x = static_cast<float>(area.getX()) + barWidth * static_cast<float>(b);
+            const float h = fraction * static_cast<float>(area.getHeight());
+
+            g.setColour(b >= slowBucket ? GoodMeterLookAndFeel::accentPink : GoodMeterLookAndFeel::ink);
+            g.fillRect(x + 1.0f, static_cast<float>(area.getBottom()) - h, barWidth - 2.0f, h);
+
+            // Label every 4th edge: 8 us, 128 us, 2 ms, 32 ms, ...
+            if (b % 4 == 3)
+            {
+                const auto us = EngineTelemetry::Snapshot::bucketUpperMicros(b);
+                const auto text = us >= 1000 ? juce::String(us / 1000) + "ms" : juce::String(static_cast<int>(us)) + "us";
+                g.setColour(GoodMeterLookAndFeel::textMuted);
+                g.drawText(text, juce::Rectangle<float>(x, static_cast<float>(labels.getY()), barWidth * 2.0f, 16.0f),
+                           juce::Justification::centredLeft, false);
+            }
+        }
+    }
+
+    juce::String exportJSON() const
+    {
+        return juce::JSON::toString(EngineTelemetry::toVar(telemetry.getSnapshot()), false);
+    }
+
+    void saveJSON()
+    {
+        const auto name = "GOODMETER_telemetry_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".json";
+        chooser = std::make_unique<juce::FileChooser>(
+            "Save Engine Diagnostics",
+            juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile(name),
+            "*.json",
+            true);
+
+        const auto json = exportJSON();   // captured now, not when the dialog closes
+        chooser->launchAsync(juce::FileBrowserComponent::saveMode
+                           | juce::FileBrowserComponent::warnAboutOverwriting,
+            [json](const juce::FileChooser& fc)
+            {
+                auto result = fc.getResult();
+                if (result != juce::File())
+                    result.replaceWithText(json);
+            });
+    }
+
+    //==========================================================================
+    static constexpr int buttonRowHeight = 34;
+    static constexpr int slowBucket = 12;   // ≥ 2048 us: longer than many small blocks
+
+    EngineTelemetry& telemetry;
+    EngineTelemetry::Watch watch;
+    EngineTelemetry::Snapshot snapshot;
+
+    juce::TextButton resetButton { "Reset" };
+    juce::TextButton copyButton { "Copy JSON" };
+    juce::TextButton saveButton { "Save JSON..." };
+    std::unique_ptr<juce::FileChooser> chooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TelemetryPanelComponent)
+};
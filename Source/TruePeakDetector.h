@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+    TruePeakDetector.h
+    GOODMETER - BS.1770-4 true-peak (dBTP) detector
+
+    4x oversampling with the 48-tap polyphase interpolation FIR from
+    ITU-R BS.1770-4 Annex 2 (4 phases × 12 taps). The four phases are laid
+    out across the lanes of one SIMD register, so each input sample costs
+    12 vector multiply-adds for all four interpolated outputs, with running
+    lane-wise max/min instead of per-output abs + compare.
+
+    One kernel serves both paths:
+      - Real-time: one stateful TruePeakFilter per channel in processBlock
+      - Offline:   measureTruePeak() for whole buffers, or a TruePeakFilter
+                   carried across chunks (Nono analyser, Audio Doctor)
+
+    No allocation; state is the last 11 input samples per channel.
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+class TruePeakFilter
+{
+public:
+    static constexpr int kOversampling = 4;
+    static constexpr int kTapsPerPhase = 12;
+    static constexpr int kHistory = kTapsPerPhase - 1;
+
+    TruePeakFilter()
+    {
+#if JUCE_USE_SIMD
+        // One register per tap, lanes = phases
+        for (int k = 0; k < kTapsPerPhase; ++k)
+            for (size_t lane = 0; lane < juce::dsp::SIMDRegister<float>::SIMDNumElements; ++lane)
+                tapRegisters[static_cast<size_t>(k)].set(lane, kCoefficients[lane % kOversampling][k]);
+#endif
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        history.fill(0.0f);
+    }
+
+    //==========================================================================
+    /** Feed a block and return its largest |interpolated sample| (linear). */
+    float process(const float* input, int numSamples) noexcept
+    {
+        float peak = 0.0f;
+        int offset = 0;
+
+        while (offset < numSamples)
+        {
+            const int run = juce::jmin(numSamples - offset, kChunkSize);
+
+            // Contiguous [history | new samples] so every tap reads a plain pointer
+            std::copy(history.begin(), history.end(), work.begin());
+            std::copy(input + offset, input + offset + run, work.begin() + kHistory);
+
+            peak = juce::jmax(peak, processContiguous(work.data() + kHistory, run));
+
+            std::copy(work.begin() + run, work.begin() + run + kHistory, history.begin());
+            offset += run;
+        }
+
+        return peak;
+    }
+
+    //==========================================================================
+    /** ITU-R BS.1770-4 Annex 2 coefficients, [phase][tap] */
+    static constexpr float kCoefficients[kOversampling][kTapsPerPhase] =
+    {
+        {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+          -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+           0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+        { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+          -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+           0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+        { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f,
+          -0.2003173828125f,  0.7797851562500f,  0.4650878906250f, -0.1665039062500f,
+           0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+        { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f,
+          -0.1022949218750f,  0.9721679687500f,  0.1373291015625f, -0.0594482421875f,
+           0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+    };
+
+private:
+    static constexpr int kChunkSize = 256;
+
+    // x points at the first new sample; x[-kHistory..-1] is valid history
+    float processContiguous(const float* x, int numSamples) const noexcept
+    {
+#if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+
+        if constexpr (Vec::SIMDNumElements == static_cast<size_t>(kOversampling))
+        {
+            const auto& taps = tapRegisters;
+            Vec hi = Vec::expand(0.0f);
+            Vec lo = Vec::expand(0.0f);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                Vec acc = taps[0] * Vec::expand(x[i]);
+                for (int k = 1; k < kTapsPerPhase; ++k)
+                    acc = Vec::multiplyAdd(acc, taps[static_cast<size_t>(k)], Vec::expand(x[i - k]));
+
+                hi = Vec::max(hi, acc);
+                lo = Vec::min(lo, acc);
+            }
+
+            alignas(16) float hiLanes[kOversampling];
+            alignas(16) float loLanes[kOversampling];
+            hi.copyToRawArray(hiLanes);
+            lo.copyToRawArray(loLanes);
+
+            float peak = 0.0f;
+            for (int p = 0; p < kOversampling; ++p)
+                peak = juce::jmax(peak, hiLanes[p], -loLanes[p]);
+            return peak;
+        }
+        else
+#endif
+        {
+            float peak = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int p = 0; p < kOversampling; ++p)
+                {
+                    float acc = 0.0f;
+                    for (int k = 0; k < kTapsPerPhase; ++k)
+                        acc += kCoefficients[p][k] * x[i - k];
+                    peak = juce::jmax(peak, std::abs(acc));
+                }
+            }
+            return peak;
+        }
+    }
+
+#if JUCE_USE_SIMD
+    std::array<juce::dsp::SIMDRegister<float>, kTapsPerPhase> tapRegisters {};
+#endif
+    std::array<float, kHistory> history {};
+    std::array<float, kHistory + kChunkSize> work {};
+};
+
+//==============================================================================
+/** Offline helper: true peak (linear) of a whole channel, starting from silence. */
+inline float measureTruePeak(const float* data, int numSamples) noexcept
+{
+    TruePeakFilter filter;
+    float peak = filter.process(data, numSamples);
+
+    // Flush the interpolator so the final samples' inter-sample overs are seen
+    const std::array<float, TruePeakFilter::kHistory> tail {};
+    return juce::jmax(peak, filter.process(tail.data(), static_cast<int>(tail.size())));
+}
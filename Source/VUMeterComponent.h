@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "GoodMeterLookAndFeel.h"
+#include "FrameScheduler.h"
 
 //==============================================================================
 /**
@@ -19,8 +20,7 @@
  * Range: -30 VU to +3 VU
  * Dual zones: normal (-30 to 0) and danger (0 to +3)
  */
-class VUMeterComponent : public juce::Component,
-                         public juce::Timer
+class VUMeterComponent : public juce::Component
 {
 public:
     //==========================================================================
@@ -28,14 +28,6 @@ public:
     {
         // ✅ 只设置高度，宽度由父容器（MeterCard）控制
         setSize(100, 220);  // 初始宽度会被父容器覆盖
-
-        // Start 60Hz timer for smooth needle animation
-        startTimerHz(60);
-    }
-
-    ~VUMeterComponent() override
-    {
-        stopTimer();
     }
 
     void setMarathonDarkStyle(bool shouldUse)
@@ -176,7 +168,7 @@ public:
 
     //==========================================================================
     /**
-     * Update VU value from processor (called from PluginEditor::timerCallback)
+     * Update VU value from processor (called once per frame by the owner)
      *
      * CRITICAL: Processor 传入的已经是 dB 值（rmsL_dB, rmsR_dB）
      * 不要再做 log10 转换！
@@ -197,7 +189,7 @@ public:
         // 3. Apply ballistics (smoothing) (ClassicVUMeter.tsx line 46)
         currentVuDisplay += (targetLevel - currentVuDisplay) * vuSmoothing;
 
-        repaint();
+        FrameScheduler::getInstance().repaint(*this);
     }
 
 private:
@@ -226,12 +218,6 @@ private:
     float lastVuCacheScale = 0.0f;
     bool marathonDarkStyle = false;
 
-    //==========================================================================
-    void timerCallback() override
-    {
-        // Smooth animation handled in updateVU()
-    }
-
     //==========================================================================
     /**
      * Draw circular arc using juce::Path
@@ -5,6 +5,16 @@
 
     Usage:
       VideoAudioExtractor::extractAudio(videoFile, outputFile, [](bool ok) { ... });
+
+      // Meter while decoding: the same pass feeds the callbacks and the WAV
+      VideoAudioExtractor::AudioStreamCallbacks stream;
+      stream.onFormat = [&](double sr, int ch) { ...; return true; };
+      stream.onBlock  = [&](const juce::AudioBuffer<float>& b, int n) { ...; return true; };
+      VideoAudioExtractor::streamAudio(videoFile, outputFile, stream, [](bool ok) { ... });
+
+      // Every marker thumbnail in one pass over the video track
+      VideoAudioExtractor::extractFrameImages(videoFile, requests,
+          [](int index, bool ok) { ... }, [] { ... });
   ==============================================================================
 */
 
@@ -12,6 +22,7 @@
 
 #include <JuceHeader.h>
 #include <functional>
+#include <vector>
 
 class VideoAudioExtractor
 {
@@ -61,12 +72,50 @@ public:
                              const juce::File& outputFile,
                              std::function<void(bool success)> onComplete);
 
+    /** Decoded PCM handed out while extraction runs. Both run on the decode
+     *  thread; returning false cancels the extraction (onComplete gets false). */
+    struct AudioStreamCallbacks
+    {
+        /** Once, before the first block. */
+        std::function<bool(double sampleRate, int numChannels)> onFormat;
+
+        /** Every decoded block in order, numSamples ≤ 8192 per channel. */
+        std::function<bool(const juce::AudioBuffer<float>& block, int numSamples)> onBlock;
+    };
+
+    /** extractAudio() that also passes each decoded block to the callbacks,
+     *  so metering and analysis finish with the decode instead of reopening
+     *  the WAV afterwards. outputFile may be juce::File() to decode without
+     *  writing anything. A failed or cancelled extraction deletes outputFile.
+     *  onComplete is called on the JUCE message thread.
+     */
+    static void streamAudio(const juce::File& videoFile,
+                            const juce::File& outputFile,
+                            AudioStreamCallbacks callbacks,
+                            std::function<void(bool success)> onComplete);
+
     /** Asynchronously extract a frame image at the given time from a video file. */
     static void extractFrameImage(const juce::File& videoFile,
                                   double seconds,
                                   const juce::File& outputFile,
                                   std::function<void(bool success)> onComplete);
 
+    struct FrameRequest
+    {
+        double seconds = 0.0;
+        juce::File outputFile;      // PNG
+    };
+
+    /** Asynchronously extract many frame images with one image generator:
+     *  the times go to AVFoundation together and are decoded in time order,
+     *  instead of one asset open and seek per frame. onFrame(index into
+     *  requests, success) as each image lands, then onComplete; both on the
+     *  JUCE message thread. */
+    static void extractFrameImages(const juce::File& videoFile,
+                                   std::vector<FrameRequest> requests,
+                                   std::function<void(int index, bool success)> onFrame,
+                                   std::function<void()> onComplete);
+
     /** Inspect the video track and report timing-related information for marker display. */
     static VideoTimingInfo getVideoTimingInfo(const juce::File& videoFile);
 
@@ -5,7 +5,12 @@
 
     Uses AVAssetReader to decode the video's audio track into raw PCM (Float32),
     then streams it through JUCE's WavAudioFormat writer to produce a 24-bit
-    uncompressed WAV file. Never loads the entire file into memory.
+    uncompressed WAV file. Never loads the entire file into memory. The same
+    decoded blocks can be handed to callers as they come (streamAudio), so
+    metering runs alongside the decode rather than after it.
+
+    Marker thumbnails: one AVAssetImageGenerator per batch, all times
+    requested together (extractFrameImages), or one-off (extractFrameImage).
   ==============================================================================
 */
 
@@ -17,6 +22,7 @@
 #import <AVFoundation/AVFoundation.h>
 #import <CoreMedia/CoreMedia.h>
 #import <CoreVideo/CoreVideo.h>
+#include <map>
 #if JUCE_IOS
  #import <UIKit/UIKit.h>
 #elif JUCE_MAC
@@ -24,10 +30,12 @@
 #endif
 
 //==============================================================================
-// Internal: synchronous lossless WAV extraction (runs on background thread)
+// Internal: synchronous decode to PCM blocks, optionally teed into a lossless
+// WAV (runs on background thread)
 //==============================================================================
-static bool performWavExtraction(const juce::String& inputPathStr,
-                                 const juce::String& outputPathStr)
+static bool performAudioDecode(const juce::String& inputPathStr,
+                               const juce::String& outputPathStr,
+                               const VideoAudioExtractor::AudioStreamCallbacks& callbacks)
 {
     @autoreleasepool
     {
@@ -103,37 +111,47 @@ static bool performWavExtraction(const juce::String& inputPathStr,
         }
 
         // ── 4. Create JUCE WAV writer (24-bit, professional quality) ──
-        juce::File outputFile(outputPathStr);
-        auto outputStream = outputFile.createOutputStream();
-        if (!outputStream)
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        if (outputPathStr.isNotEmpty())
         {
-            DBG("VideoAudioExtractor: failed to create output stream");
-            [reader cancelReading];
-            return false;
+            juce::File outputFile(outputPathStr);
+            auto outputStream = outputFile.createOutputStream();
+            if (!outputStream)
+            {
+                DBG("VideoAudioExtractor: failed to create output stream");
+                [reader cancelReading];
+                return false;
+            }
+
+            juce::WavAudioFormat wavFormat;
+            // createWriterFor takes ownership of the OutputStream
+            writer.reset(wavFormat.createWriterFor(outputStream.release(),
+                                                   sampleRate,
+                                                   static_cast<unsigned int>(numChannels),
+                                                   24,     // 24-bit lossless
+                                                   {},     // no metadata
+                                                   0));    // quality option
+
+            if (!writer)
+            {
+                DBG("VideoAudioExtractor: failed to create WAV writer");
+                [reader cancelReading];
+                return false;
+            }
         }
 
-        juce::WavAudioFormat wavFormat;
-        // createWriterFor takes ownership of the OutputStream
-        std::unique_ptr<juce::AudioFormatWriter> writer(
-            wavFormat.createWriterFor(outputStream.release(),
-                                      sampleRate,
-                                      static_cast<unsigned int>(numChannels),
-                                      24,     // 24-bit lossless
-                                      {},     // no metadata
-                                      0));    // quality option
-
-        if (!writer)
+        if (callbacks.onFormat && !callbacks.onFormat(sampleRate, numChannels))
         {
-            DBG("VideoAudioExtractor: failed to create WAV writer");
             [reader cancelReading];
             return false;
         }
 
-        // ── 5. Stream: read CMSampleBuffers → deinterleave → write WAV ──
+        // ── 5. Stream: read CMSampleBuffers → deinterleave → callbacks + WAV ──
         const int juceBlockSize = 8192;
         juce::AudioBuffer<float> juceBuffer(numChannels, juceBlockSize);
+        bool cancelled = false;
 
-        while (reader.status == AVAssetReaderStatusReading)
+        while (!cancelled && reader.status == AVAssetReaderStatusReading)
         {
             @autoreleasepool
             {
@@ -172,7 +190,7 @@ static bool performWavExtraction(const juce::String& inputPathStr,
                 int totalSamples = static_cast<int>(totalLength / sizeof(float));
                 int numFrames = totalSamples / numChannels;
 
-                // Deinterleave into JUCE AudioBuffer and write in chunks
+                // Deinterleave into JUCE AudioBuffer and hand out in chunks
                 int framesProcessed = 0;
                 while (framesProcessed < numFrames)
                 {
@@ -180,14 +198,23 @@ static bool performWavExtraction(const juce::String& inputPathStr,
                     juceBuffer.setSize(numChannels, framesToProcess, false, false, true);
 
                     // Deinterleave: interleaved [L0 R0 L1 R1 ...] → per-channel arrays
-                    for (int frame = 0; frame < framesToProcess; ++frame)
+                    const float* src = floatData + framesProcessed * numChannels;
+                    for (int ch = 0; ch < numChannels; ++ch)
                     {
-                        int srcIdx = (framesProcessed + frame) * numChannels;
-                        for (int ch = 0; ch < numChannels; ++ch)
-                            juceBuffer.setSample(ch, frame, floatData[srcIdx + ch]);
+                        float* dst = juceBuffer.getWritePointer(ch);
+                        for (int frame = 0; frame < framesToProcess; ++frame)
+                            dst[frame] = src[frame * numChannels + ch];
+                    }
+
+                    if (writer)
+                        writer->writeFromAudioSampleBuffer(juceBuffer, 0, framesToProcess);
+
+                    if (callbacks.onBlock && !callbacks.onBlock(juceBuffer, framesToProcess))
+                    {
+                        cancelled = true;
+                        break;
                     }
 
-                    writer->writeFromAudioSampleBuffer(juceBuffer, 0, framesToProcess);
                     framesProcessed += framesToProcess;
                 }
 
@@ -195,11 +222,14 @@ static bool performWavExtraction(const juce::String& inputPathStr,
             }
         }
 
+        if (cancelled)
+            [reader cancelReading];
+
         // ── 6. Flush and close ──
         writer.reset();
 
-        bool ok = (reader.status == AVAssetReaderStatusCompleted);
-        if (!ok)
+        bool ok = !cancelled && (reader.status == AVAssetReaderStatusCompleted);
+        if (!ok && !cancelled)
         {
             DBG("VideoAudioExtractor: reader finished with status "
                 + juce::String((int)reader.status));
@@ -211,6 +241,72 @@ static bool performWavExtraction(const juce::String& inputPathStr,
     }
 }
 
+//==============================================================================
+// Internal: frame grabs
+//==============================================================================
+static double clampFrameSeconds(AVAsset* asset, double frameStep, double seconds)
+{
+    const double durationSeconds = juce::jmax(0.0, CMTimeGetSeconds(asset.duration));
+    return durationSeconds > frameStep
+        ? juce::jlimit(0.0, durationSeconds - frameStep, seconds)
+        : juce::jmax(0.0, seconds);
+}
+
+/** Generator for the first video track, frames snapped within half a frame. */
+static AVAssetImageGenerator* createFrameGenerator(AVAsset* asset, double& frameStep)
+{
+    NSArray<AVAssetTrack*>* videoTracks = [asset tracksWithMediaType:AVMediaTypeVideo];
+    if (videoTracks.count == 0)
+        return nil;
+
+    AVAssetTrack* videoTrack = [videoTracks objectAtIndex:0];
+    double nominalFrameRate = (double) videoTrack.nominalFrameRate;
+    if (!std::isfinite(nominalFrameRate) || nominalFrameRate <= 1.0)
+        nominalFrameRate = 30.0;
+
+    frameStep = 1.0 / nominalFrameRate;
+
+    AVAssetImageGenerator* imageGenerator = [[AVAssetImageGenerator alloc] initWithAsset:asset];
+    imageGenerator.appliesPreferredTrackTransform = YES;
+    imageGenerator.apertureMode = AVAssetImageGeneratorApertureModeEncodedPixels;
+    imageGenerator.maximumSize = CGSizeMake(1920.0, 1920.0);
+    imageGenerator.requestedTimeToleranceBefore = CMTimeMakeWithSeconds(frameStep * 0.5, 6000);
+    imageGenerator.requestedTimeToleranceAfter = CMTimeMakeWithSeconds(frameStep * 0.5, 6000);
+    return imageGenerator;
+}
+
+static bool writeFramePng(CGImageRef cgImage, const juce::String& outputPathStr)
+{
+    juce::File outputFile(outputPathStr);
+    outputFile.getParentDirectory().createDirectory();
+    if (outputFile.existsAsFile())
+        outputFile.deleteFile();
+
+    NSString* outputPath = [NSString stringWithUTF8String:outputPathStr.toRawUTF8()];
+    if (outputPath == nil)
+        return false;
+
+#if JUCE_IOS
+    UIImage* rawImage = [UIImage imageWithCGImage:cgImage];
+    const CGSize imageSize = CGSizeMake(CGImageGetWidth(cgImage), CGImageGetHeight(cgImage));
+    UIGraphicsBeginImageContextWithOptions(imageSize, YES, 1.0);
+    [rawImage drawInRect:CGRectMake(0.0, 0.0, imageSize.width, imageSize.height)];
+    UIImage* flattenedImage = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+
+    NSData* pngData = UIImagePNGRepresentation(flattenedImage != nil ? flattenedImage : rawImage);
+#else
+    NSBitmapImageRep* bitmapRep = [[NSBitmapImageRep alloc] initWithCGImage:cgImage];
+    NSData* pngData = [bitmapRep representationUsingType:NSBitmapImageFileTypePNG
+                                              properties:@{}];
+#endif
+
+    if (pngData == nil)
+        return false;
+
+    return [pngData writeToFile:outputPath atomically:YES];
+}
+
 static bool performFrameExtraction(const juce::String& inputPathStr,
                                    double seconds,
                                    const juce::String& outputPathStr)
@@ -221,30 +317,13 @@ static bool performFrameExtraction(const juce::String& inputPathStr,
         NSURL* inputURL = [NSURL fileURLWithPath:inputPath];
         AVAsset* asset = [AVAsset assetWithURL:inputURL];
 
-        NSArray<AVAssetTrack*>* videoTracks = [asset tracksWithMediaType:AVMediaTypeVideo];
-        if (videoTracks.count == 0)
+        double frameStep = 1.0 / 30.0;
+        AVAssetImageGenerator* imageGenerator = createFrameGenerator(asset, frameStep);
+        if (imageGenerator == nil)
             return false;
 
-        AVAssetTrack* videoTrack = [videoTracks objectAtIndex:0];
-        const double durationSeconds = juce::jmax(0.0, CMTimeGetSeconds(asset.duration));
-        double nominalFrameRate = (double) videoTrack.nominalFrameRate;
-        if (!std::isfinite(nominalFrameRate) || nominalFrameRate <= 1.0)
-            nominalFrameRate = 30.0;
-
-        const double frameStep = 1.0 / nominalFrameRate;
-        const double clampedSeconds = durationSeconds > frameStep
-            ? juce::jlimit(0.0, durationSeconds - frameStep, seconds)
-            : juce::jmax(0.0, seconds);
-
-        AVAssetImageGenerator* imageGenerator = [[AVAssetImageGenerator alloc] initWithAsset:asset];
-        imageGenerator.appliesPreferredTrackTransform = YES;
-        imageGenerator.apertureMode = AVAssetImageGeneratorApertureModeEncodedPixels;
-        imageGenerator.maximumSize = CGSizeMake(1920.0, 1920.0);
-        imageGenerator.requestedTimeToleranceBefore = CMTimeMakeWithSeconds(frameStep * 0.5, 6000);
-        imageGenerator.requestedTimeToleranceAfter = CMTimeMakeWithSeconds(frameStep * 0.5, 6000);
-
         NSError* error = nil;
-        CMTime target = CMTimeMakeWithSeconds(clampedSeconds, 6000);
+        CMTime target = CMTimeMakeWithSeconds(clampFrameSeconds(asset, frameStep, seconds), 6000);
         CMTime actualTime = kCMTimeZero;
         CGImageRef cgImage = [imageGenerator copyCGImageAtTime:target actualTime:&actualTime error:&error];
         if (cgImage == nil || error != nil)
@@ -253,38 +332,9 @@ static bool performFrameExtraction(const juce::String& inputPathStr,
             return false;
         }
 
-        juce::File outputFile(outputPathStr);
-        outputFile.getParentDirectory().createDirectory();
-        if (outputFile.existsAsFile())
-            outputFile.deleteFile();
-
-        NSString* outputPath = [NSString stringWithUTF8String:outputPathStr.toRawUTF8()];
-        if (outputPath == nil)
-        {
-            CGImageRelease(cgImage);
-            return false;
-        }
-
-#if JUCE_IOS
-        UIImage* rawImage = [UIImage imageWithCGImage:cgImage];
-        const CGSize imageSize = CGSizeMake(CGImageGetWidth(cgImage), CGImageGetHeight(cgImage));
-        UIGraphicsBeginImageContextWithOptions(imageSize, YES, 1.0);
-        [rawImage drawInRect:CGRectMake(0.0, 0.0, imageSize.width, imageSize.height)];
-        UIImage* flattenedImage = UIGraphicsGetImageFromCurrentImageContext();
-        UIGraphicsEndImageContext();
-
-        NSData* pngData = UIImagePNGRepresentation(flattenedImage != nil ? flattenedImage : rawImage);
-#else
-        NSBitmapImageRep* bitmapRep = [[NSBitmapImageRep alloc] initWithCGImage:cgImage];
-        NSData* pngData = [bitmapRep representationUsingType:NSBitmapImageFileTypePNG
-                                                  properties:@{}];
-#endif
+        const bool ok = writeFramePng(cgImage, outputPathStr);
         CGImageRelease(cgImage);
-
-        if (pngData == nil)
-            return false;
-
-        return [pngData writeToFile:outputPath atomically:YES];
+        return ok;
     }
 }
 
@@ -759,24 +809,41 @@ void VideoAudioExtractor::extractAudio(const juce::File& videoFile,
                                        const juce::File& outputFile,
                                        std::function<void(bool success)> onComplete)
 {
-    // Ensure output directory exists
-    outputFile.getParentDirectory().createDirectory();
+    streamAudio(videoFile, outputFile, {}, std::move(onComplete));
+}
 
-    // Delete any existing file at output path
-    if (outputFile.existsAsFile())
-        outputFile.deleteFile();
+void VideoAudioExtractor::streamAudio(const juce::File& videoFile,
+                                      const juce::File& outputFile,
+                                      AudioStreamCallbacks callbacks,
+                                      std::function<void(bool success)> onComplete)
+{
+    const bool writesFile = outputFile != juce::File();
+    if (writesFile)
+    {
+        // Ensure output directory exists
+        outputFile.getParentDirectory().createDirectory();
+
+        // Delete any existing file at output path
+        if (outputFile.existsAsFile())
+            outputFile.deleteFile();
+    }
 
-    // Capture paths and callback for the background block.
-    // The callback is wrapped in shared_ptr for ObjC++ block capture safety.
+    // Capture paths and callbacks for the background block.
+    // The callbacks are wrapped in shared_ptr for ObjC++ block capture safety.
     // The caller is responsible for ensuring their captured state is valid
     // (e.g. using Component::SafePointer in the lambda passed as onComplete).
     juce::String inputPath  = videoFile.getFullPathName();
-    juce::String outputPath = outputFile.getFullPathName();
+    juce::String outputPath = writesFile ? outputFile.getFullPathName() : juce::String();
     auto callback = std::make_shared<std::function<void(bool)>>(std::move(onComplete));
+    auto stream = std::make_shared<AudioStreamCallbacks>(std::move(callbacks));
 
     // Run heavy I/O on a GCD background thread
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        bool success = performWavExtraction(inputPath, outputPath);
+        bool success = performAudioDecode(inputPath, outputPath, *stream);
+
+        // Never leave a truncated WAV where a later open would trust it
+        if (!success && outputPath.isNotEmpty())
+            juce::File(outputPath).deleteFile();
 
         // Callback on the JUCE message thread — guard against post-shutdown callAsync
         auto cb = callback;
@@ -814,6 +881,103 @@ void VideoAudioExtractor::extractFrameImage(const juce::File& videoFile,
     });
 }
 
+void VideoAudioExtractor::extractFrameImages(const juce::File& videoFile,
+                                             std::vector<FrameRequest> requests,
+                                             std::function<void(int index, bool success)> onFrame,
+                                             std::function<void()> onComplete)
+{
+    struct Batch
+    {
+        std::vector<FrameRequest> requests;
+        std::function<void(int, bool)> onFrame;
+        std::function<void()> onComplete;
+        std::map<CMTimeValue, std::vector<int>> indicesByTime;   // at timescale 6000
+        size_t timesLeft = 0;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->requests = std::move(requests);
+    batch->onFrame = std::move(onFrame);
+    batch->onComplete = std::move(onComplete);
+
+    auto post = [](std::function<void()> fn)
+    {
+        if (juce::MessageManager::getInstanceWithoutCreating() != nullptr)
+            juce::MessageManager::callAsync(std::move(fn));
+    };
+
+    juce::String inputPath = videoFile.getFullPathName();
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        @autoreleasepool
+        {
+            NSURL* inputURL = [NSURL fileURLWithPath:[NSString stringWithUTF8String:inputPath.toRawUTF8()]];
+            AVAsset* asset = [AVAsset assetWithURL:inputURL];
+
+            double frameStep = 1.0 / 30.0;
+            __block AVAssetImageGenerator* imageGenerator = createFrameGenerator(asset, frameStep);
+
+            // Requests that land on the same frame time share one decode
+            for (size_t i = 0; i < batch->requests.size(); ++i)
+            {
+                const auto clamped = clampFrameSeconds(asset, frameStep, batch->requests[i].seconds);
+                batch->indicesByTime[CMTimeMakeWithSeconds(clamped, 6000).value].push_back((int) i);
+            }
+
+            if (imageGenerator == nil || batch->indicesByTime.empty())
+            {
+                post([batch]
+                {
+                    if (batch->onFrame)
+                        for (size_t i = 0; i < batch->requests.size(); ++i)
+                            batch->onFrame((int) i, false);
+                    if (batch->onComplete)
+                        batch->onComplete();
+                });
+                return;
+            }
+
+            NSMutableArray<NSValue*>* times = [NSMutableArray arrayWithCapacity:batch->indicesByTime.size()];
+            for (const auto& entry : batch->indicesByTime)
+                [times addObject:[NSValue valueWithCMTime:CMTimeMake(entry.first, 6000)]];
+            batch->timesLeft = batch->indicesByTime.size();
+
+            // Handler calls arrive one at a time, in request (= time) order
+            [imageGenerator generateCGImagesAsynchronouslyForTimes:times
+                                                 completionHandler:^(CMTime requestedTime, CGImageRef cgImage, CMTime actualTime,
+                                                                     AVAssetImageGeneratorResult result, NSError* error)
+            {
+                juce::ignoreUnused(actualTime, error);
+                const auto it = batch->indicesByTime.find(CMTimeConvertScale(requestedTime, 6000, kCMTimeRoundingMethod_RoundHalfAwayFromZero).value);
+                std::vector<std::pair<int, bool>> landed;
+
+                if (it != batch->indicesByTime.end())
+                {
+                    for (auto index : it->second)
+                    {
+                        const bool ok = result == AVAssetImageGeneratorSucceeded && cgImage != nullptr
+                                     && writeFramePng(cgImage, batch->requests[(size_t) index].outputFile.getFullPathName());
+                        landed.emplace_back(index, ok);
+                    }
+                }
+
+                const bool finished = --batch->timesLeft == 0;
+                if (finished)
+                    imageGenerator = nil;   // held until the last frame lands
+
+                post([batch, landed, finished]
+                {
+                    if (batch->onFrame)
+                        for (const auto& frame : landed)
+                            batch->onFrame(frame.first, frame.second);
+                    if (finished && batch->onComplete)
+                        batch->onComplete();
+                });
+            }];
+        }
+    });
+}
+
 VideoAudioExtractor::VideoTimingInfo VideoAudioExtractor::getVideoTimingInfo(const juce::File& videoFile)
 {
     return readVideoTimingInfo(videoFile.getFullPathName());
@@ -1015,6 +1179,32 @@ void VideoAudioExtractor::extractFrameImage(const juce::File&,
     });
 }
 
+void VideoAudioExtractor::streamAudio(const juce::File&,
+                                      const juce::File&,
+                                      AudioStreamCallbacks,
+                                      std::function<void(bool success)> onComplete)
+{
+    juce::MessageManager::callAsync([onComplete]()
+    {
+        if (onComplete) onComplete(false);
+    });
+}
+
+void VideoAudioExtractor::extractFrameImages(const juce::File&,
+                                             std::vector<FrameRequest> requests,
+                                             std::function<void(int index, bool success)> onFrame,
+                                             std::function<void()> onComplete)
+{
+    const auto numRequests = static_cast<int>(requests.size());
+    juce::MessageManager::callAsync([numRequests, onFrame, onComplete]()
+    {
+        if (onFrame)
+            for (int i = 0; i < numRequests; ++i)
+                onFrame(i, false);
+        if (onComplete) onComplete();
+    });
+}
+
 void GoodMeterIOSShareHelpers::shareFile(const juce::File&)
 {
 }
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+    HistoryMediaIndex.h
+    GOODMETER iOS - Persistent index of the imported media in Documents
+
+    The history page used to list Documents with findChildFiles, then stat
+    every file again for its size and date while sorting and building rows.
+    With a few thousand recordings that held the message thread for
+    seconds. The index keeps (name, size, modification time) for every file:
+
+      - Loaded from <app data>/GOODMETER/history.idx when constructed, so
+        the page lists the library immediately
+      - rescan() walks the directory once on a background thread (size and
+        date come from the directory iterator) and, if anything changed,
+        swaps in the new snapshot, saves it and calls onChanged
+      - Names are stored relative to the directory: the iOS container path
+        changes between installs, the file names don't
+
+    Thread safety model:
+      - getEntries() / rescan() / forget(): message thread
+      - Scanning and saving: the index's own background thread
+      - The snapshot is guarded by a mutex; onChanged runs on the message
+        thread through an AsyncUpdater
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class HistoryMediaIndex : private juce::Thread,
+                          private juce::AsyncUpdater
+{
+public:
+    struct Entry
+    {
+        juce::File file;
+        juce::int64 size = 0;
+        juce::int64 modifiedMs = 0;
+
+        bool operator== (const Entry& o) const noexcept
+        {
+            return size == o.size && modifiedMs == o.modifiedMs && file == o.file;
+        }
+    };
+
+    explicit HistoryMediaIndex(const juce::File& directoryToIndex)
+        : Thread("GOODMETER-HistoryIndex"),
+          directory(directoryToIndex)
+    {
+        load();
+    }
+
+    ~HistoryMediaIndex() override
+    {
+        cancelPendingUpdate();
+        stopThread(4000);
+    }
+
+    /** Message thread, after a scan found the directory changed. */
+    std::function<void()> onChanged;
+
+    //==========================================================================
+    /** Every indexed file, newest first. */
+    std::vector<Entry> getEntries() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return entries;
+    }
+
+    /** Walk the directory again in the background. */
+    void rescan()
+    {
+        scanRequested = true;
+        if (! isThreadRunning())
+            startThread(juce::Thread::Priority::low);
+        notify();
+    }
+
+    /** Drop a deleted file now rather than on the next scan. */
+    void forget(const juce::File& file)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [&file] (const Entry& e) { return e.file == file; }),
+                      entries.end());
+    }
+
+private:
+    static constexpr int kIndexMagic = 0x58494847;   // "GHIX"
+
+    //==========================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (! scanRequested.exchange(false))
+            {
+                wait(-1);
+                continue;
+            }
+
+            auto scanned = scan();
+            if (threadShouldExit())
+                return;
+
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                if (scanned == entries)
+                    continue;
+                entries = scanned;
+            }
+
+            save(scanned);
+            triggerAsyncUpdate();
+        }
+    }
+
+    std::vector<Entry> scan() const
+    {
+        std::vector<Entry> found;
+        for (const auto& item : juce::RangedDirectoryIterator(directory, false, "*", juce::File::findFiles))
+        {
+            if (threadShouldExit())
+                break;
+
+            found.push_back({ item.getFile(), item.getFileSize(), item.getModificationTime().toMilliseconds() });
+        }
+
+        sortNewestFirst(found);
+        return found;
+    }
+
+    static void sortNewestFirst(std::vector<Entry>& list)
+    {
+        std::sort(list.begin(), list.end(),
+                  [] (const Entry& a, const Entry& b) { return a.modifiedMs > b.modifiedMs; });
+    }
+
+    void handleAsyncUpdate() override
+    {
+        if (onChanged)
+            onChanged();
+    }
+
+    //==========================================================================
+    static juce::File indexFile()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("GOODMETER")
+            .getChildFile("history.idx");
+    }
+
+    void load()
+    {
+        juce::FileInputStream stream(indexFile());
+        if (! stream.openedOk() || stream.readInt() != kIndexMagic)
+            return;
+
+        const int count = stream.readInt();
+        std::vector<Entry> loaded;
+        loaded.reserve((size_t) juce::jlimit(0, 100000, count));
+        for (int i = 0; i < count && ! stream.isExhausted(); ++i)
+        {
+            Entry entry;
+            const auto name = stream.readString();
+            entry.size = stream.readInt64();
+            entry.modifiedMs = stream.readInt64();
+            entry.file = directory.getChildFile(name);
+
+            if (name.isNotEmpty())
+                loaded.push_back(entry);
+        }
+
+        sortNewestFirst(loaded);
+        const std::lock_guard<std::mutex> lock(mutex);
+        entries = std::move(loaded);
+    }
+
+    void save(const std::vector<Entry>& list) const
+    {
+        if (! indexFile().getParentDirectory().createDirectory())
+            return;
+
+        juce::TemporaryFile temp(indexFile());
+        {
+            auto out = temp.getFile().createOutputStream();
+            if (out == nullptr)
+                return;
+
+            out->writeInt(kIndexMagic);
+            out->writeInt(static_cast<int>(list.size()));
+            for (const auto& entry : list)
+            {
+                out->writeString(entry.file.getRelativePathFrom(directory));
+                out->writeInt64(entry.size);
+                out->writeInt64(entry.modifiedMs);
+            }
+            out->flush();
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
+    //==========================================================================
+    const juce::File directory;
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;         // newest first (mutex)
+    std::atomic<bool> scanRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE(HistoryMediaIndex)
+};
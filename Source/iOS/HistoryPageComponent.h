@@ -5,8 +5,13 @@
 
     Shows files stored in the app's Documents directory:
       - Audio / Video segments
+      - Virtualised list: rows are recycled as it scrolls, and file sizes
+        and dates come from a persistent background index
+        (HistoryMediaIndex); marker frame previews load asynchronously
+        (HistoryThumbnailCache)
       - Long-press multi-select delete mode
-      - Animated pyramid action button reveals LOAD
+      - Animated pyramid action button reveals LOAD, and a zoomable
+        waveform (PeakPyramid) for audio files
       - Delete selected files to free device storage
   ==============================================================================
 */
@@ -16,8 +21,12 @@
 #include <JuceHeader.h>
 #include <array>
 #include <map>
+#include <memory>
 #include <set>
 #include "../VideoAudioExtractor.h"
+#include "../PeakPyramid.h"
+#include "HistoryMediaIndex.h"
+#include "HistoryThumbnailCache.h"
 #include "IOSShareHelpers.h"
 #include "MarkerModel.h"
 #include "DigitalTimecodeRenderer.h"
@@ -322,6 +331,186 @@ private:
     bool isDarkMode = false;
 };
 
+//==============================================================================
+/** Zoomable waveform of an opened audio row, drawn from its PeakPyramid.
+    Horizontal drag scrolls, vertical drag zooms around the touch point (up
+    zooms in), double-tap toggles between the whole file and a 4x close-up. */
+class HistoryWaveformStrip : public juce::Component
+{
+public:
+    HistoryWaveformStrip(const juce::File& fileToUse, juce::Colour accentToUse)
+        : file(fileToUse), accent(accentToUse)
+    {
+        // Drags here zoom and scroll the waveform, not the history list
+        setViewportIgnoreDragFlag(true);
+    }
+
+    void setDarkMode(bool dark)
+    {
+        isDarkMode = dark;
+        repaint();
+    }
+
+    /** Load (or build and store) the pyramid off the message thread, once. */
+    void ensureLoaded()
+    {
+        if (loadRequested)
+            return;
+
+        loadRequested = true;
+        auto pyramid = std::make_shared<PeakPyramid>();
+        juce::Component::SafePointer<HistoryWaveformStrip> safeThis(this);
+        AnalysisThreadPool::getInstance().submit([pyramid, source = file, safeThis]
+        {
+            const bool loaded = pyramid->loadOrBuild(source);
+            juce::MessageManager::callAsync([pyramid, loaded, safeThis]
+            {
+                if (auto* strip = safeThis.getComponent())
+                    strip->pyramidReady(loaded ? pyramid : nullptr);
+            });
+        });
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto area = getLocalBounds().toFloat();
+        const auto ink = isDarkMode ? juce::Colours::white : GoodMeterLookAndFeel::textMain;
+
+        g.setColour(ink.withAlpha(isDarkMode ? 0.04f : 0.03f));
+        g.fillRoundedRectangle(area, 8.0f);
+
+        auto lanes = getLocalBounds().reduced(6, 4);
+        if (peaks == nullptr || peaks->isEmpty())
+        {
+            g.setColour(ink.withAlpha(0.16f));
+            g.fillRect(lanes.withSizeKeepingCentre(lanes.getWidth(), 1));
+            return;
+        }
+
+        const int channels = juce::jmin(2, peaks->getNumChannels());
+        const double viewEnd = viewStart + viewLength;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            const int y0 = lanes.getY() + lanes.getHeight() * ch / channels;
+            const int y1 = lanes.getY() + lanes.getHeight() * (ch + 1) / channels;
+            const juce::Rectangle<int> lane(lanes.getX(), y0, lanes.getWidth(), y1 - y0);
+
+            g.setColour(accent.withAlpha(0.38f));
+            peaks->drawChannel(g, lane, viewStart, viewEnd, ch, 1.0f);
+            g.setColour(accent.withAlpha(0.9f));
+            peaks->drawChannelRms(g, lane, viewStart, viewEnd, ch, 1.0f);
+        }
+
+        // Where the close-up sits in the file
+        if (viewLength < peaks->getLengthSeconds())
+        {
+            const double total = peaks->getLengthSeconds();
+            const float x = area.getWidth() * static_cast<float>(viewStart / total);
+            const float w = juce::jmax(4.0f, area.getWidth() * static_cast<float>(viewLength / total));
+            g.setColour(accent.withAlpha(0.7f));
+            g.fillRoundedRectangle(x, area.getBottom() - 3.0f, w, 2.0f, 1.0f);
+        }
+    }
+
+    void mouseDown(const juce::MouseEvent& event) override
+    {
+        dragStartView = { viewStart, viewLength };
+        dragAnchorSeconds = secondsAt(static_cast<float>(event.getMouseDownX()));
+    }
+
+    void mouseDrag(const juce::MouseEvent& event) override
+    {
+        if (peaks == nullptr || getWidth() <= 0)
+            return;
+
+        // Zoom about the press point, then pan by the horizontal offset
+        const double zoom = std::exp(-0.012 * event.getDistanceFromDragStartY());
+        const double length = dragStartView.second / zoom;
+        const float pressX = static_cast<float>(event.getMouseDownX());
+        const double anchorFraction = pressX / (double) getWidth();
+        const double panSeconds = event.getDistanceFromDragStartX() / (double) getWidth() * length;
+        setView(dragAnchorSeconds - anchorFraction * length - panSeconds, length);
+    }
+
+    void mouseDoubleClick(const juce::MouseEvent& event) override
+    {
+        if (peaks == nullptr)
+            return;
+
+        if (viewLength < peaks->getLengthSeconds())
+            setView(0.0, peaks->getLengthSeconds());
+        else
+            zoomAround(static_cast<float>(event.x), 4.0);
+    }
+
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override
+    {
+        zoomAround(static_cast<float>(event.x), std::exp(2.0 * wheel.deltaY));
+    }
+
+    void mouseMagnify(const juce::MouseEvent& event, float scaleFactor) override
+    {
+        zoomAround(static_cast<float>(event.x), scaleFactor);
+    }
+
+private:
+    void pyramidReady(std::shared_ptr<PeakPyramid> pyramid)
+    {
+        peaks = std::move(pyramid);
+        if (peaks != nullptr)
+            setView(0.0, peaks->getLengthSeconds());
+        repaint();
+    }
+
+    double secondsAt(float x) const
+    {
+        return viewStart + (getWidth() > 0 ? x / getWidth() : 0.0) * viewLength;
+    }
+
+    void zoomAround(float x, double factor)
+    {
+        if (peaks == nullptr || getWidth() <= 0 || factor <= 0.0)
+            return;
+
+        const double anchor = secondsAt(x);
+        const double length = viewLength / factor;
+        setView(anchor - x / (double) getWidth() * length, length);
+    }
+
+    /** Clamp to the file, no closer than one sample per pixel. */
+    void setView(double start, double length)
+    {
+        const double total = peaks->getLengthSeconds();
+        const double minLength = juce::jmin(total, juce::jmax(1, getWidth()) / juce::jmax(1.0, peaks->getSampleRate()));
+        viewLength = juce::jlimit(minLength, juce::jmax(minLength, total), length);
+        viewStart = juce::jlimit(0.0, juce::jmax(0.0, total - viewLength), start);
+        repaint();
+    }
+
+    juce::File file;
+    juce::Colour accent;
+    bool isDarkMode = false;
+    bool loadRequested = false;
+
+    std::shared_ptr<PeakPyramid> peaks;
+    double viewStart = 0.0, viewLength = 0.0;
+    std::pair<double, double> dragStartView { 0.0, 0.0 };
+    double dragAnchorSeconds = 0.0;
+};
+
+/** Viewport that reports scrolling, so the history list can recycle its rows. */
+class HistoryListViewport : public juce::Viewport
+{
+public:
+    std::function<void()> onVisibleAreaChanged;
+
+    void visibleAreaChanged(const juce::Rectangle<int>&) override
+    {
+        if (onVisibleAreaChanged)
+            onVisibleAreaChanged();
+    }
+};
+
 class HistoryDrawerHandle : public juce::Component
 {
 public:
@@ -349,15 +538,14 @@ class HistoryRowComponent : public juce::Component,
                             private juce::Timer
 {
 public:
-    HistoryRowComponent(const juce::File& fileToUse, juce::Colour accentToUse)
-        : file(fileToUse), accent(accentToUse), pyramidButton(accentToUse)
+    /** Rows are recycled by the list: setEntry() binds one to a file. */
+    explicit HistoryRowComponent(juce::Colour accentToUse)
+        : accent(accentToUse), pyramidButton(accentToUse)
     {
         setInterceptsMouseClicks(true, true);
 
-        fileDisplayName = juce::URL::removeEscapeChars(file.getFileName());
         nameTextColour = GoodMeterLookAndFeel::textMain;
 
-        metaLabel.setText(buildMetaText(file), juce::dontSendNotification);
         metaLabel.setColour(juce::Label::textColourId, GoodMeterLookAndFeel::textMuted);
         metaLabel.setFont(makeHistoryReadableFont(16.0f));
         metaLabel.setJustificationType(juce::Justification::centredLeft);
@@ -382,8 +570,44 @@ public:
         addAndMakeVisible(pyramidButton);
     }
 
+    /** Show another file, with the action closed and no gesture in flight. */
+    void setEntry(const HistoryMediaIndex::Entry& entry)
+    {
+        file = entry.file;
+        fileSize = entry.size;
+        fileDisplayName = juce::URL::removeEscapeChars(file.getFileName());
+        metaLabel.setText(buildMetaText(entry), juce::dontSendNotification);
+
+        stopTimer();
+        pointerDown = false;
+        pointerMoved = false;
+        longPressTriggered = false;
+        waveform.reset();
+        setActionOpen(false, false);
+    }
+
     juce::String getFilePath() const { return file.getFullPathName(); }
-    int64_t getFileSize() const { return file.getSize(); }
+    int64_t getFileSize() const { return fileSize; }
+
+    static constexpr int kBaseHeight = 86;
+    static constexpr int kWaveformHeight = 64;
+    static constexpr int kWaveformGap = 6;
+
+    static int getHeightFor(bool showsWaveform)
+    {
+        return kBaseHeight + (showsWaveform ? kWaveformHeight + kWaveformGap : 0);
+    }
+
+    /** Audio rows show a waveform strip while their action is open. */
+    void setWaveformAvailable(bool shouldBeAvailable)
+    {
+        waveformAvailable = shouldBeAvailable;
+    }
+
+    int getPreferredHeight() const
+    {
+        return getHeightFor(waveform != nullptr && waveform->isVisible());
+    }
 
     void setDarkMode(bool dark)
     {
@@ -393,6 +617,8 @@ public:
         nameTextColour = textColor;
         metaLabel.setColour(juce::Label::textColourId, mutedColor);
         loadButton.setDarkMode(isDarkMode);
+        if (waveform != nullptr)
+            waveform->setDarkMode(isDarkMode);
         repaint();
     }
 
@@ -430,6 +656,20 @@ public:
 
         loadButton.setEnabled(targetLoadAlpha > 0.0f && !selectionMode);
 
+        if (shouldBeOpen && waveformAvailable && waveform == nullptr)
+        {
+            waveform = std::make_unique<HistoryWaveformStrip>(file, accent);
+            waveform->setDarkMode(isDarkMode);
+            addChildComponent(*waveform);
+        }
+
+        if (waveform != nullptr)
+        {
+            waveform->setVisible(shouldBeOpen);
+            if (shouldBeOpen)
+                waveform->ensureLoaded();
+        }
+
         if (!animate)
         {
             loadAlpha = targetLoadAlpha;
@@ -484,6 +724,12 @@ public:
     {
         auto area = getLocalBounds().reduced(12, 10);
 
+        if (waveform != nullptr && waveform->isVisible())
+        {
+            waveform->setBounds(area.removeFromBottom(kWaveformHeight));
+            area.removeFromBottom(kWaveformGap);
+        }
+
         if (selectionMode)
         {
             auto selectArea = area.removeFromLeft(28);
@@ -625,10 +871,10 @@ private:
         return juce::String(bytes) + " B";
     }
 
-    static juce::String buildMetaText(const juce::File& file)
+    static juce::String buildMetaText(const HistoryMediaIndex::Entry& entry)
     {
-        auto sizeText = formatFileSize(file.getSize());
-        auto timeText = file.getLastModificationTime().formatted("%Y-%m-%d %H:%M");
+        auto sizeText = formatFileSize(entry.size);
+        auto timeText = juce::Time(entry.modifiedMs).formatted("%Y-%m-%d %H:%M");
         return sizeText + "  "
              + juce::String(juce::CharPointer_UTF8("\xE2\x80\xA2")) + "  "
              + timeText;
@@ -709,6 +955,7 @@ private:
     }
 
     juce::File file;
+    int64_t fileSize = 0;
     juce::Colour accent;
     juce::String fileDisplayName;
     juce::Colour nameTextColour;
@@ -730,6 +977,9 @@ private:
     juce::Label metaLabel;
     HistoryLoadButton loadButton;
     HistoryPyramidButton pyramidButton;
+
+    bool waveformAvailable = false;
+    std::unique_ptr<HistoryWaveformStrip> waveform;     // created the first time the row opens
 };
 
 class HistoryMarkerRowComponent : public juce::Component
@@ -944,10 +1194,19 @@ public:
         timecode = timecodeToUse;
         noteEditor.setText(marker.note, juce::dontSendNotification);
         syncTagButtonsFromMarker();
+        thumbnailImage = {};
         if (!marker.frameImagePath.isEmpty())
-            thumbnailImage = juce::ImageFileFormat::loadFrom(juce::File(marker.frameImagePath));
-        else
-            thumbnailImage = {};
+        {
+            const auto path = marker.frameImagePath;
+            juce::Component::SafePointer<HistoryMarkerRowComponent> safeThis(this);
+            setThumbnail(HistoryThumbnailCache::getInstance().getOrLoad(juce::File(path),
+                [safeThis, path](const juce::Image& preview)
+                {
+                    if (auto* row = safeThis.getComponent())
+                        if (row->marker.frameImagePath == path)
+                            row->setThumbnail(preview);
+                }));
+        }
         cachedNoteHeight = getDesiredNoteHeight();
         resized();
         repaint();
@@ -1030,11 +1289,7 @@ public:
             {
                 juce::Graphics::ScopedSaveState state(g);
                 g.reduceClipRegion(getThumbnailBounds());
-                auto imageToDraw = thumbnailImage;
-                if (imageToDraw.getHeight() > imageToDraw.getWidth())
-                    imageToDraw = rotateClockwise(imageToDraw);
-
-                g.drawImageWithin(imageToDraw,
+                g.drawImageWithin(thumbnailImage,
                                   getThumbnailBounds().getX(),
                                   getThumbnailBounds().getY(),
                                   getThumbnailBounds().getWidth(),
@@ -1144,6 +1399,13 @@ public:
     std::function<void(bool)> onEditorFocusChanged;
 
 private:
+    /** Portrait frames are shown rotated into the landscape slot. */
+    void setThumbnail(const juce::Image& preview)
+    {
+        thumbnailImage = preview.getHeight() > preview.getWidth() ? rotateClockwise(preview) : preview;
+        repaint();
+    }
+
     static juce::Image rotateClockwise(const juce::Image& source)
     {
         juce::Image rotated(source.getFormat(), source.getHeight(), source.getWidth(), true);
@@ -1588,7 +1850,8 @@ public:
         randomizeBackground();
 #endif
 
-        viewport = std::make_unique<juce::Viewport>();
+        viewport = std::make_unique<HistoryListViewport>();
+        viewport->onVisibleAreaChanged = [this]() { updateVisibleRows(); };
         contentComponent = std::make_unique<juce::Component>();
         addAndMakeVisible(viewport.get());
         viewport->setViewedComponent(contentComponent.get(), false);
@@ -1732,6 +1995,13 @@ public:
         };
         addChildComponent(savePrompt.get());
 
+        mediaIndex.onChanged = [this]()
+        {
+            if (filterMode != FilterMode::marker)
+                rebuildList();
+        };
+        mediaIndex.rescan();
+
         refreshList();
     }
 
@@ -1763,6 +2033,9 @@ public:
         for (auto& row : markerRows)
             row->setDarkMode(isDarkTheme);
 
+        for (auto& row : rows)
+            row->setDarkMode(isDarkTheme);
+
         repaint();
     }
 
@@ -1952,7 +2225,17 @@ public:
             repaint();
     }
 
+    /** Rebuild from the media index now, and rescan Documents in the
+        background (the list updates again if anything changed). */
     void refreshList()
+    {
+        if (filterMode != FilterMode::marker)
+            mediaIndex.rescan();
+
+        rebuildList();
+    }
+
+    void rebuildList()
     {
         const auto oldScrollY = getPreservedScrollY();
         auto oldSelection = selectedPaths;
@@ -1960,6 +2243,7 @@ public:
 
         items.clear();
         rows.clear();
+        rowItemIndex.clear();
         markerRows.clear();
         contentComponent->removeAllChildren();
         markerDrawerHandle.setVisible(filterMode == FilterMode::marker);
@@ -2042,30 +2326,19 @@ public:
             return;
         }
 
-        auto docsDir = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory);
-        auto allFiles = docsDir.findChildFiles(juce::File::findFiles, false, "*");
-
-        for (const auto& file : allFiles)
+        // Already newest first; nothing here touches the file system
+        for (const auto& entry : mediaIndex.getEntries())
         {
-            if (!file.existsAsFile())
-                continue;
-
-            if (filterMode == FilterMode::audio && isAudioFile(file) && !isExtractedVideoAudioProxy(file))
-                items.push_back(file);
-            else if (filterMode == FilterMode::video && isVideoFile(file))
-                items.push_back(file);
+            if (filterMode == FilterMode::audio && isAudioFile(entry.file) && !isExtractedVideoAudioProxy(entry.file))
+                items.push_back(entry);
+            else if (filterMode == FilterMode::video && isVideoFile(entry.file))
+                items.push_back(entry);
         }
 
-        std::sort(items.begin(), items.end(),
-                  [](const juce::File& a, const juce::File& b)
-                  {
-                      return a.getLastModificationTime() > b.getLastModificationTime();
-                  });
-
         selectedPaths.clear();
-        for (const auto& file : items)
+        for (const auto& entry : items)
         {
-            auto path = file.getFullPathName();
+            auto path = entry.file.getFullPathName();
             if (oldSelection.count(path) > 0)
                 selectedPaths.insert(path);
         }
@@ -2074,9 +2347,9 @@ public:
             selectionMode = false;
 
         expandedPath.clear();
-        for (const auto& file : items)
+        for (const auto& entry : items)
         {
-            if (file.getFullPathName() == oldExpandedPath)
+            if (entry.file.getFullPathName() == oldExpandedPath)
             {
                 expandedPath = oldExpandedPath;
                 break;
@@ -2084,8 +2357,8 @@ public:
         }
 
         int64_t totalBytes = 0;
-        for (const auto& file : items)
-            totalBytes += file.getSize();
+        for (const auto& entry : items)
+            totalBytes += entry.size;
 
         auto kindText = (filterMode == FilterMode::audio) ? "audio" : "video";
         markerMetaLabel.setVisible(false);
@@ -2102,63 +2375,6 @@ public:
                            juce::dontSendNotification);
         emptyLabel.setVisible(items.empty());
 
-        const auto accent = currentAccent();
-
-        for (const auto& file : items)
-        {
-            auto row = std::make_unique<HistoryRowComponent>(file, accent);
-
-            row->onLoadRequested = [this](const juce::File& selectedFile)
-            {
-                if (selectionMode)
-                    return;
-
-                if (onFileRequested)
-                    onFileRequested(selectedFile);
-            };
-
-            row->onPyramidToggleRequested = [this](const juce::File& selectedFile, bool shouldOpen)
-            {
-                if (selectionMode)
-                    return;
-
-                expandedPath = shouldOpen ? selectedFile.getFullPathName() : juce::String();
-                syncRows();
-            };
-
-            row->onLongPressRequested = [this](const juce::File& selectedFile)
-            {
-                selectionMode = true;
-                expandedPath.clear();
-                selectedPaths.insert(selectedFile.getFullPathName());
-                syncRows();
-                resized();
-                repaint();
-            };
-
-            row->onSelectionToggleRequested = [this](const juce::File& selectedFile)
-            {
-                auto path = selectedFile.getFullPathName();
-                if (selectedPaths.count(path) > 0)
-                    selectedPaths.erase(path);
-                else
-                    selectedPaths.insert(path);
-
-                if (selectedPaths.empty())
-                    selectionMode = false;
-
-                syncRows();
-                resized();
-                repaint();
-            };
-
-            contentComponent->addAndMakeVisible(row.get());
-            rows.push_back(std::move(row));
-        }
-
-        for (auto& row : rows)
-            row->setDarkMode(isDarkTheme);
-
         updateSelectionFooter();
         layoutRows();
         syncRows();
@@ -2240,10 +2456,10 @@ private:
     {
         int64_t selectedBytes = 0;
 
-        for (const auto& file : items)
+        for (const auto& entry : items)
         {
-            if (selectedPaths.count(file.getFullPathName()) > 0)
-                selectedBytes += file.getSize();
+            if (selectedPaths.count(entry.file.getFullPathName()) > 0)
+                selectedBytes += entry.size;
         }
 
         if (!selectionMode)
@@ -2263,12 +2479,152 @@ private:
     {
         updateSelectionFooter();
 
-        for (auto& row : rows)
+        for (size_t i = 0; i < rows.size(); ++i)
+            if (rowItemIndex[i] >= 0)
+                applyRowState(*rows[i], true);
+
+        // Opening or closing a row shows or hides its waveform strip
+        layoutRows();
+    }
+
+    void applyRowState(HistoryRowComponent& row, bool animate)
+    {
+        auto path = row.getFilePath();
+        row.setSelectionMode(selectionMode);
+        row.setSelected(selectedPaths.count(path) > 0);
+        row.setActionOpen(!selectionMode && expandedPath == path, animate);
+    }
+
+    //==========================================================================
+    // Virtualised file list: only rows near the visible area exist, taken
+    // from a pool of recycled HistoryRowComponents as the list scrolls
+    //==========================================================================
+    int expandedExtraHeight() const
+    {
+        if (expandedIndex < 0)
+            return 0;
+
+        return HistoryRowComponent::getHeightFor(isAudioFile(items[(size_t) expandedIndex].file))
+             - HistoryRowComponent::kBaseHeight;
+    }
+
+    int rowTop(int index) const
+    {
+        return kListTop + index * (HistoryRowComponent::kBaseHeight + kRowGap)
+             + (expandedIndex >= 0 && index > expandedIndex ? expandedExtraHeight() : 0);
+    }
+
+    juce::Rectangle<int> rowBounds(int index) const
+    {
+        const int top = rowTop(index);
+        const int height = index == expandedIndex ? HistoryRowComponent::kBaseHeight + expandedExtraHeight()
+                                                  : HistoryRowComponent::kBaseHeight;
+        return { 0, top, contentComponent->getWidth(), height };
+    }
+
+    int rowIndexAt(int y) const
+    {
+        int local = juce::jmax(0, y - kListTop);
+        if (expandedIndex >= 0 && local >= rowTop(expandedIndex + 1) - kListTop)
+            local -= expandedExtraHeight();
+
+        return local / (HistoryRowComponent::kBaseHeight + kRowGap);
+    }
+
+    /** A free pooled row bound to items[index] (a new one if every row is in use). */
+    HistoryRowComponent& acquireRow(int index)
+    {
+        auto slot = std::find(rowItemIndex.begin(), rowItemIndex.end(), -1);
+        if (slot == rowItemIndex.end())
         {
-            auto path = row->getFilePath();
-            row->setSelectionMode(selectionMode);
-            row->setSelected(selectedPaths.count(path) > 0);
-            row->setActionOpen(!selectionMode && expandedPath == path, true);
+            auto row = std::make_unique<HistoryRowComponent>(currentAccent());
+
+            row->onLoadRequested = [this](const juce::File& selectedFile)
+            {
+                if (selectionMode)
+                    return;
+
+                if (onFileRequested)
+                    onFileRequested(selectedFile);
+            };
+
+            row->onPyramidToggleRequested = [this](const juce::File& selectedFile, bool shouldOpen)
+            {
+                if (selectionMode)
+                    return;
+
+                expandedPath = shouldOpen ? selectedFile.getFullPathName() : juce::String();
+                syncRows();
+            };
+
+            row->onLongPressRequested = [this](const juce::File& selectedFile)
+            {
+                selectionMode = true;
+                expandedPath.clear();
+                selectedPaths.insert(selectedFile.getFullPathName());
+                syncRows();
+                resized();
+                repaint();
+            };
+
+            row->onSelectionToggleRequested = [this](const juce::File& selectedFile)
+            {
+                auto path = selectedFile.getFullPathName();
+                if (selectedPaths.count(path) > 0)
+                    selectedPaths.erase(path);
+                else
+                    selectedPaths.insert(path);
+
+                if (selectedPaths.empty())
+                    selectionMode = false;
+
+                syncRows();
+                resized();
+                repaint();
+            };
+
+            row->setDarkMode(isDarkTheme);
+            contentComponent->addChildComponent(row.get());
+            rows.push_back(std::move(row));
+            rowItemIndex.push_back(-1);
+            slot = rowItemIndex.end() - 1;
+        }
+
+        *slot = index;
+        return *rows[(size_t) (slot - rowItemIndex.begin())];
+    }
+
+    /** Recycle rows that left the visible range, bind rows that entered it. */
+    void updateVisibleRows()
+    {
+        if (filterMode == FilterMode::marker || viewport == nullptr || contentComponent == nullptr)
+            return;
+
+        const auto view = viewport->getViewArea();
+        const int first = juce::jmax(0, rowIndexAt(view.getY()) - kOverscanRows);
+        const int last = juce::jmin(static_cast<int>(items.size()) - 1, rowIndexAt(view.getBottom()) + kOverscanRows);
+
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            if (rowItemIndex[i] >= 0 && (rowItemIndex[i] < first || rowItemIndex[i] > last))
+            {
+                rowItemIndex[i] = -1;
+                rows[i]->setVisible(false);
+            }
+        }
+
+        for (int index = first; index <= last; ++index)
+        {
+            if (std::find(rowItemIndex.begin(), rowItemIndex.end(), index) != rowItemIndex.end())
+                continue;
+
+            auto& row = acquireRow(index);
+            const auto& entry = items[(size_t) index];
+            row.setEntry(entry);
+            row.setWaveformAvailable(isAudioFile(entry.file));
+            applyRowState(row, false);
+            row.setBounds(rowBounds(index));
+            row.setVisible(true);
         }
     }
 
@@ -2280,12 +2636,12 @@ private:
         std::vector<juce::File> filesToDelete;
         int64_t totalBytes = 0;
 
-        for (const auto& file : items)
+        for (const auto& entry : items)
         {
-            if (selectedPaths.count(file.getFullPathName()) > 0)
+            if (selectedPaths.count(entry.file.getFullPathName()) > 0)
             {
-                totalBytes += file.getSize();
-                filesToDelete.push_back(file);
+                totalBytes += entry.size;
+                filesToDelete.push_back(entry.file);
             }
         }
 
@@ -2317,31 +2673,39 @@ private:
             return;
 
         const int width = juce::jmax(1, viewport->getMaximumVisibleWidth());
-        int y = (filterMode == FilterMode::marker) ? 0 : 6;
-        const int rowHeight = 86;
-        const int markerRowHeight = 72;
-        const int gap = 8;
 
         if (filterMode == FilterMode::marker)
         {
+            int y = 0;
             for (auto& row : markerRows)
             {
                 const int h = row->getPreferredHeight();
                 row->setBounds(0, y, width, h);
-                y += h + gap;
+                y += h + kRowGap;
             }
 
             contentComponent->setBounds(0, 0, width, juce::jmax(viewport->getMaximumVisibleHeight() + 1, y));
             return;
         }
 
-        for (auto& row : rows)
+        expandedIndex = -1;
+        for (size_t i = 0; i < items.size() && expandedPath.isNotEmpty(); ++i)
         {
-            row->setBounds(0, y, width, rowHeight);
-            y += rowHeight + gap;
+            if (items[i].file.getFullPathName() == expandedPath)
+            {
+                expandedIndex = static_cast<int>(i);
+                break;
+            }
         }
 
-        contentComponent->setBounds(0, 0, width, juce::jmax(viewport->getMaximumVisibleHeight() + 1, y));
+        const int listHeight = rowTop(static_cast<int>(items.size()));
+        contentComponent->setBounds(0, 0, width, juce::jmax(viewport->getMaximumVisibleHeight() + 1, listHeight));
+
+        for (size_t i = 0; i < rows.size(); ++i)
+            if (rowItemIndex[i] >= 0)
+                rows[i]->setBounds(rowBounds(rowItemIndex[i]));
+
+        updateVisibleRows();
     }
 
     int getScrollY() const
@@ -2504,6 +2868,7 @@ private:
         {
             if (onDeleteFileRequested)
                 onDeleteFileRequested(file);
+            mediaIndex.forget(file);
         }
 
         selectionMode = false;
@@ -3027,6 +3392,10 @@ private:
         }
     }
 
+    static constexpr int kListTop = 6;
+    static constexpr int kRowGap = 8;
+    static constexpr int kOverscanRows = 2;
+
     FilterMode filterMode = FilterMode::marker;
     int currentSkinId = 1;
     bool selectionMode = false;
@@ -3042,12 +3411,14 @@ private:
     std::unique_ptr<DotMatrixCanvas> bgCanvas;
 #endif
 
-    std::unique_ptr<juce::Viewport> viewport;
+    std::unique_ptr<HistoryListViewport> viewport;
     std::unique_ptr<juce::Component> contentComponent;
     std::unique_ptr<HistoryDeletePrompt> deletePrompt;
     std::unique_ptr<HistoryMarkerSavePrompt> savePrompt;
-    std::vector<juce::File> items;
-    std::vector<std::unique_ptr<HistoryRowComponent>> rows;
+    std::vector<HistoryMediaIndex::Entry> items;
+    std::vector<std::unique_ptr<HistoryRowComponent>> rows;    // pool, bound or free
+    std::vector<int> rowItemIndex;                              // items index per row, -1 when free
+    int expandedIndex = -1;
     std::vector<std::unique_ptr<HistoryMarkerRowComponent>> markerRows;
 
     HistorySegmentButton markerButton { "Marker", GoodMeterLookAndFeel::accentPink };
@@ -3075,6 +3446,9 @@ private:
     int markerScrollMemoryY = 0;
     bool markerScrollRestorePending = false;
 
+    // Last, so its scan thread stops before anything it calls back into goes
+    HistoryMediaIndex mediaIndex { juce::File::getSpecialLocation(juce::File::userDocumentsDirectory) };
+
 #if MARATHON_ART_STYLE
     void randomizeBackground()
     {
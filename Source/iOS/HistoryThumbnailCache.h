@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+    HistoryThumbnailCache.h
+    GOODMETER iOS - Asynchronous, size-bounded cache of marker frame previews
+
+    Marker rows used to decode their full-resolution frame grab with
+    ImageFileFormat::loadFrom on the message thread every time the list was
+    rebuilt. Previews now come from here:
+
+      - getOrLoad() returns a cached preview at once, or queues a decode on
+        the analysis thread pool and calls back on the message thread
+      - Decoded frames are scaled down to kMaxEdge pixels on their long
+        side before they are cached
+      - Concurrent requests for one file share a single decode
+      - At most kMaxImages previews are kept; the least recently used goes
+
+    Failed decodes are not cached, so a frame that is still being captured
+    loads on the next request.
+
+    Thread safety model:
+      - getOrLoad() and callbacks: message thread
+      - Decoding and scaling: AnalysisThreadPool workers
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../AnalysisTaskGraph.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <vector>
+
+class HistoryThumbnailCache
+{
+public:
+    static constexpr int kMaxImages = 48;
+    static constexpr int kMaxEdge = 480;
+
+    using Callback = std::function<void(const juce::Image&)>;
+
+    static HistoryThumbnailCache& getInstance()
+    {
+        static HistoryThumbnailCache cache;
+        return cache;
+    }
+
+    /** The cached preview, or a null image after queueing a decode that
+        calls onLoaded (message thread) with the result. */
+    juce::Image getOrLoad(const juce::File& imageFile, Callback onLoaded)
+    {
+        const auto key = imageFile.getFullPathName();
+        if (auto it = images.find(key); it != images.end())
+        {
+            it->second.lastUsed = ++useCounter;
+            return it->second.image;
+        }
+
+        auto& callbacks = waiting[key];
+        const bool alreadyLoading = ! callbacks.empty();
+        callbacks.push_back(std::move(onLoaded));
+        if (alreadyLoading)
+            return {};
+
+        AnalysisThreadPool::getInstance().submit([imageFile, key]
+        {
+            auto preview = decodePreview(imageFile);
+            juce::MessageManager::callAsync([key, preview]
+            {
+                getInstance().finished(key, preview);
+            });
+        });
+
+        return {};
+    }
+
+private:
+    HistoryThumbnailCache() = default;
+
+    struct Slot
+    {
+        juce::Image image;
+        juce::uint64 lastUsed = 0;
+    };
+
+    static juce::Image decodePreview(const juce::File& imageFile)
+    {
+        auto image = juce::ImageFileFormat::loadFrom(imageFile);
+        const int longEdge = juce::jmax(image.getWidth(), image.getHeight());
+        if (image.isNull() || longEdge <= kMaxEdge)
+            return image;
+
+        const float shrink = static_cast<float>(kMaxEdge) / static_cast<float>(longEdge);
+        return image.rescaled(juce::jmax(1, juce::roundToInt(image.getWidth() * shrink)),
+                              juce::jmax(1, juce::roundToInt(image.getHeight() * shrink)),
+                              juce::Graphics::mediumResamplingQuality);
+    }
+
+    void finished(const juce::String& key, const juce::Image& preview)
+    {
+        if (! preview.isNull())
+        {
+            if (images.size() >= (size_t) kMaxImages)
+            {
+                auto stalest = std::min_element(images.begin(), images.end(),
+                                                [] (const auto& a, const auto& b) { return a.second.lastUsed < b.second.lastUsed; });
+                images.erase(stalest);
+            }
+
+            images[key] = { preview, ++useCounter };
+        }
+
+        auto callbacks = std::move(waiting[key]);
+        waiting.erase(key);
+        for (auto& callback : callbacks)
+            if (callback)
+                callback(preview);
+    }
+
+    std::map<juce::String, Slot> images;
+    std::map<juce::String, std::vector<Callback>> waiting;
+    juce::uint64 useCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(HistoryThumbnailCache)
+};
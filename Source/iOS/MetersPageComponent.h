@@ -1063,37 +1063,24 @@ private:
 
         flushQueuedTransportSeek(false);
 
-        // Read atomic values from processor
-        float peakL = processor.peakLevelL.load(std::memory_order_relaxed);
-        float peakR = processor.peakLevelR.load(std::memory_order_relaxed);
-        float rmsL = processor.rmsLevelL.load(std::memory_order_relaxed);
-        float rmsR = processor.rmsLevelR.load(std::memory_order_relaxed);
-        float momentary = processor.lufsLevel.load(std::memory_order_relaxed);
-        float shortTerm = processor.lufsShortTerm.load(std::memory_order_relaxed);
-        float integrated = processor.lufsIntegrated.load(std::memory_order_relaxed);
-        float phase = processor.phaseCorrelation.load(std::memory_order_relaxed);
-
-        // Codex: 主人在 iOS 第 2 页发现 Levels 里的 LU Range 一直像没接值。
-        // 桌面端会先把 short-term LUFS 推进 LRA history，再实时计算 LRA；
-        // iOS 这条 timer 之前漏了这两步，所以这里只补 page-2 的同款接线。
-        if (++lraFrameCounter >= 6)
-        {
-            processor.pushShortTermLUFSForLRA(shortTerm);
-            processor.calculateLRARealtime();
-            lraFrameCounter = 0;
-        }
-
-        float luRangeVal = processor.luRange.load(std::memory_order_relaxed);
+        // One coherent snapshot per frame (LRA included — it is computed on
+        // the audio thread from the streaming short-term histogram)
+        const auto& snapshot = processor.updateMeterSnapshot();
 
         // Update setter-based components
         if (levelsMeter != nullptr)
-            levelsMeter->updateMetrics(peakL, peakR, momentary, shortTerm, integrated, luRangeVal);
+        {
+            levelsMeter->updateChannelLoudness(snapshot.channelLufs.data(), snapshot.numLoudnessChannels);
+            levelsMeter->updateMetrics(snapshot.truePeakL, snapshot.truePeakR,
+                                       snapshot.lufsMomentary, snapshot.lufsShortTerm,
+                                       snapshot.lufsIntegrated, snapshot.luRange);
+        }
 
         if (vuMeter != nullptr)
-            vuMeter->updateVU(rmsL, rmsR);
+            vuMeter->updateVU(snapshot.rmsL, snapshot.rmsR);
 
         if (phaseMeter != nullptr)
-            phaseMeter->updateCorrelation(phase);
+            phaseMeter->updateCorrelation(snapshot.phaseCorrelation);
 
         // ── Update transport ──
         const bool useExternalTransportNow = (hasExternalTransport != nullptr && hasExternalTransport());
@@ -1433,7 +1420,6 @@ private:
     int columnOverride = 0;
     DisplayMode displayMode = DisplayMode::singleColumn;
     bool isDarkTheme = false;
-    int lraFrameCounter = 0;
     bool transportUserIntentActive = false;
     bool transportUserIntentPlaying = false;
     std::uint32_t transportUserIntentUntilMs = 0;
@@ -166,6 +166,12 @@ public:
 #endif
     }
 
+#if MARATHON_ART_STYLE
+    // The dot-wave bands are only needed while this page is the one shown
+    void visibilityChanged() override        { bandDemand.setActive(isShowing()); }
+    void parentHierarchyChanged() override   { bandDemand.setActive(isShowing()); }
+#endif
+
     void resized() override
     {
         auto bounds = getLocalBounds();
@@ -440,9 +446,10 @@ public:
 
         if (audioEngine.isPlaying())
         {
-            const float targetLow = mapBandDbToDisplay(processor.rmsLevelLow.load(std::memory_order_relaxed));
-            const float targetMid = mapBandDbToDisplay(processor.rmsLevelMid3Band.load(std::memory_order_relaxed));
-            const float targetHigh = mapBandDbToDisplay(processor.rmsLevelHigh.load(std::memory_order_relaxed));
+            const auto& snapshot = processor.updateMeterSnapshot();
+            const float targetLow = mapBandDbToDisplay(snapshot.rmsLow);
+            const float targetMid = mapBandDbToDisplay(snapshot.rmsMid3Band);
+            const float targetHigh = mapBandDbToDisplay(snapshot.rmsHigh);
             const float smoothing = 0.26f;
             dotWaveBandLow += (targetLow - dotWaveBandLow) * smoothing;
             dotWaveBandMid += (targetMid - dotWaveBandMid) * smoothing;
@@ -835,9 +842,24 @@ private:
         if (asciiNono != nullptr)
             asciiNono->triggerExtractExpression();
 
+        // Loudness is measured on the decode thread while the WAV is written,
+        // so Nono's results don't wait for a second read of the file
+        auto loudness = std::make_shared<std::unique_ptr<OfflineLoudnessAnalyzer::Stream>>();
+        VideoAudioExtractor::AudioStreamCallbacks stream;
+        stream.onFormat = [loudness](double sampleRate, int numChannels)
+        {
+            *loudness = std::make_unique<OfflineLoudnessAnalyzer::Stream>(sampleRate, numChannels);
+            return true;
+        };
+        stream.onBlock = [loudness](const juce::AudioBuffer<float>& block, int numSamples)
+        {
+            (*loudness)->push(block.getArrayOfReadPointers(), numSamples);
+            return true;
+        };
+
         auto safeThis = juce::Component::SafePointer<NonoPageComponent>(this);
-        VideoAudioExtractor::extractAudio(videoFile, outputFile,
-            [safeThis, outputFile](bool success)
+        VideoAudioExtractor::streamAudio(videoFile, outputFile, std::move(stream),
+            [safeThis, outputFile, loudness](bool success)
             {
                 if (auto* self = safeThis.getComponent())
                 {
@@ -847,7 +869,12 @@ private:
                         self->asciiNono->stopExtractExpression();
 
                     if (success && outputFile.existsAsFile())
+                    {
+                        if (self->holoNono != nullptr && *loudness != nullptr)
+                            self->holoNono->providePrecomputedAnalysis(outputFile, (*loudness)->finish());
+
                         self->loadAnalyzedFile(outputFile);
+                    }
                 }
             });
 
@@ -2372,33 +2399,58 @@ private:
                   [] (const auto& a, const auto& b) { return a.seconds < b.seconds; });
 
         if (item.isVideo)
-        {
-            const auto cacheFile = juce::File(item.frameImagePath);
-            VideoAudioExtractor::extractFrameImage(juce::File(markerPath), item.seconds, cacheFile,
-                [safeThis = juce::Component::SafePointer<NonoPageComponent>(this),
-                 markerPath, markerId = item.id, cacheFile](bool success)
-                {
-                    if (auto* self = safeThis.getComponent())
-                    {
-                        if (auto* marker = self->findMarkerItemById(markerPath, markerId))
-                        {
-                            marker->framePending = false;
-                            if (success && cacheFile.existsAsFile())
-                                marker->frameImagePath = cacheFile.getFullPathName();
-                        }
-
-                        if (self->onMarkerDataChanged != nullptr)
-                            self->onMarkerDataChanged();
-                        self->repaint();
-                    }
-                });
-        }
+            captureMarkerFrames(markerPath, item.id);
 
         if (onMarkerDataChanged != nullptr)
             onMarkerDataChanged();
         repaint();
     }
 
+    /** Grab newMarkerId's thumbnail together with any other video marker of
+     *  the file whose cached frame has gone missing, in one pass. */
+    void captureMarkerFrames(const juce::String& markerPath, const juce::String& newMarkerId)
+    {
+        auto* markers = getMarkerItemsForPath(markerPath);
+        if (markers == nullptr)
+            return;
+
+        std::vector<VideoAudioExtractor::FrameRequest> requests;
+        juce::StringArray markerIds;
+        for (auto& marker : markers->items)
+        {
+            if (! marker.isVideo || marker.frameImagePath.isEmpty())
+                continue;
+
+            const bool missing = ! marker.framePending && ! juce::File(marker.frameImagePath).existsAsFile();
+            if (marker.id != newMarkerId && ! missing)
+                continue;
+
+            marker.framePending = true;
+            requests.push_back({ marker.seconds, juce::File(marker.frameImagePath) });
+            markerIds.add(marker.id);
+        }
+
+        if (requests.empty())
+            return;
+
+        auto safeThis = juce::Component::SafePointer<NonoPageComponent>(this);
+        VideoAudioExtractor::extractFrameImages(juce::File(markerPath), std::move(requests),
+            [safeThis, markerPath, markerIds](int index, bool success)
+            {
+                if (auto* self = safeThis.getComponent())
+                {
+                    juce::ignoreUnused(success);   // a failed grab is retried with the next marker
+                    if (auto* marker = self->findMarkerItemById(markerPath, markerIds[index]))
+                        marker->framePending = false;
+
+                    if (self->onMarkerDataChanged != nullptr)
+                        self->onMarkerDataChanged();
+                    self->repaint();
+                }
+            },
+            nullptr);
+    }
+
     void rebuildDotMatrixFileNameCache(const juce::String& rawText,
                                        juce::Rectangle<float> area) const
     {
@@ -3132,6 +3184,7 @@ private:
     float dotWaveBandHigh = 0.0f;
 
 #if MARATHON_ART_STYLE
+    AnalysisDemand::Subscription bandDemand { processor.analysisDemand, AnalysisDemand::Analysis::bands };   // dot-wave bands
     std::unique_ptr<DotMatrixCanvas> bgCanvas;
     bool rippleActive = false;
     int rippleCenterX = 0;
@@ -3831,7 +3884,7 @@ private:
         // Clip text to only show left of wave
         g.saveState();
         g.reduceClipRegion(juce::Rectangle<int>(0, (int)row5Y, (int)waveX, (int)cellH));
-        g.drawText("Peak " + juce::String(result.peakDBFS, 1) + " dBFS",
+        g.drawText("Peak " + juce::String(result.peakDBFS, 1) + " dBTP",
                    20, row5Y, 180, cellH, juce::Justification::centredLeft, false);
         g.drawText("Momentary " + juce::String(result.momentaryMaxLUFS, 1) + " LUFS",
                    bounds.getRight() - 200, row5Y, 180, cellH, juce::Justification::centredLeft, false);
@@ -1973,20 +1973,21 @@ void VideoPageComponent::timerCallback()
     if (!syncedAudioLoaded)
         attachSyncedAudioIfAvailable();
 
-    const float peakL = processor.peakLevelL.load(std::memory_order_relaxed);
-    const float peakR = processor.peakLevelR.load(std::memory_order_relaxed);
-    const float rmsL = processor.rmsLevelL.load(std::memory_order_relaxed);
-    const float rmsR = processor.rmsLevelR.load(std::memory_order_relaxed);
-    const float momentary = processor.lufsLevel.load(std::memory_order_relaxed);
-    const float shortTerm = processor.lufsShortTerm.load(std::memory_order_relaxed);
-    const float integrated = processor.lufsIntegrated.load(std::memory_order_relaxed);
-    const float phase = processor.phaseCorrelation.load(std::memory_order_relaxed);
-    const float luRangeVal = processor.luRange.load(std::memory_order_relaxed);
+    const auto& snapshot = processor.updateMeterSnapshot();
+    const float truePeakL = snapshot.truePeakL;
+    const float truePeakR = snapshot.truePeakR;
+    const float rmsL = snapshot.rmsL;
+    const float rmsR = snapshot.rmsR;
+    const float momentary = snapshot.lufsMomentary;
+    const float shortTerm = snapshot.lufsShortTerm;
+    const float integrated = snapshot.lufsIntegrated;
+    const float phase = snapshot.phaseCorrelation;
+    const float luRangeVal = snapshot.luRange;
 
     if (topLevelsMeter != nullptr)
-        topLevelsMeter->updateMetrics(peakL, peakR, momentary, shortTerm, integrated, luRangeVal);
+        topLevelsMeter->updateMetrics(truePeakL, truePeakR, momentary, shortTerm, integrated, luRangeVal);
     if (bottomLevelsMeter != nullptr)
-        bottomLevelsMeter->updateMetrics(peakL, peakR, momentary, shortTerm, integrated, luRangeVal);
+        bottomLevelsMeter->updateMetrics(truePeakL, truePeakR, momentary, shortTerm, integrated, luRangeVal);
     if (topVuMeter != nullptr)
         topVuMeter->updateVU(rmsL, rmsR);
     if (bottomVuMeter != nullptr)
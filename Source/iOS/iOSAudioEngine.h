@@ -7,9 +7,20 @@
     to enable real-time file playback through GOODMETERAudioProcessor.
 
     Pipeline:
-      AudioFormatReader -> AudioFormatReaderSource -> AudioTransportSource
+      AudioFormatReader -> AudioFormatReaderSource
+        -> BufferingAudioSource (read-ahead thread) -> AudioTransportSource
         -> AudioProcessorPlayer(GOODMETERAudioProcessor)
           -> AudioDeviceManager -> speaker
+
+    The audio callback never touches the disk or a decoder: the transport
+    reads through a read-ahead ring filled on readAheadThread, sized by
+    format (compressed files get more headroom than PCM). A seek only moves
+    the ring's read position; the refill happens on the read-ahead thread.
+
+    Loading builds and prepares the new source chain on the message thread
+    and hands it to the transport, which swaps it in under its own short
+    lock; the old chain is released afterwards. Nothing takes the device's
+    callback lock, so loads and scrubs can't stall the callback.
   ==============================================================================
 */
 
@@ -35,19 +46,18 @@ public:
         // feed through processor, then output to speaker
         deviceManager.addAudioCallback(this);
         transportSource.addChangeListener(this);
+        readAheadThread.startThread(juce::Thread::Priority::high);
     }
 
     ~iOSAudioEngine()
     {
-        {
-            const juce::ScopedLock callbackLock(deviceManager.getAudioCallbackLock());
-            transportSource.stop();
-            transportSource.setSource(nullptr);
-            readerSource.reset();
-        }
+        transportSource.stop();
+        transportSource.setSource(nullptr);
+        readerSource.reset();
 
         transportSource.removeChangeListener(this);
         deviceManager.removeAudioCallback(this);
+        readAheadThread.stopThread(2000);
     }
 
     //==========================================================================
@@ -76,46 +86,27 @@ public:
 
         auto newReaderSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
 
-        {
-            const juce::ScopedLock callbackLock(deviceManager.getAudioCallbackLock());
+        fileLoaded = false;
+        transportSource.stop();
 
-            fileLoaded = false;
-            transportSource.stop();
-            transportSource.setPosition(0.0);
-            transportSource.setSource(nullptr);
-            readerSource.reset();
-
-            readerSource = std::move(newReaderSource);
-            transportSource.setSource(readerSource.get(), 0, nullptr,
-                                      reader->sampleRate, 2);
-
-            // If the audio device is already running, re-prepare the transport
-            // so it picks up the new source's length with a valid sampleRate.
-            auto* device = deviceManager.getCurrentAudioDevice();
-            if (device != nullptr)
-            {
-                double sr = device->getCurrentSampleRate();
-                int bs = device->getCurrentBufferSizeSamples();
-                if (sr > 0)
-                    transportSource.prepareToPlay(bs, sr);
-            }
-            else
-            {
-                // No audio device — prepare transport with the file's own sample rate
-                // so at least getLengthInSeconds() works for UI display
-                transportSource.prepareToPlay(512, reader->sampleRate);
-            }
-
-            fileLoaded = true;
-        }
+        // The transport prepares the new chain (and its read-ahead ring)
+        // before swapping it in; the old reader source is only released
+        // once it is no longer referenced.
+        transportSource.setSource(newReaderSource.get(), readAheadSamplesFor(file, reader->sampleRate),
+                                  &readAheadThread, reader->sampleRate, 2);
+        readerSource = std::move(newReaderSource);
+
+        // No audio device — prepare transport with the file's own sample rate
+        // so at least getLengthInSeconds() works for UI display
+        if (deviceManager.getCurrentAudioDevice() == nullptr)
+            transportSource.prepareToPlay(512, reader->sampleRate);
 
+        fileLoaded = true;
         return true;
     }
 
     void clearFile()
     {
-        const juce::ScopedLock callbackLock(deviceManager.getAudioCallbackLock());
-
         fileLoaded = false;
         currentFileName.clear();
         currentFilePath.clear();
@@ -124,18 +115,15 @@ public:
         fileLengthSamples = 0;
 
         transportSource.stop();
-        transportSource.setPosition(0.0);
         transportSource.setSource(nullptr);
         readerSource.reset();
     }
 
     //==========================================================================
-    // Transport controls
+    // Transport controls (AudioTransportSource locks internally)
     //==========================================================================
     void play()
     {
-        const juce::ScopedLock callbackLock(deviceManager.getAudioCallbackLock());
-
         if (fileLoaded)
         {
             const double totalLength = getTotalLength();
@@ -148,20 +136,18 @@ public:
 
     void pause()
     {
-        const juce::ScopedLock callbackLock(deviceManager.getAudioCallbackLock());
         transportSource.stop();
     }
 
     void stop()
     {
-        const juce::ScopedLock callbackLock(deviceManager.getAudioCallbackLock());
         transportSource.stop();
         transportSource.setPosition(0.0);
     }
 
+    /** Moves the read-ahead position; the refill happens on the read-ahead thread. */
     void seek(double positionSeconds)
     {
-        const juce::ScopedLock callbackLock(deviceManager.getAudioCallbackLock());
         transportSource.setPosition(positionSeconds);
     }
 
@@ -257,9 +243,27 @@ private:
         }
     }
 
+    //==========================================================================
+    // Read-ahead sizing
+    //==========================================================================
+    static constexpr double kPcmReadAheadSeconds = 0.5;
+    static constexpr double kCompressedReadAheadSeconds = 2.0;
+
+    static bool isCompressed(const juce::File& file)
+    {
+        return file.hasFileExtension("mp3;m4a;aac;ogg;flac;caf");
+    }
+
+    static int readAheadSamplesFor(const juce::File& file, double sampleRate)
+    {
+        const double seconds = isCompressed(file) ? kCompressedReadAheadSeconds : kPcmReadAheadSeconds;
+        return juce::jmax(8192, juce::roundToInt(seconds * (sampleRate > 0.0 ? sampleRate : 48000.0)));
+    }
+
     GOODMETERAudioProcessor& processor;
     juce::AudioDeviceManager deviceManager;
     juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread readAheadThread { "GOODMETER-ReadAhead" };
     juce::AudioTransportSource transportSource;
     std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
 
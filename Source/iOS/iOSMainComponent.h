@@ -19,6 +19,7 @@
 #include "iOSPluginDefines.h"
 #include "../PluginProcessor.h"
 #include "../GoodMeterLookAndFeel.h"
+#include "../FrameScheduler.h"
 #include "iOSAudioEngine.h"
 #include "NonoPageComponent.h"
 #include "MetersPageComponent.h"
@@ -557,6 +558,9 @@ private:
     std::unique_ptr<GOODMETERAudioProcessor> processor;
     std::unique_ptr<iOSAudioEngine> audioEngine;
 
+    // One meter snapshot read per scheduler frame for the pages' meters
+    FrameScheduler::FrameStart meterFrame { [this] { if (processor != nullptr) processor->updateMeterSnapshot(); } };
+
     std::unique_ptr<NonoPageComponent> nonoPage;
     std::unique_ptr<MetersPageComponent> metersPage;
     std::unique_ptr<SettingsPageComponent> settingsPage;